@@ -2,11 +2,16 @@
 
 #include <algorithm>
 #include <cmath>
+#include <QDateTime>
+#include <QDir>
+#include <QFileDialog>
 #include <QMenuBar>
 #include <QScrollArea>
 #include <QSize>
 #include "../Core/ChannelDescriptor.h"
 #include "../Core/DeviceSettings.h"
+#include "../Core/Trace.h"
+#include "Logger.h"
 #include "LoggerOptionsDialog.h"
 #include "RadioMonitorPage.h"
 #include "TxController.h"
@@ -110,6 +115,31 @@ DeviceDetailWindow::DeviceDetailWindow(std::shared_ptr<IDevice> device, IDeviceM
         LoggerOptionsDialog dlg(this);
         dlg.exec();
     });
+    // Tracing is process-wide — every device window's action mirrors it.
+    toolsMenu->addSeparator();
+    auto* traceAction = toolsMenu->addAction(tr("Record trace"));
+    traceAction->setCheckable(true);
+    traceAction->setToolTip(tr("Record RX/DSP/recorder spans for chrome://tracing or Perfetto"));
+    connect(toolsMenu, &QMenu::aboutToShow, traceAction, [traceAction]() {
+        traceAction->setChecked(Trace::enabled());
+    });
+    connect(traceAction, &QAction::toggled, this, [](bool on) {
+        if (on == Trace::enabled()) return;
+        if (on) Trace::clear();
+        Trace::setEnabled(on);
+    });
+    connect(toolsMenu->addAction(tr("Save trace…")), &QAction::triggered, this, [this]() {
+        const QString def = QDir::home().filePath(
+            QDateTime::currentDateTime().toString("'stand-trace_'yyyyMMdd_HHmmss'.json'"));
+        const QString path = QFileDialog::getSaveFileName(
+            this, tr("Save trace"), def, tr("Chrome trace (*.json);;All files (*)"));
+        if (path.isEmpty()) return;
+        QString error;
+        if (!Trace::writeChromeJson(path, &error))
+            QMessageBox::warning(this, tr("Save trace"), error);
+        else
+            statusBar()->showMessage(tr("Trace saved: %1").arg(path), 5000);
+    });
 
     // ── Toolbar: «+» to open / reopen device selection ────────────────────────
     auto* devToolbar = addToolBar(tr("Devices"));
@@ -1073,6 +1103,18 @@ Application::Application(int& argc, char** argv, IDeviceManager& manager)
     , selectionWindow(manager, sessionManager_)
 {
     QApplication::setWindowIcon(QIcon(":/assets/icon.jpg"));
+    Trace::setThreadName("main (UI)");
+
+    const QString metricsPort = qEnvironmentVariable("STAND_METRICS_PORT");
+    if (!metricsPort.isEmpty()) {
+        bool ok = false;
+        const uint port = metricsPort.toUInt(&ok);
+        QString error;
+        if (!ok || port > 65535)
+            LOG_WARN("STAND_METRICS_PORT: not a port number: " + metricsPort.toStdString());
+        else if (!metricsServer_.listen(static_cast<quint16>(port), &error))
+            LOG_WARN(error.toStdString());
+    }
 }
 
 int Application::run() {
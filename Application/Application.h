@@ -34,6 +34,7 @@
 #include "../Hardware/DeviceController.h"
 #include "RxController.h"
 #include "ChannelPanel.h"
+#include "MetricsServer.h"
 #include "SessionManager.h"
 
 class TxController;
@@ -185,4 +186,5 @@ private:
     QApplication          qtApp;
     SessionManager        sessionManager_;
     DeviceSelectionWindow selectionWindow;
+    MetricsServer         metricsServer_;   // listens only if STAND_METRICS_PORT is set
 };
@@ -77,7 +77,10 @@ void ChannelPanel::setRxController(RxController* ctrl) {
                 demodStatusLabel_->setText(msg);
             });
 
-    classifierCtrl_ = new ClassifierController(ctrl_, this);
+    classifierCtrl_ = new ClassifierController(
+        [ctrl = ctrl_](IPipelineHandler* h) { ctrl->addExtraHandler(h); },
+        [ctrl = ctrl_](IPipelineHandler* h) { ctrl->removeExtraHandler(h); },
+        this);
 
     if (classifierLabel_) {
         connect(classifierCtrl_, &ClassifierController::classificationReady,
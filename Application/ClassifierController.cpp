@@ -1,14 +1,13 @@
 #include "ClassifierController.h"
-#include "../DSP/ClassifierHandler.h"
-#include "RxController.h"
 #include "Logger.h"
 
-#include <QJsonDocument>
-#include <QJsonObject>
+#include <QCoreApplication>
 
-ClassifierController::ClassifierController(RxController* appCtrl, QObject* parent)
+ClassifierController::ClassifierController(HandlerHook attach, HandlerHook detach,
+                                           QObject* parent)
     : QObject(parent)
-    , appCtrl_(appCtrl)
+    , attach_(std::move(attach))
+    , detach_(std::move(detach))
 {}
 
 ClassifierController::~ClassifierController() {
@@ -21,9 +20,36 @@ ClassifierController::~ClassifierController() {
 void ClassifierController::start(const QString& pythonExe, const QString& scriptPath) {
     if (isRunning()) return;
 
+    handler_ = new ClassifierHandler(this);
+    handler_->setIntervalMs(intervalMs_);
+    handler_->setChannels(channels_);
+    handler_->setCenterFrequency(centerHz_);
+    handler_->setMaxInFlight(maxInFlight_);
+    handler_->setMode(mode_);
+    handler_->publishMetrics({});
+    if (mode_ == ClassifierHandler::Mode::Local) {
+        startLocal();
+        return;
+    }
+
     LOG_INFO("ClassifierController: starting " + scriptPath.toStdString());
+    helloSeen_ = false;
+    failReason_.clear();
+    readBuf_.clear();
 
-    handler_ = new ClassifierHandler(this);
+    // Frames go through shared memory when the ring can be created; the
+    // socket then only carries results.
+    static int ringCounter = 0;
+    QStringList args{scriptPath};
+    QString ringError;
+    const QString ringName = QStringLiteral("stand_iq_%1_%2")
+                                 .arg(QCoreApplication::applicationPid()).arg(++ringCounter);
+    if (handler_->openSharedRing(ringName, &ringError)) {
+        args << QStringLiteral("--shm") << ringName;
+        LOG_INFO("ClassifierController: I/Q via shared memory " + ringName.toStdString());
+    } else {
+        LOG_WARN("ClassifierController: " + ringError.toStdString() + " — sending I/Q over TCP");
+    }
 
     socket_ = new QTcpSocket(this);
     connect(socket_, &QTcpSocket::connected,    this, &ClassifierController::onSocketConnected);
@@ -43,7 +69,16 @@ void ClassifierController::start(const QString& pythonExe, const QString& script
         LOG_INFO("[classifier] " + process_->readAll().trimmed().toStdString());
     });
 
-    process_->start(pythonExe, {scriptPath});
+    process_->start(pythonExe, args);
+}
+
+void ClassifierController::startLocal() {
+    LOG_INFO("ClassifierController: classifying in process");
+    connect(handler_, &ClassifierHandler::localResults,
+            this,     &ClassifierController::onLocalResults, Qt::QueuedConnection);
+    local_ = true;
+    attachHandler();
+    emit classifierStarted();
 }
 
 void ClassifierController::stop() {
@@ -51,8 +86,32 @@ void ClassifierController::stop() {
     emit classifierStopped();
 }
 
+void ClassifierController::setIntervalMs(int ms) {
+    intervalMs_ = ms;
+    if (handler_) handler_->setIntervalMs(ms);
+}
+
+void ClassifierController::setChannels(const QVector<ClassifierChannel>& channels) {
+    channels_ = channels;
+    if (handler_) handler_->setChannels(channels);
+}
+
+void ClassifierController::setCenterFrequency(double hz) {
+    centerHz_ = hz;
+    if (handler_) handler_->setCenterFrequency(hz);
+}
+
+void ClassifierController::setMaxInFlight(int frames) {
+    maxInFlight_ = frames;
+    if (handler_) handler_->setMaxInFlight(frames);
+}
+
+void ClassifierController::setMode(ClassifierHandler::Mode mode) {
+    mode_ = mode;
+}
+
 bool ClassifierController::isRunning() const {
-    return process_ && process_->state() != QProcess::NotRunning;
+    return local_ || (process_ && process_->state() != QProcess::NotRunning);
 }
 
 // ---------------------------------------------------------------------------
@@ -68,8 +127,9 @@ void ClassifierController::onProcessStarted() {
 }
 
 void ClassifierController::onProcessFinished(int exitCode, QProcess::ExitStatus status) {
-    const QString reason = (status == QProcess::CrashExit)
-                           ? "crashed"
+    const QString reason = !failReason_.isEmpty() ? failReason_
+                         : (status == QProcess::CrashExit)
+                           ? QStringLiteral("crashed")
                            : QString("exited with code %1").arg(exitCode);
     LOG_WARN("ClassifierController: process " + reason.toStdString());
 
@@ -96,8 +156,7 @@ void ClassifierController::connectToService() {
 void ClassifierController::onSocketConnected() {
     LOG_INFO("ClassifierController: connected to classifier service");
     if (connectTimer_) { connectTimer_->stop(); connectTimer_->deleteLater(); connectTimer_ = nullptr; }
-    attachHandler();
-    emit classifierStarted();
+    // The handler is attached once the service's hello has been checked.
 }
 
 void ClassifierController::onSocketError(QAbstractSocket::SocketError /*err*/) {
@@ -125,38 +184,57 @@ void ClassifierController::sendFrame(const QByteArray& data) {
 // ---------------------------------------------------------------------------
 void ClassifierController::onSocketReadyRead() {
     readBuf_ += socket_->readAll();
+    qsizetype pos = 0;
 
-    // Responses are newline-terminated JSON objects.
-    while (true) {
-        const int nl = readBuf_.indexOf('\n');
-        if (nl < 0) break;
-        const QByteArray line = readBuf_.left(nl).trimmed();
-        readBuf_.remove(0, nl + 1);
-
-        if (line.isEmpty()) continue;
-        const QJsonDocument doc = QJsonDocument::fromJson(line);
-        if (!doc.isObject()) {
-            LOG_WARN("ClassifierController: invalid JSON: " + line.toStdString());
-            continue;
+    if (!helloSeen_) {
+        if (readBuf_.size() < ClassifierProtocol::kHelloBytes) return;
+        QString error;
+        if (!ClassifierProtocol::parseHello(readBuf_.constData(), &error)) {
+            LOG_WARN("ClassifierController: " + error.toStdString());
+            failReason_ = QStringLiteral("rejected — ") + error;
+            readBuf_.clear();
+            if (process_) process_->terminate();   // onProcessFinished() reports it
+            return;
         }
-        const QJsonObject obj = doc.object();
-        const QString type       = obj.value("type").toString("Unknown");
-        const double  confidence = obj.value("confidence").toDouble(0.0);
-        emit classificationReady(type, confidence);
+        helloSeen_ = true;
+        pos        = ClassifierProtocol::kHelloBytes;
+        if (handler_) handler_->resetInFlight();
+        attachHandler();
+        emit classifierStarted();
     }
+
+    // Fixed-size result records; a partial record waits for the next read.
+    while (readBuf_.size() - pos >= ClassifierProtocol::kResultBytes) {
+        const auto r = ClassifierProtocol::parseResult(readBuf_.constData() + pos);
+        pos += ClassifierProtocol::kResultBytes;
+
+        if (r.lastInFrame() && handler_) handler_->frameDone();
+        publishResult(r);
+    }
+    readBuf_.remove(0, pos);
+}
+
+void ClassifierController::onLocalResults(const QVector<ClassifierProtocol::Result>& results) {
+    for (const auto& r : results) publishResult(r);
+}
+
+void ClassifierController::publishResult(const ClassifierProtocol::Result& r) {
+    const QString type = ClassifierProtocol::typeName(r.type);
+    emit channelClassified(r.channelId, type, r.confidence, r.timestamp);
+    emit classificationReady(type, r.confidence);
 }
 
 // ---------------------------------------------------------------------------
 // Handler pipeline wiring
 // ---------------------------------------------------------------------------
 void ClassifierController::attachHandler() {
-    if (handler_ && appCtrl_)
-        appCtrl_->addExtraHandler(handler_);
+    if (handler_ && attach_)
+        attach_(handler_);
 }
 
 void ClassifierController::detachHandler() {
-    if (handler_ && appCtrl_)
-        appCtrl_->removeExtraHandler(handler_);
+    if (handler_ && detach_)
+        detach_(handler_);
 }
 
 // ---------------------------------------------------------------------------
@@ -164,6 +242,10 @@ void ClassifierController::detachHandler() {
 // ---------------------------------------------------------------------------
 void ClassifierController::teardown() {
     detachHandler();
+    local_ = false;
+    if (handler_ && handler_->sentFrames() + handler_->droppedFrames() > 0)
+        LOG_INFO("ClassifierController: " + std::to_string(handler_->sentFrames()) + " frames sent, "
+                 + std::to_string(handler_->droppedFrames()) + " dropped (classifier busy)");
 
     if (connectTimer_) { connectTimer_->stop(); delete connectTimer_; connectTimer_ = nullptr; }
 
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "../DSP/ClassifierHandler.h"
+
 #include <QObject>
 #include <QProcess>
 #include <QString>
@@ -7,40 +9,69 @@
 #include <QTimer>
 #include <QByteArray>
 
-class RxController;
-class ClassifierHandler;
+#include <functional>
+
+class IPipelineHandler;
 
 // ---------------------------------------------------------------------------
 // ClassifierController — owns the Python subprocess and the TCP connection
 // to the classifier service.
 //
+// Frames (ClassifierProtocol v2) reach Python through the handler's
+// shared-memory ring (the script is started with --shm <name>); the TCP
+// socket carries the service's hello and the fixed-size result records. If
+// the ring cannot be created, frames fall back to the socket.
+//
 // Lifecycle:
 //   start() → QProcess launches Python script → connectToService() tries to
 //   connect (retries until success or process exits) → socket connected →
-//   ClassifierHandler added to RxController's pipeline.
+//   protocol hello checked → ClassifierHandler handed to the attach hook
+//   (RxController::addExtraHandler in the GUI, the headless runner's
+//   Pipeline in StandHeadless).
 //
-//   stop() / process crash → ClassifierHandler removed from pipeline →
+//   stop() / process crash → ClassifierHandler passed to the detach hook →
 //   classifierStopped() emitted → UI shows "Unavailable".
 //
+// With setMode(Mode::Local) start() launches nothing: the handler classifies
+// in process (ModulationFeatures) and is attached straight away. Mode::Features
+// runs the service as usual but sends it feature vectors instead of I/Q.
+//
 // All members live on the main thread.
-// ClassifierHandler::frameReady is connected via QueuedConnection so the
-// worker-thread signal safely reaches this object's sendFrame() slot.
+// ClassifierHandler::frameReady (TCP fallback only) is connected via
+// QueuedConnection so the worker-thread signal safely reaches sendFrame().
 // ---------------------------------------------------------------------------
 class ClassifierController : public QObject {
     Q_OBJECT
 
 public:
-    explicit ClassifierController(RxController* appCtrl, QObject* parent = nullptr);
+    // Adds / removes the ClassifierHandler on the pipeline that feeds it.
+    using HandlerHook = std::function<void(IPipelineHandler*)>;
+
+    ClassifierController(HandlerHook attach, HandlerHook detach,
+                         QObject* parent = nullptr);
     ~ClassifierController() override;
 
+    // pythonExe / scriptPath are unused in Mode::Local.
     void start(const QString& pythonExe, const QString& scriptPath);
     void stop();
 
+    // Forwarded to the ClassifierHandler, now or when it is created.
+    // No channels = one wideband snippet per frame.
+    void setIntervalMs(int ms);
+    void setChannels(const QVector<ClassifierChannel>& channels);
+    void setCenterFrequency(double hz);
+    void setMaxInFlight(int frames);
+    // Takes effect on the next start().
+    void setMode(ClassifierHandler::Mode mode);
+
     [[nodiscard]] bool isRunning() const;
 
     static constexpr int kPort = 52001;
 
 signals:
+    // One per result record; classificationReady() is the channel-less view.
+    void channelClassified(quint32 channelId, const QString& type, double confidence,
+                           quint64 timestamp);
     void classificationReady(const QString& type, double confidence);
     void classifierStarted();
     void classifierStopped();
@@ -54,16 +85,28 @@ private slots:
     void onSocketReadyRead();
     void onSocketError(QAbstractSocket::SocketError err);
     void sendFrame(const QByteArray& data);
+    void onLocalResults(const QVector<ClassifierProtocol::Result>& results);
 
 private:
     void attachHandler();
     void detachHandler();
     void teardown();
+    void startLocal();
+    void publishResult(const ClassifierProtocol::Result& r);
 
-    RxController*     appCtrl_;
+    HandlerHook        attach_;
+    HandlerHook        detach_;
+    int                intervalMs_{100};
+    int                maxInFlight_{2};
+    ClassifierHandler::Mode mode_{ClassifierHandler::Mode::Iq};
+    bool               local_{false};   // running without a service
+    double             centerHz_{0.0};
+    QVector<ClassifierChannel> channels_;
     ClassifierHandler* handler_{nullptr};
     QProcess*          process_{nullptr};
     QTcpSocket*        socket_{nullptr};
     QTimer*            connectTimer_{nullptr};   // retry until Python is ready
     QByteArray         readBuf_;
+    bool               helloSeen_{false};
+    QString            failReason_;   // protocol error that ended the process
 };
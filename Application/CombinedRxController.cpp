@@ -35,13 +35,19 @@ void CombinedRxController::startStream(const StreamConfig& cfg) {
             this, &CombinedRxController::fftReady, Qt::QueuedConnection);
 
     if (cfg.recordRaw) {
-        auto* h = new RawFileHandler(cfg.rawPath, cfg.rawFormat);
+        auto* h = new RawFileHandler(cfg.rawPath, cfg.rawFormat, pool_);
+        h->setSegmentPolicy(cfg.segments);
+        h->setInt8Scale(cfg.int8Scale);
+        if (cfg.writeSigMf)
+            h->enableSigMf(cfg.loFreqMHz * 1e6,
+                           QStringLiteral("Combined I/Q, %1 channels").arg(nCh));
         combinedPipeline_->addHandler(h);
         rawHandlers_.push_back(h);
     }
 
     if (cfg.exportWav) {
         auto* h = new BandpassHandler(cfg.wavPath, cfg.wavOffset, cfg.wavBw);
+        h->setSegmentPolicy(cfg.segments);
         combinedPipeline_->addHandler(h);
         wavHandlers_.push_back(h);
     }
@@ -51,13 +57,24 @@ void CombinedRxController::startStream(const StreamConfig& cfg) {
 
     // ── IqCombiner ──────────────────────────────────────────────────────────
     combiner_ = new IqCombiner(nCh, combinedPipeline_);
+    combiner_->publishMetrics(metricLabels());
     for (int i = 0; i < nCh && i < cfg.gainsDb.size(); ++i)
         combiner_->setChannelGain(i, cfg.gainsDb[i]);
+    combiner_->setMode(cfg.combining);
+    combiner_->setPhaseTracking(cfg.trackPhase);
+    combiner_->setDelayPool(pool_);
+    combiner_->setDelayCompensation(cfg.compensateDelay);
+    if (cfg.crossSpectrum) {
+        combiner_->setCrossSpectrum(cfg.crossOptions);
+        combiner_->setCentreFrequency(cfg.loFreqMHz * 1e6);
+    }
     // phaseMetric эмитится из worker-нити (IqCombiner::processBlock) — queued.
     connect(combiner_, &IqCombiner::phaseMetric,
             this, &CombinedRxController::phaseMetric, Qt::QueuedConnection);
     connect(combiner_, &IqCombiner::iqImbalance,
             this, &CombinedRxController::iqImbalance, Qt::QueuedConnection);
+    connect(combiner_, &IqCombiner::crossSpectrum,
+            this, &CombinedRxController::crossSpectrum, Qt::QueuedConnection);
 
     combinedPipeline_->notifyStarted(device_->sampleRate());
 
@@ -84,7 +101,13 @@ void CombinedRxController::startStream(const StreamConfig& cfg) {
         if (i < cfg.rawPerChannelPaths.size()
             && !cfg.rawPerChannelPaths[i].isEmpty()) {
             w.perChannelRaw = new RawFileHandler(cfg.rawPerChannelPaths[i],
-                                                 cfg.rawFormat);
+                                                 cfg.rawFormat, pool_);
+            w.perChannelRaw->setSegmentPolicy(cfg.segments);
+            w.perChannelRaw->setInt8Scale(cfg.int8Scale);
+            if (cfg.writeSigMf)
+                w.perChannelRaw->enableSigMf(
+                    cfg.loFreqMHz * 1e6,
+                    QStringLiteral("RX%1 I/Q before combining").arg(w.channel.channelIndex));
             w.prePipeline->addHandler(w.perChannelRaw);
         }
 
@@ -111,6 +134,12 @@ void CombinedRxController::startStream(const StreamConfig& cfg) {
 
     connect(device_, &IDevice::retuned,
             this, &CombinedRxController::onDeviceRetuned, Qt::DirectConnection);
+    connect(device_, &IDevice::gainChanged,
+            this, &CombinedRxController::onDeviceGainChanged, Qt::DirectConnection);
+
+    // Starting gains as the first annotation of every raw capture.
+    for (const auto& w : workers_)
+        onDeviceGainChanged(w.channel, device_->gain(w.channel));
 
     for (auto& w : workers_)
         w.thread->start();
@@ -130,6 +159,10 @@ void CombinedRxController::setDemodMode(const QString& mode, double offsetHz) {
 
     demodHandler_ = DemodRegistry::instance().create(mode, offsetHz, this);
     if (!demodHandler_) return;
+    Metrics::Labels labels = metricLabels();
+    labels.emplace_back("demod", "combined");
+    labels.emplace_back("mode", mode.toStdString());
+    demodHandler_->publishMetrics(labels);
 
     delete audioOut_;
     audioOut_ = new FmAudioOutput(this);
@@ -198,6 +231,10 @@ void CombinedRxController::removeExtraHandler(IPipelineHandler* h) {
         extraHandlers_.end());
 }
 
+Metrics::Labels CombinedRxController::metricLabels() const {
+    return {{"device", device_->id().toStdString()}};
+}
+
 double CombinedRxController::ifRms() const {
     return demodHandler_ ? demodHandler_->ifRms() : 0.0;
 }
@@ -273,6 +310,8 @@ void CombinedRxController::performCleanup() {
 
     disconnect(device_, &IDevice::retuned,
                this, &CombinedRxController::onDeviceRetuned);
+    disconnect(device_, &IDevice::gainChanged,
+               this, &CombinedRxController::onDeviceGainChanged);
 
     combinedPipeline_->notifyStopped();
     combinedPipeline_->clearHandlers();
@@ -306,5 +345,23 @@ void CombinedRxController::onDeviceRetuned(ChannelDescriptor ch, double hz) {
     if (!ours) return;
 
     if (fftHandler_) fftHandler_->setCenterFrequency(hz / 1e6);
+    if (combiner_) combiner_->setCentreFrequency(hz);
     if (combinedPipeline_) combinedPipeline_->notifyRetune(hz);
+    // PrePipelines are not retune-notified (IqCombiner only needs the centre), but
+    // the shared RXPLL moved every channel — tell the per-channel recorders.
+    for (auto& w : workers_)
+        if (w.perChannelRaw) w.perChannelRaw->onRetune(hz);
+}
+
+void CombinedRxController::onDeviceGainChanged(ChannelDescriptor ch, double dB) {
+    if (ch.direction != ChannelDescriptor::RX) return;
+    bool ours = false;
+    for (auto& w : workers_) {
+        if (w.channel != ch) continue;
+        ours = true;
+        if (w.perChannelRaw) w.perChannelRaw->annotateGain(ch.channelIndex, dB);
+    }
+    if (!ours) return;
+    for (auto* h : rawHandlers_)
+        h->annotateGain(ch.channelIndex, dB);
 }
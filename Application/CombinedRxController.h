@@ -40,6 +40,13 @@ public:
         double  loFreqMHz{102.0};
         QList<ChannelDescriptor> channels;   // e.g. [{RX,0}, {RX,1}]
         QList<double>            gainsDb;    // per-channel gain in dB
+        IqCombiner::Mode         combining{IqCombiner::Mode::Average};
+        bool                     trackPhase{false};   // PhaseAligned / Mrc
+        bool                     compensateDelay{false};
+        // RX0/RX1 cross-spectrum → crossSpectrum(); options are validated
+        // by the caller (IqCombiner::setCrossSpectrum throws).
+        bool                     crossSpectrum{false};
+        CrossSpectrum::Options   crossOptions;
 
         // Combined I/Q capture (after IqCombiner).
         bool    recordRaw{false};
@@ -51,6 +58,9 @@ public:
 
         // Shared sample format for both combined and per-channel raw captures.
         RecordingSettings::RawFormat rawFormat{RecordingSettings::RawFormat::Float32};
+        float   int8Scale{1.0f / 127.0f};   // .ci8, RecordingSettings::int8Scale()
+        bool    writeSigMf{false};   // .sigmf-meta next to every raw capture
+        SegmentedFileWriter::Policy segments;   // raw and WAV captures
 
         bool    exportWav{false};
         QString wavPath;
@@ -83,6 +93,8 @@ public:
     void removeExtraHandler(IPipelineHandler* h);
 
     [[nodiscard]] BaseDemodHandler* demodHandler() const { return demodHandler_; }
+    // Labels for Metrics series published by this stream: {device=<id>}.
+    [[nodiscard]] Metrics::Labels metricLabels() const;
     [[nodiscard]] double ifRms() const;
 
     // Межканальная фазовая калибровка. calibratePhase() снимает текущую сырую
@@ -98,10 +110,13 @@ signals:
     void streamStatus(const QString& msg);
     void streamError(const QString& error);
     void streamFinished();
-    // rawDeg/calDeg: [-180, 180]; coherence: [0, 1]
-    void phaseMetric(double rawDeg, double calDeg, double coherence);
+    // rawDeg/calDeg: [-180, 180]; coherence: [0, 1]; delaySamples: ch1 vs ch0
+    void phaseMetric(double rawDeg, double calDeg, double coherence, double delaySamples);
     // Per-channel I/Q imbalance: ampDb ~ 0 dB, crossCorr ~ 0 when balanced/ortho.
     void iqImbalance(int channelIndex, double ampDb, double crossCorr);
+    // StreamConfig::crossSpectrum: per-bin coherence / phase and the detected
+    // signals' angle of arrival.
+    void crossSpectrum(CrossSpectrumFrame frame);
 
 private:
     struct WorkerEntry {
@@ -116,6 +131,7 @@ private:
     void onWorkerFinished();
     void performCleanup();
     void onDeviceRetuned(ChannelDescriptor ch, double hz);
+    void onDeviceGainChanged(ChannelDescriptor ch, double dB);
 
     IDevice*      device_;
     QThreadPool*  pool_{nullptr};
@@ -18,6 +18,11 @@
 
 #include <algorithm>
 
+namespace {
+// Squelch spin minimum — shown as "Off".
+constexpr double kSquelchMinDb = -120.0;
+}
+
 DemodulatorPanel::DemodulatorPanel(int slotIndex, QWidget* parent)
     : QWidget(parent)
     , slotIndex_(slotIndex)
@@ -91,6 +96,19 @@ void DemodulatorPanel::buildUi() {
     amBwSpin_->setFixedWidth(70);
     amBwSpin_->setToolTip("AM broadcast: 4–5 kHz, SSB: 2–3 kHz");
 
+    auto* sqlLabel = new QLabel("SQL:", row1);
+    squelchSpin_ = new QDoubleSpinBox(row1);
+    squelchSpin_->setRange(kSquelchMinDb, 0.0);
+    squelchSpin_->setDecimals(0);
+    squelchSpin_->setSingleStep(1.0);
+    squelchSpin_->setSuffix(" dB");
+    squelchSpin_->setSpecialValueText("Off");
+    squelchSpin_->setValue(kSquelchMinDb);
+    squelchSpin_->setFixedWidth(70);
+    squelchSpin_->setToolTip(
+        "Squelch threshold, dBFS of channel power.\n"
+        "While the channel is idle demodulation and audio recording are skipped.");
+
     auto* volLabel = new QLabel("Vol:", row1);
     volumeSlider_  = new QSlider(Qt::Horizontal, row1);
     volumeSlider_->setRange(0, 100);
@@ -129,6 +147,9 @@ void DemodulatorPanel::buildUi() {
     hlay1->addWidget(amBwLabel_);
     hlay1->addWidget(amBwSpin_);
     hlay1->addSpacing(8);
+    hlay1->addWidget(sqlLabel);
+    hlay1->addWidget(squelchSpin_);
+    hlay1->addSpacing(8);
     hlay1->addWidget(volLabel);
     hlay1->addWidget(volumeSlider_);
     hlay1->addWidget(volumeLabel_);
@@ -187,6 +208,10 @@ void DemodulatorPanel::buildUi() {
             demodHandler_->setParam("De-emphasis", fmDeemphCombo_->currentData().toDouble());
     });
 
+    connect(squelchSpin_, &QDoubleSpinBox::valueChanged, this, [this](double) {
+        if (demodHandler_) demodHandler_->setSquelch(squelchThresholdDb());
+    });
+
     connect(volumeSlider_, &QSlider::valueChanged, this, [this](int v) {
         volumeLabel_->setText(QString("%1%").arg(v));
         volume_ = static_cast<float>(v) / 100.0f;
@@ -244,6 +269,12 @@ bool DemodulatorPanel::recordingDirValid() const {
     return !recordingDir_.isEmpty() && !recordingTimestamp_.isEmpty();
 }
 
+double DemodulatorPanel::squelchThresholdDb() const {
+    if (!squelchSpin_ || squelchSpin_->value() <= kSquelchMinDb)
+        return BaseDemodulator::kSquelchOff;
+    return squelchSpin_->value();
+}
+
 void DemodulatorPanel::setRecordingContext(const QString& dir,
                                            const QString& timestamp,
                                            const QString& combinedSource,
@@ -295,6 +326,7 @@ void DemodulatorPanel::updateFilteredRecording() {
         recordingCenterHz_, kOutputSR, ".cf32");
 
     filteredHandler_ = new BandpassHandler(path, vfoHz, bwHz, kOutputSR);
+    filteredHandler_->setSegmentPolicy(segmentPolicy_);
     ctrl_->addExtraHandler(filteredHandler_);
 }
 
@@ -326,6 +358,7 @@ void DemodulatorPanel::updateAudioRecording() {
     };
 
     audioHandler_ = new AudioFileHandler(builder, this);
+    audioHandler_->setSegmentPolicy(segmentPolicy_);
     connect(demodHandler_, &BaseDemodHandler::audioReady,
             audioHandler_, &AudioFileHandler::push, Qt::QueuedConnection);
 }
@@ -359,6 +392,12 @@ void DemodulatorPanel::applyDemod() {
     } else {
         demodHandler_->setParam("Bandwidth",   amBwSpin_->value() * 1000.0);
     }
+    demodHandler_->setSquelch(squelchThresholdDb());
+
+    Metrics::Labels labels = ctrl_->metricLabels();
+    labels.emplace_back("demod", "panel" + std::to_string(slotIndex_ + 1));
+    labels.emplace_back("mode", modeStr.toStdString());
+    demodHandler_->publishMetrics(labels);
 
     audioOut_ = new FmAudioOutput(this);
     audioOut_->setVolume(volume_);
@@ -516,6 +555,7 @@ DemodPanelSettings DemodulatorPanel::state() const {
     if (fmDeemphCombo_)  s.fmDeemphSec = fmDeemphCombo_->currentData().toDouble();
     if (amBwSpin_)       s.amBwKHz     = amBwSpin_->value();
     if (volumeSlider_)   s.volumePct   = volumeSlider_->value();
+    if (squelchSpin_)    s.squelchDb   = squelchSpin_->value();
     if (filteredCheck_)  s.recordFiltered = filteredCheck_->isChecked();
     if (audioCheck_)     s.recordAudio    = audioCheck_->isChecked();
     return s;
@@ -537,6 +577,7 @@ void DemodulatorPanel::applyState(const DemodPanelSettings& s) {
     }
     if (fmBwSpin_) { QSignalBlocker b(fmBwSpin_); fmBwSpin_->setValue(s.fmBwKHz); }
     if (amBwSpin_) { QSignalBlocker b(amBwSpin_); amBwSpin_->setValue(s.amBwKHz); }
+    if (squelchSpin_) { QSignalBlocker b(squelchSpin_); squelchSpin_->setValue(s.squelchDb); }
     if (fmDeemphCombo_) {
         const int di = fmDeemphCombo_->findData(s.fmDeemphSec);
         if (di >= 0) {
@@ -569,5 +610,12 @@ void DemodulatorPanel::applyState(const DemodPanelSettings& s) {
 void DemodulatorPanel::updateMetrics() {
     if (!levelLabel_ || !demodHandler_) return;
     const double ifRms = demodHandler_->ifRms();
-    levelLabel_->setText(QString("IF %1").arg(ifRms, 0, 'f', 3));
+    QString text = QString("IF %1").arg(ifRms, 0, 'f', 3);
+    if (demodHandler_->squelch() > BaseDemodulator::kSquelchOff) {
+        text += QString("  %1 dB  %2  CPU -%3%")
+                    .arg(demodHandler_->channelPowerDb(), 0, 'f', 1)
+                    .arg(demodHandler_->squelchOpen() ? "OPEN" : "idle")
+                    .arg(demodHandler_->cpuSavedFraction() * 100.0, 0, 'f', 0);
+    }
+    levelLabel_->setText(text);
 }
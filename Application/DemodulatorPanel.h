@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../Core/DeviceSettings.h"
+#include "../Core/SegmentedFileWriter.h"
 
 #include <QWidget>
 #include <QString>
@@ -52,8 +53,11 @@ public:
                              double         centerFreqHz,
                              bool           filteredAllowed,
                              bool           audioAllowed);
+    // Segmenting for the filtered/audio files; applies from the next
+    // setRecordingContext().
+    void setSegmentPolicy(const SegmentedFileWriter::Policy& policy) { segmentPolicy_ = policy; }
 
-    // Persistence — mode/VFO/BW/volume/recording checkbox state.
+    // Persistence — mode/VFO/BW/squelch/volume/recording checkbox state.
     [[nodiscard]] DemodPanelSettings state() const;
     void applyState(const DemodPanelSettings& s);
 
@@ -73,6 +77,7 @@ private:
     void teardownFilteredRecording();
     void teardownAudioRecording();
     [[nodiscard]] bool recordingDirValid() const;
+    [[nodiscard]] double squelchThresholdDb() const;
 
     int slotIndex_;
     double centerFreqMHz_{102.0};
@@ -99,6 +104,8 @@ private:
     QLabel*         amBwLabel_{nullptr};
     QDoubleSpinBox* amBwSpin_{nullptr};
 
+    QDoubleSpinBox* squelchSpin_{nullptr};
+
     // ── Recording ───────────────────────────────────────────────────────────
     QCheckBox*        filteredCheck_{nullptr};
     QCheckBox*        audioCheck_   {nullptr};
@@ -110,4 +117,5 @@ private:
     double            recordingCenterHz_{0.0};
     bool              filteredAllowed_{false};
     bool              audioAllowed_   {false};
+    SegmentedFileWriter::Policy segmentPolicy_;
 };
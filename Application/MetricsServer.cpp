@@ -0,0 +1,73 @@
+#include "MetricsServer.h"
+#include "../Core/Metrics.h"
+#include "Logger.h"
+
+#include <QHostAddress>
+#include <QTcpSocket>
+#include <QTimer>
+
+MetricsServer::MetricsServer(QObject* parent)
+    : QObject(parent)
+{
+    connect(&server_, &QTcpServer::newConnection, this, &MetricsServer::onNewConnection);
+}
+
+bool MetricsServer::listen(quint16 port, QString* error) {
+    if (!server_.listen(QHostAddress::LocalHost, port)) {
+        if (error) *error = QStringLiteral("metrics: cannot listen on 127.0.0.1:%1 — %2")
+                                .arg(port).arg(server_.errorString());
+        return false;
+    }
+    LOG_INFO("MetricsServer: http://127.0.0.1:" + std::to_string(server_.serverPort())
+             + "/metrics");
+    return true;
+}
+
+void MetricsServer::close() {
+    server_.close();
+}
+
+void MetricsServer::onNewConnection() {
+    while (QTcpSocket* socket = server_.nextPendingConnection()) {
+        connect(socket, &QTcpSocket::readyRead, this, [this, socket] { onReadyRead(socket); });
+        connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+        QTimer::singleShot(kRequestTimeoutMs, socket, [socket] { socket->abort(); });
+    }
+}
+
+void MetricsServer::onReadyRead(QTcpSocket* socket) {
+    // Only the request line matters; headers are ignored and GET has no body.
+    if (socket->property("answered").toBool()) return;
+    if (!socket->canReadLine()) {
+        if (socket->bytesAvailable() > kMaxRequestBytes) socket->abort();
+        return;
+    }
+    socket->setProperty("answered", true);
+
+    const QList<QByteArray> parts = socket->readLine(kMaxRequestBytes).trimmed().split(' ');
+    if (parts.size() != 3 || !parts[2].startsWith("HTTP/")) {
+        reply(socket, "400 Bad Request", "bad request\n");
+        return;
+    }
+    if (parts[0] != "GET") {
+        reply(socket, "405 Method Not Allowed", "only GET\n");
+        return;
+    }
+    const QByteArray path = parts[1].split('?').first();
+    if (path != "/metrics") {
+        reply(socket, "404 Not Found", "try /metrics\n");
+        return;
+    }
+    reply(socket, "200 OK", QByteArray::fromStdString(Metrics::Registry::instance().exposition()),
+          "text/plain; version=0.0.4; charset=utf-8");
+}
+
+void MetricsServer::reply(QTcpSocket* socket, const char* status, const QByteArray& body,
+                          const char* contentType) {
+    QByteArray head = QByteArray("HTTP/1.1 ") + status + "\r\n"
+                    + "Content-Type: " + contentType + "\r\n"
+                    + "Content-Length: " + QByteArray::number(body.size()) + "\r\n"
+                    + "Connection: close\r\n\r\n";
+    socket->write(head + body);
+    socket->disconnectFromHost();
+}
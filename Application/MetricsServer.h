@@ -0,0 +1,44 @@
+#pragma once
+
+#include <QObject>
+#include <QString>
+#include <QTcpServer>
+
+class QTcpSocket;
+
+// ---------------------------------------------------------------------------
+// MetricsServer — serves Metrics::Registry on http://127.0.0.1:<port>/metrics
+// for Prometheus-style scrapers.
+//
+// Bound to the loopback interface only; put a reverse proxy or node exporter
+// in front to reach it from elsewhere. One request per connection: GET
+// /metrics → 200 with the text exposition, other paths 404, anything else
+// 405. A connection that sends no full request within kRequestTimeoutMs or
+// more than kMaxRequestBytes is dropped. Lives on the main thread.
+//
+// Used by the GUI (STAND_METRICS_PORT) and StandHeadless ("metricsPort").
+// ---------------------------------------------------------------------------
+class MetricsServer : public QObject {
+    Q_OBJECT
+
+public:
+    static constexpr quint16 kDefaultPort      = 9464;
+    static constexpr int     kRequestTimeoutMs = 5000;
+    static constexpr int     kMaxRequestBytes  = 8192;
+
+    explicit MetricsServer(QObject* parent = nullptr);
+
+    bool listen(quint16 port, QString* error = nullptr);
+    void close();
+
+    [[nodiscard]] bool    isListening() const { return server_.isListening(); }
+    [[nodiscard]] quint16 port()        const { return server_.serverPort(); }
+
+private:
+    void onNewConnection();
+    void onReadyRead(QTcpSocket* socket);
+    static void reply(QTcpSocket* socket, const char* status, const QByteArray& body,
+                      const char* contentType = "text/plain; charset=utf-8");
+
+    QTcpServer server_;
+};
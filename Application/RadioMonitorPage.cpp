@@ -5,12 +5,18 @@
 #include "RecordingSettingsDialog.h"
 #include "../Core/FileNaming.h"
 #include "../Core/IDevice.h"
+#include "../Core/Logger.h"
+#include "../DSP/AudioFileHandler.h"
+#include "../DSP/PreTriggerRecorder.h"
+#include "../DSP/ScannerHandler.h"
 #include "../Hardware/DeviceController.h"
 #include "qcustomplot.h"
 
 #include <QCheckBox>
 #include <QDir>
 #include <QDoubleSpinBox>
+#include <QFileDialog>
+#include <QFileInfo>
 #include <QHBoxLayout>
 #include <QLabel>
 #include <QMessageBox>
@@ -50,6 +56,12 @@ RadioMonitorPage::RadioMonitorPage(IDevice*          device,
     loadRecordingSettings();
     buildUi();
 
+    scanListPath_ = QSettings().value("scanner/listPath").toString();
+    if (!scanListPath_.isEmpty()) {
+        scanList_ = ScanList::load(scanListPath_);
+        scanListBtn_->setText(QString("Scan list (%1)").arg(scanList_.size()));
+    }
+
     // Default channel selection: one RX0. DeviceDetailWindow overrides via
     // setActiveChannels() once the selection UI is known.
     activeChannels_.append({ChannelDescriptor::RX, 0});
@@ -138,13 +150,39 @@ void RadioMonitorPage::buildUi() {
 
         hlay->addWidget(addDemodBtn_);
         hlay->addSpacing(12);
+        scanCheck_ = new QCheckBox("Scan", row);
+        scanCheck_->setToolTip(
+            "Memory scanner: watch the channels from the scan list inside the\n"
+            "capture and demodulate the active ones (applied at stream start).");
+        scanCheck_->setChecked(QSettings().value("scanner/enabled", false).toBool());
+
+        triggerBtn_ = new QPushButton("Trigger", row);
+        triggerBtn_->setToolTip(
+            "Dump the pre-trigger buffer plus the post-trigger window to disk\n"
+            "(enable the buffer in Recording settings).");
+        triggerBtn_->setEnabled(false);
+
+        scanListBtn_ = new QPushButton("Scan list\u2026", row);
+        scanListBtn_->setToolTip("Load scan list (JSON)");
+
         hlay->addWidget(recordCheck_);
         hlay->addWidget(settingsBtn_);
+        hlay->addWidget(triggerBtn_);
+        hlay->addSpacing(12);
+        hlay->addWidget(scanCheck_);
+        hlay->addWidget(scanListBtn_);
         hlay->addStretch();
         outer->addWidget(row);
 
         connect(addDemodBtn_, &QPushButton::clicked, this, &RadioMonitorPage::addDemodulator);
         connect(settingsBtn_, &QPushButton::clicked, this, &RadioMonitorPage::openRecordingSettings);
+        connect(scanListBtn_, &QPushButton::clicked, this, &RadioMonitorPage::chooseScanList);
+        connect(triggerBtn_,  &QPushButton::clicked, this, [this]() {
+            if (preTrigger_) preTrigger_->trigger();
+        });
+        connect(scanCheck_, &QCheckBox::toggled, this, [](bool on) {
+            QSettings().setValue("scanner/enabled", on);
+        });
     }
 
     // ── Demodulator panels area (scrollable) ─────────────────────────────────
@@ -316,6 +354,8 @@ void RadioMonitorPage::applyFrequency() {
         controller_->setFrequencyChannel(ch, mhz);
 
     if (ctrl_) ctrl_->setFftCenterFreq(mhz);
+    if (scanner_) scanner_->setCenterFrequency(mhz * 1e6);
+    preTriggerCenterHz_.store(mhz * 1e6);
     for (auto* p : panels_) p->setCenterFreqMHz(mhz);
 
     if (centerLine_) {
@@ -352,7 +392,10 @@ void RadioMonitorPage::startStream() {
     // ── Raw/Combined recording paths ────────────────────────────────────────
     if (recordCheck_->isChecked() && !recordingSettings_.outputDir.isEmpty()) {
         QDir().mkpath(recordingSettings_.outputDir);
-        cfg.rawFormat = recordingSettings_.rawFormat;
+        cfg.rawFormat  = recordingSettings_.rawFormat;
+        cfg.writeSigMf = recordingSettings_.writeSigMf;
+        cfg.int8Scale  = recordingSettings_.int8Scale();
+        cfg.segments   = recordingSettings_.segmentPolicy();
         const QString ext = recordingSettings_.rawExtension();
 
         if (recordingSettings_.recordRawPerChannel) {
@@ -385,6 +428,9 @@ void RadioMonitorPage::startStream() {
     // Re-attach panel demodulators now that combinedPipeline_ is live.
     for (auto* p : panels_) p->onStreamStarted();
 
+    startScanner(timestamp, combinedSrc, centerHz);
+    startPreTrigger(combinedSrc, centerHz);
+
     startBtn_->setEnabled(false);
     stopBtn_->setEnabled(true);
     statusLabel_->setStyleSheet("color: #00cc44;");
@@ -404,6 +450,8 @@ void RadioMonitorPage::shutdown() {
     if (!ctrl_) return;
     for (auto* p : panels_) p->onStreamStopped();
     ctrl_->shutdown();
+    stopScanner();
+    stopPreTrigger();
 }
 
 // ---------------------------------------------------------------------------
@@ -417,6 +465,8 @@ void RadioMonitorPage::onStreamErrorInternal(const QString& err) {
 
 void RadioMonitorPage::onStreamFinishedInternal() {
     for (auto* p : panels_) p->onStreamStopped();
+    stopScanner();
+    stopPreTrigger();
 
     if (startBtn_) startBtn_->setEnabled(controller_->isInitialized());
     if (stopBtn_)  stopBtn_->setEnabled(false);
@@ -472,6 +522,7 @@ void RadioMonitorPage::addDemodulator() {
         const bool audioAllowed =
             recordCheck_->isChecked() && recordingSettings_.recordAudio
             && !recordingSettings_.outputDir.isEmpty();
+        panel->setSegmentPolicy(recordingSettings_.segmentPolicy());
         panel->setRecordingContext(recordingSettings_.outputDir,
                                    sessionTimestamp_, combinedSrc, centerHz,
                                    filteredAllowed, audioAllowed);
@@ -605,6 +656,7 @@ void RadioMonitorPage::pushRecordingContextToPanels(const QString& timestamp,
         QDir().mkpath(recordingSettings_.outputDir);
 
     for (auto* p : panels_) {
+        p->setSegmentPolicy(recordingSettings_.segmentPolicy());
         p->setRecordingContext(recordingSettings_.outputDir, timestamp,
                                combinedSource, centerFreqHz,
                                filteredAllowed, audioAllowed);
@@ -625,9 +677,32 @@ void RadioMonitorPage::loadRecordingSettings() {
         s.value("recording/filtered", false).toBool();
     recordingSettings_.recordAudio =
         s.value("recording/audio", false).toBool();
-    recordingSettings_.rawFormat = static_cast<RecordingSettings::RawFormat>(
+    recordingSettings_.rawFormat = static_cast<RecordingSettings::RawFormat>(std::clamp(
         s.value("recording/rawFormat",
-                static_cast<int>(RecordingSettings::RawFormat::Float32)).toInt());
+                static_cast<int>(RecordingSettings::RawFormat::Float32)).toInt(),
+        0, static_cast<int>(RecordingSettings::RawFormat::Int16Lossless)));
+    recordingSettings_.writeSigMf =
+        s.value("recording/sigmf", true).toBool();
+    recordingSettings_.int8FullScaleDbfs =
+        s.value("recording/int8FullScaleDbfs", 0.0).toDouble();
+    recordingSettings_.segmentMinutes =
+        s.value("recording/segmentMinutes", 0.0).toDouble();
+    recordingSettings_.segmentMB =
+        s.value("recording/segmentMB", 0).toInt();
+    recordingSettings_.preTriggerEnabled =
+        s.value("recording/preTrigger", false).toBool();
+    recordingSettings_.preTriggerSec =
+        s.value("recording/preTriggerSec", 5.0).toDouble();
+    recordingSettings_.postTriggerSec =
+        s.value("recording/postTriggerSec", 5.0).toDouble();
+    recordingSettings_.preTriggerInt16 =
+        s.value("recording/preTriggerInt16", true).toBool();
+    recordingSettings_.triggerOffsetKHz =
+        s.value("recording/triggerOffsetKHz", 0.0).toDouble();
+    recordingSettings_.triggerBwKHz =
+        s.value("recording/triggerBwKHz", 0.0).toDouble();
+    recordingSettings_.triggerLevelDb =
+        s.value("recording/triggerLevelDb", -40.0).toDouble();
 }
 
 void RadioMonitorPage::saveRecordingSettings() const {
@@ -638,4 +713,172 @@ void RadioMonitorPage::saveRecordingSettings() const {
     s.setValue("recording/filtered",      recordingSettings_.recordFiltered);
     s.setValue("recording/audio",         recordingSettings_.recordAudio);
     s.setValue("recording/rawFormat",     static_cast<int>(recordingSettings_.rawFormat));
+    s.setValue("recording/sigmf",         recordingSettings_.writeSigMf);
+    s.setValue("recording/int8FullScaleDbfs", recordingSettings_.int8FullScaleDbfs);
+    s.setValue("recording/segmentMinutes", recordingSettings_.segmentMinutes);
+    s.setValue("recording/segmentMB",      recordingSettings_.segmentMB);
+    s.setValue("recording/preTrigger",       recordingSettings_.preTriggerEnabled);
+    s.setValue("recording/preTriggerSec",    recordingSettings_.preTriggerSec);
+    s.setValue("recording/postTriggerSec",   recordingSettings_.postTriggerSec);
+    s.setValue("recording/preTriggerInt16",  recordingSettings_.preTriggerInt16);
+    s.setValue("recording/triggerOffsetKHz", recordingSettings_.triggerOffsetKHz);
+    s.setValue("recording/triggerBwKHz",     recordingSettings_.triggerBwKHz);
+    s.setValue("recording/triggerLevelDb",   recordingSettings_.triggerLevelDb);
+}
+
+// ---------------------------------------------------------------------------
+// Memory scanner
+// ---------------------------------------------------------------------------
+void RadioMonitorPage::chooseScanList() {
+    const QString path = QFileDialog::getOpenFileName(
+        this, "Scan list", scanListPath_.isEmpty()
+                           ? recordingSettings_.outputDir
+                           : QFileInfo(scanListPath_).absolutePath(),
+        "Scan list (*.json)");
+    if (path.isEmpty()) return;
+
+    QString err;
+    const QVector<ScanChannel> list = ScanList::load(path, &err);
+    if (!err.isEmpty()) {
+        QMessageBox::warning(this, "Scan list", err);
+        return;
+    }
+    scanListPath_ = path;
+    scanList_     = list;
+    QSettings().setValue("scanner/listPath", scanListPath_);
+    scanListBtn_->setText(QString("Scan list (%1)").arg(scanList_.size()));
+
+    if (scanner_) scanner_->setChannels(scanList_);
+}
+
+void RadioMonitorPage::startScanner(const QString& timestamp,
+                                    const QString& combinedSource,
+                                    double         centerFreqHz)
+{
+    stopScanner();
+    if (!scanCheck_->isChecked() || scanList_.isEmpty() || !isStreaming()) return;
+
+    scanner_ = new ScannerHandler(this);
+    scanner_->setCenterFrequency(centerFreqHz);
+    scanner_->setMaxActiveDemods(kScannerDemods);
+    scanner_->setChannels(scanList_);
+
+    connect(scanner_, &ScannerHandler::channelActivity,
+            this, &RadioMonitorPage::onScannerActivity, Qt::QueuedConnection);
+    connect(scanner_, &ScannerHandler::channelAudio,
+            this, &RadioMonitorPage::onScannerAudio, Qt::QueuedConnection);
+
+    const bool audioAllowed =
+        recordCheck_->isChecked() && recordingSettings_.recordAudio
+        && !recordingSettings_.outputDir.isEmpty();
+    scanAudioDir_  = audioAllowed ? recordingSettings_.outputDir : QString();
+    scanTimestamp_ = timestamp;
+    scanSource_    = combinedSource;
+    scanCenterHz_  = centerFreqHz;
+
+    ctrl_->addExtraHandler(scanner_);
+}
+
+void RadioMonitorPage::stopScanner() {
+    if (!scanner_) return;
+    if (ctrl_) ctrl_->removeExtraHandler(scanner_);
+    delete scanner_;
+    scanner_ = nullptr;
+
+    for (auto* h : scanAudio_) {
+        h->close();
+        delete h;
+    }
+    scanAudio_.clear();
+}
+
+void RadioMonitorPage::onScannerActivity(int index, bool active, double snrDb) {
+    if (index < 0 || index >= scanList_.size() || !statusLabel_) return;
+    const ScanChannel& c = scanList_[index];
+    const QString name = c.label.isEmpty()
+                       ? QString("%1 MHz").arg(c.freqHz / 1e6, 0, 'f', 4)
+                       : c.label;
+    statusLabel_->setText(active
+        ? QString("Scan: %1 active (SNR %2 dB)").arg(name).arg(snrDb, 0, 'f', 0)
+        : QString("Scan: %1 idle").arg(name));
+}
+
+void RadioMonitorPage::onScannerAudio(int index, QVector<float> samples,
+                                      double sampleRateHz)
+{
+    if (!scanner_ || scanAudioDir_.isEmpty()) return;
+    if (index < 0 || index >= scanList_.size()) return;
+
+    auto it = scanAudio_.find(index);
+    if (it == scanAudio_.end()) {
+        const QString suffix = QStringLiteral("scan%1").arg(index, 2, 10, QLatin1Char('0'));
+        const QString dir    = scanAudioDir_;
+        const QString ts     = scanTimestamp_;
+        const QString src    = scanSource_;
+        const double  freq   = scanList_[index].freqHz;
+        auto builder = [dir, ts, src, suffix, freq](double sr) {
+            return FileNaming::composeWithSuffix(dir, ts, src, suffix, freq, sr, ".wav");
+        };
+        it = scanAudio_.insert(index, new AudioFileHandler(builder, this));
+    }
+    it.value()->push(std::move(samples), sampleRateHz);
+}
+
+// ---------------------------------------------------------------------------
+// Pre-trigger buffer
+// ---------------------------------------------------------------------------
+void RadioMonitorPage::startPreTrigger(const QString& combinedSource, double centerFreqHz) {
+    stopPreTrigger();
+    const RecordingSettings& rs = recordingSettings_;
+    if (!rs.preTriggerEnabled || rs.outputDir.isEmpty() || !isStreaming()) return;
+    QDir().mkpath(rs.outputDir);
+
+    PreTriggerRecorder::Config cfg;
+    cfg.preSeconds       = rs.preTriggerSec;
+    cfg.postSeconds      = rs.postTriggerSec;
+    cfg.int16Storage     = rs.preTriggerInt16;
+    cfg.format           = rs.preTriggerFormat();
+    cfg.powerOffsetHz    = rs.triggerOffsetKHz * 1e3;
+    cfg.powerBandwidthHz = rs.triggerBwKHz * 1e3;
+    cfg.powerThresholdDb = rs.triggerLevelDb;
+
+    // Runs on the recorder's writer thread: timestamp at trigger time, LO
+    // from the atomic mirror (the page outlives the recorder).
+    preTriggerCenterHz_.store(centerFreqHz);
+    const QString dir = rs.outputDir;
+    const QString ext = RecordingSettings::extensionFor(cfg.format);
+    const double  sr  = device_ ? device_->sampleRate() : 0.0;
+    auto builder = [this, dir, ext, sr, combinedSource](const QString& reason) {
+        return FileNaming::composeWithSuffix(dir, FileNaming::currentTimestamp(),
+                                             combinedSource, "trig_" + reason,
+                                             preTriggerCenterHz_.load(), sr, ext);
+    };
+
+    preTrigger_ = new PreTriggerRecorder(cfg, builder, this);
+    connect(preTrigger_, &PreTriggerRecorder::captureStarted, this,
+            [this](const QString& path, const QString& reason) {
+                if (statusLabel_)
+                    statusLabel_->setText(QString("Capture (%1): %2")
+                                              .arg(reason, QFileInfo(path).fileName()));
+            }, Qt::QueuedConnection);
+    connect(preTrigger_, &PreTriggerRecorder::captureFinished, this,
+            [this](const QString& path, qint64 samples, qint64 lost) {
+                if (!statusLabel_) return;
+                QString msg = QString("Saved %1 (%2 samples)")
+                                  .arg(QFileInfo(path).fileName()).arg(samples);
+                if (lost > 0) msg += QString(", %1 lost").arg(lost);
+                statusLabel_->setText(msg);
+            }, Qt::QueuedConnection);
+
+    ctrl_->addExtraHandler(preTrigger_);
+    triggerBtn_->setEnabled(true);
+}
+
+void RadioMonitorPage::stopPreTrigger() {
+    if (triggerBtn_) triggerBtn_->setEnabled(false);
+    if (!preTrigger_) return;
+    // removeExtraHandler → onStreamStopped() flushes and joins the writer.
+    if (ctrl_) ctrl_->removeExtraHandler(preTrigger_);
+    delete preTrigger_;
+    preTrigger_ = nullptr;
 }
@@ -3,12 +3,16 @@
 #include "../Core/ChannelDescriptor.h"
 #include "../Core/DeviceSettings.h"
 #include "../Core/RecordingSettings.h"
+#include "../Core/ScanList.h"
 #include "../DSP/FftProcessor.h"
 
 #include <QWidget>
 #include <QList>
+#include <QMap>
 #include <QVector>
 
+#include <atomic>
+
 class QCustomPlot;
 class QCPItemLine;
 class QCPItemRect;
@@ -24,6 +28,9 @@ class IDevice;
 class DeviceController;
 class CombinedRxController;
 class DemodulatorPanel;
+class ScannerHandler;
+class AudioFileHandler;
+class PreTriggerRecorder;
 
 // ---------------------------------------------------------------------------
 // RadioMonitorPage — единая вкладка радиомониторинга.
@@ -31,7 +38,7 @@ class DemodulatorPanel;
 // Layout:
 //   [ Freq spinbox+slider / Apply ]
 //   [ FFT plot (single spectrum, combined I/Q) ]
-//   [ + Add demodulator ] [ Record ] [ Settings ]
+//   [ + Add demodulator ] [ Record ] [ Settings ] [ Trigger ] [ Scan ] [ Scan list ]
 //   [ DemodulatorPanel 1 … DemodulatorPanel N ]  (макс 4)
 //   [ Start / Stop ] [ Status ]
 //
@@ -87,6 +94,7 @@ private slots:
     void addDemodulator();
     void removeDemodulator(int slotIndex);
     void openRecordingSettings();
+    void chooseScanList();
 
 private:
     void buildUi();
@@ -98,6 +106,20 @@ private:
     void loadRecordingSettings();
     void saveRecordingSettings() const;
 
+    // Memory scanner — created per stream when "Scan" is checked and a list
+    // is loaded; active channels are reported in the status line and, when
+    // audio recording is allowed, written to one WAV per channel.
+    void startScanner(const QString& timestamp, const QString& combinedSource,
+                      double centerFreqHz);
+    void stopScanner();
+    void onScannerActivity(int index, bool active, double snrDb);
+    void onScannerAudio(int index, QVector<float> samples, double sampleRateHz);
+
+    // Pre-trigger buffer — armed per stream when enabled in recording
+    // settings; Trigger dumps the buffered window to "<…>_trig_<reason>".
+    void startPreTrigger(const QString& combinedSource, double centerFreqHz);
+    void stopPreTrigger();
+
     IDevice*          device_;
     DeviceController* controller_;
     QThreadPool*      dspPool_;
@@ -136,7 +158,25 @@ private:
     RecordingSettings recordingSettings_{};
     QString           sessionTimestamp_;     // set at startStream, reused for mid-session panels
 
+    // ── Pre-trigger buffer ───────────────────────────────────────────────────
+    QPushButton*         triggerBtn_{nullptr};
+    PreTriggerRecorder*  preTrigger_{nullptr};
+    std::atomic<double>  preTriggerCenterHz_{0.0};   // read by the writer thread
+
+    // ── Memory scanner ───────────────────────────────────────────────────────
+    QCheckBox*           scanCheck_{nullptr};
+    QPushButton*         scanListBtn_{nullptr};
+    QString              scanListPath_;
+    QVector<ScanChannel> scanList_;
+    ScannerHandler*      scanner_{nullptr};
+    QMap<int, AudioFileHandler*> scanAudio_;   // channel index → WAV writer
+    QString              scanAudioDir_;         // empty = no scanner audio recording
+    QString              scanTimestamp_;
+    QString              scanSource_;
+    double               scanCenterHz_{0.0};
+
     static constexpr int    kMaxDemods       = 4;
+    static constexpr int    kScannerDemods   = 2;    // simultaneous scanner demodulators
     static constexpr double kFreqMinMHz      =   30.0;
     static constexpr double kFreqMaxMHz      = 3800.0;
     static constexpr double kFreqDefaultMHz  =  102.0;
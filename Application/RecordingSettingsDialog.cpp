@@ -1,16 +1,23 @@
 #include "RecordingSettingsDialog.h"
+#include "../DSP/PreTriggerRecorder.h"
 
 #include <QCheckBox>
 #include <QComboBox>
 #include <QDialogButtonBox>
 #include <QDir>
+#include <QDoubleSpinBox>
 #include <QFileDialog>
+#include <QFormLayout>
+#include <QGroupBox>
 #include <QHBoxLayout>
 #include <QLabel>
 #include <QLineEdit>
 #include <QPushButton>
+#include <QSpinBox>
 #include <QVBoxLayout>
 
+#include <algorithm>
+
 RecordingSettingsDialog::RecordingSettingsDialog(const RecordingSettings& initial,
                                                  QWidget* parent)
     : QDialog(parent)
@@ -52,6 +59,14 @@ void RecordingSettingsDialog::buildUi() {
                              static_cast<int>(RecordingSettings::RawFormat::Float32));
     rawFormatCombo_->addItem(QStringLiteral(".cf64 (float64)"),
                              static_cast<int>(RecordingSettings::RawFormat::Float64));
+    rawFormatCombo_->addItem(QStringLiteral(".ci16 (int16, native)"),
+                             static_cast<int>(RecordingSettings::RawFormat::Int16));
+    rawFormatCombo_->addItem(QStringLiteral(".ci12 (packed 12-bit)"),
+                             static_cast<int>(RecordingSettings::RawFormat::Int12));
+    rawFormatCombo_->addItem(QStringLiteral(".ci8 (scaled int8)"),
+                             static_cast<int>(RecordingSettings::RawFormat::Int8));
+    rawFormatCombo_->addItem(QStringLiteral(".ci16z (int16, lossless compressed)"),
+                             static_cast<int>(RecordingSettings::RawFormat::Int16Lossless));
     rawFormatCombo_->setCurrentIndex(static_cast<int>(initial_.rawFormat));
 
     rawPerChannelCheck_ = new QCheckBox(tr("Raw I/Q per channel (before combining)"), this);
@@ -80,10 +95,139 @@ void RecordingSettingsDialog::buildUi() {
     };
 
     outer->addWidget(rowWithFormat(rawPerChannelCheck_, rawFormatCombo_));
+
+    // .ci8 scale: the level written as ±127, fixed for the whole file.
+    {
+        int8FullScaleSpin_ = new QDoubleSpinBox(this);
+        int8FullScaleSpin_->setRange(-90.0, 0.0);
+        int8FullScaleSpin_->setDecimals(0);
+        int8FullScaleSpin_->setSingleStep(6.0);
+        int8FullScaleSpin_->setSuffix(tr(" dBFS"));
+        int8FullScaleSpin_->setValue(initial_.int8FullScaleDbfs);
+        int8FullScaleSpin_->setToolTip(tr("Input level stored as \u00b1127 in .ci8 files.\n"
+                                          "0 dBFS never clips; lower it towards the expected\n"
+                                          "peak to keep weak signals above the int8 step."));
+        auto* row = new QHBoxLayout;
+        row->addStretch();
+        row->addWidget(new QLabel(tr(".ci8 full scale:"), this));
+        row->addWidget(int8FullScaleSpin_);
+        outer->addLayout(row);
+
+        auto syncInt8 = [this] {
+            int8FullScaleSpin_->setEnabled(rawFormatCombo_->currentData().toInt()
+                                           == static_cast<int>(RecordingSettings::RawFormat::Int8));
+        };
+        connect(rawFormatCombo_, &QComboBox::currentIndexChanged, this, syncInt8);
+        syncInt8();
+    }
+
     outer->addWidget(rowWithFormat(combinedCheck_, nullptr));
     outer->addWidget(rowWithFormat(filteredCheck_, nullptr));
     outer->addWidget(rowWithFormat(audioCheck_,    nullptr));
 
+    sigmfCheck_ = new QCheckBox(tr("SigMF metadata for raw I/Q (.sigmf-meta)"), this);
+    sigmfCheck_->setChecked(initial_.writeSigMf);
+    sigmfCheck_->setToolTip(tr("Capture segments per retune, gain changes and a\n"
+                               "1 s time \u2192 sample index for fast seeking."));
+    outer->addWidget(sigmfCheck_);
+
+    // ── Segmenting ──────────────────────────────────────────────────────────
+    {
+        auto* row = new QHBoxLayout;
+        segMinutesSpin_ = new QDoubleSpinBox(this);
+        segMinutesSpin_->setRange(0.0, 24 * 60.0);
+        segMinutesSpin_->setDecimals(1);
+        segMinutesSpin_->setSingleStep(5.0);
+        segMinutesSpin_->setSuffix(tr(" min"));
+        segMinutesSpin_->setSpecialValueText(tr("Off"));
+        segMinutesSpin_->setValue(initial_.segmentMinutes);
+
+        segMbSpin_ = new QSpinBox(this);
+        segMbSpin_->setRange(0, 1024 * 1024);
+        segMbSpin_->setSingleStep(1024);
+        segMbSpin_->setSuffix(tr(" MiB"));
+        segMbSpin_->setSpecialValueText(tr("Off"));
+        segMbSpin_->setValue(initial_.segmentMB);
+
+        const QString tip = tr("Start a new file (\u2026_seg0002, \u2026) at whichever limit\n"
+                               "comes first. Each segment is preallocated and\n"
+                               "finalised when the next one starts.");
+        segMinutesSpin_->setToolTip(tip);
+        segMbSpin_->setToolTip(tip);
+
+        row->addWidget(new QLabel(tr("Split files every:"), this));
+        row->addWidget(segMinutesSpin_);
+        row->addWidget(new QLabel(tr("or"), this));
+        row->addWidget(segMbSpin_);
+        row->addStretch();
+        outer->addLayout(row);
+    }
+
+    outer->addSpacing(8);
+
+    // ── Pre-trigger buffer ──────────────────────────────────────────────────
+    {
+        auto* box  = new QGroupBox(tr("Pre-trigger buffer (combined I/Q)"), this);
+        auto* form = new QFormLayout(box);
+
+        preTriggerCheck_ = new QCheckBox(tr("Keep the last seconds in memory"), box);
+        preTriggerCheck_->setChecked(initial_.preTriggerEnabled);
+        preTriggerCheck_->setToolTip(
+            tr("Trigger dumps [trigger \u2212 pre, trigger + post] to disk\n"
+               "as float I/Q. Manual trigger: Trigger button."));
+
+        // Captures are float only; show what the raw format turns into.
+        preTriggerFormatLabel_ = new QLabel(box);
+        auto syncFormat = [this] {
+            RecordingSettings s;
+            s.rawFormat = static_cast<RecordingSettings::RawFormat>(
+                rawFormatCombo_->currentData().toInt());
+            const QString ext = RecordingSettings::extensionFor(s.preTriggerFormat());
+            preTriggerFormatLabel_->setText(
+                s.preTriggerFormat() == s.rawFormat
+                    ? ext
+                    : tr("%1 (%2 is not available for captures)")
+                          .arg(ext, RecordingSettings::extensionFor(s.rawFormat)));
+        };
+        connect(rawFormatCombo_, &QComboBox::currentIndexChanged, this, syncFormat);
+        syncFormat();
+
+        auto makeSpin = [box](double lo, double hi, double step, int dec,
+                              const QString& suffix, double value) {
+            auto* sp = new QDoubleSpinBox(box);
+            sp->setRange(lo, hi);
+            sp->setSingleStep(step);
+            sp->setDecimals(dec);
+            sp->setSuffix(suffix);
+            sp->setValue(value);
+            return sp;
+        };
+        preSecSpin_     = makeSpin(0.0, 60.0, 1.0, 1, tr(" s"), initial_.preTriggerSec);
+        postSecSpin_    = makeSpin(0.1, 600.0, 1.0, 1, tr(" s"), initial_.postTriggerSec);
+        trigOffsetSpin_ = makeSpin(-50'000.0, 50'000.0, 10.0, 1, tr(" kHz"),
+                                   initial_.triggerOffsetKHz);
+        trigBwSpin_     = makeSpin(0.0, 10'000.0, 5.0, 1, tr(" kHz"), initial_.triggerBwKHz);
+        trigBwSpin_->setSpecialValueText(tr("Off"));
+        // 0 = off; anything else at least the recorder's floor.
+        connect(trigBwSpin_, &QDoubleSpinBox::editingFinished, this, [this] {
+            trigBwSpin_->setValue(triggerBwKHz());
+        });
+        trigLevelSpin_  = makeSpin(-120.0, 0.0, 1.0, 0, tr(" dBFS"), initial_.triggerLevelDb);
+
+        int16Check_ = new QCheckBox(tr("Store as int16 (half the RAM)"), box);
+        int16Check_->setChecked(initial_.preTriggerInt16);
+
+        form->addRow(preTriggerCheck_);
+        form->addRow(tr("Pre-trigger:"),  preSecSpin_);
+        form->addRow(tr("Post-trigger:"), postSecSpin_);
+        form->addRow(tr("Capture format:"), preTriggerFormatLabel_);
+        form->addRow(int16Check_);
+        form->addRow(tr("Power trigger offset:"),    trigOffsetSpin_);
+        form->addRow(tr("Power trigger bandwidth:"), trigBwSpin_);
+        form->addRow(tr("Power trigger level:"),     trigLevelSpin_);
+        outer->addWidget(box);
+    }
+
     outer->addStretch();
 
     // ── OK / Cancel ─────────────────────────────────────────────────────────
@@ -104,6 +248,11 @@ void RecordingSettingsDialog::browseDir() {
         dirEdit_->setText(dir);
 }
 
+double RecordingSettingsDialog::triggerBwKHz() const {
+    const double v = trigBwSpin_->value();
+    return v > 0.0 ? std::max(v, PreTriggerRecorder::kMinPowerBandwidthHz / 1e3) : 0.0;
+}
+
 RecordingSettings RecordingSettingsDialog::settings() const {
     RecordingSettings out = initial_;
     out.outputDir           = dirEdit_->text();
@@ -113,5 +262,16 @@ RecordingSettings RecordingSettingsDialog::settings() const {
     out.recordAudio         = audioCheck_->isChecked();
     out.rawFormat = static_cast<RecordingSettings::RawFormat>(
         rawFormatCombo_->currentData().toInt());
+    out.writeSigMf = sigmfCheck_->isChecked();
+    out.int8FullScaleDbfs = int8FullScaleSpin_->value();
+    out.segmentMinutes = segMinutesSpin_->value();
+    out.segmentMB      = segMbSpin_->value();
+    out.preTriggerEnabled = preTriggerCheck_->isChecked();
+    out.preTriggerSec     = preSecSpin_->value();
+    out.postTriggerSec    = postSecSpin_->value();
+    out.preTriggerInt16   = int16Check_->isChecked();
+    out.triggerOffsetKHz  = trigOffsetSpin_->value();
+    out.triggerBwKHz      = triggerBwKHz();
+    out.triggerLevelDb    = trigLevelSpin_->value();
     return out;
 }
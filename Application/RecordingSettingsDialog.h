@@ -7,12 +7,17 @@
 class QLineEdit;
 class QCheckBox;
 class QComboBox;
+class QDoubleSpinBox;
+class QLabel;
+class QSpinBox;
 
 // ---------------------------------------------------------------------------
 // RecordingSettingsDialog — modal dialog exposing RecordingSettings fields:
 //   • output directory (line edit + Browse button)
 //   • what to record (4 checkboxes)
-//   • raw format selector (.cf32 / .cf64)
+//   • raw format selector (.cf32 … .ci16z) and the .ci8 full scale
+//   • file segmenting (minutes / MiB per segment)
+//   • pre-trigger buffer (window lengths, int16 ring, power trigger band)
 //
 // UI matches the mock in the v2 refactor plan. The caller supplies an initial
 // RecordingSettings snapshot and retrieves the edited copy via settings()
@@ -29,6 +34,7 @@ public:
 private:
     void buildUi();
     void browseDir();
+    [[nodiscard]] double triggerBwKHz() const;   // spin value, raised to the recorder floor
 
     RecordingSettings  initial_;
 
@@ -38,4 +44,17 @@ private:
     QCheckBox*         filteredCheck_{nullptr};
     QCheckBox*         audioCheck_{nullptr};
     QComboBox*         rawFormatCombo_{nullptr};
+    QDoubleSpinBox*    int8FullScaleSpin_{nullptr};
+    QCheckBox*         sigmfCheck_{nullptr};
+    QDoubleSpinBox*    segMinutesSpin_{nullptr};
+    QSpinBox*          segMbSpin_{nullptr};
+
+    QCheckBox*         preTriggerCheck_{nullptr};
+    QLabel*            preTriggerFormatLabel_{nullptr};
+    QDoubleSpinBox*    preSecSpin_{nullptr};
+    QDoubleSpinBox*    postSecSpin_{nullptr};
+    QCheckBox*         int16Check_{nullptr};
+    QDoubleSpinBox*    trigOffsetSpin_{nullptr};
+    QDoubleSpinBox*    trigBwSpin_{nullptr};
+    QDoubleSpinBox*    trigLevelSpin_{nullptr};
 };
@@ -91,6 +91,10 @@ void RxController::setDemodMode(const QString& mode, double offsetHz) {
 
     demodHandler_ = DemodRegistry::instance().create(mode, offsetHz, this);
     if (!demodHandler_) return;
+    demodHandler_->publishMetrics({{"device",  device_->id().toStdString()},
+                                   {"channel", "RX" + std::to_string(channel_.channelIndex)},
+                                   {"demod",   "single"},
+                                   {"mode",    mode.toStdString()}});
 
     delete audioOut_;
     audioOut_ = new FmAudioOutput(this);
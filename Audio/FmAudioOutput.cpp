@@ -1,5 +1,6 @@
 #include "FmAudioOutput.h"
 #include "Logger.h"
+#include "Trace.h"
 
 #include <algorithm>
 #include <cmath>
@@ -72,6 +73,7 @@ void FmAudioOutput::teardown() {
 // push() — called from main thread via QueuedConnection
 // ---------------------------------------------------------------------------
 void FmAudioOutput::push(QVector<float> samples, double sampleRateHz) {
+    TRACE_SCOPE("audio", "FmAudioOutput::push");
     if (samples.isEmpty()) return;
 
     if (!sink_ || openedForRate_ != sampleRateHz) {
@@ -223,31 +225,3 @@ bool FmAudioOutput::openSink(double sampleRateHz) {
     emit statusChanged(statusText_, false);
     return true;
 }
-
-// ---------------------------------------------------------------------------
-// LinearResampler::process
-// ---------------------------------------------------------------------------
-QVector<float> FmAudioOutput::LinearResampler::process(
-    const QVector<float>& in, double inRate, double outRate)
-{
-    if (in.isEmpty() || inRate <= 0 || outRate <= 0) return {};
-
-    const double step = inRate / outRate;
-    QVector<float> out;
-    out.reserve(static_cast<int>(in.size() * outRate / inRate) + 2);
-
-    while (true) {
-        const int i = static_cast<int>(phase);
-        if (i >= in.size()) {
-            phase -= in.size();
-            prev = in.back();
-            break;
-        }
-        const float s0   = (i == 0) ? prev : in[i - 1];
-        const float s1   = in[i];
-        const float frac = static_cast<float>(phase - static_cast<double>(i));
-        out.push_back(s0 + frac * (s1 - s0));
-        phase += step;
-    }
-    return out;
-}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "../DSP/LinearResampler.h"
+
 #include <QObject>
 #include <QVector>
 #include <QAudioSink>
@@ -49,12 +51,7 @@ signals:
 
 private:
     // ── Linear resampler ─────────────────────────────────────────────────────
-    struct LinearResampler {
-        double phase{0.0};
-        float  prev{0.0f};
-        QVector<float> process(const QVector<float>& in, double inRate, double outRate);
-        void reset() { phase = 0.0; prev = 0.0f; }
-    } resampler_;
+    LinearResampler resampler_;
 
     // ── Sink state ────────────────────────────────────────────────────────────
     QAudioSink* sink_{nullptr};
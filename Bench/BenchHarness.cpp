@@ -0,0 +1,55 @@
+#include "BenchHarness.h"
+
+#include <QJsonDocument>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+bool BenchHarness::matches(const QString& name) const {
+    return options_.filter.isEmpty() || name.contains(options_.filter);
+}
+
+void BenchHarness::run(const QString& name, const QJsonObject& params, int64_t samplesPerCall,
+                       const std::function<void()>& fn) {
+    if (!matches(name) || samplesPerCall <= 0) return;
+    using Clock = std::chrono::steady_clock;
+
+    const auto timeBatch = [&fn](int64_t calls) {
+        const auto t0 = Clock::now();
+        for (int64_t i = 0; i < calls; ++i) fn();
+        return std::chrono::duration<double>(Clock::now() - t0).count();
+    };
+
+    fn();   // warm-up
+
+    const int    reps  = std::max(1, options_.repetitions);
+    const double slice = options_.minSeconds / reps;
+    int64_t calls = 1;
+    while (timeBatch(calls) < slice && calls < (int64_t{1} << 40)) calls *= 2;
+
+    std::vector<double> nsPerSample;
+    for (int r = 0; r < reps; ++r)
+        nsPerSample.push_back(timeBatch(calls) * 1e9 / static_cast<double>(calls * samplesPerCall));
+    std::sort(nsPerSample.begin(), nsPerSample.end());
+    const double median = nsPerSample[nsPerSample.size() / 2];
+    const double best   = nsPerSample.front();
+
+    QJsonObject r;
+    r["name"]             = name;
+    r["params"]           = params;
+    r["samplesPerCall"]   = static_cast<qint64>(samplesPerCall);
+    r["callsPerRep"]      = static_cast<qint64>(calls);
+    r["repetitions"]      = reps;
+    r["nsPerSample"]      = median;
+    r["nsPerSampleBest"]  = best;
+    r["msps"]             = 1e3 / median;
+    r["mspsBest"]         = 1e3 / best;
+    results_.append(r);
+
+    std::fprintf(stderr, "%-22s %-40s %10.3f ns/sample %10.2f MS/s\n",
+                 name.toUtf8().constData(),
+                 QJsonDocument(params).toJson(QJsonDocument::Compact).constData(),
+                 median, 1e3 / median);
+}
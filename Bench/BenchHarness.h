@@ -0,0 +1,49 @@
+#pragma once
+
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QString>
+#include <cstdint>
+#include <functional>
+
+// ---------------------------------------------------------------------------
+// BenchHarness — times a kernel call repeatedly and collects the results as
+// JSON for StandBench.
+//
+// run() calls fn once untimed (plan creation, first-touch allocation), then
+// doubles the batch size until one batch lasts minSeconds / repetitions, and
+// times `repetitions` such batches. Each result records the median and best
+// ns/sample and MS/s, where a "sample" is whatever samplesPerCall counts
+// (I/Q pairs in, audio samples in, FIR taps out).
+// ---------------------------------------------------------------------------
+class BenchHarness {
+public:
+    struct Options {
+        double  minSeconds{0.5};   // per kernel, all repetitions together
+        int     repetitions{5};
+        QString filter;            // run only names containing this
+    };
+
+    explicit BenchHarness(const Options& options) : options_(options) {}
+
+    void run(const QString& name, const QJsonObject& params, int64_t samplesPerCall,
+             const std::function<void()>& fn);
+
+    [[nodiscard]] bool matches(const QString& name) const;
+    [[nodiscard]] const QJsonArray& results() const { return results_; }
+    [[nodiscard]] const Options&    options() const { return options_; }
+
+private:
+    Options    options_;
+    QJsonArray results_;
+};
+
+// Keeps a result alive across the optimiser without costing a store.
+inline void benchKeep(const void* p) {
+#if defined(__GNUC__)
+    asm volatile("" : : "g"(p) : "memory");
+#else
+    static const void* volatile sink;
+    sink = p;
+#endif
+}
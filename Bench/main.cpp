@@ -0,0 +1,320 @@
+#include "BenchHarness.h"
+#include "AmDemodulator.h"
+#include "BandpassExporter.h"
+#include "CrossSpectrum.h"
+#include "DelayEstimator.h"
+#include "DspUtils.h"
+#include "FftProcessor.h"
+#include "FmDemodulator.h"
+#include "FractionalDelay.h"
+#include "IqCombiner.h"
+#include "IqFormats.h"
+#include "LinearResampler.h"
+#include "Pipeline.h"
+#include "SpectralCorrelation.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QJsonDocument>
+#include <QSaveFile>
+#include <QSysInfo>
+#include <QThread>
+
+#include <cmath>
+#include <cstdio>
+#include <exception>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// StandBench — throughput of every hot DSP kernel, as JSON:
+//   `StandBench [--output bench.json] [--filter demod.fm] [--min-time 0.5]`
+//
+// Inputs are synthetic (an FM carrier in noise, RxWorker-sized blocks) and
+// identical between runs, so two reports from the same machine compare
+// directly. Progress goes to stderr; the report to --output or stdout.
+// ---------------------------------------------------------------------------
+namespace {
+
+constexpr int kBlockPairs = 16384;   // RxWorker::kBlockSize
+
+// The rates the demodulators are built for (LimeDevice::kSupportedRates up
+// to 20 MS/s, see docs/dsp.md).
+const std::vector<double> kSampleRates = {2.5e6, 4e6, 5e6, 8e6, 10e6, 15e6, 20e6};
+
+// FM carrier at offsetHz (75 kHz deviation, 1 kHz tone) plus noise, one block.
+std::vector<float> makeIq(int pairs, double sampleRateHz, double offsetHz) {
+    std::mt19937 rng(1);
+    std::normal_distribution<float> noise(0.0f, 0.01f);
+    std::vector<float> iq(2 * static_cast<std::size_t>(pairs));
+    double phase = 0.0;
+    for (int n = 0; n < pairs; ++n) {
+        const double tone = std::sin(2.0 * dsp::kPi * 1000.0 * n / sampleRateHz);
+        phase += 2.0 * dsp::kPi * (offsetHz + 75e3 * tone) / sampleRateHz;
+        iq[2 * n]     = 0.3f * static_cast<float>(std::cos(phase)) + noise(rng);
+        iq[2 * n + 1] = 0.3f * static_cast<float>(std::sin(phase)) + noise(rng);
+    }
+    return iq;
+}
+
+QJsonObject rateParams(double sampleRateHz) {
+    return {{"sampleRateMSps", sampleRateHz / 1e6}};
+}
+
+void benchFft(BenchHarness& h) {
+    const auto iq = makeIq(65536, 2e6, 100e3);
+    for (int size = 1024; size <= 65536; size *= 2) {
+        h.run(QStringLiteral("fft"), {{"size", size}}, size, [&] {
+            const FftFrame f = FftProcessor::process(iq.data(), size, 102.0, 2e6);
+            benchKeep(f.powerDb.constData());
+        });
+    }
+}
+
+template <typename Demod>
+void benchDemod(BenchHarness& h, const QString& name) {
+    if (!h.matches(name)) return;
+    for (double sr : kSampleRates) {
+        try {
+            Demod dem(sr, 100e3);
+            const auto iq = makeIq(kBlockPairs, sr, 100e3);
+            h.run(name, rateParams(sr), kBlockPairs, [&] {
+                const QVector<float> a = dem.pushBlock(iq.data(), kBlockPairs);
+                benchKeep(a.constData());
+            });
+        } catch (const std::exception& ex) {
+            std::fprintf(stderr, "%s @ %.1f MS/s skipped: %s\n",
+                         name.toUtf8().constData(), sr / 1e6, ex.what());
+        }
+    }
+}
+
+void benchBandpass(BenchHarness& h) {
+    // process() is pushBlock() without handing the block to the file writer.
+    if (!h.matches(QStringLiteral("bandpass"))) return;
+    for (double sr : kSampleRates) {
+        BandpassExporter exp(sr, 100e3, 100e3, 250e3);
+        const auto iq = makeIq(kBlockPairs, sr, 100e3);
+        std::vector<float> out;
+        h.run(QStringLiteral("bandpass"), rateParams(sr), kBlockPairs, [&] {
+            out.clear();
+            exp.process(iq.data(), kBlockPairs, out);
+            benchKeep(out.data());
+        });
+    }
+}
+
+void benchCombiner(BenchHarness& h) {
+    if (!h.matches(QStringLiteral("combiner"))) return;
+    const auto iq = makeIq(kBlockPairs, 2e6, 100e3);
+    using Mode = IqCombiner::Mode;
+    const std::pair<Mode, const char*> modes[] = {
+        {Mode::Average, "average"}, {Mode::PhaseAligned, "phase"}, {Mode::Mrc, "mrc"}};
+    for (int channels : {1, 2, 4}) {
+        for (const auto& [mode, modeName] : modes) {
+            if (channels == 1 && mode != Mode::Average) continue;   // no weights to apply
+            Pipeline out;                        // no handlers: measures the combine only
+            IqCombiner comb(channels, &out);
+            comb.setMode(mode);
+            comb.onStreamStarted(2e6);
+            uint64_t ts = 0;
+            h.run(QStringLiteral("combiner"), {{"channels", channels}, {"mode", modeName}},
+                  kBlockPairs, [&] {
+                      for (int ch = 0; ch < channels; ++ch)
+                          comb.processBlock(iq.data(), kBlockPairs, 2e6,
+                                            BlockMeta{{ChannelDescriptor::RX, ch}, ts});
+                      ts += kBlockPairs;
+                  });
+        }
+    }
+}
+
+void benchResampler(BenchHarness& h) {
+    // One demodulator block of audio (2 MS/s / 40 ≈ 410 samples) per call,
+    // to the usual sound-card rates.
+    QVector<float> in(410);
+    for (int i = 0; i < in.size(); ++i) in[i] = static_cast<float>(std::sin(0.05 * i));
+    for (double outRate : {44100.0, 48000.0}) {
+        LinearResampler rs;
+        h.run(QStringLiteral("resampler"), {{"inRate", 50000}, {"outRate", outRate}},
+              in.size(), [&] {
+                  const QVector<float> o = rs.process(in, 50000.0, outRate);
+                  benchKeep(o.constData());
+              });
+    }
+}
+
+void benchFirDesign(BenchHarness& h) {
+    for (int taps : {31, 127, 255}) {
+        h.run(QStringLiteral("fir.design"), {{"taps", taps}}, taps, [&] {
+            const auto fir = dsp::designLowpassFir(taps, 0.1);
+            benchKeep(fir.data());
+        });
+    }
+}
+
+void benchDelay(BenchHarness& h) {
+    // The combiner's per-chunk compensation filter and its periodic estimate.
+    constexpr int R = FractionalDelay::kReach;
+    const auto iq = makeIq(kBlockPairs + 2 * R, 2e6, 100e3);
+    std::vector<float> out(2 * kBlockPairs);
+    FractionalDelay fd;
+    h.run(QStringLiteral("fracdelay"), {{"taps", FractionalDelay::kTaps}}, kBlockPairs, [&] {
+        fd.process(iq.data() + 2 * R, kBlockPairs, 2.37, out.data());
+        benchKeep(out.data());
+    });
+
+    DelayEstimator est;
+    h.run(QStringLiteral("delay.estimate"), {{"pairs", IqCombiner::kDelayPairs}},
+          IqCombiner::kDelayPairs, [&] {
+              const DelayEstimate e = est.estimate(iq.data(), iq.data() + 2 * R,
+                                                   IqCombiner::kDelayPairs);
+              benchKeep(&e);
+          });
+}
+
+void benchInt16ToFloat(BenchHarness& h) {
+    std::vector<int16_t> in(2 * kBlockPairs);
+    for (std::size_t i = 0; i < in.size(); ++i)
+        in[i] = static_cast<int16_t>((static_cast<int>(i) * 7919) % 65536 - 32768);
+    std::vector<float> out(in.size());
+    h.run(QStringLiteral("int16ToFloat"), {{"pairs", kBlockPairs}}, kBlockPairs, [&] {
+        IqFormats::int16ToFloat(in.data(), out.data(), in.size());
+        benchKeep(out.data());
+    });
+}
+
+void benchSpectralCorrelation(BenchHarness& h) {
+    // One classifier snippet (1024 pairs) per call, serial and on the global pool.
+    if (!h.matches(QStringLiteral("scf.fam"))) return;
+    const auto iq = makeIq(1024, 62'500.0, 5e3);
+    for (int channels : {16, 32, 64}) {
+        for (int tasks : {1, 0}) {
+            SpectralCorrelation::Options o;
+            o.channels = channels;
+            o.tasks    = tasks;
+            SpectralCorrelation scf(o);
+            h.run(QStringLiteral("scf.fam"),
+                  {{"channels", channels}, {"pool", tasks == 0}}, 1024, [&] {
+                      const CyclicProfile p = scf.profile(iq.data(), 1024, 62'500.0);
+                      benchKeep(p.magnitude.constData());
+                  });
+        }
+    }
+}
+
+void benchCrossSpectrum(BenchHarness& h) {
+    // One IqCombiner cross-spectrum frame: both channels, one batched FFT.
+    if (!h.matches(QStringLiteral("xspec"))) return;
+    for (int fftSize : {256, 1024, 4096}) {
+        CrossSpectrum::Options o;
+        o.fftSize = fftSize;
+        o.antennaSpacingM = 0.5;
+        CrossSpectrum xs(o);
+        const int pairs = xs.pairsNeeded();
+        const auto iq = makeIq(pairs + 7, 2e6, 100e3);   // ch1: ch0 seven pairs later
+        h.run(QStringLiteral("xspec"), {{"fftSize", fftSize}, {"segments", o.segments}}, pairs, [&] {
+            const CrossSpectrumFrame f = xs.compute(iq.data(), iq.data() + 14, pairs, 102e6, 2e6);
+            benchKeep(f.coherence.constData());
+        });
+    }
+}
+
+QJsonObject environment(const BenchHarness::Options& opt) {
+    QJsonObject host{
+        {"name",    QSysInfo::machineHostName()},
+        {"os",      QSysInfo::prettyProductName()},
+        {"cpuArch", QSysInfo::currentCpuArchitecture()},
+        {"threads", QThread::idealThreadCount()},
+    };
+    QJsonObject build{
+#if defined(__VERSION__)
+        {"compiler", QStringLiteral(__VERSION__)},
+#endif
+#ifdef NDEBUG
+        {"config", "Release"},
+#else
+        {"config", "Debug"},
+#endif
+#ifdef __AVX2__
+        {"avx2", true},
+#else
+        {"avx2", false},
+#endif
+        {"fir1Taps", kDefaultFir1Taps},
+        {"qt",       QStringLiteral(QT_VERSION_STR)},
+    };
+    return {
+        {"schema",    1},
+        {"generated", QDateTime::currentDateTimeUtc().toString(Qt::ISODate)},
+        {"host",      host},
+        {"build",     build},
+        {"options",   QJsonObject{{"minTimeSec", opt.minSeconds},
+                                  {"repetitions", opt.repetitions},
+                                  {"blockPairs", kBlockPairs}}},
+    };
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("Stand DSP kernel benchmarks (JSON report)"));
+    parser.addHelpOption();
+    QCommandLineOption outputOpt(QStringLiteral("output"),
+                                 QStringLiteral("Write the report to <file> instead of stdout."),
+                                 QStringLiteral("file"));
+    QCommandLineOption filterOpt(QStringLiteral("filter"),
+                                 QStringLiteral("Run only kernels whose name contains <text>."),
+                                 QStringLiteral("text"));
+    QCommandLineOption minTimeOpt(QStringLiteral("min-time"),
+                                  QStringLiteral("Seconds per kernel configuration (default 0.5)."),
+                                  QStringLiteral("seconds"));
+    QCommandLineOption repsOpt(QStringLiteral("repetitions"),
+                               QStringLiteral("Timed repetitions per configuration (default 5)."),
+                               QStringLiteral("n"));
+    parser.addOption(outputOpt);
+    parser.addOption(filterOpt);
+    parser.addOption(minTimeOpt);
+    parser.addOption(repsOpt);
+    parser.process(app);
+
+    BenchHarness::Options opt;
+    opt.filter = parser.value(filterOpt);
+    if (parser.isSet(minTimeOpt)) opt.minSeconds  = parser.value(minTimeOpt).toDouble();
+    if (parser.isSet(repsOpt))    opt.repetitions = parser.value(repsOpt).toInt();
+
+    BenchHarness h(opt);
+    benchInt16ToFloat(h);
+    benchFft(h);
+    benchDemod<FmDemodulator>(h, QStringLiteral("demod.fm"));
+    benchDemod<AmDemodulator>(h, QStringLiteral("demod.am"));
+    benchBandpass(h);
+    benchCombiner(h);
+    benchDelay(h);
+    benchResampler(h);
+    benchFirDesign(h);
+    benchSpectralCorrelation(h);
+    benchCrossSpectrum(h);
+
+    QJsonObject report = environment(opt);
+    report["results"] = h.results();
+    const QByteArray json = QJsonDocument(report).toJson(QJsonDocument::Indented);
+
+    if (!parser.isSet(outputOpt)) {
+        std::fwrite(json.constData(), 1, static_cast<std::size_t>(json.size()), stdout);
+        return 0;
+    }
+    QSaveFile f(parser.value(outputOpt));
+    if (!f.open(QIODevice::WriteOnly) || f.write(json) != json.size() || !f.commit()) {
+        std::fprintf(stderr, "StandBench: cannot write %s\n",
+                     parser.value(outputOpt).toUtf8().constData());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,522 @@
+#include "AsyncFileWriter.h"
+#include "Logger.h"
+#include "Trace.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#  ifndef NOMINMAX
+#    define NOMINMAX
+#  endif
+#  ifndef WIN32_LEAN_AND_MEAN
+#    define WIN32_LEAN_AND_MEAN
+#  endif
+#  include <windows.h>
+#else
+#  include <cerrno>
+#  include <fcntl.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+namespace {
+
+// ---------------------------------------------------------------------------
+// Native file handle — positional writes, no stdio buffering.
+// ---------------------------------------------------------------------------
+#ifdef _WIN32
+using Handle = HANDLE;
+const Handle kInvalidHandle = INVALID_HANDLE_VALUE;
+
+Handle openNative(const QString& path, bool& direct) {
+    const std::wstring w = path.toStdWString();
+    auto tryOpen = [&w](DWORD flags) {
+        return CreateFileW(w.c_str(), GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+                           CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL | flags, nullptr);
+    };
+    Handle h = kInvalidHandle;
+    if (direct)
+        h = tryOpen(FILE_FLAG_NO_BUFFERING | FILE_FLAG_WRITE_THROUGH);
+    if (h == kInvalidHandle) {
+        direct = false;
+        h = tryOpen(FILE_FLAG_SEQUENTIAL_SCAN);
+    }
+    return h;
+}
+
+bool writeAt(Handle h, const char* data, std::size_t bytes, uint64_t offset) {
+    while (bytes > 0) {
+        OVERLAPPED ov{};
+        ov.Offset     = static_cast<DWORD>(offset & 0xFFFFFFFFu);
+        ov.OffsetHigh = static_cast<DWORD>(offset >> 32);
+        const DWORD chunk = static_cast<DWORD>(std::min<std::size_t>(bytes, 1u << 30));
+        DWORD done = 0;
+        if (!WriteFile(h, data, chunk, &done, &ov) || done == 0) return false;
+        data   += done;
+        bytes  -= done;
+        offset += done;
+    }
+    return true;
+}
+
+void preallocate(Handle h, uint64_t bytes) {
+    FILE_ALLOCATION_INFO info{};
+    info.AllocationSize.QuadPart = static_cast<LONGLONG>(bytes);
+    SetFileInformationByHandle(h, FileAllocationInfo, &info, sizeof(info));
+}
+
+bool truncateTo(Handle h, uint64_t size) {
+    LARGE_INTEGER li{};
+    li.QuadPart = static_cast<LONGLONG>(size);
+    return SetFilePointerEx(h, li, nullptr, FILE_BEGIN) && SetEndOfFile(h);
+}
+
+void closeNative(Handle h) { CloseHandle(h); }
+
+std::string diskKey(const QString& path) {
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    const fs::path abs = fs::absolute(fs::path(path.toStdWString()), ec);
+    return (ec ? fs::path(path.toStdWString()) : abs).root_name().string();
+}
+#else
+using Handle = int;
+const Handle kInvalidHandle = -1;
+
+Handle openNative(const QString& path, bool& direct) {
+    const std::string p = path.toStdString();
+    Handle fd = kInvalidHandle;
+#ifdef O_DIRECT
+    if (direct)
+        fd = ::open(p.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_DIRECT, 0644);
+#endif
+    if (fd == kInvalidHandle) {
+        direct = false;   // not supported here (tmpfs, some FUSE) or not compiled in
+        fd = ::open(p.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    }
+    return fd;
+}
+
+bool writeAt(Handle fd, const char* data, std::size_t bytes, uint64_t offset) {
+    while (bytes > 0) {
+        const ssize_t n = ::pwrite(fd, data, bytes, static_cast<off_t>(offset));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        data   += n;
+        bytes  -= static_cast<std::size_t>(n);
+        offset += static_cast<uint64_t>(n);
+    }
+    return true;
+}
+
+void preallocate(Handle fd, uint64_t bytes) {
+#ifdef __linux__
+    // KEEP_SIZE: reserve extents without moving EOF — no truncate needed.
+    ::fallocate(fd, FALLOC_FL_KEEP_SIZE, 0, static_cast<off_t>(bytes));
+#else
+    (void)fd; (void)bytes;
+#endif
+}
+
+bool truncateTo(Handle fd, uint64_t size) {
+    return ::ftruncate(fd, static_cast<off_t>(size)) == 0;
+}
+
+void closeNative(Handle fd) { ::close(fd); }
+
+std::string diskKey(const QString& path) {
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    fs::path dir = fs::absolute(fs::path(path.toStdString()), ec).parent_path();
+    struct stat st{};
+    if (::stat(dir.c_str(), &st) == 0)
+        return std::to_string(static_cast<unsigned long long>(st.st_dev));
+    return dir.string();
+}
+#endif
+
+std::size_t roundUp(std::size_t n, std::size_t a) { return (n + a - 1) / a * a; }
+
+class IoThread;
+
+}  // namespace
+
+// ---------------------------------------------------------------------------
+// File — state shared between the producer and the disk's I/O thread
+// ---------------------------------------------------------------------------
+struct AsyncFileWriter::File {
+    struct Buffer {
+        char*       data{nullptr};
+        std::size_t used{0};
+        uint64_t    offset{0};
+    };
+
+    QString             path;
+    Options             opt;
+    std::size_t         bufBytes{0};
+    Handle              handle{kInvalidHandle};
+    bool                direct{false};
+    std::vector<Buffer> buffers;
+    IoThread*           io{nullptr};   // owned by IoService
+
+    std::mutex              mutex;
+    std::condition_variable cv;
+    std::vector<int>        freeList;   // guarded by mutex
+    int                     inFlight{0};
+
+    std::atomic<uint64_t> accepted{0};
+    std::atomic<uint64_t> written{0};
+    std::atomic<uint64_t> dropped{0};
+    std::atomic<uint64_t> dropEvents{0};
+    std::atomic<uint64_t> stalls{0};
+    std::atomic<bool>     ioError{false};
+
+    std::vector<std::pair<uint64_t, std::vector<char>>> patches;
+
+    ~File() {
+        for (Buffer& b : buffers)
+            ::operator delete(b.data, std::align_val_t{kAlignment});
+    }
+};
+
+namespace {
+
+// ---------------------------------------------------------------------------
+// IoThread — one per disk; writes buffers for every file on that disk
+// ---------------------------------------------------------------------------
+class IoThread {
+public:
+    IoThread() : thread_([this] { run(); }) {}
+
+    ~IoThread() {
+        {
+            std::lock_guard lock(mutex_);
+            stop_ = true;
+        }
+        cv_.notify_one();
+        thread_.join();
+    }
+
+    void submit(std::shared_ptr<AsyncFileWriter::File> file, int index) {
+        {
+            std::lock_guard lock(mutex_);
+            queue_.push_back({std::move(file), index, {}});
+        }
+        cv_.notify_one();
+    }
+
+    void post(std::function<void()> task) {
+        {
+            std::lock_guard lock(mutex_);
+            queue_.push_back({nullptr, -1, std::move(task)});
+        }
+        cv_.notify_one();
+    }
+
+private:
+    struct Job {
+        std::shared_ptr<AsyncFileWriter::File> file;
+        int                                    index;
+        std::function<void()>                  task;   // instead of a buffer
+    };
+
+    void run() {
+        Trace::setThreadName("AsyncFileWriter I/O");
+        while (true) {
+            Job job;
+            {
+                std::unique_lock lock(mutex_);
+                cv_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+                if (queue_.empty()) return;   // stop_ and drained
+                job = std::move(queue_.front());
+                queue_.pop_front();
+            }
+            if (job.task) job.task();
+            else          process(*job.file, job.index);
+        }
+    }
+
+    static void process(AsyncFileWriter::File& f, int index) {
+        TRACE_SCOPE("recorder", "disk write");
+        auto& b = f.buffers[index];
+
+        std::size_t len = b.used;
+        if (f.direct && len % AsyncFileWriter::kAlignment != 0) {
+            // Tail buffer: O_DIRECT needs whole sectors; close() truncates.
+            const std::size_t padded = roundUp(len, AsyncFileWriter::kAlignment);
+            std::memset(b.data + len, 0, padded - len);
+            len = padded;
+        }
+
+        const bool ok = !f.ioError.load() && writeAt(f.handle, b.data, len, b.offset);
+        if (ok) {
+            f.written.fetch_add(b.used);
+        } else {
+            f.dropped.fetch_add(b.used);
+            f.dropEvents.fetch_add(1);
+            if (!f.ioError.exchange(true))
+                LOG_ERROR("AsyncFileWriter: write failed: " + f.path.toStdString());
+        }
+
+        {
+            std::lock_guard lock(f.mutex);
+            f.freeList.push_back(index);
+            --f.inFlight;
+        }
+        f.cv.notify_all();
+    }
+
+    std::mutex              mutex_;
+    std::condition_variable cv_;
+    std::deque<Job>         queue_;
+    bool                    stop_{false};
+    std::thread             thread_;   // last: started after the members above
+};
+
+// Per-disk I/O threads, created on first use and joined at exit.
+class IoService {
+public:
+    static IoService& instance() {
+        static IoService s;
+        return s;
+    }
+
+    IoThread& forPath(const QString& path) {
+        const std::string key = diskKey(path);
+        std::lock_guard lock(mutex_);
+        auto& t = threads_[key];
+        if (!t) {
+            t = std::make_unique<IoThread>();
+            LOG_INFO("AsyncFileWriter: I/O thread for disk " + key);
+        }
+        return *t;
+    }
+
+private:
+    std::mutex                                       mutex_;
+    std::map<std::string, std::unique_ptr<IoThread>> threads_;
+};
+
+}  // namespace
+
+// ---------------------------------------------------------------------------
+// AsyncFileWriter
+// ---------------------------------------------------------------------------
+AsyncFileWriter::AsyncFileWriter() = default;
+
+AsyncFileWriter::~AsyncFileWriter() {
+    close();
+}
+
+bool AsyncFileWriter::open(const QString& path, const Options& options) {
+    close();
+
+    auto f = std::make_shared<File>();
+    f->path     = path;
+    f->opt      = options;
+    f->direct   = options.direct;
+    f->bufBytes = roundUp(std::max<std::size_t>(options.bufferBytes, kAlignment), kAlignment);
+    f->handle   = openNative(path, f->direct);
+    if (f->handle == kInvalidHandle) {
+        LOG_ERROR("AsyncFileWriter: cannot open " + path.toStdString());
+        return false;
+    }
+    if (options.direct && !f->direct)
+        LOG_WARN("AsyncFileWriter: direct I/O unavailable, using buffered I/O for "
+                 + path.toStdString());
+    if (options.preallocateBytes > 0)
+        preallocate(f->handle, options.preallocateBytes);
+
+    const int count = std::max(2, options.bufferCount);
+    f->buffers.resize(count);
+    for (int i = 0; i < count; ++i) {
+        f->buffers[i].data = static_cast<char*>(
+            ::operator new(f->bufBytes, std::align_val_t{kAlignment}));
+        f->freeList.push_back(count - 1 - i);
+    }
+
+    // Resolve (and possibly start) the disk's thread now, not on the hot path.
+    f->io = &IoService::instance().forPath(path);
+
+    file_        = std::move(f);
+    path_        = path;
+    position_    = 0;
+    current_     = -1;
+    closedStats_ = {};
+    return true;
+}
+
+// Only after write() has checked the free list: the I/O thread adds to it,
+// never takes, so the buffer write() saw is still there.
+void AsyncFileWriter::acquireBuffer() {
+    File& f = *file_;
+    std::lock_guard lock(f.mutex);
+    current_ = f.freeList.back();
+    f.freeList.pop_back();
+    f.buffers[current_].used   = 0;
+    f.buffers[current_].offset = position_;
+}
+
+void AsyncFileWriter::submitCurrent() {
+    File& f = *file_;
+    {
+        std::lock_guard lock(f.mutex);
+        ++f.inFlight;
+    }
+    f.io->submit(file_, current_);
+    current_ = -1;
+}
+
+bool AsyncFileWriter::write(const void* data, std::size_t bytes) {
+    if (!file_) return false;
+    if (bytes == 0) return true;
+    File& f = *file_;
+    const char* src = static_cast<const char*>(data);
+
+    // A full buffer is submitted at once; the next one is taken here, lazily,
+    // so a write that finds no free buffer goes through the overflow policy.
+    const std::size_t curRoom = current_ >= 0 ? f.bufBytes - f.buffers[current_].used : 0;
+    if (curRoom < bytes) {
+        // Slow path: the write needs further buffers — check there is room
+        // for all of it first so that frames are never split by a drop.
+        const std::size_t others  = f.buffers.size() - (current_ >= 0 ? 1 : 0);
+        const std::size_t maxRoom = curRoom + others * f.bufBytes;
+        auto fits = [&] { return curRoom + f.freeList.size() * f.bufBytes >= bytes; };
+
+        std::unique_lock lock(f.mutex);
+        if (!fits()) {
+            if (f.opt.overflow == Overflow::Drop || bytes > maxRoom) {
+                lock.unlock();
+                f.dropped.fetch_add(bytes);
+                f.dropEvents.fetch_add(1);
+                return false;
+            }
+            f.stalls.fetch_add(1);
+            TRACE_SCOPE("recorder", "writer stall");
+            f.cv.wait(lock, fits);
+        }
+    }
+
+    std::size_t left = bytes;
+    while (left > 0) {
+        if (current_ < 0) acquireBuffer();
+        File::Buffer* cur = &f.buffers[current_];
+        const std::size_t n = std::min(left, f.bufBytes - cur->used);
+        std::memcpy(cur->data + cur->used, src, n);
+        cur->used += n;
+        position_ += n;
+        src       += n;
+        left      -= n;
+        if (cur->used == f.bufBytes) submitCurrent();
+    }
+    f.accepted.fetch_add(bytes);
+    return true;
+}
+
+void AsyncFileWriter::patchOnClose(uint64_t offset, const void* data, std::size_t bytes) {
+    if (!file_) return;
+    const char* p = static_cast<const char*>(data);
+    file_->patches.emplace_back(offset, std::vector<char>(p, p + bytes));
+}
+
+AsyncFileWriter::Stats AsyncFileWriter::stats() const {
+    return file_ ? snapshot(*file_) : closedStats_;
+}
+
+AsyncFileWriter::Stats AsyncFileWriter::snapshot(const File& f) {
+    Stats s;
+    s.bytesAccepted = f.accepted.load();
+    s.bytesWritten  = f.written.load();
+    s.bytesDropped  = f.dropped.load();
+    s.dropEvents    = f.dropEvents.load();
+    s.stalls        = f.stalls.load();
+    return s;
+}
+
+void AsyncFileWriter::close() {
+    if (!file_) return;
+    submitTail();
+    {
+        File& f = *file_;
+        std::unique_lock lock(f.mutex);
+        f.cv.wait(lock, [&f] { return f.inFlight == 0; });
+    }
+    closedStats_ = finish(*file_, position_);
+    file_.reset();
+}
+
+void AsyncFileWriter::closeAsync(std::function<void(const Stats&)> done) {
+    if (!file_) return;
+    submitTail();
+    closedStats_ = stats();   // bytesWritten lags until the I/O thread is done
+    // Queued behind this file's last buffer on the same thread, so every
+    // write has completed when the task runs.
+    auto     f    = std::move(file_);
+    IoThread* io  = f->io;
+    const uint64_t size = position_;
+    io->post([f = std::move(f), size, done = std::move(done)] {
+        const Stats st = finish(*f, size);
+        if (done) done(st);
+    });
+}
+
+void AsyncFileWriter::post(const QString& pathOnDisk, std::function<void()> task) {
+    IoService::instance().forPath(pathOnDisk).post(std::move(task));
+}
+
+void AsyncFileWriter::submitTail() {
+    File& f = *file_;
+    if (current_ >= 0 && f.buffers[current_].used > 0) {
+        submitCurrent();
+    } else if (current_ >= 0) {
+        std::lock_guard lock(f.mutex);
+        f.freeList.push_back(current_);
+        current_ = -1;
+    }
+}
+
+// Runs once all buffers are on disk: trims direct-I/O padding and unused
+// preallocation, closes the handle and applies header patches. Owner thread (close) or I/O thread
+// (closeAsync).
+AsyncFileWriter::Stats AsyncFileWriter::finish(File& f, uint64_t size) {
+    // Direct I/O padded the tail to a whole sector; a reservation past EOF
+    // (KEEP_SIZE) stays allocated until the file is truncated, even at the
+    // same size.
+    if (f.direct || f.opt.preallocateBytes > 0) truncateTo(f.handle, size);
+    closeNative(f.handle);
+    f.handle = kInvalidHandle;
+
+    if (!f.patches.empty()) {
+        FILE* fp = std::fopen(f.path.toStdString().c_str(), "r+b");
+        if (fp) {
+            for (const auto& [offset, bytes] : f.patches) {
+                if (offset + bytes.size() > size) continue;
+                std::fseek(fp, static_cast<long>(offset), SEEK_SET);
+                std::fwrite(bytes.data(), 1, bytes.size(), fp);
+            }
+            std::fclose(fp);
+        } else {
+            LOG_ERROR("AsyncFileWriter: cannot reopen for header patch: "
+                      + f.path.toStdString());
+        }
+    }
+
+    const Stats st = snapshot(f);
+    if (st.bytesDropped > 0)
+        LOG_WARN("AsyncFileWriter: " + f.path.toStdString() + " dropped "
+                 + std::to_string(st.bytesDropped) + " bytes in "
+                 + std::to_string(st.dropEvents) + " writes");
+    return st;
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <QString>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+// ---------------------------------------------------------------------------
+// AsyncFileWriter — buffered file output that keeps disk I/O off hot threads.
+//
+// write() copies into the current buffer and returns; full buffers are handed
+// to a dedicated I/O thread shared by all files on the same disk (volume).
+// Buffers are page-aligned and allocated in open(), so write() never
+// allocates and never makes a syscall.
+//
+// Backpressure: when every buffer is in flight, Overflow::Drop discards the
+// whole write() (callers pass whole frames, so the file stays aligned) and
+// counts it in stats(); Overflow::Block waits for the I/O thread and counts a
+// stall. RX-path writers use Drop, so a disk hiccup costs data, never samples
+// of DSP time.
+//
+// Options:
+//   direct           — O_DIRECT / FILE_FLAG_NO_BUFFERING: bypasses the page
+//                      cache for long captures; falls back to buffered I/O if
+//                      the filesystem refuses it
+//   preallocateBytes — reserve disk space up front (fallocate KEEP_SIZE /
+//                      FileAllocationInfo) to avoid fragmentation and
+//                      metadata updates during the capture; whatever the
+//                      file did not use is released at close
+//
+// Header patching (WAV sizes): patchOnClose() records bytes to overwrite at an
+// offset; they are applied after the last buffer has been written.
+//
+// Threading: write()/patchOnClose() from one producer thread at a time;
+// open()/close() from the owner. close() blocks until the data is on disk;
+// closeAsync() hands the tail, truncate, header patches and the close itself
+// to the disk's I/O thread and returns at once (segment rotation).
+// post() runs any task on that thread, after everything already queued for
+// the disk — used to pre-open the next segment and write sidecars off the
+// hot path.
+// ---------------------------------------------------------------------------
+class AsyncFileWriter {
+public:
+    enum class Overflow { Drop, Block };
+
+    struct Options {
+        std::size_t bufferBytes      = 1u << 20;   // per buffer, rounded up to kAlignment
+        int         bufferCount      = 3;          // ≥ 2; 3 = triple buffering
+        bool        direct           = false;
+        uint64_t    preallocateBytes = 0;
+        Overflow    overflow         = Overflow::Drop;
+    };
+
+    struct Stats {
+        uint64_t bytesAccepted{0};   // taken by write()
+        uint64_t bytesWritten{0};    // on disk
+        uint64_t bytesDropped{0};    // overflow or I/O error
+        uint64_t dropEvents{0};
+        uint64_t stalls{0};          // Overflow::Block waits
+    };
+
+    static constexpr std::size_t kAlignment = 4096;
+
+    AsyncFileWriter();
+    ~AsyncFileWriter();
+
+    AsyncFileWriter(const AsyncFileWriter&) = delete;
+    AsyncFileWriter& operator=(const AsyncFileWriter&) = delete;
+
+    bool open(const QString& path) { return open(path, Options{}); }
+    bool open(const QString& path, const Options& options);
+    void close();
+    // done (optional) runs on the I/O thread with the file's final stats.
+    void closeAsync(std::function<void(const Stats&)> done = {});
+    [[nodiscard]] bool isOpen() const { return file_ != nullptr; }
+
+    static void post(const QString& pathOnDisk, std::function<void()> task);
+
+    // Returns false if the data was dropped (overflow, I/O error or not open).
+    bool write(const void* data, std::size_t bytes);
+    void patchOnClose(uint64_t offset, const void* data, std::size_t bytes);
+
+    // Bytes accepted so far = file offset of the next write().
+    [[nodiscard]] uint64_t position() const { return position_; }
+    [[nodiscard]] Stats    stats()    const;
+    [[nodiscard]] QString  path()     const { return path_; }
+
+    struct File;   // shared with the I/O thread
+
+private:
+    void submitCurrent();
+    void submitTail();
+    void acquireBuffer();
+    static Stats snapshot(const File& f);
+    static Stats finish(File& f, uint64_t size);
+
+    std::shared_ptr<File> file_;
+    QString               path_;
+    uint64_t              position_{0};
+    int                   current_{-1};   // buffer being filled, -1 = none
+    Stats                 closedStats_;   // snapshot of the last closed file
+};
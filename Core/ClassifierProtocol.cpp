@@ -0,0 +1,178 @@
+#include "ClassifierProtocol.h"
+
+#include <array>
+#include <cstring>
+
+namespace ClassifierProtocol {
+
+namespace {
+
+// x86 and ARM hosts are little-endian, like the protocol.
+template <typename T>
+void put(unsigned char* at, T v) { std::memcpy(at, &v, sizeof v); }
+
+template <typename T>
+T get(const unsigned char* at) { T v; std::memcpy(&v, at, sizeof v); return v; }
+
+void putInfo(unsigned char* s, const SnippetInfo& info, int count) {
+    put(s + 0,  info.channelId);
+    put(s + 4,  static_cast<int32_t>(count));
+    put(s + 8,  info.centreHz);
+    put(s + 16, info.sampleRateHz);
+    put(s + 24, info.bandwidthHz);
+    put(s + 32, info.timestamp);
+}
+
+constexpr std::array<const char*, 7> kTypeNames{"Unknown", "FM", "AM", "CW", "USB", "LSB", "NFM"};
+
+}  // namespace
+
+QString typeName(Type t) {
+    const auto i = static_cast<std::size_t>(t);
+    return QString::fromLatin1(i < kTypeNames.size() ? kTypeNames[i] : kTypeNames[0]);
+}
+
+Type typeFromName(const QString& name) {
+    for (std::size_t i = 1; i < kTypeNames.size(); ++i)
+        if (name.compare(QLatin1String(kTypeNames[i]), Qt::CaseInsensitive) == 0)
+            return static_cast<Type>(i);
+    return Type::Unknown;
+}
+
+// ---------------------------------------------------------------------------
+// FrameWriter
+// ---------------------------------------------------------------------------
+FrameWriter::FrameWriter(unsigned char* buf, std::size_t capacity,
+                         uint32_t frameId, uint64_t timestamp, Kind kind)
+    : buf_(buf), capacity_(capacity), kind_(kind)
+{
+    if (capacity_ < kFrameHeader) { capacity_ = 0; used_ = 0; return; }
+    std::memset(buf_, 0, kFrameHeader);
+    put(buf_ + 0,  kFrameMagic);
+    put(buf_ + 4,  kVersion);
+    put(buf_ + 8,  frameId);
+    put(buf_ + 16, timestamp);
+    put(buf_ + 28, static_cast<uint32_t>(kind));
+}
+
+float* FrameWriter::addSnippet(const SnippetInfo& info, int count) {
+    if (kind_ != Kind::Iq || count < 0 || capacity_ == 0 || snippetBytes(count) > capacity_ - used_)
+        return nullptr;
+
+    unsigned char* s = buf_ + used_;
+    putInfo(s, info, count);
+    used_ += snippetBytes(count);
+    ++snippets_;
+    return reinterpret_cast<float*>(s + kSnippetHeader);
+}
+
+bool FrameWriter::addFeatures(const SnippetInfo& info, const float* features, int count) {
+    if (kind_ != Kind::Features || count < 0 || capacity_ == 0
+        || featureSnippetBytes(count) > capacity_ - used_)
+        return false;
+
+    unsigned char* s = buf_ + used_;
+    putInfo(s, info, count);
+    std::memcpy(s + kSnippetHeader, features, static_cast<std::size_t>(count) * sizeof(float));
+    used_ += featureSnippetBytes(count);
+    ++snippets_;
+    return true;
+}
+
+std::size_t FrameWriter::finish() {
+    if (capacity_ == 0) return 0;
+    put(buf_ + 12, static_cast<uint32_t>(snippets_));
+    put(buf_ + 24, static_cast<uint32_t>(used_));
+    return used_;
+}
+
+// ---------------------------------------------------------------------------
+// FrameReader
+// ---------------------------------------------------------------------------
+FrameReader::FrameReader(const unsigned char* buf, std::size_t bytes)
+    : buf_(buf), bytes_(bytes)
+{
+    if (bytes_ < kFrameHeader) return;
+    if (get<uint32_t>(buf_) != kFrameMagic || get<uint32_t>(buf_ + 4) != kVersion) return;
+    const auto frameBytes = get<uint32_t>(buf_ + 24);
+    if (frameBytes < kFrameHeader || frameBytes > bytes_) return;
+
+    bytes_        = frameBytes;
+    frameId_      = get<uint32_t>(buf_ + 8);
+    snippetCount_ = static_cast<int>(get<uint32_t>(buf_ + 12));
+    timestamp_    = get<uint64_t>(buf_ + 16);
+    kind_         = static_cast<Kind>(get<uint32_t>(buf_ + 28));
+    valid_        = kind_ == Kind::Iq || kind_ == Kind::Features;
+}
+
+bool FrameReader::next(Snippet& out) {
+    if (!valid_ || read_ >= snippetCount_ || bytes_ - pos_ < kSnippetHeader) return false;
+
+    const unsigned char* s = buf_ + pos_;
+    const auto count = get<int32_t>(s + 4);
+    const std::size_t size = kind_ == Kind::Features ? featureSnippetBytes(count) : snippetBytes(count);
+    if (count < 0 || size > bytes_ - pos_) { valid_ = false; return false; }
+
+    out.info.channelId    = get<uint32_t>(s + 0);
+    out.info.centreHz     = get<double>(s + 8);
+    out.info.sampleRateHz = get<double>(s + 16);
+    out.info.bandwidthHz  = get<double>(s + 24);
+    out.info.timestamp    = get<uint64_t>(s + 32);
+    out.count             = count;
+    const auto* payload   = reinterpret_cast<const float*>(s + kSnippetHeader);
+    out.iq                = kind_ == Kind::Iq ? payload : nullptr;
+    out.features          = kind_ == Kind::Features ? payload : nullptr;
+    pos_ += size;
+    ++read_;
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Results
+// ---------------------------------------------------------------------------
+bool parseHello(const char* p, QString* error) {
+    const auto* u = reinterpret_cast<const unsigned char*>(p);
+    const auto magic   = get<uint32_t>(u);
+    const auto version = get<uint32_t>(u + 4);
+    if (magic != kResultMagic) {
+        if (error) *error = QStringLiteral("not a Stand classifier service (no protocol hello)");
+        return false;
+    }
+    if (version != kVersion) {
+        if (error) *error = QStringLiteral("classifier speaks protocol %1, Stand needs %2")
+                                .arg(version).arg(kVersion);
+        return false;
+    }
+    return true;
+}
+
+Result parseResult(const char* p) {
+    const auto* u = reinterpret_cast<const unsigned char*>(p);
+    Result r;
+    r.frameId    = get<uint32_t>(u + 0);
+    r.channelId  = get<uint32_t>(u + 4);
+    r.timestamp  = get<uint64_t>(u + 8);
+    r.type       = static_cast<Type>(get<uint16_t>(u + 16));
+    r.flags      = get<uint16_t>(u + 18);
+    r.confidence = get<float>(u + 20);
+    if (static_cast<std::size_t>(r.type) >= kTypeNames.size()) r.type = Type::Unknown;
+    return r;
+}
+
+void writeHello(char* p) {
+    auto* u = reinterpret_cast<unsigned char*>(p);
+    put(u + 0, kResultMagic);
+    put(u + 4, kVersion);
+}
+
+void writeResult(char* p, const Result& r) {
+    auto* u = reinterpret_cast<unsigned char*>(p);
+    put(u + 0,  r.frameId);
+    put(u + 4,  r.channelId);
+    put(u + 8,  r.timestamp);
+    put(u + 16, static_cast<uint16_t>(r.type));
+    put(u + 18, r.flags);
+    put(u + 20, r.confidence);
+}
+
+} // namespace ClassifierProtocol
@@ -0,0 +1,157 @@
+#pragma once
+
+#include <QMetaType>
+#include <QString>
+#include <cstddef>
+#include <cstdint>
+
+// ---------------------------------------------------------------------------
+// ClassifierProtocol — version 2 of the Stand ↔ classifier wire format.
+//
+// Stand sends frames; each frame carries any number of narrowband snippets
+// (one per watched channel) so the service classifies them as one model
+// batch. The service answers every snippet with a fixed-size result record,
+// correlated by frame id and channel id. The same frame bytes travel in a
+// ShmIqRing slot or, as the TCP fallback, after a u32 length prefix.
+//
+// Frame (little-endian, offsets in bytes):
+//   header (32):   0 u32 magic "STC2"    4 u32 version (2)
+//                  8 u32 frameId        12 u32 snippetCount
+//                 16 u64 timestamp (first sample of the source block)
+//                 24 u32 frameBytes (header + all snippets)   28 u32 kind (Kind)
+//   snippet (40 + payload), back to back:
+//                  0 u32 channelId       4 i32 count (complex samples)
+//                  8 f64 centreHz       16 f64 sampleRateHz
+//                 24 f64 bandwidthHz    32 u64 timestamp (first input sample)
+//                 40 payload — Kind::Iq: f32 I/Q interleaved, count pairs
+//                              Kind::Features: count f32 features
+//                              (ModulationFeatures order)
+//
+// Results (service → Stand, on the TCP socket):
+//   hello  (8):    0 u32 magic "STR2"    4 u32 version — once, on connect
+//   result (24):   0 u32 frameId         4 u32 channelId
+//                  8 u64 timestamp (the snippet's)
+//                 16 u16 type (Type)    18 u16 flags (kLastInFrame)
+//                 20 f32 confidence
+// The last record of every frame carries kLastInFrame; that closes the frame
+// for Stand's in-flight window (ClassifierHandler::frameDone()).
+// ---------------------------------------------------------------------------
+namespace ClassifierProtocol {
+
+constexpr uint32_t kVersion       = 2;
+constexpr uint32_t kFrameMagic    = 0x32435453;   // "STC2"
+constexpr uint32_t kResultMagic   = 0x32525453;   // "STR2"
+constexpr int      kFrameHeader   = 32;
+constexpr int      kSnippetHeader = 40;
+constexpr int      kHelloBytes    = 8;
+constexpr int      kResultBytes   = 24;
+constexpr uint16_t kLastInFrame   = 0x0001;
+
+enum class Type : uint16_t { Unknown = 0, FM, AM, CW, USB, LSB, NFM };
+
+// What the snippets of a frame carry. Feature frames are a few hundred bytes
+// instead of the decimated I/Q.
+enum class Kind : uint32_t { Iq = 0, Features = 1 };
+
+[[nodiscard]] QString typeName(Type t);
+[[nodiscard]] Type    typeFromName(const QString& name);   // Unknown if not listed
+
+[[nodiscard]] constexpr std::size_t snippetBytes(int count) {
+    return kSnippetHeader + static_cast<std::size_t>(count) * 2 * sizeof(float);
+}
+
+[[nodiscard]] constexpr std::size_t featureSnippetBytes(int count) {
+    return kSnippetHeader + static_cast<std::size_t>(count) * sizeof(float);
+}
+
+struct SnippetInfo {
+    uint32_t channelId{0};
+    double   centreHz{0.0};
+    double   sampleRateHz{0.0};
+    double   bandwidthHz{0.0};
+    uint64_t timestamp{0};
+};
+
+// Builds one frame in caller-owned memory (a ring slot or a socket buffer).
+class FrameWriter {
+public:
+    FrameWriter(unsigned char* buf, std::size_t capacity, uint32_t frameId, uint64_t timestamp,
+                Kind kind = Kind::Iq);
+
+    // Room for `count` pairs, to be filled by the caller; nullptr when the
+    // snippet does not fit (the frame stays valid without it) or this is a
+    // feature frame.
+    float* addSnippet(const SnippetInfo& info, int count);
+
+    // Copies `count` features; false when they do not fit or this is an I/Q
+    // frame.
+    bool addFeatures(const SnippetInfo& info, const float* features, int count);
+
+    // Completes the header; returns the frame length in bytes.
+    std::size_t finish();
+
+    [[nodiscard]] int snippetCount() const { return snippets_; }
+
+private:
+    unsigned char* buf_;
+    std::size_t    capacity_;
+    Kind           kind_;
+    std::size_t    used_{kFrameHeader};
+    int            snippets_{0};
+};
+
+struct Snippet {
+    SnippetInfo  info;
+    int          count{0};            // pairs (Iq) or features (Features)
+    const float* iq{nullptr};         // Kind::Iq, points into the frame
+    const float* features{nullptr};   // Kind::Features, points into the frame
+};
+
+// Walks a received frame (tests, tools). valid() is false for a truncated or
+// foreign buffer.
+class FrameReader {
+public:
+    FrameReader(const unsigned char* buf, std::size_t bytes);
+
+    [[nodiscard]] bool     valid()        const { return valid_; }
+    [[nodiscard]] uint32_t frameId()      const { return frameId_; }
+    [[nodiscard]] uint64_t timestamp()    const { return timestamp_; }
+    [[nodiscard]] int      snippetCount() const { return snippetCount_; }
+    [[nodiscard]] Kind     kind()         const { return kind_; }
+
+    // Next snippet, false after the last one.
+    bool next(Snippet& out);
+
+private:
+    const unsigned char* buf_;
+    std::size_t          bytes_;
+    std::size_t          pos_{kFrameHeader};
+    bool                 valid_{false};
+    uint32_t             frameId_{0};
+    uint64_t             timestamp_{0};
+    Kind                 kind_{Kind::Iq};
+    int                  snippetCount_{0};
+    int                  read_{0};
+};
+
+struct Result {
+    uint32_t frameId{0};
+    uint32_t channelId{0};
+    uint64_t timestamp{0};
+    Type     type{Type::Unknown};
+    uint16_t flags{0};
+    float    confidence{0.0f};
+
+    [[nodiscard]] bool lastInFrame() const { return (flags & kLastInFrame) != 0; }
+};
+
+// p must hold kHelloBytes / kResultBytes.
+[[nodiscard]] bool   parseHello(const char* p, QString* error = nullptr);
+[[nodiscard]] Result parseResult(const char* p);
+void writeHello(char* p);
+void writeResult(char* p, const Result& r);
+
+} // namespace ClassifierProtocol
+
+// ClassifierHandler's local mode hands results to the GUI thread.
+Q_DECLARE_METATYPE(ClassifierProtocol::Result)
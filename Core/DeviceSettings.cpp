@@ -79,6 +79,7 @@ DeviceSettings DeviceSettings::load(const QString& serial) {
         d.fmDeemphSec    = p.value("fmDeemphSec").toDouble(d.fmDeemphSec);
         d.amBwKHz        = p.value("amBwKHz").toDouble(d.amBwKHz);
         d.volumePct      = p.value("volumePct").toInt(d.volumePct);
+        d.squelchDb      = p.value("squelchDb").toDouble(d.squelchDb);
         d.recordFiltered = p.value("recordFiltered").toBool(d.recordFiltered);
         d.recordAudio    = p.value("recordAudio").toBool(d.recordAudio);
         s.demodPanels.append(d);
@@ -111,6 +112,7 @@ bool DeviceSettings::save(const QString& serial) const {
         p["fmDeemphSec"]    = d.fmDeemphSec;
         p["amBwKHz"]        = d.amBwKHz;
         p["volumePct"]      = d.volumePct;
+        p["squelchDb"]      = d.squelchDb;
         p["recordFiltered"] = d.recordFiltered;
         p["recordAudio"]    = d.recordAudio;
         panels.append(p);
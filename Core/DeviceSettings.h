@@ -14,6 +14,7 @@ struct DemodPanelSettings {
     double  fmDeemphSec    = 75e-6;
     double  amBwKHz        = 5.0;
     int     volumePct      = 80;
+    double  squelchDb      = -120.0;                // dBFS; -120 = off
     bool    recordFiltered = false;
     bool    recordAudio    = false;
 };
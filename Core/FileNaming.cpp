@@ -3,6 +3,8 @@
 #include <QDateTime>
 #include <QDir>
 
+#include <algorithm>
+
 namespace FileNaming {
 
 QString perChannelSource(const ChannelDescriptor& ch) {
@@ -70,4 +72,12 @@ QString composeWithSuffix(const QString& dir,
     return joinDir(dir, name);
 }
 
+QString segmentPath(const QString& path, int segment) {
+    const qsizetype slash = std::max(path.lastIndexOf('/'), path.lastIndexOf('\\'));
+    qsizetype dot = path.lastIndexOf('.');
+    if (dot <= slash) dot = path.size();
+    const QString tag = QStringLiteral("_seg%1").arg(segment + 1, 4, 10, QLatin1Char('0'));
+    return path.left(dot) + tag + path.mid(dot);
+}
+
 }  // namespace FileNaming
@@ -19,8 +19,12 @@
 // Examples:
 //   20260412_153045_rx0_102.000MHz_4.000MSps.cf32
 //   20260412_153045_dualrx_bp150kHz_102.000MHz_500.000kSps.cf32
+//   20260412_153045_rx1_102.000MHz_20.000MSps.ci12
 //   20260412_153045_dualrx_fm0_102.000MHz_48.000kSps.wav
 //
+// Segmented recordings (SegmentedFileWriter) append a 1-based part number:
+//   20260412_153045_rx0_102.000MHz_4.000MSps_seg0001.cf32
+//
 // Pure Qt (no widget dependencies) — safe to call from any layer.
 // ---------------------------------------------------------------------------
 namespace FileNaming {
@@ -47,4 +51,7 @@ QString composeWithSuffix(const QString& dir,
                           double         sampleRateHz,
                           const QString& extension);
 
+// path with "_segNNNN" inserted before the extension (segment is 0-based).
+QString segmentPath(const QString& path, int segment);
+
 }  // namespace FileNaming
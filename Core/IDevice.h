@@ -4,10 +4,11 @@
 #include <QList>
 #include <QObject>
 #include <QString>
-#include <QWidget>
 #include <cmath>
 #include <cstdint>
 
+class QWidget;
+
 // ---------------------------------------------------------------------------
 // DeviceState — жизненный цикл любого SDR-устройства.
 // IDevice эмитирует stateChanged() при каждом переходе.
@@ -163,4 +164,8 @@ signals:
     // decimation) must reset on this signal. Connected with DirectConnection
     // from RxController so the slot runs before the worker is unparked.
     void retuned(ChannelDescriptor ch, double hz);
+
+    // Emitted after a channel gain has been applied (UI thread). Recorders
+    // annotate it in their SigMF metadata.
+    void gainChanged(ChannelDescriptor ch, double dB);
 };
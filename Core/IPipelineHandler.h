@@ -8,10 +8,14 @@
 //
 // channel   — which device channel produced this block
 // timestamp — hardware sample counter (from lms_stream_meta_t); 0 if unavailable
+// rawIq     — the device's int16 samples the float block was converted from
+//             (same layout and count); nullptr past the PrePipeline or when
+//             the source was not int16. Valid only during the call.
 // ---------------------------------------------------------------------------
 struct BlockMeta {
     ChannelDescriptor channel{};    // default: {RX, 0}
     uint64_t          timestamp{0};
+    const int16_t*    rawIq{nullptr};
 };
 
 // ---------------------------------------------------------------------------
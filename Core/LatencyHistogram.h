@@ -0,0 +1,95 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+
+// ---------------------------------------------------------------------------
+// LatencyHistogram — lock-free distribution of durations in nanoseconds.
+//
+// Log-linear buckets: 8 per power of two (≤ 12.5 % relative error) from
+// 1 ns to 2^40 ns (~18 min). record() is a few relaxed atomic adds and may be
+// called from any number of threads; snapshot() is consistent per bucket,
+// which is all percentiles need.
+// ---------------------------------------------------------------------------
+class LatencyHistogram {
+public:
+    static constexpr int kSubBits    = 3;
+    static constexpr int kSub        = 1 << kSubBits;
+    static constexpr int kMaxExp     = 40;
+    static constexpr int kBuckets    = kSub + (kMaxExp - kSubBits + 1) * kSub;
+
+    struct Snapshot {
+        uint64_t count{0};
+        uint64_t sumNs{0};
+        uint64_t maxNs{0};
+        std::array<uint64_t, kBuckets> buckets{};
+
+        [[nodiscard]] double meanNs() const {
+            return count ? static_cast<double>(sumNs) / static_cast<double>(count) : 0.0;
+        }
+        // Upper edge of the bucket holding the q-quantile (0 < q ≤ 1), capped at max.
+        [[nodiscard]] uint64_t percentileNs(double q) const {
+            if (count == 0) return 0;
+            const auto rank = static_cast<uint64_t>(
+                std::max(1.0, std::ceil(q * static_cast<double>(count))));
+            uint64_t seen = 0;
+            for (int i = 0; i < kBuckets; ++i) {
+                seen += buckets[static_cast<std::size_t>(i)];
+                if (seen >= rank) return std::min(upperBound(i), maxNs);
+            }
+            return maxNs;
+        }
+    };
+
+    void record(uint64_t ns) noexcept {
+        buckets_[static_cast<std::size_t>(index(ns))].fetch_add(1, std::memory_order_relaxed);
+        count_.fetch_add(1, std::memory_order_relaxed);
+        sum_.fetch_add(ns, std::memory_order_relaxed);
+        uint64_t prev = max_.load(std::memory_order_relaxed);
+        while (ns > prev && !max_.compare_exchange_weak(prev, ns, std::memory_order_relaxed)) {}
+    }
+
+    [[nodiscard]] Snapshot snapshot() const {
+        Snapshot s;
+        for (int i = 0; i < kBuckets; ++i)
+            s.buckets[static_cast<std::size_t>(i)] =
+                buckets_[static_cast<std::size_t>(i)].load(std::memory_order_relaxed);
+        s.count = count_.load(std::memory_order_relaxed);
+        s.sumNs = sum_.load(std::memory_order_relaxed);
+        s.maxNs = max_.load(std::memory_order_relaxed);
+        return s;
+    }
+
+    void reset() noexcept {
+        for (auto& b : buckets_) b.store(0, std::memory_order_relaxed);
+        count_.store(0, std::memory_order_relaxed);
+        sum_.store(0, std::memory_order_relaxed);
+        max_.store(0, std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] static int index(uint64_t ns) noexcept {
+        if (ns < kSub) return static_cast<int>(ns);
+        const int e = std::min(kMaxExp, static_cast<int>(std::bit_width(ns)) - 1);
+        if (e == kMaxExp && (ns >> kMaxExp) > 1) return kBuckets - 1;
+        const auto m = static_cast<int>((ns >> (e - kSubBits)) & (kSub - 1));
+        return kSub + (e - kSubBits) * kSub + m;
+    }
+
+    [[nodiscard]] static uint64_t upperBound(int idx) noexcept {
+        if (idx < kSub) return static_cast<uint64_t>(idx);
+        const int e = (idx - kSub) / kSub + kSubBits;
+        const int m = (idx - kSub) % kSub;
+        const uint64_t lower = static_cast<uint64_t>(kSub + m) << (e - kSubBits);
+        return lower + (uint64_t{1} << (e - kSubBits)) - 1;
+    }
+
+private:
+    std::array<std::atomic<uint64_t>, kBuckets> buckets_{};
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> sum_{0};
+    std::atomic<uint64_t> max_{0};
+};
@@ -1,88 +1,260 @@
 #include "Logger.h"
 #include "LoggerConfig.h"
 
-#include <chrono>
+#include <QCoreApplication>
+#include <QMetaMethod>
+#include <QThread>
+
+#include <cstdint>
+#include <cstdio>
 #include <cstdlib>
-#include <ctime>
 #include <filesystem>
-#include <iomanip>
 #include <iostream>
-#include <sstream>
+
+namespace {
+constexpr std::size_t kQueueMask = Logger::kQueueCapacity - 1;
+static_assert((Logger::kQueueCapacity & kQueueMask) == 0, "kQueueCapacity must be a power of two");
+}
 
 Logger& Logger::instance() {
     static Logger instance;
     return instance;
 }
 
-Logger::Logger() {
+Logger::Logger()
+    : slots_(std::make_unique<Slot[]>(kQueueCapacity))
+{
+    for (std::size_t i = 0; i < kQueueCapacity; ++i)
+        slots_[i].seq.store(i, std::memory_order_relaxed);
+
+    // logEntryAdded is delivered through this object's event loop: keep it on
+    // the main thread even if the first LOG_* call came from a worker.
+    if (auto* app = QCoreApplication::instance(); app && thread() != app->thread())
+        moveToThread(app->thread());
+
     const char* appdata = std::getenv("APPDATA");
     if (appdata) {
         std::filesystem::path dir = std::filesystem::path(appdata) / "Stand";
         std::error_code ec;
         std::filesystem::create_directories(dir, ec);
-        setLogFile((dir / "stand.log").string());
+        openFile((dir / "stand.log").string());
     } else {
-        setLogFile("stand.log");
+        openFile("stand.log");
     }
+
+    writer_ = std::thread([this] { writerLoop(); });
 }
 
 Logger::~Logger() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (logFile_.is_open()) {
-        logFile_.flush();
-        logFile_.close();
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex_);
+        stopping_ = true;
     }
+    wakeCv_.notify_one();
+    if (writer_.joinable()) writer_.join();   // drains and flushes on the way out
+
+    std::lock_guard<std::mutex> lock(fileMutex_);
+    if (logFile_.is_open()) logFile_.close();
 }
 
 void Logger::setLogFile(const std::string& path) {
-    std::lock_guard<std::mutex> lock(mutex_);
+    flush();   // earlier lines stay in the previous file
+    std::lock_guard<std::mutex> lock(fileMutex_);
+    openFile(path);
+}
+
+void Logger::openFile(const std::string& path) {
     if (logFile_.is_open()) logFile_.close();
     logFile_.open(path, std::ios::app);
     if (!logFile_.is_open())
         std::cerr << "[Logger] WARNING: Cannot open log file: " << path << std::endl;
 }
 
+// ═══════════════════════════════════════════════════════════════════════════════
+// Producers — any thread
+// ═══════════════════════════════════════════════════════════════════════════════
 void Logger::log(LogLevel level, const std::string& msg) {
-    log(level, {}, msg);
+    push(level, {}, msg);
+}
+
+void Logger::log(LogLevel level, std::string&& msg) {
+    push(level, {}, std::move(msg));
 }
 
 void Logger::log(LogLevel level, const QString& category, const std::string& msg) {
-    if (!category.isEmpty() && !LoggerConfig::instance().isEnabled(category))
+    if (!category.isEmpty() && !LoggerConfig::instance().isEnabled(category)) return;
+    push(level, category, msg);
+}
+
+void Logger::log(LogLevel level, const QString& category, std::string&& msg) {
+    if (!category.isEmpty() && !LoggerConfig::instance().isEnabled(category)) return;
+    push(level, category, std::move(msg));
+}
+
+void Logger::log(LogLevel level, LogCat::Id cat, std::string msg) {
+    push(level, LogCat::name(cat), std::move(msg));
+}
+
+void Logger::push(LogLevel level, const QString& category, std::string msg) {
+    Record rec;
+    rec.level    = level;
+    rec.category = category;
+    rec.msg      = std::move(msg);
+    rec.time     = Clock::now();
+    if (!enqueue(std::move(rec))) return;
+    // Errors go out at once; everything else waits for the next batch.
+    if (level == LogLevel::Error) wakeCv_.notify_one();
+}
+
+void Logger::logParam(const QString& paramKey, double value) {
+    if (!LoggerConfig::instance().isEnabled(paramKey))
         return;
+    Record rec;
+    rec.category = paramKey;
+    rec.value    = value;
+    rec.isParam  = true;
+    rec.time     = Clock::now();
+    enqueue(std::move(rec));
+}
+
+void Logger::logParam(LogCat::Id cat, double value) {
+    Record rec;
+    rec.category = LogCat::name(cat);
+    rec.value    = value;
+    rec.isParam  = true;
+    rec.time     = Clock::now();
+    enqueue(std::move(rec));
+}
 
-    const std::string ts  = currentTimestamp();
-    const std::string lvl = levelToString(level);
-    const std::string cat = category.isEmpty()
-                            ? ""
-                            : "[" + category.toStdString() + "] ";
-    const std::string line = "[" + ts + "] [" + lvl + "] " + cat + msg;
+bool Logger::enqueue(Record&& rec) {
+    std::size_t pos = head_.load(std::memory_order_relaxed);
+    Slot* slot = nullptr;
+    for (;;) {
+        slot = &slots_[pos & kQueueMask];
+        const std::size_t seq  = slot->seq.load(std::memory_order_acquire);
+        const auto        diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+        if (diff == 0) {
+            if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+        } else if (diff < 0) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);   // writer a full lap behind
+            return false;
+        } else {
+            pos = head_.load(std::memory_order_relaxed);
+        }
+    }
+    slot->rec = std::move(rec);
+    slot->seq.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+void Logger::flush() {
+    std::unique_lock<std::mutex> lock(wakeMutex_);
+    if (!writer_.joinable() || stopping_) return;
+    const uint64_t ticket = ++flushRequests_;
+    wakeCv_.notify_one();
+    flushedCv_.wait(lock, [&] { return flushesDone_ >= ticket; });
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// Writer thread
+// ═══════════════════════════════════════════════════════════════════════════════
+void Logger::writerLoop() {
+    std::unique_lock<std::mutex> lock(wakeMutex_);
+    for (;;) {
+        wakeCv_.wait_for(lock, std::chrono::milliseconds(kFlushIntervalMs),
+                         [this] { return stopping_ || flushRequests_ > flushesDone_; });
+        const uint64_t requested = flushRequests_;
+        const bool     stop      = stopping_;
+        lock.unlock();
+
+        drain();
+
+        lock.lock();
+        if (requested > flushesDone_) {
+            flushesDone_ = requested;
+            flushedCv_.notify_all();
+        }
+        if (stop) return;
+    }
+}
+
+void Logger::drain() {
+    std::string batch;
+    const bool toUi = isSignalConnected(QMetaMethod::fromSignal(&Logger::logEntryAdded));
+    QVector<UiEntry> ui;
+
+    auto emitLine = [&](LogLevel level, const QString& category, const std::string& ts,
+                        const std::string& text) {
+        const std::string cat = category.isEmpty() ? std::string()
+                                                   : "[" + category.toStdString() + "] ";
+        const std::string body = std::string("[") + levelToString(level) + "] " + cat + text;
+        batch += '[';
+        batch += ts;
+        batch += "] ";
+        batch += body;
+        batch += '\n';
+        if (toUi)
+            ui.append({static_cast<int>(level), category, QString::fromStdString(ts),
+                       QString::fromStdString(body)});
+    };
+
+    for (;;) {
+        Slot& slot = slots_[tail_ & kQueueMask];
+        if (slot.seq.load(std::memory_order_acquire) != tail_ + 1) break;
+        Record rec = std::move(slot.rec);
+        slot.rec   = Record{};
+        slot.seq.store(tail_ + kQueueCapacity, std::memory_order_release);
+        ++tail_;
+
+        if (rec.isParam) {
+            char value[64];
+            std::snprintf(value, sizeof value, "%.3f", rec.value);
+            rec.msg = rec.category.toStdString() + " = " + value;
+        }
+        emitLine(rec.level, rec.category, formatTimestamp(rec.time), rec.msg);
+    }
+
+    const uint64_t dropped = dropped_.load(std::memory_order_relaxed);
+    if (dropped != droppedReported_) {
+        emitLine(LogLevel::Warning, {}, formatTimestamp(Clock::now()),
+                 "[Logger] " + std::to_string(dropped - droppedReported_)
+                 + " messages dropped (queue full)");
+        droppedReported_ = dropped;
+    }
+    if (batch.empty()) return;
 
     {
-        std::lock_guard<std::mutex> lock(mutex_);
+        std::lock_guard<std::mutex> lock(fileMutex_);
         if (logFile_.is_open()) {
-            logFile_ << line << "\n";
+            logFile_ << batch;
             logFile_.flush();
         }
+    }
 #ifndef NDEBUG
-        std::cerr << line << std::endl;
+    std::cerr << batch << std::flush;
 #endif
-    }
 
-    emit logEntryAdded(static_cast<int>(level),
-                       category,
-                       QString::fromStdString(ts),
-                       QString::fromStdString("[" + lvl + "] " + cat + msg));
+    if (ui.isEmpty()) return;
+    {
+        std::lock_guard<std::mutex> lock(uiMutex_);
+        uiPending_ += ui;
+    }
+    if (!uiPosted_.exchange(true))
+        QMetaObject::invokeMethod(this, [this] { deliverPending(); }, Qt::QueuedConnection);
 }
 
-void Logger::logParam(const QString& paramKey, double value) {
-    if (!LoggerConfig::instance().isEnabled(paramKey))
-        return;
-    std::ostringstream oss;
-    oss << std::fixed << std::setprecision(3) << value;
-    log(LogLevel::Info, paramKey, paramKey.toStdString() + " = " + oss.str());
+void Logger::deliverPending() {
+    uiPosted_.store(false);
+    QVector<UiEntry> entries;
+    {
+        std::lock_guard<std::mutex> lock(uiMutex_);
+        entries.swap(uiPending_);
+    }
+    for (const UiEntry& e : entries)
+        emit logEntryAdded(e.level, e.category, e.timestamp, e.message);
 }
 
-std::string Logger::levelToString(LogLevel level) const {
+const char* Logger::levelToString(LogLevel level) {
     switch (level) {
         case LogLevel::Debug:   return "DEBUG";
         case LogLevel::Info:    return "INFO ";
@@ -92,21 +264,23 @@ std::string Logger::levelToString(LogLevel level) const {
     return "?????";
 }
 
-std::string Logger::currentTimestamp() const {
+std::string Logger::formatTimestamp(Clock::time_point t) {
     using namespace std::chrono;
-    const auto now      = system_clock::now();
-    const auto ms       = duration_cast<milliseconds>(now.time_since_epoch()) % 1000;
-    const std::time_t t = system_clock::to_time_t(now);
-
-    std::tm tm{};
+    const std::time_t sec = Clock::to_time_t(t);
+    if (sec != stampSecond_) {
+        std::tm tm{};
 #ifdef _WIN32
-    localtime_s(&tm, &t);
+        localtime_s(&tm, &sec);
 #else
-    localtime_r(&t, &tm);
+        localtime_r(&sec, &tm);
 #endif
-
-    std::ostringstream oss;
-    oss << std::put_time(&tm, "%Y-%m-%d %H:%M:%S")
-        << '.' << std::setfill('0') << std::setw(3) << ms.count();
-    return oss.str();
+        char buf[32];
+        std::strftime(buf, sizeof buf, "%Y-%m-%d %H:%M:%S", &tm);
+        stampPrefix_ = buf;
+        stampSecond_ = sec;
+    }
+    const auto ms = duration_cast<milliseconds>(t.time_since_epoch()).count() % 1000;
+    char frac[8];
+    std::snprintf(frac, sizeof frac, ".%03d", static_cast<int>(ms < 0 ? ms + 1000 : ms));
+    return stampPrefix_ + frac;
 }
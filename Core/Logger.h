@@ -4,30 +4,63 @@
 #include "LoggerConfig.h"
 
 #include <QObject>
+#include <QVector>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
 #include <fstream>
+#include <memory>
 #include <mutex>
 #include <string>
+#include <thread>
 
 // Thread-safe logger singleton.  Implements ILogger so alternative backends
 // (e.g. LimeLogger with device-specific context) can replace it later.
 //
 // Param logging:  LOG_PARAM(LogCat::kPipelineTiming, ms) — filtered by
-//                 LoggerConfig; disabled categories are dropped before
-//                 any string work.
+//                 LoggerConfig's category bitmask before the arguments are
+//                 evaluated.
 //
 // General logging:  LOG_INFO / LOG_WARN / LOG_ERROR — always recorded.
+//
+// Asynchronous: log() stamps the record with the raw clock and pushes it into
+// a bounded lock-free MPSC queue (kQueueCapacity records) — no lock, no
+// formatting, no syscall on the calling thread. A writer thread drains the
+// queue every kFlushIntervalMs (at once for errors), formats timestamps and
+// LOG_PARAM values, writes the batch and flushes the file once. When the queue
+// is full the record is dropped and counted; the writer notes the loss in the
+// log. logEntryAdded is emitted on the Logger's (main) thread, once per writer
+// batch rather than one queued event per line.
+//
+// Records still queued when the process crashes are lost; call flush() before
+// an intentional abort or at the end of a run that must keep every line.
 class Logger : public QObject, public ILogger {
     Q_OBJECT
 
 public:
+    static constexpr std::size_t kQueueCapacity   = 8192;   // power of two
+    static constexpr int         kFlushIntervalMs = 50;
+
     static Logger& instance();
 
     // ILogger — primary entry point (category may be empty)
     void log(LogLevel level, const QString& category, const std::string& msg) override;
     void logParam(const QString& paramKey, double value) override;
 
-    // Backward-compatible overload: empty category
+    // Rvalue messages (the usual `"..." + std::to_string(x)`) are moved into
+    // the queue instead of copied.
+    void log(LogLevel level, const QString& category, std::string&& msg);
+
+    // Backward-compatible overloads: empty category
     void log(LogLevel level, const std::string& msg);
+    void log(LogLevel level, std::string&& msg);
+
+    // LOG_CAT / LOG_PARAM targets — the macros have already tested the bit.
+    void log(LogLevel level, LogCat::Id cat, std::string msg);
+    void logParam(LogCat::Id cat, double value);
 
     // Convenience wrappers
     void debug(const std::string& msg)   { log(LogLevel::Debug,   msg); }
@@ -37,6 +70,12 @@ public:
 
     void setLogFile(const std::string& path);
 
+    // Blocks until every record queued before the call is written and flushed.
+    void flush();
+
+    // Records lost to a full queue since start-up.
+    [[nodiscard]] uint64_t droppedCount() const { return dropped_.load(std::memory_order_relaxed); }
+
 signals:
     void logEntryAdded(int level, const QString& category,
                        const QString& timestamp, const QString& message);
@@ -47,19 +86,70 @@ private:
     Logger(const Logger&) = delete;
     Logger& operator=(const Logger&) = delete;
 
-    std::string levelToString(LogLevel level) const;
-    std::string currentTimestamp() const;
+    using Clock = std::chrono::system_clock;
 
+    struct Record {
+        LogLevel          level{LogLevel::Info};
+        QString           category;
+        std::string       msg;
+        double            value{0.0};
+        bool              isParam{false};   // msg empty, "<category> = <value>"
+        Clock::time_point time;
+    };
+    // Bounded MPSC ring (Vyukov): a slot is free for the producer whose ticket
+    // equals seq, and readable by the writer once seq == ticket + 1.
+    struct Slot {
+        std::atomic<std::size_t> seq{0};
+        Record                   rec;
+    };
+    struct UiEntry {
+        int     level;
+        QString category, timestamp, message;
+    };
+
+    void openFile(const std::string& path);   // caller holds fileMutex_
+    void push(LogLevel level, const QString& category, std::string msg);
+    bool enqueue(Record&& rec);
+    void writerLoop();
+    void drain();                  // writer thread only
+    void deliverPending();         // Logger's thread
+
+    static const char* levelToString(LogLevel level);
+    std::string formatTimestamp(Clock::time_point t);   // writer only
+
+    std::unique_ptr<Slot[]>  slots_;
+    std::atomic<std::size_t> head_{0};       // next producer ticket
+    std::size_t              tail_{0};       // writer only
+    std::atomic<uint64_t>    dropped_{0};
+    uint64_t                 droppedReported_{0};   // writer only
+
+    std::mutex              wakeMutex_;
+    std::condition_variable wakeCv_;
+    std::condition_variable flushedCv_;
+    uint64_t                flushRequests_{0};   // under wakeMutex_
+    uint64_t                flushesDone_{0};     // under wakeMutex_
+    bool                    stopping_{false};    // under wakeMutex_
+
+    std::mutex    fileMutex_;               // writer vs setLogFile()
     std::ofstream logFile_;
-    std::mutex    mutex_;
+    std::time_t   stampSecond_{-1};         // writer only: cached "%Y-%m-%d %H:%M:%S"
+    std::string   stampPrefix_;
+
+    std::mutex        uiMutex_;
+    QVector<UiEntry>  uiPending_;
+    std::atomic<bool> uiPosted_{false};
+
+    std::thread writer_;
 };
 
 #define LOG_DEBUG(msg)        Logger::instance().log(LogLevel::Debug,   msg)
 #define LOG_INFO(msg)         Logger::instance().log(LogLevel::Info,    msg)
 #define LOG_WARN(msg)         Logger::instance().log(LogLevel::Warning, msg)
 #define LOG_ERROR(msg)        Logger::instance().log(LogLevel::Error,   msg)
-#define LOG_PARAM(key, value) Logger::instance().logParam((key), (value))
 
-// Category-filtered log. Dropped when LoggerConfig::isEnabled(cat) is false.
+// Category-filtered logs. When LoggerConfig::isEnabled(cat) is false nothing
+// else is evaluated — msg and value may be as expensive as they like.
+#define LOG_PARAM(cat, value) \
+    do { if (LoggerConfig::isEnabled(cat)) Logger::instance().logParam((cat), (value)); } while (0)
 #define LOG_CAT(cat, level, msg) \
-    Logger::instance().log((level), QLatin1String(cat), (msg))
+    do { if (LoggerConfig::isEnabled(cat)) Logger::instance().log((level), (cat), (msg)); } while (0)
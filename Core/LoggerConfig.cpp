@@ -6,6 +6,39 @@
 #include <QJsonObject>
 #include <QStandardPaths>
 
+#include <array>
+
+namespace {
+constexpr std::array<const char*, LogCat::kCount> kKeys = {
+    "gain_rx0",
+    "gain_rx1",
+    "freq_rx0",
+    "freq_rx1",
+    "sample_rate",
+    "calibration",
+    "pipeline_timing",
+    "audio_underrun",
+    "pipeline_drop",
+    "device_lifecycle",
+    "stream_io",
+    "demod_init",
+    "combined_rx",
+};
+}
+
+const char* LogCat::key(Id id) {
+    return id < kCount ? kKeys[id] : "";
+}
+
+const QString& LogCat::name(Id id) {
+    static const std::array<QString, kCount + 1> names = [] {
+        std::array<QString, kCount + 1> n;
+        for (int i = 0; i < kCount; ++i) n[i] = QString::fromLatin1(kKeys[i]);
+        return n;
+    }();
+    return names[id < kCount ? id : kCount];
+}
+
 LoggerConfig& LoggerConfig::instance() {
     static LoggerConfig inst;
     return inst;
@@ -13,31 +46,46 @@ LoggerConfig& LoggerConfig::instance() {
 
 LoggerConfig::LoggerConfig() {
     params_ = {
-        { QLatin1String(LogCat::kGainRx0),        "Gain RX0"                 },
-        { QLatin1String(LogCat::kGainRx1),        "Gain RX1"                 },
-        { QLatin1String(LogCat::kFreqRx0),        "Frequency RX0"            },
-        { QLatin1String(LogCat::kFreqRx1),        "Frequency RX1"            },
-        { QLatin1String(LogCat::kSampleRate),     "Sample rate"              },
-        { QLatin1String(LogCat::kCalibration),    "Calibration events"       },
-        { QLatin1String(LogCat::kPipelineTiming),  "Pipeline handler timings" },
-        { QLatin1String(LogCat::kAudioUnderrun),   "Audio underruns"          },
-        { QLatin1String(LogCat::kPipelineDrop),    "Pipeline drops"           },
-        { QLatin1String(LogCat::kDeviceLifecycle), "Device lifecycle"         },
-        { QLatin1String(LogCat::kStreamIo),        "Stream I/O"               },
-        { QLatin1String(LogCat::kDemodInit),       "Demodulator init"         },
-        { QLatin1String(LogCat::kCombinedRx),      "Combined RX controller"   },
+        { LogCat::kGainRx0,         {}, "Gain RX0"                 },
+        { LogCat::kGainRx1,         {}, "Gain RX1"                 },
+        { LogCat::kFreqRx0,         {}, "Frequency RX0"            },
+        { LogCat::kFreqRx1,         {}, "Frequency RX1"            },
+        { LogCat::kSampleRate,      {}, "Sample rate"              },
+        { LogCat::kCalibration,     {}, "Calibration events"       },
+        { LogCat::kPipelineTiming,  {}, "Pipeline handler timings" },
+        { LogCat::kAudioUnderrun,   {}, "Audio underruns"          },
+        { LogCat::kPipelineDrop,    {}, "Pipeline drops"           },
+        { LogCat::kDeviceLifecycle, {}, "Device lifecycle"         },
+        { LogCat::kStreamIo,        {}, "Stream I/O"               },
+        { LogCat::kDemodInit,       {}, "Demodulator init"         },
+        { LogCat::kCombinedRx,      {}, "Combined RX controller"   },
     };
-    for (const auto& p : params_)
-        enabled_[p.key] = false;
+    for (auto& p : params_)
+        p.key = LogCat::name(p.id);
     load();
 }
 
+bool LoggerConfig::loadAndCheck(LogCat::Id id) {
+    instance();   // first use: load() clears kNotLoaded
+    return (mask_.load(std::memory_order_relaxed) & bit(id)) != 0;
+}
+
+void LoggerConfig::setEnabled(LogCat::Id id, bool on) {
+    if (id >= LogCat::kCount) return;
+    instance();   // a later first-use load() must not overwrite this
+    if (on) mask_.fetch_or(bit(id), std::memory_order_relaxed);
+    else    mask_.fetch_and(~bit(id), std::memory_order_relaxed);
+}
+
 bool LoggerConfig::isEnabled(const QString& key) const {
-    return enabled_.value(key, false);
+    for (const auto& p : params_)
+        if (p.key == key) return isEnabled(p.id);
+    return false;
 }
 
 void LoggerConfig::setEnabled(const QString& key, bool on) {
-    enabled_[key] = on;
+    for (const auto& p : params_)
+        if (p.key == key) setEnabled(p.id, on);
 }
 
 QString LoggerConfig::jsonPath() {
@@ -48,19 +96,21 @@ QString LoggerConfig::jsonPath() {
 
 void LoggerConfig::save() const {
     QJsonObject o;
-    for (auto it = enabled_.constBegin(); it != enabled_.constEnd(); ++it)
-        o[it.key()] = it.value();
+    const uint32_t m = mask_.load(std::memory_order_relaxed);
+    for (const auto& p : params_)
+        o[p.key] = (m & bit(p.id)) != 0;
     QFile f(jsonPath());
     if (f.open(QIODevice::WriteOnly | QIODevice::Truncate))
         f.write(QJsonDocument(o).toJson(QJsonDocument::Indented));
 }
 
 void LoggerConfig::load() {
+    uint32_t m = 0;
     QFile f(jsonPath());
-    if (!f.open(QIODevice::ReadOnly)) return;
-    const QJsonObject o = QJsonDocument::fromJson(f.readAll()).object();
-    for (auto it = o.constBegin(); it != o.constEnd(); ++it) {
-        if (enabled_.contains(it.key()))
-            enabled_[it.key()] = it.value().toBool();
+    if (f.open(QIODevice::ReadOnly)) {
+        const QJsonObject o = QJsonDocument::fromJson(f.readAll()).object();
+        for (const auto& p : params_)
+            if (o.value(p.key).toBool()) m |= bit(p.id);
     }
+    mask_.store(m, std::memory_order_relaxed);
 }
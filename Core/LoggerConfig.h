@@ -1,37 +1,56 @@
 #pragma once
 
 #include <QList>
-#include <QMap>
 #include <QString>
+#include <atomic>
+#include <cstdint>
 
-// Predefined parameter-log category keys — used as filter tokens in LoggerConfig.
+// Parameter-log categories — filter bits in LoggerConfig. key() is the token
+// used in logger_settings.json and in the log line ("[demod_init] ...").
 namespace LogCat {
-    inline constexpr const char* kGainRx0        = "gain_rx0";
-    inline constexpr const char* kGainRx1        = "gain_rx1";
-    inline constexpr const char* kFreqRx0        = "freq_rx0";
-    inline constexpr const char* kFreqRx1        = "freq_rx1";
-    inline constexpr const char* kSampleRate     = "sample_rate";
-    inline constexpr const char* kCalibration    = "calibration";
-    inline constexpr const char* kPipelineTiming  = "pipeline_timing";
-    inline constexpr const char* kAudioUnderrun   = "audio_underrun";
-    inline constexpr const char* kPipelineDrop    = "pipeline_drop";
-    inline constexpr const char* kDeviceLifecycle = "device_lifecycle";
-    inline constexpr const char* kStreamIo        = "stream_io";
-    inline constexpr const char* kDemodInit       = "demod_init";
-    inline constexpr const char* kCombinedRx      = "combined_rx";
+    enum Id : uint8_t {
+        kGainRx0,
+        kGainRx1,
+        kFreqRx0,
+        kFreqRx1,
+        kSampleRate,
+        kCalibration,
+        kPipelineTiming,
+        kAudioUnderrun,
+        kPipelineDrop,
+        kDeviceLifecycle,
+        kStreamIo,
+        kDemodInit,
+        kCombinedRx,
+        kCount
+    };
+    static_assert(kCount <= 31, "one bit per category, bit 31 marks unloaded settings");
+
+    [[nodiscard]] const char*    key(Id id);
+    [[nodiscard]] const QString& name(Id id);   // key() as a shared QString
 }
 
-// Runtime filter for LOG_PARAM calls.  Disabled keys are dropped before
-// any string formatting, so the hot path is a single bool lookup.
-// Persisted to <AppData>/Stand/logger_settings.json.
+// Runtime filter for LOG_CAT / LOG_PARAM.  One bit per category in an atomic
+// mask: the macros test it before evaluating their arguments, so a disabled
+// category costs a relaxed load and a branch.  The first check after start-up
+// takes the slow path once to load the saved settings.
+// Persisted to <AppData>/Stand/logger_settings.json ({"demod_init": true, ...}).
 class LoggerConfig {
 public:
     static LoggerConfig& instance();
 
+    [[nodiscard]] static bool isEnabled(LogCat::Id id) noexcept {
+        const uint32_t m = mask_.load(std::memory_order_relaxed);
+        if (!(m & (bit(id) | kNotLoaded))) return false;
+        return (m & kNotLoaded) ? loadAndCheck(id) : true;
+    }
+    static void setEnabled(LogCat::Id id, bool on);
+
+    // By JSON key; unknown keys are never enabled.
     bool isEnabled(const QString& key) const;
     void setEnabled(const QString& key, bool on);
 
-    struct ParamEntry { QString key; QString label; };
+    struct ParamEntry { LogCat::Id id; QString key; QString label; };
     const QList<ParamEntry>& allParams() const { return params_; }
 
     void save() const;
@@ -40,8 +59,12 @@ public:
 private:
     LoggerConfig();
 
+    static constexpr uint32_t kNotLoaded = 1u << 31;
+    static constexpr uint32_t bit(LogCat::Id id) noexcept { return 1u << id; }
+    static bool loadAndCheck(LogCat::Id id);
+
     static QString jsonPath();
 
-    QMap<QString, bool> enabled_;
-    QList<ParamEntry>   params_;
+    static inline std::atomic<uint32_t> mask_{kNotLoaded};
+    QList<ParamEntry> params_;
 };
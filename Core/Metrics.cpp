@@ -0,0 +1,208 @@
+#include "Metrics.h"
+#include "Logger.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+namespace {
+
+constexpr const char* kTypeNames[] = {"counter", "gauge", "histogram"};
+
+void appendEscaped(std::string& out, const std::string& v, bool quoteToo) {
+    for (char c : v) {
+        if (c == '\\')                  out += "\\\\";
+        else if (c == '\n')             out += "\\n";
+        else if (c == '"' && quoteToo)  out += "\\\"";
+        else                            out += c;
+    }
+}
+
+// {a="1",b="2"} — sorted by key so the same set always renders the same.
+std::string renderLabels(Metrics::Labels labels) {
+    if (labels.empty()) return {};
+    std::sort(labels.begin(), labels.end());
+    std::string out = "{";
+    for (std::size_t i = 0; i < labels.size(); ++i) {
+        if (i) out += ',';
+        out += labels[i].first;
+        out += "=\"";
+        appendEscaped(out, labels[i].second, true);
+        out += '"';
+    }
+    out += '}';
+    return out;
+}
+
+// Extra label inside an already rendered set: {a="1"} + le → {a="1",le="0.5"}.
+std::string withLabel(const std::string& rendered, const char* key, const std::string& value) {
+    const std::string kv = std::string(key) + "=\"" + value + "\"";
+    if (rendered.empty()) return "{" + kv + "}";
+    return rendered.substr(0, rendered.size() - 1) + "," + kv + "}";
+}
+
+std::string formatValue(double v) {
+    if (std::isnan(v)) return "NaN";
+    if (std::isinf(v)) return v > 0 ? "+Inf" : "-Inf";
+    char buf[32];
+    std::snprintf(buf, sizeof buf, "%.10g", v);
+    return buf;
+}
+
+void appendSample(std::string& out, const std::string& name, const std::string& labels,
+                  const std::string& value) {
+    out += name;
+    out += labels;
+    out += ' ';
+    out += value;
+    out += '\n';
+}
+
+}  // namespace
+
+namespace Metrics {
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// Histogram
+// ═══════════════════════════════════════════════════════════════════════════════
+Histogram::Histogram(std::vector<double> upperBounds)
+    : bounds_(std::move(upperBounds))
+{
+    std::sort(bounds_.begin(), bounds_.end());
+    bounds_.erase(std::unique(bounds_.begin(), bounds_.end()), bounds_.end());
+    counts_ = std::make_unique<std::atomic<uint64_t>[]>(bounds_.size() + 1);
+}
+
+void Histogram::observe(double v) noexcept {
+    // Few buckets: a linear scan beats a binary search here.
+    std::size_t i = 0;
+    while (i < bounds_.size() && v > bounds_[i]) ++i;
+    counts_[i].fetch_add(1, std::memory_order_relaxed);
+    double cur = sum_.load(std::memory_order_relaxed);
+    while (!sum_.compare_exchange_weak(cur, cur + v, std::memory_order_relaxed)) {}
+}
+
+Histogram::Snapshot Histogram::snapshot() const {
+    Snapshot s;
+    s.upperBounds = bounds_;
+    s.cumulative.resize(bounds_.size() + 1);
+    uint64_t acc = 0;
+    for (std::size_t i = 0; i <= bounds_.size(); ++i) {
+        acc += counts_[i].load(std::memory_order_relaxed);
+        s.cumulative[i] = acc;
+    }
+    s.sum = sum_.load(std::memory_order_relaxed);
+    return s;
+}
+
+std::vector<double> Histogram::latencyBuckets() {
+    return {50e-6, 100e-6, 250e-6, 500e-6, 1e-3, 2.5e-3, 5e-3, 10e-3, 25e-3, 50e-3,
+            100e-3, 250e-3, 1.0};
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// Registry
+// ═══════════════════════════════════════════════════════════════════════════════
+Registry& Registry::instance() {
+    static Registry r;
+    return r;
+}
+
+bool Registry::addSeries(const std::string& name, const std::string& help,
+                         const Labels& labels, Series series) {
+    std::lock_guard lock(mutex_);
+    auto [it, inserted] = families_.try_emplace(name);
+    Family& f = it->second;
+    if (inserted) {
+        f.help = help;
+        f.type = series.index();
+    } else if (f.type != series.index()) {
+        LOG_WARN("Metrics: " + name + " is already a " + kTypeNames[f.type]);
+        return false;
+    }
+    f.series[renderLabels(labels)] = std::move(series);
+    return true;
+}
+
+bool Registry::add(const std::string& name, const std::string& help, const Labels& labels,
+                   const std::shared_ptr<Counter>& counter) {
+    return addSeries(name, help, labels, std::weak_ptr<Counter>(counter));
+}
+
+bool Registry::add(const std::string& name, const std::string& help, const Labels& labels,
+                   const std::shared_ptr<Gauge>& gauge) {
+    return addSeries(name, help, labels, std::weak_ptr<Gauge>(gauge));
+}
+
+bool Registry::add(const std::string& name, const std::string& help, const Labels& labels,
+                   const std::shared_ptr<Histogram>& histogram) {
+    return addSeries(name, help, labels, std::weak_ptr<Histogram>(histogram));
+}
+
+std::shared_ptr<Counter> Registry::counter(const std::string& name, const std::string& help,
+                                           const Labels& labels) {
+    auto c = std::make_shared<Counter>();
+    add(name, help, labels, c);
+    return c;
+}
+
+std::shared_ptr<Gauge> Registry::gauge(const std::string& name, const std::string& help,
+                                       const Labels& labels) {
+    auto g = std::make_shared<Gauge>();
+    add(name, help, labels, g);
+    return g;
+}
+
+std::shared_ptr<Histogram> Registry::histogram(const std::string& name, const std::string& help,
+                                               std::vector<double> upperBounds,
+                                               const Labels& labels) {
+    auto h = std::make_shared<Histogram>(std::move(upperBounds));
+    add(name, help, labels, h);
+    return h;
+}
+
+std::string Registry::exposition() {
+    std::string out;
+    std::lock_guard lock(mutex_);
+    for (auto fit = families_.begin(); fit != families_.end();) {
+        const std::string& name = fit->first;
+        Family& f = fit->second;
+        std::string body;
+        for (auto sit = f.series.begin(); sit != f.series.end();) {
+            const std::string& labels = sit->first;
+            bool alive = true;
+            if (auto* wc = std::get_if<std::weak_ptr<Counter>>(&sit->second)) {
+                if (auto c = wc->lock()) appendSample(body, name, labels, std::to_string(c->value()));
+                else alive = false;
+            } else if (auto* wg = std::get_if<std::weak_ptr<Gauge>>(&sit->second)) {
+                if (auto g = wg->lock()) appendSample(body, name, labels, formatValue(g->value()));
+                else alive = false;
+            } else if (auto h = std::get<std::weak_ptr<Histogram>>(sit->second).lock()) {
+                const Histogram::Snapshot s = h->snapshot();
+                for (std::size_t i = 0; i < s.upperBounds.size(); ++i)
+                    appendSample(body, name + "_bucket",
+                                 withLabel(labels, "le", formatValue(s.upperBounds[i])),
+                                 std::to_string(s.cumulative[i]));
+                appendSample(body, name + "_bucket", withLabel(labels, "le", "+Inf"),
+                             std::to_string(s.cumulative.back()));
+                appendSample(body, name + "_sum", labels, formatValue(s.sum));
+                appendSample(body, name + "_count", labels, std::to_string(s.cumulative.back()));
+            } else {
+                alive = false;
+            }
+            sit = alive ? std::next(sit) : f.series.erase(sit);
+        }
+        if (f.series.empty()) {   // every owner gone — the name may be reused
+            fit = families_.erase(fit);
+            continue;
+        }
+        out += "# HELP " + name + ' ';
+        appendEscaped(out, f.help, false);
+        out += "\n# TYPE " + name + ' ' + kTypeNames[f.type] + '\n';
+        out += body;
+        ++fit;
+    }
+    return out;
+}
+
+}  // namespace Metrics
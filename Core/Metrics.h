@@ -0,0 +1,123 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// Metrics — counters, gauges and fixed-bucket histograms for dashboards,
+// exported in the Prometheus text format (MetricsServer serves it over HTTP).
+//
+// Updates are relaxed atomics with no locks: inc(), set() and observe() are
+// safe on the stream threads. The owner of a value holds it by shared_ptr;
+// the Registry keeps only a weak_ptr, so a series disappears from the export
+// when its owner (a handler, a worker) is destroyed. Registration and
+// exposition() take the registry mutex and never touch the hot path. A
+// scrape reads each series once, so its cost does not depend on how often
+// the values change.
+//
+// Names follow Prometheus conventions: stand_<subsystem>_<what>_<unit>,
+// counters end in _total.
+// ---------------------------------------------------------------------------
+namespace Metrics {
+
+using Labels = std::vector<std::pair<std::string, std::string>>;
+
+class Counter {
+public:
+    void inc(uint64_t n = 1) noexcept { v_.fetch_add(n, std::memory_order_relaxed); }
+    [[nodiscard]] uint64_t value() const noexcept { return v_.load(std::memory_order_relaxed); }
+    // Back to 0 — scrapers treat it like a process restart.
+    void reset() noexcept { v_.store(0, std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint64_t> v_{0};
+};
+
+class Gauge {
+public:
+    void set(double v) noexcept { v_.store(v, std::memory_order_relaxed); }
+    void add(double d) noexcept {
+        double cur = v_.load(std::memory_order_relaxed);
+        while (!v_.compare_exchange_weak(cur, cur + d, std::memory_order_relaxed)) {}
+    }
+    [[nodiscard]] double value() const noexcept { return v_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<double> v_{0.0};
+};
+
+// Buckets are fixed at construction (ascending upper bounds, +Inf implied).
+class Histogram {
+public:
+    explicit Histogram(std::vector<double> upperBounds);
+
+    void observe(double v) noexcept;
+
+    struct Snapshot {
+        std::vector<double>   upperBounds;
+        std::vector<uint64_t> cumulative;   // per bound, then +Inf (= count)
+        double                sum{0.0};
+    };
+    [[nodiscard]] Snapshot snapshot() const;
+
+    // 50 µs … 1 s, for per-block durations in seconds.
+    [[nodiscard]] static std::vector<double> latencyBuckets();
+
+private:
+    std::vector<double>                      bounds_;
+    std::unique_ptr<std::atomic<uint64_t>[]> counts_;   // bounds_.size() + 1
+    std::atomic<double>                      sum_{0.0};
+};
+
+class Registry {
+public:
+    static Registry& instance();
+
+    // Register an existing value under name{labels}. A series with the same
+    // name and labels that is still alive is replaced; a name already used
+    // for another metric type is rejected (false).
+    bool add(const std::string& name, const std::string& help, const Labels& labels,
+             const std::shared_ptr<Counter>& counter);
+    bool add(const std::string& name, const std::string& help, const Labels& labels,
+             const std::shared_ptr<Gauge>& gauge);
+    bool add(const std::string& name, const std::string& help, const Labels& labels,
+             const std::shared_ptr<Histogram>& histogram);
+
+    // Create and register in one step.
+    std::shared_ptr<Counter>   counter(const std::string& name, const std::string& help,
+                                       const Labels& labels = {});
+    std::shared_ptr<Gauge>     gauge(const std::string& name, const std::string& help,
+                                     const Labels& labels = {});
+    std::shared_ptr<Histogram> histogram(const std::string& name, const std::string& help,
+                                         std::vector<double> upperBounds,
+                                         const Labels& labels = {});
+
+    // Prometheus text exposition format 0.0.4; drops series whose owner is gone.
+    [[nodiscard]] std::string exposition();
+
+    Registry() = default;   // tests use private registries
+
+private:
+    using Series = std::variant<std::weak_ptr<Counter>, std::weak_ptr<Gauge>,
+                                std::weak_ptr<Histogram>>;
+    struct Family {
+        std::string                   help;
+        std::size_t                   type{0};   // Series::index()
+        std::map<std::string, Series> series;    // rendered labels → value
+    };
+
+    bool addSeries(const std::string& name, const std::string& help, const Labels& labels,
+                   Series series);
+
+    std::mutex                    mutex_;
+    std::map<std::string, Family> families_;
+};
+
+}  // namespace Metrics
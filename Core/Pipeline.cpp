@@ -1,4 +1,5 @@
 #include "Pipeline.h"
+#include "Trace.h"
 
 #include <QtConcurrent/QtConcurrent>
 #include <algorithm>
@@ -28,14 +29,19 @@ void Pipeline::dispatchBlock(const float* iq, int count, double sampleRateHz) {
     // не произойдёт, пока processBlock ещё работает.
     std::shared_lock lock(mutex_);
     if (!pool_ || handlers_.size() <= 1) {
-        for (auto* h : handlers_)
+        for (auto* h : handlers_) {
+            TRACE_SCOPE_TYPE("handler", *h);
             h->processBlock(iq, count, sampleRateHz);
+        }
         return;
     }
     QList<QFuture<void>> futures;
     futures.reserve(static_cast<qsizetype>(handlers_.size()));
     for (auto* h : handlers_)
-        futures << QtConcurrent::run(pool_, [=] { h->processBlock(iq, count, sampleRateHz); });
+        futures << QtConcurrent::run(pool_, [=] {
+            TRACE_SCOPE_TYPE("handler", *h);
+            h->processBlock(iq, count, sampleRateHz);
+        });
     for (auto& f : futures)
         f.waitForFinished();
 }
@@ -44,14 +50,19 @@ void Pipeline::dispatchBlock(const float* iq, int count, double sampleRateHz,
                               const BlockMeta& meta) {
     std::shared_lock lock(mutex_);
     if (!pool_ || handlers_.size() <= 1) {
-        for (auto* h : handlers_)
+        for (auto* h : handlers_) {
+            TRACE_SCOPE_TYPE("handler", *h);
             h->processBlock(iq, count, sampleRateHz, meta);
+        }
         return;
     }
     QList<QFuture<void>> futures;
     futures.reserve(static_cast<qsizetype>(handlers_.size()));
     for (auto* h : handlers_)
-        futures << QtConcurrent::run(pool_, [=] { h->processBlock(iq, count, sampleRateHz, meta); });
+        futures << QtConcurrent::run(pool_, [=] {
+            TRACE_SCOPE_TYPE("handler", *h);
+            h->processBlock(iq, count, sampleRateHz, meta);
+        });
     for (auto& f : futures)
         f.waitForFinished();
 }
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+
+// ---------------------------------------------------------------------------
+// ProcessUsage — CPU time and resident memory of the current process, for
+// soak runs and status lines. Windows: GetProcessTimes / working set;
+// elsewhere: getrusage / /proc/self/statm. 0 when unavailable.
+// ---------------------------------------------------------------------------
+namespace ProcessUsage {
+
+// User + kernel CPU seconds of all threads since process start.
+[[nodiscard]] double cpuSeconds();
+
+// Current resident set (working set) in bytes. Sample it to track a peak:
+// the OS high-water mark cannot be reset between runs.
+[[nodiscard]] uint64_t residentBytes();
+
+}  // namespace ProcessUsage
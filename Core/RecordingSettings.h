@@ -1,6 +1,9 @@
 #pragma once
 
+#include "SegmentedFileWriter.h"
+
 #include <QString>
+#include <cmath>
 
 // ---------------------------------------------------------------------------
 // RecordingSettings — captures the user's preferences from the recording
@@ -12,6 +15,10 @@ struct RecordingSettings {
     enum class RawFormat {
         Float32 = 0,   // .cf32 (32-bit IEEE float interleaved I/Q)
         Float64 = 1,   // .cf64 (64-bit IEEE float interleaved I/Q)
+        Int16   = 2,   // .ci16 (native int16 from the device, bit-exact)
+        Int12   = 3,   // .ci12 (12-bit packed, 3 bytes per I/Q pair)
+        Int8    = 4,   // .ci8  (int8 × per-file scale, see IqFormats)
+        Int16Lossless = 5,   // .ci16z (int16, lossless block-compressed, see IqCodec)
     };
 
     QString   outputDir;
@@ -22,9 +29,57 @@ struct RecordingSettings {
     bool      recordAudio        {false};   // per-demod audio WAV
 
     RawFormat rawFormat    {RawFormat::Float32};
+    bool      writeSigMf   {true};      // .sigmf-meta next to raw I/Q captures
+    // .ci8: the level that maps to ±127. 0 dBFS keeps every sample; lower
+    // values trade clipping of strong signals for resolution of weak ones.
+    double    int8FullScaleDbfs{0.0};
+
+    // Rotate raw/filtered/audio files into segments; 0 = no limit. Whichever
+    // limit is reached first starts the next segment.
+    double    segmentMinutes{0.0};
+    int       segmentMB     {0};
+
+    // Pre-trigger buffer (PreTriggerRecorder on the combined stream). Armed
+    // at stream start; captures are written in preTriggerFormat().
+    bool      preTriggerEnabled  {false};
+    double    preTriggerSec      {5.0};
+    double    postTriggerSec     {5.0};
+    bool      preTriggerInt16    {true};    // halve ring RAM, ~-90 dBFS quantisation
+    double    triggerOffsetKHz   {0.0};     // power trigger band, relative to LO
+    double    triggerBwKHz       {0.0};     // 0 = power trigger off
+    double    triggerLevelDb     {-40.0};
+    QString   triggerClassType;             // classifier trigger, empty = off
+    double    triggerMinConfidence{0.8};
+
+    [[nodiscard]] QString rawExtension() const { return extensionFor(rawFormat); }
+
+    // Float value of one .ci8 step (RawFileHandler::setInt8Scale).
+    [[nodiscard]] float int8Scale() const {
+        return static_cast<float>(std::pow(10.0, int8FullScaleDbfs / 20.0) / 127.0);
+    }
+
+    // The recorder writes float only: cf64 stays cf64, every other rawFormat
+    // (including the compact integer ones) is captured as cf32.
+    [[nodiscard]] RawFormat preTriggerFormat() const {
+        return rawFormat == RawFormat::Float64 ? RawFormat::Float64 : RawFormat::Float32;
+    }
+
+    [[nodiscard]] SegmentedFileWriter::Policy segmentPolicy() const {
+        SegmentedFileWriter::Policy p;
+        p.maxBytes   = segmentMB > 0 ? static_cast<uint64_t>(segmentMB) << 20 : 0;
+        p.maxSeconds = segmentMinutes * 60.0;
+        return p;
+    }
 
-    [[nodiscard]] QString rawExtension() const {
-        return rawFormat == RawFormat::Float64 ? QStringLiteral(".cf64")
-                                               : QStringLiteral(".cf32");
+    [[nodiscard]] static QString extensionFor(RawFormat f) {
+        switch (f) {
+            case RawFormat::Float64: return QStringLiteral(".cf64");
+            case RawFormat::Int16:   return QStringLiteral(".ci16");
+            case RawFormat::Int12:   return QStringLiteral(".ci12");
+            case RawFormat::Int8:    return QStringLiteral(".ci8");
+            case RawFormat::Int16Lossless: return QStringLiteral(".ci16z");
+            case RawFormat::Float32: break;
+        }
+        return QStringLiteral(".cf32");
     }
 };
@@ -0,0 +1,60 @@
+#include "ScanList.h"
+
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+namespace ScanList {
+
+QVector<ScanChannel> load(const QString& path, QString* error) {
+    QVector<ScanChannel> out;
+
+    QFile f(path);
+    if (!f.open(QIODevice::ReadOnly)) {
+        if (error) *error = QStringLiteral("cannot open ") + path;
+        return out;
+    }
+
+    QJsonParseError pe{};
+    const QJsonDocument doc = QJsonDocument::fromJson(f.readAll(), &pe);
+    if (pe.error != QJsonParseError::NoError || !doc.isArray()) {
+        if (error) *error = QStringLiteral("invalid scan list: ") + pe.errorString();
+        return out;
+    }
+
+    const QJsonArray arr = doc.array();
+    out.reserve(arr.size());
+    for (const QJsonValue& v : arr) {
+        const QJsonObject o = v.toObject();
+        ScanChannel c;
+        c.freqHz      = o.value("freqMHz").toDouble() * 1e6;
+        c.mode        = o.value("mode").toString(c.mode).toUpper();
+        c.bandwidthHz = o.value("bwKHz").toDouble(c.bandwidthHz / 1e3) * 1e3;
+        c.priority    = o.value("priority").toInt(c.priority);
+        c.label       = o.value("label").toString();
+        if (c.freqHz > 0.0 && c.bandwidthHz > 0.0)
+            out.append(c);
+    }
+    return out;
+}
+
+bool save(const QString& path, const QVector<ScanChannel>& channels) {
+    QJsonArray arr;
+    for (const ScanChannel& c : channels) {
+        QJsonObject o;
+        o["freqMHz"]  = c.freqHz / 1e6;
+        o["mode"]     = c.mode;
+        o["bwKHz"]    = c.bandwidthHz / 1e3;
+        o["priority"] = c.priority;
+        if (!c.label.isEmpty()) o["label"] = c.label;
+        arr.append(o);
+    }
+
+    QFile f(path);
+    if (!f.open(QIODevice::WriteOnly | QIODevice::Truncate)) return false;
+    f.write(QJsonDocument(arr).toJson(QJsonDocument::Indented));
+    return true;
+}
+
+} // namespace ScanList
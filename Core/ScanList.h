@@ -0,0 +1,33 @@
+#pragma once
+
+#include <QString>
+#include <QVector>
+
+// ---------------------------------------------------------------------------
+// ScanChannel — one memory-scanner entry (absolute frequency).
+//
+// priority — lower value = more important. When more channels are active
+//            than demodulators allowed, the lowest priority values win
+//            (ties broken by SNR).
+// ---------------------------------------------------------------------------
+struct ScanChannel {
+    double  freqHz      = 0.0;
+    QString mode        = QStringLiteral("FM");  // DemodRegistry name
+    double  bandwidthHz = 25'000.0;
+    int     priority    = 100;
+    QString label;
+};
+
+// ---------------------------------------------------------------------------
+// ScanList — JSON load/save of the memory-scanner channel list.
+//
+// File format (array of objects, unknown keys ignored):
+//   [ { "freqMHz": 145.500, "mode": "FM", "bwKHz": 12.5,
+//       "priority": 1, "label": "calling" }, ... ]
+// ---------------------------------------------------------------------------
+namespace ScanList {
+
+[[nodiscard]] QVector<ScanChannel> load(const QString& path, QString* error = nullptr);
+bool save(const QString& path, const QVector<ScanChannel>& channels);
+
+} // namespace ScanList
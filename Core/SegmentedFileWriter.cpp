@@ -0,0 +1,185 @@
+#include "SegmentedFileWriter.h"
+#include "FileNaming.h"
+#include "Logger.h"
+
+#include <QFile>
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+void accumulate(AsyncFileWriter::Stats& into, const AsyncFileWriter::Stats& s) {
+    into.bytesAccepted += s.bytesAccepted;
+    into.bytesWritten  += s.bytesWritten;
+    into.bytesDropped  += s.bytesDropped;
+    into.dropEvents    += s.dropEvents;
+    into.stalls        += s.stalls;
+}
+
+}  // namespace
+
+SegmentedFileWriter::~SegmentedFileWriter() {
+    close();
+}
+
+QString SegmentedFileWriter::segmentPath(int segment) const {
+    return segmented_ ? FileNaming::segmentPath(basePath_, segment) : basePath_;
+}
+
+bool SegmentedFileWriter::open(const QString& basePath,
+                               const AsyncFileWriter::Options& options,
+                               const Policy& policy, double payloadBytesPerSecond,
+                               Hooks hooks) {
+    close();
+
+    basePath_  = basePath;
+    options_   = options;
+    hooks_     = std::move(hooks);
+    segment_   = 0;
+    segmented_ = policy.enabled();
+    limit_     = policy.maxBytes;
+    if (policy.maxSeconds > 0.0 && payloadBytesPerSecond > 0.0) {
+        const auto byTime = static_cast<uint64_t>(
+            std::llround(policy.maxSeconds * payloadBytesPerSecond));
+        limit_ = limit_ > 0 ? std::min(limit_, byTime) : byTime;
+    }
+    if (segmented_ && limit_ == 0) {
+        LOG_WARN("SegmentedFileWriter: duration limit without a data rate, "
+                 "writing one segment: " + basePath.toStdString());
+    }
+    // Reserve the whole segment (header and a sector of slack included).
+    if (limit_ > 0)
+        options_.preallocateBytes = std::max<uint64_t>(
+            options_.preallocateBytes, limit_ + AsyncFileWriter::kAlignment);
+
+    closedStats_ = {};
+    shared_ = std::make_shared<Shared>();
+    cur_    = std::make_unique<AsyncFileWriter>();
+    if (!cur_->open(segmentPath(0), options_)) {
+        cur_.reset();
+        return false;
+    }
+    if (hooks_.begin) hooks_.begin(*cur_);
+    headerBytes_ = cur_->position();
+    prepareNext();
+    return true;
+}
+
+uint64_t SegmentedFileWriter::segmentBytes() const {
+    return cur_ ? cur_->position() - headerBytes_ : 0;
+}
+
+AsyncFileWriter::Stats SegmentedFileWriter::stats() const {
+    if (!shared_) return closedStats_;
+    AsyncFileWriter::Stats s;
+    {
+        std::lock_guard lock(shared_->mutex);
+        s = shared_->retired;
+    }
+    if (cur_) accumulate(s, cur_->stats());
+    return s;
+}
+
+void SegmentedFileWriter::prepareNext() {
+    if (limit_ == 0) return;
+
+    const int     next = segment_ + 1;
+    const QString path = segmentPath(next);
+    {
+        std::lock_guard lock(shared_->mutex);
+        ++shared_->pending;
+    }
+    AsyncFileWriter::post(path, [sh = shared_, path, next, opt = options_] {
+        auto w = std::make_unique<AsyncFileWriter>();
+        const bool ok = w->open(path, opt);
+        std::lock_guard lock(sh->mutex);
+        if (ok) {
+            sh->standby        = std::move(w);
+            sh->standbySegment = next;
+        }
+        --sh->pending;
+        sh->cv.notify_all();
+    });
+}
+
+void SegmentedFileWriter::rotate() {
+    const QString finished = cur_->path();
+    if (hooks_.end) hooks_.end(*cur_, segmentBytes());
+    {
+        std::lock_guard lock(shared_->mutex);
+        ++shared_->pending;
+    }
+    cur_->closeAsync([sh = shared_](const AsyncFileWriter::Stats& st) {
+        std::lock_guard lock(sh->mutex);
+        accumulate(sh->retired, st);
+        --sh->pending;
+        sh->cv.notify_all();
+    });
+
+    ++segment_;
+    std::unique_ptr<AsyncFileWriter> next;
+    {
+        std::lock_guard lock(shared_->mutex);
+        if (shared_->standbySegment == segment_) {
+            next = std::move(shared_->standby);
+            shared_->standbySegment = -1;
+        }
+    }
+    if (!next) {
+        LOG_WARN("SegmentedFileWriter: segment " + std::to_string(segment_ + 1)
+                 + " not pre-opened, opening inline");
+        next = std::make_unique<AsyncFileWriter>();
+        if (!next->open(segmentPath(segment_), options_)) {
+            cur_.reset();   // later writes are dropped; close() still settles the rest
+            return;
+        }
+    }
+
+    cur_ = std::move(next);
+    if (hooks_.begin) hooks_.begin(*cur_);
+    headerBytes_ = cur_->position();
+    if (hooks_.rotated) hooks_.rotated(finished, segment_);
+    prepareNext();
+}
+
+bool SegmentedFileWriter::write(const void* data, std::size_t bytes) {
+    if (!cur_) return false;
+    if (limit_ > 0 && segmentBytes() > 0 && segmentBytes() + bytes > limit_)
+        rotate();
+    return cur_ && cur_->write(data, bytes);
+}
+
+void SegmentedFileWriter::close() {
+    if (!shared_) return;
+
+    if (cur_) {
+        if (hooks_.end) hooks_.end(*cur_, segmentBytes());
+        cur_->close();
+        std::lock_guard lock(shared_->mutex);
+        accumulate(shared_->retired, cur_->stats());
+    }
+    cur_.reset();
+
+    // Wait for in-flight closes and the standby open, then drop the standby.
+    std::unique_ptr<AsyncFileWriter> standby;
+    {
+        std::unique_lock lock(shared_->mutex);
+        shared_->cv.wait(lock, [this] { return shared_->pending == 0; });
+        standby = std::move(shared_->standby);
+    }
+    if (standby) {
+        const QString path = standby->path();
+        standby->close();
+        QFile::remove(path);
+    }
+
+    if (segmented_)
+        LOG_INFO("SegmentedFileWriter: " + basePath_.toStdString() + " closed after "
+                 + std::to_string(segment_ + 1) + " segment(s)");
+    {
+        std::lock_guard lock(shared_->mutex);
+        closedStats_ = shared_->retired;
+    }
+    shared_.reset();
+}
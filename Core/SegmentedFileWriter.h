@@ -0,0 +1,102 @@
+#pragma once
+
+#include "AsyncFileWriter.h"
+
+#include <QString>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+// ---------------------------------------------------------------------------
+// SegmentedFileWriter — AsyncFileWriter that rotates into fixed-size or
+// fixed-duration segments (FileNaming::segmentPath: …_seg0001.cf32, …).
+//
+// Each segment is a complete file: the begin hook writes its header, the end
+// hook queues the final header patch, and the segment is finalised as soon
+// as it is rotated out — a crash loses at most the current segment's header.
+// Every segment is preallocated to the segment size.
+//
+// Rotation never touches the filesystem on the calling thread:
+//   - the next segment is opened (create + preallocate + buffers) ahead of
+//     time on the disk's I/O thread (AsyncFileWriter::post);
+//   - the finished segment is closed with AsyncFileWriter::closeAsync.
+// Only if the standby is not ready yet (segments shorter than a disk
+// round-trip) is the next one opened inline, with a warning.
+//
+// Rotation happens between write() calls, so frames are never split. A
+// disabled Policy writes basePath unchanged, exactly like AsyncFileWriter.
+//
+// Threading: as AsyncFileWriter — write() from one producer thread,
+// open()/close() from the owner; close() blocks until every segment is on
+// disk and discards the unused standby file.
+// ---------------------------------------------------------------------------
+class SegmentedFileWriter {
+public:
+    struct Policy {
+        uint64_t maxBytes{0};      // payload bytes per segment, 0 = unlimited
+        double   maxSeconds{0.0};  // payload duration per segment, 0 = unlimited
+        [[nodiscard]] bool enabled() const { return maxBytes > 0 || maxSeconds > 0.0; }
+    };
+
+    struct Hooks {
+        // A segment became current — write its header (producer thread).
+        std::function<void(AsyncFileWriter& file)> begin;
+        // A segment is about to close — queue header patches (producer/owner).
+        std::function<void(AsyncFileWriter& file, uint64_t payloadBytes)> end;
+        // After a rotation: path of the finished segment, index of the new one.
+        std::function<void(const QString& finishedPath, int segment)> rotated;
+    };
+
+    SegmentedFileWriter() = default;
+    ~SegmentedFileWriter();
+
+    SegmentedFileWriter(const SegmentedFileWriter&) = delete;
+    SegmentedFileWriter& operator=(const SegmentedFileWriter&) = delete;
+
+    // Unsegmented, no hooks.
+    bool open(const QString& basePath, const AsyncFileWriter::Options& options) {
+        return open(basePath, options, Policy{}, 0.0, Hooks{});
+    }
+    // payloadBytesPerSecond converts Policy::maxSeconds into bytes.
+    bool open(const QString& basePath, const AsyncFileWriter::Options& options,
+              const Policy& policy, double payloadBytesPerSecond, Hooks hooks = {});
+    // Returns false if the data was dropped (see AsyncFileWriter::write).
+    bool write(const void* data, std::size_t bytes);
+    void close();
+
+    [[nodiscard]] bool    isOpen()  const { return cur_ && cur_->isOpen(); }
+    [[nodiscard]] QString path()    const { return cur_ ? cur_->path() : QString{}; }
+    [[nodiscard]] int     segment() const { return segment_; }
+    // Payload bytes accepted into the current segment.
+    [[nodiscard]] uint64_t segmentBytes() const;
+    // Summed over all segments (finished segments count once finalised).
+    [[nodiscard]] AsyncFileWriter::Stats stats() const;
+
+private:
+    struct Shared {
+        std::mutex              mutex;
+        std::condition_variable cv;
+        std::unique_ptr<AsyncFileWriter> standby;
+        int                     standbySegment{-1};
+        int                     pending{0};     // opens + closes on the I/O thread
+        AsyncFileWriter::Stats  retired;
+    };
+
+    [[nodiscard]] QString segmentPath(int segment) const;
+    void prepareNext();
+    void rotate();
+
+    QString                  basePath_;
+    AsyncFileWriter::Options options_;
+    Hooks                    hooks_;
+    uint64_t                 limit_{0};     // 0 = never rotate
+    bool                     segmented_{false};
+    int                      segment_{0};
+    uint64_t                 headerBytes_{0};
+    std::unique_ptr<AsyncFileWriter> cur_;
+    std::shared_ptr<Shared>  shared_;        // null when closed
+    AsyncFileWriter::Stats   closedStats_;   // totals of the last recording
+};
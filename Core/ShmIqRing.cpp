@@ -0,0 +1,128 @@
+#include "ShmIqRing.h"
+
+#include <QNativeIpcKey>
+#include <QSharedMemory>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+namespace {
+
+// Header field offsets — keep in sync with Python/classifier_service.py.
+constexpr std::size_t kOffMagic      = 0;
+constexpr std::size_t kOffVersion    = 4;
+constexpr std::size_t kOffSlotCount  = 8;
+constexpr std::size_t kOffSlotBytes  = 12;
+constexpr std::size_t kOffPayload   = 16;
+constexpr std::size_t kOffWriteSeq   = 24;
+constexpr std::size_t kOffReadSeq    = 32;
+constexpr std::size_t kOffDropped    = 40;
+
+// Slot field offsets.
+constexpr std::size_t kSlotFrameSeq = 0;
+constexpr std::size_t kSlotBytes    = 8;
+
+std::atomic_ref<uint64_t> field64(unsigned char* base, std::size_t offset) {
+    return std::atomic_ref<uint64_t>(*reinterpret_cast<uint64_t*>(base + offset));
+}
+
+template <typename T>
+void put(unsigned char* at, T v) { std::memcpy(at, &v, sizeof v); }
+
+}  // namespace
+
+ShmIqRing::ShmIqRing() = default;
+
+ShmIqRing::~ShmIqRing() {
+    close();
+}
+
+bool ShmIqRing::create(const QString& name, int slotCount, std::size_t payloadBytes,
+                       QString* error) {
+    close();
+    if (slotCount < 2 || payloadBytes < 1 || payloadBytes > (1u << 30)) {
+        if (error) *error = QStringLiteral("ShmIqRing: need ≥ 2 slots of 1 B .. 1 GiB");
+        return false;
+    }
+
+    // Slots start on a 64-byte boundary so frameSeq never shares a line with
+    // the previous slot's payload.
+    const std::size_t slotBytes = (kSlotHeader + payloadBytes + 63) & ~std::size_t{63};
+    const std::size_t total     = kHeaderBytes + slotBytes * static_cast<std::size_t>(slotCount);
+
+#ifdef _WIN32
+    const QNativeIpcKey key(name, QNativeIpcKey::Type::Windows);
+#else
+    const QNativeIpcKey key(QLatin1Char('/') + name, QNativeIpcKey::Type::PosixRealtime);
+#endif
+    auto shm = std::make_unique<QSharedMemory>(key);
+    if (!shm->create(static_cast<qsizetype>(total))) {
+        if (error) *error = QStringLiteral("ShmIqRing: cannot create %1 — %2")
+                                .arg(name, shm->errorString());
+        return false;
+    }
+
+    base_         = static_cast<unsigned char*>(shm->data());
+    shm_          = std::move(shm);
+    name_         = name;
+    slotCount_    = static_cast<uint32_t>(slotCount);
+    slotBytes_    = static_cast<uint32_t>(slotBytes);
+    payloadBytes_ = payloadBytes;
+    writeSeq_     = 0;
+
+    std::memset(base_, 0, total);
+    put(base_ + kOffMagic,     kMagic);
+    put(base_ + kOffVersion,   kVersion);
+    put(base_ + kOffSlotCount, slotCount_);
+    put(base_ + kOffSlotBytes, slotBytes_);
+    put(base_ + kOffPayload,   static_cast<uint32_t>(payloadBytes_));
+    std::atomic_thread_fence(std::memory_order_release);
+    return true;
+}
+
+void ShmIqRing::close() {
+    base_    = nullptr;
+    pending_ = nullptr;
+    shm_.reset();   // detach; the OS object goes once no process maps it
+    name_.clear();
+}
+
+unsigned char* ShmIqRing::beginWrite() {
+    if (!base_) return nullptr;
+
+    const uint64_t read = field64(base_, kOffReadSeq).load(std::memory_order_acquire);
+    if (read <= writeSeq_ && writeSeq_ - read >= slotCount_) {
+        // Reader still owns the oldest slot — drop rather than overwrite.
+        field64(base_, kOffDropped).fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    pending_ = base_ + kHeaderBytes + static_cast<std::size_t>(writeSeq_ % slotCount_) * slotBytes_;
+    return pending_ + kSlotHeader;
+}
+
+void ShmIqRing::commit(std::size_t bytes) {
+    if (!pending_) return;
+    put(pending_ + kSlotBytes, static_cast<uint32_t>(std::min(bytes, payloadBytes_)));
+    ++writeSeq_;
+    field64(pending_, kSlotFrameSeq).store(writeSeq_, std::memory_order_release);
+    field64(base_, kOffWriteSeq).store(writeSeq_, std::memory_order_release);
+    pending_ = nullptr;
+}
+
+bool ShmIqRing::write(const void* data, std::size_t bytes) {
+    if (bytes > payloadBytes_) return false;
+    unsigned char* slot = beginWrite();
+    if (!slot) return false;
+    std::memcpy(slot, data, bytes);
+    commit(bytes);
+    return true;
+}
+
+uint64_t ShmIqRing::written() const {
+    return base_ ? field64(base_, kOffWriteSeq).load(std::memory_order_relaxed) : 0;
+}
+
+uint64_t ShmIqRing::dropped() const {
+    return base_ ? field64(base_, kOffDropped).load(std::memory_order_relaxed) : 0;
+}
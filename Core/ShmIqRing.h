@@ -0,0 +1,88 @@
+#pragma once
+
+#include <QString>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+class QSharedMemory;
+
+// ---------------------------------------------------------------------------
+// ShmIqRing — single-producer ring of frames in shared memory, read by an
+// external process (Python/classifier_service.py --shm <name>). The payload
+// is opaque here; the classifier puts ClassifierProtocol frames in it.
+//
+// beginWrite() hands out the next slot's payload so the producer builds the
+// frame in place: no allocation, no lock, no syscall, no hand-off to another
+// thread. When the reader has not yet released the oldest slot, beginWrite()
+// returns nullptr and the frame is dropped and counted (dropped(), and the
+// header's droppedFrames for the reader) — a slow reader never sees a frame
+// overwritten while it looks at it, and nothing queues up.
+//
+// Layout (little-endian, offsets in bytes):
+//   header (64):  0 u32 magic "STIQ"   4 u32 version (2)
+//                 8 u32 slotCount     12 u32 slotBytes (stride)
+//                16 u32 payloadBytes (capacity per slot)
+//                24 u64 writeSeq    — frames published (writer)
+//                32 u64 readSeq     — frames released  (reader)
+//                40 u64 droppedFrames
+//   slot k = frame % slotCount at 64 + k * slotBytes:
+//                 0 u64 frameSeq    — frame + 1 once the slot is complete
+//                 8 u32 bytes       — payload length
+//                16 payload
+// writeSeq/readSeq/frameSeq are published with release stores; the reader
+// loads writeSeq, reads the slot, then stores readSeq + 1.
+//
+// Backed by QSharedMemory with a native key: a POSIX shm object (/name) on
+// Unix, a named file mapping on Windows — both what Python's
+// multiprocessing.shared_memory.SharedMemory(name) opens. There is no wake-up
+// primitive that both sides share on every platform; the reader polls
+// writeSeq (the classifier needs one frame per ~100 ms).
+//
+// Threading: create()/close() on the owner thread while no write runs;
+// beginWrite()/commit() from one thread at a time.
+// ---------------------------------------------------------------------------
+class ShmIqRing {
+public:
+    static constexpr uint32_t kMagic       = 0x51495453;   // "STIQ"
+    static constexpr uint32_t kVersion     = 2;
+    static constexpr int      kHeaderBytes = 64;
+    static constexpr int      kSlotHeader  = 16;
+
+    ShmIqRing();
+    ~ShmIqRing();
+    ShmIqRing(const ShmIqRing&)            = delete;
+    ShmIqRing& operator=(const ShmIqRing&) = delete;
+
+    // name: letters, digits and '_' — the reader opens the same name.
+    bool create(const QString& name, int slotCount, std::size_t payloadBytes,
+                QString* error = nullptr);
+    void close();
+
+    [[nodiscard]] bool        isOpen()       const { return base_ != nullptr; }
+    [[nodiscard]] QString     name()         const { return name_; }
+    [[nodiscard]] std::size_t payloadBytes() const { return payloadBytes_; }
+
+    // Payload of the next free slot (payloadBytes() long), or nullptr when
+    // the ring is closed or full — a full ring counts the frame as dropped.
+    // A slot that is never committed is simply handed out again.
+    unsigned char* beginWrite();
+    // Publishes the slot from beginWrite() with its first `bytes` bytes.
+    void commit(std::size_t bytes);
+
+    // beginWrite() + copy + commit(). False = dropped, or bytes too large.
+    bool write(const void* data, std::size_t bytes);
+
+    [[nodiscard]] uint64_t written() const;
+    [[nodiscard]] uint64_t dropped() const;
+
+private:
+    std::unique_ptr<QSharedMemory> shm_;
+    QString        name_;
+    unsigned char* base_{nullptr};
+    unsigned char* pending_{nullptr};   // slot handed out by beginWrite()
+    uint32_t       slotCount_{0};
+    uint32_t       slotBytes_{0};
+    std::size_t    payloadBytes_{0};
+    uint64_t       writeSeq_{0};        // writer's copy of the header field
+};
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "IPipelineHandler.h"
+#include "LatencyHistogram.h"
+
+#include <chrono>
+
+// ---------------------------------------------------------------------------
+// TimedHandler — IPipelineHandler decorator that records how long the
+// wrapped handler's processBlock() takes into a LatencyHistogram.
+//
+// Add the wrapper to the Pipeline instead of the handler; lifecycle hooks are
+// forwarded unchanged. Neither pointer is owned. Cost: two steady_clock reads
+// and a histogram record per block.
+// ---------------------------------------------------------------------------
+class TimedHandler : public IPipelineHandler {
+public:
+    TimedHandler(IPipelineHandler* inner, LatencyHistogram* latency)
+        : inner_(inner), latency_(latency) {}
+
+    void processBlock(const float* iq, int count, double sampleRateHz) override {
+        const auto t0 = Clock::now();
+        inner_->processBlock(iq, count, sampleRateHz);
+        record(t0);
+    }
+    void processBlock(const float* iq, int count, double sampleRateHz,
+                      const BlockMeta& meta) override {
+        const auto t0 = Clock::now();
+        inner_->processBlock(iq, count, sampleRateHz, meta);
+        record(t0);
+    }
+
+    void onStreamStarted(double sampleRateHz) override { inner_->onStreamStarted(sampleRateHz); }
+    void onStreamStopped() override { inner_->onStreamStopped(); }
+    void onRetune(double newFreqHz) override { inner_->onRetune(newFreqHz); }
+
+    [[nodiscard]] IPipelineHandler* inner() const { return inner_; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    void record(Clock::time_point t0) {
+        latency_->record(static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - t0).count()));
+    }
+
+    IPipelineHandler* inner_;
+    LatencyHistogram* latency_;
+};
@@ -0,0 +1,179 @@
+#include "Trace.h"
+
+#include <QSaveFile>
+#include <QThread>
+
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#if defined(__GNUG__)
+#  include <cxxabi.h>
+#  include <cstdlib>
+#endif
+
+namespace {
+
+// One slot of a thread's ring. Fields are relaxed atomics so a concurrent
+// dump is race-free; seq is odd while the owner is writing, 2·(i+1) once
+// event i is complete (seqlock).
+struct Slot {
+    std::atomic<uint64_t>    seq{0};
+    std::atomic<const char*> cat{nullptr};
+    std::atomic<const char*> name{nullptr};
+    std::atomic<uint64_t>    beginNs{0};
+    std::atomic<uint64_t>    durNs{0};
+    std::atomic<bool>        typeName{false};
+};
+
+struct ThreadBuffer {
+    int                     tid{0};
+    std::string             name;        // guarded by g_mutex
+    std::unique_ptr<Slot[]> ring{new Slot[Trace::kEventsPerThread]};
+    std::atomic<uint64_t>   head{0};     // events ever written
+};
+
+std::mutex                                 g_mutex;
+std::vector<std::unique_ptr<ThreadBuffer>> g_buffers;   // never shrinks
+std::atomic<uint64_t>                      g_sinceNs{0};
+const uint64_t                             g_epochNs = Trace::nowNs();
+
+thread_local ThreadBuffer* t_buffer = nullptr;
+
+ThreadBuffer* threadBuffer() {
+    if (t_buffer) return t_buffer;
+    auto buf = std::make_unique<ThreadBuffer>();
+    const QString qtName = QThread::currentThread() ? QThread::currentThread()->objectName()
+                                                    : QString();
+    std::lock_guard lock(g_mutex);
+    buf->tid  = static_cast<int>(g_buffers.size()) + 1;
+    buf->name = qtName.isEmpty() ? "thread " + std::to_string(buf->tid) : qtName.toStdString();
+    t_buffer  = buf.get();
+    g_buffers.push_back(std::move(buf));
+    return t_buffer;
+}
+
+// type_info::name() is mangled on GCC/MinGW, readable on MSVC.
+std::string demangle(const char* name) {
+#if defined(__GNUG__)
+    int status = 0;
+    char* d = abi::__cxa_demangle(name, nullptr, nullptr, &status);
+    if (status == 0 && d) {
+        std::string s(d);
+        std::free(d);
+        return s;
+    }
+#endif
+    return name;
+}
+
+void appendEscaped(std::string& out, const std::string& s) {
+    for (char c : s) {
+        if (c == '"' || c == '\\') out += '\\';
+        if (static_cast<unsigned char>(c) >= 0x20) out += c;
+    }
+}
+
+void appendThread(std::string& json, const ThreadBuffer& buf, uint64_t since,
+                  std::map<const char*, std::string>& typeNames) {
+    json += ",\n{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":";
+    json += std::to_string(buf.tid);
+    json += ",\"args\":{\"name\":\"";
+    appendEscaped(json, buf.name);
+    json += "\"}}";
+
+    constexpr uint64_t kCap = Trace::kEventsPerThread;
+    char num[128];
+    const uint64_t head  = buf.head.load(std::memory_order_acquire);
+    const uint64_t first = head > kCap ? head - kCap : 0;
+    for (uint64_t i = first; i < head; ++i) {
+        const Slot& s = buf.ring[i & (kCap - 1)];
+        if (s.seq.load(std::memory_order_acquire) != 2 * i + 2) continue;
+        const char*    cat   = s.cat.load(std::memory_order_relaxed);
+        const char*    name  = s.name.load(std::memory_order_relaxed);
+        const bool     tname = s.typeName.load(std::memory_order_relaxed);
+        const uint64_t begin = s.beginNs.load(std::memory_order_relaxed);
+        const uint64_t dur   = s.durNs.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (s.seq.load(std::memory_order_relaxed) != 2 * i + 2) continue;   // overwritten meanwhile
+        if (begin < since || begin < g_epochNs) continue;
+
+        json += ",\n{\"ph\":\"X\",\"cat\":\"";
+        appendEscaped(json, cat);
+        json += "\",\"name\":\"";
+        if (tname) {
+            auto it = typeNames.find(name);
+            if (it == typeNames.end()) it = typeNames.emplace(name, demangle(name)).first;
+            appendEscaped(json, it->second);
+        } else {
+            appendEscaped(json, name);
+        }
+        std::snprintf(num, sizeof num, "\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%d}",
+                      static_cast<double>(begin - g_epochNs) / 1e3,
+                      static_cast<double>(dur) / 1e3, buf.tid);
+        json += num;
+    }
+}
+
+}  // namespace
+
+namespace Trace {
+
+void detail::record(const char* cat, const char* name, bool typeName,
+                    uint64_t beginNs, uint64_t endNs) noexcept {
+    ThreadBuffer* buf = threadBuffer();
+    const uint64_t i = buf->head.load(std::memory_order_relaxed);
+    Slot& s = buf->ring[i & (kEventsPerThread - 1)];
+
+    s.seq.store(2 * i + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    s.cat.store(cat, std::memory_order_relaxed);
+    s.name.store(name, std::memory_order_relaxed);
+    s.typeName.store(typeName, std::memory_order_relaxed);
+    s.beginNs.store(beginNs, std::memory_order_relaxed);
+    s.durNs.store(endNs - beginNs, std::memory_order_relaxed);
+    s.seq.store(2 * i + 2, std::memory_order_release);
+    buf->head.store(i + 1, std::memory_order_release);
+}
+
+void setEnabled(bool on) {
+    detail::g_enabled.store(on, std::memory_order_relaxed);
+}
+
+void clear() {
+    g_sinceNs.store(nowNs(), std::memory_order_relaxed);
+}
+
+void setThreadName(const std::string& name) {
+    ThreadBuffer* buf = threadBuffer();
+    std::lock_guard lock(g_mutex);
+    buf->name = name;
+}
+
+bool writeChromeJson(const QString& path, QString* error) {
+    const uint64_t since = g_sinceNs.load(std::memory_order_relaxed);
+
+    std::string json = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n"
+                       "{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":1,\"tid\":0,"
+                       "\"args\":{\"name\":\"Stand\"}}";
+    std::map<const char*, std::string> typeNames;
+    {
+        std::lock_guard lock(g_mutex);
+        for (const auto& buf : g_buffers)
+            appendThread(json, *buf, since, typeNames);
+    }
+    json += "\n]}\n";
+
+    QSaveFile f(path);
+    if (!f.open(QIODevice::WriteOnly)
+        || f.write(json.data(), static_cast<qint64>(json.size())) != static_cast<qint64>(json.size())
+        || !f.commit()) {
+        if (error) *error = QStringLiteral("cannot write ") + path;
+        return false;
+    }
+    return true;
+}
+
+}  // namespace Trace
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <QString>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <typeinfo>
+
+// ---------------------------------------------------------------------------
+// Trace — span recorder for Chrome / Perfetto trace-event JSON
+// (chrome://tracing, ui.perfetto.dev).
+//
+// Every thread writes complete spans ("ph":"X") into its own ring of
+// kEventsPerThread events: no locks and no allocation on the hot path, the
+// oldest spans are overwritten. writeChromeJson() may run while threads keep
+// recording — each slot is sequence-checked, a slot rewritten mid-copy is
+// skipped. Rings outlive their threads, so a dump after stop still shows the
+// workers.
+//
+// Recording is off until setEnabled(true); a disabled TRACE_SCOPE costs one
+// relaxed load. Building with STAND_TRACING=0 (CMake option) removes the
+// macros entirely. Names and categories must be string literals — only the
+// pointer is stored.
+// ---------------------------------------------------------------------------
+#ifndef STAND_TRACING
+#  define STAND_TRACING 1
+#endif
+
+namespace Trace {
+
+constexpr std::size_t kEventsPerThread = std::size_t{1} << 16;
+
+namespace detail {
+inline std::atomic<bool> g_enabled{false};
+void record(const char* cat, const char* name, bool typeName,
+            uint64_t beginNs, uint64_t endNs) noexcept;
+}  // namespace detail
+
+[[nodiscard]] inline bool enabled() noexcept {
+    return detail::g_enabled.load(std::memory_order_relaxed);
+}
+
+void setEnabled(bool on);
+
+// Drops everything recorded so far from later dumps.
+void clear();
+
+// Label of the calling thread in the trace (default: QThread objectName or
+// "thread N"). Call once from the thread itself.
+void setThreadName(const std::string& name);
+
+// Writes every thread's retained spans; false with *error on I/O failure.
+bool writeChromeJson(const QString& path, QString* error = nullptr);
+
+[[nodiscard]] inline uint64_t nowNs() noexcept {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// RAII span; records nothing when tracing was off at construction.
+class Scope {
+public:
+    Scope(const char* cat, const char* name) noexcept
+        : cat_(cat), name_(name), beginNs_(enabled() ? nowNs() : 0) {}
+
+    // Span named after the dynamic type — for handlers behind an interface.
+    Scope(const char* cat, const std::type_info& type) noexcept
+        : cat_(cat), name_(type.name()), typeName_(true)
+        , beginNs_(enabled() ? nowNs() : 0) {}
+
+    ~Scope() {
+        if (beginNs_) detail::record(cat_, name_, typeName_, beginNs_, nowNs());
+    }
+
+    Scope(const Scope&)            = delete;
+    Scope& operator=(const Scope&) = delete;
+
+private:
+    const char* cat_;
+    const char* name_;
+    bool        typeName_{false};
+    uint64_t    beginNs_;
+};
+
+}  // namespace Trace
+
+#define STAND_TRACE_CAT_(a, b) a##b
+#define STAND_TRACE_VAR_(line) STAND_TRACE_CAT_(traceScope_, line)
+
+#if STAND_TRACING
+// TRACE_SCOPE("rx", "readBlock");   TRACE_SCOPE_TYPE("handler", *h);
+#  define TRACE_SCOPE(cat, name)     const Trace::Scope STAND_TRACE_VAR_(__LINE__)((cat), (name))
+#  define TRACE_SCOPE_TYPE(cat, obj) const Trace::Scope STAND_TRACE_VAR_(__LINE__)((cat), typeid(obj))
+#else
+#  define TRACE_SCOPE(cat, name)     static_cast<void>(0)
+#  define TRACE_SCOPE_TYPE(cat, obj) static_cast<void>(0)
+#endif
@@ -55,3 +55,16 @@ double AmDemodulator::demodulateIF(std::complex<double> /*ifSample*/, double ifP
 void AmDemodulator::resetDemodState() {
     envDc_.reset();
 }
+
+// ---------------------------------------------------------------------------
+// Offline chunking
+// ---------------------------------------------------------------------------
+std::unique_ptr<BaseDemodulator> AmDemodulator::clone() const {
+    return std::make_unique<AmDemodulator>(*this);
+}
+
+bool AmDemodulator::sameDemodState(const BaseDemodulator& other) const {
+    const auto* o = dynamic_cast<const AmDemodulator*>(&other);
+    return o && dsp::sameBits(envDc_.state, o->envDc_.state)
+             && dsp::sameBits(envDc_.prevIn, o->envDc_.prevIn);
+}
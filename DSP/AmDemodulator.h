@@ -18,10 +18,14 @@ public:
 
     void setBandwidth(double bandwidthHz);
 
+    [[nodiscard]] std::unique_ptr<BaseDemodulator> clone() const override;
+
 protected:
     double demodulateIF(std::complex<double> ifSample, double ifPower) override;
     void resetDemodState() override;
     const char* demodName() const override { return "AmDemodulator"; }
+    double settlingIfSamples() const override { return dsp::settlingSamples(envDc_.alpha); }
+    bool   sameDemodState(const BaseDemodulator& other) const override;
 
 private:
     dsp::IirHighpass1 envDc_;   // envelope DC removal (~20 Hz)
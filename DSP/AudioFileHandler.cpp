@@ -1,26 +1,30 @@
 #include "AudioFileHandler.h"
 #include "Logger.h"
+#include "Trace.h"
 
+#include <algorithm>
+#include <cstring>
 #include <limits>
 
 namespace {
 
-void writeU32(FILE* f, uint32_t v) {
-    uint8_t b[4] = {
-        static_cast<uint8_t>( v        & 0xFF),
-        static_cast<uint8_t>((v >>  8) & 0xFF),
-        static_cast<uint8_t>((v >> 16) & 0xFF),
-        static_cast<uint8_t>((v >> 24) & 0xFF),
-    };
-    std::fwrite(b, 1, 4, f);
+uint8_t* putU32(uint8_t* p, uint32_t v) {
+    p[0] = static_cast<uint8_t>( v        & 0xFF);
+    p[1] = static_cast<uint8_t>((v >>  8) & 0xFF);
+    p[2] = static_cast<uint8_t>((v >> 16) & 0xFF);
+    p[3] = static_cast<uint8_t>((v >> 24) & 0xFF);
+    return p + 4;
 }
 
-void writeU16(FILE* f, uint16_t v) {
-    uint8_t b[2] = {
-        static_cast<uint8_t>( v       & 0xFF),
-        static_cast<uint8_t>((v >> 8) & 0xFF),
-    };
-    std::fwrite(b, 1, 2, f);
+uint8_t* putU16(uint8_t* p, uint16_t v) {
+    p[0] = static_cast<uint8_t>( v       & 0xFF);
+    p[1] = static_cast<uint8_t>((v >> 8) & 0xFF);
+    return p + 2;
+}
+
+uint8_t* putTag(uint8_t* p, const char* tag) {
+    std::memcpy(p, tag, 4);
+    return p + 4;
 }
 
 }  // namespace
@@ -35,11 +39,8 @@ AudioFileHandler::~AudioFileHandler() {
 }
 
 void AudioFileHandler::close() {
-    if (!file_) return;
-    patchWavHeader();
-    std::fflush(file_);
-    std::fclose(file_);
-    file_ = nullptr;
+    if (!file_.isOpen()) return;
+    file_.close();   // end hook patches the header
     LOG_INFO("AudioFileHandler: closed " + path_.toStdString()
              + " (" + std::to_string(samplesWritten_) + " samples)");
 }
@@ -51,8 +52,18 @@ bool AudioFileHandler::openFile(double sampleRateHz) {
         return false;
     }
 
-    file_ = std::fopen(path_.toStdString().c_str(), "wb");
-    if (!file_) {
+    const auto rate = static_cast<uint32_t>(sampleRateHz);
+    SegmentedFileWriter::Hooks hooks;
+    hooks.begin = [rate](AsyncFileWriter& f) {
+        const auto header = makeWavHeader(rate, 0);
+        f.write(header.data(), header.size());
+    };
+    hooks.end = [rate](AsyncFileWriter& f, uint64_t dataBytes) {
+        const auto header = makeWavHeader(rate, dataBytes);
+        f.patchOnClose(0, header.data(), header.size());
+    };
+    if (!file_.open(path_, AsyncFileWriter::Options{}, segmentPolicy_,
+                    sampleRateHz * sizeof(float), std::move(hooks))) {
         LOG_ERROR("AudioFileHandler: cannot open " + path_.toStdString());
         return false;
     }
@@ -61,16 +72,16 @@ bool AudioFileHandler::openFile(double sampleRateHz) {
     samplesWritten_   = 0;
     overflowLogged_   = false;
 
-    writeWavHeader(static_cast<uint32_t>(sampleRateHz), 0);
     LOG_INFO("AudioFileHandler: writing mono float32 WAV to " + path_.toStdString()
              + " @ " + std::to_string(static_cast<int>(sampleRateHz)) + " Hz");
     return true;
 }
 
 void AudioFileHandler::push(QVector<float> samples, double sampleRateHz) {
+    TRACE_SCOPE("audio", "AudioFileHandler::push");
     if (samples.isEmpty() || sampleRateHz <= 0.0) return;
 
-    if (!file_) {
+    if (!file_.isOpen()) {
         if (!openFile(sampleRateHz)) return;
     } else if (sampleRateHz != openedSampleRate_) {
         LOG_WARN("AudioFileHandler: sample rate changed from "
@@ -80,53 +91,47 @@ void AudioFileHandler::push(QVector<float> samples, double sampleRateHz) {
     }
 
     const std::size_t n = static_cast<std::size_t>(samples.size());
-    const std::size_t written =
-        std::fwrite(samples.constData(), sizeof(float), n, file_);
+    if (!file_.write(samples.constData(), n * sizeof(float)))
+        return;   // writer backlog — counted by AsyncFileWriter, logged at close
 
-    samplesWritten_ += written;
+    samplesWritten_ += n;
 
-    // WAV header's data-chunk size is uint32 — warn once when we exceed 4 GB
-    // of audio payload. Data keeps streaming; the header simply gets clamped.
-    constexpr uint64_t kMaxSamples =
-        static_cast<uint64_t>(std::numeric_limits<uint32_t>::max()) / sizeof(float);
-    if (!overflowLogged_ && samplesWritten_ > kMaxSamples) {
+    // WAV header's data-chunk size is uint32 — warn once when a file exceeds
+    // 4 GB of audio payload. Data keeps streaming; the header gets clamped.
+    if (!overflowLogged_ && file_.segmentBytes() > std::numeric_limits<uint32_t>::max()) {
         LOG_WARN("AudioFileHandler: WAV data size exceeds 4 GB, header will be clamped");
         overflowLogged_ = true;
     }
 }
 
-void AudioFileHandler::writeWavHeader(uint32_t sampleRate, uint32_t dataBytes) {
-    // RIFF/WAVE, IEEE float32, mono.
+std::array<uint8_t, AudioFileHandler::kWavHeaderBytes>
+AudioFileHandler::makeWavHeader(uint32_t sampleRate, uint64_t payloadBytes) {
+    // RIFF/WAVE, IEEE float32, mono. The data-chunk size is uint32 — clamped past 4 GB.
+    const uint32_t dataBytes = static_cast<uint32_t>(
+        std::min<uint64_t>(payloadBytes, std::numeric_limits<uint32_t>::max() - 36));
     const uint16_t numChannels = 1;
     const uint16_t bitsPerSmp  = 32;
     const uint32_t byteRate    = sampleRate * numChannels * (bitsPerSmp / 8);
     const uint16_t blockAlign  = numChannels * (bitsPerSmp / 8);
     const uint32_t chunkSize   = 36 + dataBytes;
 
-    std::fwrite("RIFF", 1, 4, file_);
-    writeU32(file_, chunkSize);
-    std::fwrite("WAVE", 1, 4, file_);
-
-    std::fwrite("fmt ", 1, 4, file_);
-    writeU32(file_, 18);                 // sub-chunk size
-    writeU16(file_, 3);                  // audio format: 3 = IEEE float
-    writeU16(file_, numChannels);
-    writeU32(file_, sampleRate);
-    writeU32(file_, byteRate);
-    writeU16(file_, blockAlign);
-    writeU16(file_, bitsPerSmp);
-    writeU16(file_, 0);                  // extra params = 0
-
-    std::fwrite("data", 1, 4, file_);
-    writeU32(file_, dataBytes);
-}
-
-void AudioFileHandler::patchWavHeader() {
-    if (!file_) return;
-    const uint64_t total = samplesWritten_ * sizeof(float);
-    const uint32_t clamped = total > std::numeric_limits<uint32_t>::max()
-                                 ? std::numeric_limits<uint32_t>::max()
-                                 : static_cast<uint32_t>(total);
-    std::rewind(file_);
-    writeWavHeader(static_cast<uint32_t>(openedSampleRate_), clamped);
+    std::array<uint8_t, kWavHeaderBytes> h{};
+    uint8_t* p = h.data();
+    p = putTag(p, "RIFF");
+    p = putU32(p, chunkSize);
+    p = putTag(p, "WAVE");
+
+    p = putTag(p, "fmt ");
+    p = putU32(p, 18);                   // sub-chunk size
+    p = putU16(p, 3);                    // audio format: 3 = IEEE float
+    p = putU16(p, numChannels);
+    p = putU32(p, sampleRate);
+    p = putU32(p, byteRate);
+    p = putU16(p, blockAlign);
+    p = putU16(p, bitsPerSmp);
+    p = putU16(p, 0);                    // extra params = 0
+
+    p = putTag(p, "data");
+    putU32(p, dataBytes);
+    return h;
 }
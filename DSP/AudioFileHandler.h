@@ -1,11 +1,13 @@
 #pragma once
 
+#include "../Core/SegmentedFileWriter.h"
+
 #include <QObject>
 #include <QString>
 #include <QVector>
 
+#include <array>
 #include <cstdint>
-#include <cstdio>
 #include <functional>
 
 // ---------------------------------------------------------------------------
@@ -24,6 +26,10 @@
 //       return FileNaming::composeWithSuffix(dir, ts, src, "fm0",
 //                                            centerHz, sr, ".wav");
 //   };
+//
+// push() runs on the UI thread, so the file goes through AsyncFileWriter:
+// push() only copies the block, the I/O thread does the fwrite. With a
+// segment policy every segment is a complete WAV, finalised at rotation.
 // ---------------------------------------------------------------------------
 class AudioFileHandler : public QObject {
     Q_OBJECT
@@ -33,10 +39,13 @@ public:
     explicit AudioFileHandler(PathBuilder builder, QObject* parent = nullptr);
     ~AudioFileHandler() override;
 
+    // Call before the first push().
+    void setSegmentPolicy(const SegmentedFileWriter::Policy& policy) { segmentPolicy_ = policy; }
+
     // Flush WAV header with final sample count and close the file.
     void close();
 
-    [[nodiscard]] bool    isOpen() const { return file_ != nullptr; }
+    [[nodiscard]] bool    isOpen() const { return file_.isOpen(); }
     [[nodiscard]] QString path()   const { return path_; }
 
 public slots:
@@ -44,12 +53,14 @@ public slots:
 
 private:
     bool openFile(double sampleRateHz);
-    void writeWavHeader(uint32_t sampleRate, uint32_t dataBytes);
-    void patchWavHeader();
+    static constexpr std::size_t kWavHeaderBytes = 46;
+    static std::array<uint8_t, kWavHeaderBytes> makeWavHeader(uint32_t sampleRate,
+                                                              uint64_t payloadBytes);
 
-    PathBuilder builder_;
-    QString     path_;
-    FILE*       file_{nullptr};
+    PathBuilder     builder_;
+    QString         path_;
+    SegmentedFileWriter         file_;
+    SegmentedFileWriter::Policy segmentPolicy_;
     double      openedSampleRate_{0.0};
     uint64_t    samplesWritten_{0};
     bool        overflowLogged_{false};
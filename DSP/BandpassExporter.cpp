@@ -1,6 +1,7 @@
 #include "BandpassExporter.h"
 #include "Logger.h"
 
+#include <algorithm>
 #include <cmath>
 #include <cstring>
 #include <stdexcept>
@@ -75,9 +76,19 @@ std::complex<double> BandpassExporter::filterSample(std::complex<double> x) {
 // ---------------------------------------------------------------------------
 // WAV I/O
 // ---------------------------------------------------------------------------
-bool BandpassExporter::open(const QString& path) {
-    fileHandle_ = std::fopen(path.toStdString().c_str(), "wb");
-    if (!fileHandle_) {
+bool BandpassExporter::open(const QString& path, const SegmentedFileWriter::Policy& segments) {
+    constexpr int64_t kPairBytes = 2 * sizeof(float);
+    SegmentedFileWriter::Hooks hooks;
+    hooks.begin = [this](AsyncFileWriter& f) {
+        const auto header = makeWavHeader(0);   // placeholder — patched by the end hook
+        f.write(header.data(), header.size());
+    };
+    hooks.end = [this](AsyncFileWriter& f, uint64_t dataBytes) {
+        const auto header = makeWavHeader(static_cast<int64_t>(dataBytes) / kPairBytes);
+        f.patchOnClose(0, header.data(), header.size());
+    };
+    if (!file_.open(path, AsyncFileWriter::Options{}, segments,
+                    outputSR_ * kPairBytes, std::move(hooks))) {
         LOG_ERROR("BandpassExporter: cannot open " + path.toStdString());
         return false;
     }
@@ -87,7 +98,6 @@ bool BandpassExporter::open(const QString& path) {
     firDelayLine_.assign(kFirTaps, {0.0, 0.0});
     firHead_ = 0;
 
-    writeWavHeader(0);   // placeholder — patched in close()
     LOG_INFO("BandpassExporter: opened " + path.toStdString());
     return true;
 }
@@ -100,10 +110,8 @@ void BandpassExporter::resetDspState() {
 }
 
 void BandpassExporter::close() {
-    if (!fileHandle_) return;
-    patchWavHeader();
-    std::fclose(fileHandle_);
-    fileHandle_ = nullptr;
+    if (!file_.isOpen()) return;
+    file_.close();   // end hook patches the header
     LOG_INFO("BandpassExporter: closed, wrote "
              + std::to_string(samplesWritten_) + " IQ pairs at "
              + std::to_string(static_cast<int>(outputSR_)) + " Hz");
@@ -113,10 +121,19 @@ void BandpassExporter::close() {
 // Main processing loop
 // ---------------------------------------------------------------------------
 void BandpassExporter::pushBlock(const float* iq, int count) {
-    if (!fileHandle_) return;
+    if (!file_.isOpen()) return;
     if (count < 1) return;
 
+    outBuf_.clear();
+    process(iq, count, outBuf_);
+
+    // ── One write per block ──────────────────────────────────────────────────
+    writeOutput(outBuf_.data(), outBuf_.size() / 2);
+}
+
+void BandpassExporter::process(const float* iq, int count, std::vector<float>& out) {
     const int numSamples = count;
+    out.reserve(out.size() + 2 * (static_cast<std::size_t>(std::max(numSamples, 0)) / decimation_ + 1));
 
     for (int i = 0; i < numSamples; ++i) {
         // ── 1. Normalised float32 → complex double ───────────────────────────
@@ -135,39 +152,48 @@ void BandpassExporter::pushBlock(const float* iq, int count) {
         if (decimationCounter_ < decimation_) continue;
         decimationCounter_ = 0;
 
-        // ── 5. Write I and Q as float32 ──────────────────────────────────────
-        writeFloat32(static_cast<float>(filtered.real()));
-        writeFloat32(static_cast<float>(filtered.imag()));
-        ++samplesWritten_;
+        // ── 5. Stage I and Q as float32 ──────────────────────────────────────
+        out.push_back(static_cast<float>(filtered.real()));
+        out.push_back(static_cast<float>(filtered.imag()));
     }
 }
 
+void BandpassExporter::writeOutput(const float* iq, std::size_t pairs) {
+    if (!file_.isOpen() || pairs == 0) return;
+    if (file_.write(iq, pairs * 2 * sizeof(float)))
+        samplesWritten_ += static_cast<int64_t>(pairs);
+}
+
+int BandpassExporter::firTaps() {
+    return kFirTaps;
+}
+
 // ---------------------------------------------------------------------------
 // WAV helpers
 // ---------------------------------------------------------------------------
 
-// Writes a 4-byte little-endian uint32 to file
-static void writeU32(FILE* f, uint32_t v) {
-    uint8_t b[4] = {
-        static_cast<uint8_t>(v & 0xFF),
-        static_cast<uint8_t>((v >> 8)  & 0xFF),
-        static_cast<uint8_t>((v >> 16) & 0xFF),
-        static_cast<uint8_t>((v >> 24) & 0xFF)
-    };
-    std::fwrite(b, 1, 4, f);
+// Little-endian field writers for the RIFF header
+static uint8_t* putU32(uint8_t* p, uint32_t v) {
+    p[0] = static_cast<uint8_t>(v & 0xFF);
+    p[1] = static_cast<uint8_t>((v >> 8)  & 0xFF);
+    p[2] = static_cast<uint8_t>((v >> 16) & 0xFF);
+    p[3] = static_cast<uint8_t>((v >> 24) & 0xFF);
+    return p + 4;
 }
 
-static void writeU16(FILE* f, uint16_t v) {
-    uint8_t b[2] = { static_cast<uint8_t>(v & 0xFF),
-                     static_cast<uint8_t>((v >> 8) & 0xFF) };
-    std::fwrite(b, 1, 2, f);
+static uint8_t* putU16(uint8_t* p, uint16_t v) {
+    p[0] = static_cast<uint8_t>(v & 0xFF);
+    p[1] = static_cast<uint8_t>((v >> 8) & 0xFF);
+    return p + 2;
 }
 
-void BandpassExporter::writeFloat32(float value) {
-    std::fwrite(&value, sizeof(float), 1, fileHandle_);
+static uint8_t* putTag(uint8_t* p, const char* tag) {
+    std::memcpy(p, tag, 4);
+    return p + 4;
 }
 
-void BandpassExporter::writeWavHeader(int64_t numSamples) {
+std::array<uint8_t, BandpassExporter::kWavHeaderBytes>
+BandpassExporter::makeWavHeader(int64_t numSamples) const {
     // RIFF WAV, IEEE float32, 2 channels (I=left, Q=right)
     const uint32_t sampleRate   = static_cast<uint32_t>(outputSR_);
     const uint16_t numChannels  = 2;
@@ -177,29 +203,25 @@ void BandpassExporter::writeWavHeader(int64_t numSamples) {
     const uint32_t dataBytes    = static_cast<uint32_t>(numSamples * numChannels * sizeof(float));
     const uint32_t chunkSize    = 36 + dataBytes;   // RIFF chunk size
 
-    std::fwrite("RIFF", 1, 4, fileHandle_);
-    writeU32(fileHandle_, chunkSize);
-    std::fwrite("WAVE", 1, 4, fileHandle_);
+    std::array<uint8_t, kWavHeaderBytes> h{};
+    uint8_t* p = h.data();
+    p = putTag(p, "RIFF");
+    p = putU32(p, chunkSize);
+    p = putTag(p, "WAVE");
 
     // fmt sub-chunk
-    std::fwrite("fmt ", 1, 4, fileHandle_);
-    writeU32(fileHandle_, 18);          // sub-chunk size (18 = PCM + extra size field)
-    writeU16(fileHandle_, 3);           // audio format: 3 = IEEE float
-    writeU16(fileHandle_, numChannels);
-    writeU32(fileHandle_, sampleRate);
-    writeU32(fileHandle_, byteRate);
-    writeU16(fileHandle_, blockAlign);
-    writeU16(fileHandle_, bitsPerSmp);
-    writeU16(fileHandle_, 0);           // extra params size = 0
+    p = putTag(p, "fmt ");
+    p = putU32(p, 18);          // sub-chunk size (18 = PCM + extra size field)
+    p = putU16(p, 3);           // audio format: 3 = IEEE float
+    p = putU16(p, numChannels);
+    p = putU32(p, sampleRate);
+    p = putU32(p, byteRate);
+    p = putU16(p, blockAlign);
+    p = putU16(p, bitsPerSmp);
+    p = putU16(p, 0);           // extra params size = 0
 
     // data sub-chunk
-    std::fwrite("data", 1, 4, fileHandle_);
-    writeU32(fileHandle_, dataBytes);
-}
-
-void BandpassExporter::patchWavHeader() {
-    if (!fileHandle_) return;
-    std::rewind(fileHandle_);
-    writeWavHeader(samplesWritten_);
-    std::fflush(fileHandle_);
+    p = putTag(p, "data");
+    putU32(p, dataBytes);
+    return h;
 }
@@ -1,9 +1,12 @@
 #pragma once
 
+#include "../Core/SegmentedFileWriter.h"
 #include "DspUtils.h"
 
 #include <QString>
+#include <array>
 #include <complex>
+#include <cstdint>
 #include <vector>
 
 // ---------------------------------------------------------------------------
@@ -30,6 +33,9 @@
 //   exp.close();   // flushes WAV header with final sample count
 //
 // Thread safety: call all methods from the SAME thread (RxWorker thread).
+// Each block's output is staged and handed to AsyncFileWriter in one write();
+// the disk I/O itself runs on the writer's I/O thread. With a segment policy
+// every segment is a complete WAV, finalised at rotation.
 // ---------------------------------------------------------------------------
 class BandpassExporter {
 public:
@@ -46,12 +52,26 @@ public:
                               double outputSampleRateHz = 250'000.0);
 
     // Open/close the WAV file.  open() may be called only once before close().
-    bool open(const QString& path);
+    bool open(const QString& path, const SegmentedFileWriter::Policy& segments = {});
     void close();
 
     // Feed one raw I/Q block.  Does nothing if not open.
     void pushBlock(const float* iq, int count);
 
+    // DSP only: appends the decimated I/Q pairs of one block to out.
+    // pushBlock() is process() + writeOutput().
+    void process(const float* iq, int count, std::vector<float>& out);
+    // Appends already band-passed pairs (interleaved) to the open file.
+    void writeOutput(const float* iq, std::size_t pairs);
+
+    // Offline chunking (OfflineProcessor). The NCO phase is the only state
+    // that needs the whole history; the FIR refills from firTaps() samples.
+    [[nodiscard]] const dsp::Nco& nco() const { return nco_; }
+    void setNco(const dsp::Nco& nco) { nco_ = nco; }
+    [[nodiscard]] int decimation() const { return decimation_; }
+    [[nodiscard]] double outputSampleRate() const { return outputSR_; }
+    [[nodiscard]] static int firTaps();
+
     // Reset DSP state that spans block boundaries: NCO phase, FIR delay line,
     // decimation counter.  Called on LO retune — samples after the retune are
     // spectrally discontinuous, stale delay-line taps would leak artifacts.
@@ -60,7 +80,7 @@ public:
     void resetDspState();
 
     // True between open() and close().
-    [[nodiscard]] bool isOpen() const { return fileHandle_ != nullptr; }
+    [[nodiscard]] bool isOpen() const { return file_.isOpen(); }
 
     // Diagnostics
     [[nodiscard]] int64_t samplesWritten() const { return samplesWritten_; }
@@ -86,13 +106,15 @@ private:
     int decimationCounter_{0};
 
     // ── WAV output ───────────────────────────────────────────────────────────
-    FILE*   fileHandle_{nullptr};
+    SegmentedFileWriter file_;
+    std::vector<float> outBuf_;           // one block of decimated I/Q
     int64_t samplesWritten_{0};   // number of (I,Q) pairs written
 
     // ── Helpers ──────────────────────────────────────────────────────────────
     std::complex<double>       filterSample(std::complex<double> x);
 
-    void writeWavHeader(int64_t numSamples);   // written at open() and patched at close()
-    void writeFloat32(float value);
-    void patchWavHeader();                     // rewinds and re-writes header with final count
+    static constexpr std::size_t kWavHeaderBytes = 46;
+    // Written when a segment opens and patched (AsyncFileWriter::patchOnClose)
+    // when it closes.
+    [[nodiscard]] std::array<uint8_t, kWavHeaderBytes> makeWavHeader(int64_t numSamples) const;
 };
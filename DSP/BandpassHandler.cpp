@@ -15,7 +15,7 @@ void BandpassHandler::onStreamStarted(double sampleRateHz) {
     try {
         exp_ = std::make_unique<BandpassExporter>(
             sampleRateHz, stationOffsetHz_, bandwidthHz_, outputSrHz_);
-        if (!exp_->open(path_)) {
+        if (!exp_->open(path_, segmentPolicy_)) {
             LOG_ERROR("BandpassHandler: cannot open WAV: " + path_.toStdString());
             exp_.reset();
         } else {
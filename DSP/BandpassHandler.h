@@ -19,11 +19,15 @@ public:
     void onStreamStopped() override;
     void onRetune(double newFreqHz) override;
 
+    // Call before onStreamStarted().
+    void setSegmentPolicy(const SegmentedFileWriter::Policy& policy) { segmentPolicy_ = policy; }
+
 private:
     QString path_;
     double  stationOffsetHz_;
     double  bandwidthHz_;
     double  outputSrHz_;
+    SegmentedFileWriter::Policy segmentPolicy_;
 
     std::unique_ptr<BandpassExporter> exp_;
 };
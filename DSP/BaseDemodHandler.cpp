@@ -22,6 +22,28 @@ void BaseDemodHandler::setOffset(double hz) {
     pendingOffset_.store(hz);
 }
 
+std::unique_ptr<BaseDemodulator> BaseDemodHandler::makeDemodulator(double sampleRateHz) {
+    std::map<QString, double> paramsCopy;
+    {
+        std::lock_guard lock(paramMutex_);
+        paramsCopy = params_;
+    }
+    const double pendingOff = pendingOffset_.load();
+    auto dem = createDemodulator(sampleRateHz,
+                                 pendingOff < 1e37 ? pendingOff : stationOffsetHz_, paramsCopy);
+    dem->setSquelch(squelchDb_.load());
+    return dem;
+}
+
+void BaseDemodHandler::publishMetrics(const Metrics::Labels& labels) {
+    auto& reg = Metrics::Registry::instance();
+    reg.add("stand_demod_if_rms", "IF RMS after the channel filter.", labels, ifRms_);
+    reg.add("stand_demod_channel_power_dbfs", "Channel power seen by the squelch.",
+            labels, powerMetric_);
+    reg.add("stand_demod_squelch_open", "1 while the squelch is open.", labels, squelchMetric_);
+    reg.add("stand_demod_audio_samples_total", "Audio samples emitted.", labels, audioMetric_);
+}
+
 void BaseDemodHandler::onStreamStarted(double sampleRateHz) {
     std::map<QString, double> paramsCopy;
     {
@@ -29,6 +51,7 @@ void BaseDemodHandler::onStreamStarted(double sampleRateHz) {
         paramsCopy = params_;
         pendingParams_.clear();
     }
+    appliedSquelchDb_ = 1e38;
     try {
         dem_ = createDemodulator(sampleRateHz, stationOffsetHz_, paramsCopy);
         LOG_CAT(LogCat::kDemodInit, LogLevel::Info,
@@ -42,6 +65,7 @@ void BaseDemodHandler::onStreamStarted(double sampleRateHz) {
 
 void BaseDemodHandler::onStreamStopped() {
     dem_.reset();
+    ifRms_->set(0.0);
 }
 
 void BaseDemodHandler::processBlock(const float* iq, int count, double sampleRateHz) {
@@ -65,7 +89,24 @@ void BaseDemodHandler::processBlock(const float* iq, int count, double sampleRat
     if (pendingOff < 1e37)
         dem_->setOffset(pendingOff);
 
+    // Apply squelch threshold change
+    const double sq = squelchDb_.load();
+    if (sq != appliedSquelchDb_) {
+        dem_->setSquelch(sq);
+        appliedSquelchDb_ = sq;
+    }
+
     const QVector<float> audio = dem_->pushBlock(iq, count);
-    if (!audio.isEmpty())
+
+    squelchOpen_.store(dem_->squelchOpen());
+    channelPowerDb_.store(dem_->channelPowerDb());
+    cpuSaved_.store(dem_->cpuSavedFraction());
+    ifRms_->set(dem_->ifRms());
+    powerMetric_->set(dem_->channelPowerDb());
+    squelchMetric_->set(dem_->squelchOpen() ? 1.0 : 0.0);
+
+    if (!audio.isEmpty()) {
+        audioMetric_->inc(static_cast<uint64_t>(audio.size()));
         emit audioReady(audio, dem_->audioSampleRate());
+    }
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../Core/IPipelineHandler.h"
+#include "../Core/Metrics.h"
 #include "BaseDemodulator.h"
 #include "DemodTypes.h"
 
@@ -16,7 +17,7 @@
 // BaseDemodHandler — common IPipelineHandler wrapper for all demodulators.
 //
 // Manages:  generic named parameters (thread-safe), lazy-init,
-//           audioReady signal, ifRms proxy.
+//           audioReady signal, ifRms proxy, squelch threshold + status.
 //
 // Subclasses implement:
 //   paramDescriptors()  — UI metadata (spin/combo definitions)
@@ -42,7 +43,24 @@ public:
     // NCO offset — universal, not a "parameter".
     void setOffset(double hz);
 
-    [[nodiscard]] double ifRms() const { return dem_ ? dem_->ifRms() : 0.0; }
+    [[nodiscard]] double ifRms() const { return ifRms_->value(); }
+
+    // Squelch threshold in dBFS; BaseDemodulator::kSquelchOff disables.
+    // While closed no audioReady is emitted (so audio recording pauses too).
+    void setSquelch(double thresholdDb) { squelchDb_.store(thresholdDb); }
+    [[nodiscard]] double squelch()          const { return squelchDb_.load(); }
+    [[nodiscard]] bool   squelchOpen()      const { return squelchOpen_.load(); }
+    [[nodiscard]] double channelPowerDb()   const { return channelPowerDb_.load(); }
+    [[nodiscard]] double cpuSavedFraction() const { return cpuSaved_.load(); }
+
+    // A fresh demodulator with the current params, offset and squelch, for
+    // use outside the pipeline (OfflineProcessor). Throws like
+    // createDemodulator().
+    [[nodiscard]] std::unique_ptr<BaseDemodulator> makeDemodulator(double sampleRateHz);
+
+    // Exports IF RMS, channel power, squelch state and audio output as
+    // stand_demod_* series with these labels (device, panel, mode…).
+    void publishMetrics(const Metrics::Labels& labels);
 
     // IPipelineHandler
     void processBlock(const float* iq, int count, double sampleRateHz) override;
@@ -75,4 +93,17 @@ private:
     std::map<QString, double> params_;
     std::vector<std::pair<QString, double>> pendingParams_;
     std::atomic<double> pendingOffset_{1e38};  // 1e38 = sentinel "no update"
+
+    // Squelch: threshold written by UI, applied on the worker thread when it
+    // differs from what the demodulator has (1e38 = not applied yet).
+    std::atomic<double> squelchDb_{BaseDemodulator::kSquelchOff};
+    double              appliedSquelchDb_{1e38};
+    std::atomic<bool>   squelchOpen_{true};
+    std::atomic<double> channelPowerDb_{-200.0};
+    std::atomic<double> cpuSaved_{0.0};
+
+    std::shared_ptr<Metrics::Gauge>   ifRms_         = std::make_shared<Metrics::Gauge>();
+    std::shared_ptr<Metrics::Gauge>   powerMetric_   = std::make_shared<Metrics::Gauge>();
+    std::shared_ptr<Metrics::Gauge>   squelchMetric_ = std::make_shared<Metrics::Gauge>();
+    std::shared_ptr<Metrics::Counter> audioMetric_   = std::make_shared<Metrics::Counter>();
 };
@@ -2,6 +2,7 @@
 #include "Logger.h"
 
 #include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <stdexcept>
 #include <string>
@@ -41,6 +42,11 @@ BaseDemodulator::BaseDemodulator(double inputSR, double stationOffsetHz,
 
     // ── NCO ──────────────────────────────────────────────────────────────────
     nco_.setFrequency(stationOffset_, inputSR_);
+
+    // ── Squelch meter ────────────────────────────────────────────────────────
+    meterAlpha_ = 1.0 - std::exp(-kMeterStride / (kMeterTauSec * ifSR_));
+    gate_.hysteresisDb = kSquelchHystDb;
+    gate_.hangSamples  = static_cast<long long>(kSquelchHangSec * ifSR_);
 }
 
 // ---------------------------------------------------------------------------
@@ -78,11 +84,101 @@ void BaseDemodulator::setOffset(double offsetHz) {
 
     resetDemodState();
 
+    // Channel power belongs to the old frequency — start the meter over.
+    meterPower_   = 0.0;
+    meterCounter_ = 0;
+    gate_.reset();
+    gateOpen_ = !squelchEnabled_;
+
     LOG_CAT(LogCat::kDemodInit, LogLevel::Info,
             std::string(demodName()) + ": offset set to "
             + std::to_string(static_cast<int>(offsetHz)) + " Hz");
 }
 
+// ---------------------------------------------------------------------------
+// Squelch
+// ---------------------------------------------------------------------------
+void BaseDemodulator::setSquelch(double thresholdDb) {
+    const bool enable = thresholdDb > kSquelchOff;
+    gate_.openDb = thresholdDb;
+
+    if (!enable) {
+        if (!gateOpen_) reopenGate();
+        gateOpen_ = true;
+    } else if (!squelchEnabled_) {
+        // Decide from the current meter reading right away — no hang time
+        // for a channel that is already idle when squelch is switched on.
+        gate_.open       = channelPowerDb() >= thresholdDb;
+        gate_.belowCount = 0;
+        gateOpen_        = gate_.open;
+    }
+    squelchEnabled_ = enable;
+    if (!enable) cpuSaved_ = 0.0;
+}
+
+double BaseDemodulator::channelPowerDb() const {
+    return 10.0 * std::log10(std::max(meterPower_, 1e-20));
+}
+
+// FIR2 and the subclass demod state hold stale history from before the gate
+// closed — flush them so the first audio after reopen has no transient.
+void BaseDemodulator::reopenGate() {
+    std::fill(fir2Delay_.begin(), fir2Delay_.end(), 0.0);
+    fir2Head_    = 0;
+    dec2Counter_ = 0;
+    resetDemodState();
+}
+
+// ---------------------------------------------------------------------------
+// Offline chunking
+// ---------------------------------------------------------------------------
+void BaseDemodulator::InputState::advance(const float* iq, int count) {
+    for (int i = 0; i < count; ++i) {
+        dc.process({static_cast<double>(iq[2 * i]), static_cast<double>(iq[2 * i + 1])});
+        nco.advance();
+    }
+}
+
+int64_t BaseDemodulator::warmupSamples() const {
+    // +1 IF sample: discriminator-style demods keep the previous IF sample.
+    const auto ifSamples = static_cast<int64_t>(std::ceil(fir2Taps_ + settlingIfSamples())) + 1;
+    const int64_t n = fir1Taps_ + ifSamples * D1_;
+    const int64_t a = chunkAlignment();
+    return (n + a - 1) / a * a;
+}
+
+bool BaseDemodulator::sameState(const BaseDemodulator& o) const {
+    using dsp::sameBits;
+    if (fir1Taps_ != o.fir1Taps_ || fir2Taps_ != o.fir2Taps_ || D1_ != o.D1_) return false;
+    if (!sameBits(dc_.prevIn, o.dc_.prevIn) || !sameBits(dc_.prevOut, o.dc_.prevOut)
+        || !sameBits(nco_.phase, o.nco_.phase))
+        return false;
+    if (dec1Counter_ != o.dec1Counter_ || dec2Counter_ != o.dec2Counter_
+        || meterCounter_ != o.meterCounter_)
+        return false;
+
+    // Circular delay lines compare in time order, not storage order.
+    for (int i = 0; i < fir1Taps_; ++i) {
+        if (!sameBits(fir1Delay_[(fir1Head_ + i) % fir1Taps_],
+                      o.fir1Delay_[(o.fir1Head_ + i) % fir1Taps_]))
+            return false;
+    }
+    for (int i = 0; i < fir2Taps_; ++i) {
+        if (!sameBits(fir2Delay_[(fir2Head_ + i) % fir2Taps_],
+                      o.fir2Delay_[(o.fir2Head_ + i) % fir2Taps_]))
+            return false;
+    }
+
+    // The meter only shapes output through the gate.
+    if (squelchEnabled_ || o.squelchEnabled_) {
+        if (squelchEnabled_ != o.squelchEnabled_ || gateOpen_ != o.gateOpen_
+            || gate_.open != o.gate_.open || gate_.belowCount != o.gate_.belowCount
+            || !sameBits(meterPower_, o.meterPower_))
+            return false;
+    }
+    return sameDemodState(o);
+}
+
 // ---------------------------------------------------------------------------
 // FIR1
 // ---------------------------------------------------------------------------
@@ -125,10 +221,14 @@ QVector<float> BaseDemodulator::pushBlock(const float* iq, int count) {
         return {};
 
     const int numSamples = count;
+    const auto t0 = std::chrono::steady_clock::now();
 
     QVector<float> audio;
     audio.reserve(numSamples / (D1_ * D2_) + 4);
 
+    int ifSamples = 0;
+    int ifGated   = 0;
+
     for (int i = 0; i < numSamples; ++i) {
 
         // ── 1. Normalised float32 → complex double ────────────────────────────
@@ -148,6 +248,12 @@ QVector<float> BaseDemodulator::pushBlock(const float* iq, int count) {
         // ── 5. Stage-1 decimation ────────────────────────────────────────────
         if (++dec1Counter_ < D1_) continue;
         dec1Counter_ = 0;
+        ++ifSamples;
+
+        // ── 5a. Squelch: idle channel computes meter points only ─────────────
+        const bool meterTick = (++meterCounter_ >= kMeterStride);
+        if (meterTick) meterCounter_ = 0;
+        if (!gateOpen_ && !meterTick) { ++ifGated; continue; }
 
         const auto filtered1 = fir1Compute();
 
@@ -156,6 +262,16 @@ QVector<float> BaseDemodulator::pushBlock(const float* iq, int count) {
                              + filtered1.imag() * filtered1.imag();
         ifPowerAvg_ = (1.0 - kPowerAlpha) * ifPowerAvg_ + kPowerAlpha * ifPower;
 
+        if (meterTick) {
+            meterPower_ += meterAlpha_ * (ifPower - meterPower_);
+            if (squelchEnabled_) {
+                const bool wasOpen = gateOpen_;
+                gateOpen_ = gate_.update(channelPowerDb(), kMeterStride);
+                if (gateOpen_ && !wasOpen) reopenGate();
+            }
+        }
+        if (!gateOpen_) { ++ifGated; continue; }
+
         // ── 7. Subclass demodulation ─────────────────────────────────────────
         const double audioSample = demodulateIF(filtered1, ifPower);
 
@@ -177,5 +293,28 @@ QVector<float> BaseDemodulator::pushBlock(const float* iq, int count) {
         ifRmsOut_ = std::sqrt(ifPowerAvg_);
     }
 
+    // ── CPU accounting ───────────────────────────────────────────────────────
+    // Cost per IF sample is learned from fully-open blocks; saved fraction is
+    // 1 − (time actually spent) / (time the same samples would cost open).
+    if (squelchEnabled_ && ifSamples > 0) {
+        const double ns = std::chrono::duration<double, std::nano>(
+            std::chrono::steady_clock::now() - t0).count();
+        if (ifGated == 0) {
+            const double perIf = ns / ifSamples;
+            activeNsPerIf_ = (activeNsPerIf_ == 0.0)
+                           ? perIf : 0.9 * activeNsPerIf_ + 0.1 * perIf;
+        }
+        windowNs_ += ns;
+        windowIf_ += ifSamples;
+        if (windowIf_ >= static_cast<long long>(ifSR_)) {
+            if (activeNsPerIf_ > 0.0) {
+                const double full = activeNsPerIf_ * static_cast<double>(windowIf_);
+                cpuSaved_ = std::clamp(1.0 - windowNs_ / full, 0.0, 1.0);
+            }
+            windowNs_ = 0.0;
+            windowIf_ = 0;
+        }
+    }
+
     return audio;
 }
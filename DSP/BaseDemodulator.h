@@ -4,6 +4,8 @@
 
 #include <QVector>
 #include <complex>
+#include <cstdint>
+#include <memory>
 #include <vector>
 
 // ---------------------------------------------------------------------------
@@ -31,21 +33,70 @@ inline constexpr int kDefaultFir2Taps = 255;
 //   AM: envelope + DC removal
 //   SSB/NFM/CW: future
 //
+// Squelch (activity gate): a decimated power meter samples FIR1 output every
+// kMeterStride IF samples. While the gate is closed only those meter points
+// are computed — FIR1 dot products for the remaining IF samples, demodulateIF,
+// FIR2 and audio output are skipped, and pushBlock() returns no audio.
+// DC blocker and NCO keep running so state is continuous on reopen.
+//
+// Offline chunking (OfflineProcessor): a recording is split into chunks that
+// run on separate clones. InputState is the input-rate recursive state (DC
+// blocker, NCO phase) — cheap to advance sequentially, so every chunk starts
+// from the exact value. Everything after FIR1 is rebuilt from warmupSamples()
+// of overlap; sameState() then checks the result bit for bit.
+//
 // Thread safety: call all methods from the SAME thread (RxWorker thread).
 // ---------------------------------------------------------------------------
 class BaseDemodulator {
 public:
+    // Squelch threshold at or below this value disables gating.
+    static constexpr double kSquelchOff = -200.0;
+
     virtual ~BaseDemodulator() = default;
 
     [[nodiscard]] QVector<float> pushBlock(const float* iq, int count);
     void setOffset(double offsetHz);
 
+    // Squelch threshold in dBFS of channel (post-FIR1) power.
+    void setSquelch(double thresholdDb);
+
     [[nodiscard]] double audioSampleRate() const { return audioSR_; }
     [[nodiscard]] double ifSampleRate()    const { return ifSR_;    }
     [[nodiscard]] int    decimation1()     const { return D1_;      }
     [[nodiscard]] double bandwidth()       const { return bandwidth_; }
     [[nodiscard]] double ifRms()           const { return ifRmsOut_; }
 
+    [[nodiscard]] bool   squelchEnabled()  const { return squelchEnabled_; }
+    [[nodiscard]] bool   squelchOpen()     const { return gateOpen_; }
+    [[nodiscard]] double channelPowerDb()  const;
+    // Fraction of demod CPU saved by the gate over the last ~1 s window
+    // (0 = nothing saved, 1 = everything gated). Measured, not modelled:
+    // wall time per IF sample while open vs. actual time spent.
+    [[nodiscard]] double cpuSavedFraction() const { return cpuSaved_; }
+
+    // ── Offline chunking ─────────────────────────────────────────────────────
+    struct InputState {
+        dsp::DcBlocker dc;
+        dsp::Nco       nco;
+        // Same arithmetic as pushBlock() applies to dc_ / nco_.
+        void advance(const float* iq, int count);
+    };
+    [[nodiscard]] InputState inputState() const { return {dc_, nco_}; }
+    void setInputState(const InputState& s) { dc_ = s.dc; nco_ = s.nco; }
+
+    // Chunk boundaries must be multiples of chunkAlignment() input samples
+    // (decimation counters and the squelch meter are then in phase).
+    [[nodiscard]] int     chunkAlignment() const { return D1_ * D2_ * kMeterStride; }
+    // Input samples after which a fresh clone has forgotten its zero history:
+    // FIR1 + FIR2 delay lines and the subclass's IIR settling, aligned.
+    [[nodiscard]] int64_t warmupSamples() const;
+
+    // True when every state that shapes future output is bitwise equal
+    // (diagnostics and CPU accounting excluded).
+    [[nodiscard]] bool sameState(const BaseDemodulator& other) const;
+
+    [[nodiscard]] virtual std::unique_ptr<BaseDemodulator> clone() const = 0;
+
 protected:
     BaseDemodulator(double inputSR, double stationOffsetHz,
                     double fir1CutoffHz, double fir2CutoffHz,
@@ -65,6 +116,11 @@ protected:
     // Subclass name for log messages.
     virtual const char* demodName() const = 0;
 
+    // Offline chunking: IF samples until the subclass state no longer depends
+    // on its start value, and a bitwise comparison of that state.
+    [[nodiscard]] virtual double settlingIfSamples() const { return 0.0; }
+    [[nodiscard]] virtual bool   sameDemodState(const BaseDemodulator& /*other*/) const { return true; }
+
     // Subclass tools — redesign filters on the fly.
     void redesignFir1(double cutoffHz);
     void redesignFir2(double cutoffHz);
@@ -95,6 +151,27 @@ private:
     int diagBlockCount_{0};
     static constexpr int kDiagInterval = 4096;
 
+    // ── Squelch / activity gate ──────────────────────────────────────────────
+    static constexpr int    kMeterStride     = 8;      // IF samples per meter point
+    static constexpr double kMeterTauSec     = 2e-3;
+    static constexpr double kSquelchHystDb   = 3.0;
+    static constexpr double kSquelchHangSec  = 0.3;
+
+    dsp::ActivityGate gate_;
+    bool   squelchEnabled_{false};
+    bool   gateOpen_{true};
+    int    meterCounter_{0};
+    double meterAlpha_{1.0};
+    double meterPower_{0.0};
+
+    // CPU accounting (per window of ~1 s of IF samples)
+    double   activeNsPerIf_{0.0};   // EMA, from blocks processed fully open
+    double   windowNs_{0.0};
+    long long windowIf_{0};
+    double   cpuSaved_{0.0};
+
+    void reopenGate();
+
     // ── Stage-1 FIR (complex) ────────────────────────────────────────────────
     std::vector<double>               fir1Coeffs_;
     std::vector<std::complex<double>> fir1Delay_;
@@ -0,0 +1,116 @@
+#include "ChannelEnergyBank.h"
+#include "DspUtils.h"
+
+#include <algorithm>
+#include <cmath>
+
+// ---------------------------------------------------------------------------
+// configure
+// ---------------------------------------------------------------------------
+void ChannelEnergyBank::configure(const std::vector<double>& offsetsHz,
+                                  double sampleRateHz, double resolutionHz)
+{
+    const int n = static_cast<int>(offsetsHz.size());
+    segLen_ = (sampleRateHz > 0.0 && resolutionHz > 0.0)
+            ? std::max(16, static_cast<int>(std::lround(sampleRateHz / resolutionHz)))
+            : 0;
+
+    coeff_.assign(n, 0.0);
+    cosW_.assign(n, 1.0);
+    sinW_.assign(n, 0.0);
+    for (int k = 0; k < n; ++k) {
+        const double w = 2.0 * dsp::kPi * offsetsHz[k] / sampleRateHz;
+        cosW_[k]  = std::cos(w);
+        sinW_[k]  = std::sin(w);
+        coeff_[k] = 2.0 * cosW_[k];
+    }
+    s1Re_.assign(n, 0.0); s1Im_.assign(n, 0.0);
+    s2Re_.assign(n, 0.0); s2Im_.assign(n, 0.0);
+    accPower_.assign(n, 0.0);
+    powerDb_.assign(n, -200.0);
+
+    // Hann window; tone-normalisation uses Σw (coherent gain).
+    window_.resize(segLen_);
+    windowSum_ = 0.0;
+    for (int i = 0; i < segLen_; ++i) {
+        window_[i] = 0.5 - 0.5 * std::cos(2.0 * dsp::kPi * i / segLen_);
+        windowSum_ += window_[i];
+    }
+    if (windowSum_ <= 0.0) windowSum_ = 1.0;
+    segRe_.resize(segLen_);
+    segIm_.resize(segLen_);
+
+    const long long perSegment = static_cast<long long>(std::max(1, n)) * std::max(1, segLen_);
+    segments_ = static_cast<int>(std::max<long long>(1, kUpdateBudget / perSegment));
+}
+
+// ---------------------------------------------------------------------------
+// process
+// ---------------------------------------------------------------------------
+bool ChannelEnergyBank::process(const float* iq, int count) {
+    const int n = channelCount();
+    if (n == 0 || segLen_ == 0 || count < segLen_)
+        return false;
+
+    const int available = count / segLen_;
+    const int segs      = std::min(segments_, available);
+    // Spread measured segments evenly over the block.
+    const int stride    = (count - segLen_) / std::max(1, segs);
+
+    std::fill(accPower_.begin(), accPower_.end(), 0.0);
+    for (int s = 0; s < segs; ++s)
+        runSegment(iq + 2 * static_cast<long long>(s) * stride);
+
+    const double norm = 1.0 / (windowSum_ * windowSum_ * segs);
+    for (int k = 0; k < n; ++k)
+        powerDb_[k] = 10.0 * std::log10(std::max(accPower_[k] * norm, 1e-20));
+    return true;
+}
+
+void ChannelEnergyBank::runSegment(const float* iq) {
+    const int n = channelCount();
+    const int L = segLen_;
+
+    // ── Convert + remove DC (LO leakage) + window, once for all channels ─────
+    double meanRe = 0.0, meanIm = 0.0;
+    for (int i = 0; i < L; ++i) {
+        meanRe += iq[2 * i];
+        meanIm += iq[2 * i + 1];
+    }
+    meanRe /= L;
+    meanIm /= L;
+    for (int i = 0; i < L; ++i) {
+        segRe_[i] = (iq[2 * i]     - meanRe) * window_[i];
+        segIm_[i] = (iq[2 * i + 1] - meanIm) * window_[i];
+    }
+
+    std::fill(s1Re_.begin(), s1Re_.end(), 0.0);
+    std::fill(s1Im_.begin(), s1Im_.end(), 0.0);
+    std::fill(s2Re_.begin(), s2Re_.end(), 0.0);
+    std::fill(s2Im_.begin(), s2Im_.end(), 0.0);
+
+    double* __restrict s1r = s1Re_.data();
+    double* __restrict s1i = s1Im_.data();
+    double* __restrict s2r = s2Re_.data();
+    double* __restrict s2i = s2Im_.data();
+    const double* __restrict c = coeff_.data();
+
+    // ── Resonators: s[n] = x[n] + 2cos(ω)·s[n-1] − s[n-2] ────────────────────
+    for (int i = 0; i < L; ++i) {
+        const double xr = segRe_[i];
+        const double xi = segIm_[i];
+        for (int k = 0; k < n; ++k) {
+            const double r  = xr + c[k] * s1r[k] - s2r[k];
+            const double im = xi + c[k] * s1i[k] - s2i[k];
+            s2r[k] = s1r[k];  s2i[k] = s1i[k];
+            s1r[k] = r;       s1i[k] = im;
+        }
+    }
+
+    // ── y = s[L-1] − e^{-jω}·s[L-2];  |y| = |X(ω)| ───────────────────────────
+    for (int k = 0; k < n; ++k) {
+        const double yr = s1r[k] - (cosW_[k] * s2r[k] + sinW_[k] * s2i[k]);
+        const double yi = s1i[k] - (cosW_[k] * s2i[k] - sinW_[k] * s2r[k]);
+        accPower_[k] += yr * yr + yi * yi;
+    }
+}
@@ -1,8 +1,12 @@
 #include "ClassifierHandler.h"
+#include "DspUtils.h"
 
-#include <QSysInfo>
+#include <algorithm>
+#include <cmath>
 #include <cstring>
 
+using namespace ClassifierProtocol;
+
 ClassifierHandler::ClassifierHandler(QObject* parent)
     : QObject(parent)
 {}
@@ -11,6 +15,62 @@ void ClassifierHandler::setIntervalMs(int ms) {
     intervalMs_.store(ms);
 }
 
+void ClassifierHandler::setMode(Mode mode) {
+    mode_.store(mode);
+}
+
+void ClassifierHandler::setChannels(const QVector<ClassifierChannel>& channels) {
+    std::lock_guard lock(cfgMutex_);
+    channels_      = channels.mid(0, kMaxSnippets);
+    channelsDirty_ = true;
+}
+
+QVector<ClassifierChannel> ClassifierHandler::channels() const {
+    std::lock_guard lock(cfgMutex_);
+    return channels_;
+}
+
+void ClassifierHandler::setCenterFrequency(double hz) {
+    centerHz_.store(hz);
+}
+
+void ClassifierHandler::onRetune(double newFreqHz) {
+    centerHz_.store(newFreqHz);
+}
+
+void ClassifierHandler::setMaxInFlight(int frames) {
+    maxInFlight_.store(std::clamp(frames, 1, kRingSlots));
+}
+
+void ClassifierHandler::frameDone() {
+    int cur = inFlight_.load();
+    while (cur > 0 && !inFlight_.compare_exchange_weak(cur, cur - 1)) {}
+    inFlightGauge_->set(inFlight_.load());
+}
+
+void ClassifierHandler::resetInFlight() {
+    inFlight_.store(0);
+    inFlightGauge_->set(0.0);
+}
+
+bool ClassifierHandler::openSharedRing(const QString& name, QString* error) {
+    return ring_.create(name, kRingSlots, maxFrameBytes(), error);
+}
+
+std::size_t ClassifierHandler::maxFrameBytes() {
+    return kFrameHeader + std::max(snippetBytes(kWidebandSamples),
+                                   kMaxSnippets * snippetBytes(kSnippetSamples));
+}
+
+void ClassifierHandler::publishMetrics(const Metrics::Labels& labels) {
+    auto& reg = Metrics::Registry::instance();
+    reg.add("stand_classifier_frames_total", "Frames handed to the classifier.", labels, sent_);
+    reg.add("stand_classifier_dropped_frames_total",
+            "Frames dropped because the in-flight window or the ring was full.", labels, dropped_);
+    reg.add("stand_classifier_inflight_frames",
+            "Frames sent and not yet answered by the classifier.", labels, inFlightGauge_);
+}
+
 // ---------------------------------------------------------------------------
 // IPipelineHandler
 // ---------------------------------------------------------------------------
@@ -24,53 +84,183 @@ void ClassifierHandler::processBlock(const float* iq, int count,
     const auto now = Clock::now();
     const auto elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(
                                now - lastEmit_).count();
-    if (elapsedMs < intervalMs_.load()) return;
+    if (elapsedMs < intervalMs_.load() || count <= 0) return;
     lastEmit_ = now;
 
-    emit frameReady(serialize(iq, count, sampleRateHz, meta.timestamp));
+    const Mode mode = mode_.load();
+    if (mode != Mode::Local && inFlight_.load() >= maxInFlight_.load()) {   // classifier still busy
+        dropped_->inc();
+        return;
+    }
+
+    {
+        std::lock_guard lock(cfgMutex_);
+        if (channelsDirty_ || sampleRateHz != builtRate_) rebuild(sampleRateHz);
+    }
+
+    const uint32_t id = ++frameId_;
+    if (mode == Mode::Local) {
+        classifyLocal(id, iq, count, sampleRateHz, meta.timestamp);
+        sent_->inc();
+        return;
+    }
+
+    const Kind kind = mode == Mode::Features ? Kind::Features : Kind::Iq;
+    if (ring_.isOpen()) {
+        unsigned char* slot = ring_.beginWrite();
+        if (!slot) { dropped_->inc(); return; }
+        FrameWriter frame(slot, ring_.payloadBytes(), id, meta.timestamp, kind);
+        fillFrame(frame, mode, iq, count, sampleRateHz, meta.timestamp);
+        ring_.commit(frame.finish());
+    } else {
+        const std::size_t bytes = frameBytes(count, mode);
+        QByteArray buf(static_cast<qsizetype>(4 + bytes), Qt::Uninitialized);
+        auto* data = reinterpret_cast<unsigned char*>(buf.data());
+        FrameWriter frame(data + 4, bytes, id, meta.timestamp, kind);
+        fillFrame(frame, mode, iq, count, sampleRateHz, meta.timestamp);
+        const auto len = static_cast<uint32_t>(frame.finish());
+        std::memcpy(data, &len, sizeof len);   // x86 = LE
+        buf.truncate(static_cast<qsizetype>(4 + len));
+        emit frameReady(buf);
+    }
+    inFlightGauge_->set(++inFlight_);
+    sent_->inc();
 }
 
 // ---------------------------------------------------------------------------
-// Frame serialization — little-endian throughout
+// Snippet extraction
 // ---------------------------------------------------------------------------
-QByteArray ClassifierHandler::serialize(const float* iq, int count,
-                                        double sampleRateHz, uint64_t timestamp)
+void ClassifierHandler::rebuild(double sampleRateHz) {
+    extractors_.clear();
+    for (const ClassifierChannel& ch : channels_) {
+        Extractor ex;
+        ex.cfg = ch;
+        const double bw = std::clamp(ch.bandwidthHz, 1.0, sampleRateHz);
+        ex.decimation = std::max(1, static_cast<int>(sampleRateHz / (kOversample * bw)));
+        ex.outRate    = sampleRateHz / ex.decimation;
+        ex.taps = dsp::designLowpassFir(std::min(kTapsPerDecim * ex.decimation + 1, kMaxTaps),
+                                        std::min(0.5, 0.5 * bw / sampleRateHz));
+        extractors_.push_back(std::move(ex));
+    }
+    builtRate_     = sampleRateHz;
+    channelsDirty_ = false;
+}
+
+// Pairs a block of `count` yields for one extractor.
+static int snippetLength(int decimation, int taps, int count) {
+    if (count < taps) return 0;
+    return std::min(ClassifierHandler::kSnippetSamples, (count - taps) / decimation + 1);
+}
+
+std::size_t ClassifierHandler::frameBytes(int count, Mode mode) const {
+    if (mode == Mode::Features)
+        return kFrameHeader + std::max<std::size_t>(extractors_.size(), 1)
+                              * featureSnippetBytes(ModulationFeatures::kCount);
+    if (extractors_.empty())
+        return kFrameHeader + snippetBytes(std::min(count, kWidebandSamples));
+    std::size_t bytes = kFrameHeader;
+    for (const Extractor& ex : extractors_)
+        bytes += snippetBytes(snippetLength(ex.decimation, static_cast<int>(ex.taps.size()), count));
+    return bytes;
+}
+
+void ClassifierHandler::fillFrame(FrameWriter& frame, Mode mode, const float* iq, int count,
+                                  double sampleRateHz, uint64_t timestamp)
 {
-    const int32_t n          = static_cast<int32_t>(count);
-    // NOTE: frame protocol change — I/Q payload is now float32 (4B/sample)
-    // Python classifier must be updated to unpack with np.frombuffer(..., dtype=np.float32)
-    const uint32_t payloadLen = static_cast<uint32_t>(8 + 4 + 8 + n * 2 * sizeof(float));
-
-    QByteArray buf;
-    buf.reserve(static_cast<qsizetype>(4 + payloadLen));
-
-    auto appendU32 = [&](uint32_t v) {
-        char b[4];
-        b[0] = static_cast<char>(v & 0xFF);
-        b[1] = static_cast<char>((v >> 8) & 0xFF);
-        b[2] = static_cast<char>((v >> 16) & 0xFF);
-        b[3] = static_cast<char>((v >> 24) & 0xFF);
-        buf.append(b, 4);
-    };
-    auto appendU64 = [&](uint64_t v) {
-        char b[8];
-        for (int i = 0; i < 8; ++i)
-            b[i] = static_cast<char>((v >> (8 * i)) & 0xFF);
-        buf.append(b, 8);
-    };
-    auto appendI32 = [&](int32_t v) {
-        appendU32(static_cast<uint32_t>(v));
-    };
-    auto appendF64 = [&](double v) {
-        char b[8]; std::memcpy(b, &v, 8);  // native (x86 = LE)
-        buf.append(b, 8);
-    };
-
-    appendU32(payloadLen);
-    appendU64(timestamp);
-    appendI32(n);
-    appendF64(sampleRateHz);
-    buf.append(reinterpret_cast<const char*>(iq),
-               static_cast<qsizetype>(n * 2 * sizeof(float)));
-    return buf;
+    if (mode == Mode::Features) {
+        forEachFeatures(iq, count, sampleRateHz, timestamp,
+                        [&frame](const SnippetInfo& info, const ModulationFeatures::Vector& f) {
+                            frame.addFeatures(info, f.data(), ModulationFeatures::kCount);
+                        });
+        return;
+    }
+
+    const double centerHz = centerHz_.load();
+
+    if (extractors_.empty()) {
+        const int n = std::min(count, kWidebandSamples);
+        SnippetInfo info{0, centerHz, sampleRateHz, sampleRateHz, timestamp};
+        if (float* out = frame.addSnippet(info, n))
+            std::memcpy(out, iq, static_cast<std::size_t>(n) * 2 * sizeof(float));
+        return;
+    }
+
+    for (const Extractor& ex : extractors_) {
+        const int n = snippetLength(ex.decimation, static_cast<int>(ex.taps.size()), count);
+        if (n <= 0) continue;
+        SnippetInfo info{ex.cfg.id, centerHz + ex.cfg.offsetHz, ex.outRate,
+                         ex.cfg.bandwidthHz, timestamp};
+        if (float* out = frame.addSnippet(info, n))
+            extract(ex, iq, n, out);
+    }
+}
+
+template <typename Fn>
+void ClassifierHandler::forEachFeatures(const float* iq, int count, double sampleRateHz,
+                                        uint64_t timestamp, Fn&& fn)
+{
+    const double centerHz = centerHz_.load();
+    ModulationFeatures::Vector f;
+
+    if (extractors_.empty()) {
+        const int n = std::min(count, kWidebandSamples);
+        if (features_.compute(iq, n, sampleRateHz, f))
+            fn(SnippetInfo{0, centerHz, sampleRateHz, sampleRateHz, timestamp}, f);
+        return;
+    }
+
+    snippet_.resize(2 * static_cast<std::size_t>(kSnippetSamples));
+    for (const Extractor& ex : extractors_) {
+        const int n = snippetLength(ex.decimation, static_cast<int>(ex.taps.size()), count);
+        if (n < ModulationFeatures::kMinSamples) continue;
+        extract(ex, iq, n, snippet_.data());
+        if (features_.compute(snippet_.data(), n, ex.outRate, f))
+            fn(SnippetInfo{ex.cfg.id, centerHz + ex.cfg.offsetHz, ex.outRate,
+                           ex.cfg.bandwidthHz, timestamp}, f);
+    }
+}
+
+void ClassifierHandler::classifyLocal(uint32_t frameId, const float* iq, int count,
+                                      double sampleRateHz, uint64_t timestamp)
+{
+    QVector<Result> results;
+    forEachFeatures(iq, count, sampleRateHz, timestamp,
+                    [&](const SnippetInfo& info, const ModulationFeatures::Vector& f) {
+                        Result r;
+                        r.frameId   = frameId;
+                        r.channelId = info.channelId;
+                        r.timestamp = info.timestamp;
+                        r.type      = ModulationFeatures::classify(f, &r.confidence);
+                        results.push_back(r);
+                    });
+    if (results.isEmpty()) return;
+    results.back().flags |= kLastInFrame;
+    emit localResults(results);
+}
+
+// Shift to DC, FIR low-pass and keep every decimation-th output — only the
+// outputs the snippet needs are computed.
+void ClassifierHandler::extract(const Extractor& ex, const float* iq, int outCount, float* out) {
+    const int taps = static_cast<int>(ex.taps.size());
+    const int need = (outCount - 1) * ex.decimation + taps;
+
+    mixed_.resize(static_cast<std::size_t>(need));
+    const std::complex<double> step =
+        std::polar(1.0, -2.0 * dsp::kPi * ex.cfg.offsetHz / (builtRate_ > 0.0 ? builtRate_ : 1.0));
+    std::complex<double> osc{1.0, 0.0};
+    for (int n = 0; n < need; ++n) {
+        mixed_[n] = std::complex<double>(iq[2 * n], iq[2 * n + 1]) * osc;
+        osc *= step;
+    }
+
+    for (int k = 0; k < outCount; ++k) {
+        const std::complex<double>* x = mixed_.data() + static_cast<std::ptrdiff_t>(k) * ex.decimation;
+        double re = 0.0, im = 0.0;
+        for (int t = 0; t < taps; ++t) {
+            re += ex.taps[t] * x[t].real();
+            im += ex.taps[t] * x[t].imag();
+        }
+        out[2 * k]     = static_cast<float>(re);
+        out[2 * k + 1] = static_cast<float>(im);
+    }
 }
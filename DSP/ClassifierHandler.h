@@ -1,52 +1,171 @@
 #pragma once
 
+#include "../Core/ClassifierProtocol.h"
 #include "../Core/IPipelineHandler.h"
+#include "../Core/Metrics.h"
+#include "../Core/ShmIqRing.h"
+#include "ModulationFeatures.h"
 
 #include <QByteArray>
 #include <QObject>
+#include <QVector>
 #include <atomic>
 #include <chrono>
+#include <complex>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 // ---------------------------------------------------------------------------
-// ClassifierHandler — IPipelineHandler that serializes every ~100 ms I/Q block
-// into a binary frame and emits frameReady() for ClassifierController to send
-// to the Python classifier service.
+// ClassifierChannel — one signal the classifier should look at, relative to
+// the LO. id comes back in the result records.
+// ---------------------------------------------------------------------------
+struct ClassifierChannel {
+    uint32_t id{0};
+    double   offsetHz{0.0};
+    double   bandwidthHz{25'000.0};
+};
+
+// ---------------------------------------------------------------------------
+// ClassifierHandler — IPipelineHandler that hands one ClassifierProtocol
+// frame per interval (default 100 ms) to the Python classifier service.
+//
+// With channels set, every channel becomes a narrowband snippet: the block is
+// shifted to the channel (NCO), low-pass filtered to bandwidthHz / 2 and
+// decimated to about kOversample × bandwidthHz, up to kSnippetSamples pairs.
+// All snippets of a block travel in one frame and are classified as one
+// batch. Without channels the frame carries the wideband block (channel 0,
+// up to kWidebandSamples pairs) as before.
+//
+// Mode::Features reduces every snippet to ModulationFeatures on the calling
+// thread and sends those instead (Kind::Features, ~100 bytes per channel).
+// Mode::Local goes one step further: ModulationFeatures::classify() decides
+// in process and the results are emitted as localResults() — no service, no
+// ring and no in-flight window.
 //
-// Threading: processBlock() is called on the RxWorker thread.
-//            frameReady() must be connected via Qt::QueuedConnection so the
-//            ClassifierController can forward data to the QTcpSocket on the
-//            main thread safely.
+// At most maxInFlight() frames are outstanding: a frame counts until the
+// controller reports its last result (frameDone()). Blocks that arrive while
+// the window is full — or while every ring slot is still held — are dropped
+// and counted, so inference overlaps capture without queues building up.
 //
-// Frame layout (little-endian):
-//   [4B uint32  payload length (everything after these 4 bytes)]
-//   [8B uint64  hardware timestamp]
-//   [4B int32   sample count N]
-//   [8B float64 sample rate Hz]
-//   [N*2*4B float32 I/Q pairs, interleaved: I0,Q0,I1,Q1,...]
+// With openSharedRing() the frame is built directly in a ShmIqRing slot on
+// the calling thread. Without a ring it is built in a QByteArray behind a
+// u32 length prefix and emitted as frameReady() for ClassifierController to
+// send over TCP.
+//
+// Threading: processBlock() is called on the RxWorker thread. Setters,
+//            frameDone() and the counters are thread-safe. frameReady() must
+//            be connected via Qt::QueuedConnection. openSharedRing() before
+//            the handler is added to a pipeline.
 // ---------------------------------------------------------------------------
 class ClassifierHandler : public QObject, public IPipelineHandler {
     Q_OBJECT
 
 public:
+    enum class Mode { Iq, Features, Local };
+
     explicit ClassifierHandler(QObject* parent = nullptr);
 
     // IPipelineHandler
     void processBlock(const float* iq, int count, double sampleRateHz) override;
     void processBlock(const float* iq, int count, double sampleRateHz,
                       const BlockMeta& meta) override;
+    void onRetune(double newFreqHz) override;
 
     // Minimum milliseconds between frames sent to classifier (rate limit).
     void setIntervalMs(int ms);   // default 100 ms; thread-safe
 
+    void setMode(Mode mode);      // default Iq; thread-safe
+    [[nodiscard]] Mode mode() const { return mode_.load(); }
+
+    // Applied on the next frame; entries past kMaxSnippets are ignored.
+    void setChannels(const QVector<ClassifierChannel>& channels);
+    [[nodiscard]] QVector<ClassifierChannel> channels() const;
+    // LO frequency, reported as snippet centre = LO + offset. Also onRetune().
+    void setCenterFrequency(double hz);
+
+    // In-flight window: 1 .. kRingSlots frames.
+    void setMaxInFlight(int frames);
+    [[nodiscard]] int maxInFlight() const { return maxInFlight_.load(); }
+    [[nodiscard]] int inFlight()    const { return inFlight_.load(); }
+    // The last result of a frame arrived (any thread).
+    void frameDone();
+    // Forget outstanding frames — a new connection will not answer them.
+    void resetInFlight();
+
+    // Shared-memory transport (see ShmIqRing); false leaves the TCP path on.
+    bool openSharedRing(const QString& name, QString* error = nullptr);
+    [[nodiscard]] bool    hasSharedRing()  const { return ring_.isOpen(); }
+    [[nodiscard]] QString sharedRingName() const { return ring_.name(); }
+
+    [[nodiscard]] uint64_t sentFrames()    const { return sent_->value(); }
+    [[nodiscard]] uint64_t droppedFrames() const { return dropped_->value(); }
+
+    // Registers stand_classifier_{frames,dropped_frames}_total and
+    // stand_classifier_inflight_frames.
+    void publishMetrics(const Metrics::Labels& labels);
+
+    static constexpr int    kRingSlots       = 4;
+    static constexpr int    kMaxSnippets     = 64;
+    static constexpr int    kSnippetSamples  = 1024;
+    static constexpr int    kWidebandSamples = 16384;   // RxWorker::kBlockSize
+    static constexpr double kOversample      = 2.5;     // snippet rate / bandwidth
+    static constexpr int    kTapsPerDecim    = 12;
+    static constexpr int    kMaxTaps         = 1025;
+
+    // Largest frame processBlock() can build (= ring slot payload).
+    [[nodiscard]] static std::size_t maxFrameBytes();
+
 signals:
+    // TCP fallback: u32 length + ClassifierProtocol frame.
     // Emitted on RxWorker thread — connect via Qt::QueuedConnection.
     void frameReady(QByteArray frame);
+    // Mode::Local: one result per snippet, the last flagged kLastInFrame.
+    // Emitted on RxWorker thread — connect via Qt::QueuedConnection.
+    void localResults(QVector<ClassifierProtocol::Result> results);
 
 private:
-    static QByteArray serialize(const float* iq, int count,
-                                double sampleRateHz, uint64_t timestamp);
+    struct Extractor {
+        ClassifierChannel   cfg;
+        int                 decimation{1};
+        double              outRate{0.0};
+        std::vector<double> taps;
+    };
+
+    void rebuild(double sampleRateHz);
+    std::size_t frameBytes(int count, Mode mode) const;
+    void fillFrame(ClassifierProtocol::FrameWriter& frame, Mode mode, const float* iq, int count,
+                   double sampleRateHz, uint64_t timestamp);
+    void classifyLocal(uint32_t frameId, const float* iq, int count,
+                       double sampleRateHz, uint64_t timestamp);
+    // fn(info, features) for every snippet with enough samples.
+    template <typename Fn>
+    void forEachFeatures(const float* iq, int count, double sampleRateHz, uint64_t timestamp, Fn&& fn);
+    void extract(const Extractor& ex, const float* iq, int outCount, float* out);
+
+    std::atomic<int>    intervalMs_{100};
+    std::atomic<Mode>   mode_{Mode::Iq};
+    std::atomic<int>    maxInFlight_{2};
+    std::atomic<int>    inFlight_{0};
+    std::atomic<double> centerHz_{0.0};
+
+    // ── Config (UI thread → worker) ──────────────────────────────────────────
+    mutable std::mutex         cfgMutex_;
+    QVector<ClassifierChannel> channels_;
+    bool                       channelsDirty_{true};
+
+    // ── Worker-thread state ──────────────────────────────────────────────────
+    std::vector<Extractor>            extractors_;
+    std::vector<std::complex<double>> mixed_;
+    std::vector<float>                snippet_;   // Features / Local scratch
+    ModulationFeatures                features_;
+    double                            builtRate_{0.0};
+    uint32_t                          frameId_{0};
 
-    std::atomic<int> intervalMs_{100};
+    ShmIqRing        ring_;
+    std::shared_ptr<Metrics::Counter> sent_     = std::make_shared<Metrics::Counter>();
+    std::shared_ptr<Metrics::Counter> dropped_  = std::make_shared<Metrics::Counter>();
+    std::shared_ptr<Metrics::Gauge>   inFlightGauge_ = std::make_shared<Metrics::Gauge>();
 
     using Clock = std::chrono::steady_clock;
     Clock::time_point lastEmit_{};
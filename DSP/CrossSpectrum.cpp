@@ -0,0 +1,160 @@
+#include "CrossSpectrum.h"
+#include "DspUtils.h"
+#include "FftProcessor.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+constexpr double kSpeedOfLight = 299'792'458.0;
+constexpr double kDegPerRad    = 180.0 / dsp::kPi;
+
+double wrapDeg(double deg) {
+    while (deg >  180.0) deg -= 360.0;
+    while (deg < -180.0) deg += 360.0;
+    return deg;
+}
+
+float db(double power) {
+    return static_cast<float>(10.0 * std::log10(std::max(power, 1e-20)));
+}
+
+}  // namespace
+
+CrossSpectrum::CrossSpectrum()
+    : CrossSpectrum(Options{})
+{}
+
+CrossSpectrum::CrossSpectrum(const Options& options)
+    : options_(options)
+{
+    const int n = options_.fftSize;
+    if (n < 16 || (n & (n - 1)) != 0)
+        throw std::invalid_argument("CrossSpectrum: fftSize must be a power of two >= 16");
+    if (options_.segments < 2)
+        throw std::invalid_argument("CrossSpectrum: segments must be >= 2");
+
+    // Hann, scaled like FftProcessor::powerSpectrum: a full-scale complex
+    // tone reads 1.0 (0 dBFS) in its bin.
+    window_.resize(static_cast<std::size_t>(n));
+    double sum = 0.0;
+    for (int i = 0; i < n; ++i) {
+        window_[i] = static_cast<float>(0.5 - 0.5 * std::cos(2.0 * dsp::kPi * i / n));
+        sum += window_[i];
+    }
+    norm_ = static_cast<float>(1.0 / (sum * sum));
+
+    const auto batch = 2 * static_cast<std::size_t>(n) * options_.segments;
+    in_.resize(batch);
+    out_.resize(batch);
+    s00_.resize(static_cast<std::size_t>(n));
+    s11_.resize(static_cast<std::size_t>(n));
+    s01_.resize(static_cast<std::size_t>(n));
+}
+
+int CrossSpectrum::pairsNeeded() const {
+    return options_.fftSize + (options_.segments - 1) * (options_.fftSize / 2);
+}
+
+CrossSpectrumFrame CrossSpectrum::compute(const float* ch0, const float* ch1, int count,
+                                          double centreHz, double sampleRateHz,
+                                          double calibrationDeg) {
+    CrossSpectrumFrame frame;
+    frame.centreHz     = centreHz;
+    frame.sampleRateHz = sampleRateHz;
+    if (count < pairsNeeded() || sampleRateHz <= 0.0) return frame;
+
+    // ── Both channels' segments, one batch: ch0 rows, then ch1 rows ─────────
+    const int n    = options_.fftSize;
+    const int segs = options_.segments;
+    const int hop  = n / 2;
+    for (int s = 0; s < segs; ++s) {
+        const float* a = ch0 + 2 * static_cast<std::size_t>(s) * hop;
+        const float* b = ch1 + 2 * static_cast<std::size_t>(s) * hop;
+        std::complex<float>* ra = in_.data() + static_cast<std::size_t>(s) * n;
+        std::complex<float>* rb = in_.data() + static_cast<std::size_t>(segs + s) * n;
+        for (int i = 0; i < n; ++i) {
+            ra[i] = {a[2 * i] * window_[i], a[2 * i + 1] * window_[i]};
+            rb[i] = {b[2 * i] * window_[i], b[2 * i + 1] * window_[i]};
+        }
+    }
+    FftProcessor::transformBatch(in_.data(), out_.data(), n, 2 * segs);
+
+    std::fill(s00_.begin(), s00_.end(), 0.0);
+    std::fill(s11_.begin(), s11_.end(), 0.0);
+    std::fill(s01_.begin(), s01_.end(), std::complex<double>{});
+    for (int s = 0; s < segs; ++s) {
+        const std::complex<float>* xa = out_.data() + static_cast<std::size_t>(s) * n;
+        const std::complex<float>* xb = out_.data() + static_cast<std::size_t>(segs + s) * n;
+        for (int k = 0; k < n; ++k) {
+            const std::complex<double> a(xa[k]), b(xb[k]);
+            s00_[k] += std::norm(a);
+            s11_[k] += std::norm(b);
+            s01_[k] += a * std::conj(b);
+        }
+    }
+
+    // ── Per bin, FFT-shifted ─────────────────────────────────────────────────
+    const double scale = static_cast<double>(norm_) / segs;
+    frame.powerDb.resize(n);
+    frame.coherence.resize(n);
+    frame.phaseDeg.resize(n);
+    sorted_.resize(static_cast<std::size_t>(n));
+    for (int i = 0; i < n; ++i) {
+        const int k = (i + n / 2) % n;
+        const double denom = s00_[k] * s11_[k];
+        const double mean  = 0.5 * (s00_[k] + s11_[k]);
+        frame.powerDb[i]   = db(mean * scale);
+        frame.coherence[i] = denom > 0.0 ? static_cast<float>(std::norm(s01_[k]) / denom) : 0.0f;
+        frame.phaseDeg[i]  = static_cast<float>(wrapDeg(std::arg(s01_[k]) * kDegPerRad - calibrationDeg));
+        sorted_[i] = mean;
+    }
+
+    // ── Signals: runs of bins above the median by detectDb ──────────────────
+    std::nth_element(sorted_.begin(), sorted_.begin() + n / 2, sorted_.end());
+    const double threshold = sorted_[n / 2] * std::pow(10.0, options_.detectDb / 10.0);
+    const double binHz = sampleRateHz / n;
+    auto above = [&](int i) {
+        const int k = (i + n / 2) % n;
+        return 0.5 * (s00_[k] + s11_[k]) > threshold;
+    };
+    for (int i = 0; i < n; ) {
+        if (!above(i)) { ++i; continue; }
+
+        double p00 = 0.0, p11 = 0.0, weight = 0.0, moment = 0.0, peak = 0.0;
+        std::complex<double> p01;
+        const int first = i;
+        for (; i < n && above(i); ++i) {
+            const int k = (i + n / 2) % n;
+            const double mean = 0.5 * (s00_[k] + s11_[k]);
+            p00 += s00_[k];
+            p11 += s11_[k];
+            p01 += s01_[k];
+            weight += mean;
+            moment += mean * (i - n / 2);
+            peak = std::max(peak, mean);
+        }
+
+        DfReading r;
+        r.freqHz      = centreHz + moment / weight * binHz;
+        r.bandwidthHz = (i - first) * binHz;
+        r.powerDb     = db(peak * scale);
+        r.coherence   = static_cast<float>(std::norm(p01) / (p00 * p11));
+        const double phaseDeg = wrapDeg(std::arg(p01) * kDegPerRad - calibrationDeg);
+        r.phaseDeg    = static_cast<float>(phaseDeg);
+
+        const double d = options_.antennaSpacingM;
+        if (d > 0.0 && r.freqHz > 0.0 && r.coherence >= options_.minCoherence) {
+            const double lambda = kSpeedOfLight / r.freqHz;
+            const double sine   = -phaseDeg / kDegPerRad * lambda / (2.0 * dsp::kPi * d);
+            if (std::abs(sine) <= 1.0) {
+                r.angleDeg   = static_cast<float>(std::asin(sine) * kDegPerRad);
+                r.angleValid = true;
+            }
+        }
+        frame.readings.append(r);
+    }
+    return frame;
+}
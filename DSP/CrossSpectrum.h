@@ -0,0 +1,87 @@
+#pragma once
+
+#include <QMetaType>
+#include <QVector>
+#include <complex>
+#include <vector>
+
+// One detected signal of a CrossSpectrumFrame: the bins of one run above the
+// detection threshold, with their summed cross-spectrum.
+struct DfReading {
+    double freqHz{0.0};        // RF, power-weighted centre of the run
+    double bandwidthHz{0.0};   // bins × resolution
+    float  powerDb{0.0f};      // strongest bin, dBFS
+    float  coherence{0.0f};    // |ΣS01|² / (ΣS00 · ΣS11), 0…1
+    float  phaseDeg{0.0f};     // arg ΣS01 − calibration, [-180, 180]
+    float  angleDeg{0.0f};     // angle of arrival from broadside, + towards RX1
+    bool   angleValid{false};  // spacing set, coherent, |sin θ| ≤ 1
+};
+
+// Per-bin results, FFT-shifted (bin 0 = −fs/2, bin fftSize/2 = centre).
+struct CrossSpectrumFrame {
+    double centreHz{0.0};
+    double sampleRateHz{0.0};
+    QVector<float>     powerDb;     // (S00 + S11) / 2, dBFS
+    QVector<float>     coherence;   // |S01|² / (S00 · S11), 0…1
+    QVector<float>     phaseDeg;    // arg S01 − calibration, [-180, 180]
+    QVector<DfReading> readings;    // ascending frequency
+
+    [[nodiscard]] double freqHz(int bin) const {
+        return centreHz + (bin - powerDb.size() / 2) * sampleRateHz / powerDb.size();
+    }
+};
+Q_DECLARE_METATYPE(CrossSpectrumFrame)
+
+// ---------------------------------------------------------------------------
+// CrossSpectrum — Welch cross-spectral density of two coherent channels:
+//
+//   S00 = Σ|X0|²,  S11 = Σ|X1|²,  S01 = Σ X0 · conj(X1)   over segments
+//
+// Segments are fftSize pairs, Hann-windowed, 50 % overlap; both channels'
+// segments go through one batched FFT (FftProcessor::transformBatch). From the
+// sums: per-bin magnitude-squared coherence and phase of ch0 · conj(ch1),
+// and the signals — runs of bins detectDb above the median bin power — each
+// with its own coherence, phase and, given the antenna spacing, a two-element
+// interferometer angle of arrival:
+//
+//   phase = −2π · d · sin θ / λ,  λ = c / f  →  θ = asin(−phase · λ / (2π d))
+//
+// θ is from broadside, positive towards RX1; the calibration (cable / LO
+// offset, IqCombiner::phaseCalibrationDeg) is removed first. Spacings above
+// λ / 2 make θ ambiguous; the principal value is reported. Uncorrelated
+// noise reads a coherence of about 1 / segments.
+//
+// Not thread-safe (scratch buffers); one instance per thread.
+// ---------------------------------------------------------------------------
+class CrossSpectrum {
+public:
+    struct Options {
+        int    fftSize{1024};        // power of two ≥ 16
+        int    segments{16};         // ≥ 2
+        double antennaSpacingM{0.0}; // 0 = no angle of arrival
+        double detectDb{10.0};       // signal threshold above the median bin
+        double minCoherence{0.5};    // for an angle of arrival
+    };
+
+    CrossSpectrum();
+    // Throws std::invalid_argument unless fftSize is a power of two ≥ 16 and
+    // segments ≥ 2.
+    explicit CrossSpectrum(const Options& options);
+
+    // Pairs compute() needs from each channel.
+    [[nodiscard]] int pairsNeeded() const;
+    [[nodiscard]] const Options& options() const { return options_; }
+
+    // Empty frame when count < pairsNeeded(); extra samples are ignored.
+    [[nodiscard]] CrossSpectrumFrame compute(const float* ch0, const float* ch1, int count,
+                                             double centreHz, double sampleRateHz,
+                                             double calibrationDeg = 0.0);
+
+private:
+    Options                          options_;
+    std::vector<float>               window_;
+    float                            norm_{1.0f};   // full-scale tone → 1.0
+    std::vector<std::complex<float>> in_, out_;
+    std::vector<double>              s00_, s11_, sorted_;
+    std::vector<std::complex<double>> s01_;
+};
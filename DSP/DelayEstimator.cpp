@@ -0,0 +1,67 @@
+#include "DelayEstimator.h"
+#include "DspUtils.h"
+#include "FftProcessor.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+DelayEstimate DelayEstimator::estimate(const float* ref, const float* x, int count) {
+    DelayEstimate result;
+    if (count < 1) return result;
+
+    const int n = static_cast<int>(std::bit_ceil(static_cast<unsigned>(count + kMaxLag)));
+    nfft_ = n;
+    in_.assign(2 * static_cast<std::size_t>(n), {});
+    out_.resize(2 * static_cast<std::size_t>(n));
+    spectrum_.resize(static_cast<std::size_t>(n));
+
+    double refEnergy = 0.0, xEnergy = 0.0;
+    for (int i = 0; i < count; ++i) {
+        in_[i]     = {ref[2 * i], ref[2 * i + 1]};
+        in_[n + i] = {x[2 * i], x[2 * i + 1]};
+        refEnergy += std::norm(std::complex<double>(in_[i]));
+        xEnergy   += std::norm(std::complex<double>(in_[n + i]));
+    }
+    if (refEnergy <= 0.0 || xEnergy <= 0.0) return result;
+
+    FftProcessor::transformBatch(in_.data(), out_.data(), n, 2);
+    for (int k = 0; k < n; ++k)
+        spectrum_[k] = std::complex<double>(out_[n + k]) * std::conj(std::complex<double>(out_[k]));
+
+    // Inverse through the forward transform: ifft(S) = conj(fft(conj(S))) / n.
+    for (int k = 0; k < n; ++k) in_[k] = std::complex<float>(std::conj(spectrum_[k]));
+    FftProcessor::transformBatch(in_.data(), out_.data(), n, 1);
+
+    int best = 0;
+    float bestMag = -1.0f;
+    for (int m = -kMaxLag; m <= kMaxLag; ++m) {
+        const float mag = std::abs(out_[(m + n) % n]);
+        if (mag > bestMag) { bestMag = mag; best = m; }
+    }
+
+    // Golden-section search for the band-limited maximum within ±1 sample.
+    constexpr double kRatio = 0.6180339887498949;
+    double a = std::max<double>(best - 1, -kMaxLag);
+    double b = std::min<double>(best + 1,  kMaxLag);
+    double c = b - kRatio * (b - a), d = a + kRatio * (b - a);
+    double fc = std::abs(correlationAt(c)), fd = std::abs(correlationAt(d));
+    for (int i = 0; i < 40; ++i) {
+        if (fc > fd) { b = d; d = c; fd = fc; c = b - kRatio * (b - a); fc = std::abs(correlationAt(c)); }
+        else         { a = c; c = d; fc = fd; d = a + kRatio * (b - a); fd = std::abs(correlationAt(d)); }
+    }
+    result.delaySamples = 0.5 * (a + b);
+    result.peak = std::abs(correlationAt(result.delaySamples)) / std::sqrt(refEnergy * xEnergy);
+    return result;
+}
+
+std::complex<double> DelayEstimator::correlationAt(double lag) const {
+    // r(τ) = 1/N Σ S_k e^{j2π f_k τ / N}, f_k = k for k < N/2, k − N above.
+    const int n = nfft_;
+    const std::complex<double> step = std::polar(1.0, 2.0 * dsp::kPi * lag / n);
+    std::complex<double> acc, z = 1.0;
+    for (int k = 0; k < n / 2; ++k, z *= step) acc += spectrum_[k] * z;
+    z = std::polar(1.0, -dsp::kPi * lag);
+    for (int k = n / 2; k < n; ++k, z *= step) acc += spectrum_[k] * z;
+    return acc / static_cast<double>(n);
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <complex>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// DelayEstimator — time delay of one channel against a reference, from their
+// cross-correlation.
+//
+//   r(m) = Σ x[n + m] · ref*[n]
+//
+// computed with FFTs of 2^k ≥ count + kMaxLag points (zero-padded, so lags up
+// to ±kMaxLag are linear, not circular). The integer peak of |r| within
+// ±kMaxLag is refined to a fraction of a sample by maximising the band-limited
+// interpolation of r around it (r(τ) = Σ_k R_k e^{j2πkτ/N}, golden-section
+// search), which is exact for band-limited signals; parabolic fits are biased
+// for the broad peaks of narrowband ones.
+//
+// delaySamples is τ with x[n] ≈ ref[n − τ]: positive when x lags.
+// FractionalDelay::process(x, …, τ) lines x up with ref. peak is
+// |r(τ)| / √(Σ|ref|² · Σ|x|²), 0…1; a noise-only estimate reads ≈ 1/√count.
+//
+// Not thread-safe (scratch buffers); one instance per thread.
+// ---------------------------------------------------------------------------
+struct DelayEstimate {
+    double delaySamples{0.0};
+    double peak{0.0};
+};
+
+class DelayEstimator {
+public:
+    static constexpr int kMaxLag = 32;
+
+    // count ≥ 1; a zero-energy channel gives peak 0.
+    DelayEstimate estimate(const float* ref, const float* x, int count);
+
+private:
+    std::complex<double> correlationAt(double lag) const;
+
+    int nfft_{0};
+    std::vector<std::complex<float>> in_, out_;
+    std::vector<std::complex<double>> spectrum_;   // X · conj(Ref)
+};
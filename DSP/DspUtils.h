@@ -1,6 +1,8 @@
 #pragma once
 
+#include <bit>
 #include <complex>
+#include <cstdint>
 #include <vector>
 #include <cmath>
 
@@ -14,6 +16,25 @@ constexpr double kPi = 3.14159265358979323846;
 // ---------------------------------------------------------------------------
 std::vector<double> designLowpassFir(int numTaps, double cutoffNorm);
 
+// ---------------------------------------------------------------------------
+// Bitwise equality (distinguishes ±0, unlike ==) — for state comparisons
+// that must guarantee identical output.
+// ---------------------------------------------------------------------------
+inline bool sameBits(double a, double b) {
+    return std::bit_cast<uint64_t>(a) == std::bit_cast<uint64_t>(b);
+}
+
+inline bool sameBits(std::complex<double> a, std::complex<double> b) {
+    return sameBits(a.real(), b.real()) && sameBits(a.imag(), b.imag());
+}
+
+// Samples until a first-order IIR with this pole has scaled its initial
+// state below 2^-64 — past that, two runs started from different states
+// agree to the last bit (in practice; callers that need certainty compare).
+inline double settlingSamples(double pole) {
+    return (pole > 0.0 && pole < 1.0) ? 64.0 * std::log(2.0) / -std::log(pole) : 0.0;
+}
+
 // ---------------------------------------------------------------------------
 // DC blocker — first-order IIR highpass for complex I/Q.
 // Removes LO leakage (DC spike at 0 Hz in baseband).
@@ -40,7 +61,8 @@ struct DcBlocker {
 
 // ---------------------------------------------------------------------------
 // NCO — numerically controlled oscillator for frequency shifting.
-// mix() multiplies input by e^{j*phase} and advances phase.
+// mix() multiplies input by e^{j*phase} and advances phase; advance() only
+// steps the phase (same arithmetic, so the two stay bit-identical).
 // ---------------------------------------------------------------------------
 struct Nco {
     double phase    = 0.0;
@@ -52,10 +74,14 @@ struct Nco {
 
     std::complex<double> mix(std::complex<double> s) {
         auto result = s * std::complex<double>(std::cos(phase), std::sin(phase));
+        advance();
+        return result;
+    }
+
+    void advance() {
         phase += phaseInc;
         if (phase >  kPi) phase -= 2.0 * kPi;
         if (phase < -kPi) phase += 2.0 * kPi;
-        return result;
     }
 
     void reset() { phase = 0.0; }
@@ -88,4 +114,40 @@ struct IirHighpass1 {
     }
 };
 
+// ---------------------------------------------------------------------------
+// Activity gate (squelch) with hysteresis and hang time.
+// Opens as soon as power reaches openDb; closes only after power has stayed
+// below (openDb - hysteresisDb) for hangSamples consecutive samples.
+// update() takes the number of samples the power estimate covers.
+// ---------------------------------------------------------------------------
+struct ActivityGate {
+    double    openDb       = -60.0;
+    double    hysteresisDb = 3.0;
+    long long hangSamples  = 0;
+
+    bool      open       = false;
+    long long belowCount = 0;
+
+    bool update(double powerDb, int nSamples) {
+        if (powerDb >= openDb) {
+            open       = true;
+            belowCount = 0;
+        } else if (open && powerDb < openDb - hysteresisDb) {
+            belowCount += nSamples;
+            if (belowCount >= hangSamples) {
+                open       = false;
+                belowCount = 0;
+            }
+        } else {
+            belowCount = 0;   // inside hysteresis band — hold state
+        }
+        return open;
+    }
+
+    void reset() {
+        open       = false;
+        belowCount = 0;
+    }
+};
+
 } // namespace dsp
@@ -4,6 +4,8 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstring>
+#include <map>
 #include <mutex>
 #include <stdexcept>
 #include <unordered_map>
@@ -96,6 +98,49 @@ CachedPlan& getPlan(int fftSize) {
     return entry;
 }
 
+// Batched plan: howMany transforms of `size` points in one fftwf_execute.
+// Same per-thread caching and planner locking as CachedPlan.
+struct CachedBatchPlan {
+    fftwf_complex* in   = nullptr;
+    fftwf_complex* out  = nullptr;
+    fftwf_plan     plan = nullptr;
+
+    ~CachedBatchPlan() {
+        if (plan) {
+            std::lock_guard<std::mutex> lock(s_plannerMutex);
+            fftwf_destroy_plan(plan);
+        }
+        if (in)  fftwf_free(in);
+        if (out) fftwf_free(out);
+    }
+    CachedBatchPlan()                                  = default;
+    CachedBatchPlan(const CachedBatchPlan&)            = delete;
+    CachedBatchPlan& operator=(const CachedBatchPlan&) = delete;
+};
+
+CachedBatchPlan& getBatchPlan(int size, int howMany) {
+    thread_local std::map<std::pair<int, int>, CachedBatchPlan> cache;
+    auto& entry = cache[{size, howMany}];
+    if (entry.plan) return entry;
+
+    const std::size_t total = static_cast<std::size_t>(size) * howMany;
+    entry.in  = reinterpret_cast<fftwf_complex*>(fftwf_malloc(sizeof(fftwf_complex) * total));
+    entry.out = reinterpret_cast<fftwf_complex*>(fftwf_malloc(sizeof(fftwf_complex) * total));
+    if (!entry.in || !entry.out)
+        throw std::runtime_error("FFTW malloc failed for batch " + std::to_string(size)
+                                 + " x " + std::to_string(howMany));
+    {
+        std::lock_guard<std::mutex> lock(s_plannerMutex);
+        entry.plan = fftwf_plan_many_dft(1, &size, howMany,
+                                         entry.in,  nullptr, 1, size,
+                                         entry.out, nullptr, 1, size,
+                                         FFTW_FORWARD, FFTW_MEASURE);
+    }
+    if (!entry.plan)
+        throw std::runtime_error("FFTW batch plan creation failed");
+    return entry;
+}
+
 // Hann window coefficients — float, cached per size alongside the plan.
 const std::vector<float>& getHannWindow(int n) {
     thread_local std::unordered_map<int, std::vector<float>> wCache;
@@ -161,3 +206,48 @@ FftFrame FftProcessor::process(const float* iq, int count,
 
     return frame;
 }
+
+void FftProcessor::powerSpectrum(const float* iq, int n, float* power) {
+    if (n < 1)
+        throw std::runtime_error("IQ buffer must contain at least one I/Q pair");
+
+    auto& cp     = getPlan(n);
+    auto& window = getHannWindow(n);
+    for (int i = 0; i < n; ++i) {
+        cp.in[i][0] = iq[2 * i]     * window[i];
+        cp.in[i][1] = iq[2 * i + 1] * window[i];
+    }
+    fftwf_execute(cp.plan);
+
+    float winSum = 0.0f;
+    for (float w : window) winSum += w;
+    const float norm = 1.0f / (winSum * winSum);
+    for (int k = 0; k < n; ++k) {
+        const int shifted = (k + n / 2) % n;
+        power[k] = (cp.out[shifted][0] * cp.out[shifted][0]
+                  + cp.out[shifted][1] * cp.out[shifted][1]) * norm;
+    }
+}
+
+void FftProcessor::transformBatch(const std::complex<float>* in, std::complex<float>* out,
+                                  int n, int howMany)
+{
+    if (n < 1 || howMany < 1)
+        throw std::runtime_error("FFT batch needs at least one transform of one point");
+
+    auto& bp = getBatchPlan(n, howMany);
+    // std::complex<float> is layout-compatible with fftwf_complex. Caller
+    // buffers are used in place when their SIMD alignment matches the plan's;
+    // otherwise the data goes through the plan's own buffers.
+    auto* fin  = reinterpret_cast<fftwf_complex*>(const_cast<std::complex<float>*>(in));
+    auto* fout = reinterpret_cast<fftwf_complex*>(out);
+    if (fftwf_alignment_of(reinterpret_cast<float*>(fin))  == fftwf_alignment_of(bp.in[0])
+        && fftwf_alignment_of(reinterpret_cast<float*>(fout)) == fftwf_alignment_of(bp.out[0])) {
+        fftwf_execute_dft(bp.plan, fin, fout);   // out-of-place: `in` is not modified
+        return;
+    }
+    const std::size_t bytes = sizeof(fftwf_complex) * static_cast<std::size_t>(n) * howMany;
+    std::memcpy(bp.in, in, bytes);
+    fftwf_execute(bp.plan);
+    std::memcpy(static_cast<void*>(out), bp.out, bytes);
+}
@@ -2,6 +2,7 @@
 
 #include <QMetaType>
 #include <QVector>
+#include <complex>
 #include <memory>
 
 struct FftFrame {
@@ -29,4 +30,15 @@ public:
     static FftFrame process(const float* iq, int count,
                             double centerFreqMHz,
                             double sampleRateHz);
+
+    // Linear Hann-windowed power of n pairs, FFT-shifted (DC at n / 2) and
+    // normalised like process(): a full-scale complex sine reads 1.0.
+    // power must hold n values. Same per-thread plan cache.
+    static void powerSpectrum(const float* iq, int n, float* power);
+
+    // howMany forward n-point transforms, back to back (n · howMany values in
+    // `in` and `out`, which must not overlap). Raw FFTW output: unnormalised,
+    // unshifted. One batched plan per (n, howMany) and thread.
+    static void transformBatch(const std::complex<float>* in, std::complex<float>* out,
+                               int n, int howMany);
 };
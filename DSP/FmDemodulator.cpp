@@ -69,3 +69,16 @@ void FmDemodulator::resetDemodState() {
     prevIF_      = {1.0, 0.0};
     deemphState_ = 0.0;
 }
+
+// ---------------------------------------------------------------------------
+// Offline chunking
+// ---------------------------------------------------------------------------
+std::unique_ptr<BaseDemodulator> FmDemodulator::clone() const {
+    return std::make_unique<FmDemodulator>(*this);
+}
+
+bool FmDemodulator::sameDemodState(const BaseDemodulator& other) const {
+    const auto* o = dynamic_cast<const FmDemodulator*>(&other);
+    return o && dsp::sameBits(prevIF_, o->prevIF_)
+             && dsp::sameBits(deemphState_, o->deemphState_);
+}
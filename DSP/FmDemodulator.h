@@ -19,10 +19,14 @@ public:
 
     void setBandwidth(double bandwidthHz);
 
+    [[nodiscard]] std::unique_ptr<BaseDemodulator> clone() const override;
+
 protected:
     double demodulateIF(std::complex<double> ifSample, double ifPower) override;
     void resetDemodState() override;
     const char* demodName() const override { return "FmDemodulator"; }
+    double settlingIfSamples() const override { return dsp::settlingSamples(deemphP_); }
+    bool   sameDemodState(const BaseDemodulator& other) const override;
 
 private:
     double deemphTau_;
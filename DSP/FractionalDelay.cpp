@@ -0,0 +1,42 @@
+#include "FractionalDelay.h"
+#include "DspUtils.h"
+
+#include <algorithm>
+#include <cmath>
+
+void FractionalDelay::design(double delaySamples) {
+    // Integer part as an offset; the sinc is centred on the fraction μ.
+    const double whole = std::floor(delaySamples);
+    const double mu    = delaySamples - whole;
+    offset_ = static_cast<int>(whole) - kTaps / 2 + 1;
+
+    double sum = 0.0;
+    std::array<double, kTaps> h{};
+    for (int k = 0; k < kTaps; ++k) {
+        const double t = k - (kTaps / 2 - 1) - mu;
+        // An integer delay leaves one non-zero tap: an exact shift.
+        const double s = t == 0.0 ? 1.0 : mu == 0.0 ? 0.0 : std::sin(dsp::kPi * t) / (dsp::kPi * t);
+        const double x = (k - mu + 0.5) / kTaps;   // window follows the centre
+        const double w = 0.42 - 0.5 * std::cos(2.0 * dsp::kPi * x) + 0.08 * std::cos(4.0 * dsp::kPi * x);
+        h[k] = s * w;
+        sum += h[k];
+    }
+    for (int k = 0; k < kTaps; ++k) taps_[k] = static_cast<float>(h[k] / sum);
+    designed_ = delaySamples;
+}
+
+void FractionalDelay::process(const float* in, int count, double delaySamples, float* out) {
+    delaySamples = std::clamp(delaySamples, -double(kMaxDelay), double(kMaxDelay));
+    if (delaySamples != designed_) design(delaySamples);
+
+    // Real taps act on I and Q alike, so over the interleaved floats this is
+    // one FIR with stride-2 taps; the fixed inner loop unrolls and the outer
+    // one vectorises.
+    const float* src = in + 2 * offset_;
+    const float* h   = taps_.data();
+    for (int i = 0; i < 2 * count; ++i) {
+        float acc = 0.0f;
+        for (int k = 0; k < kTaps; ++k) acc += h[k] * src[i + 2 * k];
+        out[i] = acc;
+    }
+}
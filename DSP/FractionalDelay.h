@@ -0,0 +1,38 @@
+#pragma once
+
+#include <array>
+
+// ---------------------------------------------------------------------------
+// FractionalDelay — shifts interleaved I/Q by a non-integer number of samples:
+//   out[n] = in(n + delaySamples)
+// so a channel that lags by τ samples is advanced by τ (delaySamples = τ).
+//
+// kTaps-tap Blackman-windowed sinc, centred on the fractional part of the
+// delay; the integer part is an offset into `in`. Taps are computed for the
+// exact delay (no phase quantisation) and kept until the delay changes, so a
+// constant delay costs the FIR alone: kTaps real multiply-adds per I and Q.
+// Response error is below −65 dB up to ±0.3 · fs and −20 dB at ±0.4 · fs.
+//
+// `in` must be readable over [−kReach, count + kReach) pairs around the
+// first output sample. Not thread-safe; one instance per stream.
+// ---------------------------------------------------------------------------
+class FractionalDelay {
+public:
+    static constexpr int kTaps     = 16;
+    static constexpr int kMaxDelay = 32;                     // |delaySamples| bound
+    static constexpr int kReach    = kMaxDelay + kTaps / 2;  // input margin, pairs
+
+    // delaySamples is clamped to ±kMaxDelay.
+    void process(const float* in, int count, double delaySamples, float* out);
+
+    // Taps in use: out[n] = Σ taps()[k] · in[n + offset() + k].
+    [[nodiscard]] const std::array<float, kTaps>& taps() const { return taps_; }
+    [[nodiscard]] int offset() const { return offset_; }
+
+private:
+    void design(double delaySamples);
+
+    std::array<float, kTaps> taps_{};
+    int    offset_{0};
+    double designed_{-1e9};   // delay the taps are for
+};
@@ -0,0 +1,406 @@
+#include "IqCodec.h"
+#include "Logger.h"
+
+#include <QThreadPool>
+#include <QtConcurrent/QtConcurrent>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdlib>
+#include <cstring>
+
+namespace IqCodec {
+
+namespace {
+
+constexpr int kMaxOrder  = 3;
+constexpr int kMaxRiceK  = 20;
+constexpr int kEscapeQ   = 24;   // unary prefixes this long switch to a raw 32-bit value
+
+void putLe(std::vector<uint8_t>& out, uint64_t v, int bytes) {
+    for (int i = 0; i < bytes; ++i)
+        out.push_back(static_cast<uint8_t>(v >> (8 * i)));
+}
+
+uint64_t getLe(const uint8_t* p, int bytes) {
+    uint64_t v = 0;
+    for (int i = 0; i < bytes; ++i)
+        v |= static_cast<uint64_t>(p[i]) << (8 * i);
+    return v;
+}
+
+// MSB-first bit packer.
+class BitWriter {
+public:
+    explicit BitWriter(std::vector<uint8_t>& out) : out_(out) {}
+
+    void put(uint32_t v, int bits) {   // bits ≤ 32
+        if (bits == 0) return;
+        const uint64_t mask = (bits == 32) ? 0xFFFFFFFFull : ((1ull << bits) - 1);
+        acc_  = (acc_ << bits) | (v & mask);
+        used_ += bits;
+        while (used_ >= 8) {
+            used_ -= 8;
+            out_.push_back(static_cast<uint8_t>(acc_ >> used_));
+        }
+    }
+
+    void rice(uint32_t u, int k) {
+        const uint32_t q = u >> k;
+        if (q >= static_cast<uint32_t>(kEscapeQ)) {
+            put((1u << kEscapeQ) - 1, kEscapeQ);
+            put(u, 32);
+            return;
+        }
+        const int prefix = static_cast<int>(q) + 1;            // q ones, one zero
+        if (prefix + k <= 32) {
+            const uint32_t low = k ? (u & ((1u << k) - 1)) : 0;
+            put(((((1u << q) - 1) << 1) << k) | low, prefix + k);
+            return;
+        }
+        put(((1u << q) - 1) << 1, prefix);
+        put(u, k);
+    }
+
+    void flush() {
+        if (used_ > 0) out_.push_back(static_cast<uint8_t>(acc_ << (8 - used_)));
+        used_ = 0;
+    }
+
+private:
+    std::vector<uint8_t>& out_;
+    uint64_t acc_{0};
+    int      used_{0};
+};
+
+class BitReader {
+public:
+    BitReader(const uint8_t* p, std::size_t bytes) : p_(p), end_(p + bytes) {}
+
+    bool get(int bits, uint32_t& v) {
+        if (bits == 0) { v = 0; return true; }
+        refill();
+        if (avail_ < bits) return false;
+        v = static_cast<uint32_t>(acc_ >> (64 - bits));
+        skip(bits);
+        return true;
+    }
+
+    bool rice(int k, uint32_t& u) {
+        int q = 0;
+        for (;;) {
+            refill();
+            if (avail_ == 0) return false;
+            const int ones = std::countl_one(acc_);   // bits past avail_ are zero
+            if (q + ones >= kEscapeQ) {
+                skip(kEscapeQ - q);
+                return get(32, u);
+            }
+            if (ones < avail_) {
+                skip(ones + 1);
+                q += ones;
+                break;
+            }
+            skip(ones);
+            q += ones;
+        }
+        uint32_t low = 0;
+        if (!get(k, low)) return false;
+        u = (static_cast<uint32_t>(q) << k) | low;
+        return true;
+    }
+
+private:
+    void refill() {
+        while (avail_ <= 56 && p_ < end_) {
+            acc_ |= static_cast<uint64_t>(*p_++) << (56 - avail_);
+            avail_ += 8;
+        }
+    }
+    void skip(int bits) {
+        acc_ = bits >= 64 ? 0 : acc_ << bits;
+        avail_ -= bits;
+    }
+
+    const uint8_t* p_;
+    const uint8_t* end_;
+    uint64_t acc_{0};
+    int      avail_{0};
+};
+
+inline uint32_t zigzag(int32_t e)   { return (static_cast<uint32_t>(e) << 1) ^ static_cast<uint32_t>(e >> 31); }
+inline int32_t  unzigzag(uint32_t u) { return static_cast<int32_t>(u >> 1) ^ -static_cast<int32_t>(u & 1); }
+
+// Fixed polynomial predictors; history before the block start is zero.
+//   a = x[n-1], b = x[n-2], c = x[n-3]
+inline int32_t predict(int order, int32_t a, int32_t b, int32_t c) {
+    switch (order) {
+        case 1:  return a;
+        case 2:  return 2 * a - b;
+        case 3:  return 3 * a - 3 * b + c;
+        default: return 0;
+    }
+}
+
+void encodeComponent(const int16_t* iq, std::size_t pairs, int comp,
+                     std::vector<int32_t>& x, std::vector<uint32_t>& u, BitWriter& bw) {
+    x.resize(pairs);
+    u.resize(pairs);
+    uint32_t orBits = 0;
+    for (std::size_t n = 0; n < pairs; ++n) {
+        x[n] = iq[2 * n + comp];
+        orBits |= static_cast<uint32_t>(x[n]);
+    }
+    const int shift = orBits == 0 ? 0 : std::min(15, std::countr_zero(orBits));
+    if (shift > 0)
+        for (auto& v : x) v >>= shift;
+
+    std::array<uint64_t, kMaxOrder + 1> cost{};
+    {
+        int32_t a = 0, b = 0, c = 0;
+        for (std::size_t n = 0; n < pairs; ++n) {
+            const int32_t v = x[n];
+            cost[0] += static_cast<uint32_t>(std::abs(v));
+            cost[1] += static_cast<uint32_t>(std::abs(v - a));
+            cost[2] += static_cast<uint32_t>(std::abs(v - 2 * a + b));
+            cost[3] += static_cast<uint32_t>(std::abs(v - 3 * a + 3 * b - c));
+            c = b; b = a; a = v;
+        }
+    }
+    const int order = static_cast<int>(std::min_element(cost.begin(), cost.end()) - cost.begin());
+
+    {
+        int32_t a = 0, b = 0, c = 0;
+        for (std::size_t n = 0; n < pairs; ++n) {
+            const int32_t v = x[n];
+            u[n] = zigzag(v - predict(order, a, b, c));
+            c = b; b = a; a = v;
+        }
+    }
+
+    bw.put(static_cast<uint32_t>(shift), 4);
+    bw.put(static_cast<uint32_t>(order), 2);
+    for (std::size_t p = 0; p < pairs; p += kPartition) {
+        const std::size_t end = std::min<std::size_t>(pairs, p + kPartition);
+        uint64_t sum = 0;
+        for (std::size_t n = p; n < end; ++n) sum += u[n];
+        const uint64_t mean = sum / (end - p);
+        const int k = mean == 0 ? 0
+                    : std::min(kMaxRiceK, static_cast<int>(std::bit_width(mean)) - 1);
+        bw.put(static_cast<uint32_t>(k), 5);
+        for (std::size_t n = p; n < end; ++n) bw.rice(u[n], k);
+    }
+}
+
+bool decodeComponent(BitReader& br, std::size_t pairs, int comp, int16_t* iq) {
+    uint32_t shift = 0, order = 0;
+    if (!br.get(4, shift) || !br.get(2, order)) return false;
+    int32_t a = 0, b = 0, c = 0;
+    for (std::size_t p = 0; p < pairs; p += kPartition) {
+        const std::size_t end = std::min<std::size_t>(pairs, p + kPartition);
+        uint32_t k = 0;
+        if (!br.get(5, k) || k > kMaxRiceK) return false;
+        for (std::size_t n = p; n < end; ++n) {
+            uint32_t u = 0;
+            if (!br.rice(static_cast<int>(k), u)) return false;
+            const int32_t v = unzigzag(u) + predict(static_cast<int>(order), a, b, c);
+            iq[2 * n + comp] = static_cast<int16_t>(static_cast<uint32_t>(v) << shift);
+            c = b; b = a; a = v;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+// ---------------------------------------------------------------------------
+// Block codec
+// ---------------------------------------------------------------------------
+void encodeBlock(const int16_t* iq, uint32_t pairs, std::vector<uint8_t>& out) {
+    const std::size_t start = out.size();
+    putLe(out, kBlockMagic, 4);
+    putLe(out, pairs, 4);
+    putLe(out, 0, 4);                       // payloadBytes, patched below
+    putLe(out, static_cast<uint8_t>(BlockMode::Rice), 4);
+
+    thread_local std::vector<int32_t>  x;
+    thread_local std::vector<uint32_t> u;
+    out.reserve(start + kBlockHeaderBytes + static_cast<std::size_t>(pairs) * 2 * sizeof(int16_t));
+    {
+        BitWriter bw(out);
+        encodeComponent(iq, pairs, 0, x, u, bw);
+        encodeComponent(iq, pairs, 1, x, u, bw);
+        bw.flush();
+    }
+
+    std::size_t payload = out.size() - start - kBlockHeaderBytes;
+    const std::size_t rawBytes = static_cast<std::size_t>(pairs) * 2 * sizeof(int16_t);
+    if (payload >= rawBytes) {
+        out.resize(start + kBlockHeaderBytes);
+        const auto* b = reinterpret_cast<const uint8_t*>(iq);
+        out.insert(out.end(), b, b + rawBytes);
+        out[start + 12] = static_cast<uint8_t>(BlockMode::Raw);
+        payload = rawBytes;
+    }
+    for (int i = 0; i < 4; ++i)
+        out[start + 8 + i] = static_cast<uint8_t>(payload >> (8 * i));
+}
+
+bool decodeBlock(const BlockHeader& header, const uint8_t* payload, int16_t* iq) {
+    if (header.mode == BlockMode::Raw) {
+        if (header.payloadBytes != header.pairs * 2 * sizeof(int16_t)) return false;
+        std::memcpy(iq, payload, header.payloadBytes);
+        return true;
+    }
+    BitReader br(payload, header.payloadBytes);
+    return decodeComponent(br, header.pairs, 0, iq)
+        && decodeComponent(br, header.pairs, 1, iq);
+}
+
+std::vector<uint8_t> fileHeader() {
+    std::vector<uint8_t> h;
+    putLe(h, kFileMagic, 4);
+    putLe(h, kVersion, 2);
+    putLe(h, 0, 2);
+    putLe(h, kBlockPairs, 4);
+    putLe(h, 0, 4);
+    return h;
+}
+
+bool parseFileHeader(const uint8_t* data, uint32_t& blockPairs) {
+    if (getLe(data, 4) != kFileMagic || getLe(data + 4, 2) != kVersion) return false;
+    blockPairs = static_cast<uint32_t>(getLe(data + 8, 4));
+    return true;
+}
+
+bool parseBlockHeader(const uint8_t* data, BlockHeader& out) {
+    if (getLe(data, 4) != kBlockMagic) return false;
+    out.pairs        = static_cast<uint32_t>(getLe(data + 4, 4));
+    out.payloadBytes = static_cast<uint32_t>(getLe(data + 8, 4));
+    out.mode         = static_cast<BlockMode>(data[12]);
+    return out.pairs > 0 && out.pairs <= kBlockPairs
+        && (out.mode == BlockMode::Rice || out.mode == BlockMode::Raw);
+}
+
+std::vector<uint8_t> indexAndTrailer(const std::vector<IndexEntry>& index,
+                                     uint64_t indexOffset) {
+    std::vector<uint8_t> out;
+    out.reserve(index.size() * kIndexEntryBytes + kTrailerBytes);
+    for (const auto& e : index) {
+        putLe(out, e.fileOffset, 8);
+        putLe(out, e.streamPair, 8);
+        putLe(out, e.pairs, 4);
+    }
+    putLe(out, indexOffset, 8);
+    putLe(out, index.size(), 4);
+    putLe(out, kTrailerMagic, 4);
+    return out;
+}
+
+bool parseTrailer(const uint8_t* data, uint64_t& indexOffset, uint32_t& count) {
+    if (getLe(data + 12, 4) != kTrailerMagic) return false;
+    indexOffset = getLe(data, 8);
+    count       = static_cast<uint32_t>(getLe(data + 8, 4));
+    return true;
+}
+
+IndexEntry parseIndexEntry(const uint8_t* data) {
+    return {getLe(data, 8), getLe(data + 8, 8), static_cast<uint32_t>(getLe(data + 16, 4))};
+}
+
+// ---------------------------------------------------------------------------
+// Writer
+// ---------------------------------------------------------------------------
+Writer::~Writer() {
+    close();
+}
+
+bool Writer::open(const QString& path, QThreadPool* pool,
+                  const AsyncFileWriter::Options& options) {
+    close();
+    if (!file_.open(path, options)) return false;
+    pool_        = pool;
+    streamPairs_ = 0;
+    index_.clear();
+    const auto h = fileHeader();
+    file_.write(h.data(), h.size());
+    return true;
+}
+
+void Writer::write(const int16_t* iq, std::size_t pairs) {
+    if (!file_.isOpen()) return;
+    while (pairs > 0) {
+        if (!current_) {
+            if (!spare_.empty()) {
+                current_ = std::move(spare_.back());
+                spare_.pop_back();
+            } else {
+                current_ = std::make_unique<Job>();
+                current_->in.reserve(2 * kBlockPairs);
+            }
+            current_->in.clear();
+            current_->streamPair = streamPairs_;
+        }
+        const std::size_t have = current_->in.size() / 2;
+        const std::size_t take = std::min<std::size_t>(pairs, kBlockPairs - have);
+        current_->in.insert(current_->in.end(), iq, iq + 2 * take);
+        iq            += 2 * take;
+        pairs         -= take;
+        streamPairs_  += take;
+        if (current_->in.size() / 2 == kBlockPairs) submit();
+    }
+}
+
+void Writer::submit() {
+    Job* job = current_.get();
+    job->out.clear();
+    auto encode = [job] {
+        encodeBlock(job->in.data(), static_cast<uint32_t>(job->in.size() / 2), job->out);
+    };
+    if (pool_) {
+        job->done = QtConcurrent::run(pool_, encode);
+    } else {
+        encode();
+        job->done = QFuture<void>();
+    }
+    inFlight_.push_back(std::move(current_));
+
+    retire(false);
+    while (inFlight_.size() > kMaxInFlight) retire(true);
+}
+
+// Writes finished blocks in submission order; with wait, at least the oldest.
+void Writer::retire(bool wait) {
+    while (!inFlight_.empty()) {
+        auto& job = inFlight_.front();
+        if (wait) {
+            job->done.waitForFinished();
+            wait = false;
+        } else if (!job->done.isFinished()) {
+            return;
+        }
+        const uint64_t offset = file_.position();
+        if (file_.write(job->out.data(), job->out.size()))
+            index_.push_back({offset, job->streamPair,
+                              static_cast<uint32_t>(job->in.size() / 2)});
+        spare_.push_back(std::move(job));
+        inFlight_.pop_front();
+    }
+}
+
+void Writer::close() {
+    if (!file_.isOpen()) return;
+    if (current_ && !current_->in.empty()) submit();
+    current_.reset();
+    while (!inFlight_.empty()) retire(true);
+    spare_.clear();
+
+    const auto tail = indexAndTrailer(index_, file_.position());
+    if (!file_.write(tail.data(), tail.size()))
+        LOG_WARN("IqCodec: index dropped; replay will rebuild it from block headers");
+    file_.close();
+    index_.clear();
+}
+
+}  // namespace IqCodec
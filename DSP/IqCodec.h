@@ -0,0 +1,122 @@
+#pragma once
+
+#include "../Core/AsyncFileWriter.h"
+
+#include <QFuture>
+#include <QString>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <vector>
+
+class QThreadPool;
+
+// ---------------------------------------------------------------------------
+// IqCodec — lossless block codec for int16 I/Q (`.ci16z`).
+//
+// Each block of up to kBlockPairs pairs is coded independently, so blocks
+// encode in parallel and decode from any index entry. Per block and per
+// component (I, Q):
+//   1. wasted bits — common trailing zeros are shifted out (4 bits for the
+//      LMS7002M's left-aligned 12-bit samples);
+//   2. fixed polynomial prediction, order 0…3, picked by smallest |residual|;
+//   3. Rice coding of the zigzagged residual, k chosen per kPartition values.
+// A block that would not shrink is stored raw.
+//
+// File layout (little-endian):
+//   header   16 B   "SIQZ", u16 version, u16 0, u32 blockPairs, u32 0
+//   blocks          "IQZB", u32 pairs, u32 payloadBytes, u8 mode, 3 × 0, payload
+//   index    20 B × n   u64 fileOffset, u64 streamPair, u32 pairs
+//   trailer  16 B   u64 indexOffset, u32 n, "SIQX"
+// streamPair counts every pair handed to the writer, so blocks dropped by a
+// slow disk leave a visible gap. Without the trailer (crash) the reader
+// rebuilds the index by walking block headers.
+// ---------------------------------------------------------------------------
+namespace IqCodec {
+
+constexpr uint32_t kBlockPairs   = 65536;
+constexpr uint32_t kPartition    = 1024;
+constexpr uint32_t kFileMagic    = 0x5A514953;   // "SIQZ"
+constexpr uint32_t kBlockMagic   = 0x425A5149;   // "IQZB"
+constexpr uint32_t kTrailerMagic = 0x58514953;   // "SIQX"
+constexpr uint16_t kVersion      = 1;
+constexpr std::size_t kFileHeaderBytes  = 16;
+constexpr std::size_t kBlockHeaderBytes = 16;
+constexpr std::size_t kIndexEntryBytes  = 20;
+constexpr std::size_t kTrailerBytes     = 16;
+
+enum class BlockMode : uint8_t { Rice = 0, Raw = 1 };
+
+struct BlockHeader {
+    uint32_t  pairs{0};
+    uint32_t  payloadBytes{0};
+    BlockMode mode{BlockMode::Rice};
+};
+
+struct IndexEntry {
+    uint64_t fileOffset{0};   // of the block header
+    uint64_t streamPair{0};
+    uint32_t pairs{0};
+};
+
+// Appends header + payload for one block to out.
+void encodeBlock(const int16_t* iq, uint32_t pairs, std::vector<uint8_t>& out);
+
+// Decodes one payload into iq (2 × header.pairs values). False if corrupt.
+bool decodeBlock(const BlockHeader& header, const uint8_t* payload, int16_t* iq);
+
+std::vector<uint8_t> fileHeader();
+bool parseFileHeader(const uint8_t* data, uint32_t& blockPairs);
+bool parseBlockHeader(const uint8_t* data, BlockHeader& out);
+std::vector<uint8_t> indexAndTrailer(const std::vector<IndexEntry>& index,
+                                     uint64_t indexOffset);
+bool parseTrailer(const uint8_t* data, uint64_t& indexOffset, uint32_t& count);
+IndexEntry parseIndexEntry(const uint8_t* data);
+
+// ---------------------------------------------------------------------------
+// Writer — accumulates int16 pairs into blocks, encodes them on the pool
+// (inline when pool == nullptr) and hands them to an AsyncFileWriter in
+// order. At most kMaxInFlight blocks are queued; past that write() waits on
+// the oldest (QFuture::waitForFinished runs it inline if it hasn't started,
+// so calling from a pool task cannot deadlock).
+// ---------------------------------------------------------------------------
+class Writer {
+public:
+    static constexpr std::size_t kMaxInFlight = 8;
+
+    Writer() = default;
+    ~Writer();
+
+    Writer(const Writer&) = delete;
+    Writer& operator=(const Writer&) = delete;
+
+    bool open(const QString& path, QThreadPool* pool, const AsyncFileWriter::Options& options);
+    void write(const int16_t* iq, std::size_t pairs);
+    void close();
+
+    [[nodiscard]] bool isOpen() const { return file_.isOpen(); }
+    [[nodiscard]] AsyncFileWriter::Stats stats() const { return file_.stats(); }
+    [[nodiscard]] uint64_t rawBytes() const { return streamPairs_ * 2 * sizeof(int16_t); }
+
+private:
+    struct Job {
+        std::vector<int16_t> in;
+        std::vector<uint8_t> out;
+        uint64_t             streamPair{0};
+        QFuture<void>        done;
+    };
+
+    void submit();
+    void retire(bool wait);
+
+    AsyncFileWriter file_;
+    QThreadPool*    pool_{nullptr};
+    std::unique_ptr<Job>              current_;
+    std::deque<std::unique_ptr<Job>>  inFlight_;
+    std::vector<std::unique_ptr<Job>> spare_;
+    std::vector<IndexEntry>           index_;
+    uint64_t        streamPairs_{0};
+};
+
+}  // namespace IqCodec
@@ -1,47 +1,177 @@
 #include "IqCombiner.h"
 #include "../Core/Pipeline.h"
+#include "../Core/Trace.h"
 
+#include <QThreadPool>
+#include <QtConcurrent/QtConcurrent>
+
+#include <algorithm>
 #include <cmath>
 #include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+std::size_t checkedCount(int channelCount) {
+    if (channelCount < 1)
+        throw std::invalid_argument("IqCombiner: channelCount must be at least 1");
+    return static_cast<std::size_t>(channelCount);
+}
+
+constexpr double kDegPerRad = 180.0 / M_PI;
+
+// out (+)= wa·a + wb·b over interleaved pairs: the fused complex
+// multiply-accumulate of two channels. One store per pair for both, and the
+// per-pair form vectorises (AVX2 + FMA: four pairs per instruction).
+template <bool Accumulate>
+void mac2(float* __restrict out, const float* __restrict a, std::complex<float> wa,
+          const float* __restrict b, std::complex<float> wb, int pairs) {
+    const float ar = wa.real(), ai = wa.imag(), br = wb.real(), bi = wb.imag();
+    for (int n = 0; n < pairs; ++n) {
+        const float i0 = a[2*n], q0 = a[2*n + 1];
+        const float i1 = b[2*n], q1 = b[2*n + 1];
+        const float re = ar*i0 - ai*q0 + br*i1 - bi*q1;
+        const float im = ar*q0 + ai*i0 + br*q1 + bi*i1;
+        out[2*n]     = Accumulate ? out[2*n]     + re : re;
+        out[2*n + 1] = Accumulate ? out[2*n + 1] + im : im;
+    }
+}
+
+// Odd channel out.
+template <bool Accumulate>
+void mac1(float* __restrict out, const float* __restrict a, std::complex<float> wa, int pairs) {
+    const float ar = wa.real(), ai = wa.imag();
+    for (int n = 0; n < pairs; ++n) {
+        const float i0 = a[2*n], q0 = a[2*n + 1];
+        const float re = ar*i0 - ai*q0;
+        const float im = ar*q0 + ai*i0;
+        out[2*n]     = Accumulate ? out[2*n]     + re : re;
+        out[2*n + 1] = Accumulate ? out[2*n + 1] + im : im;
+    }
+}
+
+}  // namespace
 
 IqCombiner::IqCombiner(int channelCount, Pipeline* output, QObject* parent)
     : QObject(parent)
     , output_(output)
     , channelCount_(channelCount)
-    , slots_(channelCount)
-    , gainScale_(channelCount, 1.0f)
+    , channels_(checkedCount(channelCount))
+    , gainScale_(channelCount)
+    , combined_(2 * static_cast<std::size_t>(kMaxDispatchPairs))
+    , calibrationDeg_(std::max(channelCount, 2))
+    , trackedDeg_(std::max(channelCount, 2))
+    , chunkCross_(channelCount)
+    , chunkPower_(channelCount, 0.0)
+    , trackCross_(channelCount)
+    , trackPower_(channelCount, 0.0)
+    , weights_(channelCount)
     , sumI2_(channelCount, 0.0)
     , sumQ2_(channelCount, 0.0)
     , sumIQ_(channelCount, 0.0)
-{}
+    , delaySamples_(std::max(channelCount, 2))
+    , source_(channelCount)
+    , delayFilters_(channelCount)
+    , delayed_(channelCount)
+    , delayInput_(channelCount)
+{
+    if (channelCount_ > 1) {
+        for (auto& chan : channels_) chan.ring.assign(2 * static_cast<std::size_t>(kRingPairs), 0.0f);
+        for (int ch = 1; ch < channelCount_; ++ch)
+            delayed_[ch].assign(2 * static_cast<std::size_t>(kMaxDispatchPairs), 0.0f);
+        stage_.assign(2 * static_cast<std::size_t>(kMaxDispatchPairs + 2 * FractionalDelay::kReach), 0.0f);
+        for (auto& in : delayInput_) in.reserve(2 * static_cast<std::size_t>(kDelayPairs));
+    }
+    for (auto& g : gainScale_) g.store(1.0f);
+    for (auto& d : calibrationDeg_) d.store(0.0);
+    for (auto& d : trackedDeg_) d.store(0.0);
+    for (auto& d : delaySamples_) d.store(0.0);
+}
+
+IqCombiner::~IqCombiner() {
+    delayTask_.waitForFinished();
+    crossTask_.waitForFinished();
+}
 
 void IqCombiner::setChannelGain(int channelIndex, double gainDb) {
     if (channelIndex < 0 || channelIndex >= channelCount_) return;
     const float scale = 1.0f / std::pow(10.0f, static_cast<float>(gainDb) / 20.0f);
-    std::lock_guard lock(mutex_);
-    gainScale_[channelIndex] = scale;
+    gainScale_[channelIndex].store(scale, std::memory_order_relaxed);
+}
+
+void IqCombiner::setMode(Mode mode) {
+    mode_.store(mode, std::memory_order_relaxed);
+}
+
+void IqCombiner::setPhaseTracking(bool on) {
+    tracking_.store(on, std::memory_order_relaxed);
 }
 
 void IqCombiner::setPhaseCalibrationDeg(double deg) {
-    phaseCalibrationDeg_.store(deg);
+    setPhaseCalibrationDeg(1, deg);
+}
+
+void IqCombiner::setPhaseCalibrationDeg(int channelIndex, double deg) {
+    if (channelIndex < 1 || channelIndex >= static_cast<int>(calibrationDeg_.size())) return;
+    calibrationDeg_[channelIndex].store(deg);
 }
 
 double IqCombiner::phaseCalibrationDeg() const {
-    return phaseCalibrationDeg_.load();
+    return phaseCalibrationDeg(1);
+}
+
+double IqCombiner::phaseCalibrationDeg(int channelIndex) const {
+    if (channelIndex < 1 || channelIndex >= static_cast<int>(calibrationDeg_.size())) return 0.0;
+    return calibrationDeg_[channelIndex].load();
+}
+
+void IqCombiner::setDelayCompensation(bool on) {
+    compensate_.store(on, std::memory_order_relaxed);
+}
+
+double IqCombiner::delaySamples(int channelIndex) const {
+    if (channelIndex < 1 || channelIndex >= static_cast<int>(delaySamples_.size())) return 0.0;
+    return delaySamples_[channelIndex].load(std::memory_order_relaxed);
+}
+
+void IqCombiner::setCrossSpectrum(const CrossSpectrum::Options& options, int intervalMs) {
+    auto cross = std::make_unique<CrossSpectrum>(options);   // throws first
+    if (channelCount_ < 2) return;
+    crossTask_.waitForFinished();
+    cross_ = std::move(cross);
+    crossIntervalMs_ = std::max(intervalMs, 0);
+    for (auto& in : crossInput_) in.assign(2 * static_cast<std::size_t>(cross_->pairsNeeded()), 0.0f);
+    crossFill_ = 0;
 }
 
 double IqCombiner::calibrateNow() {
-    double raw = 0.0;
-    {
-        std::lock_guard lock(mutex_);
-        // Используем аккумулированный cross-продукт, если есть данные; иначе 0.
-        if (accBlocks_ > 0 &&
-            (crossReAcc_ != 0.0 || crossImAcc_ != 0.0)) {
-            raw = std::atan2(crossImAcc_, crossReAcc_) * 180.0 / M_PI;
-        }
-    }
-    phaseCalibrationDeg_.store(raw);
-    return raw;
+    // Усреднённая фаза каждого канала; без данных — 0.
+    const bool have = haveTracked_.load();
+    for (std::size_t ch = 1; ch < calibrationDeg_.size(); ++ch)
+        calibrationDeg_[ch].store(have ? trackedDeg_[ch].load() : 0.0);
+    return calibrationDeg_[1].load();
+}
+
+void IqCombiner::publishMetrics(const Metrics::Labels& labels) {
+    auto& reg = Metrics::Registry::instance();
+    reg.add("stand_combiner_blocks_total", "Combined blocks dispatched.", labels, combinedBlocks_);
+    reg.add("stand_combiner_dropped_blocks_total",
+            "Channel blocks (or tails) that did not fit the alignment ring.", labels, droppedBlocks_);
+    reg.add("stand_combiner_slips_total", "Channel realignments by hardware timestamp.",
+            labels, slips_);
+    reg.add("stand_combiner_slip_samples_total",
+            "Channel samples discarded by realignment (no partner, duplicates).", labels, slipSamples_);
+    reg.add("stand_combiner_coherence", "RX0/RX1 coherence, 0…1.", labels, coherenceGauge_);
+    reg.add("stand_combiner_phase_degrees", "Calibrated RX0/RX1 phase difference.",
+            labels, phaseGauge_);
+    reg.add("stand_combiner_delay_samples", "Estimated RX1 delay against RX0, samples.",
+            labels, delayGauge_);
+    reg.add("stand_combiner_delay_estimates_total", "Inter-channel delay estimates run.",
+            labels, delayEstimates_);
+    reg.add("stand_combiner_cross_spectra_total", "RX0/RX1 cross-spectrum frames computed.",
+            labels, crossFrames_);
 }
 
 // Fallback — no metadata, treat as channel 0.
@@ -51,70 +181,311 @@ void IqCombiner::processBlock(const float* iq, int count, double sampleRateHz) {
 
 void IqCombiner::processBlock(const float* iq, int count, double sampleRateHz,
                                const BlockMeta& meta) {
-    const int floatCount = count * 2;
-
-    std::lock_guard lock(mutex_);
+    if (count <= 0) return;
 
     // If this is a single-channel combiner, skip buffering — just scale and dispatch.
     // Must come before the channelIndex bounds check: channelIndex may be 1 (RX1)
     // while channelCount_==1, which would otherwise be rejected as out-of-range.
+    // One RxWorker feeds it, so nothing else touches the accumulators.
     if (channelCount_ == 1) {
+        applyResets();
         accumulateChannelIq(0, iq, count);
         ++iqAccBlocks_;
-        combined_.resize(floatCount);
-        const float s = gainScale_[0];
-        for (int i = 0; i < floatCount; ++i)
-            combined_[i] = iq[i] * s;
-        output_->dispatchBlock(combined_.data(), count, sampleRateHz);
+        const float s = gainScale_[0].load(std::memory_order_relaxed);
+        for (int done = 0; done < count; ) {
+            const int n = std::min(count - done, kMaxDispatchPairs);
+            const float* src = iq + 2 * static_cast<std::size_t>(done);
+            for (int i = 0; i < 2 * n; ++i)
+                combined_[i] = src[i] * s;
+            const uint64_t ts = meta.timestamp != 0 ? meta.timestamp + static_cast<uint64_t>(done) : 0;
+            output_->dispatchBlock(combined_.data(), n, sampleRateHz, BlockMeta{{}, ts});
+            combinedBlocks_->inc();
+            done += n;
+        }
         maybeEmitIqImbalance();
         return;
     }
 
     const int idx = meta.channel.channelIndex;
     if (idx < 0 || idx >= channelCount_) return;
+    auto& chan = channels_[idx];
+    chan.sampleRateHz.store(sampleRateHz, std::memory_order_relaxed);
+
+    // ── Where this block goes on the position axis ──────────────────────────
+    const uint64_t epoch = epoch_.load(std::memory_order_acquire);
+    uint64_t pos;
+    if (chan.epoch != epoch) {
+        if (chan.epoch != 0) abandonRun(chan);
+        chan.epoch = epoch;
+        pos = (epoch << kEpochShift) | (meta.timestamp & kTsMask);
+        startRun(chan, pos, meta.timestamp != 0);
+    } else if (meta.timestamp == 0) {
+        pos = chan.head;                                   // no counter: contiguous
+    } else {
+        pos = (epoch << kEpochShift) | (meta.timestamp & kTsMask);
+        if (pos > chan.head) {
+            // Samples lost upstream; the combiner skips the other channels'
+            // samples for the gap.
+            abandonRun(chan);
+            startRun(chan, pos, true);
+        } else if (pos == chan.head) {
+            // A counter that continues the run: its positions are real.
+            chan.timed.store(true, std::memory_order_relaxed);
+        } else {
+            // Duplicate samples: keep only what extends the run.
+            const uint64_t overlap = std::min<uint64_t>(chan.head - pos, static_cast<uint64_t>(count));
+            slips_->inc();
+            slipSamples_->inc(overlap);
+            iq    += 2 * overlap;
+            count -= static_cast<int>(overlap);
+            pos    = chan.head;
+            if (count == 0) return;
+        }
+    }
+
+    // ── Room: never overwrite positions the combiner may still read ─────────
+    // (the delay filter reads back kReach before the read position).
+    constexpr uint64_t kRoom = kRingPairs - FractionalDelay::kReach;
+    uint64_t read = readPos_.load(std::memory_order_acquire);
+    if (pos + count > read + kRoom) {
+        // A new run far ahead moves the combiner on once it is published.
+        requestCombine();
+        read = readPos_.load(std::memory_order_acquire);
+        const uint64_t limit = std::max(read + kRoom, pos);
+        if (pos + count > limit) {
+            droppedBlocks_->inc();
+            count = static_cast<int>(limit - pos);
+            if (count == 0) return;
+        }
+    }
+
+    write(chan, pos, iq, count);
+    requestCombine();
+}
+
+void IqCombiner::abandonRun(Channel& chan) {
+    // What the channel still holds unpaired goes with its run. Approximate
+    // while a combine is reading it.
+    const uint64_t read = readPos_.load(std::memory_order_acquire);
+    const uint64_t from = std::max(read, chan.runBegin);
+    if (chan.head > from) {
+        slips_->inc();
+        slipSamples_->inc(chan.head - from);
+    }
+}
+
+void IqCombiner::startRun(Channel& chan, uint64_t pos, bool timed) {
+    // begin before end: a combiner that sees the new end also sees the new
+    // begin, and one that sees the new begin with the old end finds no span.
+    chan.runBegin = chan.head = pos;
+    chan.timed.store(timed, std::memory_order_relaxed);   // published by begin
+    chan.begin.store(pos, std::memory_order_release);
+    chan.end.store(pos, std::memory_order_release);
+}
+
+void IqCombiner::write(Channel& chan, uint64_t pos, const float* iq, int count) {
+    const auto first = static_cast<std::size_t>(pos & kRingMask);
+    const auto n     = static_cast<std::size_t>(count);
+    const std::size_t part = std::min(n, static_cast<std::size_t>(kRingPairs) - first);
+    std::memcpy(chan.ring.data() + 2 * first, iq, 2 * part * sizeof(float));
+    if (part < n)
+        std::memcpy(chan.ring.data(), iq + 2 * part, 2 * (n - part) * sizeof(float));
+    chan.head = pos + count;
+    chan.end.store(chan.head, std::memory_order_release);
+}
+
+void IqCombiner::requestCombine() {
+    // The first requester combines; later requests while it runs make it go
+    // round again, so no published samples are left behind.
+    if (combineRequests_.fetch_add(1, std::memory_order_acq_rel) != 0) return;
+    uint32_t handled;
+    do {
+        handled = combineRequests_.load(std::memory_order_acquire);
+        combineAvailable();
+    } while (combineRequests_.fetch_sub(handled, std::memory_order_acq_rel) != handled);
+}
 
-    // Store a copy of the incoming block in the slot.
-    auto& slot = slots_[idx];
-    slot.data.resize(floatCount);
-    std::memcpy(slot.data.data(), iq, floatCount * sizeof(float));
-    slot.timestamp = meta.timestamp;
-    slot.filled = true;
+void IqCombiner::combineAvailable() {
+    applyResets();
+    uint64_t read = readPos_.load(std::memory_order_relaxed);   // only written here
+    for (;;) {
+        // Compensated channels need the filter's reach on both sides of the
+        // span; the margin is not a slip.
+        const bool compensate = compensate_.load(std::memory_order_relaxed);
+        // end before begin (see startRun()).
+        uint64_t hi = std::numeric_limits<uint64_t>::max(), lo = read, paired = read;
+        for (int ch = 0; ch < channelCount_; ++ch) {
+            auto& chan = channels_[ch];
+            chan.seenEnd   = chan.end.load(std::memory_order_acquire);
+            chan.seenBegin = chan.begin.load(std::memory_order_acquire);
+            chan.seenTimed = chan.timed.load(std::memory_order_relaxed);
+            const uint64_t margin = compensate && ch > 0 ? FractionalDelay::kReach : 0;
+            hi     = std::min(hi, chan.seenEnd > margin ? chan.seenEnd - margin : 0);
+            lo     = std::max(lo, chan.seenBegin + margin);
+            paired = std::max(paired, chan.seenBegin);
+        }
+
+        // Nothing before the latest run start can be paired any more.
+        if (lo > read) {
+            uint64_t skipped = 0;
+            for (const auto& chan : channels_) {
+                const uint64_t from = std::max(read, chan.seenBegin);
+                const uint64_t to   = std::min(paired, chan.seenEnd);
+                if (to > from) skipped += to - from;
+            }
+            if (skipped > 0) {
+                slips_->inc();
+                slipSamples_->inc(skipped);
+            }
+            read = lo;
+            readPos_.store(read, std::memory_order_release);
+        }
+        if (hi <= read) return;
+
+        // One contiguous stretch of every ring.
+        const uint64_t toWrap = kRingPairs - (read & kRingMask);
+        const int n = static_cast<int>(std::min<uint64_t>({hi - read, kMaxDispatchPairs, toWrap}));
+
+        const double sampleRateHz = channels_[0].sampleRateHz.load(std::memory_order_relaxed);
+        for (int ch = 0; ch < channelCount_; ++ch) {
+            accumulateChannelIq(ch, at(ch, read), n);
+            source_[ch] = compensate && ch > 0 ? compensated(ch, read, n) : at(ch, read);
+        }
+        ++iqAccBlocks_;
+        maybeEstimateDelay(read, n);
+        maybeCollectCross(read, n);
+        accumulatePhase(n);
+        updateWeights(n, sampleRateHz);
+        // The aligned hardware timestamp of the chunk's first pair; 0 when a
+        // channel has no counter and the positions are only sample counts.
+        const bool timed = std::all_of(channels_.begin(), channels_.end(),
+                                       [](const Channel& c) { return c.seenTimed; });
+        combineAndDispatch(timed ? read & kTsMask : 0, n, sampleRateHz);
+        maybeEmitPhase();
+        maybeEmitIqImbalance();
+
+        read += static_cast<uint64_t>(n);
+        readPos_.store(read, std::memory_order_release);
+    }
+}
+
+const float* IqCombiner::at(int ch, uint64_t pos) const {
+    return channels_[ch].ring.data() + 2 * static_cast<std::size_t>(pos & kRingMask);
+}
 
-    // Check if all slots are filled.
-    for (int i = 0; i < channelCount_; ++i) {
-        if (!slots_[i].filled) return;
+const float* IqCombiner::compensated(int ch, uint64_t pos, int count) {
+    // Filter input: [pos − kReach, pos + count + kReach), from the ring when
+    // it does not wrap there.
+    constexpr int kReach = FractionalDelay::kReach;
+    const auto first = static_cast<std::size_t>((pos - kReach) & kRingMask);
+    const auto total = static_cast<std::size_t>(count) + 2 * kReach;
+    const float* ring = channels_[ch].ring.data();
+    const float* in   = ring + 2 * first;
+    if (first + total > static_cast<std::size_t>(kRingPairs)) {
+        const std::size_t part = kRingPairs - first;
+        std::memcpy(stage_.data(), in, 2 * part * sizeof(float));
+        std::memcpy(stage_.data() + 2 * part, ring, 2 * (total - part) * sizeof(float));
+        in = stage_.data();
     }
+    delayFilters_[ch].process(in + 2 * kReach, count,
+                              delaySamples_[ch].load(std::memory_order_relaxed), delayed_[ch].data());
+    return delayed_[ch].data();
+}
+
+void IqCombiner::maybeEstimateDelay(uint64_t pos, int count) {
+    // Low duty cycle: one kDelayPairs snapshot per interval, on the pool.
+    if (channelCount_ < 2 || count < kDelayMinPairs) return;
+    if (delayBusy_.load(std::memory_order_acquire)) return;
+    const auto now = Clock::now();
+    if (lastDelayRun_.time_since_epoch().count() != 0
+        && now - lastDelayRun_ < std::chrono::milliseconds(kDelayIntervalMs))
+        return;
+    lastDelayRun_ = now;
 
-    // All channels present — compute cross-channel metric then combine.
-    accumulatePhase(count);
+    const int n = std::min(count, kDelayPairs);
     for (int ch = 0; ch < channelCount_; ++ch)
-        accumulateChannelIq(ch, slots_[ch].data.data(), count);
-    ++iqAccBlocks_;
-    combineAndDispatch(count, sampleRateHz);
-    maybeEmitPhase();
-    maybeEmitIqImbalance();
+        delayInput_[ch].assign(at(ch, pos), at(ch, pos) + 2 * static_cast<std::size_t>(n));
+    delayBusy_.store(true, std::memory_order_relaxed);
+    QThreadPool* pool = delayPool_ ? delayPool_ : QThreadPool::globalInstance();
+    delayTask_ = QtConcurrent::run(pool, [this, n] { estimateDelays(n); });
+}
+
+void IqCombiner::estimateDelays(int count) {
+    TRACE_SCOPE("combiner", "estimateDelays");
+    for (int ch = 1; ch < channelCount_; ++ch) {
+        const DelayEstimate e = delayEstimator_.estimate(delayInput_[0].data(), delayInput_[ch].data(), count);
+        if (e.peak >= kMinDelayPeak)
+            delaySamples_[ch].store(e.delaySamples, std::memory_order_relaxed);
+    }
+    delayGauge_->set(delaySamples_[1].load(std::memory_order_relaxed));
+    delayEstimates_->inc();
+    delayBusy_.store(false, std::memory_order_release);
+}
+
+void IqCombiner::maybeCollectCross(uint64_t pos, int count) {
+    // Collect pairsNeeded() contiguous pairs across chunks, then hand them to
+    // the pool; a gap (slip, new epoch) restarts the collection.
+    if (!cross_ || crossBusy_.load(std::memory_order_acquire)) return;
+    if (crossFill_ == 0) {
+        const auto now = Clock::now();
+        if (lastCrossRun_.time_since_epoch().count() != 0
+            && now - lastCrossRun_ < std::chrono::milliseconds(crossIntervalMs_))
+            return;
+    } else if (pos != crossNext_) {
+        crossFill_ = 0;
+    }
+
+    const int need = cross_->pairsNeeded();
+    const int n = std::min(count, need - crossFill_);
+    for (int ch = 0; ch < 2; ++ch)
+        std::memcpy(crossInput_[ch].data() + 2 * static_cast<std::size_t>(crossFill_), at(ch, pos),
+                    2 * static_cast<std::size_t>(n) * sizeof(float));
+    crossFill_ += n;
+    crossNext_  = pos + static_cast<uint64_t>(n);
+    if (crossFill_ < need) return;
+
+    crossFill_    = 0;
+    lastCrossRun_ = Clock::now();
+    const double sampleRateHz = channels_[0].sampleRateHz.load(std::memory_order_relaxed);
+    crossBusy_.store(true, std::memory_order_relaxed);
+    QThreadPool* pool = delayPool_ ? delayPool_ : QThreadPool::globalInstance();
+    crossTask_ = QtConcurrent::run(pool, [this, sampleRateHz] { computeCross(sampleRateHz); });
+}
+
+void IqCombiner::computeCross(double sampleRateHz) {
+    TRACE_SCOPE("combiner", "computeCross");
+    CrossSpectrumFrame frame = cross_->compute(crossInput_[0].data(), crossInput_[1].data(),
+                                               cross_->pairsNeeded(),
+                                               centreHz_.load(std::memory_order_relaxed), sampleRateHz,
+                                               calibrationDeg_[1].load(std::memory_order_relaxed));
+    crossFrames_->inc();
+    crossBusy_.store(false, std::memory_order_release);
+    emit crossSpectrum(std::move(frame));
 }
 
 void IqCombiner::accumulatePhase(int count) {
-    // ch0 and ch1 cross-product: Σ c0·conj(c1) where c = I + jQ.
+    // ch0 and ch_c cross-product: Σ c0·conj(c_c) where c = I + jQ.
     // (I0+jQ0)(I1-jQ1) = (I0·I1 + Q0·Q1) + j(Q0·I1 - I0·Q1)
+    // Powers come from accumulateChannelIq() (chunkPower_).
     if (channelCount_ < 2) return;
-    const float* a = slots_[0].data.data();
-    const float* b = slots_[1].data.data();
+    const float* a = source_[0];
+    for (int ch = 1; ch < channelCount_; ++ch) {
+        const float* b = source_[ch];
+        double cre = 0.0, cim = 0.0;
+        for (int n = 0; n < count; ++n) {
+            const float i0 = a[2*n],   q0 = a[2*n + 1];
+            const float i1 = b[2*n],   q1 = b[2*n + 1];
+            cre += double(i0)*i1 + double(q0)*q1;
+            cim += double(q0)*i1 - double(i0)*q1;
+        }
+        chunkCross_[ch] = {cre, cim};
+    }
 
-    double cre = 0.0, cim = 0.0, p0 = 0.0, p1 = 0.0;
-    for (int n = 0; n < count; ++n) {
-        const float i0 = a[2*n],   q0 = a[2*n + 1];
-        const float i1 = b[2*n],   q1 = b[2*n + 1];
-        cre += double(i0)*i1 + double(q0)*q1;
-        cim += double(q0)*i1 - double(i0)*q1;
-        p0  += double(i0)*i0 + double(q0)*q0;
-        p1  += double(i1)*i1 + double(q1)*q1;
-    }
-    crossReAcc_ += cre;
-    crossImAcc_ += cim;
-    pow0Acc_    += p0;
-    pow1Acc_    += p1;
+    // phaseMetric is ch0 vs ch1.
+    crossReAcc_ += chunkCross_[1].real();
+    crossImAcc_ += chunkCross_[1].imag();
+    pow0Acc_    += chunkPower_[0];
+    pow1Acc_    += chunkPower_[1];
     ++accBlocks_;
 }
 
@@ -130,6 +501,7 @@ void IqCombiner::accumulateChannelIq(int idx, const float* data, int count) {
     sumI2_[idx] += sI2;
     sumQ2_[idx] += sQ2;
     sumIQ_[idx] += sIQ;
+    chunkPower_[idx] = sI2 + sQ2;
 }
 
 void IqCombiner::maybeEmitIqImbalance() {
@@ -174,7 +546,7 @@ void IqCombiner::maybeEmitPhase() {
     const double mag    = std::sqrt(crossReAcc_*crossReAcc_ + crossImAcc_*crossImAcc_);
     const double coh    = denom > 0.0 ? std::min(1.0, mag / denom) : 0.0;
 
-    double cal = rawDeg - phaseCalibrationDeg_.load();
+    double cal = rawDeg - calibrationDeg_[1].load();
     // wrap to [-180, 180]
     while (cal >  180.0) cal -= 360.0;
     while (cal < -180.0) cal += 360.0;
@@ -184,64 +556,114 @@ void IqCombiner::maybeEmitPhase() {
     accBlocks_  = 0;
     lastEmit_   = now;
 
-    emit phaseMetric(rawDeg, cal, coh);
+    coherenceGauge_->set(coh);
+    phaseGauge_->set(cal);
+    emit phaseMetric(rawDeg, cal, coh, delaySamples_[1].load(std::memory_order_relaxed));
 }
 
-void IqCombiner::combineAndDispatch(int count, double sampleRateHz) {
-    const int floatCount = count * 2;
-    combined_.resize(floatCount);
-
-    const float invN = 1.0f / static_cast<float>(channelCount_);
-
-    // First channel: scale into combined buffer.
-    {
-        const float s = gainScale_[0] * invN;
-        const float* src = slots_[0].data.data();
-        for (int i = 0; i < floatCount; ++i)
-            combined_[i] = src[i] * s;
+void IqCombiner::updateWeights(int count, double sampleRateHz) {
+    // One-pole averages of the per-sample statistics; the first chunk after
+    // a reset starts them.
+    const double alpha = tracked_ && sampleRateHz > 0.0
+        ? std::min(1.0, count / (sampleRateHz * kTrackSeconds)) : 1.0;
+    const double inv = 1.0 / count;
+    for (int ch = 0; ch < channelCount_; ++ch) {
+        trackCross_[ch] += alpha * (chunkCross_[ch] * inv - trackCross_[ch]);
+        trackPower_[ch] += alpha * (chunkPower_[ch] * inv - trackPower_[ch]);
+    }
+    tracked_ = true;
+    for (int ch = 1; ch < channelCount_; ++ch)
+        trackedDeg_[ch].store(std::arg(trackCross_[ch]) * kDegPerRad, std::memory_order_relaxed);
+    haveTracked_.store(true, std::memory_order_relaxed);
+
+    const Mode mode   = mode_.load(std::memory_order_relaxed);
+    const bool follow = tracking_.load(std::memory_order_relaxed);
+    const double n    = channelCount_;
+
+    // Mrc: signal power after gain normalisation, assumed equal in every
+    // channel, from the cross-correlations with ch0.
+    double signal = 0.0, invNoiseSum = 0.0;
+    if (mode == Mode::Mrc) {
+        const double s0 = gainScale_[0].load(std::memory_order_relaxed);
+        for (int ch = 1; ch < channelCount_; ++ch)
+            signal += std::abs(trackCross_[ch]) * s0 * gainScale_[ch].load(std::memory_order_relaxed);
+        signal /= n - 1.0;
     }
+    auto invNoise = [&](int ch) {
+        const double s     = gainScale_[ch].load(std::memory_order_relaxed);
+        const double power = trackPower_[ch] * s * s;
+        const double noise = std::max(power - signal, kMinNoiseRatio * power);
+        return noise > 0.0 ? 1.0 / noise : 1.0;
+    };
+    if (mode == Mode::Mrc)
+        for (int ch = 0; ch < channelCount_; ++ch) invNoiseSum += invNoise(ch);
 
-    // Remaining channels: accumulate.
-    for (int ch = 1; ch < channelCount_; ++ch) {
-        const float s = gainScale_[ch] * invN;
-        const float* src = slots_[ch].data.data();
-        for (int i = 0; i < floatCount; ++i)
-            combined_[i] += src[i] * s;
+    for (int ch = 0; ch < channelCount_; ++ch) {
+        const double s = gainScale_[ch].load(std::memory_order_relaxed);
+        const double magnitude = mode == Mode::Mrc ? s * invNoise(ch) / invNoiseSum : s / n;
+        double theta = 0.0;
+        if (mode != Mode::Average && ch > 0)
+            theta = follow ? std::arg(trackCross_[ch])
+                           : calibrationDeg_[ch].load(std::memory_order_relaxed) / kDegPerRad;
+        weights_[ch] = std::polar(static_cast<float>(magnitude), static_cast<float>(theta));
     }
+}
+
+void IqCombiner::combineAndDispatch(uint64_t timestamp, int count, double sampleRateHz) {
+    TRACE_SCOPE("combiner", "combineAndDispatch");
+    float* out = combined_.data();
+    const auto& src = source_;
+
+    // Two channels per pass; an odd first channel on its own.
+    int ch = channelCount_ % 2;
+    if (ch == 1)
+        mac1<false>(out, src[0], weights_[0], count);
+    else
+        mac2<false>(out, src[0], weights_[0], src[1], weights_[1], count), ch = 2;
+    for (; ch < channelCount_; ch += 2)
+        mac2<true>(out, src[ch], weights_[ch], src[ch + 1], weights_[ch + 1], count);
+
+    output_->dispatchBlock(out, count, sampleRateHz, BlockMeta{{}, timestamp});
+    combinedBlocks_->inc();
+}
 
-    resetSlots();
-    output_->dispatchBlock(combined_.data(), count, sampleRateHz);
+void IqCombiner::applyResets() {
+    const uint32_t reset = pendingReset_.exchange(0, std::memory_order_acquire);
+    if (reset & kResetSums) {
+        crossReAcc_ = crossImAcc_ = pow0Acc_ = pow1Acc_ = 0.0;
+        accBlocks_  = 0;
+        for (int ch = 0; ch < channelCount_; ++ch)
+            sumI2_[ch] = sumQ2_[ch] = sumIQ_[ch] = 0.0;
+        iqAccBlocks_ = 0;
+        tracked_ = false;
+        crossFill_ = 0;
+    }
+    if (reset & kResetCadence) {
+        lastEmit_   = {};
+        lastIqEmit_ = {};
+    }
 }
 
-void IqCombiner::resetSlots() {
-    for (auto& slot : slots_)
-        slot.filled = false;
+void IqCombiner::newEpoch() {
+    // Every channel re-anchors on its next block; the combiner skips what is
+    // left of the old epoch once the first new run is published.
+    epoch_.fetch_add(1, std::memory_order_acq_rel);
 }
 
 void IqCombiner::onStreamStarted(double /*sampleRateHz*/) {
-    std::lock_guard lock(mutex_);
-    resetSlots();
-    crossReAcc_ = crossImAcc_ = pow0Acc_ = pow1Acc_ = 0.0;
-    accBlocks_  = 0;
-    lastEmit_   = {};
-    for (int ch = 0; ch < channelCount_; ++ch)
-        sumI2_[ch] = sumQ2_[ch] = sumIQ_[ch] = 0.0;
-    iqAccBlocks_ = 0;
-    lastIqEmit_  = {};
+    newEpoch();
+    haveTracked_.store(false);
+    pendingReset_.fetch_or(kResetSums | kResetCadence, std::memory_order_release);
 }
 
 void IqCombiner::onStreamStopped() {
-    std::lock_guard lock(mutex_);
-    resetSlots();
+    newEpoch();
 }
 
-void IqCombiner::onRetune(double /*newFreqHz*/) {
-    std::lock_guard lock(mutex_);
-    resetSlots();
-    crossReAcc_ = crossImAcc_ = pow0Acc_ = pow1Acc_ = 0.0;
-    accBlocks_  = 0;
-    for (int ch = 0; ch < channelCount_; ++ch)
-        sumI2_[ch] = sumQ2_[ch] = sumIQ_[ch] = 0.0;
-    iqAccBlocks_ = 0;
+void IqCombiner::onRetune(double newFreqHz) {
+    newEpoch();
+    centreHz_.store(newFreqHz, std::memory_order_relaxed);
+    haveTracked_.store(false);
     // Keep lastEmit_/lastIqEmit_ as is — retune doesn't need to reset emit cadence.
+    pendingReset_.fetch_or(kResetSums, std::memory_order_release);
 }
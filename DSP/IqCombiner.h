@@ -1,32 +1,91 @@
 #pragma once
 
 #include "../Core/IPipelineHandler.h"
+#include "../Core/Metrics.h"
+#include "CrossSpectrum.h"
+#include "DelayEstimator.h"
+#include "FractionalDelay.h"
 
+#include <QFuture>
 #include <QObject>
+#include <array>
 #include <atomic>
 #include <chrono>
+#include <complex>
 #include <cstdint>
-#include <mutex>
+#include <memory>
 #include <vector>
 
 class Pipeline;
+class QThreadPool;
 
 // ---------------------------------------------------------------------------
 // IqCombiner — merges I/Q blocks from N coherent RX channels into one output.
 //
 // Registered as an IPipelineHandler in each per-channel PrePipeline.
-// When all N channels have delivered a block with the same timestamp,
-// the combiner gain-normalises each channel (÷ linear gain), averages
-// the I/Q samples, and dispatches the result to the output Pipeline.
+// Samples are aligned by BlockMeta::timestamp (hardware sample counter):
+// every channel writes into its own ring at the ring position of each
+// sample's timestamp, and the combiner takes the span of timestamps that all
+// N channels hold, gain-normalises each channel (÷ linear gain), averages the
+// I/Q samples, and dispatches the result to the output Pipeline in chunks of
+// at most kMaxDispatchPairs, each with the aligned BlockMeta::timestamp of
+// its first pair (0 while any channel runs without a counter — its positions
+// are then sample counts, not timestamps). Partial blocks simply cover less
+// of the span.
+//
+// Combining (setMode()), all as one complex weight per channel, Σ w_c · x_c:
+//   Average      w_c = scale_c / N — in-phase signals only
+//   PhaseAligned w_c = scale_c / N · e^{jθ_c}, θ_c = channel c's phase
+//                against ch0 (calibration, or tracked — setPhaseTracking())
+//   Mrc          PhaseAligned, with |w_c| ∝ 1 / noise power of channel c.
+//                After gain normalisation the signal is taken to be equally
+//                strong in every channel, |E[x0·x_c*]|, so noise = power − that.
+// The statistics behind θ and the noise powers are one-pole averages over
+// kTrackSeconds, updated per combined chunk; weights are recomputed per chunk
+// and applied in one fused complex multiply-accumulate pass per two channels.
+//
+// Inter-channel delay: timestamps align samples, not signals — cables of
+// different lengths still delay one channel by a fraction of a sample or a
+// few samples. Once per kDelayIntervalMs the combiner copies kDelayPairs of
+// every channel and a task on the delay pool (setDelayPool()) estimates each
+// channel's delay against ch0 (DelayEstimator). With setDelayCompensation()
+// channels ≥ 1 are advanced by their estimate (FractionalDelay) before
+// combining; the filter reaches FractionalDelay::kReach samples either side,
+// so the combined output then trails by kReach and starts kReach after a
+// run starts.
+//
+// Cross-spectrum (setCrossSpectrum()): at most once per interval the combiner
+// copies CrossSpectrum::pairsNeeded() contiguous pairs of ch0 and ch1 — raw,
+// not delay-compensated, so the phase keeps the geometry — and a task on the
+// same pool computes a CrossSpectrumFrame with ch1's phase calibration
+// removed and emits crossSpectrum().
+//
+// Alignment slips (slips(), slipSamples()):
+//   - a channel's timestamp jumps ahead (samples lost upstream): the other
+//     channels' samples for the gap have no partner and are skipped;
+//   - a channel starts late, or after a gap, ahead of the rest: likewise;
+//   - a timestamp goes back (duplicate samples): the overlap is trimmed.
+// A block with timestamp 0 (no counter) continues its channel's sequence.
+// onStreamStarted() / onStreamStopped() / onRetune() start a new epoch: the
+// next block of every channel re-anchors, and samples of the old epoch
+// still waiting for a partner are skipped.
 //
 // Также считает межканальную фазовую/когерентную метрику (ch0 vs ch1) и
 // эмитит phaseMetric() с троттлингом. Фазовая калибровка хранится здесь:
 // setPhaseCalibrationDeg() / calibrateNow() вычитают константный offset из
 // сырой фазы (физически задержка между каналами постоянна при одном LO).
 //
-// Threading: processBlock() is called from different RxWorker threads
-// (one per channel). Internal mutex serialises access; the thread that
-// fills the last slot performs the combine+dispatch under the lock.
+// Threading: processBlock() is called from different RxWorker threads (one
+// per channel) and never blocks on another channel. Each ring is
+// single-producer / single-consumer: the channel publishes the timestamps
+// it holds with atomic begin / end marks, the combiner publishes its read
+// position. After a deposit the thread requests a combine; the first
+// requester combines + dispatches with no lock held and keeps going while
+// requests arrive, so dispatch runs on one thread at a time, in order.
+// A channel more than kRingPairs − FractionalDelay::kReach ahead of the
+// combiner loses the block tail that does not fit (droppedBlocks()); the
+// rest of the ring is the delay filter's history. Rings and the output buffer are
+// allocated up front; the data path does not allocate.
 // phaseMetric() эмитится из той же worker-нити — подключать через
 // Qt::QueuedConnection.
 // ---------------------------------------------------------------------------
@@ -34,22 +93,90 @@ class IqCombiner : public QObject, public IPipelineHandler {
     Q_OBJECT
 
 public:
+    static constexpr int kRingPairs        = 1 << 18;   // per channel, power of two
+    static constexpr int kMaxDispatchPairs = 1 << 14;
+
+    enum class Mode { Average, PhaseAligned, Mrc };
+
+    static constexpr double kTrackSeconds = 1.0;    // phase / noise averaging
+    static constexpr double kMinNoiseRatio = 1e-3;  // Mrc: noise ≥ −30 dB of the channel
+
+    static constexpr int    kDelayPairs      = 4096;  // per estimate and channel
+    static constexpr int    kDelayMinPairs   = 1024;  // shorter chunks are not sampled
+    static constexpr int    kDelayIntervalMs = 1000;
+    static constexpr double kMinDelayPeak    = 0.5;   // DelayEstimate::peak to accept
+
+    static constexpr int    kCrossIntervalMs = 500;
+
+    // Throws std::invalid_argument if channelCount < 1.
     explicit IqCombiner(int channelCount, Pipeline* output, QObject* parent = nullptr);
+    // Waits for a running delay estimate / cross-spectrum.
+    ~IqCombiner() override;
 
     // Set per-channel RX gain in dB for normalisation.
     // scale = 1 / 10^(gainDb / 20).  Thread-safe.
     void setChannelGain(int channelIndex, double gainDb);
 
-    // Фазовая калибровка (константный offset, вычитаемый из сырой фазы).
-    // Thread-safe.
+    // Thread-safe; takes effect from the next combined chunk.
+    void setMode(Mode mode);
+    [[nodiscard]] Mode mode() const { return mode_.load(std::memory_order_relaxed); }
+
+    // PhaseAligned / Mrc: rotate by the tracked phase, which follows slow
+    // drift, instead of the calibration. Thread-safe.
+    void setPhaseTracking(bool on);
+    [[nodiscard]] bool phaseTracking() const { return tracking_.load(std::memory_order_relaxed); }
+
+    // Фазовая калибровка (константный offset, вычитаемый из сырой фазы):
+    // phase of ch0·conj(ch_c); without a channel — ch1. Thread-safe.
     void   setPhaseCalibrationDeg(double deg);
+    void   setPhaseCalibrationDeg(int channelIndex, double deg);
     double phaseCalibrationDeg() const;
+    double phaseCalibrationDeg(int channelIndex) const;
 
-    // Снимает текущую сырую фазу как нулевой reference (calibration = raw).
+    // Снимает текущую сырую фазу каждого канала (tracked, kTrackSeconds) как
+    // нулевой reference (calibration = raw).
     // Вызывать, когда физически каналы принимают один и тот же сигнал
-    // (например, общая антенна/splitter). Возвращает применённый offset в град.
+    // (например, общая антенна/splitter). Возвращает применённый offset ch1 в град.
     double calibrateNow();
 
+    // Pool for the delay estimates; nullptr (default) = the global pool.
+    // Call before the stream starts.
+    void setDelayPool(QThreadPool* pool) { delayPool_ = pool; }
+
+    // Advance channels ≥ 1 by their estimated delay. Thread-safe; takes effect
+    // from the next combined chunk.
+    void setDelayCompensation(bool on);
+    [[nodiscard]] bool delayCompensation() const { return compensate_.load(std::memory_order_relaxed); }
+
+    // Latest accepted estimate of channel c against ch0, in samples (positive:
+    // c lags), 0 before the first; delayEstimates() counts finished estimates.
+    // Thread-safe.
+    [[nodiscard]] double   delaySamples(int channelIndex) const;
+    [[nodiscard]] uint64_t delayEstimates() const { return delayEstimates_->value(); }
+
+    // Since construction; thread-safe. A drop is a channel block (or its
+    // tail) that did not fit the ring: the channel ran kRingPairs ahead of
+    // the combined output. A slip is one realignment; slipSamples counts the
+    // channel samples it discarded.
+    [[nodiscard]] uint64_t combinedBlocks() const { return combinedBlocks_->value(); }
+    [[nodiscard]] uint64_t droppedBlocks()  const { return droppedBlocks_->value(); }
+    [[nodiscard]] uint64_t slips()          const { return slips_->value(); }
+    [[nodiscard]] uint64_t slipSamples()    const { return slipSamples_->value(); }
+
+    // Per-bin coherence / phase of ch0 · conj(ch1) and angle of arrival of the
+    // detected signals, emitted as crossSpectrum() at most once per
+    // intervalMs. Needs ≥ 2 channels (otherwise ignored); call before the
+    // stream starts. Throws std::invalid_argument for bad options.
+    void setCrossSpectrum(const CrossSpectrum::Options& options, int intervalMs = kCrossIntervalMs);
+    [[nodiscard]] bool crossSpectrumEnabled() const { return cross_ != nullptr; }
+    [[nodiscard]] uint64_t crossSpectra() const { return crossFrames_->value(); }
+    // RF centre for the frames; onRetune() updates it. Thread-safe.
+    void setCentreFrequency(double hz) { centreHz_.store(hz, std::memory_order_relaxed); }
+
+    // Exports the counters above and the phase metric as stand_combiner_*
+    // series with these labels (e.g. the device id). Call once, any thread.
+    void publishMetrics(const Metrics::Labels& labels);
+
     // IPipelineHandler — uses meta.channel.channelIndex to route blocks.
     void processBlock(const float* iq, int count, double sampleRateHz) override;
     void processBlock(const float* iq, int count, double sampleRateHz,
@@ -61,38 +188,120 @@ public:
 
 signals:
     // rawDeg        — мгновенная фаза ch0·conj(ch1), [-180, 180]
-    // calibratedDeg — rawDeg - phaseCalibrationDeg_, приведено к [-180, 180]
+    // calibratedDeg — rawDeg - phaseCalibrationDeg(1), приведено к [-180, 180]
     // coherence     — |Σ cross| / √(Σ|c0|²·Σ|c1|²), [0, 1]; >0.9 = хорошая когерентность
-    void phaseMetric(double rawDeg, double calibratedDeg, double coherence);
+    // delaySamples  — delaySamples(1): задержка ch1 относительно ch0, отсчёты
+    void phaseMetric(double rawDeg, double calibratedDeg, double coherence, double delaySamples);
 
     // Per-channel I/Q imbalance.
     // amplitudeDb   — 10·log10(ΣI² / ΣQ²); 0 dB = идеальный баланс, ±знак = какая компонента сильнее
     // crossCorr     — ΣI·Q / √(ΣI²·ΣQ²), [-1, 1]; |x|<0.01 = ортогонально; большой модуль = I/Q не ортогональны
     void iqImbalance(int channelIndex, double amplitudeDb, double crossCorr);
 
+    // setCrossSpectrum(): emitted from a pool thread — connect queued.
+    void crossSpectrum(CrossSpectrumFrame frame);
+
 private:
-    struct Slot {
-        std::vector<float> data;
-        uint64_t           timestamp{0};
-        bool               filled{false};
+    // Timestamps are mapped onto one increasing "position" axis:
+    // (epoch << kEpochShift) | timestamp. Ring index = position & kRingMask.
+    static constexpr int      kEpochShift = 48;
+    static constexpr uint64_t kTsMask     = (uint64_t{1} << kEpochShift) - 1;
+    static constexpr uint64_t kRingMask   = kRingPairs - 1;
+
+    struct Channel {
+        std::vector<float>    ring;         // kRingPairs interleaved pairs
+        std::atomic<uint64_t> begin{0};     // held positions: [begin, end)
+        std::atomic<uint64_t> end{0};
+        std::atomic<double>   sampleRateHz{0.0};
+        // This channel's thread only.
+        uint64_t              epoch{0};     // 0 = not anchored yet
+        uint64_t              head{0};      // == end
+        uint64_t              runBegin{0};  // == begin
+        // The run's positions are hardware counters (anchored on, or later
+        // confirmed by, a non-zero timestamp); published with begin.
+        std::atomic<bool>     timed{false};
+        // Combining thread only: this pass's snapshot of begin / end.
+        uint64_t              seenBegin{0};
+        uint64_t              seenEnd{0};
+        bool                  seenTimed{false};
     };
 
-    void resetSlots();
-    void combineAndDispatch(int count, double sampleRateHz);
-    void accumulatePhase(int count);   // called under mutex_ in combineAndDispatch
-    void accumulateChannelIq(int idx, const float* data, int count);  // under mutex_
-    void maybeEmitPhase();              // called under mutex_
-    void maybeEmitIqImbalance();        // called under mutex_
+    // Pending resets, applied by the next combine (the only thread that owns
+    // the accumulators).
+    static constexpr uint32_t kResetSums    = 0x1;
+    static constexpr uint32_t kResetCadence = 0x2;
+
+    void abandonRun(Channel& chan);
+    void startRun(Channel& chan, uint64_t pos, bool timed);
+    void write(Channel& chan, uint64_t pos, const float* iq, int count);
+    void requestCombine();
+    void combineAvailable();
+    void applyResets();
+    void newEpoch();
+    [[nodiscard]] const float* at(int ch, uint64_t pos) const;
+    // Combining thread only.
+    [[nodiscard]] const float* compensated(int ch, uint64_t pos, int count);
+    void maybeEstimateDelay(uint64_t pos, int count);
+    void estimateDelays(int count);     // delay pool
+    void maybeCollectCross(uint64_t pos, int count);   // combining thread only
+    void computeCross(double sampleRateHz);            // delay pool
+    void updateWeights(int count, double sampleRateHz);   // combining thread only
+    void combineAndDispatch(uint64_t timestamp, int count, double sampleRateHz);   // reads source_
+    void accumulatePhase(int count);    // combining thread only, reads source_
+    void accumulateChannelIq(int idx, const float* data, int count);  // combining thread only
+    void maybeEmitPhase();              // combining thread only
+    void maybeEmitIqImbalance();        // combining thread only
 
     Pipeline*         output_;
     int               channelCount_;
-    std::vector<Slot> slots_;
-    std::vector<float> gainScale_;   // linear: 1/10^(gain/20)
-    std::vector<float> combined_;    // output buffer
-    std::mutex         mutex_;
+    std::vector<Channel> channels_;
+    std::atomic<uint64_t> epoch_{1};
+    std::atomic<uint64_t> readPos_{0};         // combined up to here
+    std::atomic<uint32_t> combineRequests_{0};
+    std::atomic<uint32_t> pendingReset_{0};
+    std::vector<std::atomic<float>> gainScale_;   // linear: 1/10^(gain/20)
+    std::atomic<Mode>  mode_{Mode::Average};
+    std::atomic<bool>  tracking_{false};
+    std::vector<float> combined_;    // output buffer, kMaxDispatchPairs pairs
+    std::shared_ptr<Metrics::Counter> combinedBlocks_ = std::make_shared<Metrics::Counter>();
+    std::shared_ptr<Metrics::Counter> droppedBlocks_  = std::make_shared<Metrics::Counter>();
+    std::shared_ptr<Metrics::Counter> slips_          = std::make_shared<Metrics::Counter>();
+    std::shared_ptr<Metrics::Counter> slipSamples_    = std::make_shared<Metrics::Counter>();
+    std::shared_ptr<Metrics::Gauge>   coherenceGauge_ = std::make_shared<Metrics::Gauge>();
+    std::shared_ptr<Metrics::Gauge>   phaseGauge_     = std::make_shared<Metrics::Gauge>();
+    std::shared_ptr<Metrics::Counter> delayEstimates_ = std::make_shared<Metrics::Counter>();
+    std::shared_ptr<Metrics::Gauge>   delayGauge_     = std::make_shared<Metrics::Gauge>();
+
+    // ── Inter-channel delay ─────────────────────────────────────────────────
+    std::atomic<bool>                 compensate_{false};
+    std::vector<std::atomic<double>>  delaySamples_;   // per channel, [0] unused
+    std::vector<const float*>         source_;         // this chunk, per channel
+    std::vector<FractionalDelay>      delayFilters_;   // combining thread only
+    std::vector<std::vector<float>>   delayed_;        // compensated chunk, ch ≥ 1
+    std::vector<float>                stage_;          // filter input across the ring wrap
+    // The estimate task owns delayInput_ and delayEstimator_ while delayBusy_.
+    QThreadPool*                      delayPool_{nullptr};
+    QFuture<void>                     delayTask_;
+    std::atomic<bool>                 delayBusy_{false};
+    std::vector<std::vector<float>>   delayInput_;     // kDelayPairs per channel
+    DelayEstimator                    delayEstimator_;
+
+    // ── Cross-spectrum ──────────────────────────────────────────────────────
+    // The task owns crossInput_ and cross_ while crossBusy_.
+    std::unique_ptr<CrossSpectrum>    cross_;
+    int                               crossIntervalMs_{kCrossIntervalMs};
+    QFuture<void>                     crossTask_;
+    std::atomic<bool>                 crossBusy_{false};
+    std::array<std::vector<float>, 2> crossInput_;     // ch0, ch1
+    int                               crossFill_{0};   // pairs collected, combining thread only
+    uint64_t                          crossNext_{0};   // position the next pair must have
+    std::atomic<double>               centreHz_{0.0};
+    std::shared_ptr<Metrics::Counter> crossFrames_ = std::make_shared<Metrics::Counter>();
 
     // ── Межканальная метрика ────────────────────────────────────────────────
-    std::atomic<double> phaseCalibrationDeg_{0.0};
+    std::vector<std::atomic<double>> calibrationDeg_;   // per channel, [0] unused
+    std::vector<std::atomic<double>> trackedDeg_;       // arg trackCross_, for calibrateNow()
+    std::atomic<bool>   haveTracked_{false};
     double  crossReAcc_{0.0};
     double  crossImAcc_{0.0};
     double  pow0Acc_{0.0};
@@ -101,6 +310,16 @@ private:
     using Clock = std::chrono::steady_clock;
     Clock::time_point lastEmit_{};
     static constexpr int kEmitIntervalMs = 200;
+    Clock::time_point lastDelayRun_{};
+    Clock::time_point lastCrossRun_{};
+
+    // ── Combining weights (combining thread only) ──────────────────────────
+    std::vector<std::complex<double>> chunkCross_;   // Σ x0·conj(x_c), this chunk
+    std::vector<double>               chunkPower_;   // Σ |x_c|², this chunk
+    std::vector<std::complex<double>> trackCross_;   // E[x0·conj(x_c)], one-pole
+    std::vector<double>               trackPower_;   // E[|x_c|²], one-pole
+    bool                              tracked_{false};
+    std::vector<std::complex<float>>  weights_;
 
     // ── Per-channel I/Q imbalance accumulators ───────────────────────────────
     std::vector<double> sumI2_;   // ΣI²  per channel
@@ -0,0 +1,280 @@
+#include "IqFileReader.h"
+#include "IqFormats.h"
+#include "Logger.h"
+#include "SigMfWriter.h"
+
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+// Recordings routinely exceed 2 GiB; MinGW's fseek/ftell take a 32-bit long.
+int seek64(FILE* f, int64_t offset, int origin) {
+#ifdef _WIN32
+    return _fseeki64(f, offset, origin);
+#else
+    return fseeko(f, static_cast<off_t>(offset), origin);
+#endif
+}
+
+int64_t tell64(FILE* f) {
+#ifdef _WIN32
+    return _ftelli64(f);
+#else
+    return static_cast<int64_t>(ftello(f));
+#endif
+}
+}  // namespace
+
+IqFileReader::~IqFileReader() {
+    close();
+}
+
+std::optional<IqFileReader::Format> IqFileReader::formatForPath(const QString& path) {
+    const QString p = path.toLower();
+    for (Format f : {Format::Float32, Format::Float64, Format::Int16,
+                     Format::Int12, Format::Int8, Format::Int16Lossless}) {
+        if (p.endsWith(RecordingSettings::extensionFor(f)))
+            return f;
+    }
+    return std::nullopt;
+}
+
+bool IqFileReader::open(const QString& path) {
+    const auto fmt = formatForPath(path);
+    if (!fmt) {
+        LOG_ERROR("IqFileReader: unknown I/Q extension: " + path.toStdString());
+        return false;
+    }
+
+    float scale = IqFormats::kInt8Scale;
+    if (*fmt == Format::Int8) {
+        QFile side(path + QStringLiteral(".json"));
+        if (side.open(QIODevice::ReadOnly)) {
+            const QJsonObject o = QJsonDocument::fromJson(side.readAll()).object();
+            scale = static_cast<float>(o.value(QStringLiteral("scale")).toDouble(scale));
+        } else {
+            LOG_WARN("IqFileReader: no scale sidecar for " + path.toStdString()
+                     + ", assuming 1/127");
+        }
+    }
+    if (!open(path, *fmt, scale)) return false;
+    loadSigMf(path);
+    return true;
+}
+
+void IqFileReader::loadSigMf(const QString& path) {
+    QFile meta(SigMfWriter::metaPathFor(path));
+    if (!meta.open(QIODevice::ReadOnly)) return;
+    const QJsonObject root   = QJsonDocument::fromJson(meta.readAll()).object();
+    const QJsonObject global = root.value(QStringLiteral("global")).toObject();
+    sigmfRateHz_ = global.value(QStringLiteral("core:sample_rate")).toDouble();
+    const QJsonArray captures = root.value(QStringLiteral("captures")).toArray();
+    if (!captures.isEmpty())
+        sigmfCenterHz_ = captures.at(0).toObject().value(QStringLiteral("core:frequency")).toDouble();
+    for (const auto& v : global.value(QStringLiteral("stand:index")).toArray()) {
+        const QJsonArray e = v.toArray();
+        if (e.size() < 4) continue;
+        const TimePoint p{static_cast<qint64>(e.at(3).toDouble()),
+                          static_cast<uint64_t>(e.at(0).toDouble())};
+        if (!timeIndex_.empty() && p.unixMs < timeIndex_.back().unixMs) continue;
+        timeIndex_.push_back(p);
+    }
+    if (sigmfRateHz_ <= 0.0) timeIndex_.clear();
+}
+
+bool IqFileReader::open(const QString& path, Format format, float int8Scale) {
+    close();
+    file_ = std::fopen(path.toStdString().c_str(), "rb");
+    if (!file_) {
+        LOG_ERROR("IqFileReader: cannot open " + path.toStdString());
+        return false;
+    }
+    format_    = format;
+    int8Scale_ = int8Scale;
+    position_  = 0;
+
+    if (format_ == Format::Int16Lossless) {
+        if (!loadIndex()) {
+            LOG_ERROR("IqFileReader: not a .ci16z file: " + path.toStdString());
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    seek64(file_, 0, SEEK_END);
+    const int64_t bytes = tell64(file_);
+    seek64(file_, 0, SEEK_SET);
+    totalPairs_ = bytes > 0 ? static_cast<uint64_t>(bytes) / IqFormats::bytesPerPair(format_) : 0;
+    return true;
+}
+
+bool IqFileReader::loadIndex() {
+    index_.clear();
+    blockStart_.clear();
+    nextBlock_ = cachePairs_ = cachePos_ = 0;
+    totalPairs_ = 0;
+
+    uint8_t head[IqCodec::kFileHeaderBytes];
+    uint32_t blockPairs = 0;
+    if (std::fread(head, 1, sizeof(head), file_) != sizeof(head)
+        || !IqCodec::parseFileHeader(head, blockPairs))
+        return false;
+
+    seek64(file_, 0, SEEK_END);
+    const uint64_t size = static_cast<uint64_t>(std::max<int64_t>(tell64(file_), 0));
+
+    // Index from the trailer when the recording was closed cleanly.
+    if (size >= IqCodec::kFileHeaderBytes + IqCodec::kTrailerBytes) {
+        uint8_t tail[IqCodec::kTrailerBytes];
+        seek64(file_, static_cast<int64_t>(size - sizeof(tail)), SEEK_SET);
+        if (std::fread(tail, 1, sizeof(tail), file_) == sizeof(tail)) {
+            uint64_t indexOffset = 0;
+            uint32_t count = 0;
+            const bool     ok         = IqCodec::parseTrailer(tail, indexOffset, count);
+            const uint64_t indexBytes = uint64_t(count) * IqCodec::kIndexEntryBytes;
+            if (ok && indexOffset + indexBytes + sizeof(tail) == size) {
+                raw_.resize(indexBytes);
+                seek64(file_, static_cast<int64_t>(indexOffset), SEEK_SET);
+                if (std::fread(raw_.data(), 1, raw_.size(), file_) == raw_.size()) {
+                    index_.reserve(count);
+                    for (uint32_t i = 0; i < count; ++i)
+                        index_.push_back(IqCodec::parseIndexEntry(
+                            raw_.data() + i * IqCodec::kIndexEntryBytes));
+                }
+            }
+        }
+    }
+
+    // Otherwise (crash, dropped index) walk the block headers.
+    if (index_.empty()) {
+        uint64_t offset = IqCodec::kFileHeaderBytes;
+        uint8_t  bh[IqCodec::kBlockHeaderBytes];
+        IqCodec::BlockHeader h;
+        while (offset + sizeof(bh) <= size) {
+            seek64(file_, static_cast<int64_t>(offset), SEEK_SET);
+            if (std::fread(bh, 1, sizeof(bh), file_) != sizeof(bh)
+                || !IqCodec::parseBlockHeader(bh, h)
+                || offset + sizeof(bh) + h.payloadBytes > size)
+                break;
+            index_.push_back({offset, totalPairs_, h.pairs});
+            totalPairs_ += h.pairs;
+            offset += sizeof(bh) + h.payloadBytes;
+        }
+        if (!index_.empty())
+            LOG_WARN("IqFileReader: .ci16z index missing, rebuilt from "
+                     + std::to_string(index_.size()) + " blocks");
+        totalPairs_ = 0;
+    }
+
+    blockStart_.reserve(index_.size());
+    for (const auto& e : index_) {
+        blockStart_.push_back(totalPairs_);
+        totalPairs_ += e.pairs;
+    }
+    return true;
+}
+
+bool IqFileReader::loadBlock(std::size_t block) {
+    if (block >= index_.size()) return false;
+    uint8_t bh[IqCodec::kBlockHeaderBytes];
+    IqCodec::BlockHeader h;
+    if (seek64(file_, static_cast<int64_t>(index_[block].fileOffset), SEEK_SET) != 0
+        || std::fread(bh, 1, sizeof(bh), file_) != sizeof(bh)
+        || !IqCodec::parseBlockHeader(bh, h)) {
+        LOG_WARN("IqFileReader: bad .ci16z block header #" + std::to_string(block));
+        return false;
+    }
+    raw_.resize(h.payloadBytes);
+    int16_.resize(static_cast<std::size_t>(h.pairs) * 2);
+    if (std::fread(raw_.data(), 1, raw_.size(), file_) != raw_.size()
+        || !IqCodec::decodeBlock(h, raw_.data(), int16_.data())) {
+        LOG_WARN("IqFileReader: corrupt .ci16z block #" + std::to_string(block));
+        return false;
+    }
+    cachePairs_ = h.pairs;
+    cachePos_   = 0;
+    nextBlock_  = block + 1;
+    return true;
+}
+
+int IqFileReader::readCompressed(float* iq, int maxPairs) {
+    int done = 0;
+    while (done < maxPairs) {
+        if (cachePos_ >= cachePairs_ && !loadBlock(nextBlock_)) break;
+        const std::size_t take = std::min<std::size_t>(cachePairs_ - cachePos_,
+                                                       static_cast<std::size_t>(maxPairs - done));
+        IqFormats::int16ToFloat(int16_.data() + 2 * cachePos_, iq + 2 * done, 2 * take);
+        cachePos_ += take;
+        done      += static_cast<int>(take);
+    }
+    position_ += static_cast<uint64_t>(done);
+    return done;
+}
+
+void IqFileReader::close() {
+    if (!file_) return;
+    std::fclose(file_);
+    file_ = nullptr;
+    timeIndex_.clear();
+    sigmfRateHz_   = 0.0;
+    sigmfCenterHz_ = 0.0;
+}
+
+bool IqFileReader::seek(uint64_t pair) {
+    if (!file_ || pair > totalPairs_) return false;
+    if (format_ == Format::Int16Lossless) {
+        cachePairs_ = cachePos_ = 0;
+        nextBlock_  = index_.size();
+        if (pair < totalPairs_) {
+            const auto it = std::upper_bound(blockStart_.begin(), blockStart_.end(), pair);
+            const std::size_t block = static_cast<std::size_t>(it - blockStart_.begin()) - 1;
+            if (!loadBlock(block)) return false;
+            cachePos_ = static_cast<std::size_t>(pair - blockStart_[block]);
+        }
+        position_ = pair;
+        return true;
+    }
+    const uint64_t offset = pair * IqFormats::bytesPerPair(format_);
+    if (seek64(file_, static_cast<int64_t>(offset), SEEK_SET) != 0) return false;
+    position_ = pair;
+    return true;
+}
+
+bool IqFileReader::seekToTime(qint64 unixMs) {
+    if (!file_ || timeIndex_.empty()) return false;
+
+    // Entries are ~kIndexIntervalSec apart: guess the slot, then walk.
+    const qint64 t0 = timeIndex_.front().unixMs;
+    const qint64 step = static_cast<qint64>(SigMfWriter::kIndexIntervalSec * 1000.0);
+    const auto last = static_cast<qint64>(timeIndex_.size()) - 1;
+    std::size_t i = static_cast<std::size_t>(std::clamp<qint64>((unixMs - t0) / step, 0, last));
+    while (i > 0 && timeIndex_[i].unixMs > unixMs) --i;
+    while (i + 1 < timeIndex_.size() && timeIndex_[i + 1].unixMs <= unixMs) ++i;
+
+    const TimePoint& p = timeIndex_[i];
+    uint64_t pair = p.sample;
+    if (unixMs > p.unixMs)
+        pair += static_cast<uint64_t>(static_cast<double>(unixMs - p.unixMs)
+                                      * sigmfRateHz_ / 1000.0);
+    if (i + 1 < timeIndex_.size()) pair = std::min(pair, timeIndex_[i + 1].sample);
+    return seek(std::min(pair, totalPairs_));
+}
+
+int IqFileReader::read(float* iq, int maxPairs) {
+    if (!file_ || maxPairs <= 0) return 0;
+    if (format_ == Format::Int16Lossless) return readCompressed(iq, maxPairs);
+
+    const std::size_t bpp = IqFormats::bytesPerPair(format_);
+    raw_.resize(static_cast<std::size_t>(maxPairs) * bpp);
+    const std::size_t got   = std::fread(raw_.data(), 1, raw_.size(), file_);
+    const std::size_t pairs = got / bpp;
+    IqFormats::decodePairs(format_, raw_.data(), iq, pairs, int8Scale_);
+    position_ += pairs;
+    return static_cast<int>(pairs);
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "../Core/RecordingSettings.h"
+#include "IqCodec.h"
+
+#include <QString>
+#include <cstdint>
+#include <cstdio>
+#include <optional>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// IqFileReader — reads raw I/Q recordings back as normalised float32 blocks,
+// the same representation RxWorker dispatches into a Pipeline.
+//
+// Format comes from the extension (.cf32 / .cf64 / .ci16 / .ci12 / .ci8 /
+// .ci16z); .ci8 takes its scale from the "<file>.json" sidecar written by
+// RawFileHandler. .ci16, .ci12 and .ci16z decode to exactly the floats the
+// live stream produced. .ci16z seeks through the IqCodec block index.
+// When a `.sigmf-meta` sidecar (SigMfWriter) exists, seekToTime() jumps to a
+// wall-clock time through its stand:index without scanning the data.
+// ---------------------------------------------------------------------------
+class IqFileReader {
+public:
+    using Format = RecordingSettings::RawFormat;
+
+    IqFileReader() = default;
+    ~IqFileReader();
+
+    IqFileReader(const IqFileReader&) = delete;
+    IqFileReader& operator=(const IqFileReader&) = delete;
+
+    [[nodiscard]] static std::optional<Format> formatForPath(const QString& path);
+
+    bool open(const QString& path);
+    bool open(const QString& path, Format format, float int8Scale);
+    void close();
+
+    [[nodiscard]] bool     isOpen()     const { return file_ != nullptr; }
+    [[nodiscard]] Format   format()     const { return format_; }
+    [[nodiscard]] uint64_t totalPairs() const { return totalPairs_; }
+    [[nodiscard]] uint64_t position()   const { return position_; }
+    [[nodiscard]] float    int8Scale()  const { return int8Scale_; }
+
+    // Reads up to maxPairs I/Q pairs into iq (2 × maxPairs floats).
+    // Returns the number of pairs read; 0 at end of file.
+    int  read(float* iq, int maxPairs);
+    bool seek(uint64_t pair);
+
+    // Seeks to the sample recorded at unixMs (ms since epoch), clamped to the
+    // recording. False when the file has no SigMF time index.
+    bool seekToTime(qint64 unixMs);
+    [[nodiscard]] bool hasTimeIndex() const { return !timeIndex_.empty(); }
+
+    // From the SigMF sidecar (core:sample_rate, first capture's
+    // core:frequency); 0 when there is none.
+    [[nodiscard]] double sigmfSampleRate() const { return sigmfRateHz_; }
+    [[nodiscard]] double sigmfCenterHz()   const { return sigmfCenterHz_; }
+
+private:
+    struct TimePoint {
+        qint64   unixMs{0};
+        uint64_t sample{0};
+    };
+
+    void loadSigMf(const QString& path);
+    bool loadIndex();
+    bool loadBlock(std::size_t block);
+    int  readCompressed(float* iq, int maxPairs);
+
+    FILE*    file_{nullptr};
+    Format   format_{Format::Float32};
+    float    int8Scale_{1.0f / 128.0f};
+    uint64_t totalPairs_{0};
+    uint64_t position_{0};
+
+    std::vector<uint8_t> raw_;     // file bytes for one read()
+    std::vector<int16_t> int16_;   // ci12 unpack scratch / ci16z decoded block
+
+    // .ci16z only
+    std::vector<IqCodec::IndexEntry> index_;
+    std::vector<uint64_t> blockStart_;   // first file pair of each block
+    std::size_t nextBlock_{0};
+    std::size_t cachePairs_{0};
+    std::size_t cachePos_{0};
+
+    // SigMF sidecar: stand:index ascending in time, rate and first LO
+    std::vector<TimePoint> timeIndex_;
+    double sigmfRateHz_{0.0};
+    double sigmfCenterHz_{0.0};
+};
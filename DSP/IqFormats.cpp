@@ -0,0 +1,113 @@
+#include "IqFormats.h"
+
+#include <cmath>
+#include <cstring>
+
+namespace IqFormats {
+
+std::size_t bytesPerPair(Format f) {
+    switch (f) {
+        case Format::Float32: return 2 * sizeof(float);
+        case Format::Float64: return 2 * sizeof(double);
+        case Format::Int16:
+        case Format::Int16Lossless: return 2 * sizeof(int16_t);   // decoded size
+        case Format::Int12:   return 3;
+        case Format::Int8:    return 2;
+    }
+    return 2 * sizeof(float);
+}
+
+std::size_t floatToInt16(const float* in, int16_t* out, std::size_t values) {
+    std::size_t clipped = 0;
+    for (std::size_t i = 0; i < values; ++i) {
+        float v = std::nearbyint(in[i] * 32768.0f);
+        if (v > 32767.0f)       { v = 32767.0f;  ++clipped; }
+        else if (v < -32768.0f) { v = -32768.0f; ++clipped; }
+        out[i] = static_cast<int16_t>(v);
+    }
+    return clipped;
+}
+
+void int16ToFloat(const int16_t* in, float* out, std::size_t values) {
+    // RxWorker's conversion — replay is bit-identical to live.
+    for (std::size_t i = 0; i < values; ++i)
+        out[i] = in[i] * (1.0f / 32768.0f);
+}
+
+std::size_t packInt12(const int16_t* iq, uint8_t* out, std::size_t pairs) {
+    std::size_t clipped = 0;
+    auto to12 = [&clipped](int16_t v) {
+        int r = (static_cast<int>(v) + 8) >> 4;   // round to nearest
+        if (r > 2047) { r = 2047; ++clipped; }
+        return static_cast<uint32_t>(r) & 0xFFFu;
+    };
+    for (std::size_t n = 0; n < pairs; ++n) {
+        const uint32_t i = to12(iq[2 * n]);
+        const uint32_t q = to12(iq[2 * n + 1]);
+        out[3 * n]     = static_cast<uint8_t>(i & 0xFF);
+        out[3 * n + 1] = static_cast<uint8_t>((i >> 8) | ((q & 0xF) << 4));
+        out[3 * n + 2] = static_cast<uint8_t>(q >> 4);
+    }
+    return clipped;
+}
+
+void unpackInt12(const uint8_t* in, int16_t* iq, std::size_t pairs) {
+    for (std::size_t n = 0; n < pairs; ++n) {
+        const uint32_t b0 = in[3 * n], b1 = in[3 * n + 1], b2 = in[3 * n + 2];
+        const uint32_t i = b0 | ((b1 & 0x0F) << 8);
+        const uint32_t q = (b1 >> 4) | (b2 << 4);
+        // Sign-extend 12 → 16 bits, back to int16 full scale.
+        iq[2 * n]     = static_cast<int16_t>(static_cast<uint16_t>(i << 4));
+        iq[2 * n + 1] = static_cast<int16_t>(static_cast<uint16_t>(q << 4));
+    }
+}
+
+std::size_t floatToInt8(const float* in, int8_t* out, std::size_t values, float scale) {
+    const float inv = scale > 0.0f ? 1.0f / scale : 0.0f;
+    std::size_t clipped = 0;
+    for (std::size_t i = 0; i < values; ++i) {
+        float v = std::nearbyint(in[i] * inv);
+        if (v > 127.0f)       { v = 127.0f;  ++clipped; }
+        else if (v < -128.0f) { v = -128.0f; ++clipped; }
+        out[i] = static_cast<int8_t>(v);
+    }
+    return clipped;
+}
+
+void int8ToFloat(const int8_t* in, float* out, std::size_t values, float scale) {
+    for (std::size_t i = 0; i < values; ++i)
+        out[i] = in[i] * scale;
+}
+
+void decodePairs(Format f, const uint8_t* in, float* out, std::size_t pairs, float int8Scale) {
+    const std::size_t vals = 2 * pairs;
+    switch (f) {
+        case Format::Float32:
+            std::memcpy(out, in, vals * sizeof(float));
+            break;
+        case Format::Float64: {
+            const auto* d = reinterpret_cast<const double*>(in);
+            for (std::size_t i = 0; i < vals; ++i) out[i] = static_cast<float>(d[i]);
+            break;
+        }
+        case Format::Int16:
+        case Format::Int16Lossless:
+            int16ToFloat(reinterpret_cast<const int16_t*>(in), out, vals);
+            break;
+        case Format::Int12: {
+            constexpr std::size_t kBatch = 1024;
+            int16_t tmp[2 * kBatch];
+            for (std::size_t done = 0; done < pairs; done += kBatch) {
+                const std::size_t n = std::min(kBatch, pairs - done);
+                unpackInt12(in + 3 * done, tmp, n);
+                int16ToFloat(tmp, out + 2 * done, 2 * n);
+            }
+            break;
+        }
+        case Format::Int8:
+            int8ToFloat(reinterpret_cast<const int8_t*>(in), out, vals, int8Scale);
+            break;
+    }
+}
+
+}  // namespace IqFormats
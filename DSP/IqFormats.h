@@ -0,0 +1,47 @@
+#pragma once
+
+#include "../Core/RecordingSettings.h"
+
+#include <cstddef>
+#include <cstdint>
+
+// ---------------------------------------------------------------------------
+// IqFormats — sample conversions for the compact raw I/Q formats.
+//
+//   .ci16  int16 I, int16 Q (little-endian). The device's own samples; float
+//          blocks are ×32768 + round + saturate, which is bit-exact for blocks
+//          that came from int16 (RxWorker divides by 32768).
+//   .ci12  12-bit two's complement I and Q packed into 3 bytes:
+//            b0 = I[7:0], b1 = Q[3:0]<<4 | I[11:8], b2 = Q[11:4]
+//          Values are int16 >> 4 (rounded, saturated) — lossless for the
+//          LMS7002M's 12-bit ADC, which arrives left-aligned in int16.
+//   .ci8   int8 I, int8 Q; sample = value × scale. The scale is fixed per
+//          file before the first sample (RecordingSettings::int8FullScaleDbfs,
+//          default kInt8Scale: float full scale 1.0 ↔ 127) and stored in the
+//          "<file>.json" sidecar and the SigMF `stand:scale` field.
+// ---------------------------------------------------------------------------
+namespace IqFormats {
+
+using Format = RecordingSettings::RawFormat;
+
+constexpr float kInt8Scale = 1.0f / 127.0f;   // default .ci8 scale
+
+[[nodiscard]] std::size_t bytesPerPair(Format f);
+
+// float [-1, 1) → int16; returns the number of saturated values.
+std::size_t floatToInt16(const float* in, int16_t* out, std::size_t values);
+void        int16ToFloat(const int16_t* in, float* out, std::size_t values);
+
+// int16 pairs ⇄ packed 12-bit; pack returns the number of saturated values.
+std::size_t packInt12(const int16_t* iq, uint8_t* out, std::size_t pairs);
+void        unpackInt12(const uint8_t* in, int16_t* iq, std::size_t pairs);
+
+// float → int8 with out = round(in / scale); returns saturated values.
+std::size_t floatToInt8(const float* in, int8_t* out, std::size_t values, float scale);
+void        int8ToFloat(const int8_t* in, float* out, std::size_t values, float scale);
+
+// File bytes of an uncompressed format → normalised float pairs, exactly as
+// IqFileReader returns them (Int16Lossless is read as decoded int16).
+void decodePairs(Format f, const uint8_t* in, float* out, std::size_t pairs, float int8Scale);
+
+}  // namespace IqFormats
@@ -0,0 +1,24 @@
+#include "LinearResampler.h"
+
+QVector<float> LinearResampler::process(const QVector<float>& in, double inRate, double outRate) {
+    if (in.isEmpty() || inRate <= 0 || outRate <= 0) return {};
+
+    const double step = inRate / outRate;
+    QVector<float> out;
+    out.reserve(static_cast<int>(in.size() * outRate / inRate) + 2);
+
+    while (true) {
+        const int i = static_cast<int>(phase);
+        if (i >= in.size()) {
+            phase -= in.size();
+            prev = in.back();
+            break;
+        }
+        const float s0   = (i == 0) ? prev : in[i - 1];
+        const float s1   = in[i];
+        const float frac = static_cast<float>(phase - static_cast<double>(i));
+        out.push_back(s0 + frac * (s1 - s0));
+        phase += step;
+    }
+    return out;
+}
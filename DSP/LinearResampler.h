@@ -0,0 +1,18 @@
+#pragma once
+
+#include <QVector>
+
+// ---------------------------------------------------------------------------
+// LinearResampler — streaming linear-interpolation resampler for mono audio
+// (demodulator SR → sound-card rate in FmAudioOutput).
+//
+// Phase and the last input sample carry over between process() calls, so a
+// stream split into blocks resamples without seams.
+// ---------------------------------------------------------------------------
+struct LinearResampler {
+    double phase{0.0};
+    float  prev{0.0f};
+
+    QVector<float> process(const QVector<float>& in, double inRate, double outRate);
+    void reset() { phase = 0.0; prev = 0.0f; }
+};
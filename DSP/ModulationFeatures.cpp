@@ -0,0 +1,226 @@
+#include "ModulationFeatures.h"
+#include "DspUtils.h"
+#include "FftProcessor.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace {
+
+constexpr double kTwoPi = 2.0 * dsp::kPi;
+
+double wrapPhase(double p) {
+    if (p >  dsp::kPi) p -= kTwoPi;
+    if (p < -dsp::kPi) p += kTwoPi;
+    return p;
+}
+
+template <std::size_t N>
+double sum(const std::array<double, N>& lanes) {
+    return std::accumulate(lanes.begin(), lanes.end(), 0.0);
+}
+
+float db(double ratio) {
+    return static_cast<float>(10.0 * std::log10(std::max(ratio, 1e-20)));
+}
+
+// 0.5 .. 0.99 as the smallest normalised distance to a threshold grows.
+float confidenceFrom(double margin) {
+    return static_cast<float>(0.5 + 0.49 * std::tanh(std::max(margin, 0.0)));
+}
+
+constexpr const char* kNames[ModulationFeatures::kCount] = {
+    "power_db", "c20", "c40", "c41", "c42",
+    "sigma_aa", "sigma_ap", "sigma_dp", "sigma_f_hz",
+    "gamma_max", "peak_share", "symmetry", "snr_db",
+};
+
+}  // namespace
+
+const char* ModulationFeatures::name(int index) {
+    return index >= 0 && index < kCount ? kNames[index] : "";
+}
+
+// ---------------------------------------------------------------------------
+// Features
+// ---------------------------------------------------------------------------
+bool ModulationFeatures::compute(const float* iq, int count, double sampleRateHz, Vector& out) {
+    if (count < kMinSamples || sampleRateHz <= 0.0) return false;
+    const auto n = static_cast<std::size_t>(count);
+    re_.resize(n);
+    im_.resize(n);
+    amp_.resize(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        re_[i] = iq[2 * i];
+        im_[i] = iq[2 * i + 1];
+    }
+
+    // ── Moments: E[x²], E[|x|²], E[x⁴], E[x³x*], E[|x|⁴] ─────────────────────
+    std::array<double, kLanes> s20r{}, s20i{}, s21{}, s40r{}, s40i{}, s41r{}, s41i{}, s42{};
+    std::array<double, kLanes> sAmp{};
+    auto moments = [&](std::size_t i, std::size_t l) {
+        const double a = re_[i], b = im_[i];
+        const double p   = a * a + b * b;
+        const double x2r = a * a - b * b, x2i = 2.0 * a * b;
+        s20r[l] += x2r;               s20i[l] += x2i;
+        s21[l]  += p;
+        s40r[l] += x2r * x2r - x2i * x2i;
+        s40i[l] += 2.0 * x2r * x2i;
+        s41r[l] += x2r * p;           s41i[l] += x2i * p;
+        s42[l]  += p * p;
+        amp_[i]  = static_cast<float>(std::sqrt(p));
+        sAmp[l] += amp_[i];
+    };
+    const std::size_t full = n - n % kLanes;
+    for (std::size_t i = 0; i < full; i += kLanes)
+        for (std::size_t l = 0; l < kLanes; ++l) moments(i + l, l);
+    for (std::size_t i = full; i < n; ++i) moments(i, 0);
+
+    const double inv = 1.0 / static_cast<double>(n);
+    const double m20r = sum(s20r) * inv, m20i = sum(s20i) * inv;
+    const double m21  = sum(s21) * inv;
+    const double m40r = sum(s40r) * inv, m40i = sum(s40i) * inv;
+    const double m41r = sum(s41r) * inv, m41i = sum(s41i) * inv;
+    const double m42  = sum(s42) * inv;
+    const double meanAmp = sum(sAmp) * inv;
+
+    const double c20sq = m20r * m20r + m20i * m20i;
+    const double c40r  = m40r - 3.0 * (m20r * m20r - m20i * m20i);
+    const double c40i  = m40i - 3.0 * (2.0 * m20r * m20i);
+    const double c41r  = m41r - 3.0 * m20r * m21;
+    const double c41i  = m41i - 3.0 * m20i * m21;
+    const double c42   = m42 - c20sq - 2.0 * m21 * m21;
+    const double p2    = std::max(m21 * m21, 1e-30);
+
+    out[kPowerDb] = db(m21);
+    out[kC20]     = static_cast<float>(std::sqrt(c20sq) / std::max(m21, 1e-30));
+    out[kC40]     = static_cast<float>(std::hypot(c40r, c40i) / p2);
+    out[kC41]     = static_cast<float>(std::hypot(c41r, c41i) / p2);
+    out[kC42]     = static_cast<float>(c42 / p2);
+
+    // ── Amplitude ────────────────────────────────────────────────────────────
+    const float invMean = meanAmp > 0.0 ? static_cast<float>(1.0 / meanAmp) : 0.0f;
+    std::array<double, kLanes> sAcn{};
+    seg_.assign(2 * n, 0.0f);   // centred amplitude as a real I/Q signal
+    for (std::size_t i = 0; i < full; i += kLanes)
+        for (std::size_t l = 0; l < kLanes; ++l) {
+            const float acn = amp_[i + l] * invMean - 1.0f;
+            seg_[2 * (i + l)] = acn;
+            sAcn[l] += static_cast<double>(acn) * acn;
+        }
+    for (std::size_t i = full; i < n; ++i) {
+        const float acn = amp_[i] * invMean - 1.0f;
+        seg_[2 * i] = acn;
+        sAcn[0] += static_cast<double>(acn) * acn;
+    }
+    out[kSigmaAa] = static_cast<float>(std::sqrt(sum(sAcn) * inv));
+
+    // ── Phase and instantaneous frequency (non-weak samples) ────────────────
+    const float weak = static_cast<float>(kWeak * meanAmp);
+    dphi_.clear();
+    double sumD = 0.0, sumD2 = 0.0;
+    for (std::size_t i = 1; i < n; ++i) {
+        if (amp_[i] < weak || amp_[i - 1] < weak) continue;
+        // arg(x[i] · conj(x[i-1]))
+        const double d = std::atan2(double(im_[i]) * re_[i - 1] - double(re_[i]) * im_[i - 1],
+                                    double(re_[i]) * re_[i - 1] + double(im_[i]) * im_[i - 1]);
+        dphi_.push_back(static_cast<float>(d));
+        sumD += d; sumD2 += d * d;
+    }
+    double sigmaDp = 0.0, sigmaAp = 0.0, sigmaF = 0.0;
+    const auto used = static_cast<double>(dphi_.size());
+    if (dphi_.size() > 1) {
+        const double meanD = sumD / used;
+        sigmaF = std::sqrt(std::max(sumD2 / used - meanD * meanD, 0.0)) * sampleRateHz / kTwoPi;
+
+        // Non-linear phase: increments minus their mean (the carrier offset),
+        // accumulated and wrapped.
+        double phi = 0.0, sP = 0.0, sP2 = 0.0, sA = 0.0;
+        for (const float d : dphi_) {
+            phi = wrapPhase(phi + d - meanD);
+            sP  += phi;
+            sP2 += phi * phi;
+            sA  += std::abs(phi);
+        }
+        const double mP = sP / used, mA = sA / used;
+        sigmaDp = std::sqrt(std::max(sP2 / used - mP * mP, 0.0));
+        sigmaAp = std::sqrt(std::max(sP2 / used - mA * mA, 0.0));
+    }
+    out[kSigmaAp]  = static_cast<float>(sigmaAp);
+    out[kSigmaDp]  = static_cast<float>(sigmaDp);
+    out[kSigmaFHz] = static_cast<float>(sigmaF);
+
+    // ── Spectra ──────────────────────────────────────────────────────────────
+    int nfft = kSpectrumSize;
+    while (nfft > count) nfft /= 2;
+
+    welch(seg_.data(), count, nfft, envPsd_);
+    out[kGammaMax] = *std::max_element(envPsd_.begin(), envPsd_.end());
+
+    welch(iq, count, nfft, psd_);
+    const double total = std::accumulate(psd_.begin(), psd_.end(), 0.0);
+    const int    peak  = static_cast<int>(std::max_element(psd_.begin(), psd_.end()) - psd_.begin());
+    double nearPeak = 0.0;
+    for (int k = std::max(0, peak - 2); k <= std::min(nfft - 1, peak + 2); ++k) nearPeak += psd_[k];
+
+    const int dc = nfft / 2;
+    double upper = 0.0, lower = 0.0;
+    for (int k = dc + 2; k < nfft; ++k) upper += psd_[k];
+    for (int k = 0; k <= dc - 2; ++k)   lower += psd_[k];
+
+    sorted_ = psd_;
+    std::nth_element(sorted_.begin(), sorted_.begin() + nfft / 2, sorted_.end());
+    const double median = sorted_[nfft / 2];
+
+    out[kPeakShare] = total > 0.0 ? static_cast<float>(nearPeak / total) : 0.0f;
+    out[kSymmetry]  = upper + lower > 0.0 ? static_cast<float>((upper - lower) / (upper + lower)) : 0.0f;
+    out[kSnrDb]     = median > 0.0 ? db(total / nfft / median) : 0.0f;
+    return true;
+}
+
+void ModulationFeatures::welch(const float* iq, int count, int nfft, std::vector<float>& psd) {
+    const int segments = count / nfft;
+    psd.assign(static_cast<std::size_t>(nfft), 0.0f);
+    spec_.resize(static_cast<std::size_t>(nfft));
+    for (int s = 0; s < segments; ++s) {
+        FftProcessor::powerSpectrum(iq + 2 * static_cast<std::size_t>(s) * nfft, nfft, spec_.data());
+        for (int k = 0; k < nfft; ++k) psd[k] += spec_[k];
+    }
+    const float inv = 1.0f / static_cast<float>(segments);
+    for (float& p : psd) p *= inv;
+}
+
+// ---------------------------------------------------------------------------
+// Decision tree
+// ---------------------------------------------------------------------------
+ClassifierProtocol::Type ModulationFeatures::classify(const Vector& f, float* confidence) {
+    using ClassifierProtocol::Type;
+    auto result = [confidence](Type t, double margin) {
+        if (confidence) *confidence = confidenceFrom(margin);
+        return t;
+    };
+
+    if (f[kSnrDb] < kMinSnrDb)
+        return result(Type::Unknown, (kMinSnrDb - f[kSnrDb]) / 3.0);
+    double margin = (f[kSnrDb] - kMinSnrDb) / 3.0;
+
+    // A line in the envelope spectrum means amplitude modulation; broadband
+    // envelope noise alone does not.
+    const bool   envelope = f[kGammaMax] > kEnvelopeTone;
+    const bool   carrier  = f[kPeakShare] > kCarrierShare;
+    margin = std::min<double>(margin, std::abs(std::log10(std::max(f[kGammaMax], 1e-9f) / kEnvelopeTone)));
+    margin = std::min<double>(margin, std::abs(f[kPeakShare] - kCarrierShare) / 0.3);
+
+    if (!envelope) {
+        if (carrier) return result(Type::CW, margin);
+        margin = std::min<double>(margin, std::abs(std::log2(std::max(f[kSigmaFHz], 1.0f) / kWideFmSigmaFHz)));
+        return result(f[kSigmaFHz] > kWideFmSigmaFHz ? Type::FM : Type::NFM, margin);
+    }
+    if (carrier) return result(Type::AM, margin);
+
+    margin = std::min<double>(margin, std::abs(std::abs(f[kSymmetry]) - kSidebandSymmetry) / kSidebandSymmetry);
+    if (std::abs(f[kSymmetry]) > kSidebandSymmetry)
+        return result(f[kSymmetry] > 0.0f ? Type::USB : Type::LSB, margin);
+    return result(Type::AM, margin);   // suppressed-carrier DSB
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "../Core/ClassifierProtocol.h"
+
+#include <array>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// ModulationFeatures — classic automatic-modulation-classification features
+// of one narrowband snippet (ClassifierHandler's decimated channel).
+//
+//   kPowerDb     10·log10 C21 (mean |x|², dBFS)
+//   kC20         |C20| / C21            — carrier / real-valued signals → 1
+//   kC40, kC41   |C40| / C21², |C41| / C21²
+//   kC42         C42 / C21²             — constant envelope −1, Gaussian 0
+//   kSigmaAa     std of the centred normalised amplitude (a / mean a − 1)
+//   kSigmaAp     std of |centred non-linear phase|  } non-weak samples only
+//   kSigmaDp     std of the centred non-linear phase} (a ≥ kWeak · mean a)
+//   kSigmaFHz    std of the instantaneous frequency, Hz
+//   kGammaMax    peak line of the centred-amplitude spectrum (an envelope
+//                tone of depth m reads m² / 4)
+//   kPeakShare   share of the power within ±2 bins of the strongest bin
+//   kSymmetry    (P_upper − P_lower) / (P_upper + P_lower), DC bins excluded
+//   kSnrDb       mean / median of the spectrum (≈ 0 dB for noise alone)
+//
+// Cumulants are from moments of the raw snippet (no mean removal), so a
+// carrier shows up in C20. Spectra are Welch averages of kSpectrumSize-point
+// Hann FFTs (smaller for short snippets). The moment and amplitude passes
+// run over de-interleaved arrays with kLanes independent accumulators so
+// they vectorise without reassociating sums.
+//
+// classify() is a small decision tree over these features for running
+// without the Python service: no envelope tone → CW (carrier) or FM / NFM
+// (by σ_f); envelope tone → AM (carrier) or USB / LSB (by symmetry).
+//
+// Not thread-safe (scratch buffers); one instance per thread.
+// ---------------------------------------------------------------------------
+class ModulationFeatures {
+public:
+    enum Index : int {
+        kPowerDb, kC20, kC40, kC41, kC42,
+        kSigmaAa, kSigmaAp, kSigmaDp, kSigmaFHz,
+        kGammaMax, kPeakShare, kSymmetry, kSnrDb,
+        kCount
+    };
+    using Vector = std::array<float, kCount>;
+
+    static constexpr int    kMinSamples   = 32;
+    static constexpr int    kSpectrumSize = 256;
+    static constexpr int    kLanes        = 8;
+    static constexpr double kWeak         = 0.5;
+
+    // Decision-tree thresholds.
+    static constexpr float kMinSnrDb         = 3.0f;
+    static constexpr float kEnvelopeTone     = 0.01f;   // kGammaMax: depth 0.2
+    static constexpr float kCarrierShare     = 0.6f;    // kPeakShare
+    static constexpr float kWideFmSigmaFHz   = 5'000.0f;
+    static constexpr float kSidebandSymmetry = 0.4f;
+
+    // False (out untouched) when count < kMinSamples.
+    bool compute(const float* iq, int count, double sampleRateHz, Vector& out);
+
+    [[nodiscard]] static const char* name(int index);
+
+    // confidence: 0.5 .. 0.99 from the distance to the thresholds crossed.
+    [[nodiscard]] static ClassifierProtocol::Type classify(const Vector& f, float* confidence = nullptr);
+
+private:
+    void welch(const float* iq, int count, int nfft, std::vector<float>& psd);
+
+    std::vector<float> re_, im_, amp_, dphi_;
+    std::vector<float> seg_, spec_, psd_, envPsd_, sorted_;
+};
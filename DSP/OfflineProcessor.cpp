@@ -0,0 +1,290 @@
+#include "OfflineProcessor.h"
+#include "BandpassExporter.h"
+#include "BaseDemodulator.h"
+#include "IqFormats.h"
+#include "Logger.h"
+
+#include <QThreadPool>
+#include <QtConcurrent/QtConcurrent>
+
+#include <algorithm>
+#include <deque>
+
+namespace {
+
+// Runs count jobs with at most `window` in flight: start(k) and finish(job)
+// on the calling thread in order, work(job) on the pool. Stops submitting
+// after the first failure but always drains what is in flight.
+template <typename Job, typename Start, typename Work, typename Finish>
+bool runInOrder(QThreadPool* pool, std::size_t window, std::size_t count,
+                Start&& start, Work&& work, Finish&& finish) {
+    struct Slot {
+        std::unique_ptr<Job> job;
+        QFuture<void>        done;
+    };
+    std::deque<Slot> inFlight;
+    bool ok = true;
+
+    auto retire = [&] {
+        Slot& s = inFlight.front();
+        s.done.waitForFinished();
+        if (ok) ok = finish(*s.job);
+        inFlight.pop_front();
+    };
+
+    for (std::size_t k = 0; k < count && ok; ++k) {
+        if (inFlight.size() >= window) retire();
+        if (!ok) break;
+        std::unique_ptr<Job> job = start(k);
+        if (!job) { ok = false; break; }
+        Job* j = job.get();
+        QFuture<void> f = QtConcurrent::run(pool, [&work, j] { work(*j); });
+        inFlight.push_back({std::move(job), f});
+    }
+    while (!inFlight.empty()) retire();
+    return ok;
+}
+
+}  // namespace
+
+OfflineProcessor::OfflineProcessor() = default;
+
+OfflineProcessor::OfflineProcessor(const Options& options)
+    : options_(options)
+{}
+
+OfflineProcessor::~OfflineProcessor() {
+    close();
+}
+
+// ---------------------------------------------------------------------------
+// Input
+// ---------------------------------------------------------------------------
+bool OfflineProcessor::open(const QString& path) {
+    close();
+    if (!probe_.open(path)) return false;
+    path_      = path;
+    format_    = probe_.format();
+    int8Scale_ = probe_.int8Scale();
+
+    // .ci16z blocks are variable-length; those go through IqFileReader.
+    if (format_ != RecordingSettings::RawFormat::Int16Lossless && probe_.totalPairs() > 0) {
+        file_.setFileName(path);
+        if (file_.open(QIODevice::ReadOnly))
+            map_ = file_.map(0, static_cast<qint64>(probe_.totalPairs()
+                                                    * IqFormats::bytesPerPair(format_)));
+        if (!map_) {
+            LOG_WARN("OfflineProcessor: cannot map " + path.toStdString()
+                     + ", using buffered reads");
+            file_.close();
+        }
+    }
+    return true;
+}
+
+void OfflineProcessor::close() {
+    if (map_) file_.unmap(const_cast<uchar*>(map_));
+    map_ = nullptr;
+    file_.close();
+    probe_.close();
+}
+
+bool OfflineProcessor::Cursor::forEach(uint64_t from, uint64_t to,
+                                       const std::function<void(const float*, int)>& fn) {
+    const int block = std::max(1, owner_.options_.blockPairs);
+    buf_.resize(2 * static_cast<std::size_t>(block));
+
+    if (owner_.map_) {
+        const std::size_t bpp = IqFormats::bytesPerPair(owner_.format_);
+        for (uint64_t p = from; p < to;) {
+            const int n = static_cast<int>(std::min<uint64_t>(block, to - p));
+            IqFormats::decodePairs(owner_.format_, owner_.map_ + p * bpp, buf_.data(),
+                                   static_cast<std::size_t>(n), owner_.int8Scale_);
+            fn(buf_.data(), n);
+            p += static_cast<uint64_t>(n);
+        }
+        return true;
+    }
+
+    if (from >= to) return true;
+    if (!reader_) {
+        reader_ = std::make_unique<IqFileReader>();
+        if (!reader_->open(owner_.path_, owner_.format_, owner_.int8Scale_)) return false;
+    }
+    if (reader_->position() != from && !reader_->seek(from)) return false;
+    for (uint64_t p = from; p < to;) {
+        const int want = static_cast<int>(std::min<uint64_t>(block, to - p));
+        const int n    = reader_->read(buf_.data(), want);
+        if (n != want) {
+            LOG_ERROR("OfflineProcessor: short read at pair " + std::to_string(p)
+                      + " in " + owner_.path_.toStdString());
+            return false;
+        }
+        fn(buf_.data(), n);
+        p += static_cast<uint64_t>(n);
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Scheduling
+// ---------------------------------------------------------------------------
+std::vector<OfflineProcessor::Span> OfflineProcessor::makeSpans(int64_t alignment,
+                                                                int64_t warmup) const {
+    // Keep the overlap a small fraction of each chunk.
+    const int64_t wanted = std::max(options_.chunkPairs, 4 * warmup);
+    const auto    chunk  = static_cast<uint64_t>(std::max(alignment, wanted / alignment * alignment));
+    const auto    warm   = static_cast<uint64_t>(warmup);
+
+    std::vector<Span> spans;
+    const uint64_t total = totalPairs();
+    for (uint64_t b = 0; b < total; b += chunk)
+        spans.push_back({b > warm ? b - warm : 0, b, std::min(total, b + chunk)});
+    return spans;
+}
+
+QThreadPool* OfflineProcessor::pool() const {
+    return options_.pool ? options_.pool : QThreadPool::globalInstance();
+}
+
+std::size_t OfflineProcessor::window() const {
+    return static_cast<std::size_t>(std::max(2, 2 * pool()->maxThreadCount()));
+}
+
+// ---------------------------------------------------------------------------
+// Demodulation
+// ---------------------------------------------------------------------------
+bool OfflineProcessor::demodulate(const BaseDemodulator& prototype, const Sink& audio,
+                                  Stats* stats) {
+    if (!isOpen()) return false;
+
+    struct Job {
+        Span span;
+        std::unique_ptr<BaseDemodulator> demod;
+        std::unique_ptr<BaseDemodulator> atBegin;   // state at span.begin
+        std::vector<float> out;
+        bool ok{true};
+    };
+
+    const std::vector<Span> spans = makeSpans(prototype.chunkAlignment(),
+                                              prototype.warmupSamples());
+    Stats    st;
+    Cursor   seq(*this);                           // pre-pass and resync, caller thread
+    auto     input  = prototype.inputState();
+    uint64_t prePos = 0;
+    std::unique_ptr<BaseDemodulator> truth;        // exact state at the next chunk's begin
+
+    const bool ok = runInOrder<Job>(pool(), window(), spans.size(),
+        [&](std::size_t k) -> std::unique_ptr<Job> {
+            auto job  = std::make_unique<Job>();
+            job->span = spans[k];
+            if (!seq.forEach(prePos, job->span.warmBegin,
+                             [&](const float* iq, int n) { input.advance(iq, n); }))
+                return nullptr;
+            prePos     = job->span.warmBegin;
+            job->demod = prototype.clone();
+            job->demod->setInputState(input);
+            return job;
+        },
+        [this](Job& job) {
+            Cursor in(*this);
+            job.ok = in.forEach(job.span.warmBegin, job.span.begin,
+                                [&](const float* iq, int n) { (void)job.demod->pushBlock(iq, n); });
+            if (job.span.begin > 0) job.atBegin = job.demod->clone();
+            job.ok = job.ok && in.forEach(job.span.begin, job.span.end,
+                [&](const float* iq, int n) {
+                    const QVector<float> a = job.demod->pushBlock(iq, n);
+                    job.out.insert(job.out.end(), a.begin(), a.end());
+                });
+        },
+        [&](Job& job) -> bool {
+            if (!job.ok) return false;
+            ++st.chunks;
+            st.warmupPairs += static_cast<int64_t>(job.span.begin - job.span.warmBegin);
+
+            if (!truth || job.atBegin->sameState(*truth)) {
+                if (!job.out.empty()) audio(job.out.data(), job.out.size());
+                truth = std::move(job.demod);
+                return true;
+            }
+
+            // The overlap did not reproduce the exact state: continue the
+            // sequential one over this chunk instead.
+            ++st.resynced;
+            LOG_WARN("OfflineProcessor: chunk at pair " + std::to_string(job.span.begin)
+                     + " did not converge in the overlap — rerun in order");
+            return seq.forEach(job.span.begin, job.span.end, [&](const float* iq, int n) {
+                const QVector<float> a = truth->pushBlock(iq, n);
+                if (!a.isEmpty()) audio(a.constData(), static_cast<std::size_t>(a.size()));
+            });
+        });
+
+    if (stats) *stats = st;
+    LOG_INFO("OfflineProcessor: demodulated " + std::to_string(totalPairs()) + " pairs in "
+             + std::to_string(st.chunks) + " chunks (" + std::to_string(st.resynced)
+             + " resynced)");
+    return ok;
+}
+
+// ---------------------------------------------------------------------------
+// Band-pass export
+// ---------------------------------------------------------------------------
+bool OfflineProcessor::bandpass(double inputSampleRateHz, double stationOffsetHz,
+                                double bandwidthHz, double outputSampleRateHz,
+                                const Sink& iq, Stats* stats) {
+    if (!isOpen()) return false;
+
+    struct Job {
+        Span span;
+        BandpassExporter*  exp{nullptr};
+        std::vector<float> out;
+        bool ok{true};
+    };
+
+    // One exporter per in-flight slot: job k reuses k − window's, which
+    // runInOrder has retired by the time k starts.
+    std::vector<std::unique_ptr<BandpassExporter>> exporters;
+    for (std::size_t i = 0; i < window(); ++i)
+        exporters.push_back(std::make_unique<BandpassExporter>(
+            inputSampleRateHz, stationOffsetHz, bandwidthHz, outputSampleRateHz));
+
+    const int64_t dec    = exporters.front()->decimation();
+    const int64_t warmup = (BandpassExporter::firTaps() - 1 + dec - 1) / dec * dec;
+    const std::vector<Span> spans = makeSpans(dec, warmup);
+
+    Stats    st;
+    dsp::Nco nco    = exporters.front()->nco();   // NCO phase is data-independent
+    uint64_t ncoPos = 0;
+
+    const bool ok = runInOrder<Job>(pool(), window(), spans.size(),
+        [&](std::size_t k) -> std::unique_ptr<Job> {
+            auto job  = std::make_unique<Job>();
+            job->span = spans[k];
+            for (; ncoPos < job->span.warmBegin; ++ncoPos) nco.advance();
+            job->exp = exporters[k % exporters.size()].get();
+            job->exp->resetDspState();
+            job->exp->setNco(nco);
+            return job;
+        },
+        [this](Job& job) {
+            Cursor in(*this);
+            std::vector<float> discard;
+            job.ok = in.forEach(job.span.warmBegin, job.span.begin,
+                                [&](const float* x, int n) {
+                                    discard.clear();
+                                    job.exp->process(x, n, discard);
+                                });
+            job.ok = job.ok && in.forEach(job.span.begin, job.span.end,
+                                          [&](const float* x, int n) { job.exp->process(x, n, job.out); });
+        },
+        [&](Job& job) -> bool {
+            if (!job.ok) return false;
+            ++st.chunks;
+            st.warmupPairs += static_cast<int64_t>(job.span.begin - job.span.warmBegin);
+            if (!job.out.empty()) iq(job.out.data(), job.out.size());
+            return true;
+        });
+
+    if (stats) *stats = st;
+    return ok;
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "../Core/RecordingSettings.h"
+#include "IqFileReader.h"
+
+#include <QFile>
+#include <QString>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+class BaseDemodulator;
+class QThreadPool;
+
+// ---------------------------------------------------------------------------
+// OfflineProcessor — demodulates / band-passes a whole recording on every
+// core, with output bit-identical to one instance fed block by block.
+//
+// The recording (any IqFileReader format; uncompressed ones memory-mapped)
+// is cut into chunks. Each chunk runs on its own demodulator clone or
+// BandpassExporter on a QThreadPool, preceded by an overlap that refills
+// the filter delay lines and lets the IIR stages settle; the overlap's
+// output is discarded. State that needs the full history is carried exactly:
+//
+//   caller thread:  input-rate pre-pass (DC blocker + NCO phase, ~2 % of the
+//                   work) → chunk k's start state → submit k → … → stitch
+//   pool threads:   overlap + chunk k → audio / I/Q
+//
+// Stitching runs on the caller in recording order. For demodulators it
+// compares chunk k's state at its first sample with chunk k−1's state at
+// its last (BaseDemodulator::sameState); on a mismatch chunk k is rerun
+// sequentially from k−1's state, so the guarantee never rests on the
+// overlap being long enough. Squelch, if set on the prototype, is honoured
+// the same way. The band-pass chain has no IIR stage and is exact by
+// construction.
+//
+// At most 2 × pool threads chunks are in flight, so memory stays bounded
+// for recordings of any length.
+// ---------------------------------------------------------------------------
+class OfflineProcessor {
+public:
+    struct Options {
+        int64_t      chunkPairs{int64_t{1} << 23};   // ~4 s at 2 MSps
+        int          blockPairs{1 << 16};            // pushBlock() size
+        QThreadPool* pool{nullptr};                  // nullptr = global pool
+    };
+
+    struct Stats {
+        int     chunks{0};
+        int     resynced{0};      // failed the boundary check, rerun in order
+        int64_t warmupPairs{0};   // overlap, processed twice
+    };
+
+    // Receives output in recording order, on the calling thread.
+    using Sink = std::function<void(const float* data, std::size_t values)>;
+
+    OfflineProcessor();
+    explicit OfflineProcessor(const Options& options);
+    ~OfflineProcessor();
+
+    OfflineProcessor(const OfflineProcessor&) = delete;
+    OfflineProcessor& operator=(const OfflineProcessor&) = delete;
+
+    bool open(const QString& path);
+    void close();
+
+    [[nodiscard]] bool     isOpen()          const { return probe_.isOpen(); }
+    [[nodiscard]] uint64_t totalPairs()      const { return probe_.totalPairs(); }
+    [[nodiscard]] double   sigmfSampleRate() const { return probe_.sigmfSampleRate(); }
+    [[nodiscard]] double   sigmfCenterHz()   const { return probe_.sigmfCenterHz(); }
+
+    // prototype: a freshly constructed demodulator (never fed), configured
+    // as the sequential run would be. audio: mono samples at its audio rate.
+    bool demodulate(const BaseDemodulator& prototype, const Sink& audio,
+                    Stats* stats = nullptr);
+
+    // iq: interleaved pairs, as BandpassExporter writes them.
+    bool bandpass(double inputSampleRateHz, double stationOffsetHz,
+                  double bandwidthHz, double outputSampleRateHz,
+                  const Sink& iq, Stats* stats = nullptr);
+
+private:
+    struct Span {
+        uint64_t warmBegin{0};   // overlap start
+        uint64_t begin{0};       // first sample whose output is kept
+        uint64_t end{0};
+    };
+
+    // Reads through the memory map, or a per-caller IqFileReader for .ci16z.
+    class Cursor {
+    public:
+        explicit Cursor(const OfflineProcessor& owner) : owner_(owner) {}
+        // Calls fn(iq, pairs) for consecutive blocks of [from, to).
+        bool forEach(uint64_t from, uint64_t to,
+                     const std::function<void(const float*, int)>& fn);
+
+    private:
+        const OfflineProcessor&       owner_;
+        std::unique_ptr<IqFileReader> reader_;
+        std::vector<float>            buf_;
+    };
+
+    [[nodiscard]] std::vector<Span> makeSpans(int64_t alignment, int64_t warmup) const;
+    [[nodiscard]] QThreadPool* pool() const;
+    [[nodiscard]] std::size_t  window() const;
+
+    Options      options_;
+    QString      path_;
+    IqFileReader probe_;                  // metadata; never read
+    QFile        file_;
+    const uchar* map_{nullptr};           // whole file, uncompressed formats
+    RecordingSettings::RawFormat format_{RecordingSettings::RawFormat::Float32};
+    float        int8Scale_{1.0f / 128.0f};
+};
@@ -0,0 +1,310 @@
+#include "PreTriggerRecorder.h"
+#include "Logger.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <string>
+
+PreTriggerRecorder::PreTriggerRecorder(const Config& cfg, PathBuilder builder, QObject* parent)
+    : QObject(parent)
+    , cfg_(cfg)
+    , builder_(std::move(builder))
+{}
+
+PreTriggerRecorder::~PreTriggerRecorder() {
+    stopWriter();
+}
+
+QString PreTriggerRecorder::reasonName(int r) {
+    switch (r) {
+        case kManual:     return QStringLiteral("manual");
+        case kPower:      return QStringLiteral("power");
+        case kClassifier: return QStringLiteral("classifier");
+        default:          return QStringLiteral("none");
+    }
+}
+
+double PreTriggerRecorder::bufferedSeconds() const {
+    if (sampleRate_ <= 0.0) return 0.0;
+    return static_cast<double>(std::min(writePos_.load(), preSamples_)) / sampleRate_;
+}
+
+// ---------------------------------------------------------------------------
+// Triggers
+// ---------------------------------------------------------------------------
+void PreTriggerRecorder::trigger() {
+    requestTrigger(kManual);
+}
+
+void PreTriggerRecorder::onClassification(const QString& type, double confidence) {
+    if (cfg_.classifierType.isEmpty()) return;
+    if (type.compare(cfg_.classifierType, Qt::CaseInsensitive) != 0) return;
+    if (confidence < cfg_.classifierMinConfidence) return;
+    requestTrigger(kClassifier);
+}
+
+void PreTriggerRecorder::requestTrigger(Reason r) {
+    // First reason wins until the worker picks it up.
+    int expected = kNone;
+    pendingReason_.compare_exchange_strong(expected, r);
+}
+
+// Worker thread. Extends a running capture, or publishes a new one for the
+// writer: start/reason are stored before captureEnd_ (release), which is the
+// only field the writer polls.
+void PreTriggerRecorder::startOrExtend(uint64_t triggerPos, Reason r) {
+    const uint64_t end = triggerPos + postSamples_;
+
+    uint64_t cur = captureEnd_.load(std::memory_order_acquire);
+    while (cur != 0) {
+        if (end <= cur) return;
+        if (captureEnd_.compare_exchange_weak(cur, end, std::memory_order_acq_rel))
+            return;
+    }
+
+    captureStart_.store(triggerPos > preSamples_ ? triggerPos - preSamples_ : 0,
+                        std::memory_order_relaxed);
+    captureReason_.store(r, std::memory_order_relaxed);
+    captureEnd_.store(end, std::memory_order_release);
+    wake_.notify_one();
+}
+
+// ---------------------------------------------------------------------------
+// Lifecycle
+// ---------------------------------------------------------------------------
+void PreTriggerRecorder::onStreamStarted(double sampleRateHz) {
+    armed_.store(false);
+    stopWriter();
+
+    sampleRate_  = sampleRateHz;
+    preSamples_  = static_cast<uint64_t>(std::max(0.0, cfg_.preSeconds) * sampleRateHz);
+    postSamples_ = std::max<uint64_t>(1,
+                       static_cast<uint64_t>(std::max(0.0, cfg_.postSeconds) * sampleRateHz));
+    capacity_    = preSamples_ + static_cast<uint64_t>(kSlackSeconds * sampleRateHz);
+
+    // All allocation happens here, never in processBlock().
+    if (cfg_.int16Storage) {
+        ring32_ = {};
+        ring16_.assign(2 * capacity_, 0);
+    } else {
+        ring16_ = {};
+        ring32_.assign(2 * capacity_, 0.0f);
+    }
+    const std::size_t bytesPerValue = cfg_.format == Format::Float64 ? sizeof(double) : sizeof(float);
+    outBuf_.resize(2 * kWriteChunk * bytesPerValue);
+
+    writePos_.store(0);
+    maxBlock_.store(0);
+    pendingReason_.store(kNone);
+    captureEnd_.store(0);
+    lost_.store(0);
+    powerAbove_ = false;
+
+    if (cfg_.powerBandwidthHz > 0.0) {
+        const double floorHz    = sampleRateHz / kMaxPowerSegment;
+        const double resolution = std::max(cfg_.powerBandwidthHz, floorHz);
+        if (resolution > cfg_.powerBandwidthHz)
+            LOG_WARN("PreTriggerRecorder: power trigger bandwidth "
+                     + std::to_string(cfg_.powerBandwidthHz) + " Hz raised to "
+                     + std::to_string(resolution) + " Hz (one segment per block)");
+        bank_.configure({cfg_.powerOffsetHz}, sampleRateHz, resolution);
+    } else {
+        bank_.configure({}, sampleRateHz, 0.0);
+    }
+
+    stopping_.store(false);
+    writer_ = std::thread(&PreTriggerRecorder::writerLoop, this);
+    armed_.store(true, std::memory_order_release);
+
+    const std::size_t ramBytes = 2 * capacity_ * (cfg_.int16Storage ? sizeof(int16_t) : sizeof(float));
+    LOG_INFO("PreTriggerRecorder: armed, pre=" + std::to_string(cfg_.preSeconds)
+             + " s, post=" + std::to_string(cfg_.postSeconds) + " s, ring "
+             + std::to_string(ramBytes >> 20) + " MiB"
+             + (cfg_.int16Storage ? " (int16)" : " (float32)"));
+}
+
+void PreTriggerRecorder::onStreamStopped() {
+    // The writer drains whatever is already in the ring before exiting.
+    armed_.store(false);
+    stopWriter();
+    ring16_ = {};
+    ring32_ = {};
+    capacity_ = 0;
+}
+
+void PreTriggerRecorder::onRetune(double /*newFreqHz*/) {
+    // Band power is measured relative to the LO — re-arm the edge detector.
+    powerAbove_ = false;
+}
+
+void PreTriggerRecorder::stopWriter() {
+    if (!writer_.joinable()) return;
+    stopping_.store(true);
+    wake_.notify_one();
+    writer_.join();
+}
+
+// ---------------------------------------------------------------------------
+// processBlock — RX path: ring copy + trigger detection only
+// ---------------------------------------------------------------------------
+void PreTriggerRecorder::processBlock(const float* iq, int count, double /*sampleRateHz*/) {
+    if (!armed_.load(std::memory_order_acquire) || count <= 0) return;
+
+    if (static_cast<uint64_t>(count) > capacity_ / 2) {
+        // Block larger than the ring is useful for — keep only its tail.
+        iq   += 2 * (count - capacity_ / 2);
+        count = static_cast<int>(capacity_ / 2);
+    }
+    if (count > maxBlock_.load(std::memory_order_relaxed))
+        maxBlock_.store(count, std::memory_order_relaxed);
+
+    const uint64_t pos   = writePos_.load(std::memory_order_relaxed);
+    const uint64_t start = pos % capacity_;
+    const uint64_t first = std::min<uint64_t>(count, capacity_ - start);
+
+    auto store = [this](uint64_t dst, const float* src, uint64_t n) {
+        if (cfg_.int16Storage) {
+            int16_t* out = ring16_.data() + 2 * dst;
+            for (uint64_t i = 0; i < 2 * n; ++i) {
+                const float v = std::clamp(src[i] * 32767.0f, -32768.0f, 32767.0f);
+                out[i] = static_cast<int16_t>(std::lrint(v));
+            }
+        } else {
+            std::copy(src, src + 2 * n, ring32_.data() + 2 * dst);
+        }
+    };
+    store(start, iq, first);
+    if (first < static_cast<uint64_t>(count))
+        store(0, iq + 2 * first, count - first);
+
+    writePos_.store(pos + count, std::memory_order_release);
+
+    // ── Triggers ─────────────────────────────────────────────────────────────
+    int reason = pendingReason_.exchange(kNone, std::memory_order_acq_rel);
+
+    if (bank_.channelCount() > 0 && bank_.process(iq, count)) {
+        const double p = bank_.powerDb()[0];
+        if (!powerAbove_ && p >= cfg_.powerThresholdDb) {
+            powerAbove_ = true;
+            if (reason == kNone) reason = kPower;
+        } else if (powerAbove_ && p < cfg_.powerThresholdDb - kRearmDb) {
+            powerAbove_ = false;
+        }
+    }
+
+    if (reason != kNone)
+        startOrExtend(pos, static_cast<Reason>(reason));
+}
+
+// ---------------------------------------------------------------------------
+// Writer thread
+// ---------------------------------------------------------------------------
+void PreTriggerRecorder::writerLoop() {
+    using namespace std::chrono_literals;
+
+    while (true) {
+        uint64_t end = captureEnd_.load(std::memory_order_acquire);
+        if (end == 0) {
+            if (stopping_.load()) break;
+            std::unique_lock lock(wakeMutex_);
+            wake_.wait_for(lock, 20ms, [this] {
+                return stopping_.load() || captureEnd_.load() != 0;
+            });
+            continue;
+        }
+
+        const uint64_t start  = captureStart_.load(std::memory_order_relaxed);
+        const QString  reason = reasonName(captureReason_.load(std::memory_order_relaxed));
+        const QString  path   = builder_ ? builder_(reason) : QString();
+
+        FILE* f = path.isEmpty() ? nullptr : std::fopen(path.toStdString().c_str(), "wb");
+        if (!f) {
+            LOG_ERROR("PreTriggerRecorder: cannot open: " + path.toStdString());
+            captureEnd_.store(0);
+            continue;
+        }
+        std::setvbuf(f, nullptr, _IOFBF, 1 << 20);
+        LOG_INFO("PreTriggerRecorder: " + reason.toStdString() + " trigger → "
+                 + path.toStdString());
+        emit captureStarted(path, reason);
+
+        const uint64_t lostBefore = lost_.load();
+        uint64_t rd = start;
+        while (true) {
+            end = captureEnd_.load(std::memory_order_acquire);
+            const uint64_t target = std::min(writePos_.load(std::memory_order_acquire), end);
+            if (rd < target) {
+                rd = dumpRange(f, rd, target);
+                continue;
+            }
+            // Finishing races with a trigger extending the end — the CAS decides.
+            if (rd >= end && captureEnd_.compare_exchange_strong(end, 0))
+                break;
+            if (stopping_.load()) {
+                captureEnd_.store(0);
+                break;
+            }
+            std::unique_lock lock(wakeMutex_);
+            wake_.wait_for(lock, 5ms);
+        }
+        std::fclose(f);
+
+        const uint64_t lost    = lost_.load() - lostBefore;
+        const uint64_t written = rd - start - lost;
+        LOG_INFO("PreTriggerRecorder: closed " + path.toStdString() + ", "
+                 + std::to_string(written) + " samples"
+                 + (lost ? ", " + std::to_string(lost) + " lost" : std::string()));
+        emit captureFinished(path, static_cast<qint64>(written), static_cast<qint64>(lost));
+    }
+}
+
+// Copies up to kWriteChunk pairs of [from, to) out of the ring and writes them.
+// Returns the new read position. Samples the producer has overwritten (or may
+// be overwriting with its next block) are skipped and counted as lost; the
+// window is re-checked after the copy since the producer never waits for us.
+uint64_t PreTriggerRecorder::dumpRange(FILE* f, uint64_t from, uint64_t to) {
+    const uint64_t guard = capacity_ - std::min<uint64_t>(capacity_,
+                               static_cast<uint64_t>(maxBlock_.load(std::memory_order_relaxed)));
+    auto oldestValid = [&] {
+        const uint64_t wp = writePos_.load(std::memory_order_acquire);
+        return wp > guard ? wp - guard : 0;
+    };
+
+    uint64_t oldest = oldestValid();
+    if (from < oldest) {
+        lost_.fetch_add(std::min(oldest, to) - from);
+        from = std::min(oldest, to);
+    }
+    if (from >= to) return to;
+
+    const uint64_t n = std::min(to - from, kWriteChunk);
+    const bool     f64 = cfg_.format == Format::Float64;
+    auto* out32 = reinterpret_cast<float*>(outBuf_.data());
+    auto* out64 = reinterpret_cast<double*>(outBuf_.data());
+
+    for (uint64_t i = 0; i < n; ++i) {
+        const uint64_t idx = 2 * ((from + i) % capacity_);
+        float re, im;
+        if (cfg_.int16Storage) {
+            re = ring16_[idx]     * (1.0f / 32767.0f);
+            im = ring16_[idx + 1] * (1.0f / 32767.0f);
+        } else {
+            re = ring32_[idx];
+            im = ring32_[idx + 1];
+        }
+        if (f64) { out64[2 * i] = re; out64[2 * i + 1] = im; }
+        else     { out32[2 * i] = re; out32[2 * i + 1] = im; }
+    }
+
+    // Anything the producer reached during the copy is torn — drop it.
+    uint64_t skip = 0;
+    oldest = oldestValid();
+    if (oldest > from) {
+        skip = std::min(oldest - from, n);
+        lost_.fetch_add(skip);
+    }
+    const std::size_t valueSize = f64 ? sizeof(double) : sizeof(float);
+    std::fwrite(outBuf_.data() + 2 * skip * valueSize, valueSize, 2 * (n - skip), f);
+    return from + n;
+}
@@ -0,0 +1,145 @@
+#pragma once
+
+#include "../Core/IPipelineHandler.h"
+#include "../Core/RecordingSettings.h"
+#include "ChannelEnergyBank.h"
+
+#include <QObject>
+#include <QString>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// PreTriggerRecorder — "time machine" capture for wideband I/Q.
+//
+// Keeps the last preSeconds of I/Q in a circular buffer (int16 storage halves
+// RAM vs float32). On a trigger, a background thread dumps
+//   [trigger − preSeconds, trigger + postSeconds)
+// to disk while the stream keeps running; a trigger arriving during a capture
+// extends its end instead of starting a new file.
+//
+// Triggers:
+//   manual      — trigger(), any thread
+//   power       — band power (ChannelEnergyBank, one channel) crosses
+//                 powerThresholdDb; re-arms 3 dB below
+//   classifier  — onClassification() with a matching type and confidence
+//
+// RX path cost: one copy (+ int16 conversion) of the block into the ring and
+// a few relaxed atomics. No locks, no allocation, no syscalls — the writer
+// thread is woken with notify_one() and also polls, so a lost wakeup only
+// delays the dump, never the RX thread.
+//
+// If the writer falls more than the ring slack behind, the overwritten
+// samples are skipped and counted in lostSamples().
+// ---------------------------------------------------------------------------
+class PreTriggerRecorder : public QObject, public IPipelineHandler {
+    Q_OBJECT
+
+public:
+    using Format = RecordingSettings::RawFormat;
+
+    // The power trigger measures one Goertzel segment of SR / bandwidth pairs
+    // per block and nothing from a shorter block, so the bandwidth is raised
+    // to keep the segment within kMaxPowerSegment (RxWorker blocks are 16384,
+    // short reads less). kMinPowerBandwidthHz does that at every LimeSDR rate
+    // up to 20 MS/s; the settings dialog uses it as its floor.
+    static constexpr int    kMaxPowerSegment     = 4096;
+    static constexpr double kMinPowerBandwidthHz = 5'000.0;
+    // Builds the output path for one capture; called on the writer thread.
+    using PathBuilder = std::function<QString(const QString& reason)>;
+
+    struct Config {
+        double preSeconds   = 5.0;
+        double postSeconds  = 5.0;
+        bool   int16Storage = true;
+        Format format       = Format::Float32;
+
+        // Power trigger — disabled when powerBandwidthHz <= 0; at least
+        // SR / kMaxPowerSegment.
+        double powerOffsetHz    = 0.0;   // relative to LO
+        double powerBandwidthHz = 0.0;
+        double powerThresholdDb = -40.0; // dBFS (tone-normalised)
+
+        // Classifier trigger — disabled when empty.
+        QString classifierType;
+        double  classifierMinConfidence = 0.8;
+    };
+
+    PreTriggerRecorder(const Config& cfg, PathBuilder builder, QObject* parent = nullptr);
+    ~PreTriggerRecorder() override;
+
+    // Manual trigger. Thread-safe; takes effect at the next block boundary.
+    void trigger();
+
+    [[nodiscard]] bool     isCapturing()  const { return captureEnd_.load() != 0; }
+    [[nodiscard]] uint64_t lostSamples()  const { return lost_.load(); }
+    [[nodiscard]] double   bufferedSeconds() const;
+
+    // IPipelineHandler
+    void processBlock(const float* iq, int count, double sampleRateHz) override;
+    void onStreamStarted(double sampleRateHz) override;
+    void onStreamStopped() override;
+    void onRetune(double newFreqHz) override;
+
+public slots:
+    void onClassification(const QString& type, double confidence);
+
+signals:
+    void captureStarted(QString path, QString reason);
+    void captureFinished(QString path, qint64 samples, qint64 lostSamples);
+
+private:
+    enum Reason : int { kNone = 0, kManual, kPower, kClassifier };
+
+    static QString reasonName(int r);
+
+    void requestTrigger(Reason r);
+    void startOrExtend(uint64_t triggerPos, Reason r);
+    void stopWriter();
+    void writerLoop();
+    uint64_t dumpRange(FILE* f, uint64_t from, uint64_t to);
+
+    static constexpr uint64_t kWriteChunk   = 1 << 16;   // I/Q pairs per fwrite
+    static constexpr double   kSlackSeconds = 1.0;       // ring beyond preSeconds
+    static constexpr double   kRearmDb      = 3.0;
+
+    Config      cfg_;
+    PathBuilder builder_;
+    double      sampleRate_{0.0};
+
+    // ── Ring (producer: processBlock; consumer: writer thread) ───────────────
+    // armed_ publishes the ring: addExtraHandler() registers the handler before
+    // calling onStreamStarted(), so a block may arrive mid-setup.
+    std::atomic<bool>    armed_{false};
+    std::vector<int16_t> ring16_;
+    std::vector<float>   ring32_;
+    uint64_t             capacity_{0};          // I/Q pairs
+    uint64_t             preSamples_{0};
+    uint64_t             postSamples_{0};
+    std::atomic<uint64_t> writePos_{0};         // total pairs written
+    std::atomic<int>      maxBlock_{0};
+
+    // ── Trigger hand-off ─────────────────────────────────────────────────────
+    std::atomic<int>      pendingReason_{kNone};
+    std::atomic<uint64_t> captureStart_{0};
+    std::atomic<uint64_t> captureEnd_{0};       // 0 = idle
+    std::atomic<int>      captureReason_{kNone};
+    std::atomic<uint64_t> lost_{0};
+
+    // ── Power trigger ────────────────────────────────────────────────────────
+    ChannelEnergyBank bank_;
+    bool              powerAbove_{false};
+
+    // ── Writer thread ────────────────────────────────────────────────────────
+    std::thread             writer_;
+    std::mutex              wakeMutex_;
+    std::condition_variable wake_;
+    std::atomic<bool>       stopping_{false};
+    std::vector<char>       outBuf_;
+};
@@ -1,51 +1,226 @@
 #include "RawFileHandler.h"
+#include "IqFormats.h"
 #include "Logger.h"
 
-RawFileHandler::RawFileHandler(const QString& path, Format format)
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <cmath>
+
+namespace {
+// 4 × 8 MB ≈ 200 ms of float32 at 20 MS/s in flight before blocks are dropped.
+AsyncFileWriter::Options rawWriterOptions() {
+    AsyncFileWriter::Options o;
+    o.bufferBytes = 8u << 20;
+    o.bufferCount = 4;
+    o.direct      = true;
+    o.overflow    = AsyncFileWriter::Overflow::Drop;
+    return o;
+}
+
+const char* formatName(RecordingSettings::RawFormat f) {
+    switch (f) {
+        case RecordingSettings::RawFormat::Float64: return "float64";
+        case RecordingSettings::RawFormat::Int16:   return "int16";
+        case RecordingSettings::RawFormat::Int12:   return "packed int12";
+        case RecordingSettings::RawFormat::Int8:    return "scaled int8";
+        case RecordingSettings::RawFormat::Int16Lossless: return "lossless int16";
+        default:                                    return "float32";
+    }
+}
+}  // namespace
+
+RawFileHandler::RawFileHandler(const QString& path, Format format, QThreadPool* pool)
     : path_(path)
     , format_(format)
+    , pool_(pool)
 {}
 
 RawFileHandler::~RawFileHandler() {
     onStreamStopped();
 }
 
-void RawFileHandler::onStreamStarted(double /*sampleRateHz*/) {
-    file_.open(path_.toStdString(), std::ios::binary);
-    if (!file_.is_open()) {
+void RawFileHandler::enableSigMf(double centerHz, const QString& description) {
+    centerHz_         = centerHz;
+    sigmfEnabled_     = true;
+    sigmfDescription_ = description;
+}
+
+void RawFileHandler::setInt8Scale(float scale) {
+    if (!(scale > 0.0f) || !std::isfinite(scale)) {
+        LOG_WARN("RawFileHandler: invalid .ci8 scale, using full scale 1/127");
+        scale = IqFormats::kInt8Scale;
+    }
+    int8Scale_ = scale;
+}
+
+void RawFileHandler::onStreamStarted(double sampleRateHz) {
+    bool opened = false;
+    if (format_ == Format::Int16Lossless) {
+        if (segmentPolicy_.enabled())
+            LOG_INFO("RawFileHandler: .ci16z is written as one file, segmenting ignored");
+        opened = codec_.open(path_, pool_, rawWriterOptions());
+    } else {
+        SegmentedFileWriter::Hooks hooks;
+        hooks.rotated = [this](const QString& finished, int) { onSegmentRotated(finished); };
+        opened = file_.open(path_, rawWriterOptions(), segmentPolicy_,
+                            sampleRateHz * static_cast<double>(IqFormats::bytesPerPair(format_)),
+                            std::move(hooks));
+    }
+    if (!opened) {
         LOG_ERROR("RawFileHandler: cannot open: " + path_.toStdString());
         return;
     }
-    LOG_INFO(std::string("RawFileHandler: writing ")
-             + (format_ == Format::Float64 ? "float64" : "float32")
+    clipped_   = 0;
+    filePairs_.store(0);
+    sigmf_.reset();
+    if (sigmfEnabled_) {
+        sigmf_ = std::make_shared<SigMfWriter>(file_.isOpen() ? file_.path() : path_,
+                                               sigmfDescription_);
+        sigmf_->begin(format_, sampleRateHz, centerHz_);
+        if (format_ == Format::Int8) sigmf_->setInt8Scale(int8Scale_);
+        sigmf_->write();
+    }
+    LOG_INFO(std::string("RawFileHandler: writing ") + formatName(format_)
              + " to " + path_.toStdString());
 }
 
+// Stream thread, inside SegmentedFileWriter::write(): the new segment is
+// already current. Sidecars of the finished segment go to the I/O thread.
+void RawFileHandler::onSegmentRotated(const QString& finishedPath) {
+    filePairs_.store(0);
+    if (format_ == Format::Int8) {
+        AsyncFileWriter::post(finishedPath,
+            [finishedPath, scale = int8Scale_, clipped = clipped_] {
+                writeInt8Sidecar(finishedPath, scale, clipped);
+            });
+    }
+    if (sigmf_) {
+        auto done  = sigmf_->nextSegment(file_.path());
+        auto fresh = sigmf_->snapshot();
+        AsyncFileWriter::post(finishedPath, [done = std::move(done), fresh = std::move(fresh)] {
+            SigMfWriter::save(done);
+            SigMfWriter::save(fresh);
+        });
+    }
+}
+
 void RawFileHandler::onStreamStopped() {
-    if (file_.is_open()) {
-        file_.flush();
-        file_.close();
-        LOG_INFO("RawFileHandler: closed " + path_.toStdString());
+    if (isOpen()) {
+        const bool    lossless = codec_.isOpen();
+        const QString last     = lossless ? path_ : file_.path();
+        if (lossless) codec_.close();
+        else          file_.close();
+        if (format_ == Format::Int8) writeInt8Sidecar(last, int8Scale_, clipped_);
+        if (sigmf_) sigmf_->write();
+        const auto st = lossless ? codec_.stats() : file_.stats();
+        std::string ratio;
+        if (lossless && codec_.rawBytes() > 0)
+            ratio = " (" + std::to_string(st.bytesWritten * 100 / codec_.rawBytes()) + "% of ci16)";
+        LOG_INFO("RawFileHandler: closed " + path_.toStdString() + ", "
+                 + std::to_string(st.bytesWritten >> 20) + " MiB" + ratio
+                 + (st.dropEvents ? ", " + std::to_string(st.dropEvents) + " blocks dropped"
+                                  : std::string()));
+        if (clipped_ > 0)
+            LOG_WARN("RawFileHandler: " + std::to_string(clipped_)
+                     + " samples saturated in " + formatName(format_));
     }
     promoteBuf_.clear();
     promoteBuf_.shrink_to_fit();
+    int16Buf_.clear();
+    int16Buf_.shrink_to_fit();
+    byteBuf_.clear();
+    byteBuf_.shrink_to_fit();
 }
 
-void RawFileHandler::processBlock(const float* iq, int count, double /*sampleRateHz*/) {
-    if (!file_.is_open() || count <= 0) return;
+void RawFileHandler::processBlock(const float* iq, int count, double sampleRateHz) {
+    processBlock(iq, count, sampleRateHz, BlockMeta{});
+}
 
-    const std::size_t n = static_cast<std::size_t>(count) * 2;
+void RawFileHandler::processBlock(const float* iq, int count, double /*sampleRateHz*/,
+                                  const BlockMeta& meta) {
+    if (!writeBlock(iq, meta.rawIq, count)) return;
+    const uint64_t first = filePairs_.fetch_add(static_cast<uint64_t>(count));
+    if (sigmf_ && sigmf_->onBlockWritten(first, static_cast<uint64_t>(count), meta.timestamp))
+        postSigMfRewrite();
+}
 
-    if (format_ == Format::Float32) {
-        file_.write(reinterpret_cast<const char*>(iq),
-                    static_cast<std::streamsize>(n * sizeof(float)));
-        return;
+void RawFileHandler::onRetune(double newFreqHz) {
+    centerHz_ = newFreqHz;
+    if (!sigmf_ || !isOpen()) return;
+    sigmf_->onRetune(filePairs_.load(), newFreqHz);
+    postSigMfRewrite();
+}
+
+void RawFileHandler::annotateGain(int channelIndex, double gainDb) {
+    if (!sigmf_) return;
+    sigmf_->onGain(filePairs_.load(), channelIndex, gainDb);
+    if (isOpen()) postSigMfRewrite();
+}
+
+// Snapshot, serialisation and the file write all run on the disk's I/O
+// thread, queued behind the data; the caller only enqueues.
+void RawFileHandler::postSigMfRewrite() {
+    AsyncFileWriter::post(path_, [sigmf = sigmf_] { sigmf->write(); });
+}
+
+// Returns true when the block was accepted by the writer.
+bool RawFileHandler::writeBlock(const float* iq, const int16_t* raw, int count) {
+    if (!isOpen() || count <= 0) return false;
+
+    const std::size_t pairs = static_cast<std::size_t>(count);
+    const std::size_t n     = pairs * 2;
+
+    switch (format_) {
+        case Format::Float32:
+            return file_.write(iq, n * sizeof(float));
+
+        case Format::Float64:
+            if (promoteBuf_.size() < n) promoteBuf_.resize(n);
+            for (std::size_t i = 0; i < n; ++i)
+                promoteBuf_[i] = static_cast<double>(iq[i]);
+            return file_.write(promoteBuf_.data(), n * sizeof(double));
+
+        case Format::Int16:
+        case Format::Int12:
+        case Format::Int16Lossless:
+            // Prefer the device samples; the float path is the fallback for
+            // handlers fed from a combined/synthetic stream.
+            if (!raw) {
+                if (int16Buf_.size() < n) int16Buf_.resize(n);
+                clipped_ += IqFormats::floatToInt16(iq, int16Buf_.data(), n);
+                raw = int16Buf_.data();
+            }
+            if (format_ == Format::Int16)
+                return file_.write(raw, n * sizeof(int16_t));
+            if (format_ == Format::Int16Lossless) {
+                codec_.write(raw, pairs);   // drops are accounted per block inside IqCodec
+                return true;
+            }
+            if (byteBuf_.size() < pairs * 3) byteBuf_.resize(pairs * 3);
+            clipped_ += IqFormats::packInt12(raw, byteBuf_.data(), pairs);
+            return file_.write(byteBuf_.data(), pairs * 3);
+
+        case Format::Int8:
+            if (byteBuf_.size() < n) byteBuf_.resize(n);
+            clipped_ += IqFormats::floatToInt8(
+                iq, reinterpret_cast<int8_t*>(byteBuf_.data()), n, int8Scale_);
+            return file_.write(byteBuf_.data(), n);
     }
+    return false;
+}
+
+void RawFileHandler::writeInt8Sidecar(const QString& dataPath, float scale, uint64_t clipped) {
+    QJsonObject o;
+    o[QStringLiteral("format")]  = QStringLiteral("ci8");
+    o[QStringLiteral("scale")]   = static_cast<double>(scale);
+    o[QStringLiteral("clipped")] = static_cast<double>(clipped);
 
-    // Float64: promote to double before writing.
-    if (promoteBuf_.size() < n) promoteBuf_.resize(n);
-    for (std::size_t i = 0; i < n; ++i)
-        promoteBuf_[i] = static_cast<double>(iq[i]);
-    file_.write(reinterpret_cast<const char*>(promoteBuf_.data()),
-                static_cast<std::streamsize>(n * sizeof(double)));
+    QFile side(dataPath + QStringLiteral(".json"));
+    if (!side.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        LOG_WARN("RawFileHandler: cannot write scale sidecar for " + dataPath.toStdString());
+        return;
+    }
+    side.write(QJsonDocument(o).toJson());
 }
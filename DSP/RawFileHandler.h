@@ -2,9 +2,15 @@
 
 #include "../Core/IPipelineHandler.h"
 #include "../Core/RecordingSettings.h"
+#include "../Core/SegmentedFileWriter.h"
+#include "IqCodec.h"
+#include "IqFormats.h"
+#include "SigMfWriter.h"
 
 #include <QString>
-#include <fstream>
+#include <atomic>
+#include <cstdint>
+#include <memory>
 #include <vector>
 
 // ---------------------------------------------------------------------------
@@ -13,21 +19,85 @@
 // Default format is 32-bit IEEE float (`.cf32`). Setting RawFormat::Float64
 // promotes each sample to 64-bit float before writing (`.cf64`), trading ~2×
 // disk bandwidth for native-precision MATLAB/Python ingestion.
+//
+// Compact formats (see IqFormats.h):
+//   Int16 (`.ci16`) — the device's own int16 samples, taken from
+//                     BlockMeta::rawIq when present; bit-exact, 2× smaller.
+//   Int12 (`.ci12`) — the same samples packed into 3 bytes per pair.
+//   Int8  (`.ci8`)  — int8 × setInt8Scale() (default IqFormats::kInt8Scale,
+//                     1.0 → 127); the scale goes to "<file>.json" and the
+//                     SigMF sidecar.
+//   Int16Lossless (`.ci16z`) — the Int16 samples through IqCodec; blocks are
+//                     compressed in parallel on `pool` (inline if nullptr).
+// Saturated values in the lossy paths are counted and logged at close.
+//
+// enableSigMf() adds a `.sigmf-meta` sidecar (SigMfWriter): capture segments
+// per retune, gain annotations and a coarse time → sample/byte index. It is
+// rewritten on every retune and gain change and every
+// SigMfWriter::kRewriteIndexPoints index entries (on the I/O thread), and at
+// stop.
+//
+// setSegmentPolicy() splits the capture into …_seg0001, …_seg0002 files
+// (SegmentedFileWriter); each segment gets its own SigMF and .ci8 sidecars,
+// written on the I/O thread at rotation. .ci16z is not segmented — its block
+// index already survives a crash.
+//
+// Disk I/O runs on the AsyncFileWriter thread for the target disk with
+// direct I/O; processBlock() only copies into the writer's buffers. If the
+// disk falls behind, whole blocks are dropped and logged at close.
 // ---------------------------------------------------------------------------
 class RawFileHandler : public IPipelineHandler {
 public:
     using Format = RecordingSettings::RawFormat;
 
-    explicit RawFileHandler(const QString& path, Format format = Format::Float32);
+    explicit RawFileHandler(const QString& path, Format format = Format::Float32,
+                            QThreadPool* pool = nullptr);
     ~RawFileHandler() override;
 
     void processBlock(const float* iq, int count, double sampleRateHz) override;
+    void processBlock(const float* iq, int count, double sampleRateHz,
+                      const BlockMeta& meta) override;
     void onStreamStarted(double sampleRateHz) override;
     void onStreamStopped() override;
+    void onRetune(double newFreqHz) override;
+
+    // Call before onStreamStarted(). centerHz is the LO at stream start.
+    void enableSigMf(double centerHz, const QString& description);
+    void setSegmentPolicy(const SegmentedFileWriter::Policy& policy) { segmentPolicy_ = policy; }
+    // .ci8 only, before onStreamStarted(): float value of one int8 step.
+    void setInt8Scale(float scale);
+    // Records a device gain change at the current file position (any thread).
+    void annotateGain(int channelIndex, double gainDb);
+
+    // Writer totals (bytes written / dropped) of the open or last recording.
+    // Call from the thread that drives the stream, or once it has stopped.
+    [[nodiscard]] AsyncFileWriter::Stats writerStats() const {
+        return format_ == Format::Int16Lossless ? codec_.stats() : file_.stats();
+    }
 
 private:
+    bool writeBlock(const float* iq, const int16_t* raw, int count);
+    void onSegmentRotated(const QString& finishedPath);
+    void postSigMfRewrite();
+    static void writeInt8Sidecar(const QString& dataPath, float scale, uint64_t clipped);
+
+    [[nodiscard]] bool isOpen() const { return file_.isOpen() || codec_.isOpen(); }
+
     QString            path_;
     Format             format_;
-    std::ofstream      file_;
-    std::vector<double> promoteBuf_;   // used only in Float64 mode
+    QThreadPool*       pool_;
+    SegmentedFileWriter file_;
+    SegmentedFileWriter::Policy segmentPolicy_;
+    IqCodec::Writer    codec_;         // Int16Lossless only
+    std::vector<double>  promoteBuf_;  // Float64 only
+    std::vector<int16_t> int16Buf_;    // int16 formats when the block has no rawIq
+    std::vector<uint8_t> byteBuf_;     // Int12/Int8 packed output
+    float              int8Scale_{IqFormats::kInt8Scale};
+    uint64_t           clipped_{0};
+
+    std::shared_ptr<SigMfWriter> sigmf_;   // shared with queued sidecar rewrites
+    bool                   sigmfEnabled_{false};
+    QString                sigmfDescription_;
+    double                 centerHz_{0.0};
+    std::atomic<uint64_t>  filePairs_{0};   // pairs that reached the file
 };
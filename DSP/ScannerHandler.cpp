@@ -0,0 +1,262 @@
+#include "ScannerHandler.h"
+#include "BaseDemodHandler.h"
+#include "DemodRegistry.h"
+#include "Logger.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+ScannerHandler::ScannerHandler(QObject* parent)
+    : QObject(parent)
+{}
+
+ScannerHandler::~ScannerHandler() {
+    // Pipeline no longer dispatches to us — demods live on our thread.
+    stopAllDemods(true);
+}
+
+// ---------------------------------------------------------------------------
+// Setters (UI thread)
+// ---------------------------------------------------------------------------
+void ScannerHandler::setChannels(const QVector<ScanChannel>& channels) {
+    std::lock_guard lock(cfgMutex_);
+    pendingChannels_ = channels;
+    channelsDirty_   = true;
+}
+
+void ScannerHandler::setCenterFrequency(double hz) { centerHz_.store(hz); }
+void ScannerHandler::setThresholdDb(double snrDb)  { thresholdDb_.store(snrDb); }
+void ScannerHandler::setHangTime(double sec)       { hangSec_.store(std::max(0.0, sec)); }
+void ScannerHandler::setMaxActiveDemods(int n)     { maxDemods_.store(std::max(0, n)); }
+
+QVector<ScanChannel> ScannerHandler::channels() const {
+    std::lock_guard lock(statusMutex_);
+    return channelList_;
+}
+
+QVector<ScannerHandler::ChannelStatus> ScannerHandler::status() const {
+    std::lock_guard lock(statusMutex_);
+    return status_;
+}
+
+// ---------------------------------------------------------------------------
+// Lifecycle
+// ---------------------------------------------------------------------------
+void ScannerHandler::onStreamStarted(double sampleRateHz) {
+    sampleRate_ = sampleRateHz;
+    {
+        std::lock_guard lock(cfgMutex_);
+        channelsDirty_ = true;   // force rebuild against the new SR
+    }
+}
+
+void ScannerHandler::onStreamStopped() {
+    stopAllDemods(false);
+    for (Slot& s : slots_) s.gate.reset();
+    publishStatus();
+}
+
+void ScannerHandler::onRetune(double newFreqHz) {
+    // Offsets are recomputed by the worker on the next block.
+    centerHz_.store(newFreqHz);
+}
+
+// ---------------------------------------------------------------------------
+// rebuild — recompute offsets / bank after channel list, SR or LO change
+// ---------------------------------------------------------------------------
+void ScannerHandler::rebuild(double sampleRateHz) {
+    QVector<ScanChannel> list;
+    bool listChanged = false;
+    {
+        std::lock_guard lock(cfgMutex_);
+        if (channelsDirty_) {
+            list          = pendingChannels_;
+            listChanged   = true;
+            channelsDirty_ = false;
+        }
+    }
+
+    if (listChanged) {
+        stopAllDemods(false);
+        slots_.clear();
+        slots_.resize(list.size());
+        for (int i = 0; i < list.size(); ++i) slots_[i].cfg = list[i];
+    } else {
+        // LO change: old demods are tuned to stale offsets.
+        stopAllDemods(false);
+    }
+
+    sampleRate_    = sampleRateHz;
+    builtCenterHz_ = centerHz_.load();
+
+    // Channels outside the usable band (edges of the anti-alias filter) are
+    // kept in the list but not measured.
+    const double usable = 0.45 * sampleRateHz;
+    std::vector<double> offsets;
+    double resolution = sampleRateHz;
+    for (Slot& s : slots_) {
+        s.offsetHz  = s.cfg.freqHz - builtCenterHz_;
+        s.inBand    = std::abs(s.offsetHz) + s.cfg.bandwidthHz / 2.0 <= usable;
+        s.bin       = -1;
+        s.floorInit = false;
+        s.gate.reset();
+        if (!s.inBand) continue;
+        s.bin = static_cast<int>(offsets.size());
+        offsets.push_back(s.offsetHz);
+        resolution = std::min(resolution, s.cfg.bandwidthHz);
+    }
+    bank_.configure(offsets, sampleRateHz, std::max(resolution, kMinResolutionHz));
+
+    {
+        std::lock_guard lock(statusMutex_);
+        channelList_.clear();
+        for (const Slot& s : slots_) channelList_.append(s.cfg);
+    }
+
+    LOG_INFO("ScannerHandler: " + std::to_string(offsets.size()) + "/"
+             + std::to_string(slots_.size()) + " channels in band, L="
+             + std::to_string(bank_.segmentLength()) + ", segments/block="
+             + std::to_string(bank_.segmentsPerBlock()));
+}
+
+// ---------------------------------------------------------------------------
+// processBlock
+// ---------------------------------------------------------------------------
+void ScannerHandler::processBlock(const float* iq, int count, double sampleRateHz) {
+    bool dirty;
+    {
+        std::lock_guard lock(cfgMutex_);
+        dirty = channelsDirty_;
+    }
+    if (dirty || sampleRateHz != sampleRate_ || centerHz_.load() != builtCenterHz_)
+        rebuild(sampleRateHz);
+
+    if (slots_.empty()) return;
+
+    if (bank_.process(iq, count)) {
+        updateGates(count, sampleRateHz);
+        assignDemods();
+    }
+
+    // Active demodulators run inline — bounded by maxActiveDemods().
+    for (Slot& s : slots_)
+        if (s.demod) s.demod->processBlock(iq, count, sampleRateHz);
+
+    publishStatus();
+}
+
+// ---------------------------------------------------------------------------
+// updateGates — noise floor + SNR gate per in-band channel
+// ---------------------------------------------------------------------------
+void ScannerHandler::updateGates(int count, double sampleRateHz) {
+    const auto&  power     = bank_.powerDb();
+    const double threshold = thresholdDb_.load();
+    const auto   hang      = static_cast<long long>(hangSec_.load() * sampleRateHz);
+    const double blockSec  = count / sampleRateHz;
+
+    for (int i = 0; i < static_cast<int>(slots_.size()); ++i) {
+        Slot& s = slots_[i];
+        if (s.bin < 0) continue;
+        const double p = power[s.bin];
+        s.powerDb = p;
+
+        // Floor: follows dips quickly, rises slowly, frozen while active.
+        if (!s.floorInit) {
+            s.floorDb   = p;
+            s.floorInit = true;
+        } else if (p < s.floorDb) {
+            s.floorDb += kFloorFallAlpha * (p - s.floorDb);
+        } else if (!s.gate.open) {
+            s.floorDb = std::min(p, s.floorDb + kFloorRiseDbPerSec * blockSec);
+        }
+
+        const double snr = p - s.floorDb;
+        s.gate.openDb       = threshold;
+        s.gate.hysteresisDb = 3.0;
+        s.gate.hangSamples  = hang;
+
+        const bool was = s.gate.open;
+        const bool now = s.gate.update(snr, count);
+        if (now != was) {
+            LOG_INFO("ScannerHandler: " + (s.cfg.label.isEmpty()
+                         ? std::to_string(s.cfg.freqHz / 1e6) + " MHz"
+                         : s.cfg.label.toStdString())
+                     + (now ? " active, SNR " : " idle, SNR ")
+                     + std::to_string(static_cast<int>(snr)) + " dB");
+            emit channelActivity(i, now, snr);
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// assignDemods — keep demodulators on the best maxActiveDemods() channels
+// ---------------------------------------------------------------------------
+void ScannerHandler::assignDemods() {
+    std::vector<int> wanted;
+    for (int i = 0; i < static_cast<int>(slots_.size()); ++i)
+        if (slots_[i].inBand && !slots_[i].noDemod && slots_[i].gate.open)
+            wanted.push_back(i);
+
+    std::sort(wanted.begin(), wanted.end(), [this](int a, int b) {
+        const Slot& sa = slots_[a];
+        const Slot& sb = slots_[b];
+        if (sa.cfg.priority != sb.cfg.priority) return sa.cfg.priority < sb.cfg.priority;
+        return (sa.powerDb - sa.floorDb) > (sb.powerDb - sb.floorDb);
+    });
+    const int limit = maxDemods_.load();
+    if (static_cast<int>(wanted.size()) > limit) wanted.resize(limit);
+
+    // Release first so a preempted channel frees its seat before a new one starts.
+    for (int i = 0; i < static_cast<int>(slots_.size()); ++i) {
+        if (slots_[i].demod
+            && std::find(wanted.begin(), wanted.end(), i) == wanted.end())
+            stopDemod(i, false);
+    }
+    for (int i : wanted)
+        if (!slots_[i].demod) startDemod(i);
+}
+
+void ScannerHandler::startDemod(int index) {
+    Slot& s = slots_[index];
+    BaseDemodHandler* h = DemodRegistry::instance().create(s.cfg.mode, s.offsetHz, nullptr);
+    if (!h) {
+        LOG_WARN("ScannerHandler: unknown mode '" + s.cfg.mode.toStdString() + "'");
+        s.noDemod = true;   // never retry this entry until the list changes
+        return;
+    }
+    h->setParam(QStringLiteral("Bandwidth"), s.cfg.bandwidthHz);
+    // Created on the worker thread — hand it to the scanner's thread so that
+    // deleteLater() is processed by the UI event loop.
+    h->moveToThread(thread());
+    connect(h, &BaseDemodHandler::audioReady, this,
+            [this, index](QVector<float> samples, double sr) {
+                emit channelAudio(index, std::move(samples), sr);
+            }, Qt::DirectConnection);
+    s.demod = h;
+}
+
+void ScannerHandler::stopDemod(int index, bool immediate) {
+    Slot& s = slots_[index];
+    if (!s.demod) return;
+    s.demod->onStreamStopped();
+    disconnect(s.demod, nullptr, this, nullptr);
+    if (immediate) delete s.demod;
+    else           s.demod->deleteLater();
+    s.demod = nullptr;
+}
+
+void ScannerHandler::stopAllDemods(bool immediate) {
+    for (int i = 0; i < static_cast<int>(slots_.size()); ++i)
+        stopDemod(i, immediate);
+}
+
+// ---------------------------------------------------------------------------
+void ScannerHandler::publishStatus() {
+    std::lock_guard lock(statusMutex_);
+    status_.resize(static_cast<int>(slots_.size()));
+    for (int i = 0; i < static_cast<int>(slots_.size()); ++i) {
+        const Slot& s = slots_[i];
+        status_[i] = {s.powerDb, s.floorDb, s.inBand, s.gate.open, s.demod != nullptr};
+    }
+}
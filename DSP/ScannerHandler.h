@@ -0,0 +1,118 @@
+#pragma once
+
+#include "../Core/IPipelineHandler.h"
+#include "../Core/ScanList.h"
+#include "ChannelEnergyBank.h"
+#include "DspUtils.h"
+
+#include <QObject>
+#include <QVector>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+class BaseDemodHandler;
+
+// ---------------------------------------------------------------------------
+// ScannerHandler — memory scanner over one wideband capture.
+//
+// Watches N known channels (ScanChannel, absolute frequency) inside the
+// current capture with one ChannelEnergyBank pass per block, tracks a
+// per-channel noise floor and opens an ActivityGate when the channel SNR
+// exceeds the threshold (hysteresis + hang time). Only active channels get
+// a full demodulator from DemodRegistry, at most maxActiveDemods() of them,
+// chosen by ScanChannel::priority (lower wins), then by SNR.
+//
+// Demodulators are owned by the scanner and driven directly from its
+// processBlock() — they are NOT added to the Pipeline, so starting/stopping
+// them never touches the pipeline handler list during dispatch. They are
+// created on the worker thread and moved to the scanner's thread so their
+// deleteLater() lands on the UI event loop.
+//
+// Threading: setters and status() are thread-safe (UI thread); signals are
+// emitted from the RxWorker / pool thread — connect with QueuedConnection.
+// ---------------------------------------------------------------------------
+class ScannerHandler : public QObject, public IPipelineHandler {
+    Q_OBJECT
+
+public:
+    struct ChannelStatus {
+        double powerDb      = -200.0;
+        double floorDb      = -200.0;
+        bool   inBand       = false;
+        bool   active       = false;
+        bool   demodulating = false;
+    };
+
+    explicit ScannerHandler(QObject* parent = nullptr);
+    ~ScannerHandler() override;
+
+    // Applied on the next block. Thread-safe.
+    void setChannels(const QVector<ScanChannel>& channels);
+    void setCenterFrequency(double hz);
+    void setThresholdDb(double snrDb);      // SNR above noise floor to open
+    void setHangTime(double sec);
+    void setMaxActiveDemods(int n);
+
+    [[nodiscard]] int maxActiveDemods() const { return maxDemods_.load(); }
+    [[nodiscard]] QVector<ScanChannel>   channels() const;
+    [[nodiscard]] QVector<ChannelStatus> status()   const;
+
+    // IPipelineHandler
+    void processBlock(const float* iq, int count, double sampleRateHz) override;
+    void onStreamStarted(double sampleRateHz) override;
+    void onStreamStopped() override;
+    void onRetune(double newFreqHz) override;
+
+signals:
+    // Gate transition for channel `index` (position in channels()).
+    void channelActivity(int index, bool active, double snrDb);
+    // Audio from the demodulator currently assigned to channel `index`.
+    void channelAudio(int index, QVector<float> samples, double sampleRateHz);
+
+private:
+    struct Slot {
+        ScanChannel        cfg;
+        double             offsetHz{0.0};
+        bool               inBand{false};
+        int                bin{-1};           // index into bank_ (in-band only)
+        bool               noDemod{false};    // mode not in DemodRegistry
+        double             powerDb{-200.0};
+        double             floorDb{0.0};
+        bool               floorInit{false};
+        dsp::ActivityGate  gate;
+        BaseDemodHandler*  demod{nullptr};
+    };
+
+    void rebuild(double sampleRateHz);
+    void updateGates(int count, double sampleRateHz);
+    void assignDemods();
+    void startDemod(int index);
+    void stopDemod(int index, bool immediate);
+    void stopAllDemods(bool immediate);
+    void publishStatus();
+
+    static constexpr double kFloorRiseDbPerSec = 1.0;   // slow upward tracking
+    static constexpr double kFloorFallAlpha    = 0.3;   // fast downward tracking
+    static constexpr double kMinResolutionHz   = 5'000.0;
+
+    // ── Config (UI thread → worker) ──────────────────────────────────────────
+    mutable std::mutex   cfgMutex_;
+    QVector<ScanChannel> pendingChannels_;
+    bool                 channelsDirty_{false};
+    std::atomic<double>  centerHz_{0.0};
+    std::atomic<double>  thresholdDb_{10.0};
+    std::atomic<double>  hangSec_{2.0};
+    std::atomic<int>     maxDemods_{2};
+
+    // ── Worker-thread state ──────────────────────────────────────────────────
+    ChannelEnergyBank  bank_;
+    std::vector<Slot>  slots_;
+    double             sampleRate_{0.0};
+    double             builtCenterHz_{0.0};
+
+    // ── Status snapshot (worker → UI) ────────────────────────────────────────
+    mutable std::mutex     statusMutex_;
+    QVector<ScanChannel>   channelList_;
+    QVector<ChannelStatus> status_;
+};
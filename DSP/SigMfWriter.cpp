@@ -0,0 +1,213 @@
+#include "SigMfWriter.h"
+#include "IqFormats.h"
+#include "Logger.h"
+
+#include <QDateTime>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QTimeZone>
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+QString isoUtc(qint64 unixMs) {
+    return QDateTime::fromMSecsSinceEpoch(unixMs, QTimeZone::UTC).toString(Qt::ISODateWithMs);
+}
+}  // namespace
+
+SigMfWriter::SigMfWriter(const QString& dataPath, QString description)
+    : description_(std::move(description))
+    , dataPath_(dataPath)
+    , metaPath_(metaPathFor(dataPath))
+{}
+
+QString SigMfWriter::metaPath() const {
+    std::lock_guard lock(mutex_);
+    return metaPath_;
+}
+
+QString SigMfWriter::metaPathFor(const QString& dataPath) {
+    const QFileInfo fi(dataPath);
+    return fi.path() + QLatin1Char('/') + fi.completeBaseName() + QStringLiteral(".sigmf-meta");
+}
+
+QString SigMfWriter::datatypeFor(Format format) {
+    switch (format) {
+        case Format::Float64: return QStringLiteral("cf64_le");
+        case Format::Int8:    return QStringLiteral("ci8");
+        case Format::Int16:
+        case Format::Int12:            // decoded type; stand:encoding says how it is stored
+        case Format::Int16Lossless: return QStringLiteral("ci16_le");
+        case Format::Float32: break;
+    }
+    return QStringLiteral("cf32_le");
+}
+
+void SigMfWriter::begin(Format format, double sampleRateHz, double centerHz) {
+    std::lock_guard lock(mutex_);
+    format_       = format;
+    sampleRateHz_ = sampleRateHz;
+    int8Scale_    = 0.0;
+    nextIndexSample_ = 0;
+    unsavedIndexPoints_ = 0;
+    captures_.clear();
+    gains_.clear();
+    index_.clear();
+    captures_.push_back({0, centerHz, QDateTime::currentMSecsSinceEpoch(), 0, false});
+}
+
+bool SigMfWriter::onBlockWritten(uint64_t firstSample, uint64_t pairs, uint64_t hwTimestamp) {
+    std::lock_guard lock(mutex_);
+    if (captures_.empty()) return false;
+
+    auto& cap = captures_.back();
+    if (!cap.hwKnown && hwTimestamp != 0 && firstSample >= cap.sampleStart
+        && hwTimestamp >= firstSample - cap.sampleStart) {
+        // First counter seen in this segment, projected back to its start.
+        cap.hwTimestamp = hwTimestamp - (firstSample - cap.sampleStart);
+        cap.hwKnown     = true;
+    }
+
+    const uint64_t end = firstSample + pairs;
+    if (end <= nextIndexSample_) return false;
+
+    const qint64  now = QDateTime::currentMSecsSinceEpoch();
+    const int64_t bpp = format_ == Format::Int16Lossless
+                            ? -1 : static_cast<int64_t>(IqFormats::bytesPerPair(format_));
+    index_.push_back({firstSample,
+                      bpp < 0 ? -1 : static_cast<int64_t>(firstSample) * bpp,
+                      hwTimestamp, now});
+    const uint64_t step = std::max<uint64_t>(
+        1, static_cast<uint64_t>(std::llround(sampleRateHz_ * kIndexIntervalSec)));
+    nextIndexSample_ = firstSample + step;
+    if (++unsavedIndexPoints_ < kRewriteIndexPoints) return false;
+    unsavedIndexPoints_ = 0;
+    return true;
+}
+
+void SigMfWriter::onRetune(uint64_t sample, double centerHz) {
+    std::lock_guard lock(mutex_);
+    if (!captures_.empty() && captures_.back().sampleStart == sample) {
+        captures_.back().centerHz = centerHz;   // nothing written since last segment
+        return;
+    }
+    captures_.push_back({sample, centerHz, QDateTime::currentMSecsSinceEpoch(), 0, false});
+}
+
+void SigMfWriter::onGain(uint64_t sample, int channelIndex, double gainDb) {
+    std::lock_guard lock(mutex_);
+    gains_.push_back({sample, channelIndex, gainDb});
+}
+
+void SigMfWriter::setInt8Scale(double scale) {
+    std::lock_guard lock(mutex_);
+    int8Scale_ = scale;
+}
+
+SigMfWriter::Sidecar SigMfWriter::snapshot() const {
+    Contents c;
+    {
+        std::lock_guard lock(mutex_);
+        c = contents();
+    }
+    return {c.metaPath, serialise(c)};
+}
+
+SigMfWriter::Contents SigMfWriter::contents() const {
+    return {dataPath_, metaPath_, format_, sampleRateHz_, int8Scale_,
+            captures_, gains_, index_};
+}
+
+SigMfWriter::Sidecar SigMfWriter::nextSegment(const QString& dataPath) {
+    std::unique_lock lock(mutex_);
+    Contents finished = contents();
+
+    // Last gain per channel carries over as the new segment's first annotations.
+    std::vector<GainEvent> carried;
+    for (auto it = gains_.rbegin(); it != gains_.rend(); ++it) {
+        const bool seen = std::any_of(carried.begin(), carried.end(),
+                                      [&](const GainEvent& g) { return g.channel == it->channel; });
+        if (!seen) carried.push_back({0, it->channel, it->gainDb});
+    }
+    std::reverse(carried.begin(), carried.end());
+
+    const double centerHz = captures_.empty() ? 0.0 : captures_.back().centerHz;
+    dataPath_ = dataPath;
+    metaPath_ = metaPathFor(dataPath);
+    nextIndexSample_ = 0;
+    unsavedIndexPoints_ = 0;
+    index_.clear();
+    gains_ = std::move(carried);
+    captures_.clear();
+    captures_.push_back({0, centerHz, QDateTime::currentMSecsSinceEpoch(), 0, false});
+    lock.unlock();
+    return {finished.metaPath, serialise(finished)};
+}
+
+QByteArray SigMfWriter::serialise(const Contents& c) const {
+    QJsonObject global;
+    QJsonArray  captures, annotations, index;
+
+    global[QStringLiteral("core:datatype")]    = datatypeFor(c.format);
+    global[QStringLiteral("core:sample_rate")] = c.sampleRateHz;
+    global[QStringLiteral("core:version")]     = QStringLiteral("1.0.0");
+    global[QStringLiteral("core:num_channels")] = 1;
+    global[QStringLiteral("core:dataset")]     = QFileInfo(c.dataPath).fileName();
+    global[QStringLiteral("core:recorder")]    = QStringLiteral("Stand");
+    global[QStringLiteral("core:hw")]          = QStringLiteral("LimeSDR");
+    if (!description_.isEmpty())
+        global[QStringLiteral("core:description")] = description_;
+    if (c.format == Format::Int12)
+        global[QStringLiteral("stand:encoding")] = QStringLiteral("ci12");
+    else if (c.format == Format::Int16Lossless)
+        global[QStringLiteral("stand:encoding")] = QStringLiteral("ci16z");
+    if (c.format == Format::Int8 && c.int8Scale > 0.0)
+        global[QStringLiteral("stand:scale")] = c.int8Scale;
+    global[QStringLiteral("stand:index_interval_s")] = kIndexIntervalSec;
+
+    for (const auto& cap : c.captures) {
+        QJsonObject o;
+        o[QStringLiteral("core:sample_start")] = static_cast<double>(cap.sampleStart);
+        o[QStringLiteral("core:frequency")]    = cap.centerHz;
+        o[QStringLiteral("core:datetime")]     = isoUtc(cap.unixMs);
+        if (cap.hwKnown)
+            o[QStringLiteral("stand:hw_timestamp")] = static_cast<double>(cap.hwTimestamp);
+        captures.append(o);
+    }
+    for (const auto& g : c.gains) {
+        QJsonObject o;
+        o[QStringLiteral("core:sample_start")] = static_cast<double>(g.sample);
+        o[QStringLiteral("core:sample_count")] = 0;
+        o[QStringLiteral("core:label")]        = QStringLiteral("gain");
+        o[QStringLiteral("stand:channel")]     = g.channel;
+        o[QStringLiteral("stand:gain_db")]     = g.gainDb;
+        annotations.append(o);
+    }
+    for (const auto& p : c.index) {
+        index.append(QJsonArray{static_cast<double>(p.sample),
+                                static_cast<double>(p.byteOffset),
+                                static_cast<double>(p.hwTimestamp),
+                                static_cast<double>(p.unixMs)});
+    }
+    global[QStringLiteral("stand:index")] = index;
+
+    QJsonObject root;
+    root[QStringLiteral("global")]      = global;
+    root[QStringLiteral("captures")]    = captures;
+    root[QStringLiteral("annotations")] = annotations;
+    return QJsonDocument(root).toJson(QJsonDocument::Indented);
+}
+
+bool SigMfWriter::save(const Sidecar& sidecar) {
+    QSaveFile f(sidecar.path);
+    if (!f.open(QIODevice::WriteOnly)) {
+        LOG_WARN("SigMfWriter: cannot write " + sidecar.path.toStdString());
+        return false;
+    }
+    f.write(sidecar.json);
+    return f.commit();
+}
@@ -0,0 +1,127 @@
+#pragma once
+
+#include "../Core/RecordingSettings.h"
+
+#include <QByteArray>
+#include <QString>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// SigMfWriter — builds the SigMF `.sigmf-meta` sidecar for one raw I/Q file.
+//
+// The data file keeps its Stand name and extension, so the metadata names it
+// in `core:dataset` (SigMF non-conforming dataset) and sits next to it with
+// the extension replaced: 20260412_153045_rx0_….cf32 → …_rx0_….sigmf-meta.
+//
+//   captures    — one segment per LO (start + every retune), with the UTC
+//                 time and the first hardware timestamp of the segment
+//   annotations — gain changes (`stand:gain_db`, `stand:channel`)
+//   stand:index — every kIndexIntervalSec of written samples:
+//                 [sample, byteOffset, hwTimestamp, unixMs]. Entries are
+//                 ~uniform in time, so entry ≈ (t − t0) / interval, then a
+//                 short walk; byteOffset is −1 for .ci16z (use its block index).
+//
+// Sample positions count what actually reached the file (dropped blocks are
+// excluded). All methods are thread-safe: blocks arrive on the stream thread,
+// retune and gain events on the UI thread. The lock only guards copying the
+// state; snapshot() serialises the copy outside it, so a rewrite never holds
+// up onBlockWritten().
+//
+// Crash resilience: onBlockWritten() reports when kRewriteIndexPoints new
+// index entries have accumulated since the last rewrite; the caller then
+// rewrites the sidecar off the stream thread (as it does on retune and gain
+// changes), so a crash loses at most that much of the index.
+//
+// Segmented recordings get one sidecar per segment: nextSegment() snapshots
+// the finished one (written off the hot path by the caller) and restarts at
+// sample 0 with the current LO and the last gain of every channel.
+// ---------------------------------------------------------------------------
+class SigMfWriter {
+public:
+    using Format = RecordingSettings::RawFormat;
+
+    static constexpr double kIndexIntervalSec  = 1.0;
+    static constexpr int    kRewriteIndexPoints = 10;   // ≈ 10 s between rewrites
+
+    explicit SigMfWriter(const QString& dataPath, QString description = {});
+
+    [[nodiscard]] static QString metaPathFor(const QString& dataPath);
+    [[nodiscard]] static QString datatypeFor(Format format);
+
+    struct Sidecar {
+        QString    path;
+        QByteArray json;
+    };
+
+    [[nodiscard]] QString metaPath() const;
+
+    // Resets all state; the first capture segment starts at sample 0.
+    void begin(Format format, double sampleRateHz, double centerHz);
+
+    // After a block reached the file: first sample index, pair count and the
+    // block's hardware counter (0 if unknown). Returns true when the sidecar
+    // is due for a periodic rewrite.
+    bool onBlockWritten(uint64_t firstSample, uint64_t pairs, uint64_t hwTimestamp);
+
+    void onRetune(uint64_t sample, double centerHz);
+    void onGain(uint64_t sample, int channelIndex, double gainDb);
+    void setInt8Scale(double scale);
+
+    // Serialises everything so far. Safe to call repeatedly (crash resilience).
+    bool write() const { return save(snapshot()); }
+    [[nodiscard]] Sidecar snapshot() const;
+    static bool save(const Sidecar& sidecar);
+
+    // The data moved on to a new segment file; returns the finished segment.
+    Sidecar nextSegment(const QString& dataPath);
+
+private:
+    struct Capture {
+        uint64_t sampleStart{0};
+        double   centerHz{0.0};
+        qint64   unixMs{0};
+        uint64_t hwTimestamp{0};
+        bool     hwKnown{false};
+    };
+    struct GainEvent {
+        uint64_t sample{0};
+        int      channel{0};
+        double   gainDb{0.0};
+    };
+    struct IndexPoint {
+        uint64_t sample{0};
+        int64_t  byteOffset{0};
+        uint64_t hwTimestamp{0};
+        qint64   unixMs{0};
+    };
+
+    // Everything one sidecar holds, copied out under mutex_.
+    struct Contents {
+        QString  dataPath;
+        QString  metaPath;
+        Format   format{Format::Float32};
+        double   sampleRateHz{0.0};
+        double   int8Scale{0.0};
+        std::vector<Capture>    captures;
+        std::vector<GainEvent>  gains;
+        std::vector<IndexPoint> index;
+    };
+    [[nodiscard]] Contents   contents() const;   // mutex_ held
+    [[nodiscard]] QByteArray serialise(const Contents& c) const;
+
+    QString description_;
+
+    mutable std::mutex mutex_;
+    QString  dataPath_;
+    QString  metaPath_;
+    Format   format_{Format::Float32};
+    double   sampleRateHz_{0.0};
+    double   int8Scale_{0.0};
+    uint64_t nextIndexSample_{0};
+    int      unsavedIndexPoints_{0};
+    std::vector<Capture>    captures_;
+    std::vector<GainEvent>  gains_;
+    std::vector<IndexPoint> index_;
+};
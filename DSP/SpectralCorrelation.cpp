@@ -0,0 +1,177 @@
+#include "SpectralCorrelation.h"
+#include "DspUtils.h"
+#include "FftProcessor.h"
+
+#include <QThreadPool>
+#include <QtConcurrent/QtConcurrent>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+double CyclicProfile::peakAlphaHz(double minAlphaHz) const {
+    if (magnitude.isEmpty() || resolutionHz <= 0.0) return 0.0;
+    const int first = centre + std::max(1, static_cast<int>(std::ceil(minAlphaHz / resolutionHz)));
+    int best = -1;
+    for (int i = first; i < magnitude.size(); ++i)
+        if (best < 0 || magnitude[i] > magnitude[best]) best = i;
+    return best < 0 ? 0.0 : alphaHz(best);
+}
+
+SpectralCorrelation::SpectralCorrelation()
+    : SpectralCorrelation(Options{})
+{}
+
+SpectralCorrelation::SpectralCorrelation(const Options& options)
+    : options_(options)
+{
+    const int np = options_.channels;
+    if (np < 8 || (np & (np - 1)) != 0)
+        throw std::invalid_argument("SpectralCorrelation: channels must be a power of two >= 8");
+    if (options_.maxBlocks < 8)
+        throw std::invalid_argument("SpectralCorrelation: maxBlocks must be >= 8");
+
+    // Hann with unit energy: white noise of power σ² reads σ² in every bin.
+    window_.resize(static_cast<std::size_t>(np));
+    double energy = 0.0;
+    for (int n = 0; n < np; ++n) {
+        window_[n] = static_cast<float>(0.5 - 0.5 * std::cos(2.0 * dsp::kPi * n / np));
+        energy += static_cast<double>(window_[n]) * window_[n];
+    }
+    const auto scale = static_cast<float>(1.0 / std::sqrt(energy));
+    for (float& w : window_) w *= scale;
+}
+
+int SpectralCorrelation::blocksFor(int count) const {
+    const int np  = options_.channels;
+    const int hop = np / 4;
+    if (count < np) return 0;
+    const int blocks = std::min(options_.maxBlocks, (count - np) / hop + 1);
+    return blocks - blocks % 8;
+}
+
+// Runs fn(task, index) for index 0 .. count − 1 on the pool and waits; one
+// task runs inline.
+template <typename Fn>
+void SpectralCorrelation::runTasks(int count, Fn&& fn) {
+    if (static_cast<int>(tasks_.size()) < count) tasks_.resize(static_cast<std::size_t>(count));
+    if (count == 1) { fn(tasks_[0], 0); return; }
+
+    QThreadPool* pool = options_.pool ? options_.pool : QThreadPool::globalInstance();
+    QVector<QFuture<void>> running;
+    running.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        Task* task = &tasks_[i];
+        running.append(QtConcurrent::run(pool, [&fn, task, i] { fn(*task, i); }));
+    }
+    for (QFuture<void>& f : running) f.waitForFinished();
+}
+
+CyclicProfile SpectralCorrelation::profile(const float* iq, int count, double sampleRateHz) {
+    const int np     = options_.channels;
+    const int hop    = np / 4;
+    const int blocks = blocksFor(count);
+
+    CyclicProfile out;
+    out.sampleRateHz = sampleRateHz;
+    if (blocks < 8) return out;
+
+    out.resolutionHz = sampleRateHz / (static_cast<double>(blocks) * hop);
+    out.centre       = np * blocks / 4;
+
+    const QThreadPool* pool = options_.pool ? options_.pool : QThreadPool::globalInstance();
+    const int tasks = std::clamp(options_.tasks > 0 ? options_.tasks : pool->maxThreadCount(), 1, np);
+
+    // ── Stage 1: channelise, split by block ──────────────────────────────────
+    channels_.resize(static_cast<std::size_t>(np) * blocks);
+    const int per1 = (blocks + tasks - 1) / tasks;
+    const int tasks1 = (blocks + per1 - 1) / per1;
+    runTasks(tasks1, [&](Task& task, int i) {
+        channelise(iq, blocks, i * per1, std::min(blocks, (i + 1) * per1), task);
+    });
+
+    // ── Stage 2: correlate, split by k1 ──────────────────────────────────────
+    const int size = np * blocks / 2;
+    const int per2 = (np + tasks - 1) / tasks;
+    const int tasks2 = (np + per2 - 1) / per2;
+    runTasks(tasks2, [&](Task& task, int i) {
+        task.profile.assign(static_cast<std::size_t>(size), 0.0f);
+        correlate(blocks, i * per2, std::min(np, (i + 1) * per2), task);
+    });
+
+    out.magnitude.resize(size);
+    std::fill(out.magnitude.begin(), out.magnitude.end(), 0.0f);
+    for (int t = 0; t < tasks2; ++t)
+        for (int a = 0; a < size; ++a)
+            out.magnitude[a] = std::max(out.magnitude[a], tasks_[t].profile[a]);
+    return out;
+}
+
+void SpectralCorrelation::channelise(const float* iq, int blocks, int firstBlock, int lastBlock,
+                                     Task& task)
+{
+    const int np  = options_.channels;
+    const int hop = np / 4;
+    const int n   = lastBlock - firstBlock;
+    if (n <= 0) return;
+
+    const std::size_t total = static_cast<std::size_t>(np) * n;
+    task.in.resize(total);
+    task.out.resize(total);
+    for (int b = 0; b < n; ++b) {
+        const float* x = iq + 2 * static_cast<std::size_t>(firstBlock + b) * hop;
+        Complex*     y = task.in.data() + static_cast<std::size_t>(b) * np;
+        for (int i = 0; i < np; ++i)
+            y[i] = Complex(x[2 * i] * window_[i], x[2 * i + 1] * window_[i]);
+    }
+    FftProcessor::transformBatch(task.in.data(), task.out.data(), np, n);
+
+    // Bin m (signed) of block p is mixed down by e^(−j2π·m·p·L/Np) =
+    // (−j)^(m·p) for L = Np / 4, and stored DC-centred at k = m + Np / 2.
+    for (int b = 0; b < n; ++b) {
+        const int p = firstBlock + b;
+        const Complex* X = task.out.data() + static_cast<std::size_t>(b) * np;
+        for (int bin = 0; bin < np; ++bin) {
+            const int m = bin < np / 2 ? bin : bin - np;
+            const Complex v = X[bin];
+            Complex r;
+            switch (((m * p) % 4 + 4) % 4) {
+                case 0:  r = v;                             break;
+                case 1:  r = Complex(v.imag(), -v.real());  break;   // × −j
+                case 2:  r = -v;                            break;
+                default: r = Complex(-v.imag(), v.real());  break;   // × j
+            }
+            channels_[static_cast<std::size_t>(m + np / 2) * blocks + p] = r;
+        }
+    }
+}
+
+void SpectralCorrelation::correlate(int blocks, int k1Begin, int k1End, Task& task) const {
+    const int np     = options_.channels;
+    const int centre = np * blocks / 4;
+    const int keep   = blocks / 8;
+    const float scale = 1.0f / static_cast<float>(blocks);
+
+    const std::size_t total = static_cast<std::size_t>(np) * blocks;
+    task.in.resize(total);
+    task.out.resize(total);
+
+    for (int k1 = k1Begin; k1 < k1End; ++k1) {
+        const Complex* x1 = channels_.data() + static_cast<std::size_t>(k1) * blocks;
+        for (int k2 = 0; k2 < np; ++k2) {
+            const Complex* x2 = channels_.data() + static_cast<std::size_t>(k2) * blocks;
+            Complex*       z  = task.in.data() + static_cast<std::size_t>(k2) * blocks;
+            for (int p = 0; p < blocks; ++p) z[p] = x1[p] * std::conj(x2[p]);
+        }
+        FftProcessor::transformBatch(task.in.data(), task.out.data(), blocks, np);
+
+        for (int k2 = 0; k2 < np; ++k2) {
+            const Complex* s    = task.out.data() + static_cast<std::size_t>(k2) * blocks;
+            float*         prof = task.profile.data() + centre + (k1 - k2) * blocks / 4;
+            for (int q = -keep; q < keep; ++q) {
+                const float mag = std::abs(s[q < 0 ? q + blocks : q]) * scale;
+                prof[q] = std::max(prof[q], mag);
+            }
+        }
+    }
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <QVector>
+#include <complex>
+#include <vector>
+
+class QThreadPool;
+
+// ---------------------------------------------------------------------------
+// CyclicProfile — max over f of |S_x^α(f)| for every cyclic frequency α on a
+// grid of resolutionHz, from −sampleRateHz to +sampleRateHz.
+//
+// α = 0 is the ordinary power spectrum (its peak); digital modulations add
+// lines at multiples of the symbol rate that energy spectra do not show.
+// ---------------------------------------------------------------------------
+struct CyclicProfile {
+    double          sampleRateHz{0.0};
+    double          resolutionHz{0.0};   // Δα
+    int             centre{0};           // index of α = 0
+    QVector<float>  magnitude;
+
+    [[nodiscard]] double alphaHz(int index) const { return (index - centre) * resolutionHz; }
+    // α ≥ minAlphaHz with the largest magnitude (positive side; the profile
+    // is symmetric); 0 when there is none.
+    [[nodiscard]] double peakAlphaHz(double minAlphaHz) const;
+};
+
+// ---------------------------------------------------------------------------
+// SpectralCorrelation — FFT Accumulation Method (FAM) estimate of the
+// spectral correlation function of a narrowband snippet, reduced to its
+// cyclic-frequency profile.
+//
+//   1. Channelise: P blocks of Np samples, hop L = Np / 4, Hann window, one
+//      batched Np-point FFT (FftProcessor::transformBatch), then each bin is
+//      mixed down to baseband — with L = Np / 4 that is a quarter-turn
+//      rotation per block, no trigonometry.
+//   2. Correlate: for every channel pair (k1, k2) a P-point FFT over the
+//      blocks of X_k1 · X_k2*. Output q is α = f_k1 − f_k2 + q · Δα with
+//      Δα = fs / (P · L); only |q| ≤ P / 8 is kept, which tiles the α axis
+//      once per pair diagonal. The Np pairs of one k1 are one batched FFT.
+//
+// Both stages run on a QThreadPool (Options::pool, nullptr = the global
+// pool): stage 1 split by block, stage 2 by k1. Each stage-2 task folds its
+// rows into a private profile, so the full Np² · P surface is never stored. Memory is O(Np · P) per task, and
+// Options::maxBlocks caps P — samples beyond Np + (P − 1) · L are ignored.
+//
+// profile() may be called from any thread; one instance must not be used by
+// two threads at once.
+// ---------------------------------------------------------------------------
+class SpectralCorrelation {
+public:
+    struct Options {
+        int          channels{32};     // Np, power of two ≥ 8
+        int          maxBlocks{256};   // P upper bound
+        int          tasks{0};         // per stage; 0 = the pool's thread count
+        QThreadPool* pool{nullptr};    // nullptr = QThreadPool::globalInstance()
+    };
+
+    SpectralCorrelation();
+    // Throws std::invalid_argument unless channels is a power of two ≥ 8
+    // and maxBlocks ≥ 8.
+    explicit SpectralCorrelation(const Options& options);
+
+    // Empty profile when count < channels + 7 · hop (fewer than 8 blocks).
+    [[nodiscard]] CyclicProfile profile(const float* iq, int count, double sampleRateHz);
+
+    // P used for `count` samples: a multiple of 8, at most maxBlocks.
+    [[nodiscard]] int blocksFor(int count) const;
+
+    [[nodiscard]] const Options& options() const { return options_; }
+
+private:
+    using Complex = std::complex<float>;
+
+    // Per-task scratch, kept between calls.
+    struct Task {
+        std::vector<Complex> in, out;
+        std::vector<float>   profile;
+    };
+
+    template <typename Fn> void runTasks(int count, Fn&& fn);
+    void channelise(const float* iq, int blocks, int firstBlock, int lastBlock, Task& task);
+    void correlate(int blocks, int k1Begin, int k1End, Task& task) const;
+
+    Options              options_;
+    std::vector<float>   window_;     // Hann, scaled to unit energy
+    std::vector<Complex> channels_;   // [k · P + p]: channel k, block p, at baseband
+    std::vector<Task>    tasks_;
+};
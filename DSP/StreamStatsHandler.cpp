@@ -0,0 +1,67 @@
+#include "StreamStatsHandler.h"
+
+#include <cmath>
+
+namespace {
+// RxWorker normalises int16 by 1/32768, so full scale reads back as ±1.0 and
+// +32767 as 1 − 2⁻¹⁵.
+constexpr float kFullScale = 32767.0f / 32768.0f;
+}
+
+void StreamStatsHandler::onStreamStarted(double sampleRateHz) {
+    blocks_->reset();
+    pairs_->reset();
+    gaps_->reset();
+    lostPairs_->reset();
+    clipped_->reset();
+    sampleRate_.store(sampleRateHz);
+    nextTimestamp_ = 0;
+}
+
+void StreamStatsHandler::processBlock(const float* iq, int count, double sampleRateHz) {
+    processBlock(iq, count, sampleRateHz, BlockMeta{});
+}
+
+void StreamStatsHandler::processBlock(const float* iq, int count, double sampleRateHz,
+                                      const BlockMeta& meta) {
+    if (count <= 0) return;
+    sampleRate_.store(sampleRateHz, std::memory_order_relaxed);
+
+    if (meta.timestamp != 0) {
+        if (nextTimestamp_ != 0 && meta.timestamp != nextTimestamp_) {
+            gaps_->inc();
+            if (meta.timestamp > nextTimestamp_)
+                lostPairs_->inc(meta.timestamp - nextTimestamp_);
+        }
+        nextTimestamp_ = meta.timestamp + static_cast<uint64_t>(count);
+    }
+
+    uint64_t clipped = 0;
+    for (int i = 0; i < count; ++i) {
+        if (std::abs(iq[2 * i]) >= kFullScale || std::abs(iq[2 * i + 1]) >= kFullScale)
+            ++clipped;
+    }
+    if (clipped) clipped_->inc(clipped);
+
+    blocks_->inc();
+    pairs_->inc(static_cast<uint64_t>(count));
+}
+
+void StreamStatsHandler::publishMetrics(const Metrics::Labels& labels) {
+    auto& reg = Metrics::Registry::instance();
+    reg.add("stand_stream_gaps_total", "Hardware timestamp discontinuities.", labels, gaps_);
+    reg.add("stand_stream_lost_samples_total", "I/Q pairs skipped by timestamp gaps.",
+            labels, lostPairs_);
+    reg.add("stand_stream_clipped_samples_total", "I/Q pairs at full scale.", labels, clipped_);
+}
+
+StreamStatsHandler::Snapshot StreamStatsHandler::snapshot() const {
+    Snapshot s;
+    s.blocks       = blocks_->value();
+    s.pairs        = pairs_->value();
+    s.gaps         = gaps_->value();
+    s.lostPairs    = lostPairs_->value();
+    s.clippedPairs = clipped_->value();
+    s.sampleRateHz = sampleRate_.load(std::memory_order_relaxed);
+    return s;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "../Core/IPipelineHandler.h"
+#include "../Core/Metrics.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+// ---------------------------------------------------------------------------
+// StreamStatsHandler — counts what a Pipeline delivered: blocks, I/Q pairs,
+// hardware-timestamp discontinuities and full-scale samples.
+//
+// A gap is a block whose BlockMeta::timestamp is not where the previous one
+// ended (device FIFO overrun or a dropped USB transfer); lostPairs sums the
+// forward jumps. Blocks without timestamps are counted but not checked —
+// place the handler on a PrePipeline, where the hardware counter is intact.
+//
+// processBlock() runs on the stream thread; snapshot() from any thread.
+// ---------------------------------------------------------------------------
+class StreamStatsHandler : public IPipelineHandler {
+public:
+    struct Snapshot {
+        uint64_t blocks{0};
+        uint64_t pairs{0};
+        uint64_t gaps{0};
+        uint64_t lostPairs{0};
+        uint64_t clippedPairs{0};   // |I| or |Q| at full scale
+        double   sampleRateHz{0.0};
+    };
+
+    void processBlock(const float* iq, int count, double sampleRateHz) override;
+    void processBlock(const float* iq, int count, double sampleRateHz,
+                      const BlockMeta& meta) override;
+    void onStreamStarted(double sampleRateHz) override;
+
+    [[nodiscard]] Snapshot snapshot() const;
+
+    // Exports gaps, lost and clipped pairs as stand_stream_* counters.
+    void publishMetrics(const Metrics::Labels& labels);
+
+private:
+    using CounterPtr = std::shared_ptr<Metrics::Counter>;
+    CounterPtr blocks_    = std::make_shared<Metrics::Counter>();
+    CounterPtr pairs_     = std::make_shared<Metrics::Counter>();
+    CounterPtr gaps_      = std::make_shared<Metrics::Counter>();
+    CounterPtr lostPairs_ = std::make_shared<Metrics::Counter>();
+    CounterPtr clipped_   = std::make_shared<Metrics::Counter>();
+    std::atomic<double>   sampleRate_{0.0};
+    uint64_t              nextTimestamp_{0};   // stream thread only, 0 = unknown
+};
@@ -0,0 +1,111 @@
+#include "FileReplayDevice.h"
+#include "Logger.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <thread>
+
+FileReplayDevice::FileReplayDevice(Config config, QObject* parent)
+    : IDevice(parent)
+    , config_(std::move(config))
+{}
+
+void FileReplayDevice::setState(DeviceState s) {
+    if (state_.exchange(s) != s) emit stateChanged(s);
+}
+
+void FileReplayDevice::init(const QList<ChannelDescriptor>& /*channels*/) {
+    if (!reader_.open(config_.path))
+        throw std::runtime_error("FileReplayDevice: cannot read " + config_.path.toStdString());
+
+    sampleRate_ = config_.sampleRateHz > 0.0 ? config_.sampleRateHz : reader_.sigmfSampleRate();
+    if (sampleRate_ <= 0.0) {
+        reader_.close();
+        throw std::runtime_error("FileReplayDevice: no sample rate for "
+                                 + config_.path.toStdString() + " (no SigMF sidecar)");
+    }
+    frequency_.store(config_.centerHz > 0.0 ? config_.centerHz : reader_.sigmfCenterHz());
+
+    LOG_CAT(LogCat::kDeviceLifecycle, LogLevel::Info,
+            "FileReplayDevice: " + config_.path.toStdString() + ", "
+            + std::to_string(reader_.totalPairs()) + " pairs at "
+            + std::to_string(sampleRate_) + " Sps"
+            + (config_.loop ? ", looping" : "")
+            + (config_.realtime ? "" : ", free-running"));
+    setState(DeviceState::Ready);
+}
+
+void FileReplayDevice::close() {
+    reader_.close();
+    setState(DeviceState::Connected);
+}
+
+void FileReplayDevice::setSampleRate(double hz) {
+    // A recording has one rate; a different request is a configuration error
+    // upstream, not something to resample here.
+    if (sampleRate_ > 0.0 && std::abs(hz - sampleRate_) > 0.5)
+        LOG_WARN("FileReplayDevice: recording is " + std::to_string(sampleRate_)
+                 + " Sps, ignoring request for " + std::to_string(hz));
+}
+
+void FileReplayDevice::startStream() {
+    if (state_.load() == DeviceState::Streaming) return;
+    if (!reader_.isOpen()) throw std::runtime_error("FileReplayDevice: not initialised");
+    reader_.seek(0);
+    nextSample_.store(0);
+    eofSignalled_ = false;
+    lastTimestamp_.store(0);
+    startedAt_    = Clock::now();
+    setState(DeviceState::Streaming);
+}
+
+void FileReplayDevice::stopStream() {
+    if (state_.load() == DeviceState::Streaming) setState(DeviceState::Ready);
+}
+
+uint64_t FileReplayDevice::lastReadTimestamp(ChannelDescriptor /*ch*/) const {
+    return lastTimestamp_.load();
+}
+
+int FileReplayDevice::readBlock(int16_t* buffer, int count, int timeoutMs) {
+    if (state_.load() != DeviceState::Streaming || count <= 0) return -1;
+
+    if (config_.realtime) {
+        const auto due = startedAt_ + std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double>(static_cast<double>(nextSample_.load() + count) / sampleRate_));
+        const auto now = Clock::now();
+        if (due - now > std::chrono::milliseconds(timeoutMs)) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(timeoutMs));
+            return 0;
+        }
+        std::this_thread::sleep_until(due);
+    }
+
+    floatBuf_.resize(2 * static_cast<std::size_t>(count));
+    int n = reader_.read(floatBuf_.data(), count);
+    if (n == 0 && config_.loop && reader_.totalPairs() > 0) {
+        reader_.seek(0);
+        n = reader_.read(floatBuf_.data(), count);
+    }
+    if (n == 0) {
+        if (!eofSignalled_) {
+            eofSignalled_ = true;
+            LOG_CAT(LogCat::kStreamIo, LogLevel::Info,
+                    "FileReplayDevice: end of " + config_.path.toStdString());
+            emit endOfFile();
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(timeoutMs));
+        return 0;
+    }
+
+    // Inverse of RxWorker's / 32768 — exact for int16-origin recordings.
+    for (int i = 0; i < 2 * n; ++i) {
+        const float v = std::clamp(floatBuf_[i] * 32768.0f, -32768.0f, 32767.0f);
+        buffer[i] = static_cast<int16_t>(std::lrint(v));
+    }
+
+    lastTimestamp_.store(nextSample_.load());
+    nextSample_.fetch_add(static_cast<uint64_t>(n));
+    return n;
+}
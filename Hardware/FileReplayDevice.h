@@ -0,0 +1,89 @@
+#pragma once
+
+#include "../Core/IDevice.h"
+#include "../DSP/IqFileReader.h"
+
+#include <QString>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// FileReplayDevice — IDevice that plays a raw I/Q recording (any format
+// IqFileReader reads) back as a single RX0 stream.
+//
+// Sample rate and LO come from the recording's SigMF sidecar unless given
+// in Config. Samples are re-quantised to int16 at the hardware boundary, so
+// .ci16/.ci12/.ci16z recordings replay bit-exactly into the Pipeline.
+// realtime = true paces readBlock() to the sample rate; false replays as
+// fast as the Pipeline consumes (offline processing, benchmarks).
+//
+// At end of file the recording restarts (loop) or endOfFile() is emitted
+// once from the worker thread and readBlock() idles until stopped.
+// setFrequency() only relabels the stream — the recording cannot retune.
+// ---------------------------------------------------------------------------
+class FileReplayDevice : public IDevice {
+    Q_OBJECT
+
+public:
+    struct Config {
+        QString path;
+        double  sampleRateHz{0.0};   // 0 = from SigMF
+        double  centerHz{0.0};       // 0 = from SigMF
+        bool    loop{false};
+        bool    realtime{true};
+    };
+
+    explicit FileReplayDevice(Config config, QObject* parent = nullptr);
+
+    [[nodiscard]] QString id()   const override { return QStringLiteral("file"); }
+    [[nodiscard]] QString name() const override { return QStringLiteral("Replay: ") + config_.path; }
+
+    // Opens the recording; throws std::runtime_error if it cannot be read or
+    // its sample rate is unknown.
+    void init(const QList<ChannelDescriptor>& channels = {}) override;
+    void close() override;
+
+    void   setSampleRate(double hz) override;
+    [[nodiscard]] double sampleRate() const override { return sampleRate_; }
+    [[nodiscard]] QList<double> supportedSampleRates() const override { return {sampleRate_}; }
+
+    void   setFrequency(double hz) override { frequency_.store(hz); }
+    [[nodiscard]] double frequency() const override { return frequency_.load(); }
+    void   setGain(double /*dB*/) override {}
+    [[nodiscard]] double gain()    const override { return 0.0; }
+    [[nodiscard]] double maxGain() const override { return 0.0; }
+
+    void startStream() override;
+    void stopStream()  override;
+    int  readBlock(int16_t* buffer, int count, int timeoutMs) override;
+    [[nodiscard]] uint64_t lastReadTimestamp(ChannelDescriptor ch) const override;
+
+    [[nodiscard]] DeviceState state() const override { return state_.load(); }
+
+    // Pairs replayed so far (all passes) / in the file (one pass).
+    [[nodiscard]] uint64_t position()   const { return nextSample_.load(); }
+    [[nodiscard]] uint64_t totalPairs() const { return reader_.totalPairs(); }
+
+signals:
+    void endOfFile();
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    void setState(DeviceState s);
+
+    Config              config_;
+    IqFileReader        reader_;
+    double              sampleRate_{0.0};
+    std::atomic<double> frequency_{0.0};
+    std::atomic<DeviceState> state_{DeviceState::Connected};
+
+    // Written by the worker thread only
+    std::vector<float>    floatBuf_;
+    Clock::time_point     startedAt_{};
+    bool                  eofSignalled_{false};
+    std::atomic<uint64_t> nextSample_{0};
+    std::atomic<uint64_t> lastTimestamp_{0};
+};
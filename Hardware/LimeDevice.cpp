@@ -1,13 +1,7 @@
 #include "LimeDevice.h"
 #include "LimeException.h"
 #include "Logger.h"
-
-#include <QComboBox>
-#include <QHBoxLayout>
-#include <QLabel>
-#include <QSlider>
-#include <QVBoxLayout>
-#include <QWidget>
+#include "Trace.h"
 
 #include <algorithm>
 #include <cctype>
@@ -108,6 +102,10 @@ LimeDevice::LimeDevice(const lms_info_str_t& id, QObject* parent)
 {
     std::memcpy(deviceId_, id, sizeof(lms_info_str_t));
     serial_ = parseSerial(id);
+    temperatureMetric_ = Metrics::Registry::instance().gauge(
+        "stand_device_temperature_celsius", "LMS7002M chip temperature (last reading).",
+        {{"device", serial_}});
+    temperatureMetric_->set(std::nan(""));
     LOG_CAT(LogCat::kDeviceLifecycle, LogLevel::Debug, "LimeDevice created: " + serial_);
 }
 
@@ -600,6 +598,7 @@ void LimeDevice::setGain(ChannelDescriptor ch, double dB) {
     LMS_WriteParam(handle_, LMS7_G_TIA_RFE, kDefaultTia);
 
     currentGainDb_[idx] = dB;
+    emit gainChanged(ch, dB);
     LOG_CAT(LogCat::kDeviceLifecycle, LogLevel::Info,
             "Gain RX" + std::to_string(idx) + ": "
             + std::to_string(dB) + " dB  PGA=" + std::to_string(pgaVal)
@@ -796,6 +795,7 @@ void LimeDevice::checkPauseForRetune(ChannelDescriptor ch) {
 }
 
 void LimeDevice::performStreamingRetune(int idx, double hz) {
+    TRACE_SCOPE("retune", "performStreamingRetune");
     // Snapshot key data while not yet parked so we fail fast on a bad idx.
     auto it = streams_.find({ChannelDescriptor::RX, idx});
     if (it == streams_.end()) {
@@ -809,6 +809,7 @@ void LimeDevice::performStreamingRetune(int idx, double hz) {
 
     // ── Phase 1: park the worker ─────────────────────────────────────────────
     {
+        TRACE_SCOPE("retune", "park worker");
         std::unique_lock lock(retuneMutex_);
         retuneInProgress_[idx] = true;
         retuneCv_.notify_all();
@@ -835,10 +836,18 @@ void LimeDevice::performStreamingRetune(int idx, double hz) {
     // Stop → change LO → restart to flush FPGA FIFO.
     // LMS_StopStream / LMS_StartStream only affect this channel's stream;
     // the other channel (dual RX) keeps streaming uninterrupted.
-    LMS_StopStream(&it->second);
+    {
+        TRACE_SCOPE("retune", "LMS_StopStream");
+        LMS_StopStream(&it->second);
+    }
 
     bool ok = true;
-    if (LMS_SetLOFrequency(handle_, LMS_CH_RX, idx, hz) != 0) {
+    int loStatus = 0;
+    {
+        TRACE_SCOPE("retune", "LMS_SetLOFrequency");
+        loStatus = LMS_SetLOFrequency(handle_, LMS_CH_RX, idx, hz);
+    }
+    if (loStatus != 0) {
         LOG_WARN("LMS_SetLOFrequency (retune) failed: RX" + std::to_string(idx));
         ok = false;
     } else {
@@ -861,7 +870,12 @@ void LimeDevice::performStreamingRetune(int idx, double hz) {
             resetDcAfterRetune(other);
     }
 
-    if (LMS_StartStream(&it->second) != 0) {
+    int startStatus = 0;
+    {
+        TRACE_SCOPE("retune", "LMS_StartStream");
+        startStatus = LMS_StartStream(&it->second);
+    }
+    if (startStatus != 0) {
         LOG_WARN("LMS_StartStream after retune failed: RX" + std::to_string(idx));
         ok = false;
     }
@@ -873,7 +887,10 @@ void LimeDevice::performStreamingRetune(int idx, double hz) {
     // DirectConnection: pipeline_->notifyRetune(hz) runs synchronously here,
     // so handler DSP state (FIR delay line, NCO phase, decimation counter)
     // is reset while the worker is still parked — race-free.
-    emit retuned({ChannelDescriptor::RX, idx}, hz);
+    {
+        TRACE_SCOPE("retune", "notify handlers");
+        emit retuned({ChannelDescriptor::RX, idx}, hz);
+    }
 
     // ── Phase 4: release the worker ──────────────────────────────────────────
     {
@@ -907,6 +924,7 @@ double LimeDevice::temperature() const {
     float_type t = 0;
     if (LMS_GetChipTemperature(handle_, 0, &t) != 0)
         return std::nan("");
+    temperatureMetric_->set(static_cast<double>(t));
     return static_cast<double>(t);
 }
 
@@ -1,10 +1,12 @@
 #pragma once
 
 #include "../Core/IDevice.h"
+#include "../Core/Metrics.h"
 #include "lime/LimeSuite.h"
 
 #include <condition_variable>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <set>
 #include <string>
@@ -133,6 +135,7 @@ private:
     lms_device_t*  handle_{nullptr};
     lms_info_str_t deviceId_{};
     std::string    serial_;
+    std::shared_ptr<Metrics::Gauge> temperatureMetric_;   // last temperature() reading
 
     // ── Per-channel state ─────────────────────────────────────────────────────
     // RX index 0/1 = RX channel 0/1.  TX index 0/1 = TX channel 0/1.
@@ -2,7 +2,22 @@
 #include "IDevice.h"
 #include "Pipeline.h"
 #include "IPipelineHandler.h"
+#include "IqFormats.h"
+#include "LatencyHistogram.h"
 #include "Logger.h"
+#include "Metrics.h"
+#include "Trace.h"
+
+#include <chrono>
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+void recordSince(LatencyHistogram* h, Clock::time_point t0) {
+    if (h) h->record(static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - t0).count()));
+}
+}  // namespace
 
 RxWorker::RxWorker(IDevice* device, Pipeline* pipeline,
                            ChannelDescriptor channel, QObject* parent)
@@ -13,14 +28,28 @@ RxWorker::RxWorker(IDevice* device, Pipeline* pipeline,
 {
     buffer_.resize(kBlockSize * 2);     // interleaved I/Q: count * 2 int16
     floatBuf_.resize(kBlockSize * 2);   // normalized float32 copy
+
+    auto& reg = Metrics::Registry::instance();
+    const Metrics::Labels labels{{"device", device_->id().toStdString()},
+                                 {"channel", "RX" + std::to_string(channel_.channelIndex)}};
+    blocksMetric_     = reg.counter("stand_rx_blocks_total", "Blocks read from the device.", labels);
+    samplesMetric_    = reg.counter("stand_rx_samples_total", "I/Q pairs read from the device.", labels);
+    shortReadsMetric_ = reg.counter("stand_rx_short_reads_total",
+                                    "Reads that returned fewer pairs than requested.", labels);
+    readMetric_       = reg.histogram("stand_rx_read_seconds", "Duration of one readBlock() call.",
+                                      Metrics::Histogram::latencyBuckets(), labels);
 }
 
+RxWorker::~RxWorker() = default;
+
 void RxWorker::stop() {
     running_.store(false);
 }
 
 void RxWorker::run() {
     const QString devId = device_->id();
+    Trace::setThreadName("RxWorker " + devId.toStdString() + " RX"
+                         + std::to_string(channel_.channelIndex));
     LOG_CAT(LogCat::kStreamIo, LogLevel::Info, "RxWorker started: " + devId.toStdString());
     emit statusMessage(QString("Streaming: %1").arg(devId));
 
@@ -51,7 +80,18 @@ void RxWorker::run() {
 
         // 100 ms timeout — keeps LMS_RecvStream from holding the device mutex
         // too long and blocking main-thread calls (e.g. LMS_SetLOFrequency).
-        const int n = device_->readBlock(channel_, buffer_.data(), kBlockSize, 100);
+        const auto tRead = Clock::now();
+        int n = 0;
+        {
+            TRACE_SCOPE("rx", "readBlock");
+            n = device_->readBlock(channel_, buffer_.data(), kBlockSize, 100);
+        }
+        if (n > 0) {
+            const auto elapsed = Clock::now() - tRead;
+            if (readLatency_) readLatency_->record(static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+            readMetric_->observe(std::chrono::duration<double>(elapsed).count());
+        }
 
         if (diagCount < 10) {
             LOG_CAT(LogCat::kStreamIo, LogLevel::Debug, "readBlock[" + std::to_string(diagCount) + "] = " + std::to_string(n));
@@ -67,17 +107,25 @@ void RxWorker::run() {
 
         // Log partial reads but don't stop — LimeSuite sometimes delivers
         // a smaller block after a USB hiccup and recovers on its own.
+        blocksMetric_->inc();
+        samplesMetric_->inc(static_cast<uint64_t>(n));
         if (n < kBlockSize) {
+            shortReadsMetric_->inc();
             LOG_WARN("readBlock partial: expected " + std::to_string(kBlockSize)
                      + " got " + std::to_string(n) + " — continuing");
         }
 
         // Single int16→float conversion at hardware boundary (/ 32768.0f → [-1, 1])
-        for (int i = 0; i < n * 2; ++i)
-            floatBuf_[i] = buffer_[i] * (1.0f / 32768.0f);
+        const auto tConvert = Clock::now();
+        {
+            TRACE_SCOPE("rx", "int16ToFloat");
+            IqFormats::int16ToFloat(buffer_.data(), floatBuf_.data(), static_cast<std::size_t>(n) * 2);
+        }
+        recordSince(convertLatency_, tConvert);
 
         pipeline_->dispatchBlock(floatBuf_.data(), n, sr,
-                                BlockMeta{channel_, device_->lastReadTimestamp(channel_)});
+                                BlockMeta{channel_, device_->lastReadTimestamp(channel_),
+                                          buffer_.data()});
     }
 
     pipeline_->notifyStopped();
@@ -4,10 +4,13 @@
 #include <QObject>
 #include <atomic>
 #include <cstdint>
+#include <memory>
 #include <vector>
 
 class IDevice;
+class LatencyHistogram;
 class Pipeline;
+namespace Metrics { class Counter; class Histogram; }
 
 // ---------------------------------------------------------------------------
 // RxWorker — чистый I/Q loop. Живёт в отдельном QThread.
@@ -28,6 +31,14 @@ public:
     RxWorker(IDevice* device, Pipeline* pipeline,
                  ChannelDescriptor channel = {},
                  QObject* parent = nullptr);
+    ~RxWorker() override;
+
+    // Optional per-block timing of readBlock() and the int16→float step
+    // (soak runs). Call before run(); either may be nullptr. Not owned.
+    void setReadTiming(LatencyHistogram* read, LatencyHistogram* convert) {
+        readLatency_    = read;
+        convertLatency_ = convert;
+    }
 
 public slots:
     void run();
@@ -44,6 +55,14 @@ private:
     Pipeline*         pipeline_;
     ChannelDescriptor channel_{};
     std::atomic<bool> running_{false};
+    LatencyHistogram* readLatency_{nullptr};
+    LatencyHistogram* convertLatency_{nullptr};
+
+    // stand_rx_* series, labelled with device and channel.
+    std::shared_ptr<Metrics::Counter>   blocksMetric_;
+    std::shared_ptr<Metrics::Counter>   samplesMetric_;
+    std::shared_ptr<Metrics::Counter>   shortReadsMetric_;
+    std::shared_ptr<Metrics::Histogram> readMetric_;
 
     // 16384 = 2^14: FFTW fast radix-2, помещается в USB transfer limit при любом SR.
     static constexpr int kBlockSize = 16384;
@@ -0,0 +1,271 @@
+#include "SimulatedDevice.h"
+#include "Logger.h"
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <numbers>
+#include <random>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+
+// Noise period in I/Q pairs — prime, so it never lines up with block sizes.
+constexpr std::size_t kNoisePairs = 65'521;
+constexpr int         kMaxChannels = 4;
+constexpr double      kTwoPi = 2.0 * std::numbers::pi;
+
+double dbToAmplitude(double db) { return std::pow(10.0, db / 20.0); }
+
+}  // namespace
+
+SimulatedDevice::SimulatedDevice(Config config, QObject* parent)
+    : IDevice(parent)
+    , config_(std::move(config))
+    , streams_(static_cast<std::size_t>(std::clamp(config_.channels, 1, kMaxChannels)))
+{
+    std::mt19937 rng(config_.seed);
+    std::normal_distribution<float> gauss(0.0f, std::sqrt(0.5f));   // |n|² = 1
+    noise_.resize(2 * kNoisePairs);
+    for (auto& v : noise_) v = gauss(rng);
+
+    for (std::size_t i = 0; i < streams_.size(); ++i) {
+        streams_[i].carrierPhase.assign(static_cast<std::size_t>(config_.carriers.size()), 0.0);
+        streams_[i].fmPhase.assign(static_cast<std::size_t>(config_.carriers.size()), 0.0);
+        streams_[i].noisePos = (i * 7'919) % kNoisePairs;   // uncorrelated noise per channel
+    }
+}
+
+SimulatedDevice::Stream* SimulatedDevice::stream(ChannelDescriptor ch) {
+    if (ch.direction != ChannelDescriptor::RX) return nullptr;
+    if (ch.channelIndex < 0 || ch.channelIndex >= static_cast<int>(streams_.size())) return nullptr;
+    return &streams_[static_cast<std::size_t>(ch.channelIndex)];
+}
+
+const SimulatedDevice::Stream* SimulatedDevice::stream(ChannelDescriptor ch) const {
+    return const_cast<SimulatedDevice*>(this)->stream(ch);
+}
+
+void SimulatedDevice::setState(DeviceState s) {
+    if (state_.exchange(s) != s) emit stateChanged(s);
+}
+
+// ---------------------------------------------------------------------------
+// Lifecycle / parameters
+// ---------------------------------------------------------------------------
+void SimulatedDevice::init(const QList<ChannelDescriptor>& /*channels*/) {
+    LOG_CAT(LogCat::kDeviceLifecycle, LogLevel::Info,
+            "SimulatedDevice: init, " + std::to_string(streams_.size()) + " RX channel(s), "
+            + std::to_string(config_.carriers.size()) + " carrier(s)"
+            + (config_.realtime ? "" : ", free-running"));
+    setState(DeviceState::Ready);
+}
+
+void SimulatedDevice::close() {
+    for (auto& s : streams_) s.running.store(false);
+    lockstepCv_.notify_all();
+    setState(DeviceState::Connected);
+}
+
+void SimulatedDevice::setSampleRate(double hz) {
+    if (hz <= 0.0) throw std::invalid_argument("SimulatedDevice: sample rate must be positive");
+    sampleRate_.store(hz);
+    emit sampleRateChanged(hz);
+}
+
+QList<double> SimulatedDevice::supportedSampleRates() const {
+    return {250e3, 500e3, 1e6, 2e6, 4e6, 5e6, 8e6, 10e6, 20e6, 30e6};
+}
+
+double SimulatedDevice::frequency(ChannelDescriptor ch) const {
+    const Stream* s = stream(ch);
+    return s ? s->frequencyHz.load() : 0.0;
+}
+
+double SimulatedDevice::gain(ChannelDescriptor ch) const {
+    const Stream* s = stream(ch);
+    return s ? s->gainDb.load() : 0.0;
+}
+
+void SimulatedDevice::setGain(ChannelDescriptor ch, double dB) {
+    Stream* s = stream(ch);
+    if (!s) return;
+    s->gainDb.store(std::clamp(dB, 0.0, maxGain()));
+    emit gainChanged(ch, s->gainDb.load());
+}
+
+void SimulatedDevice::setFrequency(ChannelDescriptor ch, double hz) {
+    Stream* s = stream(ch);
+    if (!s) return;
+    if (!s->running.load()) {
+        s->frequencyHz.store(hz);
+        return;
+    }
+
+    // Same protocol as LimeDevice::performStreamingRetune.
+    {
+        std::unique_lock lock(retuneMutex_);
+        s->retuneInProgress = true;
+        retuneCv_.notify_all();
+        if (!retuneCv_.wait_for(lock, std::chrono::seconds(1),
+                                [s] { return s->workerParked; })) {
+            LOG_WARN("SimulatedDevice: RX" + std::to_string(ch.channelIndex)
+                     + " worker did not park within 1s — proceeding");
+        }
+    }
+    s->frequencyHz.store(hz);
+    emit retuned(ch, hz);
+    {
+        std::lock_guard lock(retuneMutex_);
+        s->retuneInProgress = false;
+    }
+    retuneCv_.notify_all();
+}
+
+void SimulatedDevice::checkPauseForRetune(ChannelDescriptor ch) {
+    Stream* s = stream(ch);
+    if (!s) return;
+
+    std::unique_lock lock(retuneMutex_);
+    if (!s->retuneInProgress) return;
+    s->workerParked = true;
+    retuneCv_.notify_all();
+    retuneCv_.wait(lock, [s] { return !s->retuneInProgress; });
+    s->workerParked = false;
+}
+
+// ---------------------------------------------------------------------------
+// Streaming
+// ---------------------------------------------------------------------------
+void SimulatedDevice::startStream(ChannelDescriptor ch) {
+    Stream* s = stream(ch);
+    if (!s) throw std::invalid_argument("SimulatedDevice: no such channel");
+    if (s->running.exchange(true)) return;   // idempotent, as on LimeDevice
+    s->nextSample = 0;
+    s->lastTimestamp.store(0);
+    s->requested.store(0);
+    s->startedAt  = Clock::now();
+    setState(DeviceState::Streaming);
+}
+
+void SimulatedDevice::stopStream(ChannelDescriptor ch) {
+    Stream* s = stream(ch);
+    if (!s) return;
+    s->running.store(false);
+    lockstepCv_.notify_all();
+    if (std::none_of(streams_.begin(), streams_.end(),
+                     [](const Stream& x) { return x.running.load(); }))
+        setState(DeviceState::Ready);
+}
+
+uint64_t SimulatedDevice::lastReadTimestamp(ChannelDescriptor ch) const {
+    const Stream* s = stream(ch);
+    return s ? s->lastTimestamp.load() : 0;
+}
+
+int SimulatedDevice::readBlock(ChannelDescriptor ch, int16_t* buffer, int count, int timeoutMs) {
+    Stream* s = stream(ch);
+    if (!s || !s->running.load() || count <= 0) return -1;
+
+    const double sr = sampleRate_.load();
+
+    if (config_.realtime) {
+        const auto due = s->startedAt + std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double>(static_cast<double>(s->nextSample + count) / sr));
+        const auto now = Clock::now();
+        if (due - now > std::chrono::milliseconds(timeoutMs)) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(timeoutMs));
+            return 0;
+        }
+        std::this_thread::sleep_until(due);
+    } else if (streams_.size() > 1 && !waitForOtherChannels(s, timeoutMs)) {
+        return 0;
+    }
+
+    const std::size_t n = static_cast<std::size_t>(count);
+    s->acc.resize(2 * n);
+
+    // ── Noise ────────────────────────────────────────────────────────────────
+    const double gainShift = s->gainDb.load() - kReferenceGainDb;
+    const auto   noiseAmp  = static_cast<float>(dbToAmplitude(config_.noiseDbfs + gainShift));
+    for (std::size_t i = 0; i < n; ++i) {
+        s->acc[2 * i]     = noise_[2 * s->noisePos]     * noiseAmp;
+        s->acc[2 * i + 1] = noise_[2 * s->noisePos + 1] * noiseAmp;
+        if (++s->noisePos == kNoisePairs) s->noisePos = 0;
+    }
+
+    // ── Carriers ─────────────────────────────────────────────────────────────
+    const double lo = s->frequencyHz.load();
+    for (qsizetype c = 0; c < config_.carriers.size(); ++c) {
+        const Carrier& car  = config_.carriers[c];
+        double& phase       = s->carrierPhase[static_cast<std::size_t>(c)];
+        double& fmPhase     = s->fmPhase[static_cast<std::size_t>(c)];
+        const double offset = car.frequencyHz - lo;
+        const double step   = kTwoPi * offset / sr;
+        const bool audible  = std::abs(offset) < sr / 2.0;
+        const auto amp      = static_cast<float>(dbToAmplitude(car.levelDbfs + gainShift));
+
+        if (car.fmDeviationHz <= 0.0) {
+            // Unmodulated: one rotator per block, renormalised at block start.
+            if (audible) {
+                std::complex<double> r = std::polar(1.0, phase);
+                const std::complex<double> rot = std::polar(1.0, step);
+                for (std::size_t i = 0; i < n; ++i) {
+                    s->acc[2 * i]     += amp * static_cast<float>(r.real());
+                    s->acc[2 * i + 1] += amp * static_cast<float>(r.imag());
+                    r *= rot;
+                }
+            }
+            phase = std::remainder(phase + step * static_cast<double>(n), kTwoPi);
+            continue;
+        }
+
+        const double devStep = kTwoPi * car.fmDeviationHz / sr;
+        const double fmStep  = kTwoPi * car.fmToneHz / sr;
+        for (std::size_t i = 0; i < n; ++i) {
+            if (audible) {
+                s->acc[2 * i]     += amp * static_cast<float>(std::cos(phase));
+                s->acc[2 * i + 1] += amp * static_cast<float>(std::sin(phase));
+            }
+            phase   += step + devStep * std::sin(fmPhase);
+            fmPhase += fmStep;
+        }
+        phase   = std::remainder(phase, kTwoPi);
+        fmPhase = std::remainder(fmPhase, kTwoPi);
+    }
+
+    // ── float → int16 (the hardware boundary) ────────────────────────────────
+    for (std::size_t i = 0; i < 2 * n; ++i) {
+        const float v = std::clamp(s->acc[i] * 32767.0f, -32768.0f, 32767.0f);
+        buffer[i] = static_cast<int16_t>(std::lrint(v));
+    }
+
+    s->lastTimestamp.store(s->nextSample);
+    s->nextSample += n;
+    return count;
+}
+
+// A channel asking for the block at sample P has dispatched everything
+// before P (RxWorker reads, dispatches, reads again). Producing P only once
+// every other running channel has asked for P too means no channel is ever
+// a block ahead of the rest at IqCombiner.
+bool SimulatedDevice::waitForOtherChannels(Stream* s, int timeoutMs) {
+    const uint64_t at = s->nextSample;
+    std::unique_lock lock(lockstepMutex_);
+    s->requested.store(at);
+    lockstepCv_.notify_all();
+    return lockstepCv_.wait_for(lock, std::chrono::milliseconds(timeoutMs), [&] {
+        return !s->running.load()
+            || std::all_of(streams_.begin(), streams_.end(), [&](const Stream& o) {
+                   return &o == s || !o.running.load() || o.requested.load() >= at;
+               });
+    });
+}
+
+QList<ChannelInfo> SimulatedDevice::availableChannels() const {
+    QList<ChannelInfo> out;
+    for (int i = 0; i < static_cast<int>(streams_.size()); ++i)
+        out.append({{ChannelDescriptor::RX, i}, QStringLiteral("RX%1").arg(i)});
+    return out;
+}
@@ -0,0 +1,129 @@
+#pragma once
+
+#include "../Core/IDevice.h"
+
+#include <QList>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// SimulatedDevice — IDevice that synthesises int16 I/Q: carriers (optionally
+// FM-modulated by a sine) over Gaussian noise. No hardware, QtCore only —
+// used by StandHeadless for unattended test runs and benchmarks.
+//
+// Carriers sit at absolute RF frequencies, so a retune moves them through
+// the band like on a real receiver; carriers outside ±Fs/2 are not heard.
+// Levels are dBFS at kReferenceGainDb; setGain() shifts everything by the
+// difference. realtime = true paces readBlock() to the sample rate;
+// false returns blocks as fast as they are read (throughput tests); with
+// several channels streaming, a free-running channel then waits for the
+// others to come back for the same block, as one hardware clock would make
+// them — otherwise the fastest RxWorker overruns IqCombiner and the soak
+// numbers measure thread scheduling instead of the graph.
+// lastReadTimestamp() is the per-channel sample counter.
+//
+// A streaming retune uses LimeDevice's handshake: the worker is parked in
+// checkPauseForRetune(), retuned() fires, then the worker resumes.
+// ---------------------------------------------------------------------------
+class SimulatedDevice : public IDevice {
+    Q_OBJECT
+
+public:
+    static constexpr double kReferenceGainDb = 40.0;
+
+    struct Carrier {
+        double frequencyHz{0.0};
+        double levelDbfs{-20.0};
+        double fmDeviationHz{0.0};   // 0 = unmodulated carrier
+        double fmToneHz{1'000.0};
+    };
+
+    struct Config {
+        QList<Carrier> carriers;
+        double   noiseDbfs{-60.0};
+        int      channels{1};        // RX0..RX(n-1), 1..4
+        bool     realtime{true};
+        uint32_t seed{1};
+    };
+
+    explicit SimulatedDevice(Config config, QObject* parent = nullptr);
+
+    [[nodiscard]] QString id()   const override { return QStringLiteral("sim"); }
+    [[nodiscard]] QString name() const override { return QStringLiteral("Simulated SDR"); }
+
+    void init(const QList<ChannelDescriptor>& channels = {}) override;
+    void close() override;
+
+    void   setSampleRate(double hz) override;
+    [[nodiscard]] double sampleRate() const override { return sampleRate_.load(); }
+    [[nodiscard]] QList<double> supportedSampleRates() const override;
+
+    void   setFrequency(double hz) override { setFrequency(ChannelDescriptor{}, hz); }
+    [[nodiscard]] double frequency() const override { return frequency(ChannelDescriptor{}); }
+    void   setGain(double dB) override { setGain(ChannelDescriptor{}, dB); }
+    [[nodiscard]] double gain()    const override { return gain(ChannelDescriptor{}); }
+    [[nodiscard]] double maxGain() const override { return 70.0; }
+
+    void startStream() override { startStream(ChannelDescriptor{}); }
+    void stopStream()  override { stopStream(ChannelDescriptor{}); }
+    int  readBlock(int16_t* buffer, int count, int timeoutMs) override {
+        return readBlock(ChannelDescriptor{}, buffer, count, timeoutMs);
+    }
+
+    void startStream(ChannelDescriptor ch) override;
+    void stopStream(ChannelDescriptor ch) override;
+    int  readBlock(ChannelDescriptor ch, int16_t* buffer, int count, int timeoutMs) override;
+    void checkPauseForRetune(ChannelDescriptor ch) override;
+    void setFrequency(ChannelDescriptor ch, double hz) override;
+    void setGain(ChannelDescriptor ch, double dB) override;
+
+    [[nodiscard]] double frequency(ChannelDescriptor ch) const override;
+    [[nodiscard]] double gain(ChannelDescriptor ch)      const override;
+    [[nodiscard]] uint64_t lastReadTimestamp(ChannelDescriptor ch) const override;
+
+    [[nodiscard]] DeviceState state() const override { return state_.load(); }
+    [[nodiscard]] QList<ChannelInfo> availableChannels() const override;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Stream {
+        std::atomic<double>   frequencyHz{100e6};
+        std::atomic<double>   gainDb{kReferenceGainDb};
+        std::atomic<bool>     running{false};
+        std::atomic<uint64_t> lastTimestamp{0};
+        std::atomic<uint64_t> requested{0};   // nextSample at readBlock() entry
+        // Worker thread only
+        uint64_t              nextSample{0};
+        Clock::time_point     startedAt{};
+        std::vector<double>   carrierPhase;   // radians, per carrier
+        std::vector<double>   fmPhase;
+        std::size_t           noisePos{0};
+        std::vector<float>    acc;            // interleaved float scratch
+        // Retune handshake, guarded by retuneMutex_
+        bool retuneInProgress{false};
+        bool workerParked{false};
+    };
+
+    [[nodiscard]] bool waitForOtherChannels(Stream* s, int timeoutMs);
+    [[nodiscard]] Stream*       stream(ChannelDescriptor ch);
+    [[nodiscard]] const Stream* stream(ChannelDescriptor ch) const;
+    void setState(DeviceState s);
+
+    Config                   config_;
+    std::atomic<double>      sampleRate_{2'000'000.0};
+    std::atomic<DeviceState> state_{DeviceState::Connected};
+
+    std::vector<float>  noise_;     // unit-variance Gaussian I/Q, cycled
+    std::vector<Stream> streams_;   // one per RX channel, never resized
+
+    std::mutex              retuneMutex_;
+    std::condition_variable retuneCv_;
+
+    std::mutex              lockstepMutex_;   // free-running multi-channel only
+    std::condition_variable lockstepCv_;
+};
@@ -0,0 +1,267 @@
+#include "HeadlessConfig.h"
+
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <algorithm>
+
+namespace {
+
+std::optional<RecordingSettings::RawFormat> parseFormat(const QString& name) {
+    using F = RecordingSettings::RawFormat;
+    for (F f : {F::Float32, F::Float64, F::Int16, F::Int12, F::Int8, F::Int16Lossless}) {
+        if (RecordingSettings::extensionFor(f) == QLatin1Char('.') + name.toLower())
+            return f;
+    }
+    return std::nullopt;
+}
+
+bool fail(QString* error, const QString& msg) {
+    if (error) *error = msg;
+    return false;
+}
+
+bool parseDevice(const QJsonObject& o, HeadlessConfig& c, QString* error) {
+    const QString type = o.value("type").toString(QStringLiteral("sim")).toLower();
+    if (type == QLatin1String("lime"))      c.deviceType = HeadlessConfig::DeviceType::Lime;
+    else if (type == QLatin1String("sim"))  c.deviceType = HeadlessConfig::DeviceType::Simulated;
+    else if (type == QLatin1String("file")) c.deviceType = HeadlessConfig::DeviceType::File;
+    else return fail(error, QStringLiteral("device.type must be lime, sim or file"));
+
+    c.serial = o.value("serial").toString();
+    if (o.contains("channels")) {
+        c.channels.clear();
+        for (const QJsonValue& v : o.value("channels").toArray())
+            c.channels.append(v.toInt());
+        if (c.channels.isEmpty())
+            return fail(error, QStringLiteral("device.channels is empty"));
+    }
+    const QString combining = o.value("combining").toString(QStringLiteral("average")).toLower();
+    if (combining == QLatin1String("average"))    c.combining = IqCombiner::Mode::Average;
+    else if (combining == QLatin1String("phase")) c.combining = IqCombiner::Mode::PhaseAligned;
+    else if (combining == QLatin1String("mrc"))   c.combining = IqCombiner::Mode::Mrc;
+    else return fail(error, QStringLiteral("device.combining must be average, phase or mrc"));
+    c.trackPhase = o.value("trackPhase").toBool(false);
+    c.phaseCalibrationDeg.clear();
+    for (const QJsonValue& v : o.value("phaseCalibrationDeg").toArray())
+        c.phaseCalibrationDeg.append(v.toDouble());
+    c.compensateDelay = o.value("compensateDelay").toBool(false);
+
+    c.sampleRateHz = o.value("sampleRateMSps").toDouble(c.sampleRateHz / 1e6) * 1e6;
+    c.centerHz     = o.value("freqMHz").toDouble(c.centerHz / 1e6) * 1e6;
+    c.gainDb       = o.value("gainDb").toDouble(c.gainDb);
+
+    const bool realtime = o.value("realtime").toBool(true);
+
+    c.sim.realtime  = realtime;
+    c.sim.noiseDbfs = o.value("noiseDbfs").toDouble(c.sim.noiseDbfs);
+    c.sim.seed      = static_cast<uint32_t>(o.value("seed").toInt(1));
+    int maxChannel  = 0;
+    for (int ch : c.channels) maxChannel = std::max(maxChannel, ch);
+    c.sim.channels  = maxChannel + 1;
+    for (const QJsonValue& v : o.value("carriers").toArray()) {
+        const QJsonObject co = v.toObject();
+        SimulatedDevice::Carrier car;
+        car.frequencyHz   = co.value("freqMHz").toDouble() * 1e6;
+        car.levelDbfs     = co.value("levelDbfs").toDouble(car.levelDbfs);
+        car.fmDeviationHz = co.value("fmDeviationKHz").toDouble() * 1e3;
+        car.fmToneHz      = co.value("fmToneHz").toDouble(car.fmToneHz);
+        if (car.frequencyHz > 0.0) c.sim.carriers.append(car);
+    }
+
+    c.file.path     = o.value("path").toString();
+    c.file.loop     = o.value("loop").toBool(false);
+    c.file.realtime = realtime;
+    // For replay, rate and LO default to the SigMF sidecar.
+    c.file.sampleRateHz = o.value("sampleRateMSps").toDouble(0.0) * 1e6;
+    c.file.centerHz     = o.value("freqMHz").toDouble(0.0) * 1e6;
+    if (c.deviceType == HeadlessConfig::DeviceType::File) {
+        if (c.file.path.isEmpty())
+            return fail(error, QStringLiteral("device.path is required for type \"file\""));
+        if (c.channels != QList<int>{0})
+            return fail(error, QStringLiteral("file replay has a single channel (0)"));
+    }
+    return true;
+}
+
+bool parseRecording(const QJsonObject& o, RecordingSettings& r, QString* error) {
+    r.outputDir           = o.value("dir").toString();
+    r.recordCombined      = o.value("combined").toBool(true);
+    r.recordRawPerChannel = o.value("perChannel").toBool(false);
+    r.recordFiltered      = o.value("filtered").toBool(false);
+    r.recordAudio         = o.value("audio").toBool(false);
+    r.writeSigMf          = o.value("sigmf").toBool(r.writeSigMf);
+    r.segmentMinutes      = o.value("segmentMinutes").toDouble(0.0);
+    r.segmentMB           = o.value("segmentMB").toInt(0);
+    r.int8FullScaleDbfs   = o.value("ci8FullScaleDbfs").toDouble(r.int8FullScaleDbfs);
+    if (r.int8FullScaleDbfs > 0.0 || r.int8FullScaleDbfs < -90.0)
+        return fail(error, QStringLiteral("recording.ci8FullScaleDbfs must be in [-90, 0]"));
+    if (o.contains("format")) {
+        const auto f = parseFormat(o.value("format").toString());
+        if (!f) return fail(error, QStringLiteral("recording.format: unknown format \"%1\"")
+                                       .arg(o.value("format").toString()));
+        r.rawFormat = *f;
+    }
+
+    const QJsonObject pre = o.value("preTrigger").toObject();
+    r.preTriggerEnabled    = pre.value("enabled").toBool(false);
+    r.preTriggerSec        = pre.value("preSec").toDouble(r.preTriggerSec);
+    r.postTriggerSec       = pre.value("postSec").toDouble(r.postTriggerSec);
+    r.preTriggerInt16      = pre.value("int16").toBool(r.preTriggerInt16);
+    r.triggerOffsetKHz     = pre.value("offsetKHz").toDouble(r.triggerOffsetKHz);
+    r.triggerBwKHz         = pre.value("bwKHz").toDouble(r.triggerBwKHz);
+    r.triggerLevelDb       = pre.value("levelDb").toDouble(r.triggerLevelDb);
+    r.triggerClassType     = pre.value("classType").toString();
+    r.triggerMinConfidence = pre.value("minConfidence").toDouble(r.triggerMinConfidence);
+    if (r.preTriggerEnabled && (r.preTriggerSec <= 0.0 || r.postTriggerSec < 0.0))
+        return fail(error, QStringLiteral("recording.preTrigger: preSec must be positive, postSec >= 0"));
+    if (r.triggerMinConfidence < 0.0 || r.triggerMinConfidence > 1.0)
+        return fail(error, QStringLiteral("recording.preTrigger.minConfidence must be in [0, 1]"));
+    return true;
+}
+
+}  // namespace
+
+std::optional<HeadlessConfig> HeadlessConfig::load(const QString& path, QString* error) {
+    QFile f(path);
+    if (!f.open(QIODevice::ReadOnly)) {
+        if (error) *error = QStringLiteral("cannot open ") + path;
+        return std::nullopt;
+    }
+    QJsonParseError pe{};
+    const QJsonDocument doc = QJsonDocument::fromJson(f.readAll(), &pe);
+    if (pe.error != QJsonParseError::NoError || !doc.isObject()) {
+        if (error) *error = QStringLiteral("invalid config: ") + pe.errorString();
+        return std::nullopt;
+    }
+    const QJsonObject root = doc.object();
+
+    HeadlessConfig c;
+    if (!parseDevice(root.value("device").toObject(), c, error)) return std::nullopt;
+    if (!parseRecording(root.value("recording").toObject(), c.recording, error))
+        return std::nullopt;
+
+    for (const QJsonValue& v : root.value("demodulators").toArray()) {
+        const QJsonObject o = v.toObject();
+        Demodulator d;
+        d.mode     = o.value("mode").toString().toUpper();
+        d.offsetHz = o.value("offsetKHz").toDouble() * 1e3;
+        if (o.contains("squelchDb")) d.squelchDb = o.value("squelchDb").toDouble();
+        const QJsonObject params = o.value("params").toObject();
+        for (auto it = params.begin(); it != params.end(); ++it)
+            d.params.insert(it.key(), it.value().toDouble());
+        if (d.mode.isEmpty()) {
+            if (error) *error = QStringLiteral("demodulators: entry without \"mode\"");
+            return std::nullopt;
+        }
+        c.demodulators.append(d);
+    }
+
+    const QJsonObject cls = root.value("classifier").toObject();
+    c.classifier.script     = cls.value("script").toString();
+    const QString clsMode   = cls.value("mode").toString(QStringLiteral("iq")).toLower();
+    if (clsMode == QLatin1String("iq"))            c.classifier.mode = ClassifierHandler::Mode::Iq;
+    else if (clsMode == QLatin1String("features")) c.classifier.mode = ClassifierHandler::Mode::Features;
+    else if (clsMode == QLatin1String("local"))    c.classifier.mode = ClassifierHandler::Mode::Local;
+    else {
+        if (error) *error = QStringLiteral("classifier.mode: expected iq, features or local");
+        return std::nullopt;
+    }
+    c.classifier.enabled    = !c.classifier.script.isEmpty()
+                           || c.classifier.mode == ClassifierHandler::Mode::Local;
+    c.classifier.python     = cls.value("python").toString(c.classifier.python);
+    c.classifier.intervalMs = cls.value("intervalMs").toInt(c.classifier.intervalMs);
+    c.classifier.maxInFlight = cls.value("maxInFlight").toInt(c.classifier.maxInFlight);
+    for (const QJsonValue& v : cls.value("channels").toArray()) {
+        const QJsonObject o = v.toObject();
+        ClassifierChannel ch;
+        ch.id          = static_cast<uint32_t>(
+            o.value("id").toInt(static_cast<int>(c.classifier.channels.size()) + 1));
+        ch.offsetHz    = o.value("offsetKHz").toDouble() * 1e3;
+        ch.bandwidthHz = o.value("bwKHz").toDouble(ch.bandwidthHz / 1e3) * 1e3;
+        if (ch.bandwidthHz <= 0.0) {
+            if (error) *error = QStringLiteral("classifier.channels: bwKHz must be positive");
+            return std::nullopt;
+        }
+        c.classifier.channels.append(ch);
+    }
+    if (c.classifier.channels.size() > ClassifierHandler::kMaxSnippets
+        || c.classifier.maxInFlight < 1 || c.classifier.maxInFlight > ClassifierHandler::kRingSlots) {
+        if (error) *error = QStringLiteral("classifier: at most %1 channels, maxInFlight 1..%2")
+                                .arg(ClassifierHandler::kMaxSnippets).arg(ClassifierHandler::kRingSlots);
+        return std::nullopt;
+    }
+
+    const QJsonObject xs = root.value("crossSpectrum").toObject();
+    auto& xo = c.crossSpectrum.options;
+    c.crossSpectrum.enabled    = xs.value("enabled").toBool(false);
+    c.crossSpectrum.intervalMs = xs.value("intervalMs").toInt(c.crossSpectrum.intervalMs);
+    xo.fftSize         = xs.value("fftSize").toInt(xo.fftSize);
+    xo.segments        = xs.value("segments").toInt(xo.segments);
+    xo.antennaSpacingM = xs.value("antennaSpacingM").toDouble(xo.antennaSpacingM);
+    xo.detectDb        = xs.value("detectDb").toDouble(xo.detectDb);
+    xo.minCoherence    = xs.value("minCoherence").toDouble(xo.minCoherence);
+    if (xo.fftSize < 16 || (xo.fftSize & (xo.fftSize - 1)) != 0 || xo.segments < 2) {
+        if (error) *error = QStringLiteral("crossSpectrum: fftSize must be a power of two >= 16, "
+                                           "segments >= 2");
+        return std::nullopt;
+    }
+
+    const QJsonObject off = root.value("offline").toObject();
+    c.offline.enabled  = off.value("enabled").toBool(false);
+    c.offline.chunkSec = off.value("chunkSec").toDouble(c.offline.chunkSec);
+    if (c.offline.enabled) {
+        if (c.deviceType != DeviceType::File) {
+            if (error) *error = QStringLiteral("offline processing needs device.type \"file\"");
+            return std::nullopt;
+        }
+        if (c.recording.outputDir.isEmpty()) {
+            if (error) *error = QStringLiteral("offline processing needs recording.dir");
+            return std::nullopt;
+        }
+    }
+
+    const QJsonObject soak = root.value("soak").toObject();
+    c.soak.enabled = soak.value("enabled").toBool(false);
+    for (const QJsonValue& v : soak.value("sampleRatesMSps").toArray())
+        c.soak.sampleRatesHz.append(v.toDouble() * 1e6);
+    if (soak.contains("demodCounts")) {
+        c.soak.demodCounts.clear();
+        for (const QJsonValue& v : soak.value("demodCounts").toArray())
+            c.soak.demodCounts.append(v.toInt());
+        std::sort(c.soak.demodCounts.begin(), c.soak.demodCounts.end());
+    }
+    c.soak.durationSec = soak.value("durationSec").toDouble(c.soak.durationSec);
+    c.soak.warmupSec   = soak.value("warmupSec").toDouble(c.soak.warmupSec);
+    c.soak.rtfMargin   = soak.value("rtfMargin").toDouble(c.soak.rtfMargin);
+    c.soak.fftFps      = soak.value("fftFps").toInt(c.soak.fftFps);
+    c.soak.output      = soak.value("output").toString();
+    if (c.soak.enabled) {
+        if (c.deviceType != DeviceType::Simulated) {
+            if (error) *error = QStringLiteral("soak runs need device.type \"sim\"");
+            return std::nullopt;
+        }
+        if (c.soak.demodCounts.isEmpty() || c.soak.demodCounts.first() < 0
+            || c.soak.durationSec <= 0.0) {
+            if (error) *error = QStringLiteral("soak: demodCounts must be non-negative "
+                                               "and durationSec positive");
+            return std::nullopt;
+        }
+    }
+
+    c.threads          = root.value("threads").toInt(0);
+    c.durationSec      = root.value("durationSec").toDouble(0.0);
+    c.statsIntervalSec = root.value("statsIntervalSec").toDouble(1.0);
+    c.fftFps           = root.value("fftFps").toInt(0);
+    c.stageTiming      = root.value("stageTiming").toBool(false);
+    c.logFile          = root.value("logFile").toString();
+    c.traceFile        = root.value("traceFile").toString();
+    c.metricsPort      = root.value("metricsPort").toInt(0);
+    if (c.metricsPort < 0 || c.metricsPort > 65535) {
+        if (error) *error = QStringLiteral("metricsPort must be 0..65535");
+        return std::nullopt;
+    }
+    return c;
+}
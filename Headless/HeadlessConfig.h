@@ -0,0 +1,152 @@
+#pragma once
+
+#include "../Core/RecordingSettings.h"
+#include "../DSP/ClassifierHandler.h"
+#include "../DSP/IqCombiner.h"
+#include "../Hardware/FileReplayDevice.h"
+#include "../Hardware/SimulatedDevice.h"
+
+#include <QList>
+#include <QMap>
+#include <QString>
+#include <optional>
+
+// ---------------------------------------------------------------------------
+// HeadlessConfig — everything StandHeadless builds, read from one JSON file.
+//
+// Unknown keys are ignored; every key is optional. Example:
+//   {
+//     "device": { "type": "sim",            // "lime" | "sim" | "file"
+//                 "serial": "",             // lime: part of the device id
+//                 "channels": [0, 1],       // RX indices, combined by IqCombiner
+//                 "combining": "average",   // "average" | "phase" | "mrc"
+//                 "trackPhase": false,      // phase/mrc: follow drift, no calibration
+//                 "phaseCalibrationDeg": [60],  // phase/mrc: per channel from the second
+//                 "compensateDelay": false, // advance channels by their estimated delay
+//                 "sampleRateMSps": 2.0, "freqMHz": 102.0, "gainDb": 40,
+//                 "realtime": true,         // sim/file: pace to the sample rate
+//                 "noiseDbfs": -60,         // sim
+//                 "carriers": [ { "freqMHz": 102.1, "levelDbfs": -20,
+//                                 "fmDeviationKHz": 75, "fmToneHz": 1000 } ],
+//                 "path": "rec.ci16", "loop": false },   // file
+//     "threads": 0,                         // DSP pool size, 0 = ideal count
+//     "durationSec": 0,                     // 0 = until SIGINT/SIGTERM
+//     "statsIntervalSec": 1,                // 0 = no status lines or summary
+//     "fftFps": 0,                          // > 0 adds the GUI's FftHandler
+//     "stageTiming": false,                 // per-stage block latency histograms
+//     "logFile": "stand-headless.log",
+//     "traceFile": "stand-trace.json",      // Chrome trace of the run, see Trace.h
+//     "metricsPort": 9464,                  // 127.0.0.1:<port>/metrics, 0 = off
+//     "recording": { "dir": "/data", "combined": true, "perChannel": false,
+//                    "filtered": false, "audio": true, "format": "ci16",
+//                    "sigmf": true, "segmentMinutes": 10, "segmentMB": 0,
+//                    "ci8FullScaleDbfs": 0,         // level mapped to ±127 in .ci8
+//                    "preTrigger": { "enabled": false, "preSec": 5, "postSec": 5,
+//                                    "int16": true, "offsetKHz": 0, "bwKHz": 0,
+//                                    "levelDb": -40, "classType": "FM",
+//                                    "minConfidence": 0.8 } },
+//     "demodulators": [ { "mode": "FM", "offsetKHz": 100, "squelchDb": -50,
+//                         "params": { "Bandwidth": 150000 } } ],
+//     "classifier": { "python": "python", "script": "Python/classifier.py",
+//                     "mode": "iq", "intervalMs": 100, "maxInFlight": 2,
+//                     "channels": [ { "id": 1, "offsetKHz": 100, "bwKHz": 25 } ] },
+//     "crossSpectrum": { "enabled": false, "fftSize": 1024, "segments": 16,
+//                        "intervalMs": 500, "antennaSpacingM": 0,
+//                        "detectDb": 10, "minCoherence": 0.5 },  // ≥ 2 channels
+//     "offline": { "enabled": false, "chunkSec": 4 },  // file only, see below
+//     "soak": { "enabled": false, "sampleRatesMSps": [],  // [] = LimeSDR rates
+//               "demodCounts": [0, 1, 2, 4, 8, 16], "durationSec": 10,
+//               "warmupSec": 2, "rtfMargin": 1.2, "fftFps": 30,
+//               "output": "soak.json" }               // sim only, see below
+//   }
+// Recording is off while "recording.dir" is empty. Without
+// "classifier.channels" the classifier sees the wideband block; "id"
+// defaults to the entry's position + 1. "classifier.mode" "features" sends
+// feature vectors instead of I/Q; "local" classifies in process and needs no
+// script.
+// "recording.preTrigger" arms a PreTriggerRecorder on the combined stream;
+// a capture starts on the power trigger ("bwKHz" > 0) or when the classifier
+// reports "classType" with at least "minConfidence".
+// "crossSpectrum" runs IqCombiner's cross-spectrum of the first two channels:
+// the status line lists the strongest signals with their RX0/RX1 phase,
+// coherence and, with "antennaSpacingM", angle of arrival.
+// With "offline.enabled" a "file" device is not replayed through the live
+// pipeline but processed as fast as every core allows (OfflineRunner):
+// demodulator audio and filtered I/Q go to recording.dir, nothing else runs.
+// With "soak.enabled" the graph is run unthrottled once per sample rate and
+// demodulator count (SoakRunner); "demodulators" then only supply templates.
+// ---------------------------------------------------------------------------
+struct HeadlessConfig {
+    enum class DeviceType { Lime, Simulated, File };
+
+    struct Demodulator {
+        QString mode;                  // DemodRegistry name
+        double  offsetHz{0.0};         // from the LO
+        std::optional<double> squelchDb;
+        QMap<QString, double> params;  // BaseDemodHandler::setParam
+    };
+
+    struct Offline {
+        bool   enabled{false};
+        double chunkSec{4.0};          // OfflineProcessor chunk length
+    };
+
+    struct Soak {
+        bool          enabled{false};
+        QList<double> sampleRatesHz;           // empty = LimeDevice::kSupportedRates
+        QList<int>    demodCounts{0, 1, 2, 4, 8, 16};
+        double        durationSec{10.0};       // measured, after the warm-up
+        double        warmupSec{2.0};
+        double        rtfMargin{1.2};          // sustained = real-time factor ≥ this, no drops
+        int           fftFps{30};
+        QString       output;                  // JSON report; empty = none
+    };
+
+    struct Classifier {
+        bool    enabled{false};
+        QString python{QStringLiteral("python")};
+        QString script;
+        ClassifierHandler::Mode mode{ClassifierHandler::Mode::Iq};
+        int     intervalMs{100};
+        int     maxInFlight{2};
+        QVector<ClassifierChannel> channels;
+    };
+
+    struct CrossSpectrumConfig {
+        bool    enabled{false};
+        CrossSpectrum::Options options;
+        int     intervalMs{IqCombiner::kCrossIntervalMs};
+    };
+
+    DeviceType  deviceType{DeviceType::Simulated};
+    QString     serial;
+    QList<int>  channels{0};
+    IqCombiner::Mode combining{IqCombiner::Mode::Average};
+    bool          trackPhase{false};
+    QList<double> phaseCalibrationDeg;   // channels[1..]
+    bool          compensateDelay{false};
+    double      sampleRateHz{2'000'000.0};
+    double      centerHz{102e6};
+    double      gainDb{40.0};
+    SimulatedDevice::Config  sim;
+    FileReplayDevice::Config file;
+
+    RecordingSettings  recording;
+    QList<Demodulator> demodulators;
+    Classifier         classifier;
+    CrossSpectrumConfig crossSpectrum;
+    Offline            offline;
+    Soak               soak;
+
+    int     threads{0};
+    double  durationSec{0.0};
+    double  statsIntervalSec{1.0};
+    int     fftFps{0};
+    bool    stageTiming{false};
+    QString logFile;
+    QString traceFile;
+    int     metricsPort{0};
+
+    [[nodiscard]] static std::optional<HeadlessConfig> load(const QString& path,
+                                                            QString* error = nullptr);
+};
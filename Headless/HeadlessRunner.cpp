@@ -0,0 +1,619 @@
+#include "HeadlessRunner.h"
+#include "../Application/ClassifierController.h"
+#include "../Core/FileNaming.h"
+#include "../Core/IDevice.h"
+#include "../Core/TimedHandler.h"
+#include "../DSP/AudioFileHandler.h"
+#include "../DSP/BandpassHandler.h"
+#include "../DSP/BaseDemodHandler.h"
+#include "../DSP/DemodRegistry.h"
+#include "../DSP/FftHandler.h"
+#include "../DSP/IqCombiner.h"
+#include "../DSP/PreTriggerRecorder.h"
+#include "../DSP/RawFileHandler.h"
+#include "../Hardware/FileReplayDevice.h"
+#include "../Hardware/LimeDeviceManager.h"
+#include "../Hardware/RxWorker.h"
+#include "../Hardware/SimulatedDevice.h"
+#include "Logger.h"
+
+#include <QDir>
+#include <algorithm>
+#include <cstdio>
+
+namespace {
+
+void printLine(const QString& line) {
+    std::fputs(qPrintable(line + QLatin1Char('\n')), stdout);
+    std::fflush(stdout);
+}
+
+}  // namespace
+
+HeadlessRunner::HeadlessRunner(HeadlessConfig config, QObject* parent)
+    : QObject(parent)
+    , config_(std::move(config))
+{
+    if (config_.threads > 0) pool_.setMaxThreadCount(config_.threads);
+    for (int idx : config_.channels)
+        channels_.append(ChannelDescriptor{ChannelDescriptor::RX, idx});
+
+    // Created up front so report() always lists every stage of the graph.
+    if (config_.stageTiming) {
+        for (const char* stage : {"read", "convert", "channelStats", "combiner", "recorder",
+                                  "fft", "demod", "bandpass"})
+            stageLatency_[QString::fromLatin1(stage)] = std::make_unique<LatencyHistogram>();
+    }
+
+    statsTimer_.setInterval(static_cast<int>(std::max(0.1, config_.statsIntervalSec) * 1000.0));
+    connect(&statsTimer_, &QTimer::timeout, this, &HeadlessRunner::printStats);
+
+    // LimeDevice::temperature() updates stand_device_temperature_celsius; the
+    // GUI polls it at the same rate for its status bar.
+    temperatureTimer_.setInterval(5000);
+    connect(&temperatureTimer_, &QTimer::timeout, this, [this] {
+        if (device_) static_cast<void>(device_->temperature());
+    });
+}
+
+HeadlessRunner::~HeadlessRunner() {
+    // Normal shutdown goes through stop() → finished(); this covers start()
+    // failures and destruction with the stream still running.
+    for (auto& w : workers_)
+        if (w.worker) disconnect(w.worker, nullptr, this, nullptr);
+    for (auto& w : workers_)
+        if (w.worker) w.worker->stop();
+    for (auto& w : workers_)
+        if (w.thread) { w.thread->quit(); w.thread->wait(3000); }
+    cleanup();
+    if (device_) device_->close();
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// Start
+// ═══════════════════════════════════════════════════════════════════════════════
+bool HeadlessRunner::start() {
+    if (!openDevice()) return false;
+    if (!buildGraph()) return false;
+
+    startClassifier();
+
+    runClock_.start();
+    lastStatsMs_ = 0;
+    lastPairs_.assign(workers_.size(), 0);
+    if (config_.statsIntervalSec > 0.0) statsTimer_.start();
+    if (config_.metricsPort > 0) temperatureTimer_.start();
+    if (config_.durationSec > 0.0)
+        QTimer::singleShot(static_cast<int>(config_.durationSec * 1000.0), this,
+                           &HeadlessRunner::stop);
+
+    for (auto& w : workers_)
+        w.thread->start();
+    return true;
+}
+
+bool HeadlessRunner::openDevice() {
+    switch (config_.deviceType) {
+        case HeadlessConfig::DeviceType::Simulated:
+            device_ = std::make_shared<SimulatedDevice>(config_.sim);
+            break;
+
+        case HeadlessConfig::DeviceType::File: {
+            auto replay = std::make_shared<FileReplayDevice>(config_.file);
+            // End of a non-looping replay ends the run (emitted on the worker).
+            connect(replay.get(), &FileReplayDevice::endOfFile,
+                    this, &HeadlessRunner::stop, Qt::QueuedConnection);
+            device_ = replay;
+            break;
+        }
+
+        case HeadlessConfig::DeviceType::Lime: {
+            manager_ = std::make_unique<LimeDeviceManager>();
+            manager_->refresh();
+            for (const auto& d : manager_->devices()) {
+                if (config_.serial.isEmpty() || d->id().contains(config_.serial)) {
+                    device_ = d;
+                    break;
+                }
+            }
+            if (!device_) {
+                LOG_ERROR("HeadlessRunner: no LimeSDR"
+                          + (config_.serial.isEmpty() ? std::string{}
+                                                      : " matching " + config_.serial.toStdString()));
+                return false;
+            }
+            break;
+        }
+    }
+
+    try {
+        device_->init(channels_);
+        if (config_.deviceType != HeadlessConfig::DeviceType::File) {
+            device_->setSampleRate(config_.sampleRateHz);
+            device_->calibrate(channels_);
+            for (const auto& ch : channels_) {
+                device_->setFrequency(ch, config_.centerHz);
+                device_->setGain(ch, config_.gainDb);
+            }
+        }
+    } catch (const std::exception& ex) {
+        LOG_ERROR(std::string("HeadlessRunner: device setup failed: ") + ex.what());
+        return false;
+    }
+
+    LOG_INFO("HeadlessRunner: " + device_->name().toStdString() + ", "
+             + std::to_string(channels_.size()) + " channel(s), "
+             + std::to_string(device_->sampleRate()) + " Sps at "
+             + std::to_string(device_->frequency(channels_.first()) / 1e6) + " MHz");
+    return true;
+}
+
+bool HeadlessRunner::buildGraph() {
+    const int     nCh      = static_cast<int>(channels_.size());
+    const double  sr       = device_->sampleRate();
+    const double  centerHz = device_->frequency(channels_.first());
+    const auto&   rec      = config_.recording;
+    const bool    recording = !rec.outputDir.isEmpty();
+    const QString combinedSrc = FileNaming::combinedSource(channels_);
+    timestamp_ = FileNaming::currentTimestamp();
+
+    if (recording && !QDir().mkpath(rec.outputDir)) {
+        LOG_ERROR("HeadlessRunner: cannot create " + rec.outputDir.toStdString());
+        return false;
+    }
+
+    // ── Combined pipeline ────────────────────────────────────────────────────
+    pipeline_ = new Pipeline(&pool_, this);
+
+    if (recording && rec.recordCombined) {
+        auto* h = new RawFileHandler(
+            FileNaming::compose(rec.outputDir, timestamp_, combinedSrc, centerHz, sr,
+                                rec.rawExtension()),
+            rec.rawFormat, &pool_);
+        h->setSegmentPolicy(rec.segmentPolicy());
+        h->setInt8Scale(rec.int8Scale());
+        if (rec.writeSigMf)
+            h->enableSigMf(centerHz, QStringLiteral("StandHeadless, %1 channel(s)").arg(nCh));
+        pipeline_->addHandler(timed(h, QStringLiteral("recorder")));
+        rawHandlers_.push_back(h);
+    }
+
+    if (recording && rec.preTriggerEnabled) {
+        PreTriggerRecorder::Config cfg;
+        cfg.preSeconds              = rec.preTriggerSec;
+        cfg.postSeconds             = rec.postTriggerSec;
+        cfg.int16Storage            = rec.preTriggerInt16;
+        cfg.format                  = rec.preTriggerFormat();
+        cfg.powerOffsetHz           = rec.triggerOffsetKHz * 1e3;
+        cfg.powerBandwidthHz        = rec.triggerBwKHz * 1e3;
+        cfg.powerThresholdDb        = rec.triggerLevelDb;
+        cfg.classifierType          = rec.triggerClassType;
+        cfg.classifierMinConfidence = rec.triggerMinConfidence;
+
+        // Runs on the recorder's writer thread: timestamp at trigger time, LO
+        // from the atomic mirror, like RadioMonitorPage::startPreTrigger.
+        preTriggerCenterHz_.store(centerHz);
+        const QString dir = rec.outputDir;
+        const QString ext = RecordingSettings::extensionFor(cfg.format);
+        auto builder = [this, dir, ext, combinedSrc, sr](const QString& reason) {
+            return FileNaming::composeWithSuffix(dir, FileNaming::currentTimestamp(), combinedSrc,
+                                                 "trig_" + reason, preTriggerCenterHz_.load(),
+                                                 sr, ext);
+        };
+        preTrigger_ = new PreTriggerRecorder(cfg, builder, this);
+        connect(preTrigger_, &PreTriggerRecorder::captureStarted, this,
+                [](const QString& path, const QString& reason) {
+                    LOG_INFO("HeadlessRunner: capture (" + reason.toStdString() + "): "
+                             + path.toStdString());
+                }, Qt::QueuedConnection);
+        connect(preTrigger_, &PreTriggerRecorder::captureFinished, this,
+                [](const QString& path, qint64 samples, qint64 lost) {
+                    LOG_INFO("HeadlessRunner: saved " + path.toStdString() + " ("
+                             + std::to_string(samples) + " samples, "
+                             + std::to_string(lost) + " lost)");
+                }, Qt::QueuedConnection);
+        pipeline_->addHandler(timed(preTrigger_, QStringLiteral("preTrigger")));
+    }
+
+    if (config_.fftFps > 0) {
+        fft_ = new FftHandler(this);
+        fft_->setPlotFps(config_.fftFps);
+        fft_->setCenterFrequency(centerHz / 1e6);
+        pipeline_->addHandler(timed(fft_, QStringLiteral("fft")));
+    }
+
+    for (int i = 0; i < config_.demodulators.size(); ++i)
+        addDemodulator(config_.demodulators[i], i);
+
+    const Metrics::Labels deviceLabels{{"device", device_->id().toStdString()}};
+    combiner_ = new IqCombiner(nCh, pipeline_);
+    combiner_->setMode(config_.combining);
+    combiner_->setPhaseTracking(config_.trackPhase);
+    for (int i = 0; i < config_.phaseCalibrationDeg.size(); ++i)
+        combiner_->setPhaseCalibrationDeg(i + 1, config_.phaseCalibrationDeg[i]);
+    combiner_->setDelayPool(&pool_);
+    combiner_->setDelayCompensation(config_.compensateDelay);
+    if (config_.crossSpectrum.enabled && nCh >= 2) {
+        // Options are validated by HeadlessConfig.
+        combiner_->setCrossSpectrum(config_.crossSpectrum.options, config_.crossSpectrum.intervalMs);
+        combiner_->setCentreFrequency(centerHz);
+        connect(combiner_, &IqCombiner::crossSpectrum, this, [this](CrossSpectrumFrame frame) {
+            lastDf_ = std::move(frame.readings);
+        }, Qt::QueuedConnection);
+    }
+    combiner_->publishMetrics(deviceLabels);
+    pipeline_->notifyStarted(sr);
+
+    // ── Per-channel PrePipelines + workers ───────────────────────────────────
+    // Same start order as CombinedRxController: prepare and start every
+    // channel here, so the workers' own startStream() calls are no-ops.
+    try {
+        for (const auto& ch : channels_) device_->prepareStream(ch);
+        for (const auto& ch : channels_) device_->startStream(ch);
+    } catch (const std::exception& ex) {
+        LOG_ERROR(std::string("HeadlessRunner: startStream failed: ") + ex.what());
+        return false;
+    }
+
+    workers_.resize(static_cast<std::size_t>(nCh));
+    for (int i = 0; i < nCh; ++i) {
+        auto& w   = workers_[static_cast<std::size_t>(i)];
+        w.channel = channels_[i];
+        w.stats   = std::make_unique<StreamStatsHandler>();
+        Metrics::Labels channelLabels = deviceLabels;
+        channelLabels.emplace_back("channel", "RX" + std::to_string(w.channel.channelIndex));
+        w.stats->publishMetrics(channelLabels);
+
+        w.prePipeline = new Pipeline(nullptr, this);
+        w.prePipeline->addHandler(timed(w.stats.get(), QStringLiteral("channelStats")));
+        if (recording && rec.recordRawPerChannel) {
+            w.perChannelRaw = new RawFileHandler(
+                FileNaming::compose(rec.outputDir, timestamp_,
+                                    FileNaming::perChannelSource(w.channel),
+                                    centerHz, sr, rec.rawExtension()),
+                rec.rawFormat, &pool_);
+            w.perChannelRaw->setSegmentPolicy(rec.segmentPolicy());
+            w.perChannelRaw->setInt8Scale(rec.int8Scale());
+            if (rec.writeSigMf)
+                w.perChannelRaw->enableSigMf(
+                    centerHz, QStringLiteral("RX%1 I/Q before combining").arg(w.channel.channelIndex));
+            w.prePipeline->addHandler(timed(w.perChannelRaw, QStringLiteral("recorder")));
+        }
+        w.prePipeline->addHandler(timed(combiner_, QStringLiteral("combiner")));
+        w.prePipeline->notifyStarted(sr);
+
+        w.thread = new QThread(this);
+        w.worker = new RxWorker(device_.get(), w.prePipeline, w.channel);
+        w.worker->setReadTiming(latency(QStringLiteral("read")), latency(QStringLiteral("convert")));
+        w.worker->moveToThread(w.thread);
+
+        connect(w.thread, &QThread::started, w.worker, &RxWorker::run);
+        connect(w.worker, &RxWorker::errorOccurred, this, [this](const QString& err) {
+            LOG_ERROR("HeadlessRunner: " + err.toStdString());
+            exitCode_ = 2;
+            stop();
+        }, Qt::QueuedConnection);
+        connect(w.worker, &RxWorker::finished,
+                this, &HeadlessRunner::onWorkerFinished, Qt::QueuedConnection);
+        connect(w.worker, &RxWorker::finished, w.thread, &QThread::quit, Qt::QueuedConnection);
+        connect(w.thread, &QThread::finished, w.worker, &QObject::deleteLater);
+        connect(w.thread, &QThread::finished, w.thread, &QObject::deleteLater);
+    }
+
+    connect(device_.get(), &IDevice::retuned,
+            this, &HeadlessRunner::onDeviceRetuned, Qt::DirectConnection);
+    connect(device_.get(), &IDevice::gainChanged,
+            this, &HeadlessRunner::onDeviceGainChanged, Qt::DirectConnection);
+    for (const auto& ch : channels_)
+        onDeviceGainChanged(ch, device_->gain(ch));
+    return true;
+}
+
+void HeadlessRunner::addDemodulator(const HeadlessConfig::Demodulator& d, int slot) {
+    const auto& rec = config_.recording;
+
+    auto* h = DemodRegistry::instance().create(d.mode, d.offsetHz, this);
+    if (!h) {
+        LOG_WARN("HeadlessRunner: unknown demodulator \"" + d.mode.toStdString()
+                 + "\" (have: " + DemodRegistry::instance().names().join(", ").toStdString() + ")");
+        return;
+    }
+    for (auto it = d.params.begin(); it != d.params.end(); ++it)
+        h->setParam(it.key(), it.value());
+    if (d.squelchDb) h->setSquelch(*d.squelchDb);
+
+    Demod slotState;
+    slotState.label   = QStringLiteral("%1%2").arg(d.mode.toLower()).arg(slot);
+    slotState.handler = h;
+    h->publishMetrics({{"device", device_->id().toStdString()},
+                       {"demod",  slotState.label.toStdString()},
+                       {"mode",   d.mode.toStdString()}});
+    pipeline_->addHandler(timed(h, QStringLiteral("demod")));
+
+    if (!rec.outputDir.isEmpty()) {
+        const double  sr          = device_->sampleRate();
+        const double  centerHz    = device_->frequency(channels_.first());
+        const QString combinedSrc = FileNaming::combinedSource(channels_);
+
+        if (rec.recordFiltered) {
+            const double bwHz = h->param(QStringLiteral("Bandwidth"));
+            constexpr double kOutputSR = 250'000.0;   // BandpassExporter default
+            if (bwHz > 0.0 && kOutputSR <= sr) {
+                const QString suffix = QStringLiteral("bp%1kHz").arg(bwHz / 1e3, 0, 'f', 0);
+                slotState.filtered = new BandpassHandler(
+                    FileNaming::composeWithSuffix(rec.outputDir, timestamp_, combinedSrc,
+                                                  suffix, centerHz, kOutputSR, ".cf32"),
+                    d.offsetHz, bwHz, kOutputSR);
+                slotState.filtered->setSegmentPolicy(rec.segmentPolicy());
+                pipeline_->addHandler(timed(slotState.filtered, QStringLiteral("bandpass")));
+            }
+        }
+        if (rec.recordAudio) {
+            const QString dir = rec.outputDir, ts = timestamp_, suffix = slotState.label;
+            slotState.audio = new AudioFileHandler(
+                [dir, ts, combinedSrc, suffix, centerHz](double audioSr) {
+                    return FileNaming::composeWithSuffix(dir, ts, combinedSrc, suffix,
+                                                         centerHz, audioSr, ".wav");
+                }, this);
+            slotState.audio->setSegmentPolicy(rec.segmentPolicy());
+            connect(h, &BaseDemodHandler::audioReady,
+                    slotState.audio, &AudioFileHandler::push, Qt::QueuedConnection);
+        }
+    }
+    demods_.push_back(slotState);
+}
+
+IPipelineHandler* HeadlessRunner::timed(IPipelineHandler* h, const QString& stage) {
+    LatencyHistogram* hist = latency(stage);
+    if (!hist) return h;
+    timedHandlers_.push_back(std::make_unique<TimedHandler>(h, hist));
+    return timedHandlers_.back().get();
+}
+
+LatencyHistogram* HeadlessRunner::latency(const QString& stage) {
+    const auto it = stageLatency_.find(stage);
+    return it != stageLatency_.end() ? it->second.get() : nullptr;
+}
+
+void HeadlessRunner::startClassifier() {
+    if (!config_.classifier.enabled) return;
+
+    // The handler joins the combined pipeline mid-stream: fire its start hook
+    // like CombinedRxController::addExtraHandler does.
+    classifier_ = new ClassifierController(
+        [this](IPipelineHandler* h) {
+            if (!pipeline_) return;
+            pipeline_->addHandler(h);
+            h->onStreamStarted(device_->sampleRate());
+        },
+        [this](IPipelineHandler* h) {
+            if (pipeline_) pipeline_->removeHandler(h);
+        },
+        this);
+    classifier_->setIntervalMs(config_.classifier.intervalMs);
+    classifier_->setMode(config_.classifier.mode);
+    classifier_->setMaxInFlight(config_.classifier.maxInFlight);
+    classifier_->setChannels(config_.classifier.channels);
+    classifier_->setCenterFrequency(config_.centerHz);
+    connect(classifier_, &ClassifierController::channelClassified,
+            this, [this](quint32 channelId, const QString& type, double confidence, quint64) {
+                lastClass_[channelId] =
+                    QStringLiteral("%1 (%2 %)").arg(type).arg(confidence * 100.0, 0, 'f', 0);
+            });
+    if (preTrigger_)
+        connect(classifier_, &ClassifierController::channelClassified, preTrigger_,
+                [rec = preTrigger_](quint32, const QString& type, double confidence, quint64) {
+                    rec->onClassification(type, confidence);
+                });
+    connect(classifier_, &ClassifierController::classifierError, this, [](const QString& msg) {
+        LOG_WARN("HeadlessRunner: classifier: " + msg.toStdString());
+    });
+    classifier_->start(config_.classifier.python, config_.classifier.script);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// Stop
+// ═══════════════════════════════════════════════════════════════════════════════
+void HeadlessRunner::stop() {
+    if (stopping_) return;
+    stopping_ = true;
+    LOG_INFO("HeadlessRunner: stopping");
+    if (classifier_) classifier_->stop();
+    for (auto& w : workers_)
+        if (w.worker) w.worker->stop();
+    if (workers_.empty()) {   // never started
+        cleanup();
+        emit finished(exitCode_);
+    }
+}
+
+void HeadlessRunner::onWorkerFinished() {
+    if (++finishedCount_ < static_cast<int>(workers_.size())) return;
+
+    for (auto& w : workers_) {
+        w.worker = nullptr;   // deleteLater via QThread::finished
+        w.thread = nullptr;
+    }
+    statsTimer_.stop();
+    temperatureTimer_.stop();
+    finishedMs_ = runClock_.elapsed();
+    if (config_.statsIntervalSec > 0.0) {
+        printStats();
+        printSummary();
+    }
+    cleanup();
+    emit finished(exitCode_);
+}
+
+void HeadlessRunner::cleanup() {
+    if (!pipeline_) return;
+
+    for (const auto& ch : channels_) {
+        try { device_->stopStream(ch); }
+        catch (const std::exception& ex) {
+            LOG_WARN(std::string("HeadlessRunner: stopStream: ") + ex.what());
+        }
+    }
+    disconnect(device_.get(), &IDevice::retuned, this, &HeadlessRunner::onDeviceRetuned);
+    disconnect(device_.get(), &IDevice::gainChanged, this, &HeadlessRunner::onDeviceGainChanged);
+
+    for (auto& w : workers_) {
+        if (w.prePipeline) {
+            w.prePipeline->notifyStopped();
+            w.prePipeline->clearHandlers();
+            delete w.prePipeline;
+        }
+        if (w.perChannelRaw) finalRecorderDrops_ += w.perChannelRaw->writerStats().bytesDropped;
+        delete w.perChannelRaw;
+    }
+
+    pipeline_->notifyStopped();
+    pipeline_->clearHandlers();
+    delete pipeline_;
+    pipeline_ = nullptr;
+
+    // notifyStopped() → onStreamStopped() has flushed and joined its writer.
+    delete preTrigger_;
+    preTrigger_ = nullptr;
+    delete classifier_;
+    classifier_ = nullptr;
+    delete fft_;
+    fft_ = nullptr;
+    if (combiner_) {
+        finalCombined_      = combiner_->combinedBlocks();
+        finalCombinerDrops_ = combiner_->droppedBlocks();
+        finalCombinerSlips_ = combiner_->slipSamples();
+    }
+    delete combiner_;
+    combiner_ = nullptr;
+    for (auto& d : demods_) {
+        if (d.audio) d.audio->close();
+        delete d.audio;
+        delete d.filtered;
+        delete d.handler;
+    }
+    demods_.clear();
+    for (auto* h : rawHandlers_) {
+        finalRecorderDrops_ += h->writerStats().bytesDropped;
+        delete h;
+    }
+    rawHandlers_.clear();
+    timedHandlers_.clear();
+
+    // Stats handlers are kept for the summary; the rest of the entry is gone.
+    for (auto& w : workers_) {
+        w.prePipeline   = nullptr;
+        w.perChannelRaw = nullptr;
+    }
+    pool_.waitForDone();
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// Device events
+// ═══════════════════════════════════════════════════════════════════════════════
+void HeadlessRunner::onDeviceRetuned(ChannelDescriptor ch, double hz) {
+    if (!channels_.contains(ch)) return;
+    preTriggerCenterHz_.store(hz);
+    if (pipeline_) pipeline_->notifyRetune(hz);
+    if (combiner_) combiner_->setCentreFrequency(hz);
+    for (auto& w : workers_)
+        if (w.perChannelRaw) w.perChannelRaw->onRetune(hz);
+}
+
+void HeadlessRunner::onDeviceGainChanged(ChannelDescriptor ch, double dB) {
+    if (!channels_.contains(ch)) return;
+    for (auto& w : workers_)
+        if (w.perChannelRaw && w.channel == ch) w.perChannelRaw->annotateGain(ch.channelIndex, dB);
+    for (auto* h : rawHandlers_)
+        h->annotateGain(ch.channelIndex, dB);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// Reporting
+// ═══════════════════════════════════════════════════════════════════════════════
+void HeadlessRunner::printStats() {
+    const qint64 nowMs = runClock_.elapsed();
+    const double dt    = static_cast<double>(nowMs - lastStatsMs_) / 1000.0;
+    if (dt <= 0.0) return;
+    lastStatsMs_ = nowMs;
+
+    QString line = QStringLiteral("[%1 s]").arg(static_cast<double>(nowMs) / 1000.0, 8, 'f', 1);
+    for (std::size_t i = 0; i < workers_.size(); ++i) {
+        const auto s    = workers_[i].stats->snapshot();
+        const double rate = static_cast<double>(s.pairs - lastPairs_[i]) / dt;
+        lastPairs_[i] = s.pairs;
+        const double load = s.sampleRateHz > 0.0 ? 100.0 * rate / s.sampleRateHz : 0.0;
+        line += QStringLiteral(" RX%1 %2 MSps (%3 %) gaps %4 lost %5 clip %6 |")
+                    .arg(workers_[i].channel.channelIndex)
+                    .arg(rate / 1e6, 0, 'f', 3)
+                    .arg(load, 0, 'f', 1)
+                    .arg(s.gaps).arg(s.lostPairs).arg(s.clippedPairs);
+    }
+    for (const auto& d : demods_) {
+        line += QStringLiteral(" %1 %2 dBFS %3 |")
+                    .arg(d.label.toUpper())
+                    .arg(d.handler->channelPowerDb(), 0, 'f', 1)
+                    .arg(d.handler->squelchOpen() ? QStringLiteral("open")
+                                                  : QStringLiteral("closed"));
+    }
+    if (classifier_) {
+        if (lastClass_.empty())
+            line += QStringLiteral(" class — |");
+        for (const auto& [id, cls] : lastClass_)
+            line += config_.classifier.channels.isEmpty()
+                        ? QStringLiteral(" class %1 |").arg(cls)
+                        : QStringLiteral(" class#%1 %2 |").arg(id).arg(cls);
+    }
+    if (combiner_ && combiner_->crossSpectrumEnabled()) {
+        // Strongest three; the angle only where it is valid.
+        QVector<DfReading> df = lastDf_;
+        std::sort(df.begin(), df.end(),
+                  [](const DfReading& a, const DfReading& b) { return a.powerDb > b.powerDb; });
+        if (df.isEmpty())
+            line += QStringLiteral(" DF — |");
+        for (int i = 0; i < std::min<int>(df.size(), 3); ++i) {
+            line += QStringLiteral(" DF %1 MHz %2° coh %3")
+                        .arg(df[i].freqHz / 1e6, 0, 'f', 3)
+                        .arg(df[i].phaseDeg, 0, 'f', 1)
+                        .arg(df[i].coherence, 0, 'f', 2);
+            if (df[i].angleValid)
+                line += QStringLiteral(" AoA %1°").arg(df[i].angleDeg, 0, 'f', 1);
+            line += QStringLiteral(" |");
+        }
+    }
+    if (line.endsWith(QLatin1Char('|'))) line.chop(2);
+    printLine(line);
+}
+
+void HeadlessRunner::printSummary() {
+    const double secs = static_cast<double>(runClock_.elapsed()) / 1000.0;
+    printLine(QStringLiteral("── summary: %1 s").arg(secs, 0, 'f', 1));
+    for (const auto& w : workers_) {
+        const auto s = w.stats->snapshot();
+        const double avg = secs > 0.0 ? static_cast<double>(s.pairs) / secs : 0.0;
+        printLine(QStringLiteral("   RX%1: %2 blocks, %3 pairs, avg %4 MSps, %5 gaps (%6 pairs lost), "
+                                 "%7 clipped")
+                      .arg(w.channel.channelIndex)
+                      .arg(s.blocks).arg(s.pairs)
+                      .arg(avg / 1e6, 0, 'f', 3)
+                      .arg(s.gaps).arg(s.lostPairs).arg(s.clippedPairs));
+    }
+}
+
+HeadlessRunner::Report HeadlessRunner::report() const {
+    Report r;
+    r.elapsedSec = static_cast<double>(finishedMs_ >= 0 ? finishedMs_ : runClock_.elapsed()) / 1000.0;
+    for (const auto& w : workers_)
+        r.channels.push_back(w.stats->snapshot());
+    r.combinedBlocks       = combiner_ ? combiner_->combinedBlocks() : finalCombined_;
+    r.combinerDrops        = combiner_ ? combiner_->droppedBlocks()  : finalCombinerDrops_;
+    r.combinerSlipSamples  = combiner_ ? combiner_->slipSamples()    : finalCombinerSlips_;
+    r.recorderDroppedBytes = finalRecorderDrops_;
+    for (const auto& [stage, hist] : stageLatency_)
+        r.stages[stage] = hist->snapshot();
+    return r;
+}
+
+void HeadlessRunner::resetStageTiming() {
+    for (auto& [stage, hist] : stageLatency_) hist->reset();
+}
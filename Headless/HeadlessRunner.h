@@ -0,0 +1,154 @@
+#pragma once
+
+#include "HeadlessConfig.h"
+#include "../Core/LatencyHistogram.h"
+#include "../Core/Pipeline.h"
+#include "../DSP/StreamStatsHandler.h"
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QThread>
+#include <QThreadPool>
+#include <QTimer>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <vector>
+
+class AudioFileHandler;
+class BandpassHandler;
+class BaseDemodHandler;
+class ClassifierController;
+class FftHandler;
+class IDevice;
+class IDeviceManager;
+class IqCombiner;
+class PreTriggerRecorder;
+class RawFileHandler;
+class RxWorker;
+class TimedHandler;
+
+// ---------------------------------------------------------------------------
+// HeadlessRunner — StandHeadless's replacement for RadioMonitorPage +
+// CombinedRxController: the same stream graph without widgets or audio out.
+//
+//   RxWorker[i] → PrePipeline[i] (StreamStatsHandler, per-channel raw) ──┐
+//                                      IqCombiner → combined Pipeline ←──┘
+//                                        ├── RawFileHandler
+//                                        ├── PreTriggerRecorder (preTrigger)
+//                                        ├── FftHandler (fftFps > 0)
+//                                        ├── [per demodulator] DemodHandler
+//                                        │     ├── BandpassHandler  (filtered)
+//                                        │     └── AudioFileHandler (audio)
+//                                        └── ClassifierHandler (when enabled)
+//
+// The classifier's results feed the PreTriggerRecorder's classifier trigger.
+// Filenames follow RadioMonitorPage / DemodulatorPanel (FileNaming), so a
+// headless capture is indistinguishable from one made in the GUI.
+// Every statsIntervalSec a status line goes to stdout; a summary at the end.
+//
+// start() opens and configures the device synchronously. stop() (signal,
+// duration, end of replay, worker error) stops the workers; finished() is
+// emitted once every file is closed.
+//
+// With stageTiming every handler is wrapped in a TimedHandler and RxWorker
+// times its read and int16→float steps; report() returns the per-stage
+// latency histograms with the stream and drop counters (SoakRunner).
+// ---------------------------------------------------------------------------
+class HeadlessRunner : public QObject {
+    Q_OBJECT
+
+public:
+    explicit HeadlessRunner(HeadlessConfig config, QObject* parent = nullptr);
+    ~HeadlessRunner() override;
+
+    // False if the device or the stream could not be set up (already logged).
+    bool start();
+    void stop();
+
+    struct Report {
+        double   elapsedSec{0.0};
+        std::vector<StreamStatsHandler::Snapshot> channels;
+        uint64_t combinedBlocks{0};
+        uint64_t combinerDrops{0};          // IqCombiner::droppedBlocks
+        uint64_t combinerSlipSamples{0};    // IqCombiner::slipSamples
+        uint64_t recorderDroppedBytes{0};   // all RawFileHandlers; known once finished
+        std::map<QString, LatencyHistogram::Snapshot> stages;   // stageTiming only
+    };
+
+    // Any time after start(), including after finished().
+    [[nodiscard]] Report report() const;
+    // Clears the stage histograms, e.g. at the end of a warm-up.
+    void resetStageTiming();
+
+signals:
+    void finished(int exitCode);
+
+private:
+    struct Worker {
+        ChannelDescriptor channel;
+        Pipeline*          prePipeline{nullptr};
+        QThread*           thread{nullptr};
+        RxWorker*          worker{nullptr};
+        RawFileHandler*    perChannelRaw{nullptr};
+        std::unique_ptr<StreamStatsHandler> stats;
+    };
+
+    struct Demod {
+        QString           label;     // "fm0", as DemodulatorPanel names files
+        BaseDemodHandler* handler{nullptr};
+        BandpassHandler*  filtered{nullptr};
+        AudioFileHandler* audio{nullptr};
+    };
+
+    bool openDevice();
+    bool buildGraph();
+    void addDemodulator(const HeadlessConfig::Demodulator& d, int slot);
+    // h itself, or h wrapped in a TimedHandler recording into stage.
+    IPipelineHandler* timed(IPipelineHandler* h, const QString& stage);
+    LatencyHistogram* latency(const QString& stage);
+    void startClassifier();
+    void onWorkerFinished();
+    void onDeviceRetuned(ChannelDescriptor ch, double hz);
+    void onDeviceGainChanged(ChannelDescriptor ch, double dB);
+    void printStats();
+    void printSummary();
+    void cleanup();
+
+    HeadlessConfig config_;
+    QThreadPool    pool_;
+
+    std::unique_ptr<IDeviceManager> manager_;   // Lime only
+    std::shared_ptr<IDevice>        device_;
+
+    QList<ChannelDescriptor> channels_;
+    QString                  timestamp_;   // FileNaming session timestamp
+    std::vector<Worker>      workers_;
+    IqCombiner*              combiner_{nullptr};
+    Pipeline*                pipeline_{nullptr};
+    std::vector<RawFileHandler*> rawHandlers_;
+    PreTriggerRecorder*      preTrigger_{nullptr};
+    std::atomic<double>      preTriggerCenterHz_{0.0};   // read by the writer thread
+    std::vector<Demod>       demods_;
+    ClassifierController*    classifier_{nullptr};
+    FftHandler*              fft_{nullptr};
+    std::map<quint32, QString> lastClass_;   // channel id → "FM (95 %)"
+    QVector<DfReading>       lastDf_;       // latest IqCombiner::crossSpectrum()
+
+    std::map<QString, std::unique_ptr<LatencyHistogram>> stageLatency_;
+    std::vector<std::unique_ptr<TimedHandler>>           timedHandlers_;
+    uint64_t finalCombined_{0};
+    uint64_t finalCombinerDrops_{0};
+    uint64_t finalCombinerSlips_{0};
+    uint64_t finalRecorderDrops_{0};
+    qint64   finishedMs_{-1};
+
+    QTimer        statsTimer_;
+    QTimer        temperatureTimer_;   // feeds the temperature gauge, metricsPort only
+    QElapsedTimer runClock_;
+    qint64        lastStatsMs_{0};
+    std::vector<uint64_t> lastPairs_;
+    int  finishedCount_{0};
+    int  exitCode_{0};
+    bool stopping_{false};
+};
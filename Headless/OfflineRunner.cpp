@@ -0,0 +1,125 @@
+#include "OfflineRunner.h"
+#include "../Core/FileNaming.h"
+#include "../DSP/AudioFileHandler.h"
+#include "../DSP/BandpassExporter.h"
+#include "../DSP/BaseDemodHandler.h"
+#include "../DSP/DemodRegistry.h"
+#include "../DSP/OfflineProcessor.h"
+#include "Logger.h"
+
+#include <QDir>
+#include <QElapsedTimer>
+#include <QThreadPool>
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+
+namespace {
+
+void report(const QString& line) {
+    std::fputs(qPrintable(line + QLatin1Char('\n')), stdout);
+    std::fflush(stdout);
+}
+
+}  // namespace
+
+int runOffline(const HeadlessConfig& config) {
+    const auto& rec = config.recording;
+    if (config.threads > 0) QThreadPool::globalInstance()->setMaxThreadCount(config.threads);
+
+    OfflineProcessor::Options opts;
+    OfflineProcessor probe;
+    if (!probe.open(config.file.path)) {
+        LOG_ERROR("runOffline: cannot open " + config.file.path.toStdString());
+        return 1;
+    }
+    const double sr       = config.file.sampleRateHz > 0.0 ? config.file.sampleRateHz
+                                                           : probe.sigmfSampleRate();
+    const double centerHz = config.file.centerHz > 0.0 ? config.file.centerHz
+                                                       : probe.sigmfCenterHz();
+    if (sr <= 0.0) {
+        LOG_ERROR("runOffline: no sample rate in the config or a SigMF sidecar");
+        return 1;
+    }
+    if (!QDir().mkpath(rec.outputDir)) {
+        LOG_ERROR("runOffline: cannot create " + rec.outputDir.toStdString());
+        return 1;
+    }
+    opts.chunkPairs = std::max<int64_t>(1, static_cast<int64_t>(config.offline.chunkSec * sr));
+    probe.close();
+
+    OfflineProcessor proc(opts);
+    if (!proc.open(config.file.path)) return 1;
+
+    const QString source    = FileNaming::combinedSource({ChannelDescriptor{}});
+    const QString timestamp = FileNaming::currentTimestamp();
+    const double  seconds   = static_cast<double>(proc.totalPairs()) / sr;
+
+    for (int slot = 0; slot < config.demodulators.size(); ++slot) {
+        const auto& d = config.demodulators[slot];
+        std::unique_ptr<BaseDemodHandler> h(
+            DemodRegistry::instance().create(d.mode, d.offsetHz, nullptr));
+        if (!h) {
+            LOG_WARN("runOffline: unknown demodulator \"" + d.mode.toStdString() + "\"");
+            continue;
+        }
+        for (auto it = d.params.begin(); it != d.params.end(); ++it)
+            h->setParam(it.key(), it.value());
+        if (d.squelchDb) h->setSquelch(*d.squelchDb);
+        const QString label = QStringLiteral("%1%2").arg(d.mode.toLower()).arg(slot);
+
+        if (rec.recordAudio) {
+            std::unique_ptr<BaseDemodulator> prototype;
+            try {
+                prototype = h->makeDemodulator(sr);
+            } catch (const std::exception& ex) {
+                LOG_ERROR("runOffline: " + label.toStdString() + ": " + ex.what());
+                return 1;
+            }
+            const double audioSr = prototype->audioSampleRate();
+            AudioFileHandler audio([&](double rate) {
+                return FileNaming::composeWithSuffix(rec.outputDir, timestamp, source, label,
+                                                     centerHz, rate, ".wav");
+            });
+            audio.setSegmentPolicy(rec.segmentPolicy());
+
+            QElapsedTimer t;
+            t.start();
+            OfflineProcessor::Stats stats;
+            const bool ok = proc.demodulate(*prototype, [&](const float* a, std::size_t n) {
+                audio.push(QVector<float>(a, a + n), audioSr);
+            }, &stats);
+            audio.close();
+            if (!ok) return 2;
+            report(QStringLiteral("%1: %2 s of audio in %3 s (%4× realtime, %5 chunks, %6 resynced)")
+                       .arg(label).arg(seconds, 0, 'f', 1).arg(t.elapsed() / 1e3, 0, 'f', 1)
+                       .arg(seconds * 1e3 / std::max<qint64>(1, t.elapsed()), 0, 'f', 1)
+                       .arg(stats.chunks).arg(stats.resynced));
+        }
+
+        if (rec.recordFiltered) {
+            const double bwHz = h->param(QStringLiteral("Bandwidth"));
+            constexpr double kOutputSR = 250'000.0;   // as HeadlessRunner
+            if (bwHz <= 0.0 || kOutputSR > sr) continue;
+            const QString suffix = QStringLiteral("bp%1kHz").arg(bwHz / 1e3, 0, 'f', 0);
+            BandpassExporter out(sr, d.offsetHz, bwHz, kOutputSR);
+            if (!out.open(FileNaming::composeWithSuffix(rec.outputDir, timestamp, source, suffix,
+                                                        centerHz, kOutputSR, ".cf32"),
+                          rec.segmentPolicy()))
+                return 1;
+
+            QElapsedTimer t;
+            t.start();
+            const bool ok = proc.bandpass(sr, d.offsetHz, bwHz, kOutputSR,
+                                          [&](const float* iq, std::size_t n) {
+                                              out.writeOutput(iq, n / 2);
+                                          });
+            out.close();
+            if (!ok) return 2;
+            report(QStringLiteral("%1: filtered I/Q in %2 s (%3× realtime)")
+                       .arg(suffix).arg(t.elapsed() / 1e3, 0, 'f', 1)
+                       .arg(seconds * 1e3 / std::max<qint64>(1, t.elapsed()), 0, 'f', 1));
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include "HeadlessConfig.h"
+
+// ---------------------------------------------------------------------------
+// runOffline — StandHeadless's "offline" mode: every configured demodulator
+// (and its filtered I/Q when recording.filtered is set) is run over the
+// whole device.path recording with OfflineProcessor, one after another,
+// each using every pool thread. Output names follow HeadlessRunner.
+//
+// Returns the process exit code (0 ok, 1 set-up error, 2 read error).
+// ---------------------------------------------------------------------------
+int runOffline(const HeadlessConfig& config);
@@ -0,0 +1,284 @@
+#include "SoakRunner.h"
+#include "../Core/ProcessUsage.h"
+#include "../Hardware/LimeDevice.h"
+#include "Logger.h"
+
+#include <QDateTime>
+#include <QJsonDocument>
+#include <QSaveFile>
+#include <QSysInfo>
+#include <QThread>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+
+namespace {
+
+constexpr int    kRssSampleMs = 100;
+constexpr double kMiB         = 1024.0 * 1024.0;
+
+void printLine(const QString& line) {
+    std::fputs(qPrintable(line + QLatin1Char('\n')), stdout);
+    std::fflush(stdout);
+}
+
+QJsonObject stageJson(const LatencyHistogram::Snapshot& s) {
+    const auto us = [](uint64_t ns) { return static_cast<double>(ns) / 1e3; };
+    return {
+        {"blocks", static_cast<qint64>(s.count)},
+        {"meanUs", s.meanNs() / 1e3},
+        {"p50Us",  us(s.percentileNs(0.50))},
+        {"p90Us",  us(s.percentileNs(0.90))},
+        {"p99Us",  us(s.percentileNs(0.99))},
+        {"maxUs",  us(s.maxNs)},
+    };
+}
+
+}  // namespace
+
+SoakRunner::SoakRunner(HeadlessConfig config, QObject* parent)
+    : QObject(parent)
+    , base_(std::move(config))
+{
+    rates_ = base_.soak.sampleRatesHz.isEmpty() ? LimeDevice::kSupportedRates
+                                                : base_.soak.sampleRatesHz;
+    std::sort(rates_.begin(), rates_.end());
+
+    rssTimer_.setInterval(kRssSampleMs);
+    connect(&rssTimer_, &QTimer::timeout, this, [this] {
+        rssPeak_ = std::max(rssPeak_, ProcessUsage::residentBytes());
+    });
+}
+
+SoakRunner::~SoakRunner() = default;
+
+void SoakRunner::start() {
+    printLine(QStringLiteral("soak: %1 channel(s), %2 s per run after %3 s warm-up, "
+                             "sustained = RTF ≥ %4 and no drops")
+                  .arg(base_.channels.size())
+                  .arg(base_.soak.durationSec, 0, 'f', 1)
+                  .arg(base_.soak.warmupSec, 0, 'f', 1)
+                  .arg(base_.soak.rtfMargin, 0, 'f', 2));
+    printLine(QStringLiteral("  MS/s  demods     RTF   drops  cores  peak MiB  demod p99 µs"));
+    // From the event loop, so finished() reaches a connected QCoreApplication::exit.
+    QTimer::singleShot(0, this, &SoakRunner::startNext);
+}
+
+void SoakRunner::stop() {
+    aborted_ = true;
+    if (runner_) runner_->stop();
+}
+
+HeadlessConfig SoakRunner::runConfig(const Step& step) const {
+    HeadlessConfig c = base_;
+    c.sampleRateHz      = step.sampleRateHz;
+    c.sim.realtime      = false;
+    c.durationSec       = 0.0;
+    c.statsIntervalSec  = 0.0;
+    c.stageTiming       = true;
+    c.fftFps            = base_.soak.fftFps;
+    c.classifier.enabled = false;
+
+    QList<HeadlessConfig::Demodulator> templates = base_.demodulators;
+    if (templates.isEmpty()) {
+        HeadlessConfig::Demodulator fm;
+        fm.mode = QStringLiteral("FM");
+        templates.append(fm);
+    }
+    c.demodulators.clear();
+    for (int i = 0; i < step.demods; ++i) {
+        HeadlessConfig::Demodulator d = templates[i % templates.size()];
+        d.offsetHz = (-0.4 + 0.8 * (i + 0.5) / step.demods) * step.sampleRateHz;
+        c.demodulators.append(d);
+    }
+    return c;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// One run: start → warm-up → measure → stop → finished
+// ═══════════════════════════════════════════════════════════════════════════════
+void SoakRunner::startNext() {
+    if (aborted_ || rateIdx_ >= rates_.size()) {
+        writeReport();
+        emit finished(exitCode_);
+        return;
+    }
+    step_    = {rates_[rateIdx_], base_.soak.demodCounts[countIdx_]};
+    pending_ = {};
+
+    rssBefore_ = ProcessUsage::residentBytes();
+    rssPeak_   = rssBefore_;
+    rssTimer_.start();
+
+    runner_ = std::make_unique<HeadlessRunner>(runConfig(step_));
+    connect(runner_.get(), &HeadlessRunner::finished,
+            this, &SoakRunner::onRunFinished, Qt::QueuedConnection);
+    if (!runner_->start()) {
+        rssTimer_.stop();
+        runner_.reset();
+        exitCode_ = 2;
+        finishRun(false, {{"error", "start failed"}});
+        return;
+    }
+    // Timers die with the runner, so an aborted run cannot fire them.
+    QTimer::singleShot(static_cast<int>(base_.soak.warmupSec * 1000.0), runner_.get(),
+                       [this] { onWarmupDone(); });
+}
+
+void SoakRunner::onWarmupDone() {
+    runner_->resetStageTiming();
+    baseline_   = runner_->report();
+    cpuAtStart_ = ProcessUsage::cpuSeconds();
+    measureClock_.start();
+    QTimer::singleShot(static_cast<int>(base_.soak.durationSec * 1000.0), runner_.get(),
+                       [this] { onMeasureDone(); });
+}
+
+void SoakRunner::onMeasureDone() {
+    const HeadlessRunner::Report r = runner_->report();
+    const double wallSec = static_cast<double>(measureClock_.nsecsElapsed()) / 1e9;
+    const double cpuSec  = ProcessUsage::cpuSeconds() - cpuAtStart_;
+
+    uint64_t pairs = UINT64_MAX, gaps = 0, lost = 0;
+    for (std::size_t i = 0; i < r.channels.size(); ++i) {
+        pairs = std::min(pairs, r.channels[i].pairs - baseline_.channels[i].pairs);
+        gaps += r.channels[i].gaps - baseline_.channels[i].gaps;
+        lost += r.channels[i].lostPairs - baseline_.channels[i].lostPairs;
+    }
+    if (r.channels.empty()) pairs = 0;
+    const double throughput = wallSec > 0.0 ? static_cast<double>(pairs) / wallSec : 0.0;
+    const double cores      = wallSec > 0.0 ? cpuSec / wallSec : 0.0;
+
+    QJsonObject stages;
+    for (const auto& [stage, snap] : r.stages)
+        if (snap.count > 0) stages[stage] = stageJson(snap);
+
+    pending_ = {
+        {"measuredSec",    wallSec},
+        {"throughputMSps", throughput / 1e6},
+        {"rtf",            throughput / step_.sampleRateHz},
+        {"drops", QJsonObject{
+            {"combinerBlocks", static_cast<qint64>(r.combinerDrops - baseline_.combinerDrops)},
+            {"combinerSlipSamples",
+             static_cast<qint64>(r.combinerSlipSamples - baseline_.combinerSlipSamples)},
+            {"gaps",           static_cast<qint64>(gaps)},
+            {"lostPairs",      static_cast<qint64>(lost)},
+        }},
+        {"stages", stages},
+        {"cpu", QJsonObject{
+            {"coresBusy",  cores},
+            {"perCorePct", 100.0 * cores / std::max(1, QThread::idealThreadCount())},
+        }},
+    };
+    runner_->stop();
+}
+
+void SoakRunner::onRunFinished() {
+    rssTimer_.stop();
+    rssPeak_ = std::max(rssPeak_, ProcessUsage::residentBytes());
+    const uint64_t recorderDrops = runner_->report().recorderDroppedBytes;
+    runner_.reset();
+
+    if (pending_.isEmpty()) {   // stopped before the measurement ended
+        startNext();
+        return;
+    }
+
+    QJsonObject result = pending_;
+    QJsonObject drops  = result["drops"].toObject();
+    drops["recorderBytes"] = static_cast<qint64>(recorderDrops);
+    result["drops"]  = drops;
+    result["memory"] = QJsonObject{
+        {"beforeMiB", static_cast<double>(rssBefore_) / kMiB},
+        {"peakMiB",   static_cast<double>(rssPeak_) / kMiB},
+    };
+
+    const bool noDrops = drops["combinerBlocks"].toInteger() == 0
+                      && drops["gaps"].toInteger() == 0 && recorderDrops == 0;
+    finishRun(noDrops && result["rtf"].toDouble() >= base_.soak.rtfMargin, result);
+}
+
+void SoakRunner::finishRun(bool sustained, QJsonObject result) {
+    result["sampleRateMSps"] = step_.sampleRateHz / 1e6;
+    result["demods"]         = step_.demods;
+    result["sustained"]      = sustained;
+    runs_.append(result);
+
+    const QJsonObject drops    = result["drops"].toObject();
+    const qint64      recBytes = drops["recorderBytes"].toInteger();
+    const QJsonObject demod    = result["stages"].toObject()["demod"].toObject();
+    printLine(QStringLiteral("%1  %2  %3  %4  %5  %6  %7%8%9")
+                  .arg(step_.sampleRateHz / 1e6, 6, 'f', 2)
+                  .arg(step_.demods, 6)
+                  .arg(result["rtf"].toDouble(), 6, 'f', 2)
+                  .arg(drops["combinerBlocks"].toInteger() + drops["gaps"].toInteger(), 6)
+                  .arg(result["cpu"].toObject()["coresBusy"].toDouble(), 5, 'f', 2)
+                  .arg(result["memory"].toObject()["peakMiB"].toDouble(), 8, 'f', 1)
+                  .arg(demod.isEmpty() ? QStringLiteral("           —")
+                                       : QStringLiteral("%1").arg(demod["p99Us"].toDouble(), 12, 'f', 0))
+                  .arg(recBytes > 0 ? QStringLiteral("  recorder dropped %1 MiB")
+                                          .arg(static_cast<double>(recBytes) / kMiB, 0, 'f', 1)
+                                    : QString())
+                  .arg(sustained ? QString() : QStringLiteral("  ✗")));
+
+    if (sustained) maxSustained_ = step_.demods;
+    if (sustained && countIdx_ + 1 < base_.soak.demodCounts.size()) {
+        ++countIdx_;
+    } else {
+        summary_.append(QJsonObject{
+            {"sampleRateMSps", step_.sampleRateHz / 1e6},
+            {"maxDemods",      maxSustained_ >= 0 ? QJsonValue(maxSustained_) : QJsonValue()},
+        });
+        printLine(maxSustained_ >= 0
+                      ? QStringLiteral("  → %1 MS/s: %2 demodulator(s) sustained")
+                            .arg(step_.sampleRateHz / 1e6, 0, 'f', 2).arg(maxSustained_)
+                      : QStringLiteral("  → %1 MS/s: not sustained even without demodulators")
+                            .arg(step_.sampleRateHz / 1e6, 0, 'f', 2));
+        ++rateIdx_;
+        countIdx_     = 0;
+        maxSustained_ = -1;
+    }
+    QTimer::singleShot(0, this, &SoakRunner::startNext);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// Report
+// ═══════════════════════════════════════════════════════════════════════════════
+void SoakRunner::writeReport() {
+    if (base_.soak.output.isEmpty()) return;
+
+    QJsonArray counts;
+    for (int n : base_.soak.demodCounts) counts.append(n);
+    const QJsonObject report{
+        {"schema",    1},
+        {"generated", QDateTime::currentDateTimeUtc().toString(Qt::ISODate)},
+        {"host", QJsonObject{
+            {"name",    QSysInfo::machineHostName()},
+            {"os",      QSysInfo::prettyProductName()},
+            {"cpuArch", QSysInfo::currentCpuArchitecture()},
+            {"threads", QThread::idealThreadCount()},
+        }},
+        {"options", QJsonObject{
+            {"channels",    static_cast<int>(base_.channels.size())},
+            {"durationSec", base_.soak.durationSec},
+            {"warmupSec",   base_.soak.warmupSec},
+            {"rtfMargin",   base_.soak.rtfMargin},
+            {"fftFps",      base_.soak.fftFps},
+            {"demodCounts", counts},
+            {"threads",     base_.threads},
+            {"recording",   !base_.recording.outputDir.isEmpty()},
+            {"aborted",     aborted_},
+        }},
+        {"runs",    runs_},
+        {"summary", summary_},
+    };
+
+    const QByteArray json = QJsonDocument(report).toJson(QJsonDocument::Indented);
+    QSaveFile f(base_.soak.output);
+    if (!f.open(QIODevice::WriteOnly) || f.write(json) != json.size() || !f.commit()) {
+        LOG_ERROR("SoakRunner: cannot write " + base_.soak.output.toStdString());
+        exitCode_ = 1;
+        return;
+    }
+    printLine(QStringLiteral("soak: report written to %1").arg(base_.soak.output));
+}
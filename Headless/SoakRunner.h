@@ -0,0 +1,84 @@
+#pragma once
+
+#include "HeadlessConfig.h"
+#include "HeadlessRunner.h"
+
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QObject>
+#include <QTimer>
+#include <memory>
+
+// ---------------------------------------------------------------------------
+// SoakRunner — StandHeadless's "soak" mode: how many demodulator panels this
+// machine sustains at each sample rate with the full receive graph running.
+//
+// For every sample rate (ascending) and demodulator count (ascending) one
+// HeadlessRunner is built over a free-running SimulatedDevice — the GUI's
+// topology: RxWorker per channel → PrePipelines → IqCombiner → combined
+// Pipeline with FftHandler, N demodulators and the configured recorders —
+// and run for warmupSec + durationSec. Over the measured part it records:
+//
+//   throughput / real-time factor  (pairs delivered ÷ sample rate)
+//   drops       combiner overruns, timestamp gaps, recorder bytes dropped
+//   stages      per-block latency percentiles of every stage (stageTiming)
+//   memory      resident set before the run and its sampled peak
+//   cpu         process CPU time ÷ wall time, also per logical core
+//
+// A configuration is sustained when RTF ≥ rtfMargin with no drops; the
+// first one that is not ends the escalation at that rate. The summary's
+// maxDemods is the largest sustained count. Demodulator panels cycle
+// through the config's "demodulators" (FM when empty), spread evenly over
+// ±40 % of the sample rate.
+//
+// A table goes to stdout as runs finish; the JSON report to soak.output.
+// ---------------------------------------------------------------------------
+class SoakRunner : public QObject {
+    Q_OBJECT
+
+public:
+    explicit SoakRunner(HeadlessConfig config, QObject* parent = nullptr);
+    ~SoakRunner() override;
+
+    void start();
+    void stop();   // aborts after the current run; the report is still written
+
+signals:
+    void finished(int exitCode);
+
+private:
+    struct Step {
+        double sampleRateHz{0.0};
+        int    demods{0};
+    };
+
+    [[nodiscard]] HeadlessConfig runConfig(const Step& step) const;
+    void startNext();
+    void onWarmupDone();
+    void onMeasureDone();
+    void onRunFinished();
+    void finishRun(bool sustained, QJsonObject result);
+    void writeReport();
+
+    HeadlessConfig    base_;
+    QList<double>     rates_;
+    qsizetype         rateIdx_{0};
+    qsizetype         countIdx_{0};
+    Step              step_;
+    bool              aborted_{false};
+    int               exitCode_{0};
+
+    std::unique_ptr<HeadlessRunner> runner_;
+    HeadlessRunner::Report baseline_;
+    QTimer        rssTimer_;
+    QElapsedTimer measureClock_;
+    double        cpuAtStart_{0.0};
+    uint64_t      rssBefore_{0};
+    uint64_t      rssPeak_{0};
+    QJsonObject   pending_;         // measured result, completed in onRunFinished
+
+    QJsonArray runs_;
+    QJsonArray summary_;
+    int        maxSustained_{-1};   // at the current rate
+};
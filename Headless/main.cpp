@@ -0,0 +1,137 @@
+#include "HeadlessConfig.h"
+#include "HeadlessRunner.h"
+#include "../Application/MetricsServer.h"
+#include "OfflineRunner.h"
+#include "SoakRunner.h"
+#include "Logger.h"
+#include "Trace.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QTimer>
+#include <atomic>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+
+// ---------------------------------------------------------------------------
+// StandHeadless — runs the receive pipeline from a JSON config without any
+// widgets: `StandHeadless config.json [--duration 60]`.
+//
+// SIGINT/SIGTERM stop the stream and close every file; a second signal exits
+// immediately. Exit code: 0 ok, 1 config or start-up error, 2 stream error.
+// With "offline.enabled" the recording is processed by runOffline() instead;
+// with "soak.enabled" SoakRunner benchmarks the graph (exit 2 = a run failed).
+// With "traceFile" spans are recorded from the start and written on exit;
+// SIGUSR1 (not on Windows) writes the trace so far without stopping.
+// With "metricsPort" the live counters are served on 127.0.0.1:<port>/metrics.
+// ---------------------------------------------------------------------------
+namespace {
+
+std::atomic<int>  g_signals{0};
+std::atomic<bool> g_traceRequested{false};
+
+void onSignal(int) {
+    // Only async-signal-safe work here; the event loop polls g_signals.
+    if (g_signals.fetch_add(1) > 0) std::_Exit(130);
+}
+
+#ifndef _WIN32
+void onTraceSignal(int) {
+    g_traceRequested.store(true);
+}
+#endif
+
+void writeTrace(const QString& path) {
+    QString error;
+    if (Trace::writeChromeJson(path, &error))
+        std::fprintf(stdout, "trace written to %s\n", qPrintable(path));
+    else
+        std::fprintf(stderr, "StandHeadless: %s\n", qPrintable(error));
+    std::fflush(stdout);
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("Stand headless receive pipeline"));
+    parser.addHelpOption();
+    parser.addPositionalArgument(QStringLiteral("config"), QStringLiteral("JSON configuration file"));
+    QCommandLineOption durationOpt(QStringLiteral("duration"),
+                                   QStringLiteral("Stop after <seconds> (overrides durationSec)."),
+                                   QStringLiteral("seconds"));
+    parser.addOption(durationOpt);
+    parser.process(app);
+
+    if (parser.positionalArguments().size() != 1) {
+        std::fputs(qPrintable(parser.helpText()), stderr);
+        return 1;
+    }
+
+    QString error;
+    auto config = HeadlessConfig::load(parser.positionalArguments().first(), &error);
+    if (!config) {
+        std::fprintf(stderr, "StandHeadless: %s\n", qPrintable(error));
+        return 1;
+    }
+    if (parser.isSet(durationOpt))
+        config->durationSec = parser.value(durationOpt).toDouble();
+    if (!config->logFile.isEmpty())
+        Logger::instance().setLogFile(config->logFile.toStdString());
+    if (config->offline.enabled)
+        return runOffline(*config);
+
+    std::signal(SIGINT,  onSignal);
+    std::signal(SIGTERM, onSignal);
+#ifdef _WIN32
+    std::signal(SIGBREAK, onSignal);
+#else
+    std::signal(SIGUSR1, onTraceSignal);
+#endif
+    QTimer signalPoll;
+
+    const QString traceFile = config->traceFile;
+    if (!traceFile.isEmpty()) {
+        Trace::setThreadName("main");
+        Trace::setEnabled(true);
+        QObject::connect(&signalPoll, &QTimer::timeout, &app, [traceFile] {
+            if (g_traceRequested.exchange(false)) writeTrace(traceFile);
+        });
+    }
+
+    MetricsServer metrics;
+    if (config->metricsPort > 0
+        && !metrics.listen(static_cast<quint16>(config->metricsPort), &error)) {
+        std::fprintf(stderr, "StandHeadless: %s\n", qPrintable(error));
+        return 1;
+    }
+
+    int exitCode = 0;
+    if (config->soak.enabled) {
+        SoakRunner soak(std::move(*config));
+        QObject::connect(&soak, &SoakRunner::finished, &app, &QCoreApplication::exit);
+        QObject::connect(&signalPoll, &QTimer::timeout, &soak, [&soak] {
+            if (g_signals.load() > 0) soak.stop();
+        });
+        signalPoll.start(100);
+        soak.start();
+        exitCode = app.exec();
+    } else {
+        HeadlessRunner runner(std::move(*config));
+        QObject::connect(&runner, &HeadlessRunner::finished, &app, &QCoreApplication::exit);
+
+        QObject::connect(&signalPoll, &QTimer::timeout, &runner, [&runner] {
+            if (g_signals.load() > 0) runner.stop();
+        });
+        signalPoll.start(100);
+
+        if (!runner.start()) return 1;
+        exitCode = app.exec();
+    }
+
+    if (!traceFile.isEmpty()) writeTrace(traceFile);
+    return exitCode;
+}
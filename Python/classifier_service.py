@@ -1,114 +1,347 @@
 #!/usr/bin/env python3
 """
-Stand SDR — signal classifier service.
+Stand SDR — signal classifier service (protocol v2).
 
 Drop-in contract:
-  1. Receive binary I/Q frames from Stand (see FRAME FORMAT below).
-  2. Classify the modulation type.
-  3. Send back a JSON result on the same TCP connection.
+  1. Accept Stand's TCP connection and send the hello (see RESULTS).
+  2. Receive frames — through a shared-memory ring when started with
+     --shm <name> (see RING FORMAT), otherwise over the socket behind a
+     u32 length prefix. Each frame holds one or more narrowband snippets.
+  3. Classify all snippets of a frame as one batch.
+  4. Send one result record per snippet back on the TCP connection.
 
-To plug in a real model, replace the classify() function.
-Dependencies for the stub: none (stdlib only).
+Reading the next frame overlaps inference on the current one; Stand keeps at
+most a few frames in flight and drops (and counts) blocks beyond that.
+
+To plug in a real model, replace classify_batch() (or classify()).
+Dependencies for the stub: none over TCP; numpy for --shm.
 Dependencies for a real model: torch, numpy (or tflite, onnxruntime, etc.)
 
-FRAME FORMAT (little-endian):
-  [4B uint32  payload_length  — length of everything after these 4 bytes]
-  [8B uint64  timestamp       — hardware sample counter from LimeSuite]
-  [4B int32   sample_count N  — number of complex samples]
-  [8B float64 sample_rate_hz  — samples per second]
-  [N*2*2B int16 IQ pairs      — interleaved: I0, Q0, I1, Q1, ...]
+FRAME FORMAT (Core/ClassifierProtocol.h, little-endian):
+  header (32):  0 u32 magic "STC2"  4 u32 version (2)  8 u32 frame_id
+               12 u32 snippet_count 16 u64 timestamp   24 u32 frame_bytes
+               28 u32 kind (0 = I/Q, 1 = features)
+  snippet, back to back:
+                0 u32 channel_id    4 i32 N
+                8 f64 centre_hz    16 f64 sample_rate_hz  24 f64 bandwidth_hz
+               32 u64 timestamp    40 kind 0: N*2 float32 I/Q, interleaved
+                                      kind 1: N float32 features (FEATURES)
 
-RESPONSE FORMAT (newline-terminated JSON):
-  {"type": "FM", "confidence": 0.95, "timestamp": 12345}
+RING FORMAT (Core/ShmIqRing.h, little-endian):
+  header  0 u32 magic "STIQ"  4 u32 version (2)  8 u32 slot_count
+         12 u32 slot_bytes   16 u32 payload_bytes
+         24 u64 write_seq (frames published)  32 u64 read_seq (frames released,
+         written by this script)  40 u64 dropped_frames
+  slot k = frame % slot_count at 64 + k * slot_bytes:
+          0 u64 frame_seq (frame + 1 when complete)  8 u32 bytes
+         16 one frame (FRAME FORMAT)
+  Stand never overwrites a slot this script has not released: when the
+  script falls behind, new frames are dropped and counted instead.
 
-Supported type strings (extend as needed):
-  FM, AM, CW, USB, LSB, NFM, Unknown
+RESULTS (this script → Stand, little-endian):
+  hello (8), once:   0 u32 magic "STR2"  4 u32 version (2)
+  result (24):       0 u32 frame_id  4 u32 channel_id  8 u64 timestamp
+                    16 u16 type     18 u16 flags (1 = last result of the frame)
+                    20 f32 confidence
+  type: 0 Unknown, 1 FM, 2 AM, 3 CW, 4 USB, 5 LSB, 6 NFM
 """
 
+import argparse
+import array
+import queue
+import random
+import select
 import socket
 import struct
-import json
-import random
 import sys
-import time
+import threading
+from typing import NamedTuple
 
 HOST = "127.0.0.1"
 PORT = 52001
 
-# Header inside the payload (after the 4-byte length prefix)
-# Format: timestamp (uint64) + count (int32) + sample_rate (float64)
-_HDR = struct.Struct("<QId")   # 8 + 4 + 8 = 20 bytes
-_KNOWN_TYPES = ["FM", "AM", "CW", "USB", "LSB", "NFM"]
+TYPES = ["Unknown", "FM", "AM", "CW", "USB", "LSB", "NFM"]
+
+# Feature-frame order (DSP/ModulationFeatures.h).
+FEATURES = ["power_db", "c20", "c40", "c41", "c42",
+            "sigma_aa", "sigma_ap", "sigma_dp", "sigma_f_hz",
+            "gamma_max", "peak_share", "symmetry", "snr_db"]
+
+_VERSION      = 2
+_FRAME_MAGIC  = 0x32435453   # "STC2"
+_RESULT_MAGIC = 0x32525453   # "STR2"
+_FRAME_HDR    = struct.Struct("<IIIIQII")   # magic, version, frame_id, n, timestamp, bytes, kind
+_SNIPPET_HDR  = struct.Struct("<IidddQ")    # channel_id, count, centre, rate, bandwidth, ts
+_HELLO        = struct.pack("<II", _RESULT_MAGIC, _VERSION)
+_RESULT       = struct.Struct("<IIQHHf")
+_LAST_IN_FRAME = 1
+_LEN          = struct.Struct("<I")
+_KIND_IQ       = 0
+_KIND_FEATURES = 1
+
+# Shared-memory ring (Core/ShmIqRing.h)
+_RING_MAGIC   = 0x51495453
+_RING_VERSION = 2
+_RING_HDR     = struct.Struct("<IIIII")   # magic, version, slot_count, slot_bytes, payload_bytes
+_RING_HEADER_BYTES = 64
+_OFF_WRITE_SEQ = 24
+_OFF_READ_SEQ  = 32
+_OFF_DROPPED   = 40
+_SLOT_HDR      = struct.Struct("<QI")      # frame_seq, bytes
+_SLOT_PAYLOAD  = 16
+_U64           = struct.Struct("<Q")
+_POLL_SEC      = 0.005
+
+_QUEUE_DEPTH = 1   # frames parsed ahead of the one being classified
+
+try:
+    import numpy as _np
+except ImportError:
+    _np = None
+
+
+class Snippet(NamedTuple):
+    channel_id:   int
+    centre_hz:    float
+    sample_rate:  float
+    bandwidth_hz: float
+    timestamp:    int
+    iq:           object          # float32 interleaved I/Q (numpy view or array.array)
+    features:     object = None   # float32 FEATURES instead of iq in feature frames
 
 
 # ---------------------------------------------------------------------------
-# Replace this function with real model inference.
-# iq_samples: list of int16, interleaved I/Q  [I0, Q0, I1, Q1, ...]
-# sample_rate: float, Hz
-# Returns: (type_string, confidence_0_to_1)
+# Replace these functions with real model inference.
+# iq_samples: float32 sequence, interleaved I/Q [I0, Q0, I1, Q1, ...], ±1.0
+#             full scale — a numpy array viewing shared memory in --shm mode;
+#             copy it if you need it after classify_batch() returns
+# Returns: (type_string from TYPES, confidence_0_to_1)
 # ---------------------------------------------------------------------------
-def classify(iq_samples: list, sample_rate: float) -> tuple[str, float]:
+def classify(iq_samples, sample_rate: float) -> tuple[str, float]:
     """Stub: returns a random result.  Replace with actual model."""
-    return random.choice(_KNOWN_TYPES), round(random.uniform(0.5, 0.99), 3)
+    return random.choice(TYPES[1:]), round(random.uniform(0.5, 0.99), 3)
+
+
+def classify_features(features, sample_rate: float) -> tuple[str, float]:
+    """Stub for feature frames (Stand's classifier.mode "features")."""
+    return random.choice(TYPES[1:]), round(random.uniform(0.5, 0.99), 3)
+
+
+def classify_batch(snippets: list[Snippet]) -> list[tuple[str, float]]:
+    """One result per snippet, in order.  Run the model on the whole batch here;
+    for feature frames numpy.stack([s.features for s in snippets]) is the
+    (snippets x FEATURES) input matrix."""
+    return [classify_features(s.features, s.sample_rate) if s.features is not None
+            else classify(s.iq, s.sample_rate) for s in snippets]
 
 
 # ---------------------------------------------------------------------------
-# Protocol helpers
+# Frames
 # ---------------------------------------------------------------------------
+def _floats(buf, offset: int, count: int):
+    if _np is not None:
+        return _np.frombuffer(buf, dtype=_np.float32, count=count, offset=offset)
+    values = array.array("f")
+    values.frombytes(bytes(buf[offset:offset + count * 4]))
+    if sys.byteorder != "little":
+        values.byteswap()
+    return values
+
+
+def parse_frame(buf) -> tuple[int, list[Snippet]]:
+    """(frame_id, snippets) of one frame; the snippets' I/Q or feature views
+    point into buf."""
+    if len(buf) < _FRAME_HDR.size:
+        raise ValueError("frame shorter than its header")
+    magic, version, frame_id, count, _, frame_bytes, kind = _FRAME_HDR.unpack_from(buf, 0)
+    if magic != _FRAME_MAGIC or version != _VERSION:
+        raise ValueError(f"not a v{_VERSION} frame (magic {magic:#x}, version {version})")
+    if frame_bytes > len(buf):
+        raise ValueError(f"frame truncated ({len(buf)} < {frame_bytes} bytes)")
+    if kind not in (_KIND_IQ, _KIND_FEATURES):
+        raise ValueError(f"unknown frame kind {kind}")
+
+    snippets = []
+    pos = _FRAME_HDR.size
+    for _ in range(count):
+        channel_id, n, centre, rate, bandwidth, ts = _SNIPPET_HDR.unpack_from(buf, pos)
+        pos += _SNIPPET_HDR.size
+        size = n * (4 if kind == _KIND_FEATURES else 8)
+        if n < 0 or pos + size > frame_bytes:
+            raise ValueError("snippet runs past the end of the frame")
+        if kind == _KIND_FEATURES:
+            snippets.append(Snippet(channel_id, centre, rate, bandwidth, ts, None,
+                                    _floats(buf, pos, n)))
+        else:
+            snippets.append(Snippet(channel_id, centre, rate, bandwidth, ts,
+                                    _floats(buf, pos, n * 2)))
+        pos += size
+    return frame_id, snippets
+
+
+def _results(frame_id: int, snippets: list[Snippet], labels) -> bytes:
+    out = bytearray()
+    for i, (s, (mod_type, confidence)) in enumerate(zip(snippets, labels)):
+        code = TYPES.index(mod_type) if mod_type in TYPES else 0
+        flags = _LAST_IN_FRAME if i == len(snippets) - 1 else 0
+        out += _RESULT.pack(frame_id, s.channel_id, s.timestamp, code, flags, confidence)
+    return bytes(out)
+
+
+# ---------------------------------------------------------------------------
+# Shared-memory ring reader
+# ---------------------------------------------------------------------------
+class ShmRing:
+    def __init__(self, name: str):
+        from multiprocessing import shared_memory
+
+        if _np is None:
+            raise ImportError("--shm needs numpy")
+        name = name.lstrip("/")
+        try:
+            # Python 3.13+: do not let the resource tracker unlink Stand's ring.
+            self._shm = shared_memory.SharedMemory(name=name, create=False, track=False)
+        except TypeError:
+            self._shm = shared_memory.SharedMemory(name=name, create=False)
+            if sys.platform != "win32":
+                from multiprocessing import resource_tracker
+                resource_tracker.unregister(self._shm._name, "shared_memory")
+
+        buf = self._shm.buf
+        magic, version, self.slot_count, self.slot_bytes, self.payload_bytes = \
+            _RING_HDR.unpack_from(buf, 0)
+        if magic != _RING_MAGIC or version != _RING_VERSION:
+            raise RuntimeError(f"not a Stand frame ring (magic {magic:#x}, version {version})")
+        self.resync()
+
+    def _load(self, offset: int) -> int:
+        return _U64.unpack_from(self._shm.buf, offset)[0]
+
+    def _store(self, offset: int, value: int) -> None:
+        _U64.pack_into(self._shm.buf, offset, value)
+
+    def resync(self) -> None:
+        """Skip everything published so far; older frames are stale."""
+        self.read_seq = self._load(_OFF_WRITE_SEQ)
+        self._next = self.read_seq
+        self._store(_OFF_READ_SEQ, self.read_seq)
+
+    def dropped(self) -> int:
+        return self._load(_OFF_DROPPED)
+
+    def next_frame(self):
+        """View of the next unread frame's bytes, or None.  May run ahead of
+        release() by up to slot_count frames."""
+        if self._load(_OFF_WRITE_SEQ) <= self._next:
+            return None
+        slot = _RING_HEADER_BYTES + (self._next % self.slot_count) * self.slot_bytes
+        frame_seq, size = _SLOT_HDR.unpack_from(self._shm.buf, slot)
+        if frame_seq != self._next + 1 or size > self.payload_bytes:
+            raise RuntimeError(f"ring slot out of sequence ({frame_seq} != {self._next + 1})")
+        self._next += 1
+        start = slot + _SLOT_PAYLOAD
+        return self._shm.buf[start:start + size]
+
+    def release(self) -> None:
+        """Hand the oldest frame returned by next_frame() back to Stand."""
+        self.read_seq += 1
+        self._store(_OFF_READ_SEQ, self.read_seq)
+
+    def close(self) -> None:
+        self._shm.close()
+
+
+# ---------------------------------------------------------------------------
+# Frame sources (reader thread) → inference (connection thread)
+# ---------------------------------------------------------------------------
+def _put(frames: queue.Queue, item, stop: threading.Event) -> bool:
+    while not stop.is_set():
+        try:
+            frames.put(item, timeout=0.1)
+            return True
+        except queue.Full:
+            pass
+    return False
+
+
 def _recv_exact(conn: socket.socket, n: int) -> bytes | None:
     """Read exactly n bytes, return None on EOF."""
-    buf = b""
+    buf = bytearray()
     while len(buf) < n:
         chunk = conn.recv(n - len(buf))
         if not chunk:
             return None
         buf += chunk
-    return buf
+    return bytes(buf)
 
 
-def _handle(conn: socket.socket) -> None:
-    print("[classifier] Client connected", flush=True)
-    while True:
-        # 1. Read 4-byte length prefix
-        raw_len = _recv_exact(conn, 4)
-        if raw_len is None:
-            break
-        payload_len = struct.unpack("<I", raw_len)[0]
-
-        # 2. Read payload
-        payload = _recv_exact(conn, payload_len)
-        if payload is None:
-            break
-
-        # 3. Parse header
-        if len(payload) < _HDR.size:
-            print("[classifier] Frame too short, skipping", flush=True)
-            continue
-        timestamp, count, sample_rate = _HDR.unpack_from(payload, 0)
-
-        # 4. Parse IQ samples
-        iq_bytes = payload[_HDR.size:]
-        expected = count * 2 * 2   # count complex samples × 2 ints × 2 bytes each
-        if len(iq_bytes) < expected:
-            print(f"[classifier] IQ data too short ({len(iq_bytes)} < {expected}), skipping",
-                  flush=True)
-            continue
-        iq = list(struct.unpack_from(f"<{count * 2}h", iq_bytes))
-
-        # 5. Classify
-        mod_type, confidence = classify(iq, sample_rate)
-
-        # 6. Send result
-        result = json.dumps({
-            "type":       mod_type,
-            "confidence": confidence,
-            "timestamp":  timestamp,
-        }) + "\n"
+def _read_tcp(conn: socket.socket, frames: queue.Queue, stop: threading.Event) -> None:
+    try:
+        while not stop.is_set():
+            raw_len = _recv_exact(conn, _LEN.size)
+            if raw_len is None:
+                break
+            payload = _recv_exact(conn, _LEN.unpack(raw_len)[0])
+            if payload is None:
+                break
+            try:
+                frame_id, snippets = parse_frame(payload)
+            except ValueError as e:
+                print(f"[classifier] {e}, skipping", flush=True)
+                continue
+            if not _put(frames, (frame_id, snippets, None), stop):
+                return
+    except OSError:
+        pass
+    _put(frames, None, stop)
+
+
+def _read_shm(ring: ShmRing):
+    def read(conn: socket.socket, frames: queue.Queue, stop: threading.Event) -> None:
         try:
-            conn.sendall(result.encode())
+            while not stop.is_set():
+                payload = ring.next_frame()
+                if payload is None:
+                    # Sleep until the next poll, noticing a closed connection.
+                    readable, _, _ = select.select([conn], [], [], _POLL_SEC)
+                    if readable and not conn.recv(4096):
+                        break
+                    continue
+                frame_id, snippets = parse_frame(payload)
+                if not _put(frames, (frame_id, snippets, ring.release), stop):
+                    return
         except OSError:
-            break
+            pass   # connection reset
+        except (ValueError, RuntimeError) as e:
+            print(f"[classifier] ring: {e}", flush=True)
+        _put(frames, None, stop)
+    return read
+
 
+def _serve(conn: socket.socket, read) -> None:
+    print("[classifier] Client connected", flush=True)
+    frames: queue.Queue = queue.Queue(maxsize=_QUEUE_DEPTH)
+    stop = threading.Event()
+    reader = threading.Thread(target=read, args=(conn, frames, stop), daemon=True)
+    try:
+        conn.sendall(_HELLO)
+        reader.start()
+        while True:
+            item = frames.get()
+            if item is None:
+                break
+            frame_id, snippets, release = item
+            records = _results(frame_id, snippets, classify_batch(snippets))
+            del snippets, item   # no views into a ring slot may outlive release()
+            if release:
+                release()
+            conn.sendall(records)
+    except OSError:
+        pass
+    finally:
+        stop.set()
+        if reader.is_alive():
+            reader.join()
     print("[classifier] Client disconnected", flush=True)
 
 
@@ -116,6 +349,19 @@ def _handle(conn: socket.socket) -> None:
 # Server loop
 # ---------------------------------------------------------------------------
 def main() -> None:
+    parser = argparse.ArgumentParser(description="Stand signal classifier service")
+    parser.add_argument("--shm", metavar="NAME",
+                        help="read frames from Stand's shared-memory ring instead of TCP")
+    args = parser.parse_args()
+
+    ring = None
+    if args.shm:
+        try:
+            ring = ShmRing(args.shm)
+        except (ImportError, OSError, RuntimeError) as e:
+            print(f"[classifier] cannot open shared memory {args.shm}: {e}", flush=True)
+            sys.exit(1)
+
     print(f"[classifier] Listening on {HOST}:{PORT}", flush=True)
     with socket.socket(socket.AF_INET, socket.SOCK_STREAM) as srv:
         srv.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
@@ -129,7 +375,13 @@ def main() -> None:
         while True:
             conn, addr = srv.accept()
             with conn:
-                _handle(conn)
+                if ring:
+                    ring.resync()
+                    _serve(conn, _read_shm(ring))
+                    print(f"[classifier] {ring.dropped()} frames dropped by Stand so far",
+                          flush=True)
+                else:
+                    _serve(conn, _read_tcp)
             print("[classifier] Waiting for next connection…", flush=True)
 
 
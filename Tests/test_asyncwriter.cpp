@@ -0,0 +1,196 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "AsyncFileWriter.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+static std::string tempPath(const char* name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+static std::vector<uint8_t> readAll(const std::string& path) {
+    std::vector<uint8_t> out;
+    FILE* f = std::fopen(path.c_str(), "rb");
+    if (!f) return out;
+    uint8_t buf[4096];
+    std::size_t n;
+    while ((n = std::fread(buf, 1, sizeof(buf), f)) > 0)
+        out.insert(out.end(), buf, buf + n);
+    std::fclose(f);
+    return out;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Data crosses many buffer boundaries and arrives intact and in order
+// ─────────────────────────────────────────────────────────────────────────────
+TEST_CASE("AsyncFileWriter: blocks spanning buffers are written in order", "[writer]") {
+    const std::string path = tempPath("stand_asyncwriter_order.bin");
+
+    AsyncFileWriter::Options opt;
+    opt.bufferBytes = 64 * 1024;
+    opt.bufferCount = 3;
+    opt.overflow    = AsyncFileWriter::Overflow::Block;   // nothing may be lost
+
+    AsyncFileWriter w;
+    REQUIRE(w.open(QString::fromStdString(path), opt));
+
+    // 3001-byte blocks: never aligned to the 64 KiB buffers.
+    std::vector<uint8_t> expected;
+    std::vector<uint8_t> block(3001);
+    for (int b = 0; b < 700; ++b) {
+        for (std::size_t i = 0; i < block.size(); ++i)
+            block[i] = static_cast<uint8_t>((b * 31 + i * 7) & 0xFF);
+        REQUIRE(w.write(block.data(), block.size()));
+        expected.insert(expected.end(), block.begin(), block.end());
+    }
+    CHECK(w.position() == expected.size());
+    w.close();
+
+    const auto st = w.stats();
+    CHECK(st.bytesWritten == expected.size());
+    CHECK(st.bytesDropped == 0);
+    CHECK(readAll(path) == expected);
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("AsyncFileWriter: header patch and direct-I/O tail", "[writer]") {
+    const std::string path = tempPath("stand_asyncwriter_patch.bin");
+
+    AsyncFileWriter::Options opt;
+    opt.direct           = true;          // falls back to buffered where unsupported
+    opt.preallocateBytes = 1 << 20;
+
+    AsyncFileWriter w;
+    REQUIRE(w.open(QString::fromStdString(path), opt));
+    const char placeholder[4] = {0, 0, 0, 0};
+    w.write(placeholder, 4);
+    std::vector<uint8_t> payload(10'007, 0xA5);
+    w.write(payload.data(), payload.size());
+    const uint32_t size = static_cast<uint32_t>(payload.size());
+    w.patchOnClose(0, &size, sizeof(size));
+    w.close();
+
+    const auto data = readAll(path);
+    REQUIRE(data.size() == 4 + payload.size());   // padding truncated away
+    uint32_t header = 0;
+    std::memcpy(&header, data.data(), 4);
+    CHECK(header == size);
+    CHECK(data.back() == 0xA5);
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("AsyncFileWriter: oversized write is dropped whole", "[writer]") {
+    const std::string path = tempPath("stand_asyncwriter_drop.bin");
+
+    AsyncFileWriter::Options opt;
+    opt.bufferBytes = 4096;
+    opt.bufferCount = 2;
+
+    AsyncFileWriter w;
+    REQUIRE(w.open(QString::fromStdString(path), opt));
+    std::vector<uint8_t> small(100, 1), huge(64 * 1024, 2);
+    CHECK(w.write(small.data(), small.size()));
+    CHECK_FALSE(w.write(huge.data(), huge.size()));
+    CHECK(w.write(small.data(), small.size()));
+    w.close();
+
+    const auto st = w.stats();
+    CHECK(st.bytesDropped == huge.size());
+    CHECK(st.dropEvents == 1);
+    CHECK(readAll(path).size() == 2 * small.size());
+    std::filesystem::remove(path);
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Every buffer in flight after exact-fit writes: the next write takes the
+// overflow policy instead of a buffer that is not there
+// ─────────────────────────────────────────────────────────────────────────────
+
+// Holds the disk's I/O thread (a task queued ahead of the buffers) until released.
+struct StalledDisk {
+    explicit StalledDisk(const std::string& path) {
+        AsyncFileWriter::post(QString::fromStdString(path), [flag = released] {
+            while (!flag->load()) std::this_thread::yield();
+        });
+    }
+    ~StalledDisk() { release(); }
+    void release() { released->store(true); }
+    std::shared_ptr<std::atomic<bool>> released = std::make_shared<std::atomic<bool>>(false);
+};
+
+TEST_CASE("AsyncFileWriter: exact-fit writes on a stalled disk drop the overflow", "[writer]") {
+    const std::string path = tempPath("stand_asyncwriter_stall_drop.bin");
+
+    AsyncFileWriter::Options opt;
+    opt.bufferBytes = 4096;
+    opt.bufferCount = 4;
+
+    AsyncFileWriter w;
+    REQUIRE(w.open(QString::fromStdString(path), opt));
+    std::vector<uint8_t> block(4096, 7);
+    {
+        StalledDisk disk(path);
+        for (int i = 0; i < 4; ++i)
+            CHECK(w.write(block.data(), block.size()));   // each fills, submits a buffer
+        CHECK_FALSE(w.write(block.data(), block.size()));   // none left
+        CHECK(w.stats().dropEvents == 1);
+    }
+    // Buffers come back once the disk moves.
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (w.stats().bytesWritten < 4 * block.size() && std::chrono::steady_clock::now() < deadline)
+        std::this_thread::yield();
+    CHECK(w.write(block.data(), block.size()));
+    w.close();
+
+    const auto st = w.stats();
+    CHECK(st.bytesDropped == block.size());
+    CHECK(st.bytesWritten == 5 * block.size());
+    CHECK(readAll(path).size() == 5 * block.size());
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("AsyncFileWriter: exact-fit writes on a stalled disk block the producer", "[writer]") {
+    const std::string path = tempPath("stand_asyncwriter_stall_block.bin");
+
+    AsyncFileWriter::Options opt;
+    opt.bufferBytes = 4096;
+    opt.bufferCount = 4;
+    opt.overflow    = AsyncFileWriter::Overflow::Block;
+
+    AsyncFileWriter w;
+    REQUIRE(w.open(QString::fromStdString(path), opt));
+    std::vector<uint8_t> block(4096, 9);
+    std::atomic<bool> done{false};
+    {
+        StalledDisk disk(path);
+        for (int i = 0; i < 4; ++i)
+            CHECK(w.write(block.data(), block.size()));
+        std::thread producer([&] {
+            w.write(block.data(), block.size());
+            done.store(true);
+        });
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (w.stats().stalls == 0 && std::chrono::steady_clock::now() < deadline)
+            std::this_thread::yield();
+        CHECK(w.stats().stalls == 1);
+        CHECK_FALSE(done.load());
+        disk.release();
+        producer.join();
+    }
+    CHECK(done.load());
+    w.close();
+
+    const auto st = w.stats();
+    CHECK(st.bytesDropped == 0);
+    CHECK(readAll(path) == std::vector<uint8_t>(5 * block.size(), 9));
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,313 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+
+#include "ClassifierHandler.h"
+#include "ClassifierProtocol.h"
+#include "DspUtils.h"
+#include "ModulationFeatures.h"
+
+#include <QCoreApplication>
+#include <QNativeIpcKey>
+#include <QSharedMemory>
+
+#include <cmath>
+#include <complex>
+#include <cstring>
+#include <vector>
+
+using namespace ClassifierProtocol;
+using Catch::Matchers::WithinAbs;
+
+namespace {
+
+// Attaches to the handler's ring like the Python service and returns the
+// payload of frame `seq` (0-based).
+class RingPeek {
+public:
+    explicit RingPeek(const QString& name)
+#ifdef _WIN32
+        : shm_(QNativeIpcKey(name, QNativeIpcKey::Type::Windows))
+#else
+        : shm_(QNativeIpcKey(QLatin1Char('/') + name, QNativeIpcKey::Type::PosixRealtime))
+#endif
+    {
+        REQUIRE(shm_.attach());
+        base_ = static_cast<const unsigned char*>(shm_.data());
+    }
+
+    uint64_t written() const { return get<uint64_t>(24); }
+
+    FrameReader frame(uint64_t seq) const {
+        const std::size_t slot = ShmIqRing::kHeaderBytes + (seq % get<uint32_t>(8)) * get<uint32_t>(12);
+        return FrameReader(base_ + slot + ShmIqRing::kSlotHeader, get<uint32_t>(slot + 8));
+    }
+
+private:
+    template <typename T> T get(std::size_t offset) const {
+        T v; std::memcpy(&v, base_ + offset, sizeof v); return v;
+    }
+
+    QSharedMemory        shm_;
+    const unsigned char* base_{nullptr};
+};
+
+QString ringName(const char* tag) {
+    return QStringLiteral("stand_test_cls_%1_%2").arg(QCoreApplication::applicationPid()).arg(tag);
+}
+
+std::vector<float> tone(double freqHz, double sampleRate, int count, double amplitude) {
+    std::vector<float> iq(2 * static_cast<std::size_t>(count));
+    for (int n = 0; n < count; ++n) {
+        const double ph = 2.0 * dsp::kPi * freqHz * n / sampleRate;
+        iq[2 * n]     = static_cast<float>(amplitude * std::cos(ph));
+        iq[2 * n + 1] = static_cast<float>(amplitude * std::sin(ph));
+    }
+    return iq;
+}
+
+double meanPower(const Snippet& s) {
+    double p = 0.0;
+    for (int k = 0; k < s.count; ++k)
+        p += s.iq[2 * k] * s.iq[2 * k] + s.iq[2 * k + 1] * s.iq[2 * k + 1];
+    return s.count > 0 ? p / s.count : 0.0;
+}
+
+}  // namespace
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Wire format
+// ─────────────────────────────────────────────────────────────────────────────
+TEST_CASE("ClassifierProtocol: frames round-trip through writer and reader", "[classifier]") {
+    std::vector<unsigned char> buf(kFrameHeader + snippetBytes(4) + snippetBytes(2));
+    FrameWriter w(buf.data(), buf.size(), 17, 123456789ULL);
+
+    float* a = w.addSnippet({3, 101.5e6, 62'500.0, 25'000.0, 1000}, 4);
+    REQUIRE(a != nullptr);
+    for (int i = 0; i < 8; ++i) a[i] = 0.125f * i;
+    float* b = w.addSnippet({9, 99.0e6, 31'250.0, 12'500.0, 1001}, 2);
+    REQUIRE(b != nullptr);
+    for (int i = 0; i < 4; ++i) b[i] = -1.0f;
+    CHECK(w.addSnippet({10, 0, 0, 0, 0}, 1) == nullptr);   // full
+    CHECK(w.finish() == buf.size());
+
+    FrameReader r(buf.data(), buf.size());
+    REQUIRE(r.valid());
+    CHECK(r.frameId() == 17);
+    CHECK(r.timestamp() == 123456789ULL);
+    REQUIRE(r.snippetCount() == 2);
+
+    Snippet s;
+    REQUIRE(r.next(s));
+    CHECK(s.info.channelId == 3);
+    CHECK(s.info.centreHz == 101.5e6);
+    CHECK(s.info.sampleRateHz == 62'500.0);
+    CHECK(s.info.bandwidthHz == 25'000.0);
+    CHECK(s.info.timestamp == 1000);
+    REQUIRE(s.count == 4);
+    CHECK(s.iq[7] == 0.875f);
+    REQUIRE(r.next(s));
+    CHECK(s.info.channelId == 9);
+    CHECK(s.count == 2);
+    CHECK(s.iq[3] == -1.0f);
+    CHECK_FALSE(r.next(s));
+
+    CHECK_FALSE(FrameReader(buf.data(), buf.size() - 1).valid());   // truncated
+
+    std::vector<unsigned char> fbuf(kFrameHeader + featureSnippetBytes(3));
+    FrameWriter fw(fbuf.data(), fbuf.size(), 18, 0, Kind::Features);
+    const float feat[3] = {1.0f, -2.0f, 0.5f};
+    CHECK(fw.addSnippet({1, 0, 0, 0, 0}, 1) == nullptr);   // no I/Q in a feature frame
+    REQUIRE(fw.addFeatures({4, 0, 0, 0, 0}, feat, 3));
+    CHECK(fw.finish() == fbuf.size());
+    FrameReader fr(fbuf.data(), fbuf.size());
+    REQUIRE(fr.valid());
+    CHECK(fr.kind() == Kind::Features);
+    Snippet fs;
+    REQUIRE(fr.next(fs));
+    CHECK(fs.info.channelId == 4);
+    CHECK(fs.iq == nullptr);
+    REQUIRE(fs.count == 3);
+    CHECK(fs.features[1] == -2.0f);
+
+    buf[0] ^= 0xFF;
+    CHECK_FALSE(FrameReader(buf.data(), buf.size()).valid());       // foreign magic
+}
+
+TEST_CASE("ClassifierProtocol: hello and fixed-size results", "[classifier]") {
+    char hello[kHelloBytes];
+    writeHello(hello);
+    CHECK(parseHello(hello));
+
+    QString error;
+    const uint32_t v1 = 1;
+    std::memcpy(hello + 4, &v1, sizeof v1);
+    CHECK_FALSE(parseHello(hello, &error));
+    CHECK(error.contains(QStringLiteral("protocol 1")));
+
+    Result in;
+    in.frameId    = 42;
+    in.channelId  = 7;
+    in.timestamp  = 0x0102030405060708ULL;
+    in.type       = typeFromName(QStringLiteral("usb"));
+    in.flags      = kLastInFrame;
+    in.confidence = 0.75f;
+    char rec[kResultBytes];
+    writeResult(rec, in);
+
+    const Result out = parseResult(rec);
+    CHECK(out.frameId == 42);
+    CHECK(out.channelId == 7);
+    CHECK(out.timestamp == in.timestamp);
+    CHECK(out.type == Type::USB);
+    CHECK(typeName(out.type) == QStringLiteral("USB"));
+    CHECK(out.lastInFrame());
+    CHECK(out.confidence == 0.75f);
+    CHECK(typeFromName(QStringLiteral("QPSK")) == Type::Unknown);
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// ClassifierHandler
+// ─────────────────────────────────────────────────────────────────────────────
+TEST_CASE("ClassifierHandler: without channels the frame carries the wideband block", "[classifier]") {
+    ClassifierHandler h;
+    REQUIRE(h.openSharedRing(ringName("wide")));
+    RingPeek peek(h.sharedRingName());
+    h.setIntervalMs(0);
+    h.setCenterFrequency(102e6);
+
+    const auto iq = tone(50'000.0, 2e6, 300, 0.5);
+    BlockMeta meta;
+    meta.timestamp = 4096;
+    h.processBlock(iq.data(), 300, 2e6, meta);
+
+    REQUIRE(peek.written() == 1);
+    FrameReader r = peek.frame(0);
+    REQUIRE(r.valid());
+    CHECK(r.timestamp() == 4096);
+    REQUIRE(r.snippetCount() == 1);
+    Snippet s;
+    REQUIRE(r.next(s));
+    CHECK(s.info.channelId == 0);
+    CHECK(s.info.centreHz == 102e6);
+    CHECK(s.info.sampleRateHz == 2e6);
+    REQUIRE(s.count == 300);
+    CHECK(std::memcmp(s.iq, iq.data(), iq.size() * sizeof(float)) == 0);
+}
+
+TEST_CASE("ClassifierHandler: channels become decimated snippets at their offsets", "[classifier]") {
+    ClassifierHandler h;
+    REQUIRE(h.openSharedRing(ringName("chans")));
+    RingPeek peek(h.sharedRingName());
+    h.setIntervalMs(0);
+    h.setCenterFrequency(100e6);
+    h.setChannels({{7, 200'000.0, 25'000.0}, {9, -300'000.0, 25'000.0}});
+
+    constexpr double kRate = 2e6;
+    constexpr int    kCount = 16384;
+    const auto iq = tone(200'000.0 + 1'000.0, kRate, kCount, 0.5);
+    h.processBlock(iq.data(), kCount, kRate);
+
+    REQUIRE(peek.written() == 1);
+    FrameReader r = peek.frame(0);
+    REQUIRE(r.snippetCount() == 2);
+
+    Snippet on, off;
+    REQUIRE(r.next(on));
+    REQUIRE(r.next(off));
+    CHECK(on.info.channelId == 7);
+    CHECK(on.info.centreHz == 100.2e6);
+    CHECK(on.info.bandwidthHz == 25'000.0);
+    const int decim = static_cast<int>(kRate / (ClassifierHandler::kOversample * 25'000.0));
+    CHECK(on.info.sampleRateHz == kRate / decim);
+    CHECK(on.count > 100);
+    CHECK(on.count <= ClassifierHandler::kSnippetSamples);
+    CHECK(off.info.channelId == 9);
+
+    // The tone lands 1 kHz above DC in its own channel and is filtered out of
+    // the other one.
+    CHECK_THAT(meanPower(on), WithinAbs(0.25, 0.01));
+    CHECK(meanPower(off) < 1e-6);
+    const std::complex<float> z0(on.iq[20], on.iq[21]), z1(on.iq[22], on.iq[23]);
+    const double stepHz = std::arg(z1 * std::conj(z0)) / (2.0 * dsp::kPi) * on.info.sampleRateHz;
+    CHECK_THAT(stepHz, WithinAbs(1'000.0, 1.0));
+}
+
+TEST_CASE("ClassifierHandler: the in-flight window drops blocks until results arrive", "[classifier]") {
+    ClassifierHandler h;
+    REQUIRE(h.openSharedRing(ringName("window")));
+    RingPeek peek(h.sharedRingName());
+    h.setIntervalMs(0);
+    h.setMaxInFlight(2);
+
+    const std::vector<float> iq(2 * 64, 0.1f);
+    for (int i = 0; i < 3; ++i) h.processBlock(iq.data(), 64, 1e6);
+    CHECK(h.sentFrames() == 2);
+    CHECK(h.droppedFrames() == 1);
+    CHECK(h.inFlight() == 2);
+    CHECK(peek.written() == 2);
+
+    h.frameDone();
+    h.processBlock(iq.data(), 64, 1e6);
+    CHECK(h.sentFrames() == 3);
+    CHECK(peek.frame(2).frameId() > peek.frame(1).frameId());
+
+    h.resetInFlight();
+    CHECK(h.inFlight() == 0);
+    h.frameDone();                       // late result after a reset
+    CHECK(h.inFlight() == 0);
+}
+
+TEST_CASE("ClassifierHandler: feature mode sends one vector per channel", "[classifier]") {
+    ClassifierHandler h;
+    REQUIRE(h.openSharedRing(ringName("features")));
+    RingPeek peek(h.sharedRingName());
+    h.setIntervalMs(0);
+    h.setMode(ClassifierHandler::Mode::Features);
+    h.setChannels({{7, 200'000.0, 25'000.0}, {9, -300'000.0, 25'000.0}});
+
+    constexpr double kRate = 2e6;
+    const auto iq = tone(200'000.0 + 1'000.0, kRate, 16384, 0.5);
+    h.processBlock(iq.data(), 16384, kRate);
+
+    REQUIRE(peek.written() == 1);
+    FrameReader r = peek.frame(0);
+    REQUIRE(r.valid());
+    CHECK(r.kind() == Kind::Features);
+    REQUIRE(r.snippetCount() == 2);
+
+    Snippet on, off;
+    REQUIRE(r.next(on));
+    REQUIRE(r.next(off));
+    CHECK(on.iq == nullptr);
+    REQUIRE(on.features != nullptr);
+    CHECK(on.count == ModulationFeatures::kCount);
+    CHECK(on.info.channelId == 7);
+    CHECK_THAT(on.features[ModulationFeatures::kPowerDb], WithinAbs(10.0 * std::log10(0.25), 0.2));
+    CHECK(on.features[ModulationFeatures::kPeakShare] > 0.9f);
+    CHECK(off.info.channelId == 9);
+    CHECK(off.features[ModulationFeatures::kPowerDb] < -50.0f);
+}
+
+TEST_CASE("ClassifierHandler: local mode classifies without a service or window", "[classifier]") {
+    ClassifierHandler h;
+    h.setIntervalMs(0);
+    h.setMaxInFlight(1);
+    h.setMode(ClassifierHandler::Mode::Local);
+    h.setChannels({{7, 200'000.0, 25'000.0}});
+
+    QVector<Result> results;
+    QObject::connect(&h, &ClassifierHandler::localResults,
+                     [&results](const QVector<Result>& r) { results += r; });
+
+    const auto iq = tone(200'000.0 + 1'000.0, 2e6, 16384, 0.5);
+    for (int i = 0; i < 3; ++i) h.processBlock(iq.data(), 16384, 2e6);
+
+    CHECK(h.sentFrames() == 3);
+    CHECK(h.droppedFrames() == 0);
+    CHECK(h.inFlight() == 0);
+    REQUIRE(results.size() == 3);
+    CHECK(results[0].channelId == 7);
+    CHECK(results[0].type == Type::CW);
+    CHECK(results[0].lastInFrame());
+    CHECK(results[2].frameId > results[0].frameId);
+}
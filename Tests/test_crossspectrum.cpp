@@ -0,0 +1,136 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+
+#include "CrossSpectrum.h"
+
+#include <cmath>
+#include <complex>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using Catch::Matchers::WithinAbs;
+
+namespace {
+
+constexpr double kFs     = 2e6;
+constexpr double kCentre = 433e6;
+
+struct Tone {
+    double offsetHz;
+    double amplitude;
+    double phaseDeg;   // ch0 leads ch1 by this much
+};
+
+// Two channels: the tones (ch1 rotated by −phaseDeg) plus independent noise.
+void makePair(const std::vector<Tone>& tones, int count, double noise,
+              std::vector<float>& ch0, std::vector<float>& ch1) {
+    std::mt19937 rng(5);
+    std::normal_distribution<double> n(0.0, noise / std::sqrt(2.0));
+    ch0.assign(2 * static_cast<std::size_t>(count), 0.0f);
+    ch1.assign(2 * static_cast<std::size_t>(count), 0.0f);
+    for (int i = 0; i < count; ++i) {
+        std::complex<double> a(n(rng), n(rng)), b(n(rng), n(rng));
+        for (const Tone& t : tones) {
+            const double p = 2.0 * M_PI * t.offsetHz * i / kFs;
+            a += std::polar(t.amplitude, p);
+            b += std::polar(t.amplitude, p - t.phaseDeg * M_PI / 180.0);
+        }
+        ch0[2 * i] = static_cast<float>(a.real());  ch0[2 * i + 1] = static_cast<float>(a.imag());
+        ch1[2 * i] = static_cast<float>(b.real());  ch1[2 * i + 1] = static_cast<float>(b.imag());
+    }
+}
+
+int binOf(const CrossSpectrumFrame& f, double offsetHz) {
+    return static_cast<int>(std::lround(offsetHz / f.sampleRateHz * f.powerDb.size())) + f.powerDb.size() / 2;
+}
+
+}  // namespace
+
+TEST_CASE("CrossSpectrum: per-bin phase and coherence of two stations", "[crossspectrum]") {
+    CrossSpectrum xs;   // 1024 bins, 16 segments
+    std::vector<float> ch0, ch1;
+    makePair({{250e3, 0.3, 30.0}, {-406.25e3, 0.1, -120.0}}, xs.pairsNeeded(), 0.01, ch0, ch1);
+
+    const CrossSpectrumFrame f = xs.compute(ch0.data(), ch1.data(), xs.pairsNeeded(), kCentre, kFs);
+    REQUIRE(f.powerDb.size() == 1024);
+    const int a = binOf(f, 250e3), b = binOf(f, -406.25e3);
+    CHECK_THAT(f.phaseDeg[a], WithinAbs(30.0, 0.5));
+    CHECK_THAT(f.phaseDeg[b], WithinAbs(-120.0, 0.5));
+    CHECK(f.coherence[a] > 0.99f);
+    CHECK(f.coherence[b] > 0.99f);
+    CHECK_THAT(f.powerDb[a], WithinAbs(20.0 * std::log10(0.3), 0.5));
+    CHECK_THAT(f.freqHz(a), WithinAbs(kCentre + 250e3, 1.0));
+
+    // Noise-only bins: uncorrelated between channels.
+    double noiseCoherence = 0.0;
+    for (int i = 100; i < 200; ++i) noiseCoherence += f.coherence[i];
+    CHECK(noiseCoherence / 100.0 < 0.2);
+
+    REQUIRE(f.readings.size() == 2);
+    CHECK_THAT(f.readings[0].freqHz, WithinAbs(kCentre - 406.25e3, f.sampleRateHz / 1024));
+    CHECK_THAT(f.readings[0].phaseDeg, WithinAbs(-120.0, 0.5));
+    CHECK_THAT(f.readings[1].freqHz, WithinAbs(kCentre + 250e3, f.sampleRateHz / 1024));
+    CHECK_THAT(f.readings[1].phaseDeg, WithinAbs(30.0, 0.5));
+    CHECK(f.readings[1].coherence > 0.99f);
+    CHECK_FALSE(f.readings[1].angleValid);   // no antenna spacing
+}
+
+TEST_CASE("CrossSpectrum: calibration and angle of arrival", "[crossspectrum]") {
+    CrossSpectrum::Options o;
+    o.fftSize = 256;
+    o.segments = 8;
+    // Half a wavelength at the centre: phase = −180° · sin θ.
+    o.antennaSpacingM = 299'792'458.0 / kCentre / 2.0;
+    CrossSpectrum xs(o);
+
+    // A source 30° towards RX1 reaches it first: ch0 lags by 90°. Cables add
+    // another 20°, removed by the calibration.
+    std::vector<float> ch0, ch1;
+    makePair({{0.0, 0.5, -90.0 + 20.0}}, xs.pairsNeeded(), 0.01, ch0, ch1);
+    const CrossSpectrumFrame f = xs.compute(ch0.data(), ch1.data(), xs.pairsNeeded(), kCentre, kFs, 20.0);
+
+    REQUIRE(f.readings.size() == 1);
+    const DfReading& r = f.readings[0];
+    CHECK_THAT(r.phaseDeg, WithinAbs(-90.0, 0.5));
+    REQUIRE(r.angleValid);
+    CHECK_THAT(r.angleDeg, WithinAbs(30.0, 0.5));
+}
+
+TEST_CASE("CrossSpectrum: incoherent channels give no angle", "[crossspectrum]") {
+    CrossSpectrum::Options o;
+    o.antennaSpacingM = 0.3;
+    CrossSpectrum xs(o);
+    std::vector<float> ch0, ch1, unused;
+    makePair({{100e3, 0.3, 0.0}}, xs.pairsNeeded(), 0.01, ch0, unused);
+    // ch1: the same frequency, but a random phase walk — no fixed relation.
+    std::mt19937 rng(9);
+    std::normal_distribution<double> step(0.0, 0.3);
+    ch1.resize(ch0.size());
+    double phase = 0.0;
+    for (int i = 0; i < xs.pairsNeeded(); ++i) {
+        phase += step(rng);
+        const auto s = std::polar(0.3, 2.0 * M_PI * 100e3 * i / kFs + phase);
+        ch1[2 * i] = static_cast<float>(s.real());
+        ch1[2 * i + 1] = static_cast<float>(s.imag());
+    }
+    const CrossSpectrumFrame f = xs.compute(ch0.data(), ch1.data(), xs.pairsNeeded(), kCentre, kFs);
+    REQUIRE_FALSE(f.readings.isEmpty());
+    for (const DfReading& r : f.readings) {
+        CHECK(r.coherence < 0.5f);
+        CHECK_FALSE(r.angleValid);
+    }
+}
+
+TEST_CASE("CrossSpectrum: short input and bad options", "[crossspectrum]") {
+    CrossSpectrum xs;
+    std::vector<float> iq(2 * 100, 0.1f);
+    CHECK(xs.compute(iq.data(), iq.data(), 100, kCentre, kFs).powerDb.isEmpty());
+
+    CrossSpectrum::Options o;
+    o.fftSize = 1000;
+    CHECK_THROWS_AS(CrossSpectrum(o), std::invalid_argument);
+    o.fftSize = 1024;
+    o.segments = 1;
+    CHECK_THROWS_AS(CrossSpectrum(o), std::invalid_argument);
+}
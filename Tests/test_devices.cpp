@@ -0,0 +1,185 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+
+#include "../Hardware/FileReplayDevice.h"
+#include "../Hardware/SimulatedDevice.h"
+#include "StreamStatsHandler.h"
+
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <numbers>
+#include <string>
+#include <vector>
+
+using Catch::Matchers::WithinAbs;
+
+static std::string tempPath(const char* name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+// |correlation| of int16 I/Q with a unit tone at freqHz, in full-scale units.
+static double toneAmplitude(const std::vector<int16_t>& iq, double freqHz, double srHz) {
+    std::complex<double> acc{};
+    const std::size_t n = iq.size() / 2;
+    for (std::size_t i = 0; i < n; ++i) {
+        const std::complex<double> x(iq[2 * i] / 32768.0, iq[2 * i + 1] / 32768.0);
+        acc += x * std::polar(1.0, -2.0 * std::numbers::pi * freqHz * static_cast<double>(i) / srHz);
+    }
+    return std::abs(acc) / static_cast<double>(n);
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// SimulatedDevice
+// ─────────────────────────────────────────────────────────────────────────────
+TEST_CASE("SimulatedDevice: carrier level, retune and gain", "[devices]") {
+    SimulatedDevice::Config cfg;
+    cfg.carriers  = {{100.1e6, -20.0, 0.0, 1000.0}};
+    cfg.noiseDbfs = -90.0;
+    cfg.realtime  = false;
+    SimulatedDevice dev(cfg);
+    dev.init();
+    dev.setSampleRate(1e6);
+    dev.setFrequency(100e6);
+    dev.startStream();
+
+    std::vector<int16_t> buf(2 * 8192);
+    REQUIRE(dev.readBlock(buf.data(), 8192, 100) == 8192);
+    CHECK(dev.lastReadTimestamp({}) == 0);
+    CHECK_THAT(toneAmplitude(buf, 100e3, 1e6), WithinAbs(0.1, 0.002));   // −20 dBFS
+
+    REQUIRE(dev.readBlock(buf.data(), 8192, 100) == 8192);
+    CHECK(dev.lastReadTimestamp({}) == 8192);
+
+    dev.setGain(dev.gain() + 6.0206);   // ×2 amplitude
+    REQUIRE(dev.readBlock(buf.data(), 8192, 100) == 8192);
+    CHECK_THAT(toneAmplitude(buf, 100e3, 1e6), WithinAbs(0.2, 0.004));
+
+    dev.stopStream();
+    dev.setFrequency(100.05e6);   // carrier now at +50 kHz
+    dev.startStream();
+    REQUIRE(dev.readBlock(buf.data(), 8192, 100) == 8192);
+    CHECK_THAT(toneAmplitude(buf, 50e3, 1e6), WithinAbs(0.2, 0.004));
+    CHECK(toneAmplitude(buf, 100e3, 1e6) < 0.01);
+}
+
+TEST_CASE("SimulatedDevice: free-running channels stay within one block", "[devices]") {
+    SimulatedDevice::Config cfg;
+    cfg.channels = 2;
+    cfg.realtime = false;
+    SimulatedDevice dev(cfg);
+    dev.init();
+    const ChannelDescriptor rx0{ChannelDescriptor::RX, 0}, rx1{ChannelDescriptor::RX, 1};
+    dev.startStream(rx0);
+    dev.startStream(rx1);
+
+    std::vector<int16_t> buf(2 * 4096);
+    REQUIRE(dev.readBlock(rx0, buf.data(), 4096, 10) == 4096);
+    CHECK(dev.readBlock(rx0, buf.data(), 4096, 10) == 0);      // RX1 has not asked for block 1
+    REQUIRE(dev.readBlock(rx1, buf.data(), 4096, 10) == 4096);
+    REQUIRE(dev.readBlock(rx1, buf.data(), 4096, 10) == 4096); // RX0 is waiting for block 1
+    REQUIRE(dev.readBlock(rx0, buf.data(), 4096, 10) == 4096);
+    CHECK(dev.lastReadTimestamp(rx0) == 4096);
+    CHECK(dev.lastReadTimestamp(rx1) == 4096);
+
+    dev.stopStream(rx1);                                         // a stopped channel never holds others
+    REQUIRE(dev.readBlock(rx0, buf.data(), 4096, 10) == 4096);
+    REQUIRE(dev.readBlock(rx0, buf.data(), 4096, 10) == 4096);
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// FileReplayDevice
+// ─────────────────────────────────────────────────────────────────────────────
+TEST_CASE("FileReplayDevice: ci16 replays bit-exactly, then stops or loops", "[devices]") {
+    const std::string path = tempPath("stand_replay_test.ci16");
+    std::vector<int16_t> ref(2 * 1000);
+    for (std::size_t i = 0; i < ref.size(); ++i)
+        ref[i] = static_cast<int16_t>((static_cast<int>(i) * 7919) % 65536 - 32768);
+    {
+        std::ofstream f(path, std::ios::binary);
+        f.write(reinterpret_cast<const char*>(ref.data()),
+                static_cast<std::streamsize>(ref.size() * sizeof(int16_t)));
+    }
+
+    FileReplayDevice::Config cfg;
+    cfg.path         = QString::fromStdString(path);
+    cfg.sampleRateHz = 1e6;
+    cfg.realtime     = false;
+
+    SECTION("single pass") {
+        FileReplayDevice dev(cfg);
+        dev.init();
+        REQUIRE(dev.totalPairs() == 1000);
+        dev.startStream();
+
+        std::vector<int16_t> got;
+        std::vector<int16_t> buf(2 * 300);
+        int n = 0;
+        while ((n = dev.readBlock(buf.data(), 300, 0)) > 0)
+            got.insert(got.end(), buf.begin(), buf.begin() + 2 * n);
+        CHECK(got == ref);
+        CHECK(dev.position() == 1000);
+        CHECK(dev.lastReadTimestamp({}) == 900);
+    }
+
+    SECTION("loop") {
+        cfg.loop = true;
+        FileReplayDevice dev(cfg);
+        dev.init();
+        dev.startStream();
+
+        std::vector<int16_t> buf(2 * 700);
+        int total = 0;
+        for (int k = 0; k < 4; ++k) {
+            const int n = dev.readBlock(buf.data(), 700, 0);
+            REQUIRE(n > 0);
+            for (int i = 0; i < 2 * n; ++i)
+                REQUIRE(buf[static_cast<std::size_t>(i)]
+                        == ref[static_cast<std::size_t>((2 * total + i) % 2000)]);
+            total += n;
+        }
+        CHECK(dev.position() == static_cast<uint64_t>(total));
+    }
+
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("FileReplayDevice: missing file or unknown rate throws", "[devices]") {
+    FileReplayDevice::Config cfg;
+    cfg.path = QString::fromStdString(tempPath("stand_replay_missing.ci16"));
+    FileReplayDevice missing(cfg);
+    CHECK_THROWS(missing.init());
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// StreamStatsHandler
+// ─────────────────────────────────────────────────────────────────────────────
+TEST_CASE("StreamStatsHandler: counts gaps, lost pairs and clipping", "[devices]") {
+    StreamStatsHandler stats;
+    stats.onStreamStarted(2e6);
+
+    std::vector<float> iq(2 * 100, 0.1f);
+    BlockMeta meta;
+
+    meta.timestamp = 1000;                       // first block: reference only
+    stats.processBlock(iq.data(), 100, 2e6, meta);
+    meta.timestamp = 1100;                       // contiguous
+    stats.processBlock(iq.data(), 100, 2e6, meta);
+    meta.timestamp = 1500;                       // 300 pairs dropped
+    iq[10] = -1.0f;                              // one clipped pair
+    stats.processBlock(iq.data(), 100, 2e6, meta);
+    stats.processBlock(iq.data(), 100, 2e6);     // no timestamp: not checked
+
+    auto s = stats.snapshot();
+    CHECK(s.blocks == 4);
+    CHECK(s.pairs == 400);
+    CHECK(s.gaps == 1);
+    CHECK(s.lostPairs == 300);
+    CHECK(s.clippedPairs == 2);
+    CHECK(s.sampleRateHz == 2e6);
+
+    stats.onStreamStarted(1e6);
+    CHECK(stats.snapshot().blocks == 0);
+}
@@ -5,6 +5,8 @@
 
 #include <cmath>
 #include <algorithm>
+#include <complex>
+#include <vector>
 
 static constexpr double kPi = 3.14159265358979323846;
 
@@ -141,3 +143,39 @@ TEST_CASE("FftProcessor: signal bin is at least 20 dB above noise floor", "[fft]
     INFO("Peak: " << peakDb << " dB  Noise floor: " << noiseFloorDb << " dB  SNR: " << snrDb << " dB");
     CHECK(snrDb >= 20.0);
 }
+
+// ─────────────────────────────────────────────────────────────────────────────
+// T8e — powerSpectrum: linear, shifted, full-scale sine reads 1.0
+// ─────────────────────────────────────────────────────────────────────────────
+TEST_CASE("FftProcessor: powerSpectrum is linear and DC-centred", "[fft]") {
+    constexpr int    kN  = 256;
+    constexpr double kSR = 256'000.0;
+
+    // 16 kHz = exactly bin 16 above DC.
+    const auto iq = makeComplexTone(kN, kSR, 16'000.0, 1.0);
+    std::vector<float> power(kN);
+    FftProcessor::powerSpectrum(iq.constData(), kN, power.data());
+
+    const int peak = static_cast<int>(std::max_element(power.begin(), power.end()) - power.begin());
+    CHECK(peak == kN / 2 + 16);
+    CHECK_THAT(power[peak], Catch::Matchers::WithinAbs(1.0, 0.02));
+    CHECK(power[kN / 2] < 1e-6f);
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// T8f — transformBatch: every transform of the batch is independent
+// ─────────────────────────────────────────────────────────────────────────────
+TEST_CASE("FftProcessor: transformBatch runs each transform of the batch", "[fft]") {
+    constexpr int kN = 16, kBatch = 3;
+    std::vector<std::complex<float>> in(kN * kBatch), out(kN * kBatch);
+    // Transform b: complex exponential at bin b + 1.
+    for (int b = 0; b < kBatch; ++b)
+        for (int i = 0; i < kN; ++i)
+            in[b * kN + i] = std::polar(1.0f, static_cast<float>(2.0 * kPi * (b + 1) * i / kN));
+
+    FftProcessor::transformBatch(in.data(), out.data(), kN, kBatch);
+    for (int b = 0; b < kBatch; ++b)
+        for (int k = 0; k < kN; ++k)
+            CHECK_THAT(std::abs(out[b * kN + k]),
+                       Catch::Matchers::WithinAbs(k == b + 1 ? kN : 0.0, 1e-3));
+}
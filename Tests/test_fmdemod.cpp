@@ -223,3 +223,45 @@ TEST_CASE("Out-of-band tone is attenuated by FIR1", "[fir][decimation]") {
     CHECK(dem_in.ifRms() > dem_out.ifRms() * 1.1);
 }
 
+
+// ─────────────────────────────────────────────────────────────────────────────
+// T8 — Squelch: idle channel produces no audio, signal reopens the gate
+// ─────────────────────────────────────────────────────────────────────────────
+TEST_CASE("Squelch gates audio on an idle channel and reopens on signal", "[fm][squelch]") {
+    constexpr double kSR = 4'000'000.0;
+    constexpr int    kN  = 8 * 16384;
+
+    FmDemodulator dem(kSR, 0.0, 75e-6, 100'000.0);
+    dem.setSquelch(-40.0);
+
+    // Idle: faint noise-like input well below threshold.
+    QVector<float> idle(kN * 2);
+    uint32_t lcg = 12345;
+    for (float& v : idle) {
+        lcg = lcg * 1664525u + 1013904223u;
+        v = (static_cast<float>(lcg >> 8) / 16777216.0f - 0.5f) * 1e-3f;
+    }
+    const auto idleAudio = runDemod(dem, idle);
+    INFO("channel power (idle): " << dem.channelPowerDb() << " dBFS");
+    CHECK_FALSE(dem.squelchOpen());
+    CHECK(idleAudio.isEmpty());
+
+    // Strong FM carrier → gate opens, audio flows.
+    const auto sig   = makeFmSignal(kSR, kN, 1'000.0, 50'000.0);
+    const auto audio = runDemod(dem, sig);
+    INFO("channel power (signal): " << dem.channelPowerDb() << " dBFS");
+    CHECK(dem.squelchOpen());
+    CHECK(audio.size() > kN / (dem.decimation1() * 10) / 2);
+
+    // Signal gone → gate holds for the hang time (0.3 s), then closes.
+    runDemod(dem, idle);
+    CHECK(dem.squelchOpen());
+    for (int i = 0; i < 12 && dem.squelchOpen(); ++i)   // 12 × 32 ms
+        runDemod(dem, idle);
+    CHECK_FALSE(dem.squelchOpen());
+    CHECK(runDemod(dem, idle).isEmpty());
+
+    // Disabling squelch always passes audio, even for idle input.
+    dem.setSquelch(BaseDemodulator::kSquelchOff);
+    CHECK_FALSE(runDemod(dem, idle).isEmpty());
+}
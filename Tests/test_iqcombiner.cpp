@@ -5,7 +5,13 @@
 #include "Pipeline.h"
 #include "IPipelineHandler.h"
 
+#include <atomic>
+#include <chrono>
 #include <cmath>
+#include <complex>
+#include <random>
+#include <stdexcept>
+#include <thread>
 #include <vector>
 
 using Catch::Matchers::WithinAbs;
@@ -15,17 +21,41 @@ using Catch::Matchers::WithinAbs;
 // ---------------------------------------------------------------------------
 class TestSink : public IPipelineHandler {
 public:
+    void processBlock(const float* iq, int count, double sampleRateHz,
+                      const BlockMeta& meta) override {
+        timestamps.push_back(meta.timestamp);
+        counts.push_back(count);
+        processBlock(iq, count, sampleRateHz);
+    }
     void processBlock(const float* iq, int count, double sampleRateHz) override {
         lastSr = sampleRateHz;
         lastData.assign(iq, iq + count * 2);
+        all.insert(all.end(), iq, iq + count * 2);
         callCount++;
     }
 
     std::vector<float> lastData;
+    std::vector<float> all;     // every dispatched pair, in order
+    std::vector<uint64_t> timestamps;   // BlockMeta::timestamp per dispatch
+    std::vector<int>      counts;       // pairs per dispatch
     double lastSr{0.0};
     int callCount{0};
 };
 
+// Holds every dispatch until released, standing in for slow downstream DSP.
+class GatedSink : public IPipelineHandler {
+public:
+    void processBlock(const float*, int, double) override {
+        entered.fetch_add(1);
+        while (!open.load()) std::this_thread::yield();
+        calls.fetch_add(1);
+    }
+
+    std::atomic<bool> open{false};
+    std::atomic<int>  entered{0};
+    std::atomic<int>  calls{0};
+};
+
 // ---------------------------------------------------------------------------
 // Helpers
 // ---------------------------------------------------------------------------
@@ -42,6 +72,82 @@ static BlockMeta meta(int chIdx, uint64_t ts = 0) {
     return {{ChannelDescriptor::RX, chIdx}, ts};
 }
 
+// Pair n carries its hardware timestamp: I = ts, Q = −ts. Channels combine
+// to the same values only when aligned sample for sample.
+static std::vector<float> makeStamped(uint64_t ts, int count) {
+    std::vector<float> buf(count * 2);
+    for (int n = 0; n < count; ++n) {
+        buf[2 * n]     = static_cast<float>(ts + n);
+        buf[2 * n + 1] = -static_cast<float>(ts + n);
+    }
+    return buf;
+}
+
+static void feed(IqCombiner& c, int ch, uint64_t ts, int count) {
+    const auto buf = makeStamped(ts, count);
+    c.processBlock(buf.data(), count, 2e6, meta(ch, ts));
+}
+
+// True when every dispatch is stamped with the timestamp of its first pair,
+// the dispatches consecutive from `first`.
+static bool metaFrom(const TestSink& sink, uint64_t first) {
+    for (std::size_t k = 0; k < sink.timestamps.size(); ++k) {
+        if (sink.timestamps[k] != first) return false;
+        first += static_cast<uint64_t>(sink.counts[k]);
+    }
+    return !sink.timestamps.empty();
+}
+
+// True when every pair of `all` is (ts, −ts) for consecutive ts from `first`.
+static bool stampedFrom(const std::vector<float>& all, uint64_t first) {
+    for (std::size_t n = 0; n < all.size() / 2; ++n)
+        if (all[2 * n] != static_cast<float>(first + n) || all[2 * n + 1] != -static_cast<float>(first + n))
+            return false;
+    return true;
+}
+
+// Unit tone e^{j(0.01·n + phase)} for n from `first`, plus complex Gaussian
+// noise of total power sigma².
+static std::vector<float> makeTone(uint64_t first, int count, double phaseRad,
+                                   double sigma = 0.0, std::mt19937* rng = nullptr) {
+    std::normal_distribution<double> noise(0.0, sigma / std::sqrt(2.0));
+    std::vector<float> buf(count * 2);
+    for (int n = 0; n < count; ++n) {
+        const double p = 0.01 * static_cast<double>(first + n) + phaseRad;
+        buf[2 * n]     = static_cast<float>(std::cos(p) + (rng ? noise(*rng) : 0.0));
+        buf[2 * n + 1] = static_cast<float>(std::sin(p) + (rng ? noise(*rng) : 0.0));
+    }
+    return buf;
+}
+
+// Band-limited test signal (tones within ±0.2 · fs) at fractional time t.
+static std::complex<double> multitone(double t) {
+    static const double kFreq[]  = {-0.19, -0.11, -0.045, 0.02, 0.07, 0.13, 0.18};
+    static const double kPhase[] = {0.3, 2.1, 4.0, 1.2, 5.5, 0.8, 3.3};
+    std::complex<double> s;
+    for (int i = 0; i < 7; ++i) s += std::polar(0.3, 2.0 * M_PI * kFreq[i] * t + kPhase[i]);
+    return s;
+}
+
+// multitone(n − lag) for n = first … first + count − 1.
+static std::vector<float> makeMultitone(uint64_t first, int count, double lag) {
+    std::vector<float> buf(count * 2);
+    for (int n = 0; n < count; ++n) {
+        const auto s = multitone(static_cast<double>(first + n) - lag);
+        buf[2 * n]     = static_cast<float>(s.real());
+        buf[2 * n + 1] = static_cast<float>(s.imag());
+    }
+    return buf;
+}
+
+// Mean |out − clean tone|² over the pairs of `out`, the first at `first`.
+static double errorPower(const std::vector<float>& out, uint64_t first) {
+    const auto clean = makeTone(first, static_cast<int>(out.size() / 2), 0.0);
+    double e = 0.0;
+    for (std::size_t i = 0; i < out.size(); ++i) e += (out[i] - clean[i]) * (out[i] - clean[i]);
+    return e / static_cast<double>(out.size() / 2);
+}
+
 // ═══════════════════════════════════════════════════════════════════════════════
 // Tests
 // ═══════════════════════════════════════════════════════════════════════════════
@@ -61,6 +167,10 @@ TEST_CASE("IqCombiner: single channel passthrough", "[iqcombiner]") {
     // With gain 0 dB, scale = 1.0, output equals input.
     REQUIRE_THAT(sink.lastData[0], WithinAbs(0.5, 1e-6));
     REQUIRE_THAT(sink.lastData[1], WithinAbs(-0.3, 1e-6));
+    CHECK(sink.timestamps.back() == 0);   // no counter, none invented
+
+    combiner.processBlock(data.data(), 64, 2e6, meta(0, 777));
+    CHECK(sink.timestamps.back() == 777);
 }
 
 TEST_CASE("IqCombiner: two channels equal gain → average", "[iqcombiner]") {
@@ -113,6 +223,40 @@ TEST_CASE("IqCombiner: gain normalization", "[iqcombiner]") {
     REQUIRE_THAT(sink.lastData[0], WithinAbs(0.1, 1e-5));
 }
 
+TEST_CASE("IqCombiner: channels without counters dispatch no timestamp", "[iqcombiner]") {
+    Pipeline pipe;
+    TestSink sink;
+    pipe.addHandler(&sink);
+    IqCombiner combiner(2, &pipe);
+
+    constexpr int N = 64;
+    auto data = makeConstIq(N, 0.5f, 0.0f);
+    for (int b = 0; b < 3; ++b) {
+        combiner.processBlock(data.data(), N, 2e6, meta(0));
+        combiner.processBlock(data.data(), N, 2e6, meta(1));
+    }
+    REQUIRE(sink.callCount == 3);
+    CHECK(sink.timestamps == std::vector<uint64_t>{0, 0, 0});   // none invented
+
+    // One channel without a counter is enough: its positions are sample counts.
+    combiner.onStreamStarted(2e6);
+    combiner.processBlock(data.data(), N, 2e6, meta(0));        // counts 0, N, …
+    combiner.processBlock(data.data(), N, 2e6, meta(1, N));     // counter N
+    combiner.processBlock(data.data(), N, 2e6, meta(0));
+    REQUIRE(sink.callCount == 4);
+    CHECK(sink.timestamps.back() == 0);
+
+    // A counter that continues a counted run confirms its positions.
+    combiner.onStreamStarted(2e6);
+    combiner.processBlock(data.data(), N, 2e6, meta(0));
+    combiner.processBlock(data.data(), N, 2e6, meta(1));
+    combiner.processBlock(data.data(), N, 2e6, meta(0, N));
+    combiner.processBlock(data.data(), N, 2e6, meta(1, N));
+    REQUIRE(sink.callCount == 6);
+    CHECK(sink.timestamps[4] == 0);
+    CHECK(sink.timestamps[5] == static_cast<uint64_t>(N));
+}
+
 TEST_CASE("IqCombiner: multiple blocks in sequence", "[iqcombiner]") {
     Pipeline pipe;
     TestSink sink;
@@ -139,9 +283,11 @@ TEST_CASE("IqCombiner: multiple blocks in sequence", "[iqcombiner]") {
     REQUIRE(sink.callCount == 2);
     REQUIRE_THAT(sink.lastData[0], WithinAbs(0.5, 1e-5));
     REQUIRE_THAT(sink.lastData[1], WithinAbs(0.5, 1e-5));
+    // The gap stays visible downstream.
+    CHECK(sink.timestamps == std::vector<uint64_t>{100, 200});
 }
 
-TEST_CASE("IqCombiner: onStreamStarted resets slots", "[iqcombiner]") {
+TEST_CASE("IqCombiner: onStreamStarted discards unpaired samples", "[iqcombiner]") {
     Pipeline pipe;
     TestSink sink;
     pipe.addHandler(&sink);
@@ -162,6 +308,114 @@ TEST_CASE("IqCombiner: onStreamStarted resets slots", "[iqcombiner]") {
     combiner.processBlock(data.data(), N, 2e6, meta(0));
     combiner.processBlock(data.data(), N, 2e6, meta(1));
     REQUIRE(sink.callCount == 1);
+    CHECK(combiner.slipSamples() == N);
+}
+
+TEST_CASE("IqCombiner: a channel a block ahead is kept for its partner", "[iqcombiner]") {
+    Pipeline pipe;
+    TestSink sink;
+    pipe.addHandler(&sink);
+
+    IqCombiner combiner(2, &pipe);
+
+    constexpr int N = 8;
+    feed(combiner, 0, 1000, N);
+    feed(combiner, 0, 1000 + N, N);   // ch0 ran ahead: buffered, not lost
+    feed(combiner, 1, 1000, N);
+    CHECK(combiner.combinedBlocks() == 1);
+    feed(combiner, 1, 1000 + N, N);
+    CHECK(combiner.combinedBlocks() == 2);
+    CHECK(combiner.droppedBlocks() == 0);
+    CHECK(combiner.slips() == 0);
+    CHECK(sink.all.size() == 4 * N);
+    CHECK(stampedFrom(sink.all, 1000));
+}
+
+TEST_CASE("IqCombiner: realigns channels by timestamp", "[iqcombiner]") {
+    Pipeline pipe;
+    TestSink sink;
+    pipe.addHandler(&sink);
+
+    IqCombiner combiner(2, &pipe);
+
+    // ch1 starts 3 samples later: ch0's first 3 samples have no partner.
+    constexpr int N = 64;
+    feed(combiner, 0, 5000, N);
+    feed(combiner, 1, 5003, N);
+    CHECK(combiner.slips() == 1);
+    CHECK(combiner.slipSamples() == 3);
+    CHECK(sink.all.size() == 2 * (N - 3));
+    CHECK(stampedFrom(sink.all, 5003));
+    CHECK(metaFrom(sink, 5003));   // output meta = aligned input timestamp
+
+    // Partial blocks on ch1 cover the rest of ch0's next block.
+    feed(combiner, 0, 5000 + N, N);
+    feed(combiner, 1, 5003 + N, 20);
+    feed(combiner, 1, 5003 + N + 20, 41);
+    CHECK(sink.all.size() == 2 * (2 * N - 3));
+    CHECK(stampedFrom(sink.all, 5003));
+    CHECK(metaFrom(sink, 5003));
+    CHECK(combiner.slips() == 1);
+}
+
+TEST_CASE("IqCombiner: a gap on one channel skips the others' samples", "[iqcombiner]") {
+    Pipeline pipe;
+    TestSink sink;
+    pipe.addHandler(&sink);
+
+    IqCombiner combiner(2, &pipe);
+
+    constexpr int N = 32;
+    feed(combiner, 0, 0, N);
+    feed(combiner, 1, 0, N);
+    feed(combiner, 0, N, N);
+    feed(combiner, 0, 2 * N, N);
+    feed(combiner, 1, 2 * N, N);      // ch1 lost [N, 2N) upstream
+    CHECK(combiner.slips() == 1);
+    CHECK(combiner.slipSamples() == N);
+
+    sink.all.erase(sink.all.begin(), sink.all.begin() + 2 * N);
+    CHECK(sink.all.size() == 2 * N);
+    CHECK(stampedFrom(sink.all, 2 * N));
+}
+
+TEST_CASE("IqCombiner: duplicate samples are trimmed", "[iqcombiner]") {
+    Pipeline pipe;
+    TestSink sink;
+    pipe.addHandler(&sink);
+
+    IqCombiner combiner(2, &pipe);
+
+    constexpr int N = 16;
+    feed(combiner, 0, 100, N);
+    feed(combiner, 0, 100 + N - 4, N);   // repeats 4 samples
+    feed(combiner, 1, 100, 2 * N - 4);
+    CHECK(combiner.slips() == 1);
+    CHECK(combiner.slipSamples() == 4);
+    CHECK(sink.all.size() == 2 * (2 * N - 4));
+    CHECK(stampedFrom(sink.all, 100));
+}
+
+TEST_CASE("IqCombiner: a channel a ring ahead drops the excess", "[iqcombiner]") {
+    Pipeline pipe;
+    TestSink sink;
+    pipe.addHandler(&sink);
+
+    IqCombiner combiner(2, &pipe);
+
+    // The ring holds kRingPairs less the delay filter's history, so the
+    // last block loses that much.
+    constexpr int N = IqCombiner::kMaxDispatchPairs;
+    constexpr int kBlocks = IqCombiner::kRingPairs / N;
+    for (int b = 0; b < kBlocks; ++b) feed(combiner, 0, uint64_t(b) * N, N);
+    CHECK(combiner.droppedBlocks() == 1);
+    CHECK(sink.callCount == 0);
+
+    // ch1 catches up over what ch0 kept.
+    for (int b = 0; b < kBlocks; ++b) feed(combiner, 1, uint64_t(b) * N, N);
+    CHECK(sink.callCount == kBlocks);
+    CHECK(sink.all.size() == 2u * (IqCombiner::kRingPairs - FractionalDelay::kReach));
+    CHECK(stampedFrom(sink.all, 0));
 }
 
 TEST_CASE("IqCombiner: out-of-range channel index ignored", "[iqcombiner]") {
@@ -195,3 +449,277 @@ TEST_CASE("IqCombiner: single channel with gain", "[iqcombiner]") {
     const float expected = 1.0f / std::pow(10.0f, 6.0f / 20.0f);
     REQUIRE_THAT(sink.lastData[0], WithinAbs(expected, 1e-5));
 }
+
+TEST_CASE("IqCombiner: a channel deposits while the other dispatches", "[iqcombiner]") {
+    Pipeline pipe;
+    GatedSink sink;
+    pipe.addHandler(&sink);
+
+    IqCombiner combiner(2, &pipe);
+
+    constexpr int N = 8;
+    auto data = makeConstIq(N, 0.5f, 0.5f);
+
+    // ch1 completes the first span and is held inside the downstream pipeline.
+    combiner.processBlock(data.data(), N, 2e6, meta(0, 0));
+    std::thread rx1([&] { combiner.processBlock(data.data(), N, 2e6, meta(1, 0)); });
+    while (sink.entered.load() == 0) std::this_thread::yield();
+
+    // ch0 keeps depositing without waiting for it.
+    combiner.processBlock(data.data(), N, 2e6, meta(0, N));
+    combiner.processBlock(data.data(), N, 2e6, meta(0, 2 * N));
+    CHECK(sink.calls.load() == 0);
+
+    sink.open.store(true);
+    rx1.join();
+    CHECK(sink.calls.load() == 1);
+
+    // The buffered ch0 blocks pair with ch1's next ones.
+    combiner.processBlock(data.data(), N, 2e6, meta(1, N));
+    combiner.processBlock(data.data(), N, 2e6, meta(1, 2 * N));
+    CHECK(sink.calls.load() == 3);
+    CHECK(combiner.droppedBlocks() == 0);
+    CHECK(combiner.slips() == 0);
+}
+
+TEST_CASE("IqCombiner: dispatch stays serial under concurrent channels", "[iqcombiner]") {
+    Pipeline pipe;
+    TestSink sink;
+    pipe.addHandler(&sink);
+
+    IqCombiner combiner(2, &pipe);
+
+    constexpr int N = 64;
+    constexpr int kBlocks = 2000;
+    auto run = [&](int ch) {
+        for (int b = 0; b < kBlocks; ++b) {
+            const auto buf = makeStamped(uint64_t(b) * N, N);
+            combiner.processBlock(buf.data(), N, 2e6, meta(ch, uint64_t(b) * N));
+        }
+    };
+    std::thread rx0(run, 0);
+    std::thread rx1(run, 1);
+    rx0.join();
+    rx1.join();
+
+    // Less than a ring apart: every sample is combined, in order.
+    CHECK(combiner.droppedBlocks() == 0);
+    CHECK(combiner.slips() == 0);
+    CHECK(combiner.combinedBlocks() == static_cast<uint64_t>(sink.callCount));
+    CHECK(sink.all.size() == 2u * N * kBlocks);
+    CHECK(stampedFrom(sink.all, 0));
+}
+
+TEST_CASE("IqCombiner: rejects an empty channel set", "[iqcombiner]") {
+    Pipeline pipe;
+    CHECK_THROWS_AS(IqCombiner(0, &pipe), std::invalid_argument);
+}
+
+TEST_CASE("IqCombiner: phase-aligned combining applies the calibration", "[iqcombiner]") {
+    Pipeline pipe;
+    TestSink sink;
+    pipe.addHandler(&sink);
+
+    IqCombiner combiner(2, &pipe);
+    constexpr int N = 256;
+    const double lag = 60.0 * M_PI / 180.0;   // ch1 = ch0 · e^{−j60°}
+    auto ch0 = makeTone(0, N, 0.0);
+    auto ch1 = makeTone(0, N, -lag);
+
+    SECTION("average loses the misalignment") {
+        combiner.processBlock(ch0.data(), N, 2e6, meta(0, 1));
+        combiner.processBlock(ch1.data(), N, 2e6, meta(1, 1));
+        REQUIRE(sink.all.size() == 2u * N);
+        CHECK_THAT(std::hypot(sink.all[0], sink.all[1]), WithinAbs(std::cos(lag / 2), 1e-5));
+    }
+    SECTION("calibrated rotation restores the signal") {
+        combiner.setMode(IqCombiner::Mode::PhaseAligned);
+        combiner.setPhaseCalibrationDeg(60.0);
+        combiner.processBlock(ch0.data(), N, 2e6, meta(0, 1));
+        combiner.processBlock(ch1.data(), N, 2e6, meta(1, 1));
+        REQUIRE(sink.all.size() == 2u * N);
+        CHECK(errorPower(sink.all, 0) < 1e-10);
+    }
+}
+
+TEST_CASE("IqCombiner: calibrateNow captures every channel's phase", "[iqcombiner]") {
+    Pipeline pipe;
+    TestSink sink;
+    pipe.addHandler(&sink);
+
+    IqCombiner combiner(3, &pipe);
+    CHECK(combiner.calibrateNow() == 0.0);   // nothing tracked yet
+
+    constexpr int N = 512;
+    const double lags[3] = {0.0, 60.0, -100.0};
+    for (int ch = 0; ch < 3; ++ch) {
+        auto buf = makeTone(0, N, -lags[ch] * M_PI / 180.0);
+        combiner.processBlock(buf.data(), N, 2e6, meta(ch, 1));
+    }
+    CHECK_THAT(combiner.calibrateNow(), WithinAbs(60.0, 1e-3));
+    CHECK_THAT(combiner.phaseCalibrationDeg(2), WithinAbs(-100.0, 1e-3));
+
+    combiner.setMode(IqCombiner::Mode::PhaseAligned);
+    sink.all.clear();
+    for (int ch = 0; ch < 3; ++ch) {
+        auto buf = makeTone(N, N, -lags[ch] * M_PI / 180.0);
+        combiner.processBlock(buf.data(), N, 2e6, meta(ch, 1 + N));
+    }
+    REQUIRE(sink.all.size() == 2u * N);
+    CHECK(errorPower(sink.all, N) < 1e-8);
+}
+
+TEST_CASE("IqCombiner: MRC beats both the average and the best channel", "[iqcombiner]") {
+    std::mt19937 rng(7);
+    constexpr int N = 8192;
+    constexpr int kBlocks = 4;
+    const double sigma[2] = {0.3, 1.0};   // ch1 far noisier, and 30° behind
+
+    auto run = [&](IqCombiner::Mode mode) {
+        Pipeline pipe;
+        TestSink sink;
+        pipe.addHandler(&sink);
+        IqCombiner combiner(2, &pipe);
+        combiner.setMode(mode);
+        combiner.setPhaseTracking(true);
+        for (int b = 0; b < kBlocks; ++b) {
+            sink.all.clear();
+            for (int ch = 0; ch < 2; ++ch) {
+                auto buf = makeTone(uint64_t(b) * N, N, ch == 1 ? -M_PI / 6 : 0.0, sigma[ch], &rng);
+                combiner.processBlock(buf.data(), N, 2e6, meta(ch, 1 + uint64_t(b) * N));
+            }
+        }
+        return errorPower(sink.all, uint64_t(kBlocks - 1) * N);
+    };
+
+    const double average = run(IqCombiner::Mode::Average);
+    const double mrc     = run(IqCombiner::Mode::Mrc);
+    const double best    = sigma[0] * sigma[0];
+    const double ideal   = 1.0 / (1.0 / (sigma[0] * sigma[0]) + 1.0 / (sigma[1] * sigma[1]));
+    CHECK(mrc < average);
+    CHECK(mrc < best);
+    CHECK_THAT(mrc, WithinAbs(ideal, 0.15 * ideal));
+}
+
+TEST_CASE("IqCombiner: phase tracking follows a drifting channel", "[iqcombiner]") {
+    Pipeline pipe;
+    TestSink sink;
+    pipe.addHandler(&sink);
+
+    IqCombiner combiner(2, &pipe);
+    combiner.setMode(IqCombiner::Mode::PhaseAligned);
+    combiner.setPhaseTracking(true);
+
+    // 0.5 s per block at 4 kHz: the average settles within a few blocks.
+    constexpr int    N  = 2000;
+    constexpr double fs = 4e3;
+    for (int b = 0; b < 12; ++b) {
+        const double lag = (b < 4 ? 20.0 : 110.0) * M_PI / 180.0;
+        auto ch0 = makeTone(uint64_t(b) * N, N, 0.0);
+        auto ch1 = makeTone(uint64_t(b) * N, N, -lag);
+        sink.all.clear();
+        combiner.processBlock(ch0.data(), N, fs, meta(0, 1 + uint64_t(b) * N));
+        combiner.processBlock(ch1.data(), N, fs, meta(1, 1 + uint64_t(b) * N));
+        REQUIRE(sink.all.size() == 2u * N);
+        if (b == 3)  CHECK(errorPower(sink.all, uint64_t(b) * N) < 1e-8);
+    }
+    CHECK(errorPower(sink.all, uint64_t(11) * N) < 1e-4);   // within ~0.6°
+    CHECK(combiner.phaseCalibrationDeg() == 0.0);   // tracking leaves the calibration alone
+}
+
+TEST_CASE("IqCombiner: estimates and compensates a fractional delay", "[iqcombiner]") {
+    Pipeline pipe;
+    TestSink sink;
+    pipe.addHandler(&sink);
+
+    IqCombiner combiner(2, &pipe);
+    combiner.setDelayCompensation(true);
+    constexpr int    N   = 8192;
+    constexpr double lag = 2.37;   // ch1 lags ch0
+
+    auto feedBlock = [&](int b) {
+        const uint64_t first = uint64_t(b) * N;
+        auto ch0 = makeMultitone(first, N, 0.0);
+        auto ch1 = makeMultitone(first, N, lag);
+        combiner.processBlock(ch0.data(), N, 2e6, meta(0, 1 + first));
+        combiner.processBlock(ch1.data(), N, 2e6, meta(1, 1 + first));
+    };
+
+    feedBlock(0);
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+    while (combiner.delayEstimates() == 0 && std::chrono::steady_clock::now() < deadline)
+        std::this_thread::yield();
+    REQUIRE(combiner.delayEstimates() == 1);
+    CHECK_THAT(combiner.delaySamples(1), WithinAbs(lag, 0.01));
+
+    // The combined output trails by kReach and starts kReach into the run.
+    feedBlock(1);
+    constexpr int kReach = FractionalDelay::kReach;
+    REQUIRE(sink.all.size() == 2u * (2 * N - 2 * kReach));
+    CHECK(combiner.slips() == 0);
+    double err = 0.0;
+    const std::size_t from = N;   // past the first, uncompensated block
+    for (std::size_t i = from; i < sink.all.size() / 2; ++i) {
+        const auto want = multitone(static_cast<double>(i + kReach));
+        err = std::max(err, std::abs(std::complex<double>(sink.all[2 * i], sink.all[2 * i + 1]) - want));
+    }
+    CHECK(err < 1e-3);
+}
+
+TEST_CASE("IqCombiner: cross-spectrum of the raw channels", "[iqcombiner]") {
+    Pipeline pipe;
+    TestSink sink;
+    pipe.addHandler(&sink);
+
+    IqCombiner combiner(2, &pipe);
+    CrossSpectrum::Options o;
+    o.fftSize = 256;
+    o.segments = 4;
+    o.antennaSpacingM = 299'792'458.0 / 433e6 / 2.0;   // λ / 2
+    combiner.setCrossSpectrum(o, 0);
+    combiner.setCentreFrequency(433e6);
+    combiner.setPhaseCalibrationDeg(10.0);
+
+    CrossSpectrumFrame frame;
+    std::atomic<bool> got{false};
+    QObject::connect(&combiner, &IqCombiner::crossSpectrum, [&](CrossSpectrumFrame f) {
+        if (got.load()) return;
+        frame = std::move(f);
+        got.store(true);
+    });
+
+    // ch1 = ch0 · e^{−j40°}: raw phase 40°, calibrated 30°.
+    constexpr int N = 4096;
+    std::mt19937 rng(3);
+    const auto ch0 = makeTone(1, N, 0.0, 0.05, &rng);
+    const auto ch1 = makeTone(1, N, -40.0 * M_PI / 180.0, 0.05, &rng);
+    combiner.processBlock(ch0.data(), N, 2e6, meta(0, 1));
+    combiner.processBlock(ch1.data(), N, 2e6, meta(1, 1));
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+    while (!got.load() && std::chrono::steady_clock::now() < deadline)
+        std::this_thread::yield();
+    REQUIRE(got.load());
+    CHECK(combiner.crossSpectra() >= 1);
+    CHECK(frame.centreHz == 433e6);
+    CHECK(frame.sampleRateHz == 2e6);
+    REQUIRE(frame.readings.size() == 1);
+    const DfReading& r = frame.readings[0];
+    CHECK_THAT(r.phaseDeg, WithinAbs(30.0, 0.5));
+    CHECK(r.coherence > 0.95f);
+    REQUIRE(r.angleValid);
+    CHECK_THAT(r.angleDeg, WithinAbs(std::asin(-30.0 / 180.0) * 180.0 / M_PI, 0.5));
+}
+
+TEST_CASE("IqCombiner: cross-spectrum needs two channels", "[iqcombiner]") {
+    Pipeline pipe;
+    IqCombiner one(1, &pipe);
+    one.setCrossSpectrum({});
+    CHECK_FALSE(one.crossSpectrumEnabled());
+
+    IqCombiner two(2, &pipe);
+    CrossSpectrum::Options bad;
+    bad.fftSize = 100;
+    CHECK_THROWS_AS(two.setCrossSpectrum(bad), std::invalid_argument);
+    CHECK_FALSE(two.crossSpectrumEnabled());
+}
@@ -0,0 +1,242 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+
+#include "IqFileReader.h"
+#include "IqFormats.h"
+#include "RawFileHandler.h"
+#include "RecordingSettings.h"
+#include "SigMfWriter.h"
+
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+using Format = RecordingSettings::RawFormat;
+
+static std::string tempPath(const char* name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+// Device-like samples: 12-bit ADC values left-aligned in int16.
+static std::vector<int16_t> adcSamples(int pairs) {
+    std::vector<int16_t> v(static_cast<std::size_t>(pairs) * 2);
+    for (std::size_t i = 0; i < v.size(); ++i) {
+        const int a = static_cast<int>(2047.0 * std::sin(0.013 * static_cast<double>(i) + (i & 1)));
+        v[i] = static_cast<int16_t>(a * 16);
+    }
+    v[0] = -32768;   // full-scale extremes
+    v[1] = 2047 * 16;
+    return v;
+}
+
+// Same conversion as RxWorker.
+static std::vector<float> toFloat(const std::vector<int16_t>& in) {
+    std::vector<float> out(in.size());
+    for (std::size_t i = 0; i < in.size(); ++i) out[i] = in[i] * (1.0f / 32768.0f);
+    return out;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Conversions
+// ─────────────────────────────────────────────────────────────────────────────
+TEST_CASE("IqFormats: float → int16 inverts RxWorker bit-exactly", "[iqformats]") {
+    std::vector<int16_t> all(65536);
+    for (int i = 0; i < 65536; ++i) all[i] = static_cast<int16_t>(i - 32768);
+    const auto f = toFloat(all);
+
+    std::vector<int16_t> back(all.size());
+    CHECK(IqFormats::floatToInt16(f.data(), back.data(), f.size()) == 0);
+    CHECK(back == all);
+
+    const float hot[2] = {1.5f, -1.5f};
+    int16_t out[2];
+    CHECK(IqFormats::floatToInt16(hot, out, 2) == 2);
+    CHECK(out[0] == 32767);
+    CHECK(out[1] == -32768);
+}
+
+TEST_CASE("IqFormats: ci12 pack/unpack is lossless for 12-bit samples", "[iqformats]") {
+    const auto raw = adcSamples(1001);
+    const std::size_t pairs = raw.size() / 2;
+
+    std::vector<uint8_t> packed(pairs * 3);
+    CHECK(IqFormats::packInt12(raw.data(), packed.data(), pairs) == 0);
+
+    std::vector<int16_t> back(raw.size());
+    IqFormats::unpackInt12(packed.data(), back.data(), pairs);
+    CHECK(back == raw);
+}
+
+TEST_CASE("IqFormats: ci8 maps full scale to 127 and round-trips within one step", "[iqformats]") {
+    std::vector<float> x(2048);
+    for (std::size_t i = 0; i < x.size(); ++i)
+        x[i] = static_cast<float>(std::cos(0.01 * static_cast<double>(i)));
+
+    const float scale = IqFormats::kInt8Scale;
+    std::vector<int8_t> q(x.size());
+    CHECK(IqFormats::floatToInt8(x.data(), q.data(), x.size(), scale) == 0);
+    std::vector<float> back(x.size());
+    IqFormats::int8ToFloat(q.data(), back.data(), x.size(), scale);
+    for (std::size_t i = 0; i < x.size(); ++i)
+        CHECK(std::abs(back[i] - x[i]) <= 0.5f * scale + 1e-7f);
+    CHECK(q[0] == 127);
+
+    const float hot[2] = {1.5f, -1.5f};
+    int8_t out[2];
+    CHECK(IqFormats::floatToInt8(hot, out, 2, scale) == 2);
+    CHECK(out[0] == 127);
+    CHECK(out[1] == -128);
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// RawFileHandler → IqFileReader
+// ─────────────────────────────────────────────────────────────────────────────
+TEST_CASE("RawFileHandler: ci16 and ci12 replay the live floats exactly", "[iqformats]") {
+    const auto raw = adcSamples(4096);
+    const auto f   = toFloat(raw);
+    const int  pairs = static_cast<int>(raw.size() / 2);
+
+    for (Format fmt : {Format::Int16, Format::Int12}) {
+        const std::string path = tempPath(fmt == Format::Int16 ? "stand_iqfmt.ci16"
+                                                               : "stand_iqfmt.ci12");
+        {
+            RawFileHandler h(QString::fromStdString(path), fmt);
+            h.onStreamStarted(1e6);
+            BlockMeta meta;
+            meta.rawIq = raw.data();
+            h.processBlock(f.data(), pairs / 2, 1e6, meta);                 // device path
+            h.processBlock(f.data() + pairs, pairs / 2, 1e6);                // float fallback
+            h.onStreamStopped();
+        }
+        CHECK(std::filesystem::file_size(path)
+              == static_cast<uintmax_t>(pairs) * IqFormats::bytesPerPair(fmt));
+
+        IqFileReader r;
+        REQUIRE(r.open(QString::fromStdString(path)));
+        CHECK(r.format() == fmt);
+        CHECK(r.totalPairs() == static_cast<uint64_t>(pairs));
+
+        std::vector<float> back(f.size());
+        int got = 0;
+        while (got < pairs) {
+            const int n = r.read(back.data() + 2 * got, 1000);
+            if (n == 0) break;
+            got += n;
+        }
+        CHECK(got == pairs);
+        CHECK(back == f);
+
+        REQUIRE(r.seek(pairs - 1));
+        float last[2];
+        CHECK(r.read(last, 4) == 1);
+        CHECK(last[0] == f[f.size() - 2]);
+        r.close();
+        std::filesystem::remove(path);
+    }
+}
+
+// A quiet first block must not fix a scale that clips what follows.
+TEST_CASE("RawFileHandler: ci8 keeps a fixed full scale across a quiet start", "[iqformats]") {
+    const std::string path = tempPath("stand_iqfmt.ci8");
+    constexpr int kBlock = 1000;
+    std::vector<float> quiet(2 * kBlock), loud(2 * kBlock);
+    for (std::size_t i = 0; i < quiet.size(); ++i) {
+        const float s = static_cast<float>(std::sin(0.02 * static_cast<double>(i)));
+        quiet[i] = 0.001f * s;
+        loud[i]  = 0.9f * s;
+    }
+    {
+        RawFileHandler h(QString::fromStdString(path), Format::Int8);
+        h.enableSigMf(100e6, {});
+        h.onStreamStarted(1e6);
+        h.processBlock(quiet.data(), kBlock, 1e6);
+        h.processBlock(loud.data(), kBlock, 1e6);
+        h.onStreamStopped();
+    }
+
+    QFile side(QString::fromStdString(path) + QStringLiteral(".json"));
+    REQUIRE(side.open(QIODevice::ReadOnly));
+    const QJsonObject o = QJsonDocument::fromJson(side.readAll()).object();
+    CHECK(o.value(QStringLiteral("scale")).toDouble() == static_cast<double>(IqFormats::kInt8Scale));
+    CHECK(o.value(QStringLiteral("clipped")).toDouble() == 0.0);
+
+    QFile meta(SigMfWriter::metaPathFor(QString::fromStdString(path)));
+    REQUIRE(meta.open(QIODevice::ReadOnly));
+    const QJsonObject global = QJsonDocument::fromJson(meta.readAll()).object()
+                                   .value(QStringLiteral("global")).toObject();
+    CHECK(global.value(QStringLiteral("stand:scale")).toDouble()
+          == static_cast<double>(IqFormats::kInt8Scale));
+
+    IqFileReader r;
+    REQUIRE(r.open(QString::fromStdString(path)));
+    REQUIRE(r.totalPairs() == 2u * kBlock);
+    std::vector<float> back(4 * kBlock);
+    int got = 0;
+    while (got < 2 * kBlock) {
+        const int n = r.read(back.data() + 2 * got, 2 * kBlock - got);
+        if (n == 0) break;
+        got += n;
+    }
+    REQUIRE(got == 2 * kBlock);
+    for (std::size_t i = 0; i < loud.size(); ++i)
+        CHECK(std::abs(back[quiet.size() + i] - loud[i]) <= 0.5f * IqFormats::kInt8Scale + 1e-6f);
+    r.close();
+    side.close();
+    meta.close();
+    std::filesystem::remove(path);
+    std::filesystem::remove(path + ".json");
+    std::filesystem::remove(SigMfWriter::metaPathFor(QString::fromStdString(path)).toStdString());
+}
+
+TEST_CASE("RawFileHandler: ci8 uses the configured full scale", "[iqformats]") {
+    const std::string path = tempPath("stand_iqfmt_scaled.ci8");
+    RecordingSettings rec;
+    rec.int8FullScaleDbfs = -40.0;   // 0.01 ↔ 127
+    const float scale = rec.int8Scale();
+    REQUIRE_THAT(scale * 127.0f, Catch::Matchers::WithinRel(0.01f, 1e-5f));
+
+    constexpr int kBlock = 1000;
+    std::vector<float> weak(2 * kBlock);
+    for (std::size_t i = 0; i < weak.size(); ++i)
+        weak[i] = 0.008f * static_cast<float>(std::sin(0.02 * static_cast<double>(i)));
+    {
+        RawFileHandler h(QString::fromStdString(path), Format::Int8);
+        h.setInt8Scale(scale);
+        h.enableSigMf(100e6, {});
+        h.onStreamStarted(1e6);
+        h.processBlock(weak.data(), kBlock, 1e6);
+        h.onStreamStopped();
+    }
+
+    QFile meta(SigMfWriter::metaPathFor(QString::fromStdString(path)));
+    REQUIRE(meta.open(QIODevice::ReadOnly));
+    CHECK(QJsonDocument::fromJson(meta.readAll()).object()
+              .value(QStringLiteral("global")).toObject()
+              .value(QStringLiteral("stand:scale")).toDouble() == static_cast<double>(scale));
+
+    // The reader takes the scale from the sidecar; ~100 steps of resolution.
+    IqFileReader r;
+    REQUIRE(r.open(QString::fromStdString(path)));
+    CHECK(r.int8Scale() == scale);
+    std::vector<float> back(weak.size());
+    int got = 0;
+    while (got < kBlock) {
+        const int n = r.read(back.data() + 2 * got, kBlock - got);
+        if (n == 0) break;
+        got += n;
+    }
+    REQUIRE(got == kBlock);
+    for (std::size_t i = 0; i < weak.size(); ++i)
+        CHECK(std::abs(back[i] - weak[i]) <= 0.5f * scale + 1e-7f);
+    r.close();
+    meta.close();
+    std::filesystem::remove(path);
+    std::filesystem::remove(path + ".json");
+    std::filesystem::remove(SigMfWriter::metaPathFor(QString::fromStdString(path)).toStdString());
+}
@@ -0,0 +1,105 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "LatencyHistogram.h"
+#include "TimedHandler.h"
+
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+// ─────────────────────────────────────────────────────────────────────────────
+// LatencyHistogram
+// ─────────────────────────────────────────────────────────────────────────────
+TEST_CASE("LatencyHistogram: buckets are ordered and within 12.5 %", "[latency]") {
+    int prev = -1;
+    for (uint64_t v = 0; v < (uint64_t{1} << 20); v += 1 + v / 64) {
+        const int idx = LatencyHistogram::index(v);
+        REQUIRE(idx >= prev);
+        REQUIRE(idx < LatencyHistogram::kBuckets);
+        const uint64_t upper = LatencyHistogram::upperBound(idx);
+        REQUIRE(upper >= v);
+        REQUIRE(static_cast<double>(upper - v) <= 0.125 * static_cast<double>(v) + 1.0);
+        prev = idx;
+    }
+    CHECK(LatencyHistogram::index(UINT64_MAX) == LatencyHistogram::kBuckets - 1);
+}
+
+TEST_CASE("LatencyHistogram: percentiles, mean and max", "[latency]") {
+    LatencyHistogram h;
+    for (uint64_t v = 1; v <= 1000; ++v) h.record(v * 1000);   // 1 µs … 1 ms
+
+    const auto s = h.snapshot();
+    CHECK(s.count == 1000);
+    CHECK(s.maxNs == 1'000'000);
+    CHECK(s.meanNs() == 500'500.0);
+    const auto p50 = s.percentileNs(0.50);
+    const auto p99 = s.percentileNs(0.99);
+    CHECK(p50 >= 500'000);
+    CHECK(p50 <= 500'000 * 9 / 8);
+    CHECK(p99 >= 990'000);
+    CHECK(p99 <= 1'000'000);        // capped at the maximum
+    CHECK(s.percentileNs(1.0) == 1'000'000);
+
+    h.reset();
+    CHECK(h.snapshot().count == 0);
+    CHECK(h.snapshot().percentileNs(0.5) == 0);
+}
+
+TEST_CASE("LatencyHistogram: concurrent record() loses nothing", "[latency]") {
+    LatencyHistogram h;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t)
+        threads.emplace_back([&h, t] {
+            for (int i = 0; i < 100'000; ++i) h.record(static_cast<uint64_t>(t * 1000 + i % 1000));
+        });
+    for (auto& th : threads) th.join();
+
+    const auto s = h.snapshot();
+    CHECK(s.count == 400'000);
+    uint64_t total = 0;
+    for (uint64_t b : s.buckets) total += b;
+    CHECK(total == 400'000);
+    CHECK(s.maxNs == 3999);
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// TimedHandler
+// ─────────────────────────────────────────────────────────────────────────────
+namespace {
+
+struct CountingHandler : IPipelineHandler {
+    int blocks{0}, started{0}, stopped{0};
+    double retunedHz{0.0};
+    int lastChannel{-1};
+
+    void processBlock(const float*, int, double) override { ++blocks; }
+    void processBlock(const float*, int, double, const BlockMeta& meta) override {
+        ++blocks;
+        lastChannel = meta.channel.channelIndex;
+    }
+    void onStreamStarted(double) override { ++started; }
+    void onStreamStopped() override { ++stopped; }
+    void onRetune(double hz) override { retunedHz = hz; }
+};
+
+}  // namespace
+
+TEST_CASE("TimedHandler: forwards everything and times each block", "[latency]") {
+    CountingHandler inner;
+    LatencyHistogram h;
+    TimedHandler timed(&inner, &h);
+
+    const std::vector<float> iq(64, 0.0f);
+    timed.onStreamStarted(2e6);
+    timed.processBlock(iq.data(), 32, 2e6);
+    timed.processBlock(iq.data(), 32, 2e6, BlockMeta{{ChannelDescriptor::RX, 1}, 0});
+    timed.onRetune(101e6);
+    timed.onStreamStopped();
+
+    CHECK(inner.blocks == 2);
+    CHECK(inner.lastChannel == 1);
+    CHECK(inner.started == 1);
+    CHECK(inner.stopped == 1);
+    CHECK(inner.retunedHz == 101e6);
+    CHECK(h.snapshot().count == 2);
+}
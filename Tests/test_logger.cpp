@@ -0,0 +1,144 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "Logger.h"
+#include "LoggerConfig.h"
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+static std::string tempPath(const char* name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+// Redirects the log to a fresh file for one test and returns its lines.
+class LogCapture {
+public:
+    explicit LogCapture(const char* name) : path_(tempPath(name)) {
+        std::filesystem::remove(path_);
+        Logger::instance().setLogFile(path_);
+    }
+    ~LogCapture() {
+        Logger::instance().setLogFile(tempPath("stand_test_logger_rest.log"));
+        std::filesystem::remove(path_);
+    }
+
+    std::vector<std::string> lines() const {
+        Logger::instance().flush();
+        std::ifstream in(path_);
+        std::vector<std::string> out;
+        for (std::string line; std::getline(in, line);) out.push_back(line);
+        return out;
+    }
+
+private:
+    std::string path_;
+};
+
+static bool endsWith(const std::string& s, const std::string& suffix) {
+    return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Format
+// ─────────────────────────────────────────────────────────────────────────────
+TEST_CASE("Logger: line format is unchanged by the async backend", "[logger]") {
+    LogCapture cap("stand_test_logger_format.log");
+    LOG_WARN("partial read: " + std::to_string(42));
+    const std::string lvalue = "lvalue message";
+    LOG_ERROR(lvalue);
+
+    const auto lines = cap.lines();
+    REQUIRE(lines.size() == 2);
+    // [YYYY-MM-DD HH:MM:SS.mmm] [WARN ] partial read: 42
+    REQUIRE(lines[0].size() > 26);
+    CHECK(lines[0][0] == '[');
+    CHECK(lines[0][11] == ' ');
+    CHECK(lines[0][20] == '.');
+    CHECK(lines[0].compare(24, 2, "] ") == 0);
+    CHECK(endsWith(lines[0], "[WARN ] partial read: 42"));
+    CHECK(endsWith(lines[1], "[ERROR] lvalue message"));
+}
+
+TEST_CASE("Logger: categories are filtered, LOG_PARAM is formatted by the writer", "[logger]") {
+    LogCapture cap("stand_test_logger_param.log");
+    const bool wasEnabled = LoggerConfig::isEnabled(LogCat::kPipelineTiming);
+    int evaluated = 0;
+    auto expensive = [&evaluated] { ++evaluated; return std::string("shown"); };
+
+    LoggerConfig::setEnabled(LogCat::kPipelineTiming, false);
+    LOG_PARAM(LogCat::kPipelineTiming, 1.0);
+    LOG_CAT(LogCat::kPipelineTiming, LogLevel::Info, expensive());
+    CHECK(evaluated == 0);   // disabled: the message is never built
+
+    LoggerConfig::setEnabled(LogCat::kPipelineTiming, true);
+    LOG_PARAM(LogCat::kPipelineTiming, 1.23456);
+    LOG_CAT(LogCat::kPipelineTiming, LogLevel::Debug, expensive());
+    CHECK(evaluated == 1);
+    LoggerConfig::setEnabled(LogCat::kPipelineTiming, wasEnabled);
+
+    const auto lines = cap.lines();
+    REQUIRE(lines.size() == 2);
+    CHECK(endsWith(lines[0], "[INFO ] [pipeline_timing] pipeline_timing = 1.235"));
+    CHECK(endsWith(lines[1], "[DEBUG] [pipeline_timing] shown"));
+}
+
+TEST_CASE("LoggerConfig: string keys map onto the category bits", "[logger]") {
+    auto& cfg = LoggerConfig::instance();
+    const bool wasEnabled = LoggerConfig::isEnabled(LogCat::kDemodInit);
+
+    CHECK(std::string(LogCat::key(LogCat::kDemodInit)) == "demod_init");
+    cfg.setEnabled(QStringLiteral("demod_init"), true);
+    CHECK(LoggerConfig::isEnabled(LogCat::kDemodInit));
+    CHECK(cfg.isEnabled(QStringLiteral("demod_init")));
+    CHECK(cfg.isEnabled(QStringLiteral("stream_io")) == LoggerConfig::isEnabled(LogCat::kStreamIo));
+    cfg.setEnabled(QStringLiteral("demod_init"), false);
+    CHECK_FALSE(LoggerConfig::isEnabled(LogCat::kDemodInit));
+    CHECK_FALSE(cfg.isEnabled(QStringLiteral("no_such_key")));
+    CHECK(cfg.allParams().size() == LogCat::kCount);
+
+    LoggerConfig::setEnabled(LogCat::kDemodInit, wasEnabled);
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Concurrency and overflow
+// ─────────────────────────────────────────────────────────────────────────────
+TEST_CASE("Logger: concurrent producers keep per-thread order, drops are counted", "[logger]") {
+    LogCapture cap("stand_test_logger_threads.log");
+    constexpr int kThreads   = 4;
+    constexpr int kPerThread = 5000;   // 20 000 > kQueueCapacity: some may drop
+    const uint64_t droppedBefore = Logger::instance().droppedCount();
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([t] {
+            for (int i = 0; i < kPerThread; ++i)
+                LOG_INFO("t" + std::to_string(t) + " #" + std::to_string(i));
+        });
+    }
+    for (auto& th : threads) th.join();
+
+    const auto lines = cap.lines();
+    const uint64_t dropped = Logger::instance().droppedCount() - droppedBefore;
+
+    std::vector<int> last(kThreads, -1);
+    uint64_t written = 0;
+    bool ordered = true, dropNoted = false;
+    for (const auto& line : lines) {
+        const auto pos = line.find("[INFO ] t");
+        if (pos == std::string::npos) {
+            dropNoted = dropNoted || line.find("messages dropped") != std::string::npos;
+            continue;
+        }
+        const int t = line[pos + 9] - '0';
+        const int i = std::stoi(line.substr(line.find('#', pos) + 1));
+        ordered = ordered && i > last[t];
+        last[t] = i;
+        ++written;
+    }
+    CHECK(ordered);
+    CHECK(written + dropped == static_cast<uint64_t>(kThreads) * kPerThread);
+    CHECK(dropNoted == (dropped > 0));
+}
@@ -0,0 +1,163 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "IqCombiner.h"
+#include "Metrics.h"
+#include "Pipeline.h"
+#include "StreamStatsHandler.h"
+
+#include <atomic>
+#include <cmath>
+#include <string>
+#include <thread>
+#include <vector>
+
+static bool contains(const std::string& text, const std::string& needle) {
+    return text.find(needle) != std::string::npos;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Exposition format
+// ─────────────────────────────────────────────────────────────────────────────
+TEST_CASE("Metrics: counters and gauges in the text format", "[metrics]") {
+    Metrics::Registry reg;
+    auto c = reg.counter("test_blocks_total", "Blocks seen.", {{"device", "sim"}, {"channel", "RX0"}});
+    auto g = reg.gauge("test_level_dbfs", "Level.");
+    c->inc();
+    c->inc(41);
+    g->set(-12.5);
+    g->add(0.25);
+
+    const std::string text = reg.exposition();
+    CHECK(contains(text, "# HELP test_blocks_total Blocks seen.\n# TYPE test_blocks_total counter\n"));
+    // Labels are sorted by key whatever the registration order.
+    CHECK(contains(text, "test_blocks_total{channel=\"RX0\",device=\"sim\"} 42\n"));
+    CHECK(contains(text, "# TYPE test_level_dbfs gauge\n"));
+    CHECK(contains(text, "test_level_dbfs -12.25\n"));
+
+    g->set(std::nan(""));
+    CHECK(contains(reg.exposition(), "test_level_dbfs NaN\n"));
+    c->reset();
+    CHECK(contains(reg.exposition(), "test_blocks_total{channel=\"RX0\",device=\"sim\"} 0\n"));
+}
+
+TEST_CASE("Metrics: histogram buckets are cumulative", "[metrics]") {
+    Metrics::Registry reg;
+    auto h = reg.histogram("test_read_seconds", "Read time.", {0.002, 0.001}, {{"device", "sim"}});
+    h->observe(0.0005);
+    h->observe(0.001);    // on the bound → that bucket
+    h->observe(0.0015);
+    h->observe(5.0);
+
+    const std::string text = reg.exposition();
+    CHECK(contains(text, "# TYPE test_read_seconds histogram\n"));
+    CHECK(contains(text, "test_read_seconds_bucket{device=\"sim\",le=\"0.001\"} 2\n"));
+    CHECK(contains(text, "test_read_seconds_bucket{device=\"sim\",le=\"0.002\"} 3\n"));
+    CHECK(contains(text, "test_read_seconds_bucket{device=\"sim\",le=\"+Inf\"} 4\n"));
+    CHECK(contains(text, "test_read_seconds_sum{device=\"sim\"} 5.003\n"));
+    CHECK(contains(text, "test_read_seconds_count{device=\"sim\"} 4\n"));
+}
+
+TEST_CASE("Metrics: label values are escaped", "[metrics]") {
+    Metrics::Registry reg;
+    auto c = reg.counter("test_escape_total", "Line one\nline two.", {{"path", "C:\\rec \"a\""}});
+    const std::string text = reg.exposition();
+    CHECK(contains(text, "# HELP test_escape_total Line one\\nline two.\n"));
+    CHECK(contains(text, "test_escape_total{path=\"C:\\\\rec \\\"a\\\"\"} 0\n"));
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Registration
+// ─────────────────────────────────────────────────────────────────────────────
+TEST_CASE("Metrics: a series disappears with its owner", "[metrics]") {
+    Metrics::Registry reg;
+    auto keep = reg.counter("test_owned_total", "Owned.", {{"channel", "RX0"}});
+    auto drop = reg.counter("test_owned_total", "Owned.", {{"channel", "RX1"}});
+    CHECK(contains(reg.exposition(), "channel=\"RX1\""));
+
+    drop.reset();
+    std::string text = reg.exposition();
+    CHECK(contains(text, "test_owned_total{channel=\"RX0\"} 0\n"));
+    CHECK_FALSE(contains(text, "RX1"));
+
+    keep.reset();
+    text = reg.exposition();
+    CHECK_FALSE(contains(text, "test_owned_total"));
+
+    // Once every owner is gone the name may come back as another type.
+    auto g = std::make_shared<Metrics::Gauge>();
+    CHECK(reg.add("test_owned_total", "Now a gauge.", {}, g));
+}
+
+TEST_CASE("Metrics: a name keeps its type, re-adding replaces the series", "[metrics]") {
+    Metrics::Registry reg;
+    auto c = reg.counter("test_typed", "Typed.");
+    auto g = std::make_shared<Metrics::Gauge>();
+    CHECK_FALSE(reg.add("test_typed", "Typed.", {}, g));
+    CHECK(contains(reg.exposition(), "# TYPE test_typed counter\n"));
+
+    auto replacement = std::make_shared<Metrics::Counter>();
+    replacement->inc(7);
+    CHECK(reg.add("test_typed", "Typed.", {}, replacement));
+    CHECK(contains(reg.exposition(), "test_typed 7\n"));
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Concurrency
+// ─────────────────────────────────────────────────────────────────────────────
+TEST_CASE("Metrics: updates and scrapes run concurrently", "[metrics]") {
+    Metrics::Registry reg;
+    auto c = reg.counter("test_concurrent_total", "Concurrent.");
+    auto h = reg.histogram("test_concurrent_seconds", "Concurrent.",
+                           Metrics::Histogram::latencyBuckets());
+    constexpr int kThreads = 4;
+    constexpr int kPerThread = 20000;
+
+    std::atomic<bool> done{false};
+    std::thread scraper([&] {
+        while (!done.load()) static_cast<void>(reg.exposition());
+    });
+    std::vector<std::thread> writers;
+    for (int t = 0; t < kThreads; ++t) {
+        writers.emplace_back([&] {
+            for (int i = 0; i < kPerThread; ++i) {
+                c->inc();
+                h->observe(1e-3);
+            }
+        });
+    }
+    for (auto& w : writers) w.join();
+    done.store(true);
+    scraper.join();
+
+    CHECK(c->value() == static_cast<uint64_t>(kThreads) * kPerThread);
+    const auto s = h->snapshot();
+    CHECK(s.cumulative.back() == static_cast<uint64_t>(kThreads) * kPerThread);
+    CHECK(std::abs(s.sum - kThreads * kPerThread * 1e-3) < 1e-6);
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Components publish into the process registry
+// ─────────────────────────────────────────────────────────────────────────────
+TEST_CASE("Metrics: StreamStatsHandler and IqCombiner publish their counters", "[metrics]") {
+    const Metrics::Labels labels{{"device", "metrics-test"}};
+    std::vector<float> iq(64, 0.0f);
+    iq[0] = 1.0f;   // one clipped pair
+
+    {
+        StreamStatsHandler stats;
+        stats.publishMetrics(labels);
+        stats.onStreamStarted(1e6);
+        stats.processBlock(iq.data(), 32, 1e6);
+
+        Pipeline out;
+        IqCombiner combiner(1, &out);
+        combiner.publishMetrics(labels);
+        combiner.processBlock(iq.data(), 32, 1e6, BlockMeta{{ChannelDescriptor::RX, 0}, 0});
+
+        const std::string text = Metrics::Registry::instance().exposition();
+        CHECK(contains(text, "stand_stream_clipped_samples_total{device=\"metrics-test\"} 1\n"));
+        CHECK(contains(text, "stand_stream_gaps_total{device=\"metrics-test\"} 0\n"));
+        CHECK(contains(text, "stand_combiner_blocks_total{device=\"metrics-test\"} 1\n"));
+    }
+    CHECK_FALSE(contains(Metrics::Registry::instance().exposition(), "metrics-test"));
+}
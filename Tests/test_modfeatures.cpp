@@ -0,0 +1,141 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+
+#include "ModulationFeatures.h"
+#include "DspUtils.h"
+
+#include <cmath>
+#include <complex>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+using ClassifierProtocol::Type;
+using Catch::Matchers::WithinAbs;
+using F = ModulationFeatures;
+
+namespace {
+
+constexpr double kRate  = 62'500.0;   // 25 kHz channel × kOversample
+constexpr int    kCount = 1024;       // ClassifierHandler::kSnippetSamples
+
+// Samples `signal` (complex baseband, seconds → value) plus complex white
+// noise of RMS `noise`.
+std::vector<float> synth(const std::function<std::complex<double>(double)>& signal,
+                         double noise = 0.05)
+{
+    std::mt19937 rng(7);
+    std::normal_distribution<double> g(0.0, noise / std::sqrt(2.0));
+    std::vector<float> iq(2 * kCount);
+    for (int n = 0; n < kCount; ++n) {
+        const auto z = signal(n / kRate);
+        iq[2 * n]     = static_cast<float>(z.real() + g(rng));
+        iq[2 * n + 1] = static_cast<float>(z.imag() + g(rng));
+    }
+    return iq;
+}
+
+std::complex<double> phasor(double amplitude, double phase) { return std::polar(amplitude, phase); }
+
+constexpr double kTwoPi = 2.0 * dsp::kPi;
+
+F::Vector features(const std::vector<float>& iq) {
+    F mf;
+    F::Vector f{};
+    REQUIRE(mf.compute(iq.data(), kCount, kRate, f));
+    return f;
+}
+
+Type decide(const std::vector<float>& iq, float* confidence = nullptr) {
+    return F::classify(features(iq), confidence);
+}
+
+}  // namespace
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Features
+// ─────────────────────────────────────────────────────────────────────────────
+TEST_CASE("ModulationFeatures: a clean carrier has textbook cumulants", "[modfeatures]") {
+    const auto f = features(synth([](double) { return phasor(0.5, 0.3); }, 0.0));
+
+    CHECK_THAT(f[F::kPowerDb], WithinAbs(10.0 * std::log10(0.25), 0.01));
+    CHECK_THAT(f[F::kC20], WithinAbs(1.0, 1e-3));        // unmodulated: |E[x²]| = E[|x|²]
+    CHECK_THAT(f[F::kSigmaAa], WithinAbs(0.0, 1e-4));
+    CHECK_THAT(f[F::kSigmaFHz], WithinAbs(0.0, 1.0));
+    CHECK(f[F::kPeakShare] > 0.95f);
+}
+
+TEST_CASE("ModulationFeatures: constant envelope versus noise", "[modfeatures]") {
+    // Constant envelope: C42 / C21² = −1 − |C20 / C21|² (the FM carrier's C20
+    // is small).
+    const auto fm = features(synth([](double t) {
+        return phasor(0.5, 2.5 * std::sin(kTwoPi * 1'000.0 * t));
+    }, 0.0));
+    CHECK_THAT(fm[F::kC42], WithinAbs(-1.0 - fm[F::kC20] * fm[F::kC20], 0.01));
+    CHECK_THAT(fm[F::kSigmaAa], WithinAbs(0.0, 1e-3));
+    // Peak deviation 2.5 kHz sinusoidal: σ_f = 2.5 kHz / √2.
+    CHECK_THAT(fm[F::kSigmaFHz], WithinAbs(2'500.0 / std::sqrt(2.0), 60.0));
+
+    // Complex Gaussian noise: C42 ≈ 0, flat spectrum.
+    const auto noise = features(synth([](double) { return std::complex<double>{}; }, 0.3));
+    CHECK_THAT(noise[F::kC42], WithinAbs(0.0, 0.15));
+    CHECK_THAT(noise[F::kSnrDb], WithinAbs(0.0, 1.5));
+    CHECK_THAT(noise[F::kSymmetry], WithinAbs(0.0, 0.15));
+}
+
+TEST_CASE("ModulationFeatures: envelope tone and sideband symmetry", "[modfeatures]") {
+    // AM, depth 0.5: the centred envelope is 0.5 cos → line of 0.5² / 4.
+    const auto am = features(synth([](double t) {
+        return std::complex<double>(0.5 * (1.0 + 0.5 * std::cos(kTwoPi * 1'000.0 * t)), 0.0);
+    }, 0.0));
+    CHECK_THAT(am[F::kGammaMax], WithinAbs(0.0625, 0.01));
+    CHECK_THAT(am[F::kSymmetry], WithinAbs(0.0, 0.05));
+
+    // Two-tone above the carrier: all power in the upper half.
+    const auto usb = features(synth([](double t) {
+        return phasor(0.25, kTwoPi * 700.0 * t) + phasor(0.25, kTwoPi * 1'900.0 * t);
+    }));
+    CHECK(usb[F::kSymmetry] > 0.9f);
+}
+
+TEST_CASE("ModulationFeatures: short snippets are rejected", "[modfeatures]") {
+    F mf;
+    F::Vector f{};
+    f.fill(42.0f);
+    const std::vector<float> iq(2 * (F::kMinSamples - 1), 0.1f);
+    CHECK_FALSE(mf.compute(iq.data(), F::kMinSamples - 1, kRate, f));
+    CHECK(f[0] == 42.0f);
+    CHECK(std::string(F::name(F::kSnrDb)) == "snr_db");
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Decision tree
+// ─────────────────────────────────────────────────────────────────────────────
+TEST_CASE("ModulationFeatures: decision tree separates the basic modulations", "[modfeatures]") {
+    for (const double noise : {0.05, 0.15}) {   // ≈ 20 and 10 dB SNR
+        INFO("noise RMS " << noise);
+
+        CHECK(decide(synth([](double t) { return phasor(0.5, kTwoPi * 1'000.0 * t); }, noise)) == Type::CW);
+        CHECK(decide(synth([](double t) {
+            return 0.5 * (1.0 + 0.7 * std::cos(kTwoPi * 800.0 * t)) * phasor(1.0, kTwoPi * 2'000.0 * t);
+        }, noise)) == Type::AM);
+        CHECK(decide(synth([](double t) {
+            return phasor(0.5, 2.5 * std::sin(kTwoPi * 1'000.0 * t));          // ±2.5 kHz
+        }, noise)) == Type::NFM);
+        CHECK(decide(synth([](double t) {
+            return phasor(0.5, 8.0 * std::sin(kTwoPi * 1'500.0 * t));          // ±12 kHz
+        }, noise)) == Type::FM);
+        CHECK(decide(synth([](double t) {
+            return phasor(0.25, kTwoPi * 700.0 * t) + phasor(0.25, kTwoPi * 1'900.0 * t);
+        }, noise)) == Type::USB);
+        CHECK(decide(synth([](double t) {
+            return phasor(0.25, -kTwoPi * 700.0 * t) + phasor(0.25, -kTwoPi * 1'900.0 * t);
+        }, noise)) == Type::LSB);
+
+        float confidence = 0.0f;
+        CHECK(decide(synth([](double) { return std::complex<double>{}; }, noise), &confidence) == Type::Unknown);
+        CHECK(confidence >= 0.5f);
+        CHECK(confidence <= 0.99f);
+    }
+}
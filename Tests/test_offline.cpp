@@ -0,0 +1,201 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "AmDemodulator.h"
+#include "BandpassExporter.h"
+#include "FmDemodulator.h"
+#include "IqCodec.h"
+#include "IqFileReader.h"
+#include "OfflineProcessor.h"
+
+#include <QThreadPool>
+
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <numbers>
+#include <random>
+#include <string>
+#include <vector>
+
+static std::string tempPath(const char* name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+// Carrier at offsetHz, FM- or AM-modulated by a 1 kHz tone, plus noise (int16).
+static std::vector<int16_t> makeSignal(std::size_t pairs, double sr, double offsetHz,
+                                       bool am, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::normal_distribution<double> noise(0.0, 300.0);
+    std::vector<int16_t> v(pairs * 2);
+    double phase = 0.0;
+    for (std::size_t n = 0; n < pairs; ++n) {
+        const double tone = std::sin(2.0 * std::numbers::pi * 1000.0 * static_cast<double>(n) / sr);
+        phase += 2.0 * std::numbers::pi * (offsetHz + (am ? 0.0 : 50e3 * tone)) / sr;
+        const double a = 8000.0 * (am ? 1.0 + 0.5 * tone : 1.0);
+        v[2 * n]     = static_cast<int16_t>(std::lround(a * std::cos(phase) + noise(rng)));
+        v[2 * n + 1] = static_cast<int16_t>(std::lround(a * std::sin(phase) + noise(rng)));
+    }
+    return v;
+}
+
+static void writeCi16(const std::string& path, const std::vector<int16_t>& iq) {
+    std::ofstream f(path, std::ios::binary);
+    f.write(reinterpret_cast<const char*>(iq.data()),
+            static_cast<std::streamsize>(iq.size() * sizeof(int16_t)));
+}
+
+// Reference: one instance fed the whole file block by block.
+template <typename Fn>
+static void readBlocks(const std::string& path, int block, Fn&& fn) {
+    IqFileReader r;
+    REQUIRE(r.open(QString::fromStdString(path)));
+    std::vector<float> buf(2 * static_cast<std::size_t>(block));
+    int n = 0;
+    while ((n = r.read(buf.data(), block)) > 0) fn(buf.data(), n);
+}
+
+static std::vector<float> sequentialAudio(const std::string& path, BaseDemodulator& dem, int block) {
+    std::vector<float> out;
+    readBlocks(path, block, [&](const float* iq, int n) {
+        const QVector<float> a = dem.pushBlock(iq, n);
+        out.insert(out.end(), a.begin(), a.end());
+    });
+    return out;
+}
+
+static std::vector<float> offlineAudio(const std::string& path, const BaseDemodulator& prototype,
+                                       const OfflineProcessor::Options& opt,
+                                       OfflineProcessor::Stats* stats) {
+    OfflineProcessor proc(opt);
+    REQUIRE(proc.open(QString::fromStdString(path)));
+    std::vector<float> out;
+    REQUIRE(proc.demodulate(prototype, [&](const float* a, std::size_t n) {
+        out.insert(out.end(), a, a + n);
+    }, stats));
+    return out;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Demodulation
+// ─────────────────────────────────────────────────────────────────────────────
+TEST_CASE("OfflineProcessor: FM audio is bit-identical to sequential processing", "[offline]") {
+    constexpr double kSr     = 2e6;
+    constexpr double kOffset = 200e3;
+    const FmDemodulator prototype(kSr, kOffset);
+    const auto pairs = static_cast<std::size_t>(6 * 4 * prototype.warmupSamples() + 12345);
+    const auto iq    = makeSignal(pairs, kSr, kOffset, false, 1);
+
+    const std::string path = tempPath("stand_offline_fm.ci16");
+    writeCi16(path, iq);
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(4);
+    OfflineProcessor::Options opt;
+    opt.chunkPairs = 1;          // raised to 4 × warm-up: many chunks
+    opt.blockPairs = 4096;
+    opt.pool       = &pool;
+
+    auto seqDemod = prototype.clone();
+    const auto expected = sequentialAudio(path, *seqDemod, opt.blockPairs);
+
+    OfflineProcessor::Stats stats;
+    const auto got = offlineAudio(path, prototype, opt, &stats);
+    CHECK(stats.chunks >= 6);
+    CHECK(stats.resynced == 0);  // the overlap, not the fallback, made it exact
+    CHECK(got == expected);
+
+    SECTION(".ci16z goes through the reader and matches too") {
+        const std::string zpath = tempPath("stand_offline_fm.ci16z");
+        {
+            IqCodec::Writer w;
+            AsyncFileWriter::Options wopt;
+            wopt.overflow = AsyncFileWriter::Overflow::Block;
+            REQUIRE(w.open(QString::fromStdString(zpath), nullptr, wopt));
+            w.write(iq.data(), pairs);
+            w.close();
+        }
+        CHECK(offlineAudio(zpath, prototype, opt, nullptr) == expected);
+        std::filesystem::remove(zpath);
+    }
+
+    SECTION("squelch gating is reproduced") {
+        auto gated = prototype.clone();
+        gated->setSquelch(-10.0);
+        auto seqGated = gated->clone();
+        CHECK(offlineAudio(path, *gated, opt, nullptr)
+              == sequentialAudio(path, *seqGated, opt.blockPairs));
+    }
+
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("OfflineProcessor: AM audio is bit-identical to sequential processing", "[offline]") {
+    constexpr double kSr     = 250e3;
+    constexpr double kOffset = -30e3;
+    const AmDemodulator prototype(kSr, kOffset);
+    const auto pairs = static_cast<std::size_t>(3 * 4 * prototype.warmupSamples() + 777);
+
+    const std::string path = tempPath("stand_offline_am.ci16");
+    writeCi16(path, makeSignal(pairs, kSr, kOffset, true, 2));
+
+    OfflineProcessor::Options opt;
+    opt.chunkPairs = 1;
+    opt.blockPairs = 1000;       // not a multiple of the chunk alignment
+
+    auto seqDemod = prototype.clone();
+    OfflineProcessor::Stats stats;
+    CHECK(offlineAudio(path, prototype, opt, &stats)
+          == sequentialAudio(path, *seqDemod, opt.blockPairs));
+    CHECK(stats.chunks >= 3);
+    CHECK(stats.resynced == 0);
+
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("BaseDemodulator: sameState tells a settled clone from a fresh one", "[offline]") {
+    constexpr double kSr = 2e6;
+    FmDemodulator a(kSr, 0.0);
+    const auto iq = makeSignal(20000, kSr, 0.0, false, 3);
+    std::vector<float> f(iq.size());
+    for (std::size_t i = 0; i < iq.size(); ++i) f[i] = iq[i] / 32768.0f;
+
+    auto fresh = a.clone();
+    CHECK(fresh->sameState(a));
+    (void)a.pushBlock(f.data(), 20000);
+    CHECK_FALSE(fresh->sameState(a));
+    CHECK(a.clone()->sameState(a));
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Band-pass export
+// ─────────────────────────────────────────────────────────────────────────────
+TEST_CASE("OfflineProcessor: band-pass I/Q is bit-identical to sequential processing", "[offline]") {
+    constexpr double kSr     = 2e6;
+    constexpr double kOffset = 300e3;
+    constexpr std::size_t kPairs = 400'000;
+
+    const std::string path = tempPath("stand_offline_bp.ci16");
+    writeCi16(path, makeSignal(kPairs, kSr, kOffset, false, 4));
+
+    OfflineProcessor::Options opt;
+    opt.chunkPairs = 30'000;     // not a multiple of the decimation (8)
+    opt.blockPairs = 4096;
+
+    BandpassExporter seq(kSr, kOffset, 100e3, 250e3);
+    std::vector<float> expected;
+    readBlocks(path, opt.blockPairs, [&](const float* x, int n) { seq.process(x, n, expected); });
+
+    OfflineProcessor proc(opt);
+    REQUIRE(proc.open(QString::fromStdString(path)));
+    std::vector<float> got;
+    OfflineProcessor::Stats stats;
+    REQUIRE(proc.bandpass(kSr, kOffset, 100e3, 250e3, [&](const float* x, std::size_t n) {
+        got.insert(got.end(), x, x + n);
+    }, &stats));
+    CHECK(stats.chunks >= 10);
+    CHECK(got.size() == 2 * kPairs / 8);
+    CHECK(got == expected);
+
+    std::filesystem::remove(path);
+}
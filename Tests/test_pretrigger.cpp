@@ -0,0 +1,233 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+
+#include "PreTriggerRecorder.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <thread>
+#include <vector>
+
+static constexpr double kPi = 3.14159265358979323846;
+
+// Ramp I/Q: I = n·step, Q = −n·step, so every sample identifies its index.
+static std::vector<float> makeRamp(long long first, int count, double step) {
+    std::vector<float> iq(2 * count);
+    for (int i = 0; i < count; ++i) {
+        iq[2 * i]     = static_cast<float>((first + i) * step);
+        iq[2 * i + 1] = static_cast<float>(-(first + i) * step);
+    }
+    return iq;
+}
+
+static std::vector<float> readCf32(const std::string& path) {
+    std::vector<float> out;
+    FILE* f = std::fopen(path.c_str(), "rb");
+    if (!f) return out;
+    float buf[1024];
+    std::size_t n;
+    while ((n = std::fread(buf, sizeof(float), 1024, f)) > 0)
+        out.insert(out.end(), buf, buf + n);
+    std::fclose(f);
+    return out;
+}
+
+static bool waitIdle(const PreTriggerRecorder& rec) {
+    for (int i = 0; i < 500 && rec.isCapturing(); ++i)
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    return !rec.isCapturing();
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Manual trigger dumps [trigger − pre, trigger + post)
+// ─────────────────────────────────────────────────────────────────────────────
+TEST_CASE("PreTriggerRecorder: manual trigger writes pre and post window", "[pretrigger]") {
+    constexpr double kSR    = 1000.0;
+    constexpr int    kBlock = 100;
+    constexpr double kStep  = 1e-4;
+
+    const std::string path =
+        (std::filesystem::temp_directory_path() / "stand_pretrigger_manual.cf32").string();
+    std::filesystem::remove(path);
+
+    PreTriggerRecorder::Config cfg;
+    cfg.preSeconds   = 1.0;
+    cfg.postSeconds  = 0.5;
+    cfg.int16Storage = false;
+    PreTriggerRecorder rec(cfg, [&](const QString&) { return QString::fromStdString(path); });
+
+    rec.onStreamStarted(kSR);
+    long long pos = 0;
+    auto feed = [&](int blocks) {
+        for (int b = 0; b < blocks; ++b, pos += kBlock) {
+            const auto iq = makeRamp(pos, kBlock, kStep);
+            rec.processBlock(iq.data(), kBlock, kSR);
+        }
+    };
+
+    feed(20);              // 2 s of history, ring holds pre + 1 s
+    rec.trigger();         // latched at the next block boundary (sample 2000)
+    feed(5);               // up to the post-trigger end (2500)
+    REQUIRE(waitIdle(rec));
+    rec.onStreamStopped();
+
+    const auto data = readCf32(path);
+    REQUIRE(data.size() == 2u * 1500u);
+    CHECK(rec.lostSamples() == 0);
+    for (std::size_t i = 0; i < data.size() / 2; i += 97) {
+        INFO("sample " << i);
+        CHECK_THAT(data[2 * i],     Catch::Matchers::WithinAbs((1000 + i) * kStep, 1e-6));
+        CHECK_THAT(data[2 * i + 1], Catch::Matchers::WithinAbs(-(1000.0 + i) * kStep, 1e-6));
+    }
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("PreTriggerRecorder: int16 storage and power trigger", "[pretrigger]") {
+    constexpr double kSR    = 100'000.0;
+    constexpr int    kBlock = 4096;
+
+    const std::string path =
+        (std::filesystem::temp_directory_path() / "stand_pretrigger_power.cf32").string();
+    std::filesystem::remove(path);
+
+    PreTriggerRecorder::Config cfg;
+    cfg.preSeconds       = 0.2;
+    cfg.postSeconds      = 0.1;
+    cfg.int16Storage     = true;
+    cfg.powerOffsetHz    = 10'000.0;
+    cfg.powerBandwidthHz = 1'000.0;
+    cfg.powerThresholdDb = -30.0;
+
+    QString reason;
+    PreTriggerRecorder rec(cfg, [&](const QString& r) {
+        reason = r;
+        return QString::fromStdString(path);
+    });
+    rec.onStreamStarted(kSR);
+
+    // Quiet noise, then a -20 dBFS tone in the watched band.
+    long long n = 0;
+    auto feed = [&](int blocks, double toneAmp) {
+        for (int b = 0; b < blocks; ++b) {
+            std::vector<float> iq(2 * kBlock);
+            for (int i = 0; i < kBlock; ++i, ++n) {
+                const double ph = 2.0 * kPi * cfg.powerOffsetHz * n / kSR;
+                iq[2 * i]     = static_cast<float>(1e-3 * std::sin(0.37 * n) + toneAmp * std::cos(ph));
+                iq[2 * i + 1] = static_cast<float>(1e-3 * std::cos(0.53 * n) + toneAmp * std::sin(ph));
+            }
+            rec.processBlock(iq.data(), kBlock, kSR);
+        }
+    };
+    feed(8, 0.0);
+    CHECK_FALSE(rec.isCapturing());
+    feed(4, 0.1);
+    REQUIRE(waitIdle(rec));
+    rec.onStreamStopped();
+
+    CHECK(reason == QStringLiteral("power"));
+    const auto data = readCf32(path);
+    // pre (0.2 s) + post (0.1 s) around the first loud block.
+    CHECK(data.size() == 2u * 30'000u);
+    for (float v : data)
+        REQUIRE(std::abs(v) <= 0.2f);
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("PreTriggerRecorder: a too-narrow power bandwidth is raised, not silent", "[pretrigger]") {
+    // 20 Hz at 2 MS/s would need a 100000-pair segment — longer than any block.
+    constexpr double kSR    = 2e6;
+    constexpr int    kBlock = 16384;
+
+    const std::string path =
+        (std::filesystem::temp_directory_path() / "stand_pretrigger_narrow.cf32").string();
+    std::filesystem::remove(path);
+
+    PreTriggerRecorder::Config cfg;
+    cfg.preSeconds       = 0.01;
+    cfg.postSeconds      = 0.01;
+    cfg.powerOffsetHz    = 100'000.0;
+    cfg.powerBandwidthHz = 20.0;
+    cfg.powerThresholdDb = -30.0;
+
+    QString reason;
+    PreTriggerRecorder rec(cfg, [&](const QString& r) {
+        reason = r;
+        return QString::fromStdString(path);
+    });
+    rec.onStreamStarted(kSR);
+
+    long long n = 0;
+    auto feed = [&](int blocks, double toneAmp) {
+        for (int b = 0; b < blocks; ++b) {
+            std::vector<float> iq(2 * kBlock);
+            for (int i = 0; i < kBlock; ++i, ++n) {
+                const double ph = 2.0 * kPi * cfg.powerOffsetHz * n / kSR;
+                iq[2 * i]     = static_cast<float>(toneAmp * std::cos(ph));
+                iq[2 * i + 1] = static_cast<float>(toneAmp * std::sin(ph));
+            }
+            rec.processBlock(iq.data(), kBlock, kSR);
+        }
+    };
+    feed(2, 0.0);
+    CHECK_FALSE(rec.isCapturing());
+    feed(3, 0.1);
+    REQUIRE(waitIdle(rec));
+    rec.onStreamStopped();
+
+    CHECK(reason == QStringLiteral("power"));
+    std::filesystem::remove(path);
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Classifier trigger: a matching, confident result starts a capture
+// ─────────────────────────────────────────────────────────────────────────────
+TEST_CASE("PreTriggerRecorder: classifier result triggers an armed recorder", "[pretrigger]") {
+    constexpr double kSR    = 1000.0;
+    constexpr int    kBlock = 100;
+
+    const std::string path =
+        (std::filesystem::temp_directory_path() / "stand_pretrigger_class.cf32").string();
+    std::filesystem::remove(path);
+
+    PreTriggerRecorder::Config cfg;
+    cfg.preSeconds   = 0.5;
+    cfg.postSeconds  = 0.3;
+    cfg.int16Storage = false;
+    cfg.classifierType          = QStringLiteral("FM");
+    cfg.classifierMinConfidence = 0.8;
+
+    QString reason;
+    PreTriggerRecorder rec(cfg, [&](const QString& r) {
+        reason = r;
+        return QString::fromStdString(path);
+    });
+    rec.onStreamStarted(kSR);
+    long long pos = 0;
+    auto feed = [&](int blocks) {
+        for (int b = 0; b < blocks; ++b, pos += kBlock) {
+            const auto iq = makeRamp(pos, kBlock, 1e-4);
+            rec.processBlock(iq.data(), kBlock, kSR);
+        }
+    };
+
+    feed(10);
+    rec.onClassification(QStringLiteral("AM"), 0.99);   // other type
+    rec.onClassification(QStringLiteral("FM"), 0.5);    // not confident enough
+    feed(2);
+    CHECK_FALSE(rec.isCapturing());
+
+    rec.onClassification(QStringLiteral("fm"), 0.9);    // type match ignores case
+    feed(1);
+    CHECK(rec.isCapturing());
+    feed(3);
+    REQUIRE(waitIdle(rec));
+    rec.onStreamStopped();
+
+    CHECK(reason == QStringLiteral("classifier"));
+    const auto data = readCf32(path);
+    REQUIRE(data.size() == 2u * 800u);   // pre 0.5 s + post 0.3 s
+    CHECK_THAT(data[0], Catch::Matchers::WithinAbs(700 * 1e-4, 1e-6));   // trigger at 1200
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,165 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "FileNaming.h"
+#include "SegmentedFileWriter.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#  include <sys/stat.h>
+#endif
+
+static std::string tempPath(const char* name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+static std::vector<uint8_t> readAll(const std::string& path) {
+    std::vector<uint8_t> out;
+    FILE* f = std::fopen(path.c_str(), "rb");
+    if (!f) return out;
+    uint8_t buf[4096];
+    std::size_t n;
+    while ((n = std::fread(buf, 1, sizeof(buf), f)) > 0)
+        out.insert(out.end(), buf, buf + n);
+    std::fclose(f);
+    return out;
+}
+
+static std::string segment(const std::string& base, int i) {
+    return FileNaming::segmentPath(QString::fromStdString(base), i).toStdString();
+}
+
+TEST_CASE("FileNaming: segment number goes before the extension", "[segments]") {
+    CHECK(FileNaming::segmentPath(QStringLiteral("/rec/a_rx0_4.000MSps.cf32"), 0)
+          == QStringLiteral("/rec/a_rx0_4.000MSps_seg0001.cf32"));
+    CHECK(FileNaming::segmentPath(QStringLiteral("/rec.d/noext"), 11)
+          == QStringLiteral("/rec.d/noext_seg0012"));
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Size policy: whole frames per segment, continuous data, no stray standby
+// ─────────────────────────────────────────────────────────────────────────────
+TEST_CASE("SegmentedFileWriter: rotates by size without splitting frames", "[segments]") {
+    const std::string base = tempPath("stand_segwriter.bin");
+
+    AsyncFileWriter::Options opt;
+    opt.bufferBytes = 4096;
+    opt.overflow    = AsyncFileWriter::Overflow::Block;
+    SegmentedFileWriter::Policy policy;
+    policy.maxBytes = 1000;
+
+    int rotations = 0;
+    SegmentedFileWriter::Hooks hooks;
+    hooks.rotated = [&](const QString& finished, int seg) {
+        CHECK(finished.toStdString() == segment(base, seg - 1));
+        ++rotations;
+    };
+
+    SegmentedFileWriter w;
+    REQUIRE(w.open(QString::fromStdString(base), opt, policy, 0.0, std::move(hooks)));
+    CHECK(w.path().toStdString() == segment(base, 0));
+
+    std::vector<uint8_t> expected;
+    std::vector<uint8_t> frame(300);
+    for (int b = 0; b < 10; ++b) {
+        std::memset(frame.data(), b + 1, frame.size());
+        REQUIRE(w.write(frame.data(), frame.size()));
+        expected.insert(expected.end(), frame.begin(), frame.end());
+    }
+    w.close();
+
+    // 3 frames (900 B) fit in 1000 B → 4 segments: 3 + 3 + 3 + 1 frames.
+    CHECK(rotations == 3);
+    std::vector<uint8_t> joined;
+    for (int i = 0; i < 4; ++i) {
+        const auto part = readAll(segment(base, i));
+        CHECK(part.size() == (i < 3 ? 900u : 300u));
+        joined.insert(joined.end(), part.begin(), part.end());
+        std::filesystem::remove(segment(base, i));
+    }
+    CHECK(joined == expected);
+    CHECK_FALSE(std::filesystem::exists(segment(base, 4)));   // standby discarded
+    CHECK(w.stats().bytesWritten == expected.size());
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Duration policy + header hooks: every segment carries its own final header
+// ─────────────────────────────────────────────────────────────────────────────
+TEST_CASE("SegmentedFileWriter: duration segments are finalised with headers", "[segments]") {
+    const std::string base = tempPath("stand_segwriter.wav");
+
+    SegmentedFileWriter::Policy policy;
+    policy.maxSeconds = 1.0;
+    constexpr double kBytesPerSec = 400.0;   // 100 float samples/s
+
+    SegmentedFileWriter::Hooks hooks;
+    hooks.begin = [](AsyncFileWriter& f) {
+        const uint32_t zero = 0;
+        f.write("HDR!", 4);
+        f.write(&zero, sizeof(zero));
+    };
+    hooks.end = [](AsyncFileWriter& f, uint64_t payload) {
+        const auto n = static_cast<uint32_t>(payload);
+        f.patchOnClose(4, &n, sizeof(n));
+    };
+
+    SegmentedFileWriter w;
+    REQUIRE(w.open(QString::fromStdString(base), AsyncFileWriter::Options{}, policy,
+                   kBytesPerSec, std::move(hooks)));
+    std::vector<float> block(25, 0.5f);   // 100 B, 4 blocks per second
+    for (int b = 0; b < 10; ++b)
+        REQUIRE(w.write(block.data(), block.size() * sizeof(float)));
+    CHECK(w.segment() == 2);
+    CHECK(w.segmentBytes() == 200);
+    w.close();
+
+    const uint32_t sizes[3] = {400, 400, 200};
+    for (int i = 0; i < 3; ++i) {
+        const auto f = readAll(segment(base, i));
+        REQUIRE(f.size() == 8 + sizes[i]);
+        CHECK(std::memcmp(f.data(), "HDR!", 4) == 0);
+        uint32_t n = 0;
+        std::memcpy(&n, f.data() + 4, sizeof(n));
+        CHECK(n == sizes[i]);
+        std::filesystem::remove(segment(base, i));
+    }
+}
+
+TEST_CASE("SegmentedFileWriter: disabled policy writes the base path", "[segments]") {
+    const std::string base = tempPath("stand_segwriter_plain.bin");
+    SegmentedFileWriter w;
+    REQUIRE(w.open(QString::fromStdString(base), AsyncFileWriter::Options{}));
+    const char data[] = "plain";
+    REQUIRE(w.write(data, 5));
+    w.close();
+    CHECK(readAll(base).size() == 5);
+    CHECK_FALSE(std::filesystem::exists(segment(base, 0)));
+    std::filesystem::remove(base);
+}
+
+#ifdef __linux__
+// Each segment reserves its full size up front; a short buffered segment must
+// give the unused reservation back when it is closed.
+TEST_CASE("SegmentedFileWriter: short buffered segment releases its preallocation", "[segments]") {
+    const std::string base = tempPath("stand_segwriter_prealloc.bin");
+    SegmentedFileWriter::Policy policy;
+    policy.maxBytes = 64u << 20;
+    SegmentedFileWriter w;
+    REQUIRE(w.open(QString::fromStdString(base), AsyncFileWriter::Options{}, policy, 0.0));
+    std::vector<char> data(5000, 'x');
+    REQUIRE(w.write(data.data(), data.size()));
+    w.close();
+
+    const std::string path = segment(base, 0);
+    struct stat st{};
+    REQUIRE(::stat(path.c_str(), &st) == 0);
+    CHECK(st.st_size == 5000);
+    CHECK(static_cast<uint64_t>(st.st_blocks) * 512 < (1u << 20));
+    std::filesystem::remove(path);
+}
+#endif
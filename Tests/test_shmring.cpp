@@ -0,0 +1,126 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "ShmIqRing.h"
+
+#include <QCoreApplication>
+#include <QNativeIpcKey>
+#include <QSharedMemory>
+
+#include <cstring>
+#include <vector>
+
+namespace {
+
+// Attaches the way the Python reader does, via the ring's native name.
+class RingReader {
+public:
+    explicit RingReader(const QString& name)
+#ifdef _WIN32
+        : shm_(QNativeIpcKey(name, QNativeIpcKey::Type::Windows))
+#else
+        : shm_(QNativeIpcKey(QLatin1Char('/') + name, QNativeIpcKey::Type::PosixRealtime))
+#endif
+    {
+        REQUIRE(shm_.attach());
+        base_ = static_cast<unsigned char*>(shm_.data());
+    }
+
+    template <typename T> T at(std::size_t offset) const {
+        T v; std::memcpy(&v, base_ + offset, sizeof v); return v;
+    }
+    void setReadSeq(uint64_t v) { std::memcpy(base_ + 32, &v, sizeof v); }
+
+    std::size_t slot(uint64_t frame) const {
+        return ShmIqRing::kHeaderBytes + (frame % at<uint32_t>(8)) * at<uint32_t>(12);
+    }
+
+private:
+    QSharedMemory  shm_;
+    unsigned char* base_{nullptr};
+};
+
+QString ringName(const char* tag) {
+    return QStringLiteral("stand_test_%1_%2").arg(QCoreApplication::applicationPid()).arg(tag);
+}
+
+}  // namespace
+
+TEST_CASE("ShmIqRing: header and frames as the reader sees them", "[shmring]") {
+    ShmIqRing ring;
+    QString error;
+    REQUIRE(ring.create(ringName("layout"), 3, 100, &error));
+    RingReader reader(ring.name());
+
+    CHECK(reader.at<uint32_t>(0) == ShmIqRing::kMagic);
+    CHECK(reader.at<uint32_t>(4) == ShmIqRing::kVersion);
+    CHECK(reader.at<uint32_t>(8) == 3);
+    CHECK(reader.at<uint32_t>(12) % 64 == 0);
+    CHECK(reader.at<uint32_t>(16) == 100);
+    CHECK(reader.at<uint64_t>(24) == 0);
+
+    std::vector<unsigned char> frame(40);
+    for (std::size_t i = 0; i < frame.size(); ++i) frame[i] = static_cast<unsigned char>(i * 3);
+    REQUIRE(ring.write(frame.data(), frame.size()));
+    CHECK_FALSE(ring.write(frame.data(), 101));   // larger than a slot
+
+    CHECK(reader.at<uint64_t>(24) == 1);
+    const std::size_t s = reader.slot(0);
+    CHECK(reader.at<uint64_t>(s + 0) == 1);             // frameSeq
+    CHECK(reader.at<uint32_t>(s + 8) == 40);            // bytes
+    CHECK(reader.at<unsigned char>(s + ShmIqRing::kSlotHeader + 39) == frame[39]);
+}
+
+TEST_CASE("ShmIqRing: frames are built in place and committed", "[shmring]") {
+    ShmIqRing ring;
+    REQUIRE(ring.create(ringName("inplace"), 2, 64));
+    RingReader reader(ring.name());
+
+    unsigned char* slot = ring.beginWrite();
+    REQUIRE(slot != nullptr);
+    std::memset(slot, 0xAB, 16);
+    CHECK(reader.at<uint64_t>(24) == 0);                 // not published yet
+    ring.commit(16);
+    CHECK(reader.at<uint64_t>(24) == 1);
+    CHECK(reader.at<uint32_t>(reader.slot(0) + 8) == 16);
+
+    // A slot that is not committed is handed out again.
+    unsigned char* next = ring.beginWrite();
+    REQUIRE(next != nullptr);
+    CHECK(ring.beginWrite() == next);
+    CHECK(ring.written() == 1);
+}
+
+TEST_CASE("ShmIqRing: a slow reader causes counted drops, not overwrites", "[shmring]") {
+    ShmIqRing ring;
+    REQUIRE(ring.create(ringName("drops"), 2, 8));
+    RingReader reader(ring.name());
+
+    const uint64_t a = 1, b = 2, c = 3;
+    CHECK(ring.write(&a, sizeof a));
+    CHECK(ring.write(&b, sizeof b));
+    CHECK_FALSE(ring.write(&c, sizeof c));              // both slots unread
+    CHECK(ring.beginWrite() == nullptr);
+    CHECK(ring.written() == 2);
+    CHECK(ring.dropped() == 2);
+    CHECK(reader.at<uint64_t>(40) == 2);
+    CHECK(reader.at<uint64_t>(reader.slot(0) + ShmIqRing::kSlotHeader) == 1);   // frame 0 untouched
+
+    reader.setReadSeq(1);                                // reader released frame 0
+    CHECK(ring.write(&c, sizeof c));
+    CHECK(reader.at<uint64_t>(reader.slot(2) + 0) == 3);
+    CHECK(reader.at<uint64_t>(reader.slot(2) + ShmIqRing::kSlotHeader) == 3);
+    CHECK_FALSE(ring.write(&a, sizeof a));
+    CHECK(ring.dropped() == 3);
+}
+
+TEST_CASE("ShmIqRing: invalid sizes and a taken name are refused", "[shmring]") {
+    ShmIqRing a, b;
+    QString error;
+    CHECK_FALSE(a.create(ringName("bad"), 1, 16, &error));
+    CHECK_FALSE(error.isEmpty());
+    REQUIRE(a.create(ringName("taken"), 2, 16));
+    CHECK_FALSE(b.create(ringName("taken"), 2, 16));
+    CHECK_FALSE(b.isOpen());
+    const float sample = 0.0f;
+    CHECK_FALSE(b.write(&sample, sizeof sample));
+}
@@ -0,0 +1,238 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+
+#include "FileNaming.h"
+#include "IqFileReader.h"
+#include "RawFileHandler.h"
+#include "SigMfWriter.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+using Format = RecordingSettings::RawFormat;
+using Catch::Matchers::WithinAbs;
+
+static std::string tempPath(const char* name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+static QJsonObject readMeta(const QString& dataPath) {
+    QFile f(SigMfWriter::metaPathFor(dataPath));
+    REQUIRE(f.open(QIODevice::ReadOnly));
+    return QJsonDocument::fromJson(f.readAll()).object();
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// RawFileHandler → .sigmf-meta
+// ─────────────────────────────────────────────────────────────────────────────
+TEST_CASE("SigMF: captures, gain annotations and index follow the file", "[sigmf]") {
+    const QString path = QString::fromStdString(tempPath("stand_sigmf_test.ci16"));
+    constexpr double kRate  = 40'000.0;     // 10 blocks per index interval
+    constexpr int    kBlock = 4000;
+    std::vector<float> iq(2 * kBlock, 0.25f);
+
+    {
+        RawFileHandler h(path, Format::Int16);
+        h.enableSigMf(100e6, QStringLiteral("unit test"));
+        h.onStreamStarted(kRate);
+        h.annotateGain(0, 30.0);
+
+        uint64_t ts = 1'000'000;
+        for (int b = 0; b < 25; ++b) {
+            if (b == 12) h.onRetune(101e6);
+            if (b == 20) h.annotateGain(1, 42.5);
+            h.processBlock(iq.data(), kBlock, kRate, BlockMeta{{}, ts});
+            ts += kBlock;
+        }
+        h.onStreamStopped();
+    }
+
+    const QJsonObject root   = readMeta(path);
+    const QJsonObject global = root.value(QStringLiteral("global")).toObject();
+    CHECK(global.value(QStringLiteral("core:datatype")).toString() == QStringLiteral("ci16_le"));
+    CHECK_THAT(global.value(QStringLiteral("core:sample_rate")).toDouble(), WithinAbs(kRate, 1e-9));
+    CHECK(global.value(QStringLiteral("core:dataset")).toString() == QStringLiteral("stand_sigmf_test.ci16"));
+
+    const QJsonArray caps = root.value(QStringLiteral("captures")).toArray();
+    REQUIRE(caps.size() == 2);
+    const QJsonObject c0 = caps.at(0).toObject();
+    const QJsonObject c1 = caps.at(1).toObject();
+    CHECK(c0.value(QStringLiteral("core:sample_start")).toDouble() == 0.0);
+    CHECK(c0.value(QStringLiteral("core:frequency")).toDouble() == 100e6);
+    CHECK(c0.value(QStringLiteral("stand:hw_timestamp")).toDouble() == 1'000'000.0);
+    CHECK(c1.value(QStringLiteral("core:sample_start")).toDouble() == 12.0 * kBlock);
+    CHECK(c1.value(QStringLiteral("core:frequency")).toDouble() == 101e6);
+    CHECK(c1.value(QStringLiteral("stand:hw_timestamp")).toDouble() == 1'000'000.0 + 12.0 * kBlock);
+
+    const QJsonArray ann = root.value(QStringLiteral("annotations")).toArray();
+    REQUIRE(ann.size() == 2);
+    CHECK(ann.at(0).toObject().value(QStringLiteral("core:sample_start")).toDouble() == 0.0);
+    CHECK(ann.at(1).toObject().value(QStringLiteral("core:sample_start")).toDouble() == 20.0 * kBlock);
+    CHECK(ann.at(1).toObject().value(QStringLiteral("stand:channel")).toInt() == 1);
+    CHECK_THAT(ann.at(1).toObject().value(QStringLiteral("stand:gain_db")).toDouble(),
+               WithinAbs(42.5, 1e-9));
+
+    // One entry per second of samples: 0, 40000, 80000; byte offset = 4 × sample.
+    const QJsonArray index = global.value(QStringLiteral("stand:index")).toArray();
+    REQUIRE(index.size() == 3);
+    for (int i = 0; i < 3; ++i) {
+        const QJsonArray e = index.at(i).toArray();
+        CHECK(e.at(0).toDouble() == i * kRate);
+        CHECK(e.at(1).toDouble() == 4.0 * i * kRate);
+        CHECK(e.at(2).toDouble() == 1'000'000.0 + i * kRate);
+    }
+
+    std::filesystem::remove(path.toStdString());
+    std::filesystem::remove(SigMfWriter::metaPathFor(path).toStdString());
+}
+
+TEST_CASE("SigMF: IqFileReader seeks by wall-clock time through the index", "[sigmf]") {
+    const QString path = QString::fromStdString(tempPath("stand_sigmf_seek.cf32"));
+    constexpr double kRate = 1000.0;
+    std::vector<float> iq(2 * 5000);
+    for (std::size_t n = 0; n < iq.size() / 2; ++n) iq[2 * n] = static_cast<float>(n);
+    {
+        QFile f(path);
+        REQUIRE(f.open(QIODevice::WriteOnly));
+        f.write(reinterpret_cast<const char*>(iq.data()),
+                static_cast<qint64>(iq.size() * sizeof(float)));
+    }
+
+    // Index written as if the recording started at t0 = 1 000 000 ms.
+    SigMfWriter meta(path);
+    meta.begin(Format::Float32, kRate, 100e6);
+    constexpr qint64 t0 = 1'000'000;
+    for (uint64_t s = 0; s < 5000; s += 500) meta.onBlockWritten(s, 500, 0);
+    REQUIRE(meta.write());
+    {
+        // Replace the wall-clock column with known values: t0 + sample / rate.
+        QFile f(SigMfWriter::metaPathFor(path));
+        REQUIRE(f.open(QIODevice::ReadOnly));
+        QJsonObject root = QJsonDocument::fromJson(f.readAll()).object();
+        f.close();
+        QJsonObject global = root.value(QStringLiteral("global")).toObject();
+        QJsonArray  fixed;
+        for (const auto& v : global.value(QStringLiteral("stand:index")).toArray()) {
+            QJsonArray e = v.toArray();
+            fixed.append(QJsonArray{e.at(0), e.at(1), e.at(2),
+                                    static_cast<double>(t0) + e.at(0).toDouble()});
+        }
+        REQUIRE(fixed.size() == 5);
+        global[QStringLiteral("stand:index")] = fixed;
+        root[QStringLiteral("global")]        = global;
+        REQUIRE(f.open(QIODevice::WriteOnly));
+        f.write(QJsonDocument(root).toJson());
+    }
+
+    IqFileReader r;
+    REQUIRE(r.open(path));
+    REQUIRE(r.hasTimeIndex());
+
+    float one[2];
+    REQUIRE(r.seekToTime(t0 + 2500));
+    REQUIRE(r.read(one, 1) == 1);
+    CHECK(one[0] == 2500.0f);
+
+    REQUIRE(r.seekToTime(t0 - 10'000));   // before the start → first sample
+    CHECK(r.position() == 0);
+    REQUIRE(r.seekToTime(t0 + 60'000));   // past the end → end of file
+    CHECK(r.position() == r.totalPairs());
+
+    r.close();
+    std::filesystem::remove(path.toStdString());
+    std::filesystem::remove(SigMfWriter::metaPathFor(path).toStdString());
+}
+
+TEST_CASE("SigMF: every segment of a segmented recording gets its own sidecar", "[sigmf]") {
+    const QString path = QString::fromStdString(tempPath("stand_sigmf_seg.ci16"));
+    constexpr int kBlock = 1000;   // 4000 B per block, 3 blocks per segment
+    std::vector<float> iq(2 * kBlock, 0.25f);
+
+    SegmentedFileWriter::Policy policy;
+    policy.maxBytes = 12'000;
+    {
+        RawFileHandler h(path, Format::Int16);
+        h.setSegmentPolicy(policy);
+        h.enableSigMf(100e6, {});
+        h.onStreamStarted(1e6);
+        h.annotateGain(0, 20.0);
+        for (int b = 0; b < 7; ++b) {
+            if (b == 4) h.onRetune(105e6);
+            h.processBlock(iq.data(), kBlock, 1e6, BlockMeta{{}, 0});
+        }
+        h.onStreamStopped();
+    }
+
+    for (int seg = 0; seg < 3; ++seg) {
+        const QString data = FileNaming::segmentPath(path, seg);
+        const QJsonObject root = readMeta(data);
+        CHECK(root.value(QStringLiteral("global")).toObject()
+                  .value(QStringLiteral("core:dataset")).toString()
+              == QFileInfo(data).fileName());
+        const QJsonArray caps = root.value(QStringLiteral("captures")).toArray();
+        REQUIRE(caps.size() == (seg == 1 ? 2 : 1));
+        CHECK(caps.at(0).toObject().value(QStringLiteral("core:sample_start")).toDouble() == 0.0);
+        CHECK(caps.at(0).toObject().value(QStringLiteral("core:frequency")).toDouble()
+              == (seg == 2 ? 105e6 : 100e6));
+        // The gain set before the first segment is repeated at the start of each.
+        const QJsonArray ann = root.value(QStringLiteral("annotations")).toArray();
+        REQUIRE(ann.size() == 1);
+        CHECK(ann.at(0).toObject().value(QStringLiteral("stand:gain_db")).toDouble() == 20.0);
+
+        std::filesystem::remove(data.toStdString());
+        std::filesystem::remove(SigMfWriter::metaPathFor(data).toStdString());
+    }
+}
+
+// The sidecar on disk keeps up with a long unsegmented capture before stop.
+TEST_CASE("SigMF: index and gains reach the disk while recording", "[sigmf]") {
+    const QString path = QString::fromStdString(tempPath("stand_sigmf_live.cf32"));
+    constexpr double kRate  = 1000.0;
+    constexpr int    kBlock = 500;   // two blocks per index interval
+    std::vector<float> iq(2 * kBlock, 0.1f);
+
+    RawFileHandler h(path, Format::Float32);
+    h.enableSigMf(100e6, {});
+    h.onStreamStarted(kRate);
+    h.annotateGain(0, 33.0);
+    for (int b = 0; b < 2 * SigMfWriter::kRewriteIndexPoints + 1; ++b)
+        h.processBlock(iq.data(), kBlock, kRate);
+
+    // Rewrites are queued on the I/O thread; wait for the periodic one.
+    QJsonObject root;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    do {
+        QFile f(SigMfWriter::metaPathFor(path));
+        if (f.open(QIODevice::ReadOnly))
+            root = QJsonDocument::fromJson(f.readAll()).object();
+        if (root.value(QStringLiteral("global")).toObject()
+                .value(QStringLiteral("stand:index")).toArray().size()
+            >= SigMfWriter::kRewriteIndexPoints)
+            break;
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    } while (std::chrono::steady_clock::now() < deadline);
+
+    const QJsonArray index = root.value(QStringLiteral("global")).toObject()
+                                 .value(QStringLiteral("stand:index")).toArray();
+    CHECK(index.size() >= SigMfWriter::kRewriteIndexPoints);   // serialised when it runs
+    const QJsonArray ann = root.value(QStringLiteral("annotations")).toArray();
+    REQUIRE(ann.size() == 1);
+    CHECK(ann.at(0).toObject().value(QStringLiteral("stand:gain_db")).toDouble() == 33.0);
+
+    h.onStreamStopped();
+    CHECK(readMeta(path).value(QStringLiteral("global")).toObject()
+              .value(QStringLiteral("stand:index")).toArray().size()
+          == SigMfWriter::kRewriteIndexPoints + 1);
+    std::filesystem::remove(path.toStdString());
+    std::filesystem::remove(SigMfWriter::metaPathFor(path).toStdString());
+}
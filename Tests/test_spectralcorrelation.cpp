@@ -0,0 +1,111 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+
+#include "SpectralCorrelation.h"
+#include "DspUtils.h"
+
+#include <QThreadPool>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+constexpr double kRate  = 62'500.0;   // a 25 kHz classifier snippet
+constexpr int    kCount = 1024;
+
+// BPSK, rectangular pulses of `sps` samples, on a carrier `offsetHz` off DC,
+// plus complex noise of RMS `noise`.
+std::vector<float> bpsk(int sps, double offsetHz, double noise) {
+    std::mt19937 rng(3);
+    std::bernoulli_distribution bit(0.5);
+    std::normal_distribution<double> g(0.0, noise / std::sqrt(2.0));
+    std::vector<float> iq(2 * kCount);
+    double symbol = 1.0;
+    for (int n = 0; n < kCount; ++n) {
+        if (n % sps == 0) symbol = bit(rng) ? 1.0 : -1.0;
+        const double ph = 2.0 * dsp::kPi * offsetHz * n / kRate;
+        iq[2 * n]     = static_cast<float>(0.5 * symbol * std::cos(ph) + g(rng));
+        iq[2 * n + 1] = static_cast<float>(0.5 * symbol * std::sin(ph) + g(rng));
+    }
+    return iq;
+}
+
+std::vector<float> tone(double offsetHz) {
+    std::vector<float> iq(2 * kCount);
+    for (int n = 0; n < kCount; ++n) {
+        const double ph = 2.0 * dsp::kPi * offsetHz * n / kRate;
+        iq[2 * n]     = static_cast<float>(0.5 * std::cos(ph));
+        iq[2 * n + 1] = static_cast<float>(0.5 * std::sin(ph));
+    }
+    return iq;
+}
+
+// Largest magnitude at |α| ≥ minAlphaHz relative to the α = 0 line.
+double cyclicRatio(const CyclicProfile& p, double minAlphaHz) {
+    const double peak = p.peakAlphaHz(minAlphaHz);
+    return p.magnitude[p.centre + static_cast<int>(std::lround(peak / p.resolutionHz))]
+           / p.magnitude[p.centre];
+}
+
+SpectralCorrelation::Options serial() {
+    SpectralCorrelation::Options o;
+    o.tasks = 1;
+    return o;
+}
+
+}  // namespace
+
+TEST_CASE("SpectralCorrelation: grid follows channels and blocks", "[scf]") {
+    SpectralCorrelation scf(serial());
+    // Np = 32, hop 8: (1024 − 32) / 8 + 1 = 125 blocks → 120.
+    CHECK(scf.blocksFor(kCount) == 120);
+    CHECK(scf.blocksFor(31) == 0);
+
+    const auto p = scf.profile(bpsk(10, 0.0, 0.0).data(), kCount, kRate);
+    CHECK(p.magnitude.size() == 32 * 120 / 2);
+    CHECK(p.centre == 32 * 120 / 4);
+    CHECK_THAT(p.resolutionHz, Catch::Matchers::WithinRel(kRate / (120.0 * 8.0), 1e-12));
+    CHECK_THAT(p.alphaHz(0), Catch::Matchers::WithinRel(-kRate, 1e-12));
+
+    CHECK(scf.profile(bpsk(10, 0.0, 0.0).data(), 80, kRate).magnitude.isEmpty());
+    CHECK_THROWS_AS(SpectralCorrelation({24}), std::invalid_argument);
+}
+
+TEST_CASE("SpectralCorrelation: BPSK shows its symbol rate, a carrier does not", "[scf]") {
+    SpectralCorrelation scf(serial());
+    constexpr int    kSps = 10;
+    constexpr double kSymbolRate = kRate / kSps;   // 6.25 kBd
+
+    const auto p = scf.profile(bpsk(kSps, 3'000.0, 0.1).data(), kCount, kRate);
+    INFO("peak at " << p.peakAlphaHz(1'000.0) << " Hz, Δα " << p.resolutionHz);
+    CHECK_THAT(p.peakAlphaHz(1'000.0), Catch::Matchers::WithinAbs(kSymbolRate, 2.0 * p.resolutionHz));
+    CHECK(cyclicRatio(p, 1'000.0) > 0.2);
+
+    // A pure carrier is stationary: nothing away from α = 0.
+    const auto c = scf.profile(tone(3'000.0).data(), kCount, kRate);
+    CHECK(cyclicRatio(c, 1'000.0) < 0.05);
+}
+
+TEST_CASE("SpectralCorrelation: pool tasks give the serial result", "[scf]") {
+    const auto iq = bpsk(8, -5'000.0, 0.2);
+    SpectralCorrelation one(serial());
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(4);
+    SpectralCorrelation::Options o;
+    o.pool  = &pool;
+    o.tasks = 4;
+    SpectralCorrelation four(o);
+
+    const auto a = one.profile(iq.data(), kCount, kRate);
+    const auto b = four.profile(iq.data(), kCount, kRate);
+    REQUIRE(a.magnitude.size() == b.magnitude.size());
+    CHECK(std::equal(a.magnitude.begin(), a.magnitude.end(), b.magnitude.begin()));
+    // Repeated calls reuse the scratch without carrying state over.
+    const auto c = four.profile(iq.data(), kCount, kRate);
+    CHECK(std::equal(a.magnitude.begin(), a.magnitude.end(), c.magnitude.begin()));
+}
@@ -0,0 +1,159 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "Pipeline.h"
+#include "Trace.h"
+
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <atomic>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+static std::string tempPath(const char* name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+namespace {
+
+struct TraceEvents {
+    std::map<std::string, int>         spans;      // name → count
+    std::map<int, std::string>         threads;    // tid → thread_name
+    std::map<std::string, QJsonObject> last;       // name → last span
+};
+
+TraceEvents dump(const char* file) {
+    const QString path = QString::fromStdString(tempPath(file));
+    QString error;
+    REQUIRE(Trace::writeChromeJson(path, &error));
+
+    QFile f(path);
+    REQUIRE(f.open(QIODevice::ReadOnly));
+    QJsonParseError pe{};
+    const QJsonDocument doc = QJsonDocument::fromJson(f.readAll(), &pe);
+    REQUIRE(pe.error == QJsonParseError::NoError);
+
+    TraceEvents out;
+    for (const QJsonValue& v : doc.object().value(QStringLiteral("traceEvents")).toArray()) {
+        const QJsonObject e = v.toObject();
+        const std::string ph = e.value(QStringLiteral("ph")).toString().toStdString();
+        if (ph == "M" && e.value(QStringLiteral("name")).toString() == QStringLiteral("thread_name")) {
+            out.threads[e.value(QStringLiteral("tid")).toInt()] =
+                e.value(QStringLiteral("args")).toObject().value(QStringLiteral("name"))
+                    .toString().toStdString();
+        } else if (ph == "X") {
+            const std::string name = e.value(QStringLiteral("name")).toString().toStdString();
+            ++out.spans[name];
+            out.last[name] = e;
+        }
+    }
+    std::filesystem::remove(path.toStdString());
+    return out;
+}
+
+}  // namespace
+
+// File scope, so the demangled span name is just the class name.
+class TraceProbeHandler : public IPipelineHandler {
+public:
+    void processBlock(const float*, int, double) override { ++blocks; }
+    int blocks{0};
+};
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Recording and export
+// ─────────────────────────────────────────────────────────────────────────────
+TEST_CASE("Trace: spans from several threads reach the Chrome JSON", "[trace]") {
+    Trace::clear();
+    Trace::setEnabled(true);
+    Trace::setThreadName("trace test main");
+
+    {
+        TRACE_SCOPE("test", "outer");
+        TRACE_SCOPE("test", "inner");
+    }
+    std::thread worker([] {
+        Trace::setThreadName("trace test worker");
+        for (int i = 0; i < 3; ++i) TRACE_SCOPE("test", "worker span");
+    });
+    worker.join();
+
+    Pipeline pipeline;
+    TraceProbeHandler probe;
+    pipeline.addHandler(&probe);
+    std::vector<float> iq(64, 0.0f);
+    pipeline.dispatchBlock(iq.data(), 32, 1e6);
+    pipeline.dispatchBlock(iq.data(), 32, 1e6, BlockMeta{});
+    REQUIRE(probe.blocks == 2);
+
+    Trace::setEnabled(false);
+    const TraceEvents ev = dump("stand_trace_threads.json");
+
+#if STAND_TRACING
+    CHECK(ev.spans.at("outer") == 1);
+    CHECK(ev.spans.at("inner") == 1);
+    CHECK(ev.spans.at("worker span") == 3);
+    REQUIRE(ev.spans.count("TraceProbeHandler") == 1);   // demangled dynamic type
+    CHECK(ev.spans.at("TraceProbeHandler") == 2);
+    CHECK(ev.last.at("TraceProbeHandler").value(QStringLiteral("cat")).toString()
+          == QStringLiteral("handler"));
+
+    const QJsonObject outer = ev.last.at("outer");
+    const QJsonObject inner = ev.last.at("inner");
+    CHECK(outer.value(QStringLiteral("tid")).toInt() == inner.value(QStringLiteral("tid")).toInt());
+    CHECK(outer.value(QStringLiteral("ts")).toDouble() <= inner.value(QStringLiteral("ts")).toDouble());
+    CHECK(outer.value(QStringLiteral("dur")).toDouble() >= inner.value(QStringLiteral("dur")).toDouble());
+
+    const int workerTid = ev.last.at("worker span").value(QStringLiteral("tid")).toInt();
+    CHECK(workerTid != outer.value(QStringLiteral("tid")).toInt());
+    CHECK(ev.threads.at(workerTid) == "trace test worker");
+    CHECK(ev.threads.at(outer.value(QStringLiteral("tid")).toInt()) == "trace test main");
+#else
+    CHECK(ev.spans.empty());
+#endif
+}
+
+TEST_CASE("Trace: disabled scopes and cleared spans are not exported", "[trace]") {
+    Trace::setEnabled(true);
+    { TRACE_SCOPE("test", "before clear"); }
+    Trace::clear();
+    Trace::setEnabled(false);
+    { TRACE_SCOPE("test", "while disabled"); }
+    Trace::setEnabled(true);
+    { TRACE_SCOPE("test", "after enable"); }
+    Trace::setEnabled(false);
+
+    const TraceEvents ev = dump("stand_trace_clear.json");
+    CHECK(ev.spans.count("before clear") == 0);
+    CHECK(ev.spans.count("while disabled") == 0);
+#if STAND_TRACING
+    CHECK(ev.spans.count("after enable") == 1);
+#endif
+}
+
+TEST_CASE("Trace: a full ring keeps the newest spans, dumps run concurrently", "[trace]") {
+    Trace::clear();
+    Trace::setEnabled(true);
+
+    std::atomic<bool> done{false};
+    std::thread writer([&] {
+        for (int i = 0; i < 10; ++i) TRACE_SCOPE("test", "oldest");
+        for (std::size_t i = 0; i < Trace::kEventsPerThread; ++i) TRACE_SCOPE("test", "newest");
+        done.store(true);
+    });
+    // Dumping while the ring wraps must neither crash nor emit torn spans.
+    while (!done.load()) dump("stand_trace_concurrent.json");
+    writer.join();
+    Trace::setEnabled(false);
+
+    const TraceEvents ev = dump("stand_trace_ring.json");
+#if STAND_TRACING
+    CHECK(ev.spans.count("oldest") == 0);
+    CHECK(ev.spans.at("newest") == static_cast<int>(Trace::kEventsPerThread));
+#endif
+}